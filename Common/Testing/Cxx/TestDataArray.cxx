@@ -1,5 +1,7 @@
 #include "vtkIntArray.h"
 #include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkMath.h"
 
 int TestDataArray(int,char *[])
 {
@@ -101,5 +103,156 @@ int TestDataArray(int,char *[])
     }
   cout << endl;
   farray->Delete();
+
+  // Allocation policy: aligned memory must stay aligned while growing,
+  // and keep its contents.
+  vtkDoubleArray* aarray = vtkDoubleArray::New();
+  aarray->SetAlignment( 64 );
+  aarray->SetGrowthFactor( 1.5 );
+  for ( cc = 0; cc < 1000; cc ++ )
+    {
+    aarray->InsertNextValue( cc );
+    if ( reinterpret_cast<size_t>( aarray->GetPointer(0) ) % 64 != 0 )
+      {
+      cerr << "Array with 64 byte alignment is not aligned after "
+           << cc << " inserts" << endl;
+      aarray->Delete();
+      return 1;
+      }
+    }
+  aarray->Squeeze();
+  vtkDoubleArray* copy = vtkDoubleArray::New();
+  vtkDataArray::SetGlobalDefaultAlignment( 32 );
+  vtkDoubleArray* copy2 = vtkDoubleArray::New();
+  vtkDataArray::SetGlobalDefaultAlignment( 0 );
+  copy2->DeepCopy( aarray );
+  copy->DeepCopy( copy2 );
+  if ( copy2->GetAlignment() != 32 || copy->GetAlignment() != 0 ||
+       reinterpret_cast<size_t>( copy2->GetPointer(0) ) % 32 != 0 )
+    {
+    cerr << "Global default alignment not used" << endl;
+    return 1;
+    }
+  for ( cc = 0; cc < 1000; cc ++ )
+    {
+    if ( aarray->GetValue(cc) != cc || copy->GetValue(cc) != cc )
+      {
+      cerr << "Aligned array lost value " << cc << endl;
+      return 1;
+      }
+    }
+  aarray->Delete();
+  copy->Delete();
+  copy2->Delete();
+
+  // Memory mapping: 1000 doubles after an 8 byte header.
+  const char* fname = "TestDataArrayMapped.raw";
+  FILE* fp = fopen( fname, "wb" );
+  if ( !fp )
+    {
+    cerr << "Cannot create " << fname << endl;
+    return 1;
+    }
+  double header = -1;
+  fwrite( &header, sizeof(double), 1, fp );
+  for ( cc = 0; cc < 1000; cc ++ )
+    {
+    double value = cc;
+    fwrite( &value, sizeof(double), 1, fp );
+    }
+  fclose( fp );
+
+  vtkDoubleArray* marray = vtkDoubleArray::New();
+  marray->SetNumberOfComponents( 2 );
+  if ( !marray->MapFile( fname, 8, 1000, 0 ) || !marray->GetMemoryMapped() ||
+       marray->GetNumberOfTuples() != 500 )
+    {
+    cerr << "Cannot map " << fname << endl;
+    marray->Delete();
+    return 1;
+    }
+  for ( cc = 0; cc < 1000; cc ++ )
+    {
+    if ( marray->GetValue(cc) != cc )
+      {
+      cerr << "Mapped array has " << marray->GetValue(cc)
+           << " at " << cc << endl;
+      marray->Delete();
+      return 1;
+      }
+    }
+  // Misaligned and out of range regions are refused.
+  if ( marray->MapFile( fname, 4, 10, 0 ) ||
+       marray->MapFile( fname, 8, 1001, 0 ) ||
+       !marray->GetMemoryMapped() || marray->GetValue(999) != 999 )
+    {
+    cerr << "Invalid mapping accepted" << endl;
+    marray->Delete();
+    return 1;
+    }
+
+  // Copy-on-write mappings can be modified without changing the file,
+  // growing the array moves it to memory.
+  vtkDoubleArray* carray = vtkDoubleArray::New();
+  if ( !carray->MapFile( fname, 8, 1000, 1 ) )
+    {
+    cerr << "Cannot map " << fname << " copy-on-write" << endl;
+    marray->Delete();
+    carray->Delete();
+    return 1;
+    }
+  carray->SetValue( 5, -5 );
+  carray->InsertNextValue( 1000 );
+  if ( carray->GetMemoryMapped() || carray->GetValue(5) != -5 ||
+       carray->GetValue(999) != 999 || carray->GetValue(1000) != 1000 ||
+       marray->GetValue(5) != 5 )
+    {
+    cerr << "Copy-on-write mapping failed" << endl;
+    marray->Delete();
+    carray->Delete();
+    return 1;
+    }
+  carray->Delete();
+  marray->Initialize();
+  if ( marray->GetMemoryMapped() )
+    {
+    cerr << "Initialize did not release the mapping" << endl;
+    marray->Delete();
+    return 1;
+    }
+  marray->Delete();
+  remove( fname );
+
+  // Ranges skip NaN, and are the same when computed on several threads.
+  double nan = vtkMath::Nan();
+  vtkFloatArray* narray = vtkFloatArray::New();
+  narray->SetNumberOfComponents( 2 );
+  narray->InsertNextTuple2( nan, nan );
+  for ( cc = 0; cc < 1000; cc ++ )
+    {
+    narray->InsertNextTuple2( cc % 7 ? cc - 500 : nan, nan );
+    }
+  narray->InsertNextTuple2( nan, nan );
+  for ( int threshold = 0; threshold < 32; threshold += 16 )
+    {
+    vtkDataArray::SetGlobalRangeThreadingThreshold( threshold );
+    narray->Modified();
+    narray->GetRange( range, 0 );
+    if ( range[0] != -499 || range[1] != 499 )
+      {
+      cerr << "Range with NaN is " << range[0] << " " << range[1] << endl;
+      narray->Delete();
+      return 1;
+      }
+    narray->GetRange( range, 1 );
+    if ( range[0] != VTK_DOUBLE_MAX || range[1] != VTK_DOUBLE_MIN )
+      {
+      cerr << "Range of NaN is " << range[0] << " " << range[1] << endl;
+      narray->Delete();
+      return 1;
+      }
+    }
+  vtkDataArray::SetGlobalRangeThreadingThreshold( 1048576 );
+  narray->Delete();
   return 0;
 }
@@ -0,0 +1,155 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Exercise the vtkInformation map with enough keys to grow it and with
+// removals in between.
+
+#include "vtkInformation.h"
+#include "vtkInformationDoubleKey.h"
+#include "vtkInformationIntegerKey.h"
+#include "vtkInformationIterator.h"
+#include "vtkInformationStringKey.h"
+#include "vtkSmartPointer.h"
+
+#define NUMBER_OF_KEYS 50
+
+static int TestInformationCheck(vtkInformation* info,
+                                vtkInformationIntegerKey** intKeys,
+                                vtkInformationDoubleKey** doubleKeys,
+                                vtkInformationStringKey** stringKeys,
+                                const char* label)
+{
+  int retVal = 0;
+  char value[64];
+  for (int i = 0; i < NUMBER_OF_KEYS; ++i)
+    {
+    // every third key has been removed
+    int expected = (i % 3 != 0);
+    sprintf(value, "value %d", i);
+    if (info->Has(intKeys[i]) != expected ||
+        info->Has(doubleKeys[i]) != expected ||
+        info->Has(stringKeys[i]) != expected)
+      {
+      cerr << label << ": key " << i << " Has() is wrong" << endl;
+      retVal = 1;
+      }
+    else if (expected &&
+             (info->Get(intKeys[i]) != i ||
+              info->Get(doubleKeys[i]) != 0.5 * i ||
+              strcmp(info->Get(stringKeys[i]), value) != 0))
+      {
+      cerr << label << ": key " << i << " has a wrong value" << endl;
+      retVal = 1;
+      }
+    }
+
+  int expectedKeys = 3 * (NUMBER_OF_KEYS - (NUMBER_OF_KEYS + 2) / 3);
+  if (info->GetNumberOfKeys() != expectedKeys)
+    {
+    cerr << label << ": " << info->GetNumberOfKeys() << " keys, expected "
+         << expectedKeys << endl;
+    retVal = 1;
+    }
+  return retVal;
+}
+
+int TestInformation(int, char*[])
+{
+  int retVal = 0;
+  int i;
+  char value[64];
+
+  // Keys are owned by the key manager and deleted at exit.
+  vtkInformationIntegerKey* intKeys[NUMBER_OF_KEYS];
+  vtkInformationDoubleKey* doubleKeys[NUMBER_OF_KEYS];
+  vtkInformationStringKey* stringKeys[NUMBER_OF_KEYS];
+  for (i = 0; i < NUMBER_OF_KEYS; ++i)
+    {
+    intKeys[i] = new vtkInformationIntegerKey("Integer", "TestInformation");
+    doubleKeys[i] = new vtkInformationDoubleKey("Double", "TestInformation");
+    stringKeys[i] = new vtkInformationStringKey("String", "TestInformation");
+    }
+
+  vtkSmartPointer<vtkInformation> info =
+    vtkSmartPointer<vtkInformation>::New();
+  for (i = 0; i < NUMBER_OF_KEYS; ++i)
+    {
+    sprintf(value, "value %d", i);
+    info->Set(intKeys[i], i);
+    info->Set(doubleKeys[i], 0.5 * i);
+    info->Set(stringKeys[i], value);
+    }
+  for (i = 0; i < NUMBER_OF_KEYS; i += 3)
+    {
+    info->Remove(intKeys[i]);
+    info->Remove(doubleKeys[i]);
+    info->Remove(stringKeys[i]);
+    }
+  retVal |= TestInformationCheck(info, intKeys, doubleKeys, stringKeys,
+                                 "Set/Remove");
+
+  // Every key is visited once.
+  vtkSmartPointer<vtkInformationIterator> it =
+    vtkSmartPointer<vtkInformationIterator>::New();
+  it->SetInformation(info);
+  int visited = 0;
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    vtkInformationKey* key = it->GetCurrentKey();
+    if (!key->Has(info))
+      {
+      cerr << "Iterator returned a key that is not set" << endl;
+      retVal = 1;
+      }
+    ++visited;
+    }
+  if (visited != info->GetNumberOfKeys())
+    {
+    cerr << "Iterator visited " << visited << " keys" << endl;
+    retVal = 1;
+    }
+
+  vtkSmartPointer<vtkInformation> copy =
+    vtkSmartPointer<vtkInformation>::New();
+  copy->Copy(info);
+  retVal |= TestInformationCheck(copy, intKeys, doubleKeys, stringKeys,
+                                 "Copy");
+
+  // Setting an unchanged value does not modify the information.
+  unsigned long mtime = info->GetMTime();
+  info->Set(intKeys[1], 1);
+  info->Set(doubleKeys[1], 0.5);
+  if (info->GetMTime() != mtime)
+    {
+    cerr << "Setting an unchanged value modified the information" << endl;
+    retVal = 1;
+    }
+  info->Set(intKeys[1], 2);
+  if (info->GetMTime() == mtime || info->Get(intKeys[1]) != 2)
+    {
+    cerr << "Setting a new value did not modify the information" << endl;
+    retVal = 1;
+    }
+
+  info->Clear();
+  if (info->GetNumberOfKeys() != 0 || info->Has(intKeys[1]))
+    {
+    cerr << "Clear left keys behind" << endl;
+    retVal = 1;
+    }
+
+  copy->PrintSelf(cout, vtkIndent());
+
+  return retVal;
+}
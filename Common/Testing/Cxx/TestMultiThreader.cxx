@@ -0,0 +1,224 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Exercise vtkMultiThreader with and without the persistent thread pool.
+
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+
+#define NUMBER_OF_EXECUTES 50
+
+typedef struct {
+  vtkMutexLock* Lock;
+  vtkMultiThreader* Inner;
+  int Counts[VTK_MAX_THREADS];
+  int NestedCount;
+} vtkMultiThreaderTestData;
+
+VTK_THREAD_RETURN_TYPE vtkMultiThreaderTestCount( void* arg )
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkMultiThreaderTestData* td =
+    static_cast<vtkMultiThreaderTestData*>(info->UserData);
+
+  td->Lock->Lock();
+  td->Counts[info->ThreadID]++;
+  td->Lock->Unlock();
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+VTK_THREAD_RETURN_TYPE vtkMultiThreaderTestNested( void* arg )
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkMultiThreaderTestData* td =
+    static_cast<vtkMultiThreaderTestData*>(info->UserData);
+
+  // Only thread 0 nests, the pool is busy so this must fall back to
+  // creating threads rather than deadlock.
+  if ( info->ThreadID == 0 )
+    {
+    td->Inner->SingleMethodExecute();
+    td->Lock->Lock();
+    td->NestedCount++;
+    td->Lock->Unlock();
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+VTK_THREAD_RETURN_TYPE vtkMultiThreaderTestSpawned( void* arg )
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+
+  int active = 1;
+  while ( active )
+    {
+    info->ActiveFlagLock->Lock();
+    active = *info->ActiveFlag;
+    info->ActiveFlagLock->Unlock();
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+static int vtkMultiThreaderTestCheck( vtkMultiThreaderTestData& data,
+                                      int numThreads, int expected,
+                                      const char* label )
+{
+  int retVal = 0;
+  for ( int i = 0; i < numThreads; ++i )
+    {
+    if ( data.Counts[i] != expected )
+      {
+      cerr << label << ": thread " << i << " ran " << data.Counts[i]
+           << " times, expected " << expected << endl;
+      retVal = 1;
+      }
+    data.Counts[i] = 0;
+    }
+  return retVal;
+}
+
+int TestMultiThreader( int, char*[] )
+{
+  int retVal = 0;
+  int i;
+
+  vtkMultiThreaderTestData data;
+  data.Lock = vtkMutexLock::New();
+  data.NestedCount = 0;
+  for ( i = 0; i < VTK_MAX_THREADS; ++i )
+    {
+    data.Counts[i] = 0;
+    }
+
+  vtkMultiThreader* threader = vtkMultiThreader::New();
+  // Use more threads than there are processors to make sure the pool
+  // does not depend on the processor count.
+  int numThreads = VTK_MAX_THREADS < 4 ? VTK_MAX_THREADS : 4;
+  threader->SetNumberOfThreads( numThreads );
+  threader->SetSingleMethod( vtkMultiThreaderTestCount, &data );
+
+  for ( int usePool = 0; usePool < 2; ++usePool )
+    {
+    vtkMultiThreader::SetGlobalUseThreadPool( usePool );
+    if ( vtkMultiThreader::GetGlobalUseThreadPool() != usePool )
+      {
+      cerr << "GetGlobalUseThreadPool did not return " << usePool << endl;
+      retVal = 1;
+      }
+
+    for ( i = 0; i < NUMBER_OF_EXECUTES; ++i )
+      {
+      threader->SingleMethodExecute();
+      }
+    retVal |= vtkMultiThreaderTestCheck(
+      data, numThreads, NUMBER_OF_EXECUTES, "SingleMethodExecute" );
+
+    // Fewer threads than the pool holds must only run those threads.
+    threader->SetNumberOfThreads( 2 );
+    threader->SingleMethodExecute();
+    retVal |= vtkMultiThreaderTestCheck(
+      data, 2, 1, "SingleMethodExecute (2 threads)" );
+    for ( i = 2; i < numThreads; ++i )
+      {
+      if ( data.Counts[i] != 0 )
+        {
+        cerr << "Thread " << i << " ran with only 2 threads requested" << endl;
+        retVal = 1;
+        }
+      }
+    threader->SetNumberOfThreads( numThreads );
+
+    for ( i = 0; i < numThreads; ++i )
+      {
+      threader->SetMultipleMethod( i, vtkMultiThreaderTestCount, &data );
+      }
+    for ( i = 0; i < NUMBER_OF_EXECUTES; ++i )
+      {
+      threader->MultipleMethodExecute();
+      }
+    retVal |= vtkMultiThreaderTestCheck(
+      data, numThreads, NUMBER_OF_EXECUTES, "MultipleMethodExecute" );
+    }
+
+  // Nested execution while the pool is in use.
+  data.Inner = vtkMultiThreader::New();
+  data.Inner->SetNumberOfThreads( numThreads );
+  data.Inner->SetSingleMethod( vtkMultiThreaderTestCount, &data );
+  threader->SetSingleMethod( vtkMultiThreaderTestNested, &data );
+  threader->SingleMethodExecute();
+  if ( data.NestedCount != 1 )
+    {
+    cerr << "Nested SingleMethodExecute did not complete" << endl;
+    retVal = 1;
+    }
+  retVal |= vtkMultiThreaderTestCheck(
+    data, numThreads, 1, "Nested SingleMethodExecute" );
+
+  // More threads than the old fixed-size bookkeeping allowed.
+  int manyThreads = VTK_MAX_THREADS < 100 ? VTK_MAX_THREADS : 100;
+  threader->SetNumberOfThreads( manyThreads );
+  if ( threader->GetNumberOfThreads() != manyThreads )
+    {
+    cerr << "SetNumberOfThreads(" << manyThreads << ") was clamped to "
+         << threader->GetNumberOfThreads() << endl;
+    retVal = 1;
+    }
+  threader->SetSingleMethod( vtkMultiThreaderTestCount, &data );
+  threader->SingleMethodExecute();
+  retVal |= vtkMultiThreaderTestCheck(
+    data, manyThreads, 1, "SingleMethodExecute (many threads)" );
+
+  // Spawned threads run until they are told to terminate.
+  int spawned[3];
+  for ( i = 0; i < 3; ++i )
+    {
+    spawned[i] = threader->SpawnThread( vtkMultiThreaderTestSpawned, &data );
+    if ( spawned[i] != i || !threader->IsThreadActive( spawned[i] ) )
+      {
+      cerr << "SpawnThread returned " << spawned[i] << endl;
+      retVal = 1;
+      }
+    }
+  threader->TerminateThread( spawned[1] );
+  if ( threader->IsThreadActive( spawned[1] ) )
+    {
+    cerr << "Thread " << spawned[1] << " still active" << endl;
+    retVal = 1;
+    }
+  // The freed id is reused.
+  if ( threader->SpawnThread( vtkMultiThreaderTestSpawned, &data ) != 1 )
+    {
+    cerr << "SpawnThread did not reuse a terminated thread id" << endl;
+    retVal = 1;
+    }
+  for ( i = 0; i < 3; ++i )
+    {
+    threader->TerminateThread( i );
+    }
+
+  threader->PrintSelf( cout, vtkIndent() );
+
+  vtkMultiThreader::SetGlobalUseThreadPool( 0 );
+  data.Inner->Delete();
+  threader->Delete();
+  data.Lock->Delete();
+
+  return retVal;
+}
@@ -0,0 +1,119 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkParallelFor visits every index exactly once and reduces
+// the per-thread results.
+
+#include "vtkParallelFor.h"
+
+#include <vtkstd/vector>
+
+class vtkParallelForTestFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkstd::vector<int> Visits;
+  vtkstd::vector<double> PartialSums;
+  double Sum;
+  int NumberOfThreads;
+  int BadThreadId;
+
+  virtual void Initialize(int numberOfThreads)
+    {
+    this->NumberOfThreads = numberOfThreads;
+    this->PartialSums.assign(numberOfThreads, 0.0);
+    this->BadThreadId = 0;
+    }
+
+  virtual void Execute(vtkIdType begin, vtkIdType end, int threadId)
+    {
+    if ( threadId < 0 || threadId >= this->NumberOfThreads )
+      {
+      this->BadThreadId = 1;
+      return;
+      }
+    for ( vtkIdType i = begin; i < end; ++i )
+      {
+      this->Visits[i]++;
+      this->PartialSums[threadId] += static_cast<double>(i);
+      }
+    }
+
+  virtual void Reduce()
+    {
+    this->Sum = 0.0;
+    for ( int i = 0; i < this->NumberOfThreads; ++i )
+      {
+      this->Sum += this->PartialSums[i];
+      }
+    }
+};
+
+static int vtkParallelForTestRun( vtkParallelFor* parallelFor,
+                                  vtkIdType begin, vtkIdType end )
+{
+  vtkParallelForTestFunctor functor;
+  functor.Visits.assign(end > 0 ? end : 0, 0);
+  parallelFor->Execute( begin, end, &functor );
+
+  int retVal = 0;
+  double expected = 0.0;
+  for ( vtkIdType i = 0; i < end; ++i )
+    {
+    int visits = ( i >= begin ? 1 : 0 );
+    if ( functor.Visits[i] != visits )
+      {
+      cerr << "Index " << i << " visited " << functor.Visits[i]
+           << " times, expected " << visits << endl;
+      retVal = 1;
+      break;
+      }
+    expected += visits * static_cast<double>(i);
+    }
+  if ( functor.Sum != expected )
+    {
+    cerr << "Reduced sum " << functor.Sum << ", expected " << expected << endl;
+    retVal = 1;
+    }
+  if ( functor.BadThreadId )
+    {
+    cerr << "Execute called with a bad thread id" << endl;
+    retVal = 1;
+    }
+  return retVal;
+}
+
+int TestParallelFor( int, char*[] )
+{
+  int retVal = 0;
+
+  vtkParallelFor* parallelFor = vtkParallelFor::New();
+  parallelFor->SetNumberOfThreads( 4 );
+
+  // Automatic grain size, large enough to be split.
+  retVal |= vtkParallelForTestRun( parallelFor, 0, 100000 );
+  // Not a multiple of the grain, and not starting at zero.
+  parallelFor->SetGrainSize( 7 );
+  retVal |= vtkParallelForTestRun( parallelFor, 3, 1000 );
+  // Empty and single index ranges.
+  retVal |= vtkParallelForTestRun( parallelFor, 10, 10 );
+  retVal |= vtkParallelForTestRun( parallelFor, 10, 11 );
+  // Serial execution.
+  parallelFor->SetNumberOfThreads( 1 );
+  retVal |= vtkParallelForTestRun( parallelFor, 0, 5000 );
+
+  parallelFor->PrintSelf( cout, vtkIndent() );
+  parallelFor->Delete();
+
+  return retVal;
+}
@@ -19,8 +19,10 @@
 
 #include "vtkTimerLog.h"
 #include "vtkDebugLeaks.h"
+#include "vtkMultiThreader.h"
 
 #include <vtksys/ios/sstream>
+#include <vtkstd/string>
 
 // this is needed for the unlink call
 #if defined(__CYGWIN__)
@@ -68,10 +70,107 @@ void otherTimerLogTest(ostream& strm)
 }
 
 
+VTK_THREAD_RETURN_TYPE otherTimerLogThread(void *)
+{
+  for (int i = 0; i < 10; i++)
+    {
+    vtkTimerLog::MarkStartEvent("outer");
+    vtkTimerLog::MarkStartEvent("inner");
+    vtkTimerLog::MarkEvent("mark");
+    vtkTimerLog::MarkEndEvent("inner");
+    vtkTimerLog::MarkEndEvent("outer");
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+// Events recorded concurrently are kept per thread and merged in order.
+int otherTimerLogThreadedTest(ostream& strm)
+{
+  int retVal = 0;
+  int i;
+  strm << "Test vtkTimerLog threaded Start" << endl;
+
+  vtkTimerLog::ResetLog();
+  vtkTimerLog::SetMaxEntries(1000);
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(4);
+  threader->SetSingleMethod(otherTimerLogThread, NULL);
+  threader->SingleMethodExecute();
+  threader->Delete();
+
+  int num = vtkTimerLog::GetNumberOfEvents();
+  if (num != 4 * 50)
+    {
+    cerr << "Expected " << 4 * 50 << " events, got " << num << endl;
+    retVal = 1;
+    }
+
+  int starts = 0;
+  int ends = 0;
+  for (i = 0; i < num; i++)
+    {
+    if (i > 0 &&
+        vtkTimerLog::GetEventWallTime(i) < vtkTimerLog::GetEventWallTime(i-1))
+      {
+      cerr << "Event " << i << " is out of order" << endl;
+      retVal = 1;
+      }
+    int expectedIndent = 0;
+    if (!strcmp(vtkTimerLog::GetEventString(i), "inner"))
+      {
+      expectedIndent = 1;
+      }
+    else if (!strcmp(vtkTimerLog::GetEventString(i), "mark"))
+      {
+      expectedIndent = 2;
+      }
+    if (vtkTimerLog::GetEventIndent(i) != expectedIndent +
+        (vtkTimerLog::GetEventType(i) == vtkTimerLog::END))
+      {
+      cerr << "Event " << i << " has indent "
+           << vtkTimerLog::GetEventIndent(i) << endl;
+      retVal = 1;
+      }
+    starts += (vtkTimerLog::GetEventType(i) == vtkTimerLog::START);
+    ends += (vtkTimerLog::GetEventType(i) == vtkTimerLog::END);
+    }
+  if (starts != 4 * 20 || ends != 4 * 20)
+    {
+    cerr << "Got " << starts << " start and " << ends << " end events" << endl;
+    retVal = 1;
+    }
+
+  vtkTimerLog::DumpLogWithIndents(&strm, 0.0);
+
+  vtksys_ios::ostringstream trace;
+  vtkTimerLog::DumpTraceEvents(&trace);
+  vtkstd::string json = trace.str();
+  if (json.find("{\"traceEvents\":[") != 0 ||
+      json.find("\"ph\":\"B\"") == vtkstd::string::npos ||
+      json.find("\"ph\":\"E\"") == vtkstd::string::npos ||
+      json.find("\"name\":\"mark\",\"ph\":\"i\"") == vtkstd::string::npos)
+    {
+    cerr << "Unexpected trace output:\n" << json.substr(0, 200) << endl;
+    retVal = 1;
+    }
+  strm << json;
+
+  vtkTimerLog::ResetLog();
+  if (vtkTimerLog::GetNumberOfEvents() != 0)
+    {
+    cerr << "ResetLog did not clear the events of all threads" << endl;
+    retVal = 1;
+    }
+  vtkTimerLog::CleanupLog();
+  strm << "Test vtkTimerLog threaded End" << endl;
+  return retVal;
+}
+
+
 int otherTimerLog(int,char *[])
 {
   vtksys_ios::ostringstream vtkmsg_with_warning_C4701; 
   otherTimerLogTest(vtkmsg_with_warning_C4701);
 
-  return 0;
+  return otherTimerLogThreadedTest(vtkmsg_with_warning_C4701);
 } 
@@ -35,6 +35,27 @@
 #include "vtkUnsignedLongArray.h"
 #include "vtkUnsignedShortArray.h"
 
+#include <vtkstd/vector>
+
+#if defined(_WIN32)
+# include <malloc.h> // _aligned_malloc
+# include "vtkWindows.h" // CreateFileMapping
+#else
+# include <stdlib.h> // posix_memalign
+# include <fcntl.h> // open
+# include <sys/mman.h> // mmap, madvise
+# include <sys/stat.h> // fstat
+# include <unistd.h> // close, sysconf
+#endif
+
+// Huge pages are 2MB on the common platforms.
+#define VTK_DATA_ARRAY_HUGE_PAGE_SIZE 2097152
+
+static int vtkDataArrayGlobalDefaultAlignment = 0;
+static double vtkDataArrayGlobalDefaultGrowthFactor = 2.0;
+static vtkIdType vtkDataArrayGlobalDefaultHugePageThreshold = 0;
+static vtkIdType vtkDataArrayGlobalRangeThreadingThreshold = 1048576;
+
 vtkInformationKeyMacro(vtkDataArray, PER_COMPONENT, InformationVector);
 vtkInformationKeyRestrictedMacro(vtkDataArray, COMPONENT_RANGE, DoubleVector, 2);
 vtkInformationKeyRestrictedMacro(vtkDataArray, L2_NORM_RANGE, DoubleVector, 2);
@@ -54,6 +75,258 @@ vtkDataArray::vtkDataArray(vtkIdType numComp)
 
   this->NumberOfComponents = static_cast<int>(numComp < 1 ? 1 : numComp);
   this->Name = 0;
+
+  this->Alignment = vtkDataArrayGlobalDefaultAlignment;
+  this->GrowthFactor = vtkDataArrayGlobalDefaultGrowthFactor;
+  this->HugePageThreshold = vtkDataArrayGlobalDefaultHugePageThreshold;
+}
+
+//----------------------------------------------------------------------------
+// Alignments must be a power of two and a multiple of sizeof(void*).
+static int vtkDataArrayValidAlignment(int alignment)
+{
+  if (alignment <= 0)
+    {
+    return 0;
+    }
+  int valid = static_cast<int>(sizeof(void*));
+  while (valid < alignment && valid < (1 << 30))
+    {
+    valid <<= 1;
+    }
+  return valid;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArray::SetAlignment(int alignment)
+{
+  alignment = vtkDataArrayValidAlignment(alignment);
+  if (this->Alignment != alignment)
+    {
+    this->Alignment = alignment;
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArray::SetGlobalDefaultAlignment(int alignment)
+{
+  vtkDataArrayGlobalDefaultAlignment = vtkDataArrayValidAlignment(alignment);
+}
+
+//----------------------------------------------------------------------------
+int vtkDataArray::GetGlobalDefaultAlignment()
+{
+  return vtkDataArrayGlobalDefaultAlignment;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArray::SetGlobalDefaultGrowthFactor(double factor)
+{
+  vtkDataArrayGlobalDefaultGrowthFactor =
+    (factor < 1.1 ? 1.1 : (factor > 16.0 ? 16.0 : factor));
+}
+
+//----------------------------------------------------------------------------
+double vtkDataArray::GetGlobalDefaultGrowthFactor()
+{
+  return vtkDataArrayGlobalDefaultGrowthFactor;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArray::SetGlobalDefaultHugePageThreshold(vtkIdType threshold)
+{
+  vtkDataArrayGlobalDefaultHugePageThreshold = (threshold > 0 ? threshold : 0);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkDataArray::GetGlobalDefaultHugePageThreshold()
+{
+  return vtkDataArrayGlobalDefaultHugePageThreshold;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArray::SetGlobalRangeThreadingThreshold(vtkIdType threshold)
+{
+  vtkDataArrayGlobalRangeThreadingThreshold = (threshold > 0 ? threshold : 0);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkDataArray::GetGlobalRangeThreadingThreshold()
+{
+  return vtkDataArrayGlobalRangeThreadingThreshold;
+}
+
+//----------------------------------------------------------------------------
+int vtkDataArray::NeedsAlignedMemory(size_t size)
+{
+  return (this->Alignment > 0 ||
+          (this->HugePageThreshold > 0 &&
+           size >= static_cast<size_t>(this->HugePageThreshold)));
+}
+
+//----------------------------------------------------------------------------
+void *vtkDataArray::AllocateMemory(size_t size, int &aligned)
+{
+  aligned = 0;
+  if (!this->NeedsAlignedMemory(size))
+    {
+    return malloc(size);
+    }
+
+  int hugePages = (this->HugePageThreshold > 0 &&
+                   size >= static_cast<size_t>(this->HugePageThreshold));
+  size_t alignment = static_cast<size_t>(
+    hugePages ? VTK_DATA_ARRAY_HUGE_PAGE_SIZE : this->Alignment);
+  if (hugePages && static_cast<size_t>(this->Alignment) > alignment)
+    {
+    alignment = static_cast<size_t>(this->Alignment);
+    }
+
+  void *ptr = 0;
+#if defined(_WIN32)
+  ptr = _aligned_malloc(size, alignment);
+#else
+  if (posix_memalign(&ptr, alignment, size) != 0)
+    {
+    ptr = 0;
+    }
+#endif
+  if (!ptr)
+    {
+    return 0;
+    }
+  aligned = 1;
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (hugePages)
+    {
+    // Only a hint, the kernel may not have transparent huge pages.
+    madvise(ptr, size, MADV_HUGEPAGE);
+    }
+#endif
+  return ptr;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArray::FreeAlignedMemory(void *ptr)
+{
+#if defined(_WIN32)
+  _aligned_free(ptr);
+#else
+  free(ptr);
+#endif
+}
+
+//----------------------------------------------------------------------------
+void *vtkDataArray::MapFileRegion(const char *fileName, vtkTypeInt64 offset,
+                                  size_t length, int copyOnWrite,
+                                  void *&base, size_t &baseLength)
+{
+  base = 0;
+  baseLength = 0;
+  if (!fileName || offset < 0 || length == 0)
+    {
+    return 0;
+    }
+
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, 0,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+  if (file == INVALID_HANDLE_VALUE)
+    {
+    return 0;
+    }
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) ||
+      static_cast<vtkTypeInt64>(fileSize.QuadPart) - offset <
+      static_cast<vtkTypeInt64>(length))
+    {
+    CloseHandle(file);
+    return 0;
+    }
+  HANDLE mapping = CreateFileMappingA(
+    file, 0, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, 0);
+  CloseHandle(file);
+  if (!mapping)
+    {
+    return 0;
+    }
+
+  // Views start on an allocation granularity boundary.
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  vtkTypeInt64 start = offset -
+    offset % static_cast<vtkTypeInt64>(systemInfo.dwAllocationGranularity);
+  size_t skip = static_cast<size_t>(offset - start);
+  base = MapViewOfFile(mapping, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ,
+                       static_cast<DWORD>(start >> 32),
+                       static_cast<DWORD>(start & 0xffffffff),
+                       skip + length);
+  // The view keeps the mapping alive.
+  CloseHandle(mapping);
+#else
+  int fd = open(fileName, O_RDONLY);
+  if (fd < 0)
+    {
+    return 0;
+    }
+  struct stat fs;
+  if (fstat(fd, &fs) != 0 ||
+      static_cast<vtkTypeInt64>(fs.st_size) - offset <
+      static_cast<vtkTypeInt64>(length))
+    {
+    // Touching pages past the end of the file would raise SIGBUS.
+    close(fd);
+    return 0;
+    }
+
+  vtkTypeInt64 pageSize = static_cast<vtkTypeInt64>(sysconf(_SC_PAGESIZE));
+  vtkTypeInt64 start = offset - offset % pageSize;
+  size_t skip = static_cast<size_t>(offset - start);
+  base = mmap(0, skip + length,
+              copyOnWrite ? (PROT_READ | PROT_WRITE) : PROT_READ,
+              copyOnWrite ? MAP_PRIVATE : MAP_SHARED,
+              fd, static_cast<off_t>(start));
+  // The mapping keeps the file open.
+  close(fd);
+  if (base == MAP_FAILED)
+    {
+    base = 0;
+    }
+#endif
+
+  if (!base)
+    {
+    return 0;
+    }
+  baseLength = skip + length;
+  return static_cast<char *>(base) + skip;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArray::UnmapFileRegion(void *base, size_t baseLength)
+{
+  if (!base)
+    {
+    return;
+    }
+#if defined(_WIN32)
+  (void)baseLength;
+  UnmapViewOfFile(base);
+#else
+  munmap(base, baseLength);
+#endif
+}
+
+//----------------------------------------------------------------------------
+int vtkDataArray::MapFile(const char *vtkNotUsed(fileName),
+                          vtkTypeInt64 vtkNotUsed(offset),
+                          vtkIdType vtkNotUsed(numberOfValues),
+                          int vtkNotUsed(copyOnWrite))
+{
+  vtkErrorMacro("Memory mapping is not supported by " << this->GetClassName());
+  return 0;
 }
 
 //----------------------------------------------------------------------------
@@ -1083,12 +1356,37 @@ void vtkDataArray::ComputeRange(int comp)
     }
   else
     {
-    this->ComputeScalarRange( comp );
+    // Scanning all components costs about the same as scanning one, so
+    // cache the ranges of the others as well.
+    vtkstd::vector<double> ranges( 2*this->NumberOfComponents );
+    if ( this->ComputeComponentRanges( &ranges[0] ) )
+      {
+      vtkInformationVector* infoVec = this->GetInformation()->Get( PER_COMPONENT() );
+      for ( int i = 0; i < this->NumberOfComponents; ++i )
+        {
+        if ( i != comp )
+          {
+          infoVec->GetInformationObject( i )->Set( rkey, &ranges[2*i], 2 );
+          }
+        }
+      this->Range[0] = ranges[2*comp];
+      this->Range[1] = ranges[2*comp+1];
+      }
+    else
+      {
+      this->ComputeScalarRange( comp );
+      }
     }
 
   info->Set( rkey, this->Range, 2 );
 }
 
+//----------------------------------------------------------------------------
+int vtkDataArray::ComputeComponentRanges(double* vtkNotUsed(ranges))
+{
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 void vtkDataArray::ComputeScalarRange(int comp)
 {
@@ -1237,6 +1535,9 @@ void vtkDataArray::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Number Of Tuples: " << this->GetNumberOfTuples() << "\n";
   os << indent << "Size: " << this->Size << "\n";
   os << indent << "MaxId: " << this->MaxId << "\n";
+  os << indent << "Alignment: " << this->Alignment << "\n";
+  os << indent << "Growth Factor: " << this->GrowthFactor << "\n";
+  os << indent << "Huge Page Threshold: " << this->HugePageThreshold << "\n";
   if ( this->LookupTable )
     {
     os << indent << "Lookup Table:\n";
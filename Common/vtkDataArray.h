@@ -371,16 +371,86 @@ public:
   // keys not inteneded to be coppied are excluded here.
   virtual int CopyInformation(vtkInformation *infoFrom, int deep=1);
 
+  // Description:
+  // Set/Get the byte alignment of the memory allocated by this array,
+  // for example 64 to start the data on a cache line for SIMD loads.  It
+  // must be a power of two; 0 uses the alignment of malloc().  Aligned
+  // arrays are grown by allocating and copying instead of realloc().
+  // Defaults to GetGlobalDefaultAlignment().
+  void SetAlignment(int alignment);
+  vtkGetMacro(Alignment, int);
+
+  // Description:
+  // Set/Get the factor by which the allocation grows when values are
+  // inserted past its end.  The default of 2 doubles it; smaller values
+  // waste less memory at the cost of more reallocations.  Defaults to
+  // GetGlobalDefaultGrowthFactor().
+  vtkSetClampMacro(GrowthFactor, double, 1.1, 16.0);
+  vtkGetMacro(GrowthFactor, double);
+
+  // Description:
+  // Set/Get the allocation size in bytes from which the memory is aligned
+  // to huge pages and, on Linux, marked for transparent huge pages, which
+  // reduces TLB misses on very large arrays.  0 turns this off.  Defaults
+  // to GetGlobalDefaultHugePageThreshold().
+  vtkSetClampMacro(HugePageThreshold, vtkIdType, 0, VTK_LARGE_ID);
+  vtkGetMacro(HugePageThreshold, vtkIdType);
+
+  // Description:
+  // Set/Get the allocation policy of arrays created from now on.  The
+  // defaults are an alignment of 0, a growth factor of 2 and no huge
+  // pages.
+  static void SetGlobalDefaultAlignment(int alignment);
+  static int GetGlobalDefaultAlignment();
+  static void SetGlobalDefaultGrowthFactor(double factor);
+  static double GetGlobalDefaultGrowthFactor();
+  static void SetGlobalDefaultHugePageThreshold(vtkIdType threshold);
+  static vtkIdType GetGlobalDefaultHugePageThreshold();
+
+  // Description:
+  // Set/Get the number of values from which GetRange() scans an array on
+  // several threads.  0 always scans on the calling thread.  The default
+  // is 1048576.
+  static void SetGlobalRangeThreadingThreshold(vtkIdType threshold);
+  static vtkIdType GetGlobalRangeThreadingThreshold();
+
+  //BTX
+  // Description:
+  // Bind the array to numberOfValues values stored in the file fileName,
+  // starting offset bytes into it, instead of reading them into memory.
+  // The file is memory mapped and its pages are read when first touched.
+  // With copyOnWrite set the values may be modified; modified pages are
+  // private to this array and never written back.  Without it the values
+  // are read-only and writing to them, through the API or a pointer,
+  // crashes.  Resizing or reallocating the array copies the values into
+  // ordinary memory.  The values must be in the native byte order and
+  // offset a multiple of their size.  Returns 1 on success and 0, leaving
+  // the array unchanged, if the file region cannot be mapped or the array
+  // type does not support mapping.
+  virtual int MapFile(const char *fileName, vtkTypeInt64 offset,
+                      vtkIdType numberOfValues, int copyOnWrite);
+  //ETX
+
+  // Description:
+  // Return 1 if the values are held in a file mapped by MapFile().
+  virtual int GetMemoryMapped() { return 0; }
+
 protected:
   // Description:
   // Compute the range for a specific component. If comp is set -1
   // then L2 norm is computed on all components. Call ClearRange
-  // to force a recomputation if it is needed.
+  // to force a recomputation if it is needed.  The ranges of all
+  // components are computed and cached together.
   virtual void ComputeRange(int comp);
   // Description:
   // Slow range computation methods. Reimplement.
   virtual void ComputeScalarRange(int comp);
   virtual void ComputeVectorRange();
+  // Description:
+  // Compute the ranges of all components in one pass into ranges, which
+  // holds two values per component.  Returns 0 if not implemented, in
+  // which case ComputeScalarRange() is used for each component.
+  virtual int ComputeComponentRanges(double *ranges);
 
   // Construct object with default tuple dimension (number of components) of 1.
   vtkDataArray(vtkIdType numComp=1);
@@ -389,6 +459,27 @@ protected:
   vtkLookupTable *LookupTable;
   double Range[2];
 
+  // Allocation policy.  AllocateMemory() returns memory of size bytes
+  // following it and sets aligned to 1 if the memory must be released with
+  // FreeAlignedMemory() rather than free().  NeedsAlignedMemory() tells
+  // whether an allocation of size bytes would be aligned, in which case it
+  // cannot be grown with realloc().
+  int Alignment;
+  double GrowthFactor;
+  vtkIdType HugePageThreshold;
+  void *AllocateMemory(size_t size, int &aligned);
+  int NeedsAlignedMemory(size_t size);
+  static void FreeAlignedMemory(void *ptr);
+
+  // Memory mapping.  MapFileRegion() maps length bytes of fileName starting
+  // at offset and returns a pointer to the first of them, or 0 on failure.
+  // The mapping itself starts at the page boundary below offset; base and
+  // baseLength describe it for UnmapFileRegion().
+  static void *MapFileRegion(const char *fileName, vtkTypeInt64 offset,
+                             size_t length, int copyOnWrite,
+                             void *&base, size_t &baseLength);
+  static void UnmapFileRegion(void *base, size_t baseLength);
+
 private:
   double* GetTupleN(vtkIdType i, int n);
   
@@ -187,7 +187,9 @@ public:
   enum DeleteMethod
   {
     VTK_DATA_ARRAY_FREE,
-    VTK_DATA_ARRAY_DELETE
+    VTK_DATA_ARRAY_DELETE,
+    VTK_DATA_ARRAY_ALIGNED_FREE,
+    VTK_DATA_ARRAY_UNMAP
   };
 //ETX
 
@@ -200,7 +202,10 @@ public:
   // suppled array. If specified, the delete method determines how the data
   // array will be deallocated. If the delete method is
   // VTK_DATA_ARRAY_FREE, free() will be used. If the delete method is
-  // DELETE, delete[] will be used. The default is FREE.
+  // DELETE, delete[] will be used. VTK_DATA_ARRAY_ALIGNED_FREE is for
+  // memory from _aligned_malloc() on Windows and posix_memalign()
+  // elsewhere. The default is FREE.  VTK_DATA_ARRAY_UNMAP is used
+  // internally by MapFile() and cannot be given here.
   void SetArray(T* array, vtkIdType size, int save, int deleteMethod);
   void SetArray(T* array, vtkIdType size, int save)
     { this->SetArray(array, size, save, VTK_DATA_ARRAY_FREE); }
@@ -214,6 +219,15 @@ public:
       this->SetArray(static_cast<T*>(array), size, save, deleteMethod); 
     }
 
+  //BTX
+  // Description:
+  // Bind the array to values stored in a file.  See vtkDataArray.
+  virtual int MapFile(const char *fileName, vtkTypeInt64 offset,
+                      vtkIdType numberOfValues, int copyOnWrite);
+  //ETX
+  virtual int GetMemoryMapped()
+    { return this->DeleteMethod == VTK_DATA_ARRAY_UNMAP; }
+
   // Description:
   // This method copies the array data to the void pointer specified
   // by the user.  It is up to the user to allocate enough memory for
@@ -268,8 +282,13 @@ protected:
   int SaveUserArray;
   int DeleteMethod;
 
+  // The file mapping set up by MapFile().
+  void *MappedBase;
+  size_t MappedLength;
+
   virtual void ComputeScalarRange(int comp);
   virtual void ComputeVectorRange();
+  virtual int ComputeComponentRanges(double *ranges);
 private:
   vtkDataArrayTemplate(const vtkDataArrayTemplate&);  // Not implemented.
   void operator=(const vtkDataArrayTemplate&);  // Not implemented.
@@ -23,13 +23,16 @@
 #include "vtkInformationDoubleVectorKey.h"
 #include "vtkInformationInformationVectorKey.h"
 #include "vtkInformationVector.h"
+#include "vtkParallelFor.h"
 #include "vtkSortDataArray.h"
 #include "vtkTypeTraits.h"
+#include <vtkstd/limits>
 #include <vtkstd/new>
 #include <vtkstd/exception>
 #include <vtkstd/utility>
 #include <vtkstd/algorithm>
 #include <vtkstd/map>
+#include <vtkstd/vector>
 
 // We do not provide a definition for the copy constructor or
 // operator=.  Block the warning.
@@ -76,6 +79,8 @@ vtkDataArrayTemplate<T>::vtkDataArrayTemplate(vtkIdType numComp):
   this->TupleSize = 0;
   this->SaveUserArray = 0;
   this->DeleteMethod = VTK_DATA_ARRAY_FREE;
+  this->MappedBase = 0;
+  this->MappedLength = 0;
   this->Lookup = 0;
 }
 
@@ -119,22 +124,64 @@ void vtkDataArrayTemplate<T>::SetArray(T* array,
   this->DataChanged();
 }
 
+//----------------------------------------------------------------------------
+template <class T>
+int vtkDataArrayTemplate<T>::MapFile(const char *fileName,
+                                     vtkTypeInt64 offset,
+                                     vtkIdType numberOfValues,
+                                     int copyOnWrite)
+{
+  if (numberOfValues <= 0 || offset < 0 ||
+      offset % static_cast<vtkTypeInt64>(sizeof(T)) != 0)
+    {
+    vtkErrorMacro("Cannot map " << numberOfValues << " values at offset "
+                  << offset);
+    return 0;
+    }
+
+  void *base;
+  size_t length;
+  void *ptr = vtkDataArray::MapFileRegion(
+    fileName, offset, static_cast<size_t>(numberOfValues)*sizeof(T),
+    copyOnWrite, base, length);
+  if (!ptr)
+    {
+    vtkErrorMacro("Unable to map " << numberOfValues << " values at offset "
+                  << offset << " of file " << (fileName ? fileName : "(null)"));
+    return 0;
+    }
+
+  this->DeleteArray();
+  this->Array = static_cast<T*>(ptr);
+  this->Size = numberOfValues;
+  this->MaxId = numberOfValues-1;
+  this->DeleteMethod = VTK_DATA_ARRAY_UNMAP;
+  this->MappedBase = base;
+  this->MappedLength = length;
+  this->DataChanged();
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 // Allocate memory for this array. Delete old storage only if necessary.
+// A file mapping is never reused, it may be read-only.
 template <class T>
 int vtkDataArrayTemplate<T>::Allocate(vtkIdType sz, vtkIdType)
 {
   this->MaxId = -1;
 
-  if(sz > this->Size)
+  if(sz > this->Size || this->DeleteMethod == VTK_DATA_ARRAY_UNMAP)
     {
     this->DeleteArray();
 
     this->Size = 0;
 
     vtkIdType newSize = (sz > 0 ? sz : 1);
-    this->Array = static_cast<T*>(malloc(static_cast<size_t>(newSize)
-                                         * sizeof(T)));
+    int aligned;
+    this->Array = static_cast<T*>(
+      this->AllocateMemory(static_cast<size_t>(newSize)*sizeof(T), aligned));
+    this->DeleteMethod = (aligned ? VTK_DATA_ARRAY_ALIGNED_FREE :
+                          VTK_DATA_ARRAY_FREE);
     if(this->Array==0)
       {
       vtkErrorMacro("Unable to allocate " << newSize
@@ -204,8 +251,11 @@ void vtkDataArrayTemplate<T>::DeepCopy(vtkDataArray* fa)
   this->Size = fa->GetSize();
 
   this->Size = (this->Size > 0 ? this->Size : 1);
+  int aligned;
   this->Array = static_cast<T* >(
-    malloc(static_cast<size_t>(this->Size) * sizeof(T)));
+    this->AllocateMemory(static_cast<size_t>(this->Size)*sizeof(T), aligned));
+  this->DeleteMethod = (aligned ? VTK_DATA_ARRAY_ALIGNED_FREE :
+                        VTK_DATA_ARRAY_FREE);
   if(this->Array==0)
     {
     vtkErrorMacro("Unable to allocate " << this->Size
@@ -249,6 +299,8 @@ void vtkDataArrayTemplate<T>::PrintSelf(ostream& os, vtkIndent indent)
     {
     osw << indent << "Array: (null)\n";
     }
+  osw << indent << "Memory Mapped: "
+      << (this->GetMemoryMapped() ? "On" : "Off") << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -261,6 +313,16 @@ void vtkDataArrayTemplate<T>::DeleteArray()
       {
       free(this->Array);
       }
+    else if (this->DeleteMethod == VTK_DATA_ARRAY_ALIGNED_FREE)
+      {
+      vtkDataArray::FreeAlignedMemory(this->Array);
+      }
+    else if (this->DeleteMethod == VTK_DATA_ARRAY_UNMAP)
+      {
+      vtkDataArray::UnmapFileRegion(this->MappedBase, this->MappedLength);
+      this->MappedBase = 0;
+      this->MappedLength = 0;
+      }
     else
       {
       delete[] this->Array;
@@ -281,9 +343,10 @@ T* vtkDataArrayTemplate<T>::ResizeAndExtend(vtkIdType sz)
   if(sz > this->Size)
     {
     // Requested size is bigger than current size.  Allocate enough
-    // memory to fit the requested size and be more than double the
-    // currently allocated memory.
-    newSize = this->Size + sz;
+    // memory to fit the requested size and grow the currently allocated
+    // memory by GrowthFactor (by default more than double it).
+    newSize = sz + static_cast<vtkIdType>((this->GrowthFactor - 1.0) *
+                                          this->Size);
     }
   else if (sz == this->Size)
     {
@@ -313,14 +376,18 @@ T* vtkDataArrayTemplate<T>::ResizeAndExtend(vtkIdType sz)
   dontUseRealloc=true;
   #endif
 
-  // Allocate the new array or reallocate the old.
+  // Allocate the new array or reallocate the old.  realloc() does not
+  // keep the alignment the allocation policy may ask for.
+  size_t newBytes = static_cast<size_t>(newSize)*sizeof(T);
   if (this->Array
       && 
       (this->SaveUserArray 
-       || this->DeleteMethod==VTK_DATA_ARRAY_DELETE
+       || this->DeleteMethod!=VTK_DATA_ARRAY_FREE
+       || this->NeedsAlignedMemory(newBytes)
        || dontUseRealloc ))
     {
-    newArray = static_cast<T*>(malloc(static_cast<size_t>(newSize)*sizeof(T)));
+    int aligned;
+    newArray = static_cast<T*>(this->AllocateMemory(newBytes, aligned));
     if(!newArray)
       {
       vtkErrorMacro("Unable to allocate " << newSize
@@ -345,13 +412,37 @@ T* vtkDataArrayTemplate<T>::ResizeAndExtend(vtkIdType sz)
 
     // Realease old array if we own
     this->DeleteArray();
+    this->DeleteMethod = (aligned ? VTK_DATA_ARRAY_ALIGNED_FREE :
+                          VTK_DATA_ARRAY_FREE);
+    }
+  else if (!this->Array)
+    {
+    int aligned;
+    newArray = static_cast<T*>(this->AllocateMemory(newBytes, aligned));
+    if(!newArray)
+      {
+      vtkErrorMacro("Unable to allocate " << newSize
+                    << " elements of size " << sizeof(T)
+                    << " bytes. ");
+      #if !defined NDEBUG
+      // We're debugging, crash here preserving the stack
+      abort();
+      #elif !defined VTK_DONT_THROW_BAD_ALLOC
+      // We can throw something that has universal meaning
+      throw vtkstd::bad_alloc();
+      #else
+      // We indicate that malloc failed by return
+      return 0;
+      #endif
+      }
+    this->DeleteMethod = (aligned ? VTK_DATA_ARRAY_ALIGNED_FREE :
+                          VTK_DATA_ARRAY_FREE);
     }
   else
     {
     // Try to reallocate with minimal memory usage and possibly avoid
     // copying.
-    newArray = static_cast<T*>(
-      realloc(this->Array,static_cast<size_t>(newSize)*sizeof(T)));
+    newArray = static_cast<T*>(realloc(this->Array,newBytes));
     if(!newArray)
       {
       vtkErrorMacro("Unable to allocate " << newSize
@@ -513,12 +604,18 @@ vtkIdType vtkDataArrayTemplate<T>::InsertNextTuple(vtkIdType j,
       }
     }
 
+  // Make room for the whole tuple at once, then copy it.
+  T* outPtr = this->WritePointer(this->MaxId + 1, this->NumberOfComponents);
+  if (outPtr==0)
+    {
+    return -1;
+    }
   T* data = static_cast<T*>(source->GetVoidPointer(0));
   vtkIdType locj = j * source->GetNumberOfComponents();
   
   for (vtkIdType cur = 0; cur < this->NumberOfComponents; cur++)
     {
-    this->InsertNextValue(data[locj + cur]);
+    outPtr[cur] = data[locj + cur];
     }
   return (this->GetNumberOfTuples()-1);
 }
@@ -919,76 +1016,255 @@ vtkIdType vtkDataArrayTemplate<T>::InsertNextValue(T f)
 }
 
 //----------------------------------------------------------------------------
+// Range kernels.  The comparisons are written as selects, which compile
+// to branch-free min/max instructions.  NaN values are skipped: they are
+// tested for with an equality, as an ordered comparison with NaN raises
+// the invalid floating point exception.
 template <class T>
-void vtkDataArrayTemplate<T>::ComputeScalarRange(int comp)
+inline void vtkDataArrayTemplateMinMax(T v, T& low, T& high)
 {
-  // Compute range only if there are data.
-  T* begin = this->Array+comp;
-  T* end = this->Array+comp+this->MaxId+1;
-  if(begin == end)
+  low = (v < low ? v : low);
+  high = (v > high ? v : high);
+}
+
+inline void vtkDataArrayTemplateMinMax(float v, float& low, float& high)
+{
+  if(v == v)
     {
-    return;
+    low = (v < low ? v : low);
+    high = (v > high ? v : high);
     }
+}
 
-  // Compute the range of scalar values.
-  int numComp = this->NumberOfComponents;
-  T range[2] = {vtkTypeTraits<T>::Max(), vtkTypeTraits<T>::Min()};
-  for(T* i = begin; i != end; i += numComp)
+inline void vtkDataArrayTemplateMinMax(double v, double& low, double& high)
+{
+  if(v == v)
     {
-    T s = *i;
-    if(s < range[0])
+    low = (v < low ? v : low);
+    high = (v > high ? v : high);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Update ranges, two values per component, with the tuples [begin, end).
+template <class T>
+void vtkDataArrayTemplateComponentRanges(const T* array, vtkIdType begin,
+                                         vtkIdType end, int numComp,
+                                         T* ranges)
+{
+  if(numComp == 1)
+    {
+    // Independent accumulators let consecutive values be compared in
+    // parallel.
+    const T* p = array + begin;
+    vtkIdType n = end - begin;
+    T low[4] = {ranges[0], ranges[0], ranges[0], ranges[0]};
+    T high[4] = {ranges[1], ranges[1], ranges[1], ranges[1]};
+    vtkIdType i = 0;
+    for(; i + 4 <= n; i += 4)
       {
-      range[0] = s;
+      vtkDataArrayTemplateMinMax(p[i], low[0], high[0]);
+      vtkDataArrayTemplateMinMax(p[i+1], low[1], high[1]);
+      vtkDataArrayTemplateMinMax(p[i+2], low[2], high[2]);
+      vtkDataArrayTemplateMinMax(p[i+3], low[3], high[3]);
       }
-    if(s > range[1])
+    for(; i < n; ++i)
       {
-      range[1] = s;
+      vtkDataArrayTemplateMinMax(p[i], low[0], high[0]);
       }
+    for(int j = 1; j < 4; ++j)
+      {
+      vtkDataArrayTemplateMinMax(low[j], low[0], high[0]);
+      vtkDataArrayTemplateMinMax(high[j], low[0], high[0]);
+      }
+    ranges[0] = low[0];
+    ranges[1] = high[0];
+    return;
     }
 
-  // Store the range.
-  this->Range[0] = static_cast<double>(range[0]);
-  this->Range[1] = static_cast<double>(range[1]);
+  const T* p = array + begin*numComp;
+  for(vtkIdType i = begin; i < end; ++i, p += numComp)
+    {
+    for(int j = 0; j < numComp; ++j)
+      {
+      vtkDataArrayTemplateMinMax(p[j], ranges[2*j], ranges[2*j+1]);
+      }
+    }
 }
 
 //----------------------------------------------------------------------------
+// Update range with the squared magnitudes of the tuples [begin, end).
 template <class T>
-void vtkDataArrayTemplate<T>::ComputeVectorRange()
+void vtkDataArrayTemplateMagnitudeRange(const T* array, vtkIdType begin,
+                                        vtkIdType end, int numComp,
+                                        double* range)
 {
-  // Compute range only if there are data.
-  T* begin = this->Array;
-  T* end = this->Array+this->MaxId+1;
-  if(begin == end)
+  const T* p = array + begin*numComp;
+  for(vtkIdType i = begin; i < end; ++i, p += numComp)
     {
-    return;
+    double s = 0.0;
+    for(int j = 0; j < numComp; ++j)
+      {
+      double t = static_cast<double>(p[j]);
+      s += t*t;
+      }
+    vtkDataArrayTemplateMinMax(s, range[0], range[1]);
     }
+}
 
-  // Compute the range of vector magnitude squared.
-  int numComp = this->NumberOfComponents;
-  double range[2] = {VTK_DOUBLE_MAX, VTK_DOUBLE_MIN};
-  for(T* i = begin; i != end; i += numComp)
+//----------------------------------------------------------------------------
+// Computes the component or magnitude ranges of an array, one partial
+// result per thread.
+template <class T>
+class vtkDataArrayTemplateRangeFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkDataArrayTemplateRangeFunctor(const T* array, int numComp,
+                                   int magnitude)
+    : Array(array), NumberOfComponents(numComp), Magnitude(magnitude) {}
+
+  virtual void Initialize(int numberOfThreads)
+    {
+    // Start from the widest possible empty range.
+    typedef vtkstd::numeric_limits<T> limits;
+    T low = (limits::has_infinity ? -limits::infinity() :
+             (limits::is_integer ? limits::min() : -limits::max()));
+    T high = (limits::has_infinity ? limits::infinity() : limits::max());
+    this->Ranges.resize(2*this->NumberOfComponents*numberOfThreads);
+    for(size_t i = 0; i < this->Ranges.size(); i += 2)
+      {
+      this->Ranges[i] = high;
+      this->Ranges[i+1] = low;
+      }
+    this->MagnitudeRanges.resize(2*numberOfThreads);
+    for(size_t i = 0; i < this->MagnitudeRanges.size(); i += 2)
+      {
+      this->MagnitudeRanges[i] = VTK_DOUBLE_MAX;
+      this->MagnitudeRanges[i+1] = VTK_DOUBLE_MIN;
+      }
+    }
+
+  virtual void Execute(vtkIdType begin, vtkIdType end, int threadId)
     {
-    double s = 0.0;
-    for(int j=0; j < numComp; ++j)
+    if(this->Magnitude)
       {
-      double t = static_cast<double>(i[j]);
-      s += t*t;
+      vtkDataArrayTemplateMagnitudeRange(
+        this->Array, begin, end, this->NumberOfComponents,
+        &this->MagnitudeRanges[2*threadId]);
+      }
+    else
+      {
+      vtkDataArrayTemplateComponentRanges(
+        this->Array, begin, end, this->NumberOfComponents,
+        &this->Ranges[2*this->NumberOfComponents*threadId]);
+      }
+    }
+
+  virtual void Reduce()
+    {
+    size_t n = 2*this->NumberOfComponents;
+    for(size_t i = n; i < this->Ranges.size(); i += 2)
+      {
+      vtkDataArrayTemplateMinMax(this->Ranges[i], this->Ranges[i%n],
+                                 this->Ranges[i%n+1]);
+      vtkDataArrayTemplateMinMax(this->Ranges[i+1], this->Ranges[i%n],
+                                 this->Ranges[i%n+1]);
+      }
+    for(size_t i = 2; i < this->MagnitudeRanges.size(); i += 2)
+      {
+      vtkDataArrayTemplateMinMax(this->MagnitudeRanges[i],
+                                 this->MagnitudeRanges[0],
+                                 this->MagnitudeRanges[1]);
+      vtkDataArrayTemplateMinMax(this->MagnitudeRanges[i+1],
+                                 this->MagnitudeRanges[0],
+                                 this->MagnitudeRanges[1]);
       }
-    if(s < range[0])
+    }
+
+  const T* Array;
+  int NumberOfComponents;
+  int Magnitude;
+  vtkstd::vector<T> Ranges;
+  vtkstd::vector<double> MagnitudeRanges;
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkDataArrayTemplateComputeRange(vtkDataArrayTemplateRangeFunctor<T>& f,
+                                      vtkIdType numTuples)
+{
+  vtkIdType threshold = vtkDataArray::GetGlobalRangeThreadingThreshold();
+  if(threshold > 0 && numTuples*f.NumberOfComponents >= threshold)
+    {
+    vtkParallelFor* pf = vtkParallelFor::New();
+    pf->Execute(0, numTuples, &f);
+    pf->Delete();
+    }
+  else
+    {
+    f.Initialize(1);
+    f.Execute(0, numTuples, 0);
+    f.Reduce();
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+int vtkDataArrayTemplate<T>::ComputeComponentRanges(double* ranges)
+{
+  int numComp = this->NumberOfComponents;
+  vtkIdType numTuples = (this->MaxId+1)/numComp;
+  vtkDataArrayTemplateRangeFunctor<T> f(this->Array, numComp, 0);
+  vtkDataArrayTemplateComputeRange(f, numTuples);
+
+  // Components without data, or only NaN, keep the invalid range.
+  for(int j = 0; j < numComp; ++j)
+    {
+    if(numTuples > 0 && !(f.Ranges[2*j] > f.Ranges[2*j+1]))
       {
-      range[0] = s;
+      ranges[2*j] = static_cast<double>(f.Ranges[2*j]);
+      ranges[2*j+1] = static_cast<double>(f.Ranges[2*j+1]);
       }
-    // this cannot be an elseif because there may be only one vector in which
-    // case the range[1] would be left at a bad value
-    if(s > range[1])
+    else
       {
-      range[1] = s;
+      ranges[2*j] = VTK_DOUBLE_MAX;
+      ranges[2*j+1] = VTK_DOUBLE_MIN;
       }
     }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkDataArrayTemplate<T>::ComputeScalarRange(int comp)
+{
+  vtkstd::vector<double> ranges(2*this->NumberOfComponents);
+  this->ComputeComponentRanges(&ranges[0]);
+  this->Range[0] = ranges[2*comp];
+  this->Range[1] = ranges[2*comp+1];
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkDataArrayTemplate<T>::ComputeVectorRange()
+{
+  int numComp = this->NumberOfComponents;
+  vtkIdType numTuples = (this->MaxId+1)/numComp;
+  if(numTuples == 0)
+    {
+    return;
+    }
+
+  // Compute the range of vector magnitude squared.
+  vtkDataArrayTemplateRangeFunctor<T> f(this->Array, numComp, 1);
+  vtkDataArrayTemplateComputeRange(f, numTuples);
 
   // Store the range of vector magnitude.
-  this->Range[0] = sqrt(range[0]);
-  this->Range[1] = sqrt(range[1]);
+  if(f.MagnitudeRanges[0] <= f.MagnitudeRanges[1])
+    {
+    this->Range[0] = sqrt(f.MagnitudeRanges[0]);
+    this->Range[1] = sqrt(f.MagnitudeRanges[1]);
+    }
 }
 
 //----------------------------------------------------------------------------
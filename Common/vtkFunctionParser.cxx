@@ -525,6 +525,37 @@ int vtkFunctionParser::DisambiguateOperators()
 }
 
 bool vtkFunctionParser::Evaluate()
+{
+  if (!this->EvaluateByteCode())
+    {
+    return false;
+    }
+  this->EvaluateMTime.Modified();
+  return true;
+}
+
+double *vtkFunctionParser::EvaluateValues(const double *scalarValues,
+                                          const double *vectorValues)
+{
+  int i;
+  for (i = 0; i < this->NumberOfScalarVariables; i++)
+    {
+    this->ScalarVariableValues[i] = scalarValues[i];
+    }
+  for (i = 0; i < this->NumberOfVectorVariables; i++)
+    {
+    this->VectorVariableValues[i][0] = vectorValues[3*i];
+    this->VectorVariableValues[i][1] = vectorValues[3*i+1];
+    this->VectorVariableValues[i][2] = vectorValues[3*i+2];
+    }
+  if (!this->EvaluateByteCode())
+    {
+    return NULL;
+    }
+  return this->Stack;
+}
+
+bool vtkFunctionParser::EvaluateByteCode()
 {
   int numBytesProcessed;
   int numImmediatesProcessed = 0;
@@ -947,8 +978,6 @@ bool vtkFunctionParser::Evaluate()
     }
   this->StackPointer = stackPosition;
 
-  this->EvaluateMTime.Modified();
-
   return true;
 }
 
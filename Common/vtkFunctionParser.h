@@ -172,6 +172,19 @@ public:
                               double zValue);
   void SetVectorVariableValue(int i, const double values[3]) {
     this->SetVectorVariableValue(i,values[0],values[1],values[2]);};
+
+  // Description:
+  // Evaluate the function for the given values of the scalar variables,
+  // and of the vector variables three by three, in the order of their
+  // indices.  Return the scalar or vector result, or NULL if the function
+  // could not be evaluated.  Unlike setting the variables one by one this
+  // leaves the modification times alone, which makes it cheap enough to
+  // call once per tuple, also from several threads each with a parser of
+  // its own.
+  //BTX
+  double *EvaluateValues(const double *scalarValues,
+                         const double *vectorValues);
+  //ETX
   
   // Description:
   // Get the value of a vector variable.
@@ -230,7 +243,10 @@ protected:
   int Parse();
   // Description:
   // Evaluate the function, returning true on success, false on failure.
+  // EvaluateByteCode() does the work without marking the result as up to
+  // date.
   bool Evaluate();
+  bool EvaluateByteCode();
 
   int CheckSyntax();
   void RemoveSpaces();
@@ -147,12 +147,14 @@ void vtkInformation::SetAsObjectBase(vtkInformationKey* key,
       {
       this->Internal->Map.erase(i);
       }
-    oldvalue->UnRegister(0);
+    if(oldvalue)
+      {
+      oldvalue->UnRegister(0);
+      }
     }
   else if(newvalue)
     {
-    MapType::value_type entry(key, newvalue);
-    this->Internal->Map.insert(entry);
+    this->Internal->Map.insert(key)->second = newvalue;
     newvalue->Register(0);
     }
   this->Modified(key);
@@ -173,6 +175,54 @@ vtkObjectBase* vtkInformation::GetAsObjectBase(vtkInformationKey* key)
   return 0;
 }
 
+//----------------------------------------------------------------------------
+void vtkInformation::SetAsInteger(vtkInformationKey* key, int value)
+{
+  size_t size = this->Internal->Map.size();
+  vtkInformationInternals::Entry* e = this->Internal->Map.insert(key);
+  if(this->Internal->Map.size() != size || e->Scalar.Integer != value)
+    {
+    e->Scalar.Integer = value;
+    this->Modified(key);
+    }
+}
+
+//----------------------------------------------------------------------------
+int* vtkInformation::GetAsIntegerAddress(vtkInformationKey* key)
+{
+  typedef vtkInformationInternals::MapType MapType;
+  MapType::iterator i = this->Internal->Map.find(key);
+  if(i != this->Internal->Map.end())
+    {
+    return &i->Scalar.Integer;
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkInformation::SetAsDouble(vtkInformationKey* key, double value)
+{
+  size_t size = this->Internal->Map.size();
+  vtkInformationInternals::Entry* e = this->Internal->Map.insert(key);
+  if(this->Internal->Map.size() != size || e->Scalar.Double != value)
+    {
+    e->Scalar.Double = value;
+    this->Modified(key);
+    }
+}
+
+//----------------------------------------------------------------------------
+double* vtkInformation::GetAsDoubleAddress(vtkInformationKey* key)
+{
+  typedef vtkInformationInternals::MapType MapType;
+  MapType::iterator i = this->Internal->Map.find(key);
+  if(i != this->Internal->Map.end())
+    {
+    return &i->Scalar.Double;
+    }
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 void vtkInformation::Clear()
 {
@@ -455,6 +455,13 @@ protected:
   VTK_COMMON_EXPORT void SetAsObjectBase(vtkInformationKey* key, vtkObjectBase* value);
   VTK_COMMON_EXPORT vtkObjectBase* GetAsObjectBase(vtkInformationKey* key);
 
+  // Get/Set an integer or double entry stored inline in the map, without
+  // a value object.  The Get methods return 0 if there is no entry.
+  VTK_COMMON_EXPORT void SetAsInteger(vtkInformationKey* key, int value);
+  VTK_COMMON_EXPORT int* GetAsIntegerAddress(vtkInformationKey* key);
+  VTK_COMMON_EXPORT void SetAsDouble(vtkInformationKey* key, double value);
+  VTK_COMMON_EXPORT double* GetAsDoubleAddress(vtkInformationKey* key);
+
   // Internal implementation details.
   vtkInformationInternals* Internal;
 
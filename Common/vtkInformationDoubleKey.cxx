@@ -37,48 +37,23 @@ void vtkInformationDoubleKey::PrintSelf(ostream& os, vtkIndent indent)
 }
 
 //----------------------------------------------------------------------------
-class vtkInformationDoubleValue: public vtkObjectBase
+void vtkInformationDoubleKey::Set(vtkInformation* info, double value)
 {
-public:
-  vtkTypeMacro(vtkInformationDoubleValue, vtkObjectBase);
-  double Value;
-};
+  // The value is stored in the information object itself.
+  this->SetAsDouble(info, value);
+}
 
 //----------------------------------------------------------------------------
-void vtkInformationDoubleKey::Set(vtkInformation* info, double value)
+double vtkInformationDoubleKey::Get(vtkInformation* info)
 {
-  if(vtkInformationDoubleValue* oldv =
-     static_cast<vtkInformationDoubleValue *>(
-       this->GetAsObjectBase(info)))
-    {
-    if (oldv->Value != value)
-      {
-      // Replace the existing value.
-      oldv->Value = value;
-      // Since this sets a value without call SetAsObjectBase(),
-      // the info has to be modified here (instead of 
-      // vtkInformation::SetAsObjectBase()
-      info->Modified(this);
-      }
-    }
-  else
-    {
-    // Allocate a new value.
-    vtkInformationDoubleValue* v = new vtkInformationDoubleValue;
-    this->ConstructClass("vtkInformationDoubleValue");
-    v->Value = value;
-    this->SetAsObjectBase(info, v);
-    v->Delete();
-    }
+  double* v = this->GetAsDoubleAddress(info);
+  return v?*v:0;
 }
 
 //----------------------------------------------------------------------------
-double vtkInformationDoubleKey::Get(vtkInformation* info)
+int vtkInformationDoubleKey::Has(vtkInformation* info)
 {
-  vtkInformationDoubleValue* v =
-    static_cast<vtkInformationDoubleValue *>(
-      this->GetAsObjectBase(info));
-  return v?v->Value:0;
+  return this->GetAsDoubleAddress(info)?1:0;
 }
 
 //----------------------------------------------------------------------------
@@ -107,11 +82,5 @@ void vtkInformationDoubleKey::Print(ostream& os, vtkInformation* info)
 //----------------------------------------------------------------------------
 double* vtkInformationDoubleKey::GetWatchAddress(vtkInformation* info)
 {
-  if(vtkInformationDoubleValue* v =
-     static_cast<vtkInformationDoubleValue *>(
-       this->GetAsObjectBase(info)))
-    {
-    return &v->Value;
-    }
-  return 0;
+  return this->GetAsDoubleAddress(info);
 }
@@ -45,6 +45,10 @@ public:
   // object for this key, the value is removed from the second.
   virtual void ShallowCopy(vtkInformation* from, vtkInformation* to);
 
+  // Description:
+  // Check whether this key appears in the given information object.
+  virtual int Has(vtkInformation* info);
+
   // Description:
   // Print the key's value in an information object to a stream.
   virtual void Print(ostream& os, vtkInformation* info);
@@ -53,7 +57,8 @@ protected:
   // Description:
   // Get the address at which the actual value is stored.  This is
   // meant for use from a debugger to add watches and is therefore not
-  // a public method.
+  // a public method.  The value is stored inline in the information
+  // object, so the address changes when keys are added to it.
   double* GetWatchAddress(vtkInformation* info);
 
 private:
@@ -24,37 +24,206 @@
 #include "vtkInformationKey.h"
 #include "vtkObjectBase.h"
 
-#define VTK_INFORMATION_USE_HASH_MAP
-#ifdef VTK_INFORMATION_USE_HASH_MAP
-# include <vtksys/hash_map.hxx>
-#else
-# include <vtksys/stl/map>
-#endif
-
 //----------------------------------------------------------------------------
+// Open addressing hash table from key pointer to value, probed
+// linearly.  The first few entries are stored in the object itself, so
+// small information objects need no extra allocation.  Integer and
+// double values are stored in the entry itself (with a null value
+// object) rather than in a separately allocated value object.
 class vtkInformationInternals
 {
 public:
   typedef vtkInformationKey* KeyType;
   typedef vtkObjectBase* DataType;
-#ifdef VTK_INFORMATION_USE_HASH_MAP
-  struct HashFun
+
+  struct Entry
+  {
+    KeyType first;
+    DataType second;
+    union
+    {
+      int Integer;
+      double Double;
+    } Scalar;
+  };
+
+  class MapType
   {
-    size_t operator()(KeyType key) const
+  public:
+    class iterator
+    {
+    public:
+      iterator(): Current(0), End(0) {}
+      iterator(Entry* current, Entry* end): Current(current), End(end)
+        {
+        this->Skip();
+        }
+      Entry* operator->() const { return this->Current; }
+      Entry& operator*() const { return *this->Current; }
+      iterator& operator++()
+        {
+        ++this->Current;
+        this->Skip();
+        return *this;
+        }
+      bool operator==(const iterator& i) const
+        { return this->Current == i.Current; }
+      bool operator!=(const iterator& i) const
+        { return this->Current != i.Current; }
+    private:
+      void Skip()
+        {
+        while(this->Current != this->End && !this->Current->first)
+          {
+          ++this->Current;
+          }
+        }
+      Entry* Current;
+      Entry* End;
+    };
+    typedef iterator const_iterator;
+
+    MapType(): Table(this->Small), Capacity(SmallCapacity), Size(0)
+      {
+      this->Clear(this->Small, SmallCapacity);
+      }
+    ~MapType()
+      {
+      if(this->Table != this->Small)
+        {
+        delete [] this->Table;
+        }
+      }
+
+    iterator begin()
+      { return iterator(this->Table, this->Table + this->Capacity); }
+    iterator end()
+      {
+      Entry* end = this->Table + this->Capacity;
+      return iterator(end, end);
+      }
+    size_t size() const { return this->Size; }
+
+    // Return the entry for the key, or end().
+    iterator find(KeyType key)
+      {
+      Entry* e = this->Lookup(key);
+      if(e->first)
+        {
+        return iterator(e, this->Table + this->Capacity);
+        }
+      return this->end();
+      }
+
+    // Return the entry for the key, adding an empty one (null value,
+    // zero scalar) if there is none.  Invalidates iterators and entry
+    // pointers when an entry is added.
+    Entry* insert(KeyType key)
+      {
+      Entry* e = this->Lookup(key);
+      if(!e->first)
+        {
+        if(4*(this->Size + 1) > 3*this->Capacity)
+          {
+          this->Grow();
+          e = this->Lookup(key);
+          }
+        e->first = key;
+        ++this->Size;
+        }
+      return e;
+      }
+
+    // Remove the entry, moving later entries of its probe sequence up so
+    // that lookups never need tombstones.
+    void erase(iterator i)
+      {
+      size_t mask = this->Capacity - 1;
+      size_t hole = static_cast<size_t>(&*i - this->Table);
+      size_t j = hole;
+      for(;;)
+        {
+        j = (j + 1) & mask;
+        Entry& e = this->Table[j];
+        if(!e.first)
+          {
+          break;
+          }
+        // move e into the hole unless its home slot lies cyclically in
+        // (hole, j]
+        size_t home = Hash(e.first) & mask;
+        if(((j - home) & mask) >= ((j - hole) & mask))
+          {
+          this->Table[hole] = e;
+          hole = j;
+          }
+        }
+      this->Table[hole].first = 0;
+      this->Table[hole].second = 0;
+      --this->Size;
+      }
+
+  private:
+    enum { SmallCapacity = 8 };
+
+    static size_t Hash(KeyType key)
+      {
+      // keys are heap allocated, so the low bits carry little entropy
+      size_t h = reinterpret_cast<size_t>(key);
+      return (h >> 4) ^ (h >> 12);
+      }
+
+    static void Clear(Entry* table, size_t capacity)
+      {
+      for(size_t i = 0; i < capacity; ++i)
+        {
+        table[i].first = 0;
+        table[i].second = 0;
+        table[i].Scalar.Double = 0;
+        }
+      }
+
+    Entry* Lookup(KeyType key)
+      {
+      size_t mask = this->Capacity - 1;
+      size_t i = Hash(key) & mask;
+      while(this->Table[i].first && this->Table[i].first != key)
+        {
+        i = (i + 1) & mask;
+        }
+      return this->Table + i;
+      }
+
+    void Grow()
       {
-      return static_cast<size_t>(key - KeyType(0));
+      Entry* oldTable = this->Table;
+      size_t oldCapacity = this->Capacity;
+      this->Capacity = 2*oldCapacity;
+      this->Table = new Entry[this->Capacity];
+      this->Clear(this->Table, this->Capacity);
+      for(size_t i = 0; i < oldCapacity; ++i)
+        {
+        if(oldTable[i].first)
+          {
+          *this->Lookup(oldTable[i].first) = oldTable[i];
+          }
+        }
+      if(oldTable != this->Small)
+        {
+        delete [] oldTable;
+        }
       }
+
+    Entry* Table;
+    size_t Capacity;
+    size_t Size;
+    Entry Small[SmallCapacity];
+
+    MapType(const MapType&);  // Not implemented.
+    void operator=(const MapType&);  // Not implemented.
   };
-  typedef vtksys::hash_map<KeyType, DataType, HashFun> MapType;
-#else
-  typedef vtksys_stl::map<KeyType, DataType> MapType;
-#endif
   MapType Map;
 
-#ifdef VTK_INFORMATION_USE_HASH_MAP
-  vtkInformationInternals(): Map(33) {}
-#endif
-
   ~vtkInformationInternals()
     {
     for(MapType::iterator i = this->Map.begin(); i != this->Map.end(); ++i)
@@ -67,6 +236,4 @@ public:
     }
 };
 
-#undef VTK_INFORMATION_USE_HASH_MAP
-
 #endif
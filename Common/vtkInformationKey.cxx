@@ -32,6 +32,26 @@ public:
     {
     return info->GetAsObjectBase(key);
     }
+  static void SetAsInteger(vtkInformation* info, vtkInformationKey* key,
+                           int value)
+    {
+    info->SetAsInteger(key, value);
+    }
+  static int* GetAsIntegerAddress(vtkInformation* info,
+                                  vtkInformationKey* key)
+    {
+    return info->GetAsIntegerAddress(key);
+    }
+  static void SetAsDouble(vtkInformation* info, vtkInformationKey* key,
+                          double value)
+    {
+    info->SetAsDouble(key, value);
+    }
+  static double* GetAsDoubleAddress(vtkInformation* info,
+                                    vtkInformationKey* key)
+    {
+    return info->GetAsDoubleAddress(key);
+    }
   static void ReportAsObjectBase(vtkInformation* info, vtkInformationKey* key,
                                  vtkGarbageCollector* collector)
     {
@@ -94,6 +114,32 @@ vtkObjectBase* vtkInformationKey::GetAsObjectBase(vtkInformation* info)
   return vtkInformationKeyToInformationFriendship::GetAsObjectBase(info, this);
 }
 
+//----------------------------------------------------------------------------
+void vtkInformationKey::SetAsInteger(vtkInformation* info, int value)
+{
+  vtkInformationKeyToInformationFriendship::SetAsInteger(info, this, value);
+}
+
+//----------------------------------------------------------------------------
+int* vtkInformationKey::GetAsIntegerAddress(vtkInformation* info)
+{
+  return vtkInformationKeyToInformationFriendship::GetAsIntegerAddress(info,
+                                                                       this);
+}
+
+//----------------------------------------------------------------------------
+void vtkInformationKey::SetAsDouble(vtkInformation* info, double value)
+{
+  vtkInformationKeyToInformationFriendship::SetAsDouble(info, this, value);
+}
+
+//----------------------------------------------------------------------------
+double* vtkInformationKey::GetAsDoubleAddress(vtkInformation* info)
+{
+  return vtkInformationKeyToInformationFriendship::GetAsDoubleAddress(info,
+                                                                      this);
+}
+
 //----------------------------------------------------------------------------
 int vtkInformationKey::Has(vtkInformation* info)
 {
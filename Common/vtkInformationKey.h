@@ -104,6 +104,13 @@ protected:
   void SetAsObjectBase(vtkInformation* info, vtkObjectBase* value);
   vtkObjectBase* GetAsObjectBase(vtkInformation* info);
 
+  // Set/Get an integer or double value stored directly in the given
+  // information object.  The Get methods return 0 if there is no entry.
+  void SetAsInteger(vtkInformation* info, int value);
+  int* GetAsIntegerAddress(vtkInformation* info);
+  void SetAsDouble(vtkInformation* info, double value);
+  double* GetAsDoubleAddress(vtkInformation* info);
+
   // Report the object associated with this key instance in the given
   // information object to the collector.
   void ReportAsObjectBase(vtkInformation* info,
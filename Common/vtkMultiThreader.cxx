@@ -14,10 +14,13 @@
 =========================================================================*/
 #include "vtkMultiThreader.h"
 
+#include "vtkConditionVariable.h"
 #include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
 #include "vtkWindows.h"
 
+#include <vtkstd/vector>
+
 vtkCxxRevisionMacro(vtkMultiThreader, "$Revision$");
 vtkStandardNewMacro(vtkMultiThreader);
 
@@ -46,6 +49,58 @@ typedef vtkThreadFunctionType vtkExternCThreadFunctionType;
 #include <sys/sysctl.h>
 #endif
 
+#if defined(VTK_USE_PTHREADS) && defined(__linux__)
+#include <sched.h>
+#endif
+
+//----------------------------------------------------------------------------
+// Bookkeeping for one thread created with SpawnThread.  The entries are
+// allocated individually so that the ThreadInfo handed to a running
+// thread does not move when more threads are spawned.
+class vtkMultiThreaderSpawnedThread
+{
+public:
+  int                          ActiveFlag;
+  vtkMutexLock                 *ActiveFlagLock;
+  vtkThreadProcessIDType       ProcessID;
+  vtkMultiThreader::ThreadInfo Info;
+};
+
+class vtkMultiThreaderSpawnedThreads
+{
+public:
+  vtkMultiThreaderSpawnedThreads() {}
+  ~vtkMultiThreaderSpawnedThreads()
+    {
+    vtkstd::vector<vtkMultiThreaderSpawnedThread *>::iterator it;
+    for (it = this->Threads.begin(); it != this->Threads.end(); ++it)
+      {
+      if ((*it)->ActiveFlagLock)
+        {
+        (*it)->ActiveFlagLock->Delete();
+        }
+      delete *it;
+      }
+    }
+
+  // Return the entry for the given id, or NULL if the id is out of range.
+  vtkMultiThreaderSpawnedThread *Get(int id)
+    {
+    vtkMultiThreaderSpawnedThread *entry = 0;
+    this->Lock.Lock();
+    if (id >= 0 && id < static_cast<int>(this->Threads.size()))
+      {
+      entry = this->Threads[id];
+      }
+    this->Lock.Unlock();
+    return entry;
+    }
+
+  // Guards the growth of Threads.
+  vtkSimpleMutexLock Lock;
+  vtkstd::vector<vtkMultiThreaderSpawnedThread *> Threads;
+};
+
 // Initialize static member that controls global maximum number of threads
 static int vtkMultiThreaderGlobalMaximumNumberOfThreads = 0;
 
@@ -94,6 +149,16 @@ int vtkMultiThreader::GetGlobalDefaultNumberOfThreads()
 #elif defined(_SC_NPROC_ONLN)
     num = sysconf( _SC_NPROC_ONLN );
 #endif
+#if defined(__linux__) && defined(CPU_COUNT)
+    // Only count the processors this process is allowed to run on.
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    if (sched_getaffinity(0, sizeof(cpus), &cpus) == 0 &&
+        CPU_COUNT(&cpus) > 0)
+      {
+      num = CPU_COUNT(&cpus);
+      }
+#endif
 #if defined(__SVR4) && defined(sun) && defined(PTHREAD_MUTEX_NORMAL)
     pthread_setconcurrency(num);
 #endif
@@ -144,47 +209,320 @@ int vtkMultiThreader::GetGlobalDefaultNumberOfThreads()
   return vtkMultiThreaderGlobalDefaultNumberOfThreads;
 }
 
-// Constructor. Default all the methods to NULL. Since the
-// ThreadInfoArray is static, the ThreadIDs can be initialized here
-// and will not change.
-vtkMultiThreader::vtkMultiThreader()
+// The thread pool is only available where we know how to create
+// threads that outlive a single execute call.
+#if (defined(VTK_USE_PTHREADS) && !defined(VTK_HP_PTHREADS)) || \
+  defined(VTK_USE_WIN32_THREADS)
+# define VTK_MULTITHREADER_USE_POOL
+#endif
+
+#ifdef VTK_MULTITHREADER_USE_POOL
+//----------------------------------------------------------------------------
+// A set of worker threads that are parked on a condition variable
+// between execute calls.  Only one execute call can use the pool at a
+// time; the pool refuses other calls so that the caller can fall back
+// to creating its own threads.
+class vtkMultiThreaderThreadPool
 {
-  int i;
+public:
+  vtkMultiThreaderThreadPool();
+  ~vtkMultiThreaderThreadPool();
+
+  // Run the job on numberOfThreads threads, the calling thread being
+  // thread 0.  Either single is set, or multiple holds one method per
+  // thread.  Returns 0 without doing anything if the pool is busy.
+  int Execute(int numberOfThreads, vtkThreadFunctionType single,
+              vtkThreadFunctionType *multiple,
+              vtkMultiThreader::ThreadInfo *info);
+
+  static VTK_THREAD_RETURN_TYPE WorkerMain(void *arg);
+
+protected:
+  struct Worker
+  {
+    vtkMultiThreaderThreadPool *Pool;
+    int Index;
+    unsigned long Generation;
+    vtkThreadProcessIDType ProcessID;
+  };
+
+  // Make sure workers 1 .. numberOfThreads-1 exist.  Called with the
+  // lock held.
+  int Grow(int numberOfThreads);
+
+  vtkSimpleMutexLock Lock;
+  vtkSimpleConditionVariable WorkReady;
+  vtkSimpleConditionVariable WorkDone;
+  vtkstd::vector<Worker *> Workers;
+
+  unsigned long Generation;
+  int Pending;
+  int Busy;
+  int Shutdown;
+
+  // The job currently being executed.
+  int NumberOfThreads;
+  vtkThreadFunctionType SingleMethod;
+  vtkThreadFunctionType *MultipleMethod;
+  vtkMultiThreader::ThreadInfo *ThreadInfoArray;
+};
+
+//----------------------------------------------------------------------------
+vtkMultiThreaderThreadPool::vtkMultiThreaderThreadPool()
+{
+  this->Generation = 0;
+  this->Pending = 0;
+  this->Busy = 0;
+  this->Shutdown = 0;
+  this->NumberOfThreads = 0;
+  this->SingleMethod = 0;
+  this->MultipleMethod = 0;
+  this->ThreadInfoArray = 0;
+}
 
-  for ( i = 0; i < VTK_MAX_THREADS; i++ )
+//----------------------------------------------------------------------------
+vtkMultiThreaderThreadPool::~vtkMultiThreaderThreadPool()
+{
+  this->Lock.Lock();
+  while (this->Busy)
     {
-    this->ThreadInfoArray[i].ThreadID           = i;
-    this->ThreadInfoArray[i].ActiveFlag         = NULL;
-    this->ThreadInfoArray[i].ActiveFlagLock     = NULL;
-    this->MultipleMethod[i]                     = NULL;
-    this->SpawnedThreadActiveFlag[i]            = 0;
-    this->SpawnedThreadActiveFlagLock[i]        = NULL;
-    this->SpawnedThreadInfoArray[i].ThreadID    = i;
+    this->WorkDone.Wait(this->Lock);
     }
+  this->Shutdown = 1;
+  this->WorkReady.Broadcast();
+  this->Lock.Unlock();
+
+  vtkstd::vector<Worker *>::iterator it;
+  for (it = this->Workers.begin(); it != this->Workers.end(); ++it)
+    {
+#ifdef VTK_USE_WIN32_THREADS
+    WaitForSingleObject((*it)->ProcessID, INFINITE);
+    CloseHandle((*it)->ProcessID);
+#else
+    pthread_join((*it)->ProcessID, NULL);
+#endif
+    delete *it;
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiThreaderThreadPool::Grow(int numberOfThreads)
+{
+  while (static_cast<int>(this->Workers.size()) + 1 < numberOfThreads)
+    {
+    Worker *w = new Worker;
+    w->Pool = this;
+    w->Index = static_cast<int>(this->Workers.size()) + 1;
+    // The new worker has not seen the job about to be posted.
+    w->Generation = this->Generation;
+
+#ifdef VTK_USE_WIN32_THREADS
+    DWORD threadId;
+    w->ProcessID = CreateThread(NULL, 0,
+                                vtkMultiThreaderThreadPool::WorkerMain,
+                                static_cast<void *>(w), 0, &threadId);
+    int failed = (w->ProcessID == NULL);
+#else
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+#if !defined(__CYGWIN__)
+    pthread_attr_setscope(&attr, PTHREAD_SCOPE_PROCESS);
+#endif
+    int failed = pthread_create(
+      &w->ProcessID, &attr,
+      reinterpret_cast<vtkExternCThreadFunctionType>(
+        vtkMultiThreaderThreadPool::WorkerMain),
+      static_cast<void *>(w));
+    pthread_attr_destroy(&attr);
+#endif
+    if (failed)
+      {
+      delete w;
+      return 0;
+      }
+    this->Workers.push_back(w);
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiThreaderThreadPool::Execute(int numberOfThreads,
+                                        vtkThreadFunctionType single,
+                                        vtkThreadFunctionType *multiple,
+                                        vtkMultiThreader::ThreadInfo *info)
+{
+  this->Lock.Lock();
+  if (this->Busy || this->Shutdown || !this->Grow(numberOfThreads))
+    {
+    this->Lock.Unlock();
+    return 0;
+    }
+  this->Busy = 1;
+  this->NumberOfThreads = numberOfThreads;
+  this->SingleMethod = single;
+  this->MultipleMethod = multiple;
+  this->ThreadInfoArray = info;
+  this->Pending = numberOfThreads - 1;
+  ++this->Generation;
+  this->WorkReady.Broadcast();
+  this->Lock.Unlock();
+
+  // The calling thread does the work of thread 0.
+  if (single)
+    {
+    single(static_cast<void *>(&info[0]));
+    }
+  else
+    {
+    multiple[0](static_cast<void *>(&info[0]));
+    }
+
+  this->Lock.Lock();
+  while (this->Pending > 0)
+    {
+    this->WorkDone.Wait(this->Lock);
+    }
+  this->Busy = 0;
+  this->SingleMethod = 0;
+  this->MultipleMethod = 0;
+  this->ThreadInfoArray = 0;
+  // Wake anybody else waiting for the pool to go idle.
+  this->WorkDone.Broadcast();
+  this->Lock.Unlock();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkMultiThreaderThreadPool::WorkerMain(void *arg)
+{
+  Worker *w = static_cast<Worker *>(arg);
+  vtkMultiThreaderThreadPool *self = w->Pool;
+
+  self->Lock.Lock();
+  for (;;)
+    {
+    while (!self->Shutdown && w->Generation == self->Generation)
+      {
+      self->WorkReady.Wait(self->Lock);
+      }
+    if (self->Shutdown)
+      {
+      break;
+      }
+    w->Generation = self->Generation;
+    if (w->Index < self->NumberOfThreads)
+      {
+      vtkThreadFunctionType method = self->SingleMethod ?
+        self->SingleMethod : self->MultipleMethod[w->Index];
+      void *data = static_cast<void *>(&self->ThreadInfoArray[w->Index]);
+      self->Lock.Unlock();
+      method(data);
+      self->Lock.Lock();
+      if (--self->Pending == 0)
+        {
+        self->WorkDone.Broadcast();
+        }
+      }
+    }
+  self->Lock.Unlock();
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+// The pool, or NULL when the pool is not in use.
+static vtkMultiThreaderThreadPool *vtkMultiThreaderGlobalThreadPool = 0;
+#endif
+
+static int vtkMultiThreaderGlobalUseThreadPool = 0;
+
+void vtkMultiThreader::SetGlobalUseThreadPool(int val)
+{
+  val = (val != 0);
+  if (val == vtkMultiThreaderGlobalUseThreadPool)
+    {
+    return;
+    }
+  vtkMultiThreaderGlobalUseThreadPool = val;
+
+#ifdef VTK_MULTITHREADER_USE_POOL
+  if (val)
+    {
+    vtkMultiThreaderGlobalThreadPool = new vtkMultiThreaderThreadPool;
+    }
+  else
+    {
+    delete vtkMultiThreaderGlobalThreadPool;
+    vtkMultiThreaderGlobalThreadPool = 0;
+    }
+#endif
+}
+
+int vtkMultiThreader::GetGlobalUseThreadPool()
+{
+  return vtkMultiThreaderGlobalUseThreadPool;
+}
+
+// Constructor. Default all the methods to NULL. The per-thread arrays
+// are allocated when the number of threads is known.
+vtkMultiThreader::vtkMultiThreader()
+{
+  this->ThreadArraySize = 0;
+  this->ThreadInfoArray = NULL;
+  this->MultipleMethod = NULL;
+  this->MultipleData = NULL;
+  this->SpawnedThreads = new vtkMultiThreaderSpawnedThreads;
 
   this->SingleMethod = NULL;
+  this->SingleData = NULL;
   this->NumberOfThreads = 
     vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
 
 }
 
-// Destructor. Nothing allocated so nothing needs to be done here.
 vtkMultiThreader::~vtkMultiThreader()
 {
+  delete [] this->ThreadInfoArray;
+  delete [] this->MultipleMethod;
+  delete [] this->MultipleData;
+  delete this->SpawnedThreads;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiThreader::AllocateThreadArrays(int num)
+{
+  if (num <= this->ThreadArraySize)
+    {
+    return;
+    }
+
+  ThreadInfo *info = new ThreadInfo[num];
+  vtkThreadFunctionType *methods = new vtkThreadFunctionType[num];
+  void **data = new void *[num];
+
   int i;
-  
-  for ( i = 0; i < VTK_MAX_THREADS; i++ )
+  for (i = 0; i < num; i++)
     {
-    if ( this->ThreadInfoArray[i].ActiveFlagLock )
-      {
-      this->ThreadInfoArray[i].ActiveFlagLock->Delete();
-      }
-    
-    if ( this->SpawnedThreadActiveFlagLock[i] )
-      {
-      this->SpawnedThreadActiveFlagLock[i]->Delete();
-      }
+    info[i].ThreadID       = i;
+    info[i].ActiveFlag     = NULL;
+    info[i].ActiveFlagLock = NULL;
+    info[i].UserData       = NULL;
+    info[i].NumberOfThreads = 0;
+    methods[i] = NULL;
+    data[i] = NULL;
     }
+  for (i = 0; i < this->ThreadArraySize; i++)
+    {
+    methods[i] = this->MultipleMethod[i];
+    data[i] = this->MultipleData[i];
+    }
+
+  delete [] this->ThreadInfoArray;
+  delete [] this->MultipleMethod;
+  delete [] this->MultipleData;
+  this->ThreadInfoArray = info;
+  this->MultipleMethod = methods;
+  this->MultipleData = data;
+  this->ThreadArraySize = num;
 }
 
 //----------------------------------------------------------------------------
@@ -223,6 +561,7 @@ void vtkMultiThreader::SetMultipleMethod( int index,
     }
   else
     {
+    this->AllocateThreadArrays(this->NumberOfThreads);
     this->MultipleMethod[index] = f;
     this->MultipleData[index]   = data;
     }
@@ -235,16 +574,16 @@ void vtkMultiThreader::SingleMethodExecute()
 
 #ifdef VTK_USE_WIN32_THREADS
   DWORD              threadId;
-  HANDLE             process_id[VTK_MAX_THREADS];
+  vtkstd::vector<HANDLE> process_id;
 #endif
 
 #ifdef VTK_USE_SPROC
   siginfo_t          info_ptr;
-  int                process_id[VTK_MAX_THREADS];
+  vtkstd::vector<int> process_id;
 #endif
 
 #ifdef VTK_USE_PTHREADS
-  pthread_t          process_id[VTK_MAX_THREADS];
+  vtkstd::vector<pthread_t> process_id;
 #endif
 
   if ( !this->SingleMethod )
@@ -259,7 +598,31 @@ void vtkMultiThreader::SingleMethodExecute()
     {
     this->NumberOfThreads = vtkMultiThreaderGlobalMaximumNumberOfThreads;
     }
-  
+
+  this->AllocateThreadArrays(this->NumberOfThreads);
+#if defined(VTK_USE_WIN32_THREADS) || defined(VTK_USE_SPROC) || \
+  defined(VTK_USE_PTHREADS)
+  process_id.resize(this->NumberOfThreads);
+#endif
+
+#ifdef VTK_MULTITHREADER_USE_POOL
+  // Hand the work to the parked worker threads if the pool is enabled
+  // and not already in use.
+  if (vtkMultiThreaderGlobalThreadPool && this->NumberOfThreads > 1)
+    {
+    for ( thread_loop = 0; thread_loop < this->NumberOfThreads; thread_loop++ )
+      {
+      this->ThreadInfoArray[thread_loop].UserData        = this->SingleData;
+      this->ThreadInfoArray[thread_loop].NumberOfThreads = this->NumberOfThreads;
+      }
+    if (vtkMultiThreaderGlobalThreadPool->Execute(
+          this->NumberOfThreads, this->SingleMethod, NULL,
+          this->ThreadInfoArray))
+      {
+      return;
+      }
+    }
+#endif
     
   // We are using sproc (on SGIs), pthreads(on Suns), or a single thread
   // (the default)  
@@ -420,16 +783,16 @@ void vtkMultiThreader::MultipleMethodExecute()
 
 #ifdef VTK_USE_WIN32_THREADS
   DWORD              threadId;
-  HANDLE             process_id[VTK_MAX_THREADS];
+  vtkstd::vector<HANDLE> process_id;
 #endif
 
 #ifdef VTK_USE_SPROC
   siginfo_t          info_ptr;
-  int                process_id[VTK_MAX_THREADS];
+  vtkstd::vector<int> process_id;
 #endif
 
 #ifdef VTK_USE_PTHREADS
-  pthread_t          process_id[VTK_MAX_THREADS];
+  vtkstd::vector<pthread_t> process_id;
 #endif
 
 
@@ -440,6 +803,12 @@ void vtkMultiThreader::MultipleMethodExecute()
     this->NumberOfThreads = vtkMultiThreaderGlobalMaximumNumberOfThreads;
     }
 
+  this->AllocateThreadArrays(this->NumberOfThreads);
+#if defined(VTK_USE_WIN32_THREADS) || defined(VTK_USE_SPROC) || \
+  defined(VTK_USE_PTHREADS)
+  process_id.resize(this->NumberOfThreads);
+#endif
+
   for ( thread_loop = 0; thread_loop < this->NumberOfThreads; thread_loop++ )
     {
     if ( this->MultipleMethod[thread_loop] == (vtkThreadFunctionType)NULL)
@@ -449,6 +818,26 @@ void vtkMultiThreader::MultipleMethodExecute()
       }
     }
 
+#ifdef VTK_MULTITHREADER_USE_POOL
+  // Hand the work to the parked worker threads if the pool is enabled
+  // and not already in use.
+  if (vtkMultiThreaderGlobalThreadPool && this->NumberOfThreads > 1)
+    {
+    for ( thread_loop = 0; thread_loop < this->NumberOfThreads; thread_loop++ )
+      {
+      this->ThreadInfoArray[thread_loop].UserData = 
+        this->MultipleData[thread_loop];
+      this->ThreadInfoArray[thread_loop].NumberOfThreads = this->NumberOfThreads;
+      }
+    if (vtkMultiThreaderGlobalThreadPool->Execute(
+          this->NumberOfThreads, NULL, this->MultipleMethod,
+          this->ThreadInfoArray))
+      {
+      return;
+      }
+    }
+#endif
+
   // We are using sproc (on SGIs), pthreads(on Suns), CreateThread
   // on a PC or a single thread (the default)  
 
@@ -602,40 +991,52 @@ void vtkMultiThreader::MultipleMethodExecute()
 int vtkMultiThreader::SpawnThread( vtkThreadFunctionType f, void *userdata )
 {
   int id;
+  vtkMultiThreaderSpawnedThread *entry = NULL;
 
 #ifdef VTK_USE_WIN32_THREADS
   DWORD              threadId;
 #endif
 
-  for ( id = 0; id < VTK_MAX_THREADS; id++ )
+  this->SpawnedThreads->Lock.Lock();
+  int numberOfEntries = static_cast<int>(this->SpawnedThreads->Threads.size());
+  for ( id = 0; id < numberOfEntries; id++ )
     {
-    if ( this->SpawnedThreadActiveFlagLock[id] == NULL )
+    entry = this->SpawnedThreads->Threads[id];
+    if ( entry->ActiveFlagLock == NULL )
       {
-      this->SpawnedThreadActiveFlagLock[id] = vtkMutexLock::New();
+      entry->ActiveFlagLock = vtkMutexLock::New();
       }
-    this->SpawnedThreadActiveFlagLock[id]->Lock();
-    if (this->SpawnedThreadActiveFlag[id] == 0)
+    entry->ActiveFlagLock->Lock();
+    if (entry->ActiveFlag == 0)
       {
       // We've got a useable thread id, so grab it
-      this->SpawnedThreadActiveFlag[id] = 1;
-      this->SpawnedThreadActiveFlagLock[id]->Unlock();
+      entry->ActiveFlag = 1;
+      entry->ActiveFlagLock->Unlock();
       break;
       }
-    this->SpawnedThreadActiveFlagLock[id]->Unlock();
+    entry->ActiveFlagLock->Unlock();
     }
 
-  if ( id >= VTK_MAX_THREADS )
+  if ( id >= numberOfEntries )
     {
-    vtkErrorMacro( << "You have too many active threads!" );
-    return -1;
+    if ( id >= VTK_MAX_THREADS )
+      {
+      this->SpawnedThreads->Lock.Unlock();
+      vtkErrorMacro( << "You have too many active threads!" );
+      return -1;
+      }
+    entry = new vtkMultiThreaderSpawnedThread;
+    entry->ActiveFlag = 1;
+    entry->ActiveFlagLock = vtkMutexLock::New();
+    entry->Info.ThreadID = id;
+    this->SpawnedThreads->Threads.push_back(entry);
     }
+  this->SpawnedThreads->Lock.Unlock();
 
-  this->SpawnedThreadInfoArray[id].UserData        = userdata;
-  this->SpawnedThreadInfoArray[id].NumberOfThreads = 1;
-  this->SpawnedThreadInfoArray[id].ActiveFlag = 
-    &this->SpawnedThreadActiveFlag[id];
-  this->SpawnedThreadInfoArray[id].ActiveFlagLock = 
-    this->SpawnedThreadActiveFlagLock[id];
+  entry->Info.UserData        = userdata;
+  entry->Info.NumberOfThreads = 1;
+  entry->Info.ActiveFlag      = &entry->ActiveFlag;
+  entry->Info.ActiveFlagLock  = entry->ActiveFlagLock;
 
   // We are using sproc (on SGIs), pthreads(on Suns or HPs), 
   // CreateThread (on win32), or generating an error  
@@ -643,10 +1044,10 @@ int vtkMultiThreader::SpawnThread( vtkThreadFunctionType f, void *userdata )
 #ifdef VTK_USE_WIN32_THREADS
   // Using CreateThread on a PC
   //
-  this->SpawnedThreadProcessID[id] = 
+  entry->ProcessID = 
       CreateThread(NULL, 0, f, 
-             ((void *)(&this->SpawnedThreadInfoArray[id])), 0, &threadId);
-  if (this->SpawnedThreadProcessID[id] == NULL)
+             ((void *)(&entry->Info)), 0, &threadId);
+  if (entry->ProcessID == NULL)
     {
     vtkErrorMacro("Error in thread creation !!!");
     } 
@@ -655,8 +1056,8 @@ int vtkMultiThreader::SpawnThread( vtkThreadFunctionType f, void *userdata )
 #ifdef VTK_USE_SPROC
   // Using sproc() on an SGI
   //
-  this->SpawnedThreadProcessID[id] = 
-    sproc( f, PR_SADDR, ( (void *)(&this->SpawnedThreadInfoArray[id]) ) );
+  entry->ProcessID = 
+    sproc( f, PR_SADDR, ( (void *)(&entry->Info) ) );
 
 #endif
 
@@ -675,14 +1076,14 @@ int vtkMultiThreader::SpawnThread( vtkThreadFunctionType f, void *userdata )
 #endif
   
 #ifdef VTK_HP_PTHREADS
-  pthread_create( &(this->SpawnedThreadProcessID[id]),
+  pthread_create( &(entry->ProcessID),
                   attr, f,  
-                  ( (void *)(&this->SpawnedThreadInfoArray[id]) ) );
+                  ( (void *)(&entry->Info) ) );
 #else
-  pthread_create( &(this->SpawnedThreadProcessID[id]),
+  pthread_create( &(entry->ProcessID),
                   &attr,
                   reinterpret_cast<vtkExternCThreadFunctionType>(f),  
-                  ( (void *)(&this->SpawnedThreadInfoArray[id]) ) );
+                  ( (void *)(&entry->Info) ) );
 #endif
 
 #endif
@@ -693,7 +1094,9 @@ int vtkMultiThreader::SpawnThread( vtkThreadFunctionType f, void *userdata )
   // There is no multi threading, so there is only one thread.
   // This won't work - so give an error message.
   vtkErrorMacro( << "Cannot spawn thread in a single threaded environment!" );
-  this->SpawnedThreadActiveFlagLock[id]->Delete();
+  entry->ActiveFlagLock->Delete();
+  entry->ActiveFlagLock = NULL;
+  entry->ActiveFlag = 0;
   id = -1;
 #endif
 #endif
@@ -705,22 +1108,23 @@ int vtkMultiThreader::SpawnThread( vtkThreadFunctionType f, void *userdata )
 void vtkMultiThreader::TerminateThread( int threadID )
 {
   // check if the threadID argument is in range
-  if ( threadID >= VTK_MAX_THREADS )
+  vtkMultiThreaderSpawnedThread *entry = this->SpawnedThreads->Get(threadID);
+  if ( !entry )
     {
-    vtkErrorMacro("ThreadID is out of range. Must be less that " << VTK_MAX_THREADS );
+    vtkErrorMacro("ThreadID " << threadID << " is out of range.");
     return;
     }
   
   // If we don't have a lock, then this thread is definitely not active
-  if ( !this->SpawnedThreadActiveFlag[threadID] )
+  if ( !entry->ActiveFlagLock )
     {
     return;
     }
   
   // If we do have a lock, use it and find out the status of the active flag
-  this->SpawnedThreadActiveFlagLock[threadID]->Lock();
-  int val = this->SpawnedThreadActiveFlag[threadID];
-  this->SpawnedThreadActiveFlagLock[threadID]->Unlock();
+  entry->ActiveFlagLock->Lock();
+  int val = entry->ActiveFlag;
+  entry->ActiveFlagLock->Unlock();
   
   // If the active flag is 0, return since this thread is not active
   if ( val == 0 )
@@ -730,24 +1134,24 @@ void vtkMultiThreader::TerminateThread( int threadID )
   
   // OK - now we know we have an active thread - set the active flag to 0
   // to indicate to the thread that it should terminate itself
-  this->SpawnedThreadActiveFlagLock[threadID]->Lock();
-  this->SpawnedThreadActiveFlag[threadID] = 0;
-  this->SpawnedThreadActiveFlagLock[threadID]->Unlock();
+  entry->ActiveFlagLock->Lock();
+  entry->ActiveFlag = 0;
+  entry->ActiveFlagLock->Unlock();
 
 #ifdef VTK_USE_WIN32_THREADS
-  WaitForSingleObject(this->SpawnedThreadProcessID[threadID], INFINITE);
-  CloseHandle(this->SpawnedThreadProcessID[threadID]);
+  WaitForSingleObject(entry->ProcessID, INFINITE);
+  CloseHandle(entry->ProcessID);
 #endif
 
 #ifdef VTK_USE_SPROC
   siginfo_t info_ptr;
 
-  waitid( P_PID, (id_t) this->SpawnedThreadProcessID[threadID], 
+  waitid( P_PID, (id_t) entry->ProcessID, 
           &info_ptr, WEXITED );
 #endif
 
 #ifdef VTK_USE_PTHREADS
-  pthread_join( this->SpawnedThreadProcessID[threadID], NULL );
+  pthread_join( entry->ProcessID, NULL );
 #endif
 
 #ifndef VTK_USE_WIN32_THREADS
@@ -760,8 +1164,8 @@ void vtkMultiThreader::TerminateThread( int threadID )
 #endif
 #endif
 
-  this->SpawnedThreadActiveFlagLock[threadID]->Delete();
-  this->SpawnedThreadActiveFlagLock[threadID] = NULL;
+  entry->ActiveFlagLock->Delete();
+  entry->ActiveFlagLock = NULL;
 
 }
 
@@ -784,22 +1188,23 @@ vtkMultiThreaderIDType vtkMultiThreader::GetCurrentThreadID()
 int vtkMultiThreader::IsThreadActive( int threadID )
 {
   // check if the threadID argument is in range
-  if ( threadID >= VTK_MAX_THREADS )
+  vtkMultiThreaderSpawnedThread *entry = this->SpawnedThreads->Get(threadID);
+  if ( !entry )
     {
-    vtkErrorMacro("ThreadID is out of range. Must be less that " << VTK_MAX_THREADS );
+    vtkErrorMacro("ThreadID " << threadID << " is out of range.");
     return 0;
     }
   
   // If we don't have a lock, then this thread is not active
-  if ( this->SpawnedThreadActiveFlagLock[threadID] == NULL )
+  if ( entry->ActiveFlagLock == NULL )
     {
     return 0;
     }
   
   // We have a lock - use it to get the active flag value
-  this->SpawnedThreadActiveFlagLock[threadID]->Lock();
-  int val = this->SpawnedThreadActiveFlag[threadID];
-  this->SpawnedThreadActiveFlagLock[threadID]->Unlock();
+  entry->ActiveFlagLock->Lock();
+  int val = entry->ActiveFlag;
+  entry->ActiveFlagLock->Unlock();
   
   // now return that value
   return val;
@@ -830,6 +1235,8 @@ void vtkMultiThreader::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Thread Count: " << this->NumberOfThreads << "\n";
   os << indent << "Global Maximum Number Of Threads: " << 
     vtkMultiThreaderGlobalMaximumNumberOfThreads << endl;
+  os << indent << "Global Use Thread Pool: " << 
+    vtkMultiThreaderGlobalUseThreadPool << endl;
   os << "Thread system used: " <<
 #ifdef VTK_USE_PTHREADS  
    "PTHREADS"
@@ -83,6 +83,9 @@ typedef int vtkMultiThreaderIDType;
 //ETX
 
 class vtkMutexLock;
+//BTX
+class vtkMultiThreaderSpawnedThreads;
+//ETX
 
 class VTK_COMMON_EXPORT vtkMultiThreader : public vtkObject 
 {
@@ -120,7 +123,8 @@ public:
   // Description:
   // Get/Set the number of threads to create. It will be clamped to the range
   // 1 - VTK_MAX_THREADS, so the caller of this method should check that the
-  // requested number of threads was accepted.
+  // requested number of threads was accepted.  The per-thread bookkeeping
+  // is sized to the number of threads actually used.
   vtkSetClampMacro( NumberOfThreads, int, 1, VTK_MAX_THREADS );
   virtual int GetNumberOfThreads();
 
@@ -134,10 +138,26 @@ public:
   // Description:
   // Set/Get the value which is used to initialize the NumberOfThreads
   // in the constructor.  Initially this default is set to the number of 
-  // processors or VTK_MAX_THREADS (which ever is less).
+  // processors or VTK_MAX_THREADS (which ever is less).  On Linux the
+  // processors are those in the affinity mask of the process, so that
+  // jobs restricted to a subset of the machine (taskset, cpusets,
+  // containers) do not oversubscribe it.
   static void SetGlobalDefaultNumberOfThreads(int val);
   static int  GetGlobalDefaultNumberOfThreads();
 
+  // Description:
+  // Set/Get whether SingleMethodExecute and MultipleMethodExecute
+  // dispatch to a persistent, process-wide pool of parked worker threads
+  // instead of creating and joining new threads on every call.  The
+  // methods receive the same ThreadInfo structure either way.  If the pool
+  // is already busy (for example when called from within a pool thread)
+  // the execute methods fall back to creating threads.  Turning the pool
+  // off joins its worker threads.  This should be set from the main
+  // thread while no execute call is in progress.  Off by default; only
+  // supported with pthreads and win32 threads.
+  static void SetGlobalUseThreadPool(int val);
+  static int  GetGlobalUseThreadPool();
+
   // These methods are excluded from Tcl wrapping 1) because the
   // wrapper gives up on them and 2) because they really shouldn't be
   // called from a script anyway.
@@ -169,8 +189,8 @@ public:
 
   // Description:
   // Create a new thread for the given function. Return a thread id
-  // which is a number between 0 and VTK_MAX_THREADS - 1. This id should
-  // be used to kill the thread at a later time.
+  // which is a number between 0 and VTK_MAX_THREADS - 1, or -1 on error.
+  // This id should be used to kill the thread at a later time.
   int SpawnThread( vtkThreadFunctionType, void *data );
 
   // Description:
@@ -194,30 +214,35 @@ protected:
   vtkMultiThreader();
   ~vtkMultiThreader();
 
+  // Description:
+  // Make sure the per-thread arrays (ThreadInfoArray, MultipleMethod and
+  // MultipleData) can hold at least num entries.
+  void AllocateThreadArrays(int num);
+
   // The number of threads to use
   int                        NumberOfThreads;
 
+  // The number of entries allocated in the per-thread arrays
+  int                        ThreadArraySize;
+
   // An array of thread info containing a thread id
-  // (0, 1, 2, .. VTK_MAX_THREADS-1), the thread count, and a pointer
+  // (0, 1, 2, .. NumberOfThreads-1), the thread count, and a pointer
   // to void so that user data can be passed to each thread
-  ThreadInfo                 ThreadInfoArray[VTK_MAX_THREADS];
+  ThreadInfo                 *ThreadInfoArray;
 
   // The methods
   vtkThreadFunctionType      SingleMethod;
-  vtkThreadFunctionType      MultipleMethod[VTK_MAX_THREADS];
+  vtkThreadFunctionType      *MultipleMethod;
 
-  // Storage of MutexFunctions and ints used to control spawned 
-  // threads and the spawned thread ids
-  int                        SpawnedThreadActiveFlag[VTK_MAX_THREADS];
-  vtkMutexLock               *SpawnedThreadActiveFlagLock[VTK_MAX_THREADS];
-  vtkThreadProcessIDType     SpawnedThreadProcessID[VTK_MAX_THREADS];
-  ThreadInfo                 SpawnedThreadInfoArray[VTK_MAX_THREADS];
+  // Storage of the active flags, the mutexes used to control spawned
+  // threads and the spawned thread ids.  Grows as threads are spawned.
+  vtkMultiThreaderSpawnedThreads *SpawnedThreads;
 
 //ETX
 
   // Internal storage of the data
   void                       *SingleData;
-  void                       *MultipleData[VTK_MAX_THREADS];
+  void                       **MultipleData;
 
 private:
   vtkMultiThreader(const vtkMultiThreader&);  // Not implemented.
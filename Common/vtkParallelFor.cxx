@@ -0,0 +1,145 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkParallelFor.h"
+
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+
+vtkCxxRevisionMacro(vtkParallelFor, "$Revision$");
+vtkStandardNewMacro(vtkParallelFor);
+
+//----------------------------------------------------------------------------
+// The state shared by the threads: the next index to hand out.
+struct vtkParallelForRange
+{
+  vtkParallelForFunctor *Functor;
+  vtkSimpleMutexLock Lock;
+  vtkIdType Next;
+  vtkIdType End;
+  vtkIdType Grain;
+};
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkParallelForThreadedExecute(void *arg)
+{
+  int threadId = static_cast<vtkMultiThreader::ThreadInfo *>(arg)->ThreadID;
+  vtkParallelForRange *range = static_cast<vtkParallelForRange *>(
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg)->UserData);
+
+  for (;;)
+    {
+    range->Lock.Lock();
+    vtkIdType begin = range->Next;
+    vtkIdType end = begin;
+    if (begin < range->End)
+      {
+      end = (range->End - begin > range->Grain ?
+             begin + range->Grain : range->End);
+      range->Next = end;
+      }
+    range->Lock.Unlock();
+
+    if (begin >= end)
+      {
+      break;
+      }
+    range->Functor->Execute(begin, end, threadId);
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+vtkParallelFor::vtkParallelFor()
+{
+  this->Threader = vtkMultiThreader::New();
+  this->NumberOfThreads = this->Threader->GetNumberOfThreads();
+  this->GrainSize = 0;
+  this->MinimumGrainSize = 1024;
+}
+
+//----------------------------------------------------------------------------
+vtkParallelFor::~vtkParallelFor()
+{
+  this->Threader->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkParallelFor::Execute(vtkIdType begin, vtkIdType end,
+                             vtkParallelForFunctor *functor)
+{
+  if (!functor)
+    {
+    vtkErrorMacro("No functor to execute.");
+    return;
+    }
+
+  vtkIdType length = (end > begin ? end - begin : 0);
+
+  this->Threader->SetNumberOfThreads(this->NumberOfThreads);
+  int numberOfThreads = this->Threader->GetNumberOfThreads();
+
+  vtkIdType grain = this->GrainSize;
+  if (grain <= 0)
+    {
+    // a few chunks per thread to even out the load
+    grain = length / (8 * numberOfThreads);
+    if (grain < this->MinimumGrainSize)
+      {
+      grain = this->MinimumGrainSize;
+      }
+    }
+
+  // don't start threads that would have nothing to do
+  vtkIdType numberOfChunks = (length + grain - 1) / grain;
+  if (numberOfChunks < numberOfThreads)
+    {
+    numberOfThreads = (numberOfChunks > 1 ?
+                       static_cast<int>(numberOfChunks) : 1);
+    }
+
+  functor->Initialize(numberOfThreads);
+  if (numberOfThreads == 1)
+    {
+    if (length > 0)
+      {
+      functor->Execute(begin, end, 0);
+      }
+    }
+  else
+    {
+    vtkParallelForRange range;
+    range.Functor = functor;
+    range.Next = begin;
+    range.End = end;
+    range.Grain = grain;
+
+    this->Threader->SetNumberOfThreads(numberOfThreads);
+    this->Threader->SetSingleMethod(vtkParallelForThreadedExecute, &range);
+    this->Threader->SingleMethodExecute();
+    }
+  functor->Reduce();
+}
+
+//----------------------------------------------------------------------------
+void vtkParallelFor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "GrainSize: " << this->GrainSize << "\n";
+  os << indent << "MinimumGrainSize: " << this->MinimumGrainSize << "\n";
+}
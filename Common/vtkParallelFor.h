@@ -0,0 +1,114 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkParallelFor - run a functor over an index range on several threads
+// .SECTION Description
+// vtkParallelFor splits the index range [begin, end) into chunks of
+// GrainSize indices and executes a vtkParallelForFunctor on them using
+// the threads of a vtkMultiThreader.  Chunks are handed out to the
+// threads as they become free, so uneven per-index costs are balanced.
+//
+// Each call of vtkParallelForFunctor::Execute receives the id of the
+// calling thread.  Before any chunk is executed Initialize is called
+// with the number of threads that will be used, so that the functor can
+// set up per-thread storage (scratch objects, partial sums, partial
+// outputs) indexed by thread id.  Once all threads are done Reduce is
+// called from the calling thread to combine the per-thread results.
+// Thread 0 is always the calling thread, so a functor can safely report
+// progress from it.  Filters are not thread safe: a functor should call
+// UpdateProgress() and GetAbortExecute() from thread 0 only, and let the
+// other threads stop on a flag that thread 0 sets.
+//
+// Small ranges, or a NumberOfThreads of 1, are executed directly on the
+// calling thread without creating threads.
+// .SECTION See Also
+// vtkMultiThreader
+
+#ifndef __vtkParallelFor_h
+#define __vtkParallelFor_h
+
+#include "vtkObject.h"
+
+class vtkMultiThreader;
+
+//BTX
+// The work done by vtkParallelFor.
+class VTK_COMMON_EXPORT vtkParallelForFunctor
+{
+public:
+  virtual ~vtkParallelForFunctor() {}
+
+  // Description:
+  // Called once, from the calling thread, before any chunk is executed.
+  virtual void Initialize(int vtkNotUsed(numberOfThreads)) {}
+
+  // Description:
+  // Process the indices [begin, end).  Called concurrently from several
+  // threads, never twice at the same time with the same threadId.
+  virtual void Execute(vtkIdType begin, vtkIdType end, int threadId) = 0;
+
+  // Description:
+  // Called once, from the calling thread, after all chunks are executed.
+  virtual void Reduce() {}
+};
+//ETX
+
+class VTK_COMMON_EXPORT vtkParallelFor : public vtkObject
+{
+public:
+  static vtkParallelFor *New();
+  vtkTypeRevisionMacro(vtkParallelFor,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set/Get the maximum number of threads to use.  Defaults to
+  // vtkMultiThreader::GetGlobalDefaultNumberOfThreads().
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Set/Get the number of indices handed to a thread at a time.  A value
+  // of 0, the default, picks a size giving each thread several chunks
+  // but no chunk smaller than MinimumGrainSize.
+  vtkSetClampMacro(GrainSize, vtkIdType, 0, VTK_LARGE_ID);
+  vtkGetMacro(GrainSize, vtkIdType);
+
+  // Description:
+  // Set/Get the smallest chunk used when GrainSize is 0.  Ranges shorter
+  // than this are executed on the calling thread.  Default is 1024.
+  vtkSetClampMacro(MinimumGrainSize, vtkIdType, 1, VTK_LARGE_ID);
+  vtkGetMacro(MinimumGrainSize, vtkIdType);
+
+  //BTX
+  // Description:
+  // Execute the functor over [begin, end).
+  void Execute(vtkIdType begin, vtkIdType end,
+               vtkParallelForFunctor *functor);
+  //ETX
+
+protected:
+  vtkParallelFor();
+  ~vtkParallelFor();
+
+  vtkMultiThreader *Threader;
+  int NumberOfThreads;
+  vtkIdType GrainSize;
+  vtkIdType MinimumGrainSize;
+
+private:
+  vtkParallelFor(const vtkParallelFor&);  // Not implemented.
+  void operator=(const vtkParallelFor&);  // Not implemented.
+};
+
+#endif
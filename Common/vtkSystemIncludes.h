@@ -108,17 +108,19 @@
 
 // For multithreading
 
-// The maximum number of threads allowed
+// The maximum number of threads allowed.  vtkMultiThreader sizes its
+// bookkeeping to the number of threads actually used, so this is only a
+// sanity limit.
 #ifdef VTK_USE_SPROC
-#define VTK_MAX_THREADS              32
+#define VTK_MAX_THREADS              1024
 #endif
 
 #ifdef VTK_USE_PTHREADS
-#define VTK_MAX_THREADS              32
+#define VTK_MAX_THREADS              1024
 #endif
 
 #ifdef VTK_USE_WIN32_THREADS
-#define VTK_MAX_THREADS              8
+#define VTK_MAX_THREADS              1024
 #endif
 
 #ifndef VTK_USE_WIN32_THREADS
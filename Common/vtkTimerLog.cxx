@@ -36,11 +36,236 @@
 #include <sys/types.h>
 #include <time.h>
 #endif
+
+#if defined(_WIN32)
+#include "vtkWindows.h"
+#elif defined(__APPLE__)
+#include <mach/mach_time.h>
+#endif
+
+#include "vtkCriticalSection.h"
 #include "vtkObjectFactory.h"
 
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
 vtkCxxRevisionMacro(vtkTimerLog, "$Revision$");
 vtkStandardNewMacro(vtkTimerLog);
 
+//----------------------------------------------------------------------------
+// The events of one thread, in a ring of MaxEntries entries.  Only the
+// thread owning the table writes to it, so recording takes no lock.
+class vtkTimerLogTable
+{
+public:
+  vtkTimerLogTable(int index)
+    {
+    this->Index = index;
+    this->NextEntry = 0;
+    this->WrapFlag = 0;
+    this->Indent = 0;
+    this->Count = 0;
+    this->InUse = 1;
+    }
+
+  int GetNumberOfEvents()
+    {
+    return this->WrapFlag ?
+      static_cast<int>(this->Entries.size()) : this->NextEntry;
+    }
+
+  vtkTimerLogEntry *GetEvent(int i)
+    {
+    int start = this->WrapFlag ? this->NextEntry : 0;
+    return &this->Entries[(i + start) % this->Entries.size()];
+    }
+
+  void Reset()
+    {
+    this->NextEntry = 0;
+    this->WrapFlag = 0;
+    }
+
+  // Resize the ring, keeping the newest entries.
+  void Resize(int size)
+    {
+    int num = this->GetNumberOfEvents();
+    int offset = (num > size ? num - size : 0);
+    vtkstd::vector<vtkTimerLogEntry> entries(size);
+    for (int i = offset; i < num; ++i)
+      {
+      entries[i - offset] = *this->GetEvent(i);
+      }
+    this->Entries.swap(entries);
+    this->NextEntry = (num - offset) % size;
+    this->WrapFlag = (num - offset == size);
+    }
+
+  vtkstd::vector<vtkTimerLogEntry> Entries;
+  int Index;
+  int NextEntry;
+  int WrapFlag;
+  int Indent;
+  unsigned long Count;
+  int InUse;
+};
+
+//----------------------------------------------------------------------------
+static bool vtkTimerLogEntryBefore(const vtkTimerLogEntry& a,
+                                   const vtkTimerLogEntry& b)
+{
+  return a.Time < b.Time;
+}
+
+#ifdef VTK_USE_PTHREADS
+extern "C" void vtkTimerLogReleaseTable(void *table);
+#endif
+
+//----------------------------------------------------------------------------
+// The tables of all threads and the merged view of them used by the
+// event access methods.
+class vtkTimerLogInternals
+{
+public:
+  vtkTimerLogInternals()
+    {
+    this->Generation = 0;
+    this->MergedGeneration = -1;
+    this->MergedCount = 0;
+#if defined(VTK_USE_PTHREADS)
+    pthread_key_create(&this->Key, vtkTimerLogReleaseTable);
+#elif defined(VTK_USE_WIN32_THREADS)
+    this->Key = TlsAlloc();
+#else
+    this->Table = 0;
+#endif
+    }
+
+  ~vtkTimerLogInternals()
+    {
+#if defined(VTK_USE_PTHREADS)
+    pthread_key_delete(this->Key);
+#elif defined(VTK_USE_WIN32_THREADS)
+    TlsFree(this->Key);
+#endif
+    for (size_t i = 0; i < this->Tables.size(); ++i)
+      {
+      delete this->Tables[i];
+      }
+    }
+
+  // The table of the calling thread, created on first use.  The tables
+  // of threads that have exited are reused, so programs creating many
+  // short lived threads do not accumulate tables.
+  vtkTimerLogTable *GetTable()
+    {
+#if defined(VTK_USE_PTHREADS)
+    vtkTimerLogTable *table =
+      static_cast<vtkTimerLogTable *>(pthread_getspecific(this->Key));
+#elif defined(VTK_USE_WIN32_THREADS)
+    vtkTimerLogTable *table =
+      static_cast<vtkTimerLogTable *>(TlsGetValue(this->Key));
+#else
+    vtkTimerLogTable *table = this->Table;
+#endif
+    if (table)
+      {
+      return table;
+      }
+
+    this->Lock.Lock();
+    for (size_t i = 0; i < this->Tables.size() && !table; ++i)
+      {
+      if (!this->Tables[i]->InUse)
+        {
+        table = this->Tables[i];
+        table->InUse = 1;
+        table->Indent = 0;
+        }
+      }
+    if (!table)
+      {
+      table = new vtkTimerLogTable(static_cast<int>(this->Tables.size()));
+      this->Tables.push_back(table);
+      }
+    this->Lock.Unlock();
+
+#if defined(VTK_USE_PTHREADS)
+    pthread_setspecific(this->Key, table);
+#elif defined(VTK_USE_WIN32_THREADS)
+    TlsSetValue(this->Key, table);
+#else
+    this->Table = table;
+#endif
+    return table;
+    }
+
+  // Update the merged view if events were recorded since the last call.
+  void Merge()
+    {
+    unsigned long count = 0;
+    size_t i;
+    for (i = 0; i < this->Tables.size(); ++i)
+      {
+      count += this->Tables[i]->Count;
+      }
+    if (count == this->MergedCount &&
+        this->Generation == this->MergedGeneration)
+      {
+      return;
+      }
+    this->MergedCount = count;
+    this->MergedGeneration = this->Generation;
+
+    this->Merged.clear();
+    for (i = 0; i < this->Tables.size(); ++i)
+      {
+      vtkTimerLogTable *table = this->Tables[i];
+      int num = table->GetNumberOfEvents();
+      for (int j = 0; j < num; ++j)
+        {
+        this->Merged.push_back(*table->GetEvent(j));
+        }
+      }
+    // stable, so events with equal times keep their order in a thread
+    vtkstd::stable_sort(this->Merged.begin(), this->Merged.end(),
+                        vtkTimerLogEntryBefore);
+    for (i = 0; i < this->Merged.size(); ++i)
+      {
+      this->Merged[i].WallTime = 1.0e-9 * static_cast<double>(
+        this->Merged[i].Time - this->Merged[0].Time);
+      }
+    }
+
+  vtkSimpleCriticalSection Lock;
+  vtkstd::vector<vtkTimerLogTable *> Tables;
+  vtkstd::vector<vtkTimerLogEntry> Merged;
+  unsigned long MergedCount;
+  int MergedGeneration;
+  int Generation;
+#if defined(VTK_USE_PTHREADS)
+  pthread_key_t Key;
+#elif defined(VTK_USE_WIN32_THREADS)
+  DWORD Key;
+#else
+  vtkTimerLogTable *Table;
+#endif
+};
+
+// Must be constructed before and destroyed after the cleanup singleton.
+static vtkTimerLogInternals vtkTimerLogInternalsInstance;
+
+#ifdef VTK_USE_PTHREADS
+//----------------------------------------------------------------------------
+// Called when a thread with a table exits.
+void vtkTimerLogReleaseTable(void *table)
+{
+  vtkTimerLogInternalsInstance.Lock.Lock();
+  static_cast<vtkTimerLogTable *>(table)->InUse = 0;
+  vtkTimerLogInternalsInstance.Lock.Unlock();
+}
+#endif
+
 // Create a singleton to cleanup the table.  No other singletons
 // should be using the timer log, so it is safe to do this without the
 // full ClassInitialize/ClassFinalize idiom.
@@ -56,11 +281,7 @@ static vtkTimerLogCleanup vtkTimerLogCleanupInstance;
 
 // initialze the class variables
 int vtkTimerLog::Logging = 1;
-int vtkTimerLog::Indent = 0;
 int vtkTimerLog::MaxEntries = 100;
-int vtkTimerLog::NextEntry = 0;
-int vtkTimerLog::WrapFlag = 0;
-vtkTimerLogEntry *vtkTimerLog::TimerLog = NULL;
 
 #ifdef CLK_TCK
 int vtkTimerLog::TicksPerSecond = CLK_TCK;
@@ -72,43 +293,79 @@ int vtkTimerLog::TicksPerSecond = 60;
 #define CLOCKS_PER_SEC (vtkTimerLog::TicksPerSecond)
 #endif
 
-
-#ifdef _WIN32
-#ifndef _WIN32_WCE
-timeb vtkTimerLog::FirstWallTime;
-timeb vtkTimerLog::CurrentWallTime;
+//----------------------------------------------------------------------------
+// Nanoseconds from a monotonic clock with an arbitrary origin.
+static vtkTypeInt64 vtkTimerLogGetMonotonicTime()
+{
+#if defined(_WIN32)
+  static LARGE_INTEGER frequency = { 0 };
+  if (frequency.QuadPart == 0)
+    {
+    QueryPerformanceFrequency(&frequency);
+    }
+  LARGE_INTEGER count;
+  QueryPerformanceCounter(&count);
+  // split to avoid overflowing the product
+  vtkTypeInt64 seconds = count.QuadPart / frequency.QuadPart;
+  vtkTypeInt64 rest = count.QuadPart % frequency.QuadPart;
+  return seconds * 1000000000 + rest * 1000000000 / frequency.QuadPart;
+#elif defined(__APPLE__)
+  static mach_timebase_info_data_t timebase = { 0, 0 };
+  if (timebase.denom == 0)
+    {
+    mach_timebase_info(&timebase);
+    }
+  return static_cast<vtkTypeInt64>(mach_absolute_time()) *
+    timebase.numer / timebase.denom;
+#elif defined(CLOCK_MONOTONIC)
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<vtkTypeInt64>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
 #else
-FILETIME vtkTimerLog::FirstWallTime;
-FILETIME vtkTimerLog::CurrentWallTime;
+  timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<vtkTypeInt64>(tv.tv_sec) * 1000000000 +
+    static_cast<vtkTypeInt64>(tv.tv_usec) * 1000;
 #endif
+}
+
+//----------------------------------------------------------------------------
+// CPU ticks used by the process.
+static int vtkTimerLogGetCpuTicks()
+{
+#ifdef _WIN32
+  return 0;
 #else
-timeval vtkTimerLog::FirstWallTime;
-timeval vtkTimerLog::CurrentWallTime;
-tms     vtkTimerLog::FirstCpuTicks;
-tms     vtkTimerLog::CurrentCpuTicks;
+  tms cpuTicks;
+  times(&cpuTicks);
+  return static_cast<int>(cpuTicks.tms_utime + cpuTicks.tms_stime);
 #endif
+}
 
 //----------------------------------------------------------------------------
 // Allocate timing table with MaxEntries elements.
 void vtkTimerLog::AllocateLog()
 {
-  if (vtkTimerLog::TimerLog != NULL)
-    {
-    delete [] vtkTimerLog::TimerLog;
-    }
-  vtkTimerLog::TimerLog = new vtkTimerLogEntry[vtkTimerLog::MaxEntries];
+  vtkTimerLogTable *table = vtkTimerLogInternalsInstance.GetTable();
+  table->Reset();
+  table->Entries.resize(vtkTimerLog::MaxEntries);
 }
 
 //----------------------------------------------------------------------------
-// Remove timer log.
+// Remove timer log.  The tables themselves stay registered since their
+// threads still refer to them.
 void vtkTimerLog::CleanupLog()
 {
-  if ( !vtkTimerLog::TimerLog )
+  vtkTimerLogInternals& internals = vtkTimerLogInternalsInstance;
+  internals.Lock.Lock();
+  for (size_t i = 0; i < internals.Tables.size(); ++i)
     {
-    return;
+    internals.Tables[i]->Reset();
+    vtkstd::vector<vtkTimerLogEntry>().swap(internals.Tables[i]->Entries);
     }
-  delete [] vtkTimerLog::TimerLog;
-  vtkTimerLog::TimerLog = 0;
+  vtkstd::vector<vtkTimerLogEntry>().swap(internals.Merged);
+  ++internals.Generation;
+  internals.Lock.Unlock();
 }
 
 //----------------------------------------------------------------------------
@@ -116,10 +373,14 @@ void vtkTimerLog::CleanupLog()
 // to zero when the first new event is recorded.
 void vtkTimerLog::ResetLog()
 {
-  vtkTimerLog::WrapFlag = 0;
-  vtkTimerLog::NextEntry = 0;
-  // may want to free TimerLog to force realloc so
-  // that user can resize the table by changing MaxEntries.
+  vtkTimerLogInternals& internals = vtkTimerLogInternalsInstance;
+  internals.Lock.Lock();
+  for (size_t i = 0; i < internals.Tables.size(); ++i)
+    {
+    internals.Tables[i]->Reset();
+    }
+  ++internals.Generation;
+  internals.Lock.Unlock();
 }
 
 
@@ -133,7 +394,7 @@ void vtkTimerLog::FormatAndMarkEvent(const char *format, ...)
     return;
     }
 
-  static  char event[4096];
+  char event[4096];
   va_list var_args;
   va_start(var_args, format);
   vsprintf(event, format, var_args);
@@ -146,97 +407,54 @@ void vtkTimerLog::FormatAndMarkEvent(const char *format, ...)
 //----------------------------------------------------------------------------
 // Record a timing event and capture walltime and cputicks.
 void vtkTimerLog::MarkEvent(const char *event)
+{
+  vtkTimerLog::RecordEvent(event, vtkTimerLog::STANDALONE);
+}
+
+//----------------------------------------------------------------------------
+// Append an event to the table of the calling thread.
+void vtkTimerLog::RecordEvent(const char *event, int type)
 {
   if (! vtkTimerLog::Logging)
     {
     return;
     }
 
-  int strsize;
-  double time_diff;
-  int ticks_diff;
+  vtkTimerLogTable *table = vtkTimerLogInternalsInstance.GetTable();
+  if (table->Entries.empty())
+    {
+    table->Entries.resize(vtkTimerLog::MaxEntries);
+    }
 
-  strsize = (strlen(event)) > VTK_LOG_EVENT_LENGTH - 1
+  int strsize = (strlen(event)) > VTK_LOG_EVENT_LENGTH - 1
     ? VTK_LOG_EVENT_LENGTH-1 : static_cast<int>(strlen(event));
 
-  // If this the first event we're recording, allocate the
-  // internal timing table and initialize WallTime and CpuTicks
-  // for this first event to zero.
-  if (vtkTimerLog::NextEntry == 0 && ! vtkTimerLog::WrapFlag)
+  vtkTimerLogEntry *entry = &table->Entries[table->NextEntry];
+  entry->WallTime = 0.0; // known once the tables are merged
+  entry->Time = vtkTimerLogGetMonotonicTime();
+  entry->CpuTicks = vtkTimerLogGetCpuTicks();
+  entry->Thread = table->Index;
+  entry->Indent = static_cast<unsigned char>(table->Indent);
+  entry->Type = static_cast<unsigned char>(type);
+  strncpy(entry->Event, event, strsize);
+  entry->Event[strsize] = '\0';
+
+  // end events are recorded at the indent of the events they enclose
+  if (type == vtkTimerLog::START)
     {
-    if (vtkTimerLog::TimerLog == NULL)
-      {
-      vtkTimerLog::AllocateLog();
-      }
-    
-#ifdef _WIN32
-#ifdef _WIN32_WCE
-    SYSTEMTIME st;
-    GetLocalTime(&st);
-    SystemTimeToFileTime(&st, &(vtkTimerLog::FirstWallTime)); 
-#else
-    ::ftime( &(vtkTimerLog::FirstWallTime) );
-#endif
-#else
-    gettimeofday( &(vtkTimerLog::FirstWallTime), NULL );
-    times(&FirstCpuTicks);
-#endif
-    
-    vtkTimerLog::TimerLog[0].Indent = vtkTimerLog::Indent;
-    vtkTimerLog::TimerLog[0].WallTime = 0.0;
-    vtkTimerLog::TimerLog[0].CpuTicks = 0;
-    strncpy(vtkTimerLog::TimerLog[0].Event, event, strsize);
-    vtkTimerLog::TimerLog[0].Event[strsize] = '\0';
-    vtkTimerLog::NextEntry = 1;
-    return;
+    ++table->Indent;
+    }
+  else if (type == vtkTimerLog::END)
+    {
+    --table->Indent;
     }
-  
-#ifdef _WIN32
-#ifdef _WIN32_WCE
-    SYSTEMTIME st;
-    GetLocalTime(&st);
-    SystemTimeToFileTime(&st, &(vtkTimerLog::CurrentWallTime)); 
-    time_diff = (vtkTimerLog::CurrentWallTime.dwHighDateTime - 
-      vtkTimerLog::FirstWallTime.dwHighDateTime);
-    time_diff = time_diff * 429.4967296;
-    time_diff = time_diff + ((vtkTimerLog::CurrentWallTime.dwLowDateTime - 
-      vtkTimerLog::FirstWallTime.dwLowDateTime) / 10000000.0);
-#else
-  static double scale = 1.0/1000.0;
-  ::ftime( &(vtkTimerLog::CurrentWallTime) );
-  time_diff = 
-    vtkTimerLog::CurrentWallTime.time - vtkTimerLog::FirstWallTime.time;
-  time_diff += 
-    (vtkTimerLog::CurrentWallTime.millitm
-     - vtkTimerLog::FirstWallTime.millitm) * scale;
-#endif
-  ticks_diff = 0;
-#else
-  static double scale = 1.0/1000000.0;
-  gettimeofday( &(vtkTimerLog::CurrentWallTime), NULL );
-  time_diff  =  vtkTimerLog::CurrentWallTime.tv_sec
-    - vtkTimerLog::FirstWallTime.tv_sec;
-  time_diff += 
-    (vtkTimerLog::CurrentWallTime.tv_usec
-     - vtkTimerLog::FirstWallTime.tv_usec) * scale;
-
-  times(&CurrentCpuTicks);
-  ticks_diff = (CurrentCpuTicks.tms_utime + CurrentCpuTicks.tms_stime) -
-                (FirstCpuTicks.tms_utime + FirstCpuTicks.tms_stime);
-#endif
-
-  vtkTimerLog::TimerLog[vtkTimerLog::NextEntry].Indent = vtkTimerLog::Indent;
-  vtkTimerLog::TimerLog[vtkTimerLog::NextEntry].WallTime =
-    static_cast<double>(time_diff);
-  vtkTimerLog::TimerLog[vtkTimerLog::NextEntry].CpuTicks = ticks_diff;
-  strncpy(vtkTimerLog::TimerLog[vtkTimerLog::NextEntry].Event, event, strsize);
-  vtkTimerLog::TimerLog[vtkTimerLog::NextEntry].Event[strsize] = '\0';
 
-  vtkTimerLog::NextEntry++;
-  if (vtkTimerLog::NextEntry == vtkTimerLog::MaxEntries)
+  ++table->Count;
+  ++table->NextEntry;
+  if (table->NextEntry == static_cast<int>(table->Entries.size()))
     {
-    vtkTimerLog::NextEntry = 0;
-    vtkTimerLog::WrapFlag = 1;
+    table->NextEntry = 0;
+    table->WrapFlag = 1;
     }
 }
 
@@ -246,13 +464,7 @@ void vtkTimerLog::MarkEvent(const char *event)
 // Increments indent after mark.
 void vtkTimerLog::MarkStartEvent(const char *event)
 {
-  if (! vtkTimerLog::Logging)
-    { // Maybe we should still change the Indent ...
-    return;
-    }
-
-  vtkTimerLog::MarkEvent(event);
-  ++vtkTimerLog::Indent;
+  vtkTimerLog::RecordEvent(event, vtkTimerLog::START);
 }
 
 //----------------------------------------------------------------------------
@@ -260,27 +472,15 @@ void vtkTimerLog::MarkStartEvent(const char *event)
 // Decrements indent after mark.
 void vtkTimerLog::MarkEndEvent(const char *event)
 {
-  if (! vtkTimerLog::Logging)
-    { // Maybe we should still change the Indent ...
-    return;
-    }
-
-  vtkTimerLog::MarkEvent(event);
-  --vtkTimerLog::Indent;
+  vtkTimerLog::RecordEvent(event, vtkTimerLog::END);
 }
 
 //----------------------------------------------------------------------------
 // Record a timing event and capture walltime and cputicks.
 int vtkTimerLog::GetNumberOfEvents()
 {
-  if (vtkTimerLog::WrapFlag)
-    {
-    return vtkTimerLog::MaxEntries;
-    }
-   else
-    {
-    return vtkTimerLog::NextEntry;
-    } 
+  vtkTimerLogInternalsInstance.Merge();
+  return static_cast<int>(vtkTimerLogInternalsInstance.Merged.size());
 }
 
 
@@ -288,20 +488,14 @@ int vtkTimerLog::GetNumberOfEvents()
 vtkTimerLogEntry *vtkTimerLog::GetEvent(int idx)
 {
   int num = vtkTimerLog::GetNumberOfEvents();
-  int start = 0;
-  if (vtkTimerLog::WrapFlag)
-    {
-    start = vtkTimerLog::NextEntry;
-    }
 
   if (idx < 0 || idx >= num)
     {
     cerr << "Bad entry index.";
     return NULL;
     }
-  idx = (idx + start) % vtkTimerLog::MaxEntries;
 
-  return vtkTimerLog::TimerLog + idx;
+  return &vtkTimerLogInternalsInstance.Merged[idx];
 }
 
 
@@ -321,6 +515,7 @@ int vtkTimerLog::GetEventIndent(int idx)
 }
 
 //----------------------------------------------------------------------------
+// Seconds since the first event in the log.
 double vtkTimerLog::GetEventWallTime(int idx)
 {
   vtkTimerLogEntry *tmp = vtkTimerLog::GetEvent(idx);
@@ -350,64 +545,118 @@ const char* vtkTimerLog::GetEventString(int idx)
     }
 }
 
+//----------------------------------------------------------------------------
+int vtkTimerLog::GetEventThread(int idx)
+{
+  vtkTimerLogEntry *tmp = vtkTimerLog::GetEvent(idx);
+
+  if (tmp) 
+    {
+    return tmp->Thread;
+    }
+  else
+    {
+    return 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkTimerLog::GetEventType(int idx)
+{
+  vtkTimerLogEntry *tmp = vtkTimerLog::GetEvent(idx);
+
+  if (tmp) 
+    {
+    return tmp->Type;
+    }
+  else
+    {
+    return vtkTimerLog::STANDALONE;
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Write the timing table out to a file.  Calculate some helpful
-// statistics (deltas and  percentages) in the process.
+// statistics (deltas and  percentages) in the process.  The events of
+// each thread are listed separately.
 void vtkTimerLog::DumpLogWithIndents(ostream *os, double threshold)
 {
 #ifndef _WIN32_WCE
-  int num;
-  int i1, i2, j;
+  vtkTimerLogInternals& internals = vtkTimerLogInternalsInstance;
+  int num = vtkTimerLog::GetNumberOfEvents();
+  int i, i1, i2, j;
   int indent1;
   int nextIndent;
   double dtime;
-  
-  num = vtkTimerLog::GetNumberOfEvents();
 
-  for (i1=0; i1 < num; i1++)
+  for (size_t t = 0; t < internals.Tables.size(); ++t)
     {
-    indent1 = vtkTimerLog::GetEventIndent(i1);
-
-    // Search for an end event.
-    i2 = i1 + 1;
-    while (i2 < num && vtkTimerLog::GetEventIndent(i2) > indent1)
-      { // This was a start event.
-      ++i2;
+    // the events of this thread, in order
+    vtkstd::vector<int> events;
+    for (i = 0; i < num; ++i)
+      {
+      if (internals.Merged[i].Thread == static_cast<int>(t))
+        {
+        events.push_back(i);
+        }
       }
-    // If the next indent is smaller, then the event should be an end event.
-    if (i2 == num)
+    int numEvents = static_cast<int>(events.size());
+    if (numEvents == 0)
       {
-      nextIndent = vtkTimerLog::Indent;
+      continue;
       }
-    else
+    if (internals.Tables.size() > 1)
       {
-      nextIndent = vtkTimerLog::GetEventIndent(i2);
+      *os << "Thread " << t << ":\n";
       }
 
-    // Backup one to get the end event.
-    --i2;
-
-    // Simple events and end events will have dtime of 0.
-    dtime = vtkTimerLog::GetEventWallTime(i2) - vtkTimerLog::GetEventWallTime(i1);
-    if (nextIndent == indent1)
-      { // not an end event
-      if (dtime >= threshold || i2 == i1)
-        { // start event past threshold or singleton event.
-        // Print the indent.
-        j = indent1;
-        while (j-- > 0)
-          {
-          *os << "    ";
-          }
-        *os << vtkTimerLog::GetEventString(i1);
-        if (i2 > i1)
-          { // Start event.
-          *os << ",  " << dtime << " seconds\n"; 
-          }
-        else
-          { // Singlton event.
-          *os << endl;
+    for (i1=0; i1 < numEvents; i1++)
+      {
+      indent1 = vtkTimerLog::GetEventIndent(events[i1]);
+
+      // Search for an end event.
+      i2 = i1 + 1;
+      while (i2 < numEvents &&
+             vtkTimerLog::GetEventIndent(events[i2]) > indent1)
+        { // This was a start event.
+        ++i2;
+        }
+      // If the next indent is smaller, then the event should be an end event.
+      if (i2 == numEvents)
+        {
+        nextIndent = internals.Tables[t]->Indent;
+        }
+      else
+        {
+        nextIndent = vtkTimerLog::GetEventIndent(events[i2]);
+        }
+
+      // Backup one to get the end event.
+      --i2;
+
+      // Simple events and end events will have dtime of 0.
+      dtime = vtkTimerLog::GetEventWallTime(events[i2]) -
+        vtkTimerLog::GetEventWallTime(events[i1]);
+      if (nextIndent == indent1)
+        { // not an end event
+        if (dtime >= threshold || i2 == i1)
+          { // start event past threshold or singleton event.
+          // Print the indent.
+          j = indent1;
+          while (j-- > 0)
+            {
+            *os << "    ";
+            }
+          *os << vtkTimerLog::GetEventString(events[i1]);
+          if (i2 > i1)
+            { // Start event.
+            *os << ",  " << dtime << " seconds\n"; 
+            }
+          else
+            { // Singlton event.
+            *os << endl;
+            }
           }
         }
       }
@@ -423,64 +672,108 @@ void vtkTimerLog::DumpLog(const char *filename)
 {
 #ifndef _WIN32_WCE
   ofstream os_with_warning_C4701(filename);
+  int num = vtkTimerLog::GetNumberOfEvents();
+  vtkTimerLogEntry *entries = (num ? &vtkTimerLogInternalsInstance.Merged[0] : 0);
   int i;
-    
-  if ( vtkTimerLog::WrapFlag )
-    {
-    vtkTimerLog::DumpEntry(os_with_warning_C4701, 0,
-                    vtkTimerLog::TimerLog[vtkTimerLog::NextEntry].WallTime, 0,
-                    vtkTimerLog::TimerLog[vtkTimerLog::NextEntry].CpuTicks, 0,
-                    vtkTimerLog::TimerLog[vtkTimerLog::NextEntry].Event);
-    for (i=vtkTimerLog::NextEntry+1; i<vtkTimerLog::MaxEntries; i++)
+
+  for (i = 0; i < num; i++)
+    {
+    double ttime = vtkTimerLog::GetEventWallTime(i);
+    int tick = entries[i].CpuTicks - entries[0].CpuTicks;
+    if (i == 0)
       {
-      vtkTimerLog::DumpEntry(os_with_warning_C4701,
-                i-vtkTimerLog::NextEntry, vtkTimerLog::TimerLog[i].WallTime,
-                vtkTimerLog::TimerLog[i].WallTime
-                 - vtkTimerLog::TimerLog[i-1].WallTime,
-                vtkTimerLog::TimerLog[i].CpuTicks,
-                vtkTimerLog::TimerLog[i].CpuTicks
-                 - vtkTimerLog::TimerLog[i-1].CpuTicks,
-                vtkTimerLog::TimerLog[i].Event);
+      vtkTimerLog::DumpEntry(os_with_warning_C4701, 0, ttime, 0, tick, 0,
+                             entries[i].Event);
       }
-    vtkTimerLog::DumpEntry(os_with_warning_C4701, vtkTimerLog::MaxEntries-vtkTimerLog::NextEntry,
-                    vtkTimerLog::TimerLog[0].WallTime,
-                    vtkTimerLog::TimerLog[0].WallTime
-                    -vtkTimerLog::TimerLog[vtkTimerLog::MaxEntries-1].WallTime,
-                    vtkTimerLog::TimerLog[0].CpuTicks,
-                    vtkTimerLog::TimerLog[0].CpuTicks
-                    -vtkTimerLog::TimerLog[vtkTimerLog::MaxEntries-1].CpuTicks,
-                    vtkTimerLog::TimerLog[0].Event);
-    for (i=1; i<vtkTimerLog::NextEntry; i++)
+    else
       {
-      vtkTimerLog::DumpEntry(os_with_warning_C4701, vtkTimerLog::MaxEntries-vtkTimerLog::NextEntry+i,
-                      vtkTimerLog::TimerLog[i].WallTime,
-                      vtkTimerLog::TimerLog[i].WallTime
-                      - vtkTimerLog::TimerLog[i-1].WallTime,
-                      vtkTimerLog::TimerLog[i].CpuTicks,
-                      vtkTimerLog::TimerLog[i].CpuTicks
-                      - vtkTimerLog::TimerLog[i-1].CpuTicks,
-                      vtkTimerLog::TimerLog[i].Event);
+      vtkTimerLog::DumpEntry(os_with_warning_C4701, i, ttime,
+                             ttime - vtkTimerLog::GetEventWallTime(i-1),
+                             tick, entries[i].CpuTicks - entries[i-1].CpuTicks,
+                             entries[i].Event);
       }
     }
-  else
+  
+  os_with_warning_C4701.close();
+#endif
+}
+
+//----------------------------------------------------------------------------
+// Write a string as a JSON string literal.
+static void vtkTimerLogWriteJSONString(ostream& os, const char *str)
+{
+  os << '"';
+  for (; *str; ++str)
     {
-    vtkTimerLog::DumpEntry(os_with_warning_C4701, 0, vtkTimerLog::TimerLog[0].WallTime, 0,
-                    vtkTimerLog::TimerLog[0].CpuTicks, 0,
-                    vtkTimerLog::TimerLog[0].Event);
-    for (i=1; i<vtkTimerLog::NextEntry; i++)
+    unsigned char c = static_cast<unsigned char>(*str);
+    if (c == '"' || c == '\\')
+      {
+      os << '\\' << *str;
+      }
+    else if (c < 0x20)
       {
-      vtkTimerLog::DumpEntry(os_with_warning_C4701, i, vtkTimerLog::TimerLog[i].WallTime,
-                      vtkTimerLog::TimerLog[i].WallTime
-                      - vtkTimerLog::TimerLog[i-1].WallTime,
-                      vtkTimerLog::TimerLog[i].CpuTicks,
-                      vtkTimerLog::TimerLog[i].CpuTicks
-                      - vtkTimerLog::TimerLog[i-1].CpuTicks,
-                      vtkTimerLog::TimerLog[i].Event);
+      char escaped[8];
+      sprintf(escaped, "\\u%04x", c);
+      os << escaped;
+      }
+    else
+      {
+      os << *str;
       }
     }
-  
-  os_with_warning_C4701.close();
+  os << '"';
+}
+
+//----------------------------------------------------------------------------
+void vtkTimerLog::DumpTraceEvents(const char *filename)
+{
+  ofstream os(filename);
+  if (!os)
+    {
+    vtkGenericWarningMacro("Could not open " << filename);
+    return;
+    }
+  vtkTimerLog::DumpTraceEvents(&os);
+}
+
+//----------------------------------------------------------------------------
+// Timestamps are in microseconds since the first event.
+void vtkTimerLog::DumpTraceEvents(ostream *os)
+{
+  int num = vtkTimerLog::GetNumberOfEvents();
+#ifdef _WIN32
+  int pid = static_cast<int>(GetCurrentProcessId());
+#else
+  int pid = static_cast<int>(getpid());
 #endif
+
+  *os << "{\"traceEvents\":[";
+  for (int i = 0; i < num; i++)
+    {
+    vtkTimerLogEntry *entry = &vtkTimerLogInternalsInstance.Merged[i];
+    const char *phase = "i";
+    if (entry->Type == vtkTimerLog::START)
+      {
+      phase = "B";
+      }
+    else if (entry->Type == vtkTimerLog::END)
+      {
+      phase = "E";
+      }
+    char ts[64];
+    sprintf(ts, "%.3f", 1.0e6 * vtkTimerLog::GetEventWallTime(i));
+
+    *os << (i ? ",\n" : "\n") << "{\"name\":";
+    vtkTimerLogWriteJSONString(*os, entry->Event);
+    *os << ",\"ph\":\"" << phase << "\",\"ts\":" << ts
+        << ",\"pid\":" << pid << ",\"tid\":" << entry->Thread;
+    if (entry->Type == vtkTimerLog::STANDALONE)
+      {
+      *os << ",\"s\":\"t\"";
+      }
+    *os << "}";
+    }
+  *os << "\n]}\n";
 }
 
 
@@ -491,33 +784,27 @@ void vtkTimerLog::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   int i;
+  int num = vtkTimerLog::GetNumberOfEvents();
 
   os << indent << "MaxEntries: " << vtkTimerLog::MaxEntries << "\n";
-  os << indent << "NextEntry: " << vtkTimerLog::NextEntry << "\n";
-  os << indent << "WrapFlag: " << vtkTimerLog::WrapFlag << "\n";
+  os << indent << "NumberOfEvents: " << num << "\n";
+  os << indent << "NumberOfThreads: "
+     << vtkTimerLogInternalsInstance.Tables.size() << "\n";
   os << indent << "TicksPerSecond: " << vtkTimerLog::TicksPerSecond << "\n";
   os << "\n";
 
-  os << indent << "Entry \tWall Time\tCpuTicks\tEvent\n";
+  os << indent << "Entry \tWall Time\tCpuTicks\tThread\tEvent\n";
   os << indent << "----------------------------------------------\n";
 
-  if ( vtkTimerLog::WrapFlag )
-    {
-    for (i=vtkTimerLog::NextEntry; i<vtkTimerLog::MaxEntries; i++)
-      {
-      os << indent << i << "\t\t" << TimerLog[i].WallTime << "\t\t" << 
-        TimerLog[i].CpuTicks << "\t\t" << TimerLog[i].Event << "\n";
-      }
-    }
-  
-  for (i=0; i<vtkTimerLog::NextEntry; i++)
+  for (i=0; i<num; i++)
     {
-    os << indent << i << "\t\t" << TimerLog[i].WallTime << "\t\t" << 
-      TimerLog[i].CpuTicks << "\t\t" << TimerLog[i].Event << "\n";
+    vtkTimerLogEntry *entry = &vtkTimerLogInternalsInstance.Merged[i];
+    os << indent << i << "\t\t" << vtkTimerLog::GetEventWallTime(i) << "\t\t"
+       << entry->CpuTicks - vtkTimerLogInternalsInstance.Merged[0].CpuTicks
+       << "\t\t" << entry->Thread << "\t" << entry->Event << "\n";
     }
   
   os << "\n" << indent << "StartTime: " << this->StartTime << "\n";
-  os << indent << "WrapFlag: " << vtkTimerLog::WrapFlag << "\n";
 }
 
 
@@ -613,42 +900,24 @@ void vtkTimerLog::DumpEntry(ostream& os, int index, double ttime,
 //----------------------------------------------------------------------------
 void vtkTimerLog::SetMaxEntries(int a)
 {
-  int num, i, offset;
-  vtkTimerLogEntry *newLog, *tmp;
-
-  if (vtkTimerLog::MaxEntries == a)
+  if (vtkTimerLog::MaxEntries == a || a < 1)
     {
     return;
     }
 
-  newLog = new vtkTimerLogEntry[a];
-  if (vtkTimerLog::TimerLog == NULL)
+  // Keep the newest events of each thread.
+  vtkTimerLogInternals& internals = vtkTimerLogInternalsInstance;
+  internals.Lock.Lock();
+  for (size_t i = 0; i < internals.Tables.size(); ++i)
     {
-    vtkTimerLog::MaxEntries = a;
-    vtkTimerLog::TimerLog = newLog;
-    return;
-    }
-
-  // Copy the old log to the new.
-  num = vtkTimerLog::GetNumberOfEvents();
-  offset = 0;
-  if (a < num)
-    {
-    offset = num - a;
-    num = a;
-    }
-
-  for (i = 0; i < num; ++i)
-    {
-    tmp = vtkTimerLog::GetEvent(i+offset);
-    newLog[i] = *tmp;
+    if (!internals.Tables[i]->Entries.empty())
+      {
+      internals.Tables[i]->Resize(a);
+      }
     }
-
-  delete [] vtkTimerLog::TimerLog;
   vtkTimerLog::MaxEntries = a;
-  vtkTimerLog::TimerLog = newLog;
-  vtkTimerLog::WrapFlag = 0;
-  vtkTimerLog::NextEntry = num;
+  ++internals.Generation;
+  internals.Lock.Unlock();
 }
   
 
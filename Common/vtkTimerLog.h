@@ -18,6 +18,14 @@
 // with a given event.  These results can be later analyzed when
 // "dumping out" the table.
 //
+// Each thread records its events in a table of its own, without
+// locking, so threaded filters can be instrumented.  The tables are
+// merged in time order when the events are accessed or dumped, which
+// should be done while no other thread is recording.  Wall times come
+// from a monotonic clock with nanosecond resolution where available.
+// DumpTraceEvents() writes the events in the trace event format read by
+// the Chrome trace viewer, one row per thread.
+//
 // In addition, vtkTimerLog allows the user to simply get the current
 // time, and to start/stop a simple timer separate from the timing
 // table logging.
@@ -64,10 +72,13 @@
 //BTX
 typedef struct
 {
-  double WallTime;
+  double WallTime; // seconds since the first event of the log
+  vtkTypeInt64 Time; // monotonic, in nanoseconds
   int CpuTicks;
+  int Thread;
   char Event[VTK_LOG_EVENT_LENGTH];
   unsigned char Indent;
+  unsigned char Type;
 } vtkTimerLogEntry;
 //ETX
 
@@ -88,7 +99,8 @@ public:
   static void LoggingOff() {vtkTimerLog::SetLogging(0);}
 
   // Description:
-  // Set/Get the maximum number of entries allowed in the timer log
+  // Set/Get the maximum number of entries allowed in the timer log of
+  // each thread.
   static void SetMaxEntries(int a);
   static int  GetMaxEntries();
 
@@ -107,7 +119,9 @@ public:
   // Description:
   // I want to time events, so I am creating this interface to
   // mark events that have a start and an end.  These events can be,
-  // nested. The standard Dumplog ignores the indents.
+  // nested. The standard Dumplog ignores the indents.  Nesting is
+  // tracked per thread, and DumpLogWithIndents lists each thread
+  // separately.
   static void MarkStartEvent(const char *EventString);
   static void MarkEndEvent(const char *EventString);
 //BTX
@@ -115,11 +129,33 @@ public:
 //ETX
 
   // Description:
-  // Programatic access to events.  Indexed from 0 to num-1.
+  // Write the events in the Chrome trace event JSON format.  Start and
+  // end events become duration events, other events instant events.
+  static void DumpTraceEvents(const char *filename);
+//BTX
+  static void DumpTraceEvents(ostream *os);
+//ETX
+
+//BTX
+  enum EventType
+  {
+    STANDALONE,
+    START,
+    END
+  };
+//ETX
+
+  // Description:
+  // Programatic access to events.  Indexed from 0 to num-1, in the order
+  // they were recorded in.  The thread of an event is the index of the
+  // table it was recorded in; tables of threads that have exited are
+  // reused.  The type is one of the EventType values.
   static int GetNumberOfEvents();
   static int GetEventIndent(int i);
   static double GetEventWallTime(int i);
   static const char* GetEventString(int i);
+  static int GetEventThread(int i);
+  static int GetEventType(int i);
 
   // Description:
   // Record a timing event and capture wall time and cpu ticks.
@@ -131,7 +167,8 @@ public:
   static void ResetLog();
 
   // Description:
-  // Allocate timing table with MaxEntries elements.
+  // Allocate the timing table of the calling thread with MaxEntries
+  // elements.
   static void AllocateLog();
 
   // Description:
@@ -181,29 +218,11 @@ protected:
   virtual ~vtkTimerLog() { };
 
   static vtkTimerLogEntry* GetEvent(int i);
+  static void RecordEvent(const char *EventString, int type);
 
   static int               Logging;
-  static int               Indent;
   static int               MaxEntries;
-  static int               NextEntry;
-  static int               WrapFlag;
   static int               TicksPerSecond;
-  static vtkTimerLogEntry *TimerLog;
-
-#ifdef _WIN32
-#ifndef _WIN32_WCE
-  static timeb             FirstWallTime;
-  static timeb             CurrentWallTime;
-#else
-  static FILETIME FirstWallTime;
-  static FILETIME CurrentWallTime;
-#endif
-#else
-  static timeval           FirstWallTime;
-  static timeval           CurrentWallTime;
-  static tms               FirstCpuTicks;
-  static tms               CurrentCpuTicks;
-#endif
 
   // instance variables to support simple timing functionality,
   // separate from timer table logging.
@@ -0,0 +1,414 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compare the batched cell locator queries with the one-at-a-time ones.
+
+#include "vtkCellLocator.h"
+#include "vtkCellLocatorInterpolatedVelocityField.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkMath.h"
+#include "vtkModifiedBSPTree.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkStructuredGrid.h"
+#include "vtkTestUtilities.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <vtkstd/vector>
+
+#define NUMBER_OF_QUERIES 5000
+
+static vtkStructuredGrid* MakeGrid()
+{
+  static int dims[3]={20,20,20};
+  vtkStructuredGrid *sgrid = vtkStructuredGrid::New();
+  sgrid->SetDimensions(dims);
+  vtkPoints *points = vtkPoints::New();
+  vtkDoubleArray *vectors = vtkDoubleArray::New();
+  vectors->SetNumberOfComponents(3);
+  double x[3];
+  for (int k=0; k<dims[2]; k++)
+    {
+    for (int j=0; j<dims[1]; j++)
+      {
+      for (int i=0; i<dims[0]; i++)
+        {
+        x[0] = i + 0.1*sin(0.5*j);
+        x[1] = j + 0.1*cos(0.5*k);
+        x[2] = k + 0.02*i*j;
+        points->InsertNextPoint(x);
+        vectors->InsertNextTuple3(x[1], -x[0], 1.0);
+        }
+      }
+    }
+  sgrid->SetPoints(points);
+  sgrid->GetPointData()->SetVectors(vectors);
+  points->Delete();
+  vectors->Delete();
+  return sgrid;
+}
+
+static int CompareFindCells(vtkAbstractCellLocator* locator,
+                            vtkPoints* queries)
+{
+  int rval = 0;
+  vtkSmartPointer<vtkIdList> cellIds = vtkSmartPointer<vtkIdList>::New();
+  vtkSmartPointer<vtkDoubleArray> pcoords =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  vtkSmartPointer<vtkDoubleArray> weights =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  locator->FindCells(queries, 0.0, cellIds, pcoords, weights);
+
+  vtkSmartPointer<vtkGenericCell> cell = vtkSmartPointer<vtkGenericCell>::New();
+  double x[3], pc[3], w[8];
+  int found = 0;
+  for (vtkIdType i=0; i<queries->GetNumberOfPoints(); i++)
+    {
+    queries->GetPoint(i, x);
+    vtkIdType cellId = locator->FindCell(x, 0.0, cell, pc, w);
+    if (cellId != cellIds->GetId(i))
+      {
+      cerr << locator->GetClassName() << " FindCells returned "
+           << cellIds->GetId(i) << " instead of " << cellId << endl;
+      rval++;
+      continue;
+      }
+    if (cellId >= 0)
+      {
+      found++;
+      double *bpc = pcoords->GetPointer(3*i);
+      double *bw = weights->GetPointer(8*i);
+      for (int j=0; j<8; j++)
+        {
+        if ((j < 3 && bpc[j] != pc[j]) || bw[j] != w[j])
+          {
+          cerr << locator->GetClassName() << " FindCells returned other "
+               << "parametric coordinates or weights for point " << i
+               << endl;
+          rval++;
+          break;
+          }
+        }
+      }
+    }
+  if (found == 0)
+    {
+    cerr << locator->GetClassName() << " found no cells" << endl;
+    rval++;
+    }
+  return rval;
+}
+
+static int CompareIntersectWithLines(vtkAbstractCellLocator* locator,
+                                     vtkPoints* p1, vtkPoints* p2)
+{
+  int rval = 0;
+  vtkSmartPointer<vtkIdList> cellIds = vtkSmartPointer<vtkIdList>::New();
+  vtkSmartPointer<vtkDoubleArray> t = vtkSmartPointer<vtkDoubleArray>::New();
+  vtkSmartPointer<vtkPoints> x = vtkSmartPointer<vtkPoints>::New();
+  locator->IntersectWithLines(p1, p2, 0.001, cellIds, t, x);
+
+  double a0[3], a1[3], tt, xx[3], pcoords[3];
+  int subId;
+  for (vtkIdType i=0; i<p1->GetNumberOfPoints(); i++)
+    {
+    p1->GetPoint(i, a0);
+    p2->GetPoint(i, a1);
+    vtkIdType cellId = -1;
+    if (!locator->IntersectWithLine(a0, a1, 0.001, tt, xx, pcoords, subId,
+                                    cellId))
+      {
+      cellId = -1;
+      }
+    if (cellId != cellIds->GetId(i) ||
+        (cellId >= 0 && (tt != t->GetValue(i) ||
+                         vtkMath::Distance2BetweenPoints(xx, x->GetPoint(i))
+                         != 0.0)))
+      {
+      cerr << locator->GetClassName() << " IntersectWithLines returned "
+           << cellIds->GetId(i) << " instead of " << cellId << endl;
+      rval++;
+      }
+    }
+  return rval;
+}
+
+static int CompareFindClosestPoints(vtkAbstractCellLocator* locator,
+                                    vtkPoints* queries)
+{
+  int rval = 0;
+  vtkSmartPointer<vtkIdList> cellIds = vtkSmartPointer<vtkIdList>::New();
+  vtkSmartPointer<vtkPoints> closest = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkDoubleArray> dist2 =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  locator->FindClosestPoints(queries, cellIds, closest, dist2);
+
+  double x[3], cp[3], d2;
+  int subId;
+  vtkIdType cellId;
+  for (vtkIdType i=0; i<queries->GetNumberOfPoints(); i++)
+    {
+    queries->GetPoint(i, x);
+    locator->FindClosestPoint(x, cp, cellId, subId, d2);
+    if (cellId != cellIds->GetId(i) || d2 != dist2->GetValue(i))
+      {
+      cerr << locator->GetClassName() << " FindClosestPoints returned "
+           << cellIds->GetId(i) << " instead of " << cellId << endl;
+      rval++;
+      }
+    }
+  return rval;
+}
+
+// Copy a locator file with the vtkIdType at byte position replaced by
+// value, counting from the end if position is negative, or with the last
+// value cut off if truncate is set.
+static void WriteDamagedLocator(const char* fileName, const char* damagedName,
+                                long position, vtkIdType value, int truncate)
+{
+  ifstream in(fileName, ios::in | ios::binary);
+  in.seekg(0, ios::end);
+  long size = static_cast<long>(in.tellg());
+  in.seekg(0, ios::beg);
+  vtkstd::vector<char> buffer(size);
+  in.read(&buffer[0], size);
+  in.close();
+  if (truncate)
+    {
+    size -= sizeof(vtkIdType);
+    }
+  else
+    {
+    memcpy(&buffer[position < 0 ? size + position : position], &value,
+           sizeof(vtkIdType));
+    }
+  ofstream out(damagedName, ios::out | ios::binary);
+  out.write(&buffer[0], size);
+}
+
+static int CompareReadLocator(vtkCellLocator* locator, vtkStructuredGrid* sgrid,
+                              vtkPoints* p1, vtkPoints* p2,
+                              const char* fileName, const char* damagedName)
+{
+  int rval = 0;
+  if (!locator->WriteSearchStructure(fileName))
+    {
+    cerr << "WriteSearchStructure failed" << endl;
+    return 1;
+    }
+
+  vtkSmartPointer<vtkCellLocator> readLocator =
+    vtkSmartPointer<vtkCellLocator>::New();
+  readLocator->SetDataSet(sgrid);
+  if (!readLocator->ReadSearchStructure(fileName))
+    {
+    cerr << "ReadSearchStructure failed" << endl;
+    vtksys::SystemTools::RemoveFile(fileName);
+    return 1;
+    }
+  if (readLocator->GetNumberOfBuckets() != locator->GetNumberOfBuckets())
+    {
+    cerr << "The read locator has " << readLocator->GetNumberOfBuckets()
+         << " buckets instead of " << locator->GetNumberOfBuckets() << endl;
+    rval++;
+    }
+
+  double a0[3], a1[3], t, x[3], pcoords[3];
+  int subId;
+  vtkIdType cellId, readCellId;
+  for (vtkIdType i=0; i<p1->GetNumberOfPoints(); i++)
+    {
+    p1->GetPoint(i, a0);
+    p2->GetPoint(i, a1);
+    if (locator->FindCell(a0) != readLocator->FindCell(a0))
+      {
+      cerr << "The read locator found another cell for point " << i << endl;
+      rval++;
+      }
+    if (!locator->IntersectWithLine(a0, a1, 0.001, t, x, pcoords, subId,
+                                    cellId))
+      {
+      cellId = -1;
+      }
+    if (!readLocator->IntersectWithLine(a0, a1, 0.001, t, x, pcoords, subId,
+                                        readCellId))
+      {
+      readCellId = -1;
+      }
+    if (cellId != readCellId)
+      {
+      cerr << "The read locator intersected another cell for line " << i
+           << endl;
+      rval++;
+      }
+    }
+
+  // a locator file only fits a data set with the same number of cells
+  vtkSmartPointer<vtkStructuredGrid> other =
+    vtkSmartPointer<vtkStructuredGrid>::New();
+  other->SetDimensions(2, 2, 2);
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for (int j=0; j<8; j++)
+    {
+    points->InsertNextPoint(j & 1, (j >> 1) & 1, (j >> 2) & 1);
+    }
+  other->SetPoints(points);
+  readLocator->SetDataSet(other);
+  readLocator->GlobalWarningDisplayOff();
+  if (readLocator->ReadSearchStructure(fileName))
+    {
+    cerr << "ReadSearchStructure accepted another data set" << endl;
+    rval++;
+    }
+
+  // damaged files: truncated, with a cell id out of range, with
+  // decreasing offsets and with a wrong number of cell ids.  The header is
+  // the signature, four ints, the two counts and the bounds.
+  readLocator->SetDataSet(sgrid);
+  const long countsEnd = static_cast<long>(
+    sizeof("vtkCellLocator 1\n") + 4*sizeof(int) + 2*sizeof(vtkIdType));
+  const long offsetsStart = countsEnd + static_cast<long>(6*sizeof(double));
+  const char* damages[4] = { "truncated", "cell id", "offsets",
+                             "cell id count" };
+  long positions[4] = { 0, -static_cast<long>(sizeof(vtkIdType)),
+                        offsetsStart + static_cast<long>(sizeof(vtkIdType)),
+                        countsEnd - static_cast<long>(sizeof(vtkIdType)) };
+  vtkIdType values[4] = { 0, sgrid->GetNumberOfCells(), -1, 0x7fffffff };
+  for (int d=0; d<4; d++)
+    {
+    WriteDamagedLocator(fileName, damagedName, positions[d], values[d],
+                        d == 0);
+    if (readLocator->ReadSearchStructure(damagedName))
+      {
+      cerr << "ReadSearchStructure accepted a file with damaged "
+           << damages[d] << endl;
+      rval++;
+      }
+    }
+  readLocator->GlobalWarningDisplayOn();
+
+  vtksys::SystemTools::RemoveFile(fileName);
+  vtksys::SystemTools::RemoveFile(damagedName);
+  return rval;
+}
+
+static int CompareVelocityField(vtkStructuredGrid* sgrid, vtkPoints* queries)
+{
+  int rval = 0;
+  vtkSmartPointer<vtkCellLocatorInterpolatedVelocityField> field =
+    vtkSmartPointer<vtkCellLocatorInterpolatedVelocityField>::New();
+  vtkSmartPointer<vtkCellLocator> prototype =
+    vtkSmartPointer<vtkCellLocator>::New();
+  field->SetCellLocatorPrototype(prototype);
+  field->AddDataSet(sgrid);
+
+  vtkSmartPointer<vtkDoubleArray> f = vtkSmartPointer<vtkDoubleArray>::New();
+  vtkIdType numFound = field->FunctionValuesAtPoints(queries, f);
+
+  double x[4], v[3];
+  vtkIdType found = 0;
+  x[3] = 0.0;
+  for (vtkIdType i=0; i<queries->GetNumberOfPoints(); i++)
+    {
+    queries->GetPoint(i, x);
+    if (!field->FunctionValues(x, v))
+      {
+      v[0] = v[1] = v[2] = 0.0;
+      }
+    else
+      {
+      found++;
+      }
+    double *bv = f->GetPointer(3*i);
+    if (fabs(v[0]-bv[0]) + fabs(v[1]-bv[1]) + fabs(v[2]-bv[2]) > 1.0e-6)
+      {
+      cerr << "FunctionValuesAtPoints returned (" << bv[0] << ", " << bv[1]
+           << ", " << bv[2] << ") instead of (" << v[0] << ", " << v[1]
+           << ", " << v[2] << ")" << endl;
+      rval++;
+      }
+    }
+  if (found != numFound)
+    {
+    cerr << "FunctionValuesAtPoints found " << numFound << " points instead "
+         << "of " << found << endl;
+    rval++;
+    }
+  return rval;
+}
+
+int TestCellLocators(int argc, char* argv[])
+{
+  int rval = 0;
+
+  // Make sure the queries are spread over several threads.
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  vtkStructuredGrid *sgrid = MakeGrid();
+  double bounds[6];
+  sgrid->GetBounds(bounds);
+
+  // points and lines both inside and outside the grid
+  vtkMath::RandomSeed(8775070);
+  vtkSmartPointer<vtkPoints> p1 = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkPoints> p2 = vtkSmartPointer<vtkPoints>::New();
+  for (int i=0; i<NUMBER_OF_QUERIES; i++)
+    {
+    double x[3], y[3];
+    for (int j=0; j<3; j++)
+      {
+      double length = bounds[2*j+1] - bounds[2*j];
+      x[j] = vtkMath::Random(bounds[2*j] - 0.1*length,
+                             bounds[2*j+1] + 0.1*length);
+      y[j] = vtkMath::Random(bounds[2*j] - 0.1*length,
+                             bounds[2*j+1] + 0.1*length);
+      }
+    p1->InsertNextPoint(x);
+    p2->InsertNextPoint(y);
+    }
+
+  vtkSmartPointer<vtkCellLocator> cellLocator =
+    vtkSmartPointer<vtkCellLocator>::New();
+  cellLocator->SetDataSet(sgrid);
+  cellLocator->CacheCellBoundsOn();
+  cellLocator->BuildLocator();
+  rval += CompareFindCells(cellLocator, p1);
+  rval += CompareIntersectWithLines(cellLocator, p1, p2);
+  rval += CompareFindClosestPoints(cellLocator, p1);
+  char* fileName = vtkTestUtilities::ExpandFileNameWithArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", ".", "TestCellLocators.locator");
+  char* damagedName = vtkTestUtilities::ExpandFileNameWithArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", ".", "TestCellLocatorsDamaged.locator");
+  rval += CompareReadLocator(cellLocator, sgrid, p1, p2, fileName,
+                             damagedName);
+  delete [] fileName;
+  delete [] damagedName;
+
+  // lazily built on the first batched query
+  vtkSmartPointer<vtkModifiedBSPTree> bspTree =
+    vtkSmartPointer<vtkModifiedBSPTree>::New();
+  bspTree->SetDataSet(sgrid);
+  bspTree->LazyEvaluationOn();
+  rval += CompareFindCells(bspTree, p1);
+  rval += CompareIntersectWithLines(bspTree, p1, p2);
+
+  rval += CompareVelocityField(sgrid, p1);
+
+  sgrid->Delete();
+  return rval;
+}
@@ -0,0 +1,138 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Evaluate vtkInterpolatedVelocityField along a path through a tetrahedral
+// grid with and without the neighbor walk and check that both give the
+// same velocities.
+
+#include "vtkDoubleArray.h"
+#include "vtkInterpolatedVelocityField.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+#define GRID_SIZE 12
+
+// a distorted lattice of tetrahedra with a linear velocity field that any
+// containing cell interpolates exactly
+static vtkUnstructuredGrid* MakeTetraGrid()
+{
+  vtkUnstructuredGrid* grid =
+    vtkTestDataSetUtilities::MakeTetraGrid(GRID_SIZE, 0.2);
+  vtkDoubleArray* vectors = vtkDoubleArray::New();
+  vectors->SetName("Velocity");
+  vectors->SetNumberOfComponents(3);
+  for(vtkIdType i=0;i<grid->GetNumberOfPoints();i++)
+    {
+    double x[3];
+    grid->GetPoint(i, x);
+    vectors->InsertNextTuple3(1.0 + 0.1*x[1], 0.5 - 0.2*x[2], 0.3 + 0.05*x[0]);
+    }
+  grid->GetPointData()->SetVectors(vectors);
+  vectors->Delete();
+  return grid;
+}
+
+int TestInterpolatedVelocityField(int, char*[])
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid;
+  grid.TakeReference(MakeTetraGrid());
+
+  vtkSmartPointer<vtkInterpolatedVelocityField> plain =
+    vtkSmartPointer<vtkInterpolatedVelocityField>::New();
+  plain->AddDataSet(grid);
+  vtkSmartPointer<vtkInterpolatedVelocityField> walker =
+    vtkSmartPointer<vtkInterpolatedVelocityField>::New();
+  walker->NeighborWalkOn();
+  walker->AddDataSet(grid);
+
+  // a helix through the grid with short steps, a few jumps across it and a
+  // few points outside of it
+  int rval = 0;
+  const int numSteps = 4000;
+  double x[3], f1[3], f2[3];
+  for(int i=0;i<numSteps;i++)
+    {
+    double t = 0.01*i;
+    x[0] = 6.0 + 4.0*cos(t);
+    x[1] = 6.0 + 4.0*sin(t);
+    x[2] = 1.0 + 0.25*t;
+    if(i % 1000 == 500)
+      {
+      x[0] = 12.0 - x[0];
+      x[1] = 12.0 - x[1];
+      }
+    if(i % 1000 == 999)
+      {
+      x[2] = -5.0;
+      }
+    int found1 = plain->FunctionValues(x, f1);
+    int found2 = walker->FunctionValues(x, f2);
+    if(found1 != found2)
+      {
+      cerr << "Point " << i << " found " << found1 << " without and "
+           << found2 << " with the neighbor walk" << endl;
+      rval = 1;
+      continue;
+      }
+    if(found1 &&
+       (fabs(f1[0]-f2[0]) > 1e-9 || fabs(f1[1]-f2[1]) > 1e-9 ||
+        fabs(f1[2]-f2[2]) > 1e-9))
+      {
+      cerr << "Point " << i << " velocity (" << f2[0] << ", " << f2[1]
+           << ", " << f2[2] << ") instead of (" << f1[0] << ", " << f1[1]
+           << ", " << f1[2] << ")" << endl;
+      rval = 1;
+      }
+    }
+
+  cout << "Cache hits: " << walker->GetCacheHit()
+       << ", walk hits: " << walker->GetWalkHit()
+       << " in " << walker->GetWalkSteps() << " steps"
+       << ", global searches: " << walker->GetGlobalSearches() << endl;
+  if(walker->GetWalkHit() == 0 ||
+     walker->GetCacheHit() + walker->GetWalkHit() < numSteps * 9 / 10)
+    {
+    cerr << "Too few points found in the cached cell or by walking" << endl;
+    rval = 1;
+    }
+  if(walker->GetGlobalSearches() > 50)
+    {
+    cerr << "Too many global searches" << endl;
+    rval = 1;
+    }
+
+  walker->ClearStatistics();
+  if(walker->GetCacheHit() || walker->GetCacheMiss() || walker->GetWalkHit() ||
+     walker->GetWalkSteps() || walker->GetGlobalSearches())
+    {
+    cerr << "ClearStatistics left counts behind" << endl;
+    rval = 1;
+    }
+
+  // the settings follow the function when it is copied
+  vtkSmartPointer<vtkInterpolatedVelocityField> copy =
+    vtkSmartPointer<vtkInterpolatedVelocityField>::New();
+  walker->SetMaximumNumberOfWalkSteps(5);
+  copy->CopyParameters(walker);
+  if(!copy->GetNeighborWalk() || copy->GetMaximumNumberOfWalkSteps() != 5)
+    {
+    cerr << "CopyParameters did not copy the neighbor walk settings" << endl;
+    rval = 1;
+    }
+
+  return rval;
+}
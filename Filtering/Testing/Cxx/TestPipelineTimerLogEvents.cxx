@@ -0,0 +1,79 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Execute an algorithm with the global timer log events of the pipeline
+// off, which must leave the timer log empty, and then on, which must
+// bracket the execution with a start and an end event.
+
+#include "vtkDemandDrivenPipeline.h"
+#include "vtkObjectFactory.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+#include <string.h>
+
+class vtkTestTimedSource : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkTestTimedSource *New();
+  vtkTypeRevisionMacro(vtkTestTimedSource,vtkPolyDataAlgorithm);
+
+protected:
+  vtkTestTimedSource() { this->SetNumberOfInputPorts(0); }
+  int RequestData(vtkInformation *, vtkInformationVector **,
+                  vtkInformationVector *)
+    {
+    return 1;
+    }
+};
+
+vtkCxxRevisionMacro(vtkTestTimedSource, "$Revision$");
+vtkStandardNewMacro(vtkTestTimedSource);
+
+int TestPipelineTimerLogEvents(int, char*[])
+{
+  int rval = 0;
+  vtkSmartPointer<vtkTestTimedSource> source =
+    vtkSmartPointer<vtkTestTimedSource>::New();
+
+  if (vtkDemandDrivenPipeline::GetGlobalTimerLogEvents())
+    {
+    cerr << "Timer log events are on by default" << endl;
+    rval = 1;
+    }
+  vtkTimerLog::ResetLog();
+  source->Update();
+  if (vtkTimerLog::GetNumberOfEvents() != 0)
+    {
+    cerr << "Events logged with timer log events off" << endl;
+    rval = 1;
+    }
+
+  vtkDemandDrivenPipeline::GlobalTimerLogEventsOn();
+  source->Modified();
+  source->Update();
+  vtkDemandDrivenPipeline::GlobalTimerLogEventsOff();
+  if (vtkTimerLog::GetNumberOfEvents() != 2 ||
+      vtkTimerLog::GetEventType(0) != vtkTimerLog::START ||
+      vtkTimerLog::GetEventType(1) != vtkTimerLog::END ||
+      strcmp(vtkTimerLog::GetEventString(0), "vtkTestTimedSource") != 0)
+    {
+    cerr << "Execution not bracketed by timer log events" << endl;
+    rval = 1;
+    }
+
+  vtkTimerLog::ResetLog();
+  return rval;
+}
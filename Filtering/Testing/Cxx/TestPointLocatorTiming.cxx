@@ -0,0 +1,178 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Time vtkPointLocator on random points in the unit cube: BuildLocator(),
+// FindClosestPoint(), FindPointsWithinRadius() and, through vtkMergePoints,
+// InsertUniquePoint().  The answers of a few queries are checked against a
+// brute force search.  Pass "-n <points>" to change the number of points,
+// 100000 by default; the radius queries are a fifth of that.
+
+#include "vtkIdList.h"
+#include "vtkMath.h"
+#include "vtkMergePoints.h"
+#include "vtkPointLocator.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static vtkIdType BruteForceClosestPoint(vtkPoints *points, const double x[3])
+{
+  vtkIdType closest = -1;
+  double minDist2 = VTK_DOUBLE_MAX;
+  for (vtkIdType i=0; i < points->GetNumberOfPoints(); i++)
+    {
+    double dist2 = vtkMath::Distance2BetweenPoints(x, points->GetPoint(i));
+    if (dist2 < minDist2)
+      {
+      minDist2 = dist2;
+      closest = i;
+      }
+    }
+  return closest;
+}
+
+int TestPointLocatorTiming(int argc, char *argv[])
+{
+  vtkIdType numPoints = 100000;
+  for (int i=1; i < argc-1; i++)
+    {
+    if (!strcmp(argv[i], "-n"))
+      {
+      numPoints = atoi(argv[i+1]);
+      }
+    }
+
+  vtkMath::RandomSeed(8775070);
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(numPoints);
+  vtkIdType i;
+  for (i=0; i < numPoints; i++)
+    {
+    points->SetPoint(i, vtkMath::Random(), vtkMath::Random(),
+                     vtkMath::Random());
+    }
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->SetPoints(points);
+
+  vtkIdType numQueries = numPoints;
+  double (*queries)[3] = new double[numQueries][3];
+  for (i=0; i < numQueries; i++)
+    {
+    for (int j=0; j < 3; j++)
+      {
+      queries[i][j] = vtkMath::Random();
+      }
+    }
+
+  vtkSmartPointer<vtkTimerLog> timer = vtkSmartPointer<vtkTimerLog>::New();
+  vtkSmartPointer<vtkPointLocator> locator =
+    vtkSmartPointer<vtkPointLocator>::New();
+  locator->SetDataSet(polyData);
+  timer->StartTimer();
+  locator->BuildLocator();
+  timer->StopTimer();
+  cerr << numPoints << " points" << endl;
+  cerr << "BuildLocator: " << timer->GetElapsedTime() << " s" << endl;
+
+  int rval = 0;
+  timer->StartTimer();
+  for (i=0; i < numQueries; i++)
+    {
+    locator->FindClosestPoint(queries[i]);
+    }
+  timer->StopTimer();
+  cerr << numQueries << " FindClosestPoint: " << timer->GetElapsedTime()
+       << " s" << endl;
+  for (i=0; i < 10; i++)
+    {
+    vtkIdType found = locator->FindClosestPoint(queries[i]);
+    vtkIdType expected = BruteForceClosestPoint(points, queries[i]);
+    if (vtkMath::Distance2BetweenPoints(queries[i], points->GetPoint(found)) !=
+        vtkMath::Distance2BetweenPoints(queries[i], points->GetPoint(expected)))
+      {
+      cerr << "FindClosestPoint returned " << found << " instead of "
+           << expected << endl;
+      rval = 1;
+      }
+    }
+
+  vtkSmartPointer<vtkIdList> result = vtkSmartPointer<vtkIdList>::New();
+  // About ten points per query.
+  double radius = 1.3/pow(static_cast<double>(numPoints), 1.0/3.0);
+  vtkIdType numRadiusQueries = numQueries/5, numFound = 0;
+  timer->StartTimer();
+  for (i=0; i < numRadiusQueries; i++)
+    {
+    locator->FindPointsWithinRadius(radius, queries[i], result);
+    numFound += result->GetNumberOfIds();
+    }
+  timer->StopTimer();
+  cerr << numRadiusQueries << " FindPointsWithinRadius: "
+       << timer->GetElapsedTime() << " s, " << numFound << " points found"
+       << endl;
+  for (i=0; i < 10; i++)
+    {
+    locator->FindPointsWithinRadius(radius, queries[i], result);
+    vtkIdType expected = 0;
+    for (vtkIdType ptId=0; ptId < numPoints; ptId++)
+      {
+      if (vtkMath::Distance2BetweenPoints(queries[i],
+                                          points->GetPoint(ptId)) <=
+          radius*radius)
+        {
+        expected++;
+        }
+      }
+    if (result->GetNumberOfIds() != expected)
+      {
+      cerr << "FindPointsWithinRadius found " << result->GetNumberOfIds()
+           << " points instead of " << expected << endl;
+      rval = 1;
+      }
+    }
+
+  // Insert every point twice, the second time they must all merge.
+  double bounds[6] = { 0.0, 1.0, 0.0, 1.0, 0.0, 1.0 };
+  vtkSmartPointer<vtkPoints> merged = vtkSmartPointer<vtkPoints>::New();
+  merged->SetDataTypeToDouble();
+  vtkSmartPointer<vtkMergePoints> mergePoints =
+    vtkSmartPointer<vtkMergePoints>::New();
+  timer->StartTimer();
+  mergePoints->InitPointInsertion(merged, bounds, numPoints);
+  vtkIdType ptId;
+  for (int pass=0; pass < 2; pass++)
+    {
+    for (i=0; i < numPoints; i++)
+      {
+      mergePoints->InsertUniquePoint(points->GetPoint(i), ptId);
+      }
+    }
+  timer->StopTimer();
+  cerr << 2*numPoints << " InsertUniquePoint: " << timer->GetElapsedTime()
+       << " s" << endl;
+  if (merged->GetNumberOfPoints() != numPoints)
+    {
+    cerr << "InsertUniquePoint kept " << merged->GetNumberOfPoints()
+         << " points instead of " << numPoints << endl;
+    rval = 1;
+    }
+
+  delete [] queries;
+  return rval;
+}
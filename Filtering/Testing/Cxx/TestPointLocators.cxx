@@ -12,14 +12,21 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
+#include "vtkBSPCuts.h"
 #include "vtkIdList.h"
 #include "vtkKdTree.h"
 #include "vtkKdTreePointLocator.h"
 #include "vtkMath.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMergePoints.h"
+#include "vtkMultiThreader.h"
 #include "vtkOctreePointLocator.h"
 #include "vtkPointLocator.h"
 #include "vtkPoints.h"
 #include "vtkStructuredGrid.h"
+#include "vtkTestUtilities.h"
+
+#include <vtksys/SystemTools.hxx>
 
 // returns true if 2 points are equidistant from x, within a tolerance
 bool ArePointsEquidistant(double x[3], vtkIdType id1, vtkIdType id2,
@@ -219,10 +226,49 @@ int ComparePointLocators(vtkAbstractPointLocator* locator1, vtkAbstractPointLoca
   return rval; // returns 0 if all tests passes
 }
 
+// Check that two k-d trees have the same regions holding the same points.
+int CompareKdTrees(vtkKdTree* kd1, vtkKdTree* kd2, const char* label)
+{
+  if(kd1->GetNumberOfRegions() != kd2->GetNumberOfRegions())
+    {
+    cerr << "The " << label << " k-d tree has "
+         << kd2->GetNumberOfRegions() << " regions instead of "
+         << kd1->GetNumberOfRegions() << endl;
+    return 1;
+    }
+  int rval = 0;
+  for(int i=0;i<kd1->GetNumberOfRegions();i++)
+    {
+    double b1[6], b2[6];
+    kd1->GetRegionBounds(i, b1);
+    kd2->GetRegionBounds(i, b2);
+    vtkIdTypeArray* ids1 = kd1->GetPointsInRegion(i);
+    vtkIdTypeArray* ids2 = kd2->GetPointsInRegion(i);
+    int same = (ids1->GetNumberOfTuples() == ids2->GetNumberOfTuples());
+    for(vtkIdType j=0;same && j<ids1->GetNumberOfTuples();j++)
+      {
+      same = (ids1->GetValue(j) == ids2->GetValue(j));
+      }
+    for(int j=0;same && j<6;j++)
+      {
+      same = (b1[j] == b2[j]);
+      }
+    if(!same)
+      {
+      cerr << "Region " << i << " of the " << label
+           << " k-d tree is different" << endl;
+      rval++;
+      }
+    ids1->Delete();
+    ids2->Delete();
+    }
+  return rval;
+}
+
 // This test does a brute force test on the KdTree point locator
 // to make sure that at least one of the point locators used
 // above gives a correct result for FindClosestPoint().
-int TestKdTreePointLocator()
+int TestKdTreePointLocator(const char* fileName)
 {
   int rval = 0;
   vtkIdType num_points = 1000;
@@ -247,8 +293,39 @@ int TestKdTreePointLocator()
     A->SetPoint( point, pointA );
     }
  
+  // The threaded build must give the same regions as the serial build,
+  // and reading a saved tree must give them back as well.
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
   vtkKdTree * kd = vtkKdTree::New();
+  kd->SetMinCells( 8 );
   kd->BuildLocatorFromPoints( A );
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(1);
+  vtkKdTree * serialKd = vtkKdTree::New();
+  serialKd->SetMinCells( 8 );
+  serialKd->BuildLocatorFromPoints( A );
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(0);
+
+  vtkKdTree * readKd = vtkKdTree::New();
+  if ( !kd->WriteSearchStructure( fileName ) ||
+       !readKd->ReadSearchStructure( fileName, A ) )
+    {
+    cerr << "Could not save and restore the k-d tree" << endl;
+    rval++;
+    }
+  rval += CompareKdTrees( kd, serialKd, "serial" );
+  rval += CompareKdTrees( kd, readKd, "restored" );
+  serialKd->Delete();
+
+  // Without the points, the saved tree is used as user defined cuts.
+  vtkKdTree * cutsKd = vtkKdTree::New();
+  if ( !cutsKd->ReadSearchStructure( fileName ) ||
+       !cutsKd->GetCuts() || !cutsKd->GetCuts()->Equals( kd->GetCuts() ) )
+    {
+    cerr << "Could not read the k-d tree as cuts" << endl;
+    rval++;
+    }
+  cutsKd->Delete();
+  vtksys::SystemTools::RemoveFile( fileName );
 
   for ( test_point = 0; test_point < num_test_points; ++test_point )
     {
@@ -273,6 +350,11 @@ int TestKdTreePointLocator()
       }
     double ld2;
     idA = kd->FindClosestPoint( pointB, ld2 );
+    if ( readKd->FindClosestPoint( pointB, ld2 ) != idA )
+      {
+      cerr << "The restored k-d tree found another closest point" << endl;
+      rval++;
+      }
     float diff = static_cast<float>(ld2) - static_cast<float>(min_dist2);
     if(ld2 == 0)
       {
@@ -288,12 +370,66 @@ int TestKdTreePointLocator()
     }
 
   kd->Delete();
+  readKd->Delete();
   A->Delete();
   
   return rval;
 }
 
-int TestPointLocators(int , char *[])
+// Insert every point of a lattice twice with vtkMergePoints and check that
+// the duplicates are merged and that the inserted points can be found.
+int TestMergePoints(int dataType)
+{
+  int rval = 0;
+  const int dim = 12;
+  double bounds[6] = {0, dim-1, 0, dim-1, 0, dim-1};
+  vtkPoints* points = vtkPoints::New(dataType);
+  vtkMergePoints* merge = vtkMergePoints::New();
+  merge->SetDivisions(4, 4, 4);
+  merge->InitPointInsertion(points, bounds, 10);
+
+  double x[3];
+  vtkIdType id, expected = 0;
+  for(int pass=0;pass<2;pass++)
+    {
+    expected = 0;
+    for(int i=0;i<dim*dim*dim;i++)
+      {
+      x[0] = i % dim;
+      x[1] = (i / dim) % dim;
+      x[2] = i / (dim*dim);
+      int inserted = merge->InsertUniquePoint(x, id);
+      if(inserted != (pass == 0) || id != expected)
+        {
+        cerr << "InsertUniquePoint returned " << inserted << " and id "
+             << id << " for point " << expected << " in pass " << pass
+             << endl;
+        rval++;
+        }
+      expected++;
+      }
+    }
+  if(points->GetNumberOfPoints() != dim*dim*dim)
+    {
+    cerr << "Merged " << points->GetNumberOfPoints() << " points, expected "
+         << dim*dim*dim << endl;
+    rval++;
+    }
+
+  x[0] = 3.2; x[1] = 7.9; x[2] = 0.4;
+  id = merge->FindClosestInsertedPoint(x);
+  if(id != 3 + 8*dim)
+    {
+    cerr << "FindClosestInsertedPoint returned " << id << endl;
+    rval++;
+    }
+
+  merge->Delete();
+  points->Delete();
+  return rval;
+}
+
+int TestPointLocators(int argc, char *argv[])
 {
   vtkKdTreePointLocator* kdTreeLocator = vtkKdTreePointLocator::New();
   vtkPointLocator* uniformLocator = vtkPointLocator::New();
@@ -310,7 +446,14 @@ int TestPointLocators(int , char *[])
   uniformLocator->Delete();
   octreeLocator->Delete();
 
-  rval += TestKdTreePointLocator();
+  char* fileName = vtkTestUtilities::ExpandFileNameWithArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", ".", "TestPointLocators.kdtree");
+  rval += TestKdTreePointLocator(fileName);
+  delete [] fileName;
+
+  cout << "Testing vtkMergePoints.\n";
+  rval += TestMergePoints(VTK_FLOAT);
+  rval += TestMergePoints(VTK_DOUBLE);
 
   return rval;
 }
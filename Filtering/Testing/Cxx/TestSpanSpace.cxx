@@ -0,0 +1,267 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Traverse a tetrahedral grid and a triangle mesh with vtkSpanSpace and
+// vtkSimpleScalarTree at many values and check that they find the cells
+// whose scalar range contains the value, and that the span space is only
+// built again when its scalars change.
+
+#include "vtkCell.h"
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSimpleScalarTree.h"
+#include "vtkSmartPointer.h"
+#include "vtkSpanSpace.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vtkstd/vector>
+
+#define GRID_SIZE 10
+
+// exposes the build time of the span space
+class vtkTestSpanSpace : public vtkSpanSpace
+{
+public:
+  static vtkTestSpanSpace *New() { return new vtkTestSpanSpace; }
+  unsigned long GetBuildTime() { return this->BuildTime.GetMTime(); }
+};
+
+// a lattice of tetrahedra with the distance to a point off its center as
+// scalars
+static vtkUnstructuredGrid* MakeTetraGrid()
+{
+  vtkUnstructuredGrid* grid =
+    vtkTestDataSetUtilities::MakeTetraGrid(GRID_SIZE, 0.0);
+  vtkDoubleArray* scalars = vtkDoubleArray::New();
+  scalars->SetName("Distance");
+  for(vtkIdType i=0;i<grid->GetNumberOfPoints();i++)
+    {
+    double x[3];
+    grid->GetPoint(i, x);
+    scalars->InsertNextValue(sqrt((x[0]-4.3)*(x[0]-4.3) +
+                                  (x[1]-5.4)*(x[1]-5.4) +
+                                  (x[2]-4.7)*(x[2]-4.7)));
+    }
+  grid->GetPointData()->SetScalars(scalars);
+  scalars->Delete();
+  return grid;
+}
+
+// a square of triangles with a wave as float scalars
+static vtkPolyData* MakeTriangleMesh()
+{
+  const int n = 4*GRID_SIZE;
+  vtkPolyData* mesh = vtkPolyData::New();
+  vtkPoints* points = vtkPoints::New();
+  vtkFloatArray* scalars = vtkFloatArray::New();
+  scalars->SetName("Wave");
+  for(int j=0;j<=n;j++)
+    {
+    for(int i=0;i<=n;i++)
+      {
+      points->InsertNextPoint(i, j, 0.0);
+      scalars->InsertNextValue(sin(0.3*i) + cos(0.2*j));
+      }
+    }
+  vtkCellArray* polys = vtkCellArray::New();
+  for(int j=0;j<n;j++)
+    {
+    for(int i=0;i<n;i++)
+      {
+      vtkIdType p = i + (n+1)*j;
+      vtkIdType tri1[3] = { p, p+1, p+n+2 };
+      vtkIdType tri2[3] = { p, p+n+2, p+n+1 };
+      polys->InsertNextCell(3, tri1);
+      polys->InsertNextCell(3, tri2);
+      }
+    }
+  mesh->SetPoints(points);
+  mesh->SetPolys(polys);
+  mesh->GetPointData()->SetScalars(scalars);
+  points->Delete();
+  polys->Delete();
+  scalars->Delete();
+  return mesh;
+}
+
+// the cells found by a traversal, checking the scalars returned with them
+static int Traverse(vtkScalarTree* tree, vtkDataArray* scalars, double value,
+                    vtkstd::vector<vtkIdType>& cells)
+{
+  vtkSmartPointer<vtkDoubleArray> cellScalars =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  cells.clear();
+  vtkIdType cellId;
+  vtkIdList* cellPts;
+  vtkCell* cell;
+  for(tree->InitTraversal(value);
+      (cell=tree->GetNextCell(cellId, cellPts, cellScalars)) != NULL; )
+    {
+    for(vtkIdType i=0;i<cellPts->GetNumberOfIds();i++)
+      {
+      if(cellScalars->GetValue(i) != scalars->GetTuple1(cellPts->GetId(i)))
+        {
+        cerr << "Wrong scalars for cell " << cellId << endl;
+        return 1;
+        }
+      }
+    cells.push_back(cellId);
+    }
+  return 0;
+}
+
+// the cells whose scalar range contains the value
+static void FindCells(vtkDataSet* ds, vtkDataArray* scalars, double value,
+                      vtkstd::vector<vtkIdType>& cells)
+{
+  vtkSmartPointer<vtkIdList> cellPts = vtkSmartPointer<vtkIdList>::New();
+  cells.clear();
+  for(vtkIdType cellId=0;cellId<ds->GetNumberOfCells();cellId++)
+    {
+    ds->GetCellPoints(cellId, cellPts);
+    double min = VTK_DOUBLE_MAX, max = -VTK_DOUBLE_MAX;
+    for(vtkIdType i=0;i<cellPts->GetNumberOfIds();i++)
+      {
+      double s = scalars->GetTuple1(cellPts->GetId(i));
+      min = (s < min ? s : min);
+      max = (s > max ? s : max);
+      }
+    if(min <= value && value <= max)
+      {
+      cells.push_back(cellId);
+      }
+    }
+}
+
+static int TestDataSet(vtkDataSet* ds, const char* label)
+{
+  vtkDataArray* scalars = ds->GetPointData()->GetScalars();
+  vtkSmartPointer<vtkTestSpanSpace> spanSpace =
+    vtkSmartPointer<vtkTestSpanSpace>::New();
+  spanSpace->SetDataSet(ds);
+  spanSpace->SetResolution(16);
+  vtkSmartPointer<vtkSimpleScalarTree> simpleTree =
+    vtkSmartPointer<vtkSimpleScalarTree>::New();
+  simpleTree->SetDataSet(ds);
+
+  // values below, across and above the range of the scalars, including the
+  // scalar values of a few points
+  double range[2];
+  scalars->GetRange(range);
+  vtkstd::vector<double> values;
+  for(int i=-2;i<=52;i++)
+    {
+    values.push_back(range[0] + i*(range[1] - range[0])/50);
+    }
+  for(vtkIdType i=0;i<ds->GetNumberOfPoints();i+=97)
+    {
+    values.push_back(scalars->GetTuple1(i));
+    }
+
+  int rval = 0;
+  unsigned long buildTime = 0;
+  vtkIdType numActive = 0;
+  vtkstd::vector<vtkIdType> expected, found, simple;
+  for(size_t v=0;v<values.size();v++)
+    {
+    FindCells(ds, scalars, values[v], expected);
+    rval += Traverse(spanSpace, scalars, values[v], found);
+    rval += Traverse(simpleTree, scalars, values[v], simple);
+    if(found != expected || simple != expected)
+      {
+      cerr << label << ": " << found.size() << " cells found in span space and "
+           << simple.size() << " in the simple tree at " << values[v]
+           << " instead of " << expected.size() << endl;
+      rval++;
+      }
+    if(spanSpace->GetNumberOfActiveCells() !=
+       static_cast<vtkIdType>(expected.size()))
+      {
+      cerr << label << ": wrong number of active cells" << endl;
+      rval++;
+      }
+    numActive += static_cast<vtkIdType>(expected.size());
+    if(v == 0)
+      {
+      buildTime = spanSpace->GetBuildTime();
+      }
+    else if(spanSpace->GetBuildTime() != buildTime)
+      {
+      cerr << label << ": span space built again for a new value" << endl;
+      rval++;
+      }
+    }
+  cout << label << ": " << numActive << " cells found at "
+       << values.size() << " values." << endl;
+  if(numActive == 0)
+    {
+    cerr << label << ": no cells found" << endl;
+    rval++;
+    }
+
+  // modifying the scalars builds the span space again
+  double value = 0.5*(range[0] + range[1]);
+  for(vtkIdType i=0;i<ds->GetNumberOfPoints();i+=3)
+    {
+    scalars->SetTuple1(i, range[1]);
+    }
+  scalars->Modified();
+  FindCells(ds, scalars, value, expected);
+  rval += Traverse(spanSpace, scalars, value, found);
+  if(spanSpace->GetBuildTime() == buildTime || found != expected)
+    {
+    cerr << label << ": span space not built again for new scalars" << endl;
+    rval++;
+    }
+
+  // and so does organizing other scalars
+  vtkSmartPointer<vtkDoubleArray> other = vtkSmartPointer<vtkDoubleArray>::New();
+  other->SetNumberOfTuples(ds->GetNumberOfPoints());
+  for(vtkIdType i=0;i<ds->GetNumberOfPoints();i++)
+    {
+    double x[3];
+    ds->GetPoint(i, x);
+    other->SetValue(i, x[0] - x[1]);
+    }
+  spanSpace->SetScalars(other);
+  simpleTree->SetScalars(other);
+  FindCells(ds, other, 0.5, expected);
+  rval += Traverse(spanSpace, other, 0.5, found);
+  rval += Traverse(simpleTree, other, 0.5, simple);
+  if(found != expected || simple != expected)
+    {
+    cerr << label << ": scalars set on the trees not used" << endl;
+    rval++;
+    }
+  return rval;
+}
+
+int TestSpanSpace(int, char*[])
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid;
+  grid.TakeReference(MakeTetraGrid());
+  vtkSmartPointer<vtkPolyData> mesh;
+  mesh.TakeReference(MakeTriangleMesh());
+
+  int rval = 0;
+  rval += TestDataSet(grid, "Tetrahedra");
+  rval += TestDataSet(mesh, "Triangles");
+  return rval;
+}
@@ -0,0 +1,149 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Run a threaded image filter with the default split of the extent and
+// with work stealing, also with a global maximum number of threads below
+// the number the filter asks for, and check that every voxel is computed
+// exactly once and that the outputs are the same.
+
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkThreadedImageAlgorithm.h"
+
+#include <vtkstd/vector>
+
+// doubles its input and counts the times each voxel is computed
+class vtkTestDoubleImage : public vtkThreadedImageAlgorithm
+{
+public:
+  static vtkTestDoubleImage *New();
+  vtkTypeRevisionMacro(vtkTestDoubleImage,vtkThreadedImageAlgorithm);
+
+  vtkstd::vector<int> Visits;
+
+  void ThreadedRequestData(vtkInformation *, vtkInformationVector **,
+                           vtkInformationVector *, vtkImageData ***inData,
+                           vtkImageData **outData, int extent[6], int)
+    {
+    int *wholeExt = outData[0]->GetExtent();
+    for (int k=extent[4]; k <= extent[5]; k++)
+      {
+      for (int j=extent[2]; j <= extent[3]; j++)
+        {
+        for (int i=extent[0]; i <= extent[1]; i++)
+          {
+          float *in = static_cast<float *>(
+            inData[0][0]->GetScalarPointer(i, j, k));
+          float *out = static_cast<float *>(
+            outData[0]->GetScalarPointer(i, j, k));
+          *out = 2.0f * *in;
+          this->Visits[(i - wholeExt[0]) + (wholeExt[1] - wholeExt[0] + 1)*
+                       ((j - wholeExt[2]) + (wholeExt[3] - wholeExt[2] + 1)*
+                        (k - wholeExt[4]))]++;
+          }
+        }
+      }
+    }
+
+protected:
+  vtkTestDoubleImage() {}
+};
+
+vtkCxxRevisionMacro(vtkTestDoubleImage, "$Revision$");
+vtkStandardNewMacro(vtkTestDoubleImage);
+
+static int RunFilter(vtkImageData *image, int workStealing, int numThreads,
+                     int maxThreads, vtkImageData *output)
+{
+  vtkMultiThreader::SetGlobalMaximumNumberOfThreads(maxThreads);
+  vtkSmartPointer<vtkTestDoubleImage> filter =
+    vtkSmartPointer<vtkTestDoubleImage>::New();
+  filter->SetInput(image);
+  filter->SetNumberOfThreads(numThreads);
+  filter->SetUseWorkStealing(workStealing);
+  filter->SetMinimumPieceSize(1000);
+  filter->Visits.assign(image->GetNumberOfPoints(), 0);
+  filter->Update();
+  vtkMultiThreader::SetGlobalMaximumNumberOfThreads(0);
+  output->DeepCopy(filter->GetOutput());
+
+  for (size_t i=0; i < filter->Visits.size(); i++)
+    {
+    if (filter->Visits[i] != 1)
+      {
+      cerr << "Voxel " << i << " computed " << filter->Visits[i]
+           << " times with work stealing " << workStealing << ", "
+           << numThreads << " threads and a maximum of " << maxThreads
+           << endl;
+      return 1;
+      }
+    }
+  return 0;
+}
+
+static int CompareImages(vtkImageData *image1, vtkImageData *image2)
+{
+  vtkDataArray *s1 = image1->GetPointData()->GetScalars();
+  vtkDataArray *s2 = image2->GetPointData()->GetScalars();
+  if (!s1 || !s2 || s1->GetNumberOfTuples() != s2->GetNumberOfTuples())
+    {
+    cerr << "Outputs differ in size" << endl;
+    return 1;
+    }
+  for (vtkIdType i=0; i < s1->GetNumberOfTuples(); i++)
+    {
+    if (s1->GetTuple1(i) != s2->GetTuple1(i))
+      {
+      cerr << "Outputs differ at " << i << endl;
+      return 1;
+      }
+    }
+  return 0;
+}
+
+int TestThreadedImageAlgorithm(int, char*[])
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(0, 63, 0, 47, 0, 29);
+  image->SetScalarTypeToFloat();
+  image->SetNumberOfScalarComponents(1);
+  image->AllocateScalars();
+  vtkFloatArray *scalars =
+    vtkFloatArray::SafeDownCast(image->GetPointData()->GetScalars());
+  for (vtkIdType i=0; i < scalars->GetNumberOfTuples(); i++)
+    {
+    scalars->SetValue(i, static_cast<float>(i % 1013) - 500.0f);
+    }
+
+  int rval = 0;
+  vtkSmartPointer<vtkImageData> expected = vtkSmartPointer<vtkImageData>::New();
+  rval += RunFilter(image, 0, 4, 0, expected);
+
+  // work stealing, with as many threads as asked for and with fewer
+  int maxThreads[2] = { 0, 2 };
+  for (int i=0; i < 2; i++)
+    {
+    vtkSmartPointer<vtkImageData> output = vtkSmartPointer<vtkImageData>::New();
+    rval += RunFilter(image, 1, 4, maxThreads[i], output);
+    rval += CompareImages(expected, output);
+    rval += RunFilter(image, 0, 4, maxThreads[i], output);
+    rval += CompareImages(expected, output);
+    }
+
+  return rval;
+}
@@ -22,7 +22,10 @@
 #include "vtkCellArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
+#include "vtkIntArray.h"
+#include "vtkPoints.h"
 #include "vtkQuad.h"
+#include "vtkUnstructuredGrid.h"
 
 #include <vtksys/ios/sstream>
 
@@ -81,8 +84,219 @@ int TestCellArray(ostream& strm)
   return 0;
 }
 
+// Compare the cells of ca against the interleaved list expected.
+static int CheckCells(vtkCellArray *ca, vtkIdType ncells,
+                      const vtkIdType *expected, const char *label)
+{
+  vtkIdList *ids = vtkIdList::New();
+  int retVal = 0;
+  vtkIdType loc = 0;
+  for (vtkIdType cellId = 0; cellId < ncells; cellId++)
+    {
+    ca->GetCellAtId(cellId, ids);
+    vtkIdType npts = expected[loc++];
+    if (ids->GetNumberOfIds() != npts ||
+        ca->GetCellSize(cellId) != npts)
+      {
+      cerr << label << ": cell " << cellId << " has "
+           << ids->GetNumberOfIds() << " points, expected " << npts << endl;
+      retVal = 1;
+      break;
+      }
+    for (vtkIdType i = 0; i < npts; i++, loc++)
+      {
+      if (ids->GetId(i) != expected[loc])
+        {
+        cerr << label << ": cell " << cellId << " point " << i << " is "
+             << ids->GetId(i) << ", expected " << expected[loc] << endl;
+        retVal = 1;
+        }
+      }
+    }
+  ids->Delete();
+  return retVal;
+}
+
+int TestCellArrayOffsets(ostream& strm)
+{
+  strm << "Test CellArray offsets storage Start" << endl;
+  int retVal = 0;
+
+  vtkIdType cells[13] = {3, 0, 1, 2, 4, 2, 3, 4, 5, 3, 5, 6, 7};
+  vtkCellArray *ca = vtkCellArray::New();
+  ca->InsertNextCell(3, cells + 1);
+  ca->InsertNextCell(4, cells + 5);
+  ca->InsertNextCell(3, cells + 10);
+
+  ca->ConvertToOffsetsStorage();
+  if (!ca->GetUsesOffsetsStorage() ||
+      ca->GetOffsetsArray()->GetNumberOfTuples() != 4 ||
+      ca->GetConnectivityArray()->GetNumberOfTuples() != 10)
+    {
+    cerr << "ConvertToOffsetsStorage did not create the arrays" << endl;
+    retVal = 1;
+    }
+  if (ca->GetNumberOfCells() != 3 ||
+      ca->GetNumberOfConnectivityEntries() != 13 ||
+      ca->GetMaxCellSize() != 4)
+    {
+    cerr << "Wrong sizes in offsets storage" << endl;
+    retVal = 1;
+    }
+  retVal |= CheckCells(ca, 3, cells, "offsets storage");
+
+  // Legacy access converts back.
+  vtkIdType *ptr = ca->GetPointer();
+  if (ca->GetUsesOffsetsStorage() || memcmp(ptr, cells, sizeof(cells)) != 0)
+    {
+    cerr << "Conversion back to the interleaved layout failed" << endl;
+    retVal = 1;
+    }
+  retVal |= CheckCells(ca, 3, cells, "interleaved layout");
+
+  // Adopt buffers owned by someone else.
+  int offsets[4] = {0, 3, 7, 10};
+  int connectivity[10] = {0, 1, 2, 2, 3, 4, 5, 5, 6, 7};
+  vtkIntArray *o = vtkIntArray::New();
+  o->SetArray(offsets, 4, 1);
+  vtkIntArray *c = vtkIntArray::New();
+  c->SetArray(connectivity, 10, 1);
+  if (!ca->SetData(o, c))
+    {
+    cerr << "SetData rejected valid arrays" << endl;
+    retVal = 1;
+    }
+  retVal |= CheckCells(ca, 3, cells, "adopted arrays");
+
+  // Offsets that do not cover the connectivity in order are rejected.
+  int badOffsets[3][4] = {{1, 3, 7, 10}, {0, 7, 3, 10}, {0, 3, 7, 9}};
+  vtkIntArray *bad = vtkIntArray::New();
+  vtkObject::GlobalWarningDisplayOff();
+  for (int i = 0; i < 3; i++)
+    {
+    bad->SetArray(badOffsets[i], 4, 1);
+    if (ca->SetData(bad, c) || ca->GetOffsetsArray() != o)
+      {
+      cerr << "SetData accepted bad offsets " << i << endl;
+      retVal = 1;
+      }
+    }
+  vtkObject::GlobalWarningDisplayOn();
+  bad->Delete();
+  vtkIdType npts, *pts, n = 0, loc = 0;
+  for (ca->InitTraversal(); ca->GetNextCell(npts, pts); n++)
+    {
+    if (npts != cells[loc] || memcmp(pts, cells+loc+1, npts*sizeof(vtkIdType)))
+      {
+      cerr << "Traversal of adopted arrays failed at cell " << n << endl;
+      retVal = 1;
+      }
+    loc += npts + 1;
+    }
+  ca->SetTraversalLocation(4);
+  if (!ca->GetNextCell(npts, pts) || npts != 4 || pts[0] != 2 ||
+      ca->GetTraversalLocation(npts) != 4 || !ca->GetUsesOffsetsStorage())
+    {
+    cerr << "Traversal of offsets storage converted or lost its place"
+         << endl;
+    retVal = 1;
+    }
+
+  // Locations into a 64-bit connectivity are read in place.
+  vtkIdTypeArray *idOffsets = vtkIdTypeArray::New();
+  vtkIdTypeArray *idConnectivity = vtkIdTypeArray::New();
+  for (int i = 0; i < 4; i++)
+    {
+    idOffsets->InsertNextValue(offsets[i]);
+    }
+  for (int i = 0; i < 10; i++)
+    {
+    idConnectivity->InsertNextValue(connectivity[i]);
+    }
+  vtkCellArray *idCa = vtkCellArray::New();
+  idCa->SetData(idOffsets, idConnectivity);
+  idCa->GetCell(9, npts, pts);
+  if (npts != 3 || pts[2] != 7 || !idCa->GetUsesOffsetsStorage())
+    {
+    cerr << "GetCell on offsets storage failed" << endl;
+    retVal = 1;
+    }
+  idCa->Delete();
+  idOffsets->Delete();
+  idConnectivity->Delete();
+
+  ca->InsertNextCell(3, cells + 1);
+  if (ca->GetNumberOfCells() != 4 || n != 3)
+    {
+    cerr << "Insertion after SetData failed" << endl;
+    retVal = 1;
+    }
+
+  // Unstructured grid using offsets storage, it must not convert.
+  ca->SetData(o, c);
+  vtkPoints *points = vtkPoints::New();
+  for (int i = 0; i < 8; i++)
+    {
+    points->InsertNextPoint(i, i % 2, i % 3);
+    }
+  int types[3] = {VTK_TRIANGLE, VTK_QUAD, VTK_TRIANGLE};
+  vtkUnstructuredGrid *ug = vtkUnstructuredGrid::New();
+  ug->SetPoints(points);
+  ug->SetCells(types, ca);
+  vtkIdList *ids = vtkIdList::New();
+  ug->GetCellPoints(1, ids);
+  double bounds[6];
+  ug->GetCellBounds(1, bounds);
+  if (ids->GetNumberOfIds() != 4 || ids->GetId(3) != 5 ||
+      bounds[0] != 2 || bounds[1] != 5 ||
+      ug->GetCell(2)->GetPointId(2) != 7)
+    {
+    cerr << "Unstructured grid access through offsets failed" << endl;
+    retVal = 1;
+    }
+  ug->GetPointCells(5, ids);
+  if (ids->GetNumberOfIds() != 2 || ids->GetId(0) != 1 || ids->GetId(1) != 2)
+    {
+    cerr << "Unstructured grid links through offsets failed" << endl;
+    retVal = 1;
+    }
+  vtkIdTypeArray *locations = ug->GetCellLocationsArray();
+  if (!locations || locations->GetNumberOfTuples() != 3 ||
+      locations->GetValue(1) != 4 || locations->GetValue(2) != 9)
+    {
+    cerr << "Unstructured grid locations from offsets are wrong" << endl;
+    retVal = 1;
+    }
+  if (!ca->GetUsesOffsetsStorage())
+    {
+    cerr << "Unstructured grid converted the offsets storage" << endl;
+    retVal = 1;
+    }
+  vtkIdType newCell[3] = {1, 3, 5};
+  ug->InsertNextCell(VTK_TRIANGLE, 3, newCell);
+  ug->GetCellPoints(3, ids);
+  if (ug->GetNumberOfCells() != 4 || ids->GetId(2) != 5 ||
+      ug->GetCellLocationsArray()->GetValue(3) != 13)
+    {
+    cerr << "Insertion into unstructured grid failed" << endl;
+    retVal = 1;
+    }
+
+  ids->Delete();
+  ug->Delete();
+  points->Delete();
+  o->Delete();
+  c->Delete();
+  ca->Delete();
+  strm << "Test CellArray offsets storage Complete" << endl;
+
+  return retVal;
+}
+
 int otherCellArray(int,char *[])
 {
   vtksys_ios::ostringstream vtkmsg_with_warning_C4701; 
-  return TestCellArray(vtkmsg_with_warning_C4701);
+  int retVal = TestCellArray(vtkmsg_with_warning_C4701);
+  retVal |= TestCellArrayOffsets(vtkmsg_with_warning_C4701);
+  return retVal;
 } 
@@ -0,0 +1,396 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkTestDataSetUtilities - Data sets and comparisons used by tests.
+// .SECTION Description
+// vtkTestDataSetUtilities builds the data sets shared by several regression
+// tests and compares the outputs of a filter run in two ways, typically on
+// one and on several threads.  The comparisons print what differs to cerr
+// and return the number of differences found, so that the tests can add
+// them up.
+
+#ifndef __vtkTestDataSetUtilities_h
+#define __vtkTestDataSetUtilities_h
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkDataArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+struct vtkTestDataSetUtilities
+{
+  // Description:
+  // Build a lattice of n x n x n cubes, each split into six tetrahedra
+  // around its main diagonal.  The points of the lattice are moved by up to
+  // distortion along each axis.  The grid has no point or cell data and has
+  // to be deleted by the caller.
+  static inline vtkUnstructuredGrid* MakeTetraGrid(int n, double distortion);
+
+  // Description:
+  // Build the same lattice as MakeTetraGrid with one hexahedron per cube.
+  static inline vtkUnstructuredGrid* MakeHexahedronGrid(int n,
+                                                        double distortion);
+
+  // Description:
+  // Add the cell ids as the "CellId" cell data array, which the comparisons
+  // use to tell the cells apart.
+  static inline void AddCellIds(vtkDataSet* ds);
+
+  // Description:
+  // Compare two arrays value by value.  Two missing arrays are equal.
+  static inline int CompareArrays(vtkDataArray* a1, vtkDataArray* a2,
+                                  const char* name);
+
+  // Description:
+  // Compare the points, the cells and all the point and cell data arrays of
+  // two polygonal data sets, which must be exactly the same.
+  static inline int ComparePolyData(vtkPolyData* p1, vtkPolyData* p2,
+                                    const char* label);
+
+  // Description:
+  // Compare two data sets whose points may come in different orders.  The
+  // points are matched by the tuples of the point data array keyName, or by
+  // their coordinates when keyName is 0.  Matched points must lie within
+  // maxDistance of each other and, when maxDistance is 0, have the same
+  // point data.  The cells, their types and their "CellId" cell data must
+  // be the same and come in the same order.
+  static inline int ComparePointSets(vtkPointSet* p1, vtkPointSet* p2,
+                                     const char* keyName, double maxDistance,
+                                     const char* label);
+
+  // Description:
+  // Make the points of the lattices, shared by both kinds of cells.
+  static inline vtkUnstructuredGrid* MakeLattice(int n, double distortion);
+
+  // Description:
+  // Orders point ids by the tuples of an array, lexicographically.
+  class TupleLess
+  {
+  public:
+    vtkDataArray* Array;
+    bool operator()(vtkIdType a, vtkIdType b) const
+      {
+      for(int j=0;j<this->Array->GetNumberOfComponents();j++)
+        {
+        double va = this->Array->GetComponent(a, j);
+        double vb = this->Array->GetComponent(b, j);
+        if(va != vb)
+          {
+          return va < vb;
+          }
+        }
+      return false;
+      }
+  };
+};
+
+inline
+vtkUnstructuredGrid* vtkTestDataSetUtilities::MakeLattice(int n,
+                                                          double distortion)
+{
+  vtkUnstructuredGrid* grid = vtkUnstructuredGrid::New();
+  vtkPoints* points = vtkPoints::New();
+  for(int k=0;k<=n;k++)
+    {
+    for(int j=0;j<=n;j++)
+      {
+      for(int i=0;i<=n;i++)
+        {
+        points->InsertNextPoint(i + distortion*sin(0.9*j + 0.4*k),
+                                j + distortion*sin(0.7*k + 0.3*i),
+                                k + distortion*sin(0.5*i + 0.8*j));
+        }
+      }
+    }
+  grid->SetPoints(points);
+  points->Delete();
+  return grid;
+}
+
+inline
+vtkUnstructuredGrid* vtkTestDataSetUtilities::MakeTetraGrid(int n,
+                                                            double distortion)
+{
+  vtkUnstructuredGrid* grid =
+    vtkTestDataSetUtilities::MakeLattice(n, distortion);
+  static const int perms[6][3] =
+    { {0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0} };
+  grid->Allocate(6*n*n*n);
+  for(int k=0;k<n;k++)
+    {
+    for(int j=0;j<n;j++)
+      {
+      for(int i=0;i<n;i++)
+        {
+        for(int t=0;t<6;t++)
+          {
+          int ijk[3] = { i, j, k };
+          vtkIdType tet[4];
+          for(int v=0;v<4;v++)
+            {
+            if(v > 0)
+              {
+              ijk[perms[t][v-1]]++;
+              }
+            tet[v] = ijk[0] + (n+1)*(ijk[1] + (n+1)*ijk[2]);
+            }
+          grid->InsertNextCell(VTK_TETRA, 4, tet);
+          }
+        }
+      }
+    }
+  return grid;
+}
+
+inline
+vtkUnstructuredGrid* vtkTestDataSetUtilities::MakeHexahedronGrid(
+  int n, double distortion)
+{
+  vtkUnstructuredGrid* grid =
+    vtkTestDataSetUtilities::MakeLattice(n, distortion);
+  static const int corners[8][3] =
+    { {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0}, {0,0,1}, {1,0,1}, {1,1,1}, {0,1,1} };
+  grid->Allocate(n*n*n);
+  for(int k=0;k<n;k++)
+    {
+    for(int j=0;j<n;j++)
+      {
+      for(int i=0;i<n;i++)
+        {
+        vtkIdType hex[8];
+        for(int v=0;v<8;v++)
+          {
+          hex[v] = (i + corners[v][0]) +
+            (n+1)*((j + corners[v][1]) + (n+1)*(k + corners[v][2]));
+          }
+        grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+        }
+      }
+    }
+  return grid;
+}
+
+inline
+void vtkTestDataSetUtilities::AddCellIds(vtkDataSet* ds)
+{
+  vtkIdTypeArray* cellIds = vtkIdTypeArray::New();
+  cellIds->SetName("CellId");
+  cellIds->SetNumberOfTuples(ds->GetNumberOfCells());
+  for(vtkIdType cellId=0;cellId<ds->GetNumberOfCells();cellId++)
+    {
+    cellIds->SetValue(cellId, cellId);
+    }
+  ds->GetCellData()->AddArray(cellIds);
+  cellIds->Delete();
+}
+
+inline
+int vtkTestDataSetUtilities::CompareArrays(vtkDataArray* a1, vtkDataArray* a2,
+                                           const char* name)
+{
+  if(!a1 || !a2)
+    {
+    if(a1 != a2)
+      {
+      cerr << name << " missing from one output" << endl;
+      return 1;
+      }
+    return 0;
+    }
+  if(a1->GetNumberOfTuples() != a2->GetNumberOfTuples() ||
+     a1->GetNumberOfComponents() != a2->GetNumberOfComponents())
+    {
+    cerr << name << " differ in size" << endl;
+    return 1;
+    }
+  for(vtkIdType i=0;i<a1->GetNumberOfTuples();i++)
+    {
+    for(int j=0;j<a1->GetNumberOfComponents();j++)
+      {
+      if(a1->GetComponent(i, j) != a2->GetComponent(i, j))
+        {
+        cerr << name << " differ at " << i << endl;
+        return 1;
+        }
+      }
+    }
+  return 0;
+}
+
+inline
+int vtkTestDataSetUtilities::ComparePolyData(vtkPolyData* p1, vtkPolyData* p2,
+                                             const char* label)
+{
+  int rval = 0;
+  rval += vtkTestDataSetUtilities::CompareArrays(
+    p1->GetPoints() ? p1->GetPoints()->GetData() : 0,
+    p2->GetPoints() ? p2->GetPoints()->GetData() : 0, "Points");
+  vtkCellArray* cells1[4] =
+    { p1->GetVerts(), p1->GetLines(), p1->GetPolys(), p1->GetStrips() };
+  vtkCellArray* cells2[4] =
+    { p2->GetVerts(), p2->GetLines(), p2->GetPolys(), p2->GetStrips() };
+  const char* cellNames[4] = { "Vertices", "Lines", "Polygons", "Strips" };
+  for(int type=0;type<4;type++)
+    {
+    rval += vtkTestDataSetUtilities::CompareArrays(
+      cells1[type] ? cells1[type]->GetData() : 0,
+      cells2[type] ? cells2[type]->GetData() : 0, cellNames[type]);
+    }
+  vtkFieldData* data1[2] = { p1->GetPointData(), p1->GetCellData() };
+  vtkFieldData* data2[2] = { p2->GetPointData(), p2->GetCellData() };
+  for(int d=0;d<2;d++)
+    {
+    if(data1[d]->GetNumberOfArrays() != data2[d]->GetNumberOfArrays())
+      {
+      cerr << (d ? "Cell" : "Point") << " data arrays differ" << endl;
+      rval++;
+      continue;
+      }
+    for(int a=0;a<data1[d]->GetNumberOfArrays();a++)
+      {
+      const char* name = data1[d]->GetArrayName(a);
+      rval += vtkTestDataSetUtilities::CompareArrays(
+        data1[d]->GetArray(a), data2[d]->GetArray(name), name);
+      }
+    }
+  if(rval)
+    {
+    cerr << label << ": outputs differ" << endl;
+    }
+  return rval;
+}
+
+inline
+int vtkTestDataSetUtilities::ComparePointSets(vtkPointSet* p1, vtkPointSet* p2,
+                                              const char* keyName,
+                                              double maxDistance,
+                                              const char* label)
+{
+  vtkIdType numPts = p1->GetNumberOfPoints();
+  if(numPts != p2->GetNumberOfPoints() ||
+     p1->GetNumberOfCells() != p2->GetNumberOfCells())
+    {
+    cerr << label << ": " << p2->GetNumberOfPoints() << " points and "
+         << p2->GetNumberOfCells() << " cells instead of " << numPts
+         << " and " << p1->GetNumberOfCells() << endl;
+    return 1;
+    }
+
+  vtkPointData* pd1 = p1->GetPointData();
+  vtkPointData* pd2 = p2->GetPointData();
+  vtkDataArray* key1 =
+    keyName ? pd1->GetArray(keyName) : p1->GetPoints()->GetData();
+  vtkDataArray* key2 =
+    keyName ? pd2->GetArray(keyName) : p2->GetPoints()->GetData();
+  if(!key1 || !key2 ||
+     key1->GetNumberOfComponents() != key2->GetNumberOfComponents() ||
+     pd1->GetNumberOfArrays() != pd2->GetNumberOfArrays())
+    {
+    cerr << label << ": point data arrays differ" << endl;
+    return 1;
+    }
+
+  // match the points by their keys
+  vtkstd::vector<vtkIdType> order1(numPts), order2(numPts), map(numPts);
+  for(vtkIdType i=0;i<numPts;i++)
+    {
+    order1[i] = order2[i] = i;
+    }
+  TupleLess less;
+  less.Array = key1;
+  vtkstd::sort(order1.begin(), order1.end(), less);
+  less.Array = key2;
+  vtkstd::sort(order2.begin(), order2.end(), less);
+  for(vtkIdType i=0;i<numPts;i++)
+    {
+    for(int j=0;j<key1->GetNumberOfComponents();j++)
+      {
+      if(key1->GetComponent(order1[i], j) != key2->GetComponent(order2[i], j))
+        {
+        cerr << label << ": points differ" << endl;
+        return 1;
+        }
+      }
+    double x1[3], x2[3];
+    p1->GetPoint(order1[i], x1);
+    p2->GetPoint(order2[i], x2);
+    if(sqrt(vtkMath::Distance2BetweenPoints(x1, x2)) > maxDistance)
+      {
+      cerr << label << ": points too far apart" << endl;
+      return 1;
+      }
+    for(int a=0;maxDistance == 0.0 && a<pd1->GetNumberOfArrays();a++)
+      {
+      vtkDataArray* a1 = pd1->GetArray(a);
+      vtkDataArray* a2 = pd2->GetArray(pd1->GetArrayName(a));
+      int same = (a1 && a2 &&
+                  a1->GetNumberOfComponents() == a2->GetNumberOfComponents());
+      for(int j=0;same && j<a1->GetNumberOfComponents();j++)
+        {
+        same = (a1->GetComponent(order1[i], j) ==
+                a2->GetComponent(order2[i], j));
+        }
+      if(!same)
+        {
+        cerr << label << ": point data differs in " << pd1->GetArrayName(a)
+             << endl;
+        return 1;
+        }
+      }
+    map[order2[i]] = order1[i];
+    }
+
+  // the cells come in the same order
+  vtkSmartPointer<vtkIdList> ids1 = vtkSmartPointer<vtkIdList>::New();
+  vtkSmartPointer<vtkIdList> ids2 = vtkSmartPointer<vtkIdList>::New();
+  vtkDataArray* c1 = p1->GetCellData()->GetArray("CellId");
+  vtkDataArray* c2 = p2->GetCellData()->GetArray("CellId");
+  if(!c1 || !c2)
+    {
+    cerr << label << ": cell data missing" << endl;
+    return 1;
+    }
+  for(vtkIdType cellId=0;cellId<p1->GetNumberOfCells();cellId++)
+    {
+    p1->GetCellPoints(cellId, ids1);
+    p2->GetCellPoints(cellId, ids2);
+    int same = (p1->GetCellType(cellId) == p2->GetCellType(cellId) &&
+                ids1->GetNumberOfIds() == ids2->GetNumberOfIds() &&
+                c1->GetTuple1(cellId) == c2->GetTuple1(cellId));
+    for(vtkIdType i=0;same && i<ids1->GetNumberOfIds();i++)
+      {
+      same = (ids1->GetId(i) == map[ids2->GetId(i)]);
+      }
+    if(!same)
+      {
+      cerr << label << ": cells differ at cell " << cellId << endl;
+      return 1;
+      }
+    }
+  return 0;
+}
+
+#endif
@@ -21,10 +21,144 @@
 #include "vtkIdList.h"
 #include "vtkPoints.h"
 #include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
 #include "vtkMath.h"
+#include "vtkParallelFor.h"
+#include "vtkSmartPointer.h"
+
+#include <vtkstd/vector>
 //----------------------------------------------------------------------------
 vtkCxxRevisionMacro(vtkAbstractCellLocator, "$Revision$");
 //----------------------------------------------------------------------------
+// Answers a range of batched queries. Each thread has its own cell and
+// weights; the results are written straight into the output arrays.
+class vtkAbstractCellLocatorQueries : public vtkParallelForFunctor
+{
+public:
+  vtkAbstractCellLocator *Locator;
+  int Query;
+  vtkPoints *Points;
+  vtkPoints *Points2;
+  double Tolerance;
+  vtkIdType *CellIds;
+  double *PCoords;
+  double *Weights;
+  int NumberOfWeights;
+  double *Values; // t or dist2
+  double *Coordinates; // intersection or closest points
+  vtkstd::vector<vtkGenericCell *> Cells;
+  vtkstd::vector<double> ScratchWeights;
+
+  vtkAbstractCellLocatorQueries()
+    {
+    this->Points2 = NULL;
+    this->Tolerance = 0.0;
+    this->PCoords = this->Weights = NULL;
+    this->Values = this->Coordinates = NULL;
+    this->NumberOfWeights = 1;
+    }
+  ~vtkAbstractCellLocatorQueries()
+    {
+    for (size_t i = 0; i < this->Cells.size(); ++i)
+      {
+      this->Cells[i]->Delete();
+      }
+    }
+
+  virtual void Initialize(int numberOfThreads)
+    {
+    while (static_cast<int>(this->Cells.size()) < numberOfThreads)
+      {
+      this->Cells.push_back(vtkGenericCell::New());
+      }
+    this->ScratchWeights.resize(numberOfThreads*this->NumberOfWeights);
+    }
+
+  virtual void Execute(vtkIdType begin, vtkIdType end, int threadId)
+    {
+    vtkGenericCell *cell = this->Cells[threadId];
+    double x[3], x2[3], pcoords[3], closest[3], t, dist2;
+    double *weights = &this->ScratchWeights[threadId*this->NumberOfWeights];
+    int subId;
+    vtkIdType cellId;
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Points->GetPoint(i, x);
+      switch (this->Query)
+        {
+        case vtkAbstractCellLocator::FIND_CELL:
+          this->CellIds[i] = this->Locator->FindCell(
+            x, this->Tolerance, cell,
+            this->PCoords ? this->PCoords + 3*i : pcoords,
+            this->Weights ? this->Weights + i*this->NumberOfWeights : weights);
+          break;
+        case vtkAbstractCellLocator::INTERSECT_WITH_LINE:
+          this->Points2->GetPoint(i, x2);
+          cellId = -1;
+          if (!this->Locator->IntersectWithLine(x, x2, this->Tolerance, t,
+                                                closest, pcoords, subId,
+                                                cellId, cell))
+            {
+            cellId = -1;
+            t = VTK_DOUBLE_MAX;
+            closest[0] = closest[1] = closest[2] = 0.0;
+            }
+          this->CellIds[i] = cellId;
+          if (this->Values)
+            {
+            this->Values[i] = t;
+            }
+          if (this->Coordinates)
+            {
+            this->Coordinates[3*i] = closest[0];
+            this->Coordinates[3*i+1] = closest[1];
+            this->Coordinates[3*i+2] = closest[2];
+            }
+          break;
+        case vtkAbstractCellLocator::FIND_CLOSEST_POINT:
+          cellId = -1;
+          dist2 = VTK_DOUBLE_MAX;
+          closest[0] = closest[1] = closest[2] = 0.0;
+          this->Locator->FindClosestPoint(x, closest, cell, cellId, subId,
+                                          dist2);
+          this->CellIds[i] = cellId;
+          if (this->Values)
+            {
+            this->Values[i] = dist2;
+            }
+          if (this->Coordinates)
+            {
+            this->Coordinates[3*i] = closest[0];
+            this->Coordinates[3*i+1] = closest[1];
+            this->Coordinates[3*i+2] = closest[2];
+            }
+          break;
+        }
+      }
+    }
+
+  // The first query runs on the calling thread so that a lazily built
+  // locator, and the cell links of the data set, exist before the other
+  // threads start.
+  void Run(vtkIdType numberOfQueries)
+    {
+    if (numberOfQueries < 1)
+      {
+      return;
+      }
+    this->Initialize(1);
+    this->Execute(0, 1, 0);
+
+    vtkSmartPointer<vtkParallelFor> parallelFor =
+      vtkSmartPointer<vtkParallelFor>::New();
+    if (!this->Locator->IsQueryThreadSafe(this->Query))
+      {
+      parallelFor->SetNumberOfThreads(1);
+      }
+    parallelFor->Execute(1, numberOfQueries, this);
+    }
+};
+//----------------------------------------------------------------------------
 vtkAbstractCellLocator::vtkAbstractCellLocator()
 {
   this->CacheCellBounds            = 0;
@@ -217,6 +351,127 @@ bool vtkAbstractCellLocator::InsideCellBounds(double x[3], vtkIdType cell_ID)
   return 0;
 }
 //----------------------------------------------------------------------------
+void vtkAbstractCellLocator::FindCells(vtkPoints *points, double tol2,
+                                       vtkIdList *cellIds,
+                                       vtkDoubleArray *pcoords,
+                                       vtkDoubleArray *weights)
+{
+  if (!points || !cellIds)
+    {
+    vtkErrorMacro(<<"Points and cell ids must be given");
+    return;
+    }
+  vtkIdType numPts = points->GetNumberOfPoints();
+
+  vtkAbstractCellLocatorQueries queries;
+  queries.Locator = this;
+  queries.Query = FIND_CELL;
+  queries.Points = points;
+  queries.Tolerance = tol2;
+  if (this->DataSet && this->DataSet->GetMaxCellSize() > 32)
+    {
+    queries.NumberOfWeights = this->DataSet->GetMaxCellSize();
+    }
+  else
+    {
+    queries.NumberOfWeights = 32;
+    }
+  cellIds->SetNumberOfIds(numPts);
+  queries.CellIds = cellIds->GetPointer(0);
+  if (pcoords)
+    {
+    pcoords->SetNumberOfComponents(3);
+    pcoords->SetNumberOfTuples(numPts);
+    queries.PCoords = pcoords->GetPointer(0);
+    }
+  if (weights)
+    {
+    // The weights of each point are written in place, so every tuple is
+    // as large as the largest cell.
+    queries.NumberOfWeights = 
+      (this->DataSet ? this->DataSet->GetMaxCellSize() : 1);
+    queries.NumberOfWeights = 
+      (queries.NumberOfWeights > 0 ? queries.NumberOfWeights : 1);
+    weights->SetNumberOfComponents(queries.NumberOfWeights);
+    weights->SetNumberOfTuples(numPts);
+    queries.Weights = weights->GetPointer(0);
+    }
+  queries.Run(numPts);
+}
+//----------------------------------------------------------------------------
+void vtkAbstractCellLocator::IntersectWithLines(vtkPoints *p1, vtkPoints *p2,
+                                                double tol,
+                                                vtkIdList *cellIds,
+                                                vtkDoubleArray *t,
+                                                vtkPoints *x)
+{
+  if (!p1 || !p2 || !cellIds || 
+      p1->GetNumberOfPoints() != p2->GetNumberOfPoints())
+    {
+    vtkErrorMacro(<<"Two equally long lists of points and cell ids must be "
+                  "given");
+    return;
+    }
+  vtkIdType numLines = p1->GetNumberOfPoints();
+
+  vtkAbstractCellLocatorQueries queries;
+  queries.Locator = this;
+  queries.Query = INTERSECT_WITH_LINE;
+  queries.Points = p1;
+  queries.Points2 = p2;
+  queries.Tolerance = tol;
+  cellIds->SetNumberOfIds(numLines);
+  queries.CellIds = cellIds->GetPointer(0);
+  if (t)
+    {
+    t->SetNumberOfComponents(1);
+    t->SetNumberOfTuples(numLines);
+    queries.Values = t->GetPointer(0);
+    }
+  if (x)
+    {
+    x->SetDataTypeToDouble();
+    x->SetNumberOfPoints(numLines);
+    queries.Coordinates =
+      static_cast<vtkDoubleArray *>(x->GetData())->GetPointer(0);
+    }
+  queries.Run(numLines);
+}
+//----------------------------------------------------------------------------
+void vtkAbstractCellLocator::FindClosestPoints(vtkPoints *points,
+                                               vtkIdList *cellIds,
+                                               vtkPoints *closestPoints,
+                                               vtkDoubleArray *dist2)
+{
+  if (!points || !cellIds)
+    {
+    vtkErrorMacro(<<"Points and cell ids must be given");
+    return;
+    }
+  vtkIdType numPts = points->GetNumberOfPoints();
+
+  vtkAbstractCellLocatorQueries queries;
+  queries.Locator = this;
+  queries.Query = FIND_CLOSEST_POINT;
+  queries.Points = points;
+  cellIds->SetNumberOfIds(numPts);
+  queries.CellIds = cellIds->GetPointer(0);
+  if (closestPoints)
+    {
+    closestPoints->SetDataTypeToDouble();
+    closestPoints->SetNumberOfPoints(numPts);
+    queries.Coordinates = 
+      static_cast<vtkDoubleArray *>(closestPoints->GetData())->GetPointer(0);
+    }
+  if (dist2)
+    {
+    dist2->SetNumberOfComponents(1);
+    dist2->SetNumberOfTuples(numPts);
+    queries.Values = dist2->GetPointer(0);
+    }
+  queries.Run(numPts);
+}
+//----------------------------------------------------------------------------
 void vtkAbstractCellLocator::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
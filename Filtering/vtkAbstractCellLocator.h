@@ -28,6 +28,12 @@
 //  using vtkAbstractCellLocator::FindClosestPointWithinRadius;
 // //ETX
 // \endverbatim
+//
+// FindCells(), IntersectWithLines() and FindClosestPoints() answer a whole
+// array of queries at once. Subclasses whose queries only read the search
+// structure once it is built report so through IsQueryThreadSafe(); their
+// batched queries are then spread over several threads, each with its own
+// vtkGenericCell.
 
 //
 // .SECTION See Also
@@ -39,6 +45,7 @@
 #include "vtkLocator.h"
 
 class vtkCellArray;
+class vtkDoubleArray;
 class vtkGenericCell;
 class vtkIdList;
 class vtkPoints;
@@ -238,7 +245,46 @@ public:
   // Some locators cache cell bounds and this function can make use
   // of fast access to the data.
   virtual bool InsideCellBounds(double x[3], vtkIdType cell_ID);
- 
+
+//BTX
+  // Description:
+  // The queries that can be answered in batches.
+  enum QueryTypes
+  {
+    FIND_CELL = 0,
+    INTERSECT_WITH_LINE,
+    FIND_CLOSEST_POINT
+  };
+//ETX
+
+  // Description:
+  // Find the cell containing each of the points, as FindCell() does for a
+  // single point. cellIds receives one id per point, -1 if no cell contains
+  // the point. pcoords (3 components) and weights (as many components as
+  // the largest cell of the data set) receive the parametric coordinates
+  // and the interpolation weights of each point; either may be NULL.
+  virtual void FindCells(vtkPoints *points, double tol2, vtkIdList *cellIds,
+                         vtkDoubleArray *pcoords, vtkDoubleArray *weights);
+
+  // Description:
+  // Intersect each finite line p1[i]-p2[i] with the cells, as
+  // IntersectWithLine() does for a single line. cellIds receives the cell
+  // intersected by each line, -1 if it intersects none. t receives the
+  // parametric coordinate along the line and x the intersection point;
+  // either may be NULL.
+  virtual void IntersectWithLines(vtkPoints *p1, vtkPoints *p2, double tol,
+                                  vtkIdList *cellIds, vtkDoubleArray *t,
+                                  vtkPoints *x);
+
+  // Description:
+  // Find the closest point on the cells to each of the points, as
+  // FindClosestPoint() does for a single point. cellIds receives the cell
+  // the closest point lies on, closestPoints the point itself and dist2
+  // its squared distance; closestPoints and dist2 may be NULL.
+  virtual void FindClosestPoints(vtkPoints *points, vtkIdList *cellIds,
+                                 vtkPoints *closestPoints,
+                                 vtkDoubleArray *dist2);
+
 protected:
    vtkAbstractCellLocator();
   ~vtkAbstractCellLocator();
@@ -252,6 +298,13 @@ protected:
   virtual bool StoreCellBounds();
   virtual void FreeCellBounds();
 
+  // Description:
+  // Return 1 if the given query (one of QueryTypes) may be run from several
+  // threads at the same time, each thread passing its own vtkGenericCell,
+  // once a first query has built the locator. The default returns 0 and the
+  // batched queries then run on the calling thread only.
+  virtual int IsQueryThreadSafe(int vtkNotUsed(query)) { return 0; }
+
   int NumberOfCellsPerNode;
   int RetainCellLists;
   int CacheCellBounds;
@@ -260,6 +313,7 @@ protected:
   vtkGenericCell *GenericCell;
 //BTX - begin tcl exclude
   double (*CellBounds)[6];
+  friend class vtkAbstractCellLocatorQueries;
 //ETX - end tcl exclude
 
 private:
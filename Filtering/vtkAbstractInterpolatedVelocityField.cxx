@@ -88,6 +88,42 @@ vtkAbstractInterpolatedVelocityField::~vtkAbstractInterpolatedVelocityField()
     }
 }
 
+//---------------------------------------------------------------------------
+void vtkAbstractInterpolatedVelocityField::ShareDataSets
+  ( vtkAbstractInterpolatedVelocityField * from )
+{
+  vtkAbstractInterpolatedVelocityFieldDataSetsType::iterator it;
+  for ( it = from->DataSets->begin(); it != from->DataSets->end(); ++ it )
+    {
+    vtkAbstractInterpolatedVelocityField::PrepareDataSet( *it );
+    this->AddDataSet( *it );
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkAbstractInterpolatedVelocityField::PrepareDataSet
+  ( vtkDataSet * dataset )
+{
+  if ( !dataset || dataset->GetNumberOfPoints() < 1 ||
+       dataset->GetNumberOfCells() < 1 )
+    {
+    return;
+    }
+
+  int     subId;
+  double  x[3], pcoords[3];
+  double  tol2 = dataset->GetLength() * 
+                 vtkAbstractInterpolatedVelocityField::TOLERANCE_SCALE;
+  double *weights = new double[ dataset->GetMaxCellSize() ];
+  vtkGenericCell * cell = vtkGenericCell::New();
+  
+  dataset->GetPoint( 0, x );
+  dataset->FindCell( x, 0, cell, -1, tol2, subId, pcoords, weights );
+  
+  cell->Delete();
+  delete [] weights;
+}
+
 //---------------------------------------------------------------------------
 int vtkAbstractInterpolatedVelocityField::FunctionValues
   ( vtkDataSet * dataset, double * x, double * f )
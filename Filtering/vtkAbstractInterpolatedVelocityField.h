@@ -97,6 +97,10 @@ public:
   // hits while CacheMiss is the number of level #0 cache misses.
   vtkGetMacro( CacheHit, int );
   vtkGetMacro( CacheMiss, int );
+
+  // Description:
+  // Reset the caching statistics, e.g., before integrating a new streamline.
+  virtual void ClearStatistics() { this->CacheHit = this->CacheMiss = 0; }
   
   // Description:
   // Get the most recently visited dataset and it id. The dataset is used 
@@ -153,6 +157,13 @@ public:
   // match is found. THIS FUNCTION DOES NOT CHANGE THE REFERENCE COUNT OF 
   // dataset FOR THREAD SAFETY REASONS.
   virtual void AddDataSet( vtkDataSet * dataset ) = 0;
+
+  // Description:
+  // Add the datasets of another function, sharing the search structures
+  // built for them, so that both functions can be evaluated at the same
+  // time from different threads. Whatever the datasets build on their
+  // first cell search (bounds, point locator, cell links) is built here.
+  virtual void ShareDataSets( vtkAbstractInterpolatedVelocityField * from );
   
   // Description:
   // Evaluate the velocity field f at point (x, y, z).
@@ -202,6 +213,11 @@ protected:
   // is invoked just to handle vtkImageData and vtkRectilinearGrid that are not
   // assigned with any vtkAbstractCellLocatot-type cell locator.
   virtual int FunctionValues( vtkDataSet * ds, double * x, double * f );
+
+  // Description:
+  // Run a cell search in the dataset so that it builds its lazily created
+  // search structures before several threads search it.
+  static void PrepareDataSet( vtkDataSet * dataset );
   
 //BTX
   friend class vtkTemporalInterpolatedVelocityField;
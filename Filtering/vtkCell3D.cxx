@@ -132,9 +132,12 @@ void vtkCell3D::Contour(double value, vtkDataArray *cellScalars,
       }
 
     this->Points->GetPoint(i, x);
-    if ( locator->InsertUniquePoint(x, id) )
+    if ( locator->InsertUniqueEdgePoint(ptId, ptId, 0.0, x, id) )
       {
-      outPd->CopyData(inPd,ptId, id);
+      if ( outPd )
+        {
+        outPd->CopyData(inPd,ptId, id);
+        }
       }
     internalId[i] = this->Triangulator->InsertPoint(id, x, p, type);
     }//for all points
@@ -195,10 +198,14 @@ void vtkCell3D::Contour(double value, vtkDataArray *cellScalars,
         }
       
       // Incorporate point into output and interpolate edge data as necessary
-      if ( locator->InsertUniquePoint(x, ptId) )
+      vtkIdType e1 = this->PointIds->GetId(v1);
+      vtkIdType e2 = this->PointIds->GetId(v2);
+      if ( locator->InsertUniqueEdgePoint(e1, e2, t, x, ptId) )
         {
-        outPd->InterpolateEdge(inPd, ptId, this->PointIds->GetId(v1),
-                               this->PointIds->GetId(v2), t);
+        if ( outPd )
+          {
+          outPd->InterpolateEdge(inPd, ptId, e1, e2, t);
+          }
         }
 
       //Insert intersection point into Delaunay triangulation
@@ -279,11 +286,17 @@ void vtkCell3D::Clip(double value, vtkDataArray *cellScalars,
       {
       ptId = this->PointIds->GetId(i);
       this->Points->GetPoint(i, x);
-      if ( locator->InsertUniquePoint(x, id) )
+      if ( locator->InsertUniqueEdgePoint(ptId, ptId, 0.0, x, id) )
         {
-        outPD->CopyData(inPD,ptId, id);
+        if ( outPD )
+          {
+          outPD->CopyData(inPD,ptId, id);
+          }
         }
-      this->Triangulator->InsertPoint(id, x, p, type);
+      // The output ids order the triangulation. The tetras of a boundary
+      // cell keep the input ids, so they are clipped in terms of input
+      // points and edges; interior cells add their tetras as they are.
+      this->Triangulator->InsertPoint((allInside ? id : ptId), id, x, p, type);
       }//for all cell points of fixed topology
 
     this->Triangulator->TemplateTriangulate(this->GetCellType(),
@@ -307,10 +320,7 @@ void vtkCell3D::Clip(double value, vtkDataArray *cellScalars,
             this->Triangulator->GetNextTetra(0,this->ClipTetra,
                                              cellScalars,this->ClipScalars);)
         {
-        // VERY IMPORTANT: Notice that the outPD is used twice. This is because the
-        // tetra has been defined in terms of point ids that are defined in the
-        // output (because of the templates).
-        this->ClipTetra->Clip(value, this->ClipScalars, locator, tets, outPD,
+        this->ClipTetra->Clip(value, this->ClipScalars, locator, tets, inPD,
                               outPD, inCD, cellId, outCD, insideOut);
         }
       }//if boundary cell
@@ -338,9 +348,12 @@ void vtkCell3D::Clip(double value, vtkDataArray *cellScalars,
       }
 
     this->Points->GetPoint(i, x);
-    if ( locator->InsertUniquePoint(x, id) )
+    if ( locator->InsertUniqueEdgePoint(ptId, ptId, 0.0, x, id) )
       {
-      outPD->CopyData(inPD,ptId, id);
+      if ( outPD )
+        {
+        outPD->CopyData(inPD,ptId, id);
+        }
       }
     internalId[i] = this->Triangulator->InsertPoint(id, x, p, type);
     }//for all points
@@ -401,10 +414,14 @@ void vtkCell3D::Clip(double value, vtkDataArray *cellScalars,
         }
       
       // Incorporate point into output and interpolate edge data as necessary
-      if ( locator->InsertUniquePoint(x, ptId) )
+      vtkIdType e1 = this->PointIds->GetId(v1);
+      vtkIdType e2 = this->PointIds->GetId(v2);
+      if ( locator->InsertUniqueEdgePoint(e1, e2, t, x, ptId) )
         {
-        outPD->InterpolateEdge(inPD, ptId, this->PointIds->GetId(v1),
-                               this->PointIds->GetId(v2), t);
+        if ( outPD )
+          {
+          outPD->InterpolateEdge(inPD, ptId, e1, e2, t);
+          }
         }
 
       //Insert intersection point into Delaunay triangulation
@@ -13,6 +13,9 @@
 
 =========================================================================*/
 #include "vtkCellArray.h"
+
+#include "vtkCriticalSection.h"
+#include "vtkIntArray.h"
 #include "vtkObjectFactory.h"
 
 vtkCxxRevisionMacro(vtkCellArray, "$Revision$");
@@ -25,6 +28,23 @@ vtkCellArray::vtkCellArray()
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  this->Offsets = NULL;
+  this->Connectivity = NULL;
+  this->TraversalCellId = 0;
+  this->TraversalIds = NULL;
+  this->ConversionLock = new vtkSimpleCriticalSection;
+}
+
+//----------------------------------------------------------------------------
+// Offsets storage arrays are either vtkIdTypeArray or vtkIntArray.
+static inline vtkIdType vtkCellArrayGetValue(vtkDataArray *array,
+                                             vtkIdType i)
+{
+  if (array->GetDataType() == VTK_INT)
+    {
+    return static_cast<vtkIntArray *>(array)->GetValue(i);
+    }
+  return static_cast<vtkIdTypeArray *>(array)->GetValue(i);
 }
 
 //----------------------------------------------------------------------------
@@ -36,6 +56,20 @@ void vtkCellArray::DeepCopy (vtkCellArray *ca)
     return;
     }
 
+  if (ca->Offsets)
+    {
+    vtkDataArray *offsets = ca->Offsets->NewInstance();
+    offsets->DeepCopy(ca->Offsets);
+    vtkDataArray *connectivity = ca->Connectivity->NewInstance();
+    connectivity->DeepCopy(ca->Connectivity);
+    this->SetData(offsets, connectivity);
+    offsets->Delete();
+    connectivity->Delete();
+    this->TraversalLocation = ca->TraversalLocation;
+    return;
+    }
+
+  this->ReleaseOffsetsStorage();
   this->Ia->DeepCopy(ca->Ia);
   this->NumberOfCells = ca->NumberOfCells;
   this->InsertLocation = ca->InsertLocation;
@@ -45,12 +79,19 @@ void vtkCellArray::DeepCopy (vtkCellArray *ca)
 //----------------------------------------------------------------------------
 vtkCellArray::~vtkCellArray()
 {
+  this->ReleaseOffsetsStorage();
   this->Ia->Delete();
+  if (this->TraversalIds)
+    {
+    this->TraversalIds->Delete();
+    }
+  delete this->ConversionLock;
 }
 
 //----------------------------------------------------------------------------
 void vtkCellArray::Initialize() 
 {
+  this->ReleaseOffsetsStorage();
   this->Ia->Initialize();
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
@@ -64,6 +105,21 @@ int vtkCellArray::GetMaxCellSize()
 {
   int i, npts=0, maxSize=0;
 
+  if (this->Offsets)
+    {
+    vtkIdType cellId;
+    vtkIdType end, begin = vtkCellArrayGetValue(this->Offsets, 0);
+    for (cellId=0; cellId < this->NumberOfCells; cellId++, begin=end)
+      {
+      end = vtkCellArrayGetValue(this->Offsets, cellId+1);
+      if ( (npts=static_cast<int>(end - begin)) > maxSize )
+        {
+        maxSize = npts;
+        }
+      }
+    return maxSize;
+    }
+
   for (i=0; i<this->Ia->GetMaxId(); i+=(npts+1))
     {
     if ( (npts=this->Ia->GetValue(i)) > maxSize )
@@ -81,6 +137,7 @@ void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
   if ( cells && cells != this->Ia )
     {
     this->Modified();
+    this->ReleaseOffsetsStorage();
     this->Ia->Delete();
     this->Ia = cells;
     this->Ia->Register(this);
@@ -94,7 +151,405 @@ void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
 //----------------------------------------------------------------------------
 unsigned long vtkCellArray::GetActualMemorySize()
 {
-  return this->Ia->GetActualMemorySize();
+  unsigned long size = this->Ia->GetActualMemorySize();
+  if (this->Offsets)
+    {
+    size += this->Offsets->GetActualMemorySize();
+    size += this->Connectivity->GetActualMemorySize();
+    }
+  return size;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetNumberOfConnectivityEntries()
+{
+  if (this->Offsets)
+    {
+    // What the interleaved layout would hold.
+    return this->Connectivity->GetNumberOfTuples() + this->NumberOfCells;
+    }
+  return this->Ia->GetMaxId()+1;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::Squeeze()
+{
+  if (this->Offsets)
+    {
+    this->Offsets->Squeeze();
+    this->Connectivity->Squeeze();
+    }
+  this->Ia->Squeeze();
+}
+
+//----------------------------------------------------------------------------
+int vtkCellArray::SetData(vtkDataArray *offsets, vtkDataArray *connectivity)
+{
+  if (!offsets || !connectivity)
+    {
+    vtkErrorMacro("Both an offsets and a connectivity array are needed.");
+    return 0;
+    }
+  int i;
+  vtkDataArray *arrays[2] = {offsets, connectivity};
+  for (i=0; i < 2; i++)
+    {
+    int type = arrays[i]->GetDataType();
+    if ((type != VTK_ID_TYPE && type != VTK_INT) ||
+        arrays[i]->GetNumberOfComponents() != 1)
+      {
+      vtkErrorMacro("Offsets and connectivity must be single component "
+                    "vtkIdTypeArray or vtkIntArray, not "
+                    << arrays[i]->GetClassName());
+      return 0;
+      }
+    }
+  vtkIdType numOffsets = offsets->GetNumberOfTuples();
+  if (numOffsets < 1)
+    {
+    vtkErrorMacro("The offsets array needs ncells+1 values.");
+    return 0;
+    }
+
+  // The cells must cover the connectivity, in order.
+  vtkIdType cellId, offset, lastOffset = vtkCellArrayGetValue(offsets, 0);
+  if (lastOffset != 0)
+    {
+    vtkErrorMacro("The first offset is " << lastOffset << ", not 0.");
+    return 0;
+    }
+  for (cellId=1; cellId < numOffsets; cellId++, lastOffset=offset)
+    {
+    offset = vtkCellArrayGetValue(offsets, cellId);
+    if (offset < lastOffset)
+      {
+      vtkErrorMacro("Offset " << cellId << " is " << offset
+                    << ", less than the previous one, " << lastOffset << ".");
+      return 0;
+      }
+    }
+  if (lastOffset != connectivity->GetNumberOfTuples())
+    {
+    vtkErrorMacro("The last offset is " << lastOffset << ", not the "
+                  << connectivity->GetNumberOfTuples()
+                  << " values of the connectivity.");
+    return 0;
+    }
+
+  // Register first in case the arrays are the current ones.
+  offsets->Register(this);
+  connectivity->Register(this);
+  this->ReleaseOffsetsStorage();
+  this->Offsets = offsets;
+  this->Connectivity = connectivity;
+
+  // Drop the interleaved cells, they may be shared so do not free them
+  // in place.
+  this->Ia->Delete();
+  this->Ia = vtkIdTypeArray::New();
+
+  this->NumberOfCells = offsets->GetNumberOfTuples() - 1;
+  this->InsertLocation = this->GetNumberOfConnectivityEntries();
+  this->TraversalLocation = 0;
+  this->Modified();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReleaseOffsetsStorage()
+{
+  if (this->Offsets)
+    {
+    this->Offsets->UnRegister(this);
+    this->Offsets = NULL;
+    this->Connectivity->UnRegister(this);
+    this->Connectivity = NULL;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ConvertToOffsetsStorage()
+{
+  if (this->Offsets)
+    {
+    return;
+    }
+  this->ConversionLock->Lock();
+  if (this->Offsets)
+    {
+    this->ConversionLock->Unlock();
+    return;
+    }
+
+  // Use ints when every offset and point id fits.
+  vtkIdType numEntries = this->Ia->GetMaxId() + 1;
+  vtkIdType connectivitySize = numEntries - this->NumberOfCells;
+  vtkIdType *ia = this->Ia->GetPointer(0);
+  vtkIdType loc, maxValue = connectivitySize;
+  vtkIdType npts, i;
+  for (loc=0; loc < numEntries; loc+=npts)
+    {
+    npts = ia[loc++];
+    for (i=0; i < npts; i++)
+      {
+      maxValue = (ia[loc+i] > maxValue ? ia[loc+i] : maxValue);
+      }
+    }
+
+  vtkDataArray *offsets;
+  vtkDataArray *connectivity;
+  if (sizeof(vtkIdType) > sizeof(int) && maxValue <= VTK_INT_MAX)
+    {
+    vtkIntArray *o = vtkIntArray::New();
+    vtkIntArray *c = vtkIntArray::New();
+    int *optr = o->WritePointer(0, this->NumberOfCells+1);
+    int *cptr = c->WritePointer(0, connectivitySize);
+    int offset = 0;
+    for (loc=0; loc < numEntries; loc+=npts)
+      {
+      *optr++ = offset;
+      npts = ia[loc++];
+      for (i=0; i < npts; i++)
+        {
+        *cptr++ = static_cast<int>(ia[loc+i]);
+        }
+      offset += static_cast<int>(npts);
+      }
+    *optr = offset;
+    offsets = o;
+    connectivity = c;
+    }
+  else
+    {
+    vtkIdTypeArray *o = vtkIdTypeArray::New();
+    vtkIdTypeArray *c = vtkIdTypeArray::New();
+    vtkIdType *optr = o->WritePointer(0, this->NumberOfCells+1);
+    vtkIdType *cptr = c->WritePointer(0, connectivitySize);
+    vtkIdType offset = 0;
+    for (loc=0; loc < numEntries; loc+=npts)
+      {
+      *optr++ = offset;
+      npts = ia[loc++];
+      for (i=0; i < npts; i++)
+        {
+        *cptr++ = ia[loc+i];
+        }
+      offset += npts;
+      }
+    *optr = offset;
+    offsets = o;
+    connectivity = c;
+    }
+
+  // The cells themselves do not change, so this is not a modification.
+  this->Connectivity = connectivity;
+  this->Offsets = offsets;
+  this->Ia->Delete();
+  this->Ia = vtkIdTypeArray::New();
+  this->ConversionLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ConvertToInterleavedStorage()
+{
+  if (!this->Offsets)
+    {
+    return;
+    }
+  this->ConversionLock->Lock();
+  if (!this->Offsets)
+    {
+    this->ConversionLock->Unlock();
+    return;
+    }
+
+  vtkIdTypeArray *ia = vtkIdTypeArray::New();
+  vtkIdType *ptr = ia->WritePointer(0, this->GetNumberOfConnectivityEntries());
+  vtkIdType cellId, i;
+  vtkIdType end, begin = vtkCellArrayGetValue(this->Offsets, 0);
+  for (cellId=0; cellId < this->NumberOfCells; cellId++, begin=end)
+    {
+    end = vtkCellArrayGetValue(this->Offsets, cellId+1);
+    *ptr++ = end - begin;
+    for (i=begin; i < end; i++)
+      {
+      *ptr++ = vtkCellArrayGetValue(this->Connectivity, i);
+      }
+    }
+
+  // Publish the interleaved cells before dropping the offsets, threads
+  // that find no offsets read Ia right away.
+  vtkIdTypeArray *oldIa = this->Ia;
+  this->Ia = ia;
+  oldIa->Delete();
+  this->ReleaseOffsetsStorage();
+  this->ConversionLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+// The interleaved location of a cell in offsets storage.
+static inline vtkIdType vtkCellArrayGetLocation(vtkDataArray *offsets,
+                                                vtkIdType cellId)
+{
+  return vtkCellArrayGetValue(offsets, cellId) -
+    vtkCellArrayGetValue(offsets, 0) + cellId;
+}
+
+//----------------------------------------------------------------------------
+// Returns the id of the cell at interleaved location loc, NumberOfCells for
+// the end of the list and -1 if no cell starts there.  Locations grow
+// strictly with the cell id, so this is a binary search.
+vtkIdType vtkCellArray::FindCellAtLocation(vtkIdType loc)
+{
+  vtkIdType low = 0, high = this->NumberOfCells;
+  while (low < high)
+    {
+    vtkIdType mid = low + (high - low)/2;
+    if (vtkCellArrayGetLocation(this->Offsets, mid) < loc)
+      {
+      low = mid + 1;
+      }
+    else
+      {
+      high = mid;
+      }
+    }
+  if (vtkCellArrayGetLocation(this->Offsets, low) != loc)
+    {
+    return -1;
+    }
+  return low;
+}
+
+//----------------------------------------------------------------------------
+int vtkCellArray::GetNextCellFromOffsets(vtkIdType& npts, vtkIdType* &pts)
+{
+  // Follow SetTraversalLocation() and InitTraversal().
+  vtkIdType cellId = this->TraversalCellId;
+  if (cellId < 0 || cellId > this->NumberOfCells ||
+      vtkCellArrayGetLocation(this->Offsets, cellId) !=
+      this->TraversalLocation)
+    {
+    cellId = this->FindCellAtLocation(this->TraversalLocation);
+    }
+  if (cellId < 0 || cellId >= this->NumberOfCells)
+    {
+    return 0;
+    }
+
+  if (!this->GetCellPointerAtId(cellId, npts, pts))
+    {
+    if (!this->TraversalIds)
+      {
+      this->TraversalIds = vtkIdList::New();
+      }
+    this->GetCellAtId(cellId, this->TraversalIds);
+    npts = this->TraversalIds->GetNumberOfIds();
+    pts = this->TraversalIds->GetPointer(0);
+    }
+  this->TraversalCellId = cellId + 1;
+  this->TraversalLocation += npts + 1;
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Only possible without copying for a vtkIdTypeArray connectivity, as the
+// pointer returned must stay valid.
+int vtkCellArray::GetCellFromOffsets(vtkIdType loc, vtkIdType &npts,
+                                     vtkIdType* &pts)
+{
+  if (this->Connectivity->GetDataType() == VTK_INT)
+    {
+    return 0;
+    }
+  vtkIdType cellId = this->FindCellAtLocation(loc);
+  if (cellId < 0 || cellId >= this->NumberOfCells)
+    {
+    return 0;
+    }
+  return this->GetCellPointerAtId(cellId, npts, pts);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetCellSize(vtkIdType cellId)
+{
+  if (this->Offsets)
+    {
+    return vtkCellArrayGetValue(this->Offsets, cellId+1) -
+      vtkCellArrayGetValue(this->Offsets, cellId);
+    }
+
+  vtkIdType loc = 0;
+  for (vtkIdType i=0; i < cellId; i++)
+    {
+    loc += this->Ia->GetValue(loc) + 1;
+    }
+  return this->Ia->GetValue(loc);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdList *pts)
+{
+  pts->SetNumberOfIds(this->GetCellSize(cellId));
+  vtkIdType npts;
+  this->GetCellAtId(cellId, npts, pts->GetPointer(0));
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdType &npts,
+                               vtkIdType *pts)
+{
+  vtkIdType i;
+  if (this->Offsets)
+    {
+    vtkIdType begin = vtkCellArrayGetValue(this->Offsets, cellId);
+    npts = vtkCellArrayGetValue(this->Offsets, cellId+1) - begin;
+    if (this->Connectivity->GetDataType() == VTK_INT)
+      {
+      int *cptr = static_cast<vtkIntArray *>(this->Connectivity)->
+        GetPointer(begin);
+      for (i=0; i < npts; i++)
+        {
+        pts[i] = cptr[i];
+        }
+      }
+    else
+      {
+      vtkIdType *cptr = static_cast<vtkIdTypeArray *>(this->Connectivity)->
+        GetPointer(begin);
+      for (i=0; i < npts; i++)
+        {
+        pts[i] = cptr[i];
+        }
+      }
+    return;
+    }
+
+  vtkIdType loc = 0;
+  for (i=0; i < cellId; i++)
+    {
+    loc += this->Ia->GetValue(loc) + 1;
+    }
+  vtkIdType *cptr;
+  this->GetCell(loc, npts, cptr);
+  for (i=0; i < npts; i++)
+    {
+    pts[i] = cptr[i];
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkCellArray::GetCellPointerAtId(vtkIdType cellId, vtkIdType &npts,
+                                     vtkIdType* &pts)
+{
+  if (!this->Offsets || this->Connectivity->GetDataType() != VTK_ID_TYPE)
+    {
+    return 0;
+    }
+  vtkIdType begin = vtkCellArrayGetValue(this->Offsets, cellId);
+  npts = vtkCellArrayGetValue(this->Offsets, cellId+1) - begin;
+  pts = static_cast<vtkIdTypeArray *>(this->Connectivity)->GetPointer(begin);
+  return 1;
 }
 
 //----------------------------------------------------------------------------
@@ -105,4 +560,6 @@ void vtkCellArray::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Number Of Cells: " << this->NumberOfCells << endl;
   os << indent << "Insert Location: " << this->InsertLocation << endl;
   os << indent << "Traversal Location: " << this->TraversalLocation << endl;
+  os << indent << "Uses Offsets Storage: "
+     << (this->Offsets ? "On" : "Off") << endl;
 }
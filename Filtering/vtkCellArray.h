@@ -26,6 +26,19 @@
 // using the vtkCellTypes and vtkCellLinks objects to extend the definition of 
 // the data structure.
 //
+// Alternatively the cells can be held in offsets storage: an offsets array
+// with the start of each cell and a connectivity array with only the point
+// ids, see SetData().  This gives constant time random access through
+// GetCellAtId() and, with 32-bit arrays, roughly halves the memory used.
+// Traversal reads offsets storage directly, and so does GetCell(loc,...)
+// with a vtkIdTypeArray connectivity.  Methods that expose or modify the
+// interleaved layout above (GetData(), GetPointer(), GetSize(),
+// Allocate(), insertion, ReverseCell(), ReplaceCell(), and GetCell(loc,...)
+// with a vtkIntArray connectivity) convert the cells back to it on first
+// use.  The conversion happens once, under a lock, but it frees the
+// offsets storage: call ConvertToInterleavedStorage() before sharing the
+// cells between threads that use these methods.
+//
 // .SECTION See Also
 // vtkCellTypes vtkCellLinks
 
@@ -37,6 +50,8 @@
 #include "vtkIdTypeArray.h" // Needed for inline methods
 #include "vtkCell.h" // Needed for inline methods
 
+class vtkSimpleCriticalSection;
+
 class VTK_FILTERING_EXPORT vtkCellArray : public vtkObject
 {
 public:
@@ -50,7 +65,7 @@ public:
   // Description:
   // Allocate memory and set the size to extend by.
   int Allocate(const vtkIdType sz, const int ext=1000) 
-    {return this->Ia->Allocate(sz,ext);}
+    {this->UseInterleavedStorage(); return this->Ia->Allocate(sz,ext);}
 
   // Description:
   // Free any memory and reset to an empty state.
@@ -78,29 +93,31 @@ public:
   // Description:
   // A cell traversal methods that is more efficient than vtkDataSet traversal
   // methods.  InitTraversal() initializes the traversal of the list of cells.
-  void InitTraversal() {this->TraversalLocation=0;};
+  void InitTraversal() {this->TraversalLocation=0; this->TraversalCellId=0;};
 
   // Description:
   // A cell traversal methods that is more efficient than vtkDataSet traversal
   // methods.  GetNextCell() gets the next cell in the list. If end of list
-  // is encountered, 0 is returned.
+  // is encountered, 0 is returned.  In offsets storage with a vtkIntArray
+  // connectivity pts points to a buffer that the next call overwrites.
   int GetNextCell(vtkIdType& npts, vtkIdType* &pts);
 
   // Description:
   // Get the size of the allocated connectivity array.
   vtkIdType GetSize() 
-    {return this->Ia->GetSize();}
+    {this->UseInterleavedStorage(); return this->Ia->GetSize();}
   
   // Description:
   // Get the total number of entries (i.e., data values) in the connectivity 
   // array. This may be much less than the allocated size (i.e., return value 
   // from GetSize().)
-  vtkIdType GetNumberOfConnectivityEntries() 
-    {return this->Ia->GetMaxId()+1;}
+  vtkIdType GetNumberOfConnectivityEntries();
 
   // Description:
   // Internal method used to retrieve a cell given an offset into
-  // the internal array.
+  // the internal array.  In offsets storage the offset is the one the
+  // interleaved layout would have, and the cell is found by a binary
+  // search.
   void GetCell(vtkIdType loc, vtkIdType &npts, vtkIdType* &pts);
 
   // Description:
@@ -170,7 +187,7 @@ public:
   // Description:
   // Get pointer to array of cell data.
   vtkIdType *GetPointer() 
-    {return this->Ia->GetPointer(0);}
+    {this->UseInterleavedStorage(); return this->Ia->GetPointer(0);}
 
   // Description:
   // Get pointer to data array for purpose of direct writes of data. Size is the
@@ -195,7 +212,7 @@ public:
   // Description:
   // Return the underlying data as a data array.
   vtkIdTypeArray* GetData() 
-    {return this->Ia;}
+    {this->UseInterleavedStorage(); return this->Ia;}
 
   // Description:
   // Reuse list. Reset to initial condition.
@@ -203,8 +220,7 @@ public:
 
   // Description:
   // Reclaim any extra memory.
-  void Squeeze() 
-    {this->Ia->Squeeze();}
+  void Squeeze();
 
   // Description:
   // Return the memory in kilobytes consumed by this cell array. Used to
@@ -214,6 +230,54 @@ public:
   // information returned is valid only after the pipeline has 
   // been updated.
   unsigned long GetActualMemorySize();
+
+  // Description:
+  // Define the cells by an offsets array of ncells+1 values and a
+  // connectivity array: the point ids of cell i are the values
+  // offsets[i] to offsets[i+1]-1 of connectivity.  Each array must be a
+  // single component vtkIdTypeArray or vtkIntArray.  The arrays are
+  // referenced, not copied, so buffers owned by someone else can be
+  // adopted with vtkDataArrayTemplate::SetArray().  Like SetCells(), this
+  // discards the old cells.  The offsets must start at 0, never decrease and
+  // end at the number of values of connectivity.  Return 0, leaving the
+  // cells unchanged, if the arrays are not valid.
+  int SetData(vtkDataArray *offsets, vtkDataArray *connectivity);
+
+  // Description:
+  // Get the arrays of offsets storage, or NULL if the cells are held in
+  // the interleaved layout.
+  vtkDataArray *GetOffsetsArray() 
+    {return this->Offsets;}
+  vtkDataArray *GetConnectivityArray() 
+    {return this->Connectivity;}
+
+  // Description:
+  // Return 1 if the cells are held in offsets storage.
+  int GetUsesOffsetsStorage() 
+    {return (this->Offsets != 0);}
+
+  // Description:
+  // Convert between offsets storage and the interleaved layout.
+  // ConvertToOffsetsStorage() uses vtkIntArray for both arrays when all
+  // values fit in an int, and vtkIdTypeArray otherwise.
+  void ConvertToOffsetsStorage();
+  void ConvertToInterleavedStorage();
+
+  // Description:
+  // Random access to the cell with id cellId, in constant time with
+  // offsets storage.  With the interleaved layout these walk the list from
+  // the start, and should be avoided.  The second form copies the point
+  // ids to pts, which must hold GetCellSize(cellId) values.
+  vtkIdType GetCellSize(vtkIdType cellId);
+  void GetCellAtId(vtkIdType cellId, vtkIdList *pts);
+  void GetCellAtId(vtkIdType cellId, vtkIdType &npts, vtkIdType *pts);
+
+  // Description:
+  // Get a pointer to the point ids of the cell with id cellId without
+  // copying them.  This is only possible in offsets storage with a
+  // vtkIdTypeArray connectivity; 0 is returned otherwise.
+  int GetCellPointerAtId(vtkIdType cellId, vtkIdType &npts,
+                         vtkIdType* &pts);
   
 protected:
   vtkCellArray();
@@ -224,6 +288,26 @@ protected:
   vtkIdType TraversalLocation;   //keep track of traversal position
   vtkIdTypeArray *Ia;
 
+  // Traversal of offsets storage: the cell at TraversalLocation, and a
+  // buffer for the point ids of a vtkIntArray connectivity.
+  vtkIdType TraversalCellId;
+  vtkIdList *TraversalIds;
+  int GetNextCellFromOffsets(vtkIdType& npts, vtkIdType* &pts);
+  int GetCellFromOffsets(vtkIdType loc, vtkIdType &npts, vtkIdType* &pts);
+  vtkIdType FindCellAtLocation(vtkIdType loc);
+
+  // Serializes the conversions between the two layouts.
+  vtkSimpleCriticalSection *ConversionLock;
+
+  // Offsets storage, NULL when Ia holds the cells.
+  vtkDataArray *Offsets;
+  vtkDataArray *Connectivity;
+  void ReleaseOffsetsStorage();
+
+  // Convert back to the interleaved layout before touching Ia.
+  void UseInterleavedStorage() 
+    {if (this->Offsets) {this->ConvertToInterleavedStorage();}}
+
 private:
   vtkCellArray(const vtkCellArray&);  // Not implemented.
   void operator=(const vtkCellArray&);  // Not implemented.
@@ -234,6 +318,7 @@ private:
 inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
                                               const vtkIdType* pts)
 {
+  this->UseInterleavedStorage();
   vtkIdType i = this->Ia->GetMaxId() + 1;
   vtkIdType *ptr = this->Ia->WritePointer(i, npts+1);
   
@@ -251,6 +336,7 @@ inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
 //----------------------------------------------------------------------------
 inline vtkIdType vtkCellArray::InsertNextCell(vtkIdList *pts)
 {
+  this->UseInterleavedStorage();
   vtkIdType npts = pts->GetNumberOfIds();
   vtkIdType i = this->Ia->GetMaxId() + 1;
   vtkIdType *ptr = this->Ia->WritePointer(i,npts+1);
@@ -269,6 +355,7 @@ inline vtkIdType vtkCellArray::InsertNextCell(vtkIdList *pts)
 //----------------------------------------------------------------------------
 inline vtkIdType vtkCellArray::InsertNextCell(int npts)
 {
+  this->UseInterleavedStorage();
   this->InsertLocation = this->Ia->InsertNextValue(npts) + 1;
   this->NumberOfCells++;
 
@@ -290,6 +377,7 @@ inline void vtkCellArray::UpdateCellCount(int npts)
 //----------------------------------------------------------------------------
 inline vtkIdType vtkCellArray::InsertNextCell(vtkCell *cell)
 {
+  this->UseInterleavedStorage();
   vtkIdType npts = cell->GetNumberOfPoints();
   vtkIdType i = this->Ia->GetMaxId() + 1;
   vtkIdType *ptr = this->Ia->WritePointer(i,npts+1);
@@ -308,15 +396,21 @@ inline vtkIdType vtkCellArray::InsertNextCell(vtkCell *cell)
 //----------------------------------------------------------------------------
 inline void vtkCellArray::Reset() 
 {
+  this->ReleaseOffsetsStorage();
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
   this->Ia->Reset();
 }
 
 //----------------------------------------------------------------------------
 inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
 {
+  if ( this->Offsets )
+    {
+    return this->GetNextCellFromOffsets(npts, pts);
+    }
   if ( this->Ia->GetMaxId() >= 0 && 
        this->TraversalLocation <= this->Ia->GetMaxId() ) 
     {
@@ -335,6 +429,11 @@ inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
 inline void vtkCellArray::GetCell(vtkIdType loc, vtkIdType &npts,
                                   vtkIdType* &pts)
 {
+  if ( this->Offsets && this->GetCellFromOffsets(loc, npts, pts) )
+    {
+    return;
+    }
+  this->UseInterleavedStorage();
   npts = this->Ia->GetValue(loc++);
   pts  = this->Ia->GetPointer(loc);
 }
@@ -344,6 +443,7 @@ inline void vtkCellArray::ReverseCell(vtkIdType loc)
 {
   int i;
   vtkIdType tmp;
+  this->UseInterleavedStorage();
   vtkIdType npts=this->Ia->GetValue(loc);
   vtkIdType *pts=this->Ia->GetPointer(loc+1);
   for (i=0; i < (npts/2); i++) 
@@ -358,6 +458,7 @@ inline void vtkCellArray::ReverseCell(vtkIdType loc)
 inline void vtkCellArray::ReplaceCell(vtkIdType loc, int npts,
                                       const vtkIdType *pts)
 {
+  this->UseInterleavedStorage();
   vtkIdType *oldPts=this->Ia->GetPointer(loc+1);
   for (int i=0; i < npts; i++)
     {
@@ -369,6 +470,7 @@ inline void vtkCellArray::ReplaceCell(vtkIdType loc, int npts,
 inline vtkIdType *vtkCellArray::WritePointer(const vtkIdType ncells,
                                              const vtkIdType size)
 {
+  this->ReleaseOffsetsStorage();
   this->NumberOfCells = ncells;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
@@ -17,6 +17,7 @@
 #include "vtkCellArray.h"
 #include "vtkDataSet.h"
 #include "vtkGenericCell.h"
+#include "vtkIdList.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
 
@@ -215,6 +216,13 @@ void vtkCellLinks::BuildLinks(vtkDataSet *data, vtkCellArray *Connectivity)
   vtkIdType npts=0;
   vtkIdType *pts=0;
   vtkIdType loc = Connectivity->GetTraversalLocation();
+
+  // offsets storage is walked by cell id, which avoids converting it
+  if (Connectivity->GetUsesOffsetsStorage())
+    {
+    this->BuildLinksFromOffsets(numPts, Connectivity);
+    return;
+    }
   
   // traverse data to determine number of uses of each point
   for (Connectivity->InitTraversal(); 
@@ -247,6 +255,43 @@ void vtkCellLinks::BuildLinks(vtkDataSet *data, vtkCellArray *Connectivity)
   Connectivity->SetTraversalLocation(loc);
 }
 
+//----------------------------------------------------------------------------
+void vtkCellLinks::BuildLinksFromOffsets(vtkIdType numPts,
+                                         vtkCellArray *Connectivity)
+{
+  vtkIdType numCells = Connectivity->GetNumberOfCells();
+  vtkIdType j, cellId;
+  unsigned short *linkLoc;
+  vtkIdList *cellPts = vtkIdList::New();
+
+  for (cellId=0; cellId < numCells; cellId++)
+    {
+    Connectivity->GetCellAtId(cellId, cellPts);
+    for (j=0; j < cellPts->GetNumberOfIds(); j++)
+      {
+      this->IncrementLinkCount(cellPts->GetId(j));
+      }
+    }
+
+  this->AllocateLinks(numPts);
+  this->MaxId = numPts - 1;
+
+  linkLoc = new unsigned short[numPts];
+  memset(linkLoc, 0, numPts*sizeof(unsigned short));
+
+  for (cellId=0; cellId < numCells; cellId++)
+    {
+    Connectivity->GetCellAtId(cellId, cellPts);
+    for (j=0; j < cellPts->GetNumberOfIds(); j++)
+      {
+      vtkIdType ptId = cellPts->GetId(j);
+      this->InsertCellReference(ptId, (linkLoc[ptId])++, cellId);
+      }
+    }
+  delete [] linkLoc;
+  cellPts->Delete();
+}
+
 //----------------------------------------------------------------------------
 // Insert a new point into the cell-links data structure. The size parameter
 // is the initial size of the list.
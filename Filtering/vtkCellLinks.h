@@ -134,6 +134,9 @@ protected:
 
   void AllocateLinks(vtkIdType n);
 
+  // Build the links of a cell array in offsets storage.
+  void BuildLinksFromOffsets(vtkIdType numPts, vtkCellArray *Connectivity);
+
   // Description:
   // Insert a cell id into the list of cells using the point.
   void InsertCellReference(vtkIdType ptId, unsigned short pos,
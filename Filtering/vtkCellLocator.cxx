@@ -18,6 +18,7 @@
 #include "vtkGenericCell.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
+#include "vtkParallelFor.h"
 #include "vtkPolyData.h"
 #include "vtkBox.h"
 
@@ -26,11 +27,6 @@
 vtkCxxRevisionMacro(vtkCellLocator, "$Revision$");
 vtkStandardNewMacro(vtkCellLocator);
 
-#define VTK_CELL_OUTSIDE 0
-#define VTK_CELL_INSIDE 1
-
-typedef vtkIdList *vtkIdListPtr;
-
 //----------------------------------------------------------------------------
 class vtkNeighborCells
 {
@@ -65,13 +61,15 @@ vtkCellLocator::vtkCellLocator()
   this->MaxLevel             = 8;
   this->Level                = 8;
   this->NumberOfCellsPerNode = 25;
-  this->Tree                 = NULL;
+  this->LeafOffsets          = NULL;
+  this->LeafCells            = NULL;
   this->CellHasBeenVisited   = NULL;
   this->QueryNumber          = 0;
   this->NumberOfDivisions    = 1;
   this->H[0] = this->H[1] = this->H[2] = 1.0;
 
   this->Buckets = new vtkNeighborCells(10, 10);
+  this->BucketCells = vtkIdList::New();
 }
 
 //----------------------------------------------------------------------------
@@ -82,6 +80,7 @@ vtkCellLocator::~vtkCellLocator()
     delete this->Buckets;
     this->Buckets = NULL;
     }
+  this->BucketCells->Delete();
   
   this->FreeSearchStructure();
   this->FreeCellBounds();
@@ -96,44 +95,27 @@ vtkCellLocator::~vtkCellLocator()
 //----------------------------------------------------------------------------
 void vtkCellLocator::FreeSearchStructure()
 {
-  vtkIdList *cellIds;
-  int i;
-  
-  if ( this->Tree )
+  if ( this->LeafOffsets )
     {
-    for (i=0; i<this->NumberOfOctants; i++)
-      {
-      cellIds = this->Tree[i];
-      if (cellIds == reinterpret_cast<void *>(VTK_CELL_INSIDE))
-        {
-        cellIds = 0;
-        }
-      if (cellIds)
-        {
-        cellIds->Delete();
-        }
-      }
-    delete [] this->Tree;
-    this->Tree = NULL;
+    delete [] this->LeafOffsets;
+    this->LeafOffsets = NULL;
+    }
+  if ( this->LeafCells )
+    {
+    delete [] this->LeafCells;
+    this->LeafCells = NULL;
     }
 }
 
 //----------------------------------------------------------------------------
-// Given an offset into the structure, the number of divisions in the octree,
-// an i,j,k location in the octree; return the index (idx) into the structure.
-// Method returns 1 is the specified i,j,k location is "outside" of the octree.
-int vtkCellLocator::GenerateIndex(int offset, int numDivs, int i, int j,
-                                  int k, vtkIdType &idx)
+// The leaves below octant (i,j,k) of the given level are the Morton range
+// starting at the octant's own Morton index shifted down to the leaf level.
+int vtkCellLocator::IsOctantEmpty(int level, int i, int j, int k)
 {
-  if ( i < 0 || i >= numDivs || 
-       j < 0 || j >= numDivs || k < 0 || k >= numDivs )
-    {
-    return 1;
-    }
-  
-  idx = offset + i + j*numDivs + k*numDivs*numDivs;
-  
-  return 0;
+  int shift = 3*(this->Level - level);
+  vtkIdType first = vtkCellLocator::GetLeafIndex(i,j,k) << shift;
+  vtkIdType last = (vtkCellLocator::GetLeafIndex(i,j,k) + 1) << shift;
+  return this->LeafOffsets[first] == this->LeafOffsets[last];
 }
 
 
@@ -165,9 +147,9 @@ int vtkCellLocator::IntersectWithLine(double a0[3], double a1[3], double tol,
   int hitCellBounds;
   double result;
   double bounds2[6];
-  int i, leafStart, prod, loop;
+  int i, loop;
   vtkIdType bestCellId = -1, cId;
-  int idx;
+  vtkIdType leaf;
   double tMax, dist[3];
   int npos[3];
   int pos[3];
@@ -210,8 +192,6 @@ int vtkCellLocator::IntersectWithLine(double a0[3], double a1[3], double tol,
   if (vtkBox::IntersectBox(bounds2, origin, direction2, hitPosition, result))
     {
     // start walking through the octants
-    prod = this->NumberOfDivisions*this->NumberOfDivisions;
-    leafStart = this->NumberOfOctants - this->NumberOfDivisions*prod;
     bestCellId = -1;
     
     // Clear the array that indicates whether we have visited this cell.
@@ -245,22 +225,20 @@ int vtkCellLocator::IntersectWithLine(double a0[3], double a1[3], double tol,
         }
       }
     
-    idx = leafStart + pos[0] - 1 + (pos[1] - 1)*this->NumberOfDivisions 
-      + (pos[2] - 1)*prod;
-    
     while ((bestCellId < 0) && (pos[0] > 0) && (pos[1] > 0) && (pos[2] > 0) &&
       (pos[0] <= this->NumberOfDivisions) &&
       (pos[1] <= this->NumberOfDivisions) &&
       (pos[2] <= this->NumberOfDivisions) &&
       (currDist < stopDist))
       {
-      if (this->Tree[idx])
+      leaf = vtkCellLocator::GetLeafIndex(pos[0]-1,pos[1]-1,pos[2]-1);
+      if (!this->IsLeafEmpty(leaf))
         {
         this->ComputeOctantBounds(pos[0]-1,pos[1]-1,pos[2]-1);
-        for (tMax = VTK_DOUBLE_MAX, cellId=0; 
-        cellId < this->Tree[idx]->GetNumberOfIds(); cellId++) 
+        for (tMax = VTK_DOUBLE_MAX, cellId=this->LeafOffsets[leaf];
+        cellId < this->LeafOffsets[leaf+1]; cellId++)
           {
-          cId = this->Tree[idx]->GetId(cellId);
+          cId = this->LeafCells[cellId];
           if (this->CellHasBeenVisited[cId] != this->QueryNumber)
             {
             this->CellHasBeenVisited[cId] = this->QueryNumber;
@@ -363,9 +341,6 @@ int vtkCellLocator::IntersectWithLine(double a0[3], double a1[3], double tol,
       // now make the move, find the smallest distance
       // only cross one boundry at a time
       pos[bestDir] = npos[bestDir];
-      
-      idx = leafStart + pos[0] - 1 + (pos[1]-1)*this->NumberOfDivisions + 
-        (pos[2]-1)*prod;
       }
     } // if (vtkBox::IntersectBox(...))
     
@@ -393,7 +368,7 @@ void vtkCellLocator::FindClosestPoint(double x[3], double closestPoint[3],
   int *nei;
   vtkIdType closestCell = -1;
   int closestSubCell = -1;
-  int leafStart;
+  vtkIdType leaf;
   int level;
   int ijk[3];
   double minDist2, refinedRadius2, distance2ToBucket;
@@ -401,7 +376,6 @@ void vtkCellLocator::FindClosestPoint(double x[3], double closestPoint[3],
   double pcoords[3], point[3], cachedPoint[3], weightsArray[6];
   double *weights = weightsArray;
   int nWeights = 6, nPoints;
-  vtkIdList *cellIds;
   int stat;
   //int minStat=0; //save this variable it is used for debugging
   
@@ -411,9 +385,6 @@ void vtkCellLocator::FindClosestPoint(double x[3], double closestPoint[3],
   cachedPoint[1] = 0.0;
   cachedPoint[2] = 0.0;
 
-  leafStart = this->NumberOfOctants
-    - this->NumberOfDivisions*this->NumberOfDivisions*this->NumberOfDivisions;
-  
   // Clear the array that indicates whether we have visited this cell.
   // The array is only cleared when the query number rolls over.  This
   // saves a number of calls to memset.
@@ -459,9 +430,8 @@ void vtkCellLocator::FindClosestPoint(double x[3], double closestPoint[3],
       nei = this->Buckets->GetPoint(i);
       
       // if a neighboring bucket has cells, 
-      if ( (cellIds = 
-        this->Tree[leafStart + nei[0] + nei[1]*this->NumberOfDivisions + 
-          nei[2]*this->NumberOfDivisions*this->NumberOfDivisions]) != NULL )
+      leaf = vtkCellLocator::GetLeafIndex(nei[0], nei[1], nei[2]);
+      if ( !this->IsLeafEmpty(leaf) )
         {
         // do we still need to test this bucket?
         distance2ToBucket = this->Distance2ToBucket(x, nei);
@@ -469,10 +439,10 @@ void vtkCellLocator::FindClosestPoint(double x[3], double closestPoint[3],
         if (distance2ToBucket < refinedRadius2)
           {
           // still a viable bucket
-          for (j=0; j < cellIds->GetNumberOfIds(); j++) 
+          for (j=this->LeafOffsets[leaf]; j < this->LeafOffsets[leaf+1]; j++)
             {
             // get the cell
-            cellId = cellIds->GetId(j);
+            cellId = this->LeafCells[j];
             if (this->CellHasBeenVisited[cellId] != this->QueryNumber)
               {
               this->CellHasBeenVisited[cellId] = this->QueryNumber;
@@ -569,9 +539,8 @@ void vtkCellLocator::FindClosestPoint(double x[3], double closestPoint[3],
       {
       nei = this->Buckets->GetPoint(i);
       
-      if ( (cellIds = 
-          this->Tree[leafStart + nei[0] + nei[1]*this->NumberOfDivisions + 
-            nei[2]*this->NumberOfDivisions*this->NumberOfDivisions]) != NULL )
+      leaf = vtkCellLocator::GetLeafIndex(nei[0], nei[1], nei[2]);
+      if ( !this->IsLeafEmpty(leaf) )
         {
         // do we still need to test this bucket?
         distance2ToBucket = this->Distance2ToBucket(x, nei);
@@ -579,10 +548,10 @@ void vtkCellLocator::FindClosestPoint(double x[3], double closestPoint[3],
         if (distance2ToBucket < refinedRadius2)
           {
           // still a viable bucket
-          for (j=0; j < cellIds->GetNumberOfIds(); j++) 
+          for (j=this->LeafOffsets[leaf]; j < this->LeafOffsets[leaf+1]; j++)
             {
             // get the cell
-            cellId = cellIds->GetId(j);
+            cellId = this->LeafCells[j];
             if (this->CellHasBeenVisited[cellId] != this->QueryNumber)
               {
               this->CellHasBeenVisited[cellId] = this->QueryNumber;
@@ -668,14 +637,13 @@ vtkIdType vtkCellLocator::FindClosestPointWithinRadius(double x[3], double radiu
   int *nei;
   int closestCell = -1;
   int closestSubCell = -1;
-  int leafStart;
+  vtkIdType leaf;
   int ijk[3];
   double minDist2;
   double pcoords[3], point[3], cachedPoint[3], weightsArray[6];
   double *weights = weightsArray;
   int nWeights = 6, nPoints;
   int returnVal = 0;
-  vtkIdList *cellIds;
   
   double refinedRadius, radius2, refinedRadius2, distance2ToBucket;
   double distance2ToCellBounds, cellBounds[6], currentRadius;
@@ -688,9 +656,6 @@ vtkIdType vtkCellLocator::FindClosestPointWithinRadius(double x[3], double radiu
   cachedPoint[1] = 0.0;
   cachedPoint[2] = 0.0;
 
-  leafStart = this->NumberOfOctants
-    - this->NumberOfDivisions*this->NumberOfDivisions*this->NumberOfDivisions;
-  
   // Clear the array that indicates whether we have visited this cell.
   // The array is only cleared when the query number rolls over.  This
   // saves a number of calls to memset.
@@ -727,15 +692,14 @@ vtkIdType vtkCellLocator::FindClosestPointWithinRadius(double x[3], double radiu
   
   // Start by searching the bucket that the point is in.
   //
-  if ((cellIds = 
-      this->Tree[leafStart + ijk[0] + ijk[1]*this->NumberOfDivisions + 
-      ijk[2]*this->NumberOfDivisions*this->NumberOfDivisions]) != NULL )
+  leaf = vtkCellLocator::GetLeafIndex(ijk[0], ijk[1], ijk[2]);
+  if ( !this->IsLeafEmpty(leaf) )
     {
     // query each cell
-    for (j=0; j < cellIds->GetNumberOfIds(); j++) 
+    for (j=this->LeafOffsets[leaf]; j < this->LeafOffsets[leaf+1]; j++)
       {
       // get the cell
-      cellId = cellIds->GetId(j);
+      cellId = this->LeafCells[j];
       if (this->CellHasBeenVisited[cellId] != this->QueryNumber)
         {
         this->CellHasBeenVisited[cellId] = this->QueryNumber;
@@ -838,8 +802,6 @@ vtkIdType vtkCellLocator::FindClosestPointWithinRadius(double x[3], double radiu
   // implemented by decreasing ii by 1 each iteration.  another alternative
   // is to double the radius each iteration, i.e. ii = ii >> 1
   // In practice, reducing ii by one has been found to be more efficient.
-  int numberOfBucketsPerPlane;
-  numberOfBucketsPerPlane = this->NumberOfDivisions*this->NumberOfDivisions;
   prevMinLevel[0] = prevMaxLevel[0] = ijk[0];
   prevMinLevel[1] = prevMaxLevel[1] = ijk[1];
   prevMinLevel[2] = prevMaxLevel[2] = ijk[2];
@@ -855,9 +817,8 @@ vtkIdType vtkCellLocator::FindClosestPointWithinRadius(double x[3], double radiu
       {
       nei = this->Buckets->GetPoint(i);
       
-      if ( (cellIds = 
-        this->Tree[leafStart + nei[0] + nei[1]*this->NumberOfDivisions + 
-          nei[2]*numberOfBucketsPerPlane]) != NULL )
+      leaf = vtkCellLocator::GetLeafIndex(nei[0], nei[1], nei[2]);
+      if ( !this->IsLeafEmpty(leaf) )
         {
         // do we still need to test this bucket?
         distance2ToBucket = this->Distance2ToBucket(x, nei);
@@ -865,10 +826,10 @@ vtkIdType vtkCellLocator::FindClosestPointWithinRadius(double x[3], double radiu
         if (distance2ToBucket < refinedRadius2)
           {
           // still a viable bucket
-          for (j=0; j < cellIds->GetNumberOfIds(); j++) 
+          for (j=this->LeafOffsets[leaf]; j < this->LeafOffsets[leaf+1]; j++)
             {
             // get the cell
-            cellId = cellIds->GetId(j);
+            cellId = this->LeafCells[j];
             if (this->CellHasBeenVisited[cellId] != this->QueryNumber)
               {
               this->CellHasBeenVisited[cellId] = this->QueryNumber;
@@ -960,23 +921,17 @@ vtkIdType vtkCellLocator::FindClosestPointWithinRadius(double x[3], double radiu
 
 //----------------------------------------------------------------------------
 //  Internal function to get bucket neighbors at specified "level". The
-//  bucket neighbors are indices into the "leaf-node" layer of the octree.
-//  These indices must be offset by number of octants before the leaf node
-//  layer before they can be used. Only those buckets with cells are returned.
+//  bucket neighbors are i-j-k indices of the "leaf-node" layer of the
+//  octree; use GetLeafIndex() to look up their cells. Only those buckets
+//  with cells are returned.
 //
 void vtkCellLocator::GetBucketNeighbors(int ijk[3], int ndivs, int level)
 {
   int i, j, k, min, max, minLevel[3], maxLevel[3];
   int nei[3];
-  int leafStart;
-  int numberOfBucketsPerPlane;
   
   this->BuildLocatorIfNeeded();
 
-  numberOfBucketsPerPlane = this->NumberOfDivisions*this->NumberOfDivisions;
-  leafStart = this->NumberOfOctants
-    - numberOfBucketsPerPlane*this->NumberOfDivisions;
-  
   //  Initialize
   //
   this->Buckets->Reset();
@@ -985,8 +940,8 @@ void vtkCellLocator::GetBucketNeighbors(int ijk[3], int ndivs, int level)
   //
   if ( level == 0 ) 
     {
-    if (this->Tree[leafStart + ijk[0] + ijk[1]*this->NumberOfDivisions
-      + ijk[2]*numberOfBucketsPerPlane])
+    if (!this->IsLeafEmpty(
+          vtkCellLocator::GetLeafIndex(ijk[0], ijk[1], ijk[2])))
       {
       this->Buckets->InsertNextPoint(ijk);
       }
@@ -1014,8 +969,7 @@ void vtkCellLocator::GetBucketNeighbors(int ijk[3], int ndivs, int level)
           j == (ijk[1] + level) || j == (ijk[1] - level) ||
           k == (ijk[2] + level) || k == (ijk[2] - level) ) 
           {
-          if (this->Tree[leafStart + i + j*this->NumberOfDivisions
-            + k*numberOfBucketsPerPlane])
+          if (!this->IsLeafEmpty(vtkCellLocator::GetLeafIndex(i, j, k)))
             {
             nei[0]=i; nei[1]=j; nei[2]=k;
             this->Buckets->InsertNextPoint(nei);
@@ -1031,10 +985,8 @@ void vtkCellLocator::GetBucketNeighbors(int ijk[3], int ndivs, int level)
 //----------------------------------------------------------------------------
 // Internal method to find those buckets that are within distance specified.
 // Only those buckets outside of level radiuses of ijk are returned. The
-// bucket neighbors are indices into the "leaf-node" layer of the octree.
-// These indices must be offset by number of octants before the leaf node
-// layer before they can be used. Only buckets that have cells are placed
-// in the bucket list.
+// bucket neighbors are i-j-k indices of the "leaf-node" layer of the
+// octree. Only buckets that have cells are placed in the bucket list.
 //
 void vtkCellLocator::GetOverlappingBuckets(double x[3], int vtkNotUsed(ijk)[3], 
                                            double dist, 
@@ -1042,15 +994,10 @@ void vtkCellLocator::GetOverlappingBuckets(double x[3], int vtkNotUsed(ijk)[3],
                                            int prevMaxLevel[3])
 {
   int i, j, k, nei[3], minLevel[3], maxLevel[3];
-  int leafStart, kFactor, jFactor;
-  int numberOfBucketsPerPlane, jkSkipFlag, kSkipFlag;
+  int jkSkipFlag, kSkipFlag;
 
   this->BuildLocatorIfNeeded();
 
-  numberOfBucketsPerPlane = this->NumberOfDivisions*this->NumberOfDivisions;
-  leafStart = this->NumberOfOctants
-    - numberOfBucketsPerPlane*this->NumberOfDivisions;
-  
   // Initialize
   this->Buckets->Reset();
   
@@ -1091,7 +1038,6 @@ void vtkCellLocator::GetOverlappingBuckets(double x[3], int vtkNotUsed(ijk)[3],
 
   for ( k= minLevel[2]; k <= maxLevel[2]; k++ ) 
     {
-    kFactor = k*numberOfBucketsPerPlane;
     if (k >= prevMinLevel[2] && k <= prevMaxLevel[2])
       {
       kSkipFlag = 1;
@@ -1110,7 +1056,6 @@ void vtkCellLocator::GetOverlappingBuckets(double x[3], int vtkNotUsed(ijk)[3],
         {
         jkSkipFlag = 0;
         }
-      jFactor = j*this->NumberOfDivisions;
       for ( i= minLevel[0]; i <= maxLevel[0]; i++ ) 
         {
         if ( jkSkipFlag && i == prevMinLevel[0] )
@@ -1119,7 +1064,7 @@ void vtkCellLocator::GetOverlappingBuckets(double x[3], int vtkNotUsed(ijk)[3],
           continue;
           }
         // if this bucket has any cells, add it to the list
-        if (this->Tree[leafStart + i + jFactor + kFactor])
+        if (!this->IsLeafEmpty(vtkCellLocator::GetLeafIndex(i, j, k)))
           {
           nei[0]=i; nei[1]=j; nei[2]=k;
           this->Buckets->InsertNextPoint(nei);
@@ -1138,9 +1083,9 @@ void vtkCellLocator::GetOverlappingBuckets(double x[3], int vtkNotUsed(ijk)[3],
 
 //----------------------------------------------------------------------------
 // number of buckets available
-int vtkCellLocator::GetNumberOfBuckets(void) 
+int vtkCellLocator::GetNumberOfBuckets(void)
 {
-  if (this->Tree)
+  if (this->LeafOffsets)
     {
     return this->NumberOfOctants;
     }
@@ -1152,11 +1097,36 @@ int vtkCellLocator::GetNumberOfBuckets(void)
 }
 
 //----------------------------------------------------------------------------
-// Get the cells in a bucket.
+// Get the cells in a bucket.  Buckets are numbered level by level, so the
+// leaves are the last NumberOfDivisions^3 octants in i-j-k order.
 vtkIdList* vtkCellLocator::GetCells(int octantId)
 {
-  // handle parents ?             
-  return this->Tree[octantId];
+  int ndivs = this->NumberOfDivisions;
+  int leafStart = this->NumberOfOctants - ndivs*ndivs*ndivs;
+  vtkIdType leaf, idx;
+
+  if ( !this->LeafOffsets || octantId < leafStart ||
+       octantId >= this->NumberOfOctants )
+    {
+    return NULL;
+    }
+  octantId -= leafStart;
+  leaf = vtkCellLocator::GetLeafIndex(octantId % ndivs,
+                                      (octantId / ndivs) % ndivs,
+                                      octantId / (ndivs*ndivs));
+  if ( this->IsLeafEmpty(leaf) )
+    {
+    return NULL;
+    }
+
+  this->BucketCells->SetNumberOfIds(this->LeafOffsets[leaf+1] -
+                                    this->LeafOffsets[leaf]);
+  for (idx=this->LeafOffsets[leaf]; idx < this->LeafOffsets[leaf+1]; idx++)
+    {
+    this->BucketCells->SetId(idx - this->LeafOffsets[leaf],
+                             this->LeafCells[idx]);
+    }
+  return this->BucketCells;
 }
 
 //---------------------------------------------------------------------------
@@ -1169,7 +1139,7 @@ void vtkCellLocator::BuildLocator()
 void vtkCellLocator::BuildLocatorIfNeeded()
 {
   if (this->LazyEvaluation) {
-    if (!this->Tree || (this->Tree && (this->MTime>this->BuildTime))) {
+    if (!this->LeafOffsets || (this->LeafOffsets && (this->MTime>this->BuildTime))) {
       this->Modified();
       vtkDebugMacro(<< "Forcing BuildLocator");
       this->ForceBuildLocator();
@@ -1181,17 +1151,66 @@ void vtkCellLocator::ForceBuildLocator()
 {
   //
   // don't rebuild if build time is newer than modified and dataset modified time
-  if ( (this->Tree) && (this->BuildTime>this->MTime) && (this->BuildTime>DataSet->GetMTime())) {
+  if ( (this->LeafOffsets) && (this->BuildTime>this->MTime) && (this->BuildTime>DataSet->GetMTime())) {
     return;
   }
   // don't rebuild if UseExistingSearchStructure is ON and a tree structure already exists
-  if ( (this->Tree) && this->UseExistingSearchStructure) {
+  if ( (this->LeafOffsets) && this->UseExistingSearchStructure) {
     this->BuildTime.Modified();
     vtkDebugMacro(<< "BuildLocator exited - UseExistingSearchStructure");
     return;
   }
   this->BuildLocatorInternal();
 }
+
+//---------------------------------------------------------------------------
+// Computes the range of leaf octants overlapped by each cell of a data set
+// for BuildLocatorInternal().
+class vtkCellLocatorRangeFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkDataSet *DataSet;
+  double (*CellBounds)[6]; // used instead of DataSet when set
+  double Bounds[6];
+  double H[3];
+  double HTol[3];
+  int NumberOfDivisions;
+  int *Ranges; // ijkMin and ijkMax of each cell
+
+  void Execute(vtkIdType begin, vtkIdType end, int vtkNotUsed(threadId))
+    {
+    double cellBounds[6], *boundsPtr = cellBounds;
+    int *range;
+    for (vtkIdType cellId=begin; cellId<end; cellId++)
+      {
+      if (this->CellBounds)
+        {
+        boundsPtr = this->CellBounds[cellId];
+        }
+      else
+        {
+        this->DataSet->GetCellBounds(cellId, cellBounds);
+        }
+      range = this->Ranges + 6*cellId;
+      for (int i=0; i<3; i++)
+        {
+        range[i] = static_cast<int>(
+          (boundsPtr[2*i] - this->Bounds[2*i] - this->HTol[i]) / this->H[i]);
+        range[3+i] = static_cast<int>(
+          (boundsPtr[2*i+1] - this->Bounds[2*i] + this->HTol[i]) / this->H[i]);
+        if (range[i] < 0)
+          {
+          range[i] = 0;
+          }
+        if (range[3+i] >= this->NumberOfDivisions)
+          {
+          range[3+i] = this->NumberOfDivisions-1;
+          }
+        }
+      }
+    }
+};
+
 //---------------------------------------------------------------------------
 //  Method to form subdivision of space based on the cells provided and
 //  subject to the constraints of levels and NumberOfCellsPerNode.
@@ -1199,20 +1218,16 @@ void vtkCellLocator::ForceBuildLocator()
 //
 void vtkCellLocator::BuildLocatorInternal()
 {
-  double *bounds, length, cellBounds[6], *boundsPtr;
+  double *bounds, length, cellBounds[6];
   vtkIdType numCells;
-  int ndivs, product;
-  int i, j, k, ijkMin[3], ijkMax[3];
-  vtkIdType cellId, idx;
-  int parentOffset;
-  vtkIdList *octant;
+  int ndivs;
+  int i, j, k, *range;
+  vtkIdType cellId, leaf, numLeaves;
   int numCellsPerBucket = this->NumberOfCellsPerNode;
-  typedef vtkIdList *vtkIdListPtr;
   int prod, numOctants;
-  double hTol[3];
-  
+
   vtkDebugMacro( << "Subdividing octree..." );
-  
+
   if ( !this->DataSet || (numCells = this->DataSet->GetNumberOfCells()) < 1 )
     {
     vtkErrorMacro( << "No cells to subdivide");
@@ -1221,7 +1236,7 @@ void vtkCellLocator::BuildLocatorInternal()
 
   //  Make sure the appropriate data is available
   //
-  if ( this->Tree )
+  if ( this->LeafOffsets )
     {
     this->FreeSearchStructure();
     }
@@ -1231,7 +1246,7 @@ void vtkCellLocator::BuildLocatorInternal()
     this->CellHasBeenVisited = NULL;
     }
   this->FreeCellBounds();
-  
+
   //  Size the root cell.  Initialize cell data structure, compute
   //  level and divisions.
   //
@@ -1248,17 +1263,20 @@ void vtkCellLocator::BuildLocatorInternal()
       this->Bounds[2*i+1] += length/100.0;
       }
     }
-  
-  if ( this->Automatic ) 
+
+  if ( this->Automatic )
     {
     this->Level = static_cast<int>(
       ceil(log(static_cast<double>(numCells)/numCellsPerBucket) /
            (log(static_cast<double>(8.0)))));
-    } 
+    }
   this->Level =(this->Level > this->MaxLevel ? this->MaxLevel : this->Level);
-  
+  // the Morton index of a leaf holds at most 10 bits per direction
+  this->Level =(this->Level > 10 ? 10 : this->Level);
+  this->Level =(this->Level < 0 ? 0 : this->Level);
+
   // compute number of octants and number of divisions
-  for (ndivs=1,prod=1,numOctants=1,i=0; i<this->Level; i++) 
+  for (ndivs=1,prod=1,numOctants=1,i=0; i<this->Level; i++)
     {
     ndivs *= 2;
     prod *= 8;
@@ -1266,10 +1284,8 @@ void vtkCellLocator::BuildLocatorInternal()
     }
   this->NumberOfDivisions = ndivs;
   this->NumberOfOctants = numOctants;
+  numLeaves = prod;
 
-  this->Tree = new vtkIdListPtr[numOctants];
-  memset (this->Tree, 0, numOctants*sizeof(vtkIdListPtr));
-  
   this->CellHasBeenVisited = new unsigned char [ numCells ];
   this->ClearCellHasBeenVisited();
   this->QueryNumber = 0;
@@ -1278,111 +1294,265 @@ void vtkCellLocator::BuildLocatorInternal()
     {
     this->StoreCellBounds();
     }
-  
-  //  Compute width of leaf octant in three directions
+
+  //  Find the leaf octants each cell may fall in, making sure the cell
+  //  falls within the octants.  GetCellBounds() is only thread safe for
+  //  the data sets which compute the bounds from their points directly,
+  //  and after a first call from a single thread.
   //
+  vtkCellLocatorRangeFunctor functor;
+  functor.DataSet = this->DataSet;
+  functor.CellBounds = this->CellBounds;
+  for (i=0; i<6; i++)
+    {
+    functor.Bounds[i] = this->Bounds[i];
+    }
   for (i=0; i<3; i++)
     {
     this->H[i] = (this->Bounds[2*i+1] - this->Bounds[2*i]) / ndivs;
-    hTol[i] = this->H[i]/100.0;
+    functor.H[i] = this->H[i];
+    functor.HTol[i] = this->H[i]/100.0;
     }
+  functor.NumberOfDivisions = ndivs;
+  functor.Ranges = new int [6*numCells];
+  vtkParallelFor *parallelFor = vtkParallelFor::New();
+  if ( !this->CellBounds )
+    {
+    this->DataSet->GetCellBounds(0, cellBounds);
+    if ( !this->DataSet->IsA("vtkPolyData") &&
+         !this->DataSet->IsA("vtkUnstructuredGrid") &&
+         !this->DataSet->IsA("vtkStructuredGrid") &&
+         !this->DataSet->IsA("vtkRectilinearGrid") &&
+         !this->DataSet->IsA("vtkImageData") )
+      {
+      parallelFor->SetNumberOfThreads(1);
+      }
+    }
+  parallelFor->Execute(0, numCells, &functor);
+  parallelFor->Delete();
 
-  //  Insert each cell into the appropriate octant.  Make sure cell
-  //  falls within octant.
+  //  Counting sort of the cell ids into the leaves.  After the prefix sum
+  //  LeafOffsets[leaf] is the end of the leaf; filling the leaves back to
+  //  front moves it to the start and keeps the cell ids of a leaf in
+  //  increasing order.
   //
-  parentOffset = numOctants - (ndivs * ndivs * ndivs);
-  product = ndivs * ndivs;
-  boundsPtr = cellBounds;
-  for (cellId=0; cellId<numCells; cellId++) 
+  this->LeafOffsets = new vtkIdType [numLeaves+1];
+  memset(this->LeafOffsets, 0, (numLeaves+1)*sizeof(vtkIdType));
+  for (cellId=0; cellId<numCells; cellId++)
     {
-    if (this->CellBounds)
-      {
-      boundsPtr = this->CellBounds[cellId];
-      }
-    else
+    range = functor.Ranges + 6*cellId;
+    for ( k = range[2]; k <= range[5]; k++ )
       {
-      this->DataSet->GetCellBounds(cellId, cellBounds);
-      }
-    
-    // find min/max locations of bounding box
-    for (i=0; i<3; i++)
-      {
-      ijkMin[i] = static_cast<int>(
-        (boundsPtr[2*i] - this->Bounds[2*i] - hTol[i])/ this->H[i]);
-      ijkMax[i] = static_cast<int>(
-        (boundsPtr[2*i+1] - this->Bounds[2*i] + hTol[i]) / this->H[i]);
-      
-      if (ijkMin[i] < 0)
-        {
-        ijkMin[i] = 0;
-        }
-      if (ijkMax[i] >= ndivs)
+      for ( j = range[1]; j <= range[4]; j++ )
         {
-        ijkMax[i] = ndivs-1;
+        for ( i = range[0]; i <= range[3]; i++ )
+          {
+          this->LeafOffsets[vtkCellLocator::GetLeafIndex(i,j,k)]++;
+          }
         }
       }
-    
-    // each octant inbetween min/max point may have cell in it
-    for ( k = ijkMin[2]; k <= ijkMax[2]; k++ )
+    }
+  for (leaf=1; leaf<=numLeaves; leaf++)
+    {
+    this->LeafOffsets[leaf] += this->LeafOffsets[leaf-1];
+    }
+
+  this->LeafCells = new vtkIdType [this->LeafOffsets[numLeaves]];
+  for (cellId=numCells-1; cellId>=0; cellId--)
+    {
+    range = functor.Ranges + 6*cellId;
+    for ( k = range[2]; k <= range[5]; k++ )
       {
-      for ( j = ijkMin[1]; j <= ijkMax[1]; j++ )
+      for ( j = range[1]; j <= range[4]; j++ )
         {
-        for ( i = ijkMin[0]; i <= ijkMax[0]; i++ )
+        for ( i = range[0]; i <= range[3]; i++ )
           {
-          idx = parentOffset + i + j*ndivs + k*product;
-          this->MarkParents(reinterpret_cast<void*>(VTK_CELL_INSIDE),i,j,k,
-                            ndivs,this->Level);
-          octant = this->Tree[idx];
-          if ( ! octant )
-            {
-            octant = vtkIdList::New();
-            octant->Allocate(numCellsPerBucket,numCellsPerBucket/2);
-            this->Tree[idx] = octant;
-            }
-          octant->InsertNextId(cellId);
+          leaf = vtkCellLocator::GetLeafIndex(i,j,k);
+          this->LeafCells[--this->LeafOffsets[leaf]] = cellId;
           }
         }
       }
-    
-    } //for all cells
-  
+    }
+  delete [] functor.Ranges;
+
   this->BuildTime.Modified();
 }
 
 //----------------------------------------------------------------------------
-void vtkCellLocator::MarkParents(void* a, int i, int j, int k, 
-                                 int ndivs, int level)
+// The file starts with a signature, the sizes needed to check that it can
+// be read on this machine, and the octree parameters; the leaf offsets and
+// cell ids follow as raw arrays.
+static const char vtkCellLocatorSignature[] = "vtkCellLocator 1\n";
+
+int vtkCellLocator::WriteSearchStructure(const char *fileName)
 {
-  int offset, prod, ii;
-  vtkIdType parentIdx;
-  
-  for (offset=0, prod=1, ii=0; ii<level-1; ii++) 
+  if ( !fileName )
     {
-    offset += prod;
-    prod = prod << 3;
+    vtkErrorMacro(<< "No file name specified");
+    return 0;
     }
-  
-  while ( level > 0  )
+
+  this->ForceBuildLocator();
+  if ( !this->LeafOffsets )
     {
-    i = i >> 1;
-    j = j >> 1;
-    k = k >> 1;
-    ndivs = ndivs >> 1;
-    level--;
-    
-    parentIdx = offset + i + j*ndivs + k*ndivs*ndivs;
-    
-    // if it already matches just return
-    if (a == this->Tree[parentIdx])
-      {
-      return;
-      }
-    
-    this->Tree[parentIdx] = static_cast<vtkIdList *>(a);
-    
-    prod = prod >> 3;
-    offset -= prod;
+    vtkErrorMacro(<< "No search structure to write");
+    return 0;
+    }
+
+  ofstream file(fileName, ios::out | ios::binary);
+  if ( !file )
+    {
+    vtkErrorMacro(<< "Cannot open file " << fileName);
+    return 0;
+    }
+
+  int header[4];
+  header[0] = 0x01020304; // byte order
+  header[1] = static_cast<int>(sizeof(vtkIdType));
+  header[2] = this->Level;
+  header[3] = this->NumberOfDivisions;
+  vtkIdType numLeaves = static_cast<vtkIdType>(this->NumberOfDivisions) *
+    this->NumberOfDivisions * this->NumberOfDivisions;
+  vtkIdType counts[2];
+  counts[0] = this->DataSet->GetNumberOfCells();
+  counts[1] = this->LeafOffsets[numLeaves];
+
+  file.write(vtkCellLocatorSignature, sizeof(vtkCellLocatorSignature));
+  file.write(reinterpret_cast<char *>(header), sizeof(header));
+  file.write(reinterpret_cast<char *>(counts), sizeof(counts));
+  file.write(reinterpret_cast<char *>(this->Bounds), sizeof(this->Bounds));
+  file.write(reinterpret_cast<char *>(this->LeafOffsets),
+             (numLeaves+1)*sizeof(vtkIdType));
+  file.write(reinterpret_cast<char *>(this->LeafCells),
+             counts[1]*sizeof(vtkIdType));
+  if ( !file )
+    {
+    vtkErrorMacro(<< "Error writing file " << fileName);
+    return 0;
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkCellLocator::ReadSearchStructure(const char *fileName)
+{
+  if ( !fileName )
+    {
+    vtkErrorMacro(<< "No file name specified");
+    return 0;
+    }
+  if ( !this->DataSet )
+    {
+    vtkErrorMacro(<< "The data set must be set before reading its locator");
+    return 0;
+    }
+
+  ifstream file(fileName, ios::in | ios::binary);
+  if ( !file )
+    {
+    vtkErrorMacro(<< "Cannot open file " << fileName);
+    return 0;
+    }
+
+  char signature[sizeof(vtkCellLocatorSignature)];
+  int header[4];
+  vtkIdType counts[2];
+  double bounds[6];
+  file.read(signature, sizeof(signature));
+  file.read(reinterpret_cast<char *>(header), sizeof(header));
+  file.read(reinterpret_cast<char *>(counts), sizeof(counts));
+  file.read(reinterpret_cast<char *>(bounds), sizeof(bounds));
+  if ( !file || memcmp(signature, vtkCellLocatorSignature,
+                       sizeof(signature)) != 0 )
+    {
+    vtkErrorMacro(<< fileName << " is not a cell locator file");
+    return 0;
+    }
+  if ( header[0] != 0x01020304 ||
+       header[1] != static_cast<int>(sizeof(vtkIdType)) )
+    {
+    vtkErrorMacro(<< fileName << " was written on an incompatible machine");
+    return 0;
+    }
+  if ( header[2] < 0 || header[2] > 10 || header[3] != (1 << header[2]) )
+    {
+    vtkErrorMacro(<< fileName << " has an invalid octree");
+    return 0;
+    }
+  if ( counts[0] != this->DataSet->GetNumberOfCells() )
+    {
+    vtkErrorMacro(<< fileName << " is for a data set with " << counts[0]
+                  << " cells, not " << this->DataSet->GetNumberOfCells());
+    return 0;
+    }
+
+  // The offsets and cell ids must be all that is left in the file.
+  int ndivs = header[3];
+  vtkIdType numLeaves = static_cast<vtkIdType>(ndivs) * ndivs * ndivs;
+  vtkIdType dataStart = static_cast<vtkIdType>(file.tellg());
+  file.seekg(0, ios::end);
+  vtkIdType dataSize = static_cast<vtkIdType>(file.tellg()) - dataStart;
+  file.seekg(dataStart, ios::beg);
+  if ( counts[1] < 0 ||
+       dataSize != (numLeaves + 1 + counts[1]) *
+       static_cast<vtkIdType>(sizeof(vtkIdType)) )
+    {
+    vtkErrorMacro(<< fileName << " has an invalid size");
+    return 0;
+    }
+
+  vtkIdType *leafOffsets = new vtkIdType [numLeaves+1];
+  vtkIdType *leafCells = new vtkIdType [counts[1]];
+  file.read(reinterpret_cast<char *>(leafOffsets),
+            (numLeaves+1)*sizeof(vtkIdType));
+  file.read(reinterpret_cast<char *>(leafCells), counts[1]*sizeof(vtkIdType));
+  int valid = (file && leafOffsets[0] == 0 &&
+               leafOffsets[numLeaves] == counts[1]);
+  vtkIdType i;
+  for (i=0; valid && i < numLeaves; i++)
+    {
+    valid = (leafOffsets[i] <= leafOffsets[i+1]);
     }
+  for (i=0; valid && i < counts[1]; i++)
+    {
+    valid = (leafCells[i] >= 0 && leafCells[i] < counts[0]);
+    }
+  if ( !valid )
+    {
+    vtkErrorMacro(<< "Error reading file " << fileName);
+    delete [] leafOffsets;
+    delete [] leafCells;
+    return 0;
+    }
+
+  this->FreeSearchStructure();
+  this->FreeCellBounds();
+  if ( this->CellHasBeenVisited )
+    {
+    delete [] this->CellHasBeenVisited;
+    }
+  this->LeafOffsets = leafOffsets;
+  this->LeafCells = leafCells;
+  this->Level = header[2];
+  this->NumberOfDivisions = ndivs;
+  this->NumberOfOctants = static_cast<int>((8*numLeaves - 1) / 7);
+  for (i=0; i<3; i++)
+    {
+    this->Bounds[2*i] = bounds[2*i];
+    this->Bounds[2*i+1] = bounds[2*i+1];
+    this->H[i] = (this->Bounds[2*i+1] - this->Bounds[2*i]) / ndivs;
+    }
+
+  this->CellHasBeenVisited = new unsigned char [ counts[0] ];
+  this->ClearCellHasBeenVisited();
+  this->QueryNumber = 0;
+  if (this->CacheCellBounds)
+    {
+    this->StoreCellBounds();
+    }
+
+  this->BuildTime.Modified();
+  return 1;
 }
 
 //----------------------------------------------------------------------------
@@ -1391,13 +1561,12 @@ void vtkCellLocator::GenerateRepresentation(int level, vtkPolyData *pd)
   vtkPoints *pts;
   vtkCellArray *polys;
   int l, i, j, k, ii, boundary[3];
-  vtkIdType idx = 0;
-  vtkIdList *inside, *Inside[3];
+  int inside, Inside[3];
   int numDivs=1;
 
   this->BuildLocatorIfNeeded();
 
-  if ( this->Tree == NULL )
+  if ( this->LeafOffsets == NULL )
     {
     vtkErrorMacro(<<"No tree to generate representation from");
     return;
@@ -1408,21 +1577,16 @@ void vtkCellLocator::GenerateRepresentation(int level, vtkPolyData *pd)
   polys = vtkCellArray::New();
   polys->Allocate(10000);
 
-  // Compute idx into tree at appropriate level; determine if
+  // Compute divisions at appropriate level; determine if
   // faces of octants are visible.
   //
-  int parentIdx = 0;
-  int numOctants = 1;
-  
-  if ( level < 0 )
+  if ( level < 0 || level > this->Level )
     {
     level = this->Level;
     }
   for (l=0; l < level; l++)
     {
     numDivs *= 2;
-    parentIdx += numOctants;
-    numOctants *= 8;
     }
   
   //loop over all octabts generating visible faces
@@ -1432,20 +1596,19 @@ void vtkCellLocator::GenerateRepresentation(int level, vtkPolyData *pd)
       {
       for ( i=0; i < numDivs; i++)
         {
-        this->GenerateIndex(parentIdx,numDivs,i,j,k,idx);
-        inside = this->Tree[idx];
+        inside = !this->IsOctantEmpty(level,i,j,k);
         
-        if ( !(boundary[0]=this->GenerateIndex(parentIdx,numDivs,i-1,j,k,idx)))
+        if ( !(boundary[0] = (i == 0)) )
           {
-          Inside[0] = this->Tree[idx];
+          Inside[0] = !this->IsOctantEmpty(level,i-1,j,k);
           }
-        if ( !(boundary[1]=this->GenerateIndex(parentIdx,numDivs,i,j-1,k,idx)))
+        if ( !(boundary[1] = (j == 0)) )
           {
-          Inside[1] = this->Tree[idx];
+          Inside[1] = !this->IsOctantEmpty(level,i,j-1,k);
           }
-        if ( !(boundary[2]=this->GenerateIndex(parentIdx,numDivs,i,j,k-1,idx)))
+        if ( !(boundary[2] = (k == 0)) )
           {
-          Inside[2] = this->Tree[idx];
+          Inside[2] = !this->IsOctantEmpty(level,i,j,k-1);
           }
         
         for (ii=0; ii < 3; ii++)
@@ -1673,17 +1836,14 @@ vtkIdType vtkCellLocator::FindCell(
   double x[3], double vtkNotUsed(tol2), vtkGenericCell *cell, 
   double pcoords[3], double *weights)
 {
-  vtkIdList *cellIds;
   int ijk[3];
   int subId;
   double closestPoint[3], dist2;
   double cellBounds[6];
+  vtkIdType leaf;
   
   this->BuildLocatorIfNeeded();
 
-  int leafStart = this->NumberOfOctants
-    - this->NumberOfDivisions*this->NumberOfDivisions*this->NumberOfDivisions;
-
   // Find bucket point is in.  
   //
   for (int j=0; j<3; j++) 
@@ -1702,15 +1862,14 @@ vtkIdType vtkCellLocator::FindCell(
   
   // Search the bucket that the point is in.
   //
-  if ((cellIds = 
-      this->Tree[leafStart + ijk[0] + ijk[1]*this->NumberOfDivisions + 
-      ijk[2]*this->NumberOfDivisions*this->NumberOfDivisions]) != NULL )
+  leaf = vtkCellLocator::GetLeafIndex(ijk[0], ijk[1], ijk[2]);
+  if ( !this->IsLeafEmpty(leaf) )
     {
     // query each cell
-    for (int j=0; j < cellIds->GetNumberOfIds(); j++) 
+    for (vtkIdType j=this->LeafOffsets[leaf]; j < this->LeafOffsets[leaf+1]; j++)
       {
       // get the cell
-      int cellId = cellIds->GetId(j);
+      vtkIdType cellId = this->LeafCells[j];
       // check whether we could be close enough to the cell by
       // testing the cell bounds
       if (this->CacheCellBounds)
@@ -1782,22 +1941,19 @@ void vtkCellLocator::FindCellsWithinBounds(double *bbox, vtkIdList *cells)
     }
   
   // Now loop over block to load in ids
-  int leafStart = this->NumberOfOctants
-    - this->NumberOfDivisions*this->NumberOfDivisions*this->NumberOfDivisions;
-  vtkIdList *cellIds;
-  vtkIdType idx;
+  vtkIdType leaf, idx;
   for (k=ijk[0][2]; k <= ijk[1][2]; k++)
     {
     for (j=ijk[0][1]; j <= ijk[1][1]; j++)
       {
       for (i=ijk[0][0]; i <= ijk[1][0]; i++)
         {
-        if ( (cellIds = this->Tree[leafStart + i + j*this->NumberOfDivisions + 
-                                  k*this->NumberOfDivisions*this->NumberOfDivisions]) != NULL )
+        leaf = vtkCellLocator::GetLeafIndex(i, j, k);
+        if ( !this->IsLeafEmpty(leaf) )
           {
-          for ( idx=0; idx < cellIds->GetNumberOfIds(); idx++)
+          for ( idx=this->LeafOffsets[leaf]; idx < this->LeafOffsets[leaf+1]; idx++)
             {
-            cells->InsertUniqueId( cellIds->GetId(idx) );
+            cells->InsertUniqueId( this->LeafCells[idx] );
             }
           }
         }
@@ -1822,9 +1978,9 @@ void vtkCellLocator::FindCellsAlongLine(double p1[3], double p2[3], double vtkNo
   int hitCellBounds;
   double result;
   double bounds2[6];
-  int i, leafStart, prod, loop;
+  int i, loop;
   vtkIdType cellId, cId;
-  int idx;
+  vtkIdType leaf;
   double tMax, dist[3];
   int npos[3];
   int pos[3];
@@ -1860,8 +2016,6 @@ void vtkCellLocator::FindCellsAlongLine(double p1[3], double p2[3], double vtkNo
   if (vtkBox::IntersectBox(bounds2, origin, direction2, hitPosition, result))
     {
     // start walking through the octants
-    prod = this->NumberOfDivisions*this->NumberOfDivisions;
-    leafStart = this->NumberOfOctants - this->NumberOfDivisions*prod;
     
     // Clear the array that indicates whether we have visited this cell.
     // The array is only cleared when the query number rolls over.  This
@@ -1894,22 +2048,20 @@ void vtkCellLocator::FindCellsAlongLine(double p1[3], double p2[3], double vtkNo
         }
       }
     
-    idx = leafStart + pos[0] - 1 + (pos[1] - 1)*this->NumberOfDivisions 
-      + (pos[2] - 1)*prod;
-    
     while ( (pos[0] > 0) && (pos[1] > 0) && (pos[2] > 0) &&
       (pos[0] <= this->NumberOfDivisions) &&
       (pos[1] <= this->NumberOfDivisions) &&
       (pos[2] <= this->NumberOfDivisions) &&
       (currDist < stopDist))
       {
-      if (this->Tree[idx])
+      leaf = vtkCellLocator::GetLeafIndex(pos[0]-1,pos[1]-1,pos[2]-1);
+      if (!this->IsLeafEmpty(leaf))
         {
         this->ComputeOctantBounds(pos[0]-1,pos[1]-1,pos[2]-1);
-        for (tMax = VTK_DOUBLE_MAX, cellId=0; 
-        cellId < this->Tree[idx]->GetNumberOfIds(); cellId++) 
+        for (tMax = VTK_DOUBLE_MAX, cellId=this->LeafOffsets[leaf];
+        cellId < this->LeafOffsets[leaf+1]; cellId++)
           {
-          cId = this->Tree[idx]->GetId(cellId);
+          cId = this->LeafCells[cellId];
           if (this->CellHasBeenVisited[cId] != this->QueryNumber)
             {
             this->CellHasBeenVisited[cId] = this->QueryNumber;
@@ -1989,9 +2141,6 @@ void vtkCellLocator::FindCellsAlongLine(double p1[3], double p2[3], double vtkNo
       // now make the move, find the smallest distance
       // only cross one boundry at a time
       pos[bestDir] = npos[bestDir];
-      
-      idx = leafStart + pos[0] - 1 + (pos[1]-1)*this->NumberOfDivisions + 
-        (pos[2]-1)*prod;
       }
     }
 }
@@ -22,6 +22,12 @@
 // inside of it.)  Typical operations are intersection with a line to return
 // candidate cells, or intersection with another vtkCellLocator to return
 // candidate cells.
+//
+// The octree is stored linearly: the leaf octants are kept in Morton
+// (z-curve) order and their cell lists are packed in one array, so the
+// leaves below any octant form a contiguous range.  The search structure
+// can be written to a file and read back for the same data set, which
+// avoids rebuilding the locator of a static mesh.
 
 // .SECTION Caveats
 // Many other types of spatial locators have been developed, such as 
@@ -178,7 +184,8 @@ public:
     int &subId, double& dist2, int &inside);
   
   // Description:
-  // Get the cells in a particular bucket.
+  // Get the cells in a particular bucket.  Returns NULL for empty and
+  // non-leaf buckets.  The returned list is reused by the next call.
   virtual vtkIdList *GetCells(int bucket);
 
   // Description:
@@ -223,11 +230,30 @@ public:
   virtual void ForceBuildLocator();
   virtual void BuildLocatorInternal();
   virtual void GenerateRepresentation(int level, vtkPolyData *pd);
+
+  // Description:
+  // Write the search structure to a file, building it first if needed.
+  // The file is meant to be read back by ReadSearchStructure() on the
+  // same machine for the same data set.  Returns 1 on success.
+  int WriteSearchStructure(const char *fileName);
+
+  // Description:
+  // Read a search structure written by WriteSearchStructure() instead of
+  // building it.  The data set must be set and be the one the file was
+  // written for; only its number of cells is checked.  Returns 1 on
+  // success.
+  int ReadSearchStructure(const char *fileName);
   
 protected:
   vtkCellLocator();
   ~vtkCellLocator();
 
+  // Description:
+  // FindCell() only reads the buckets; the other queries mark visited
+  // cells in the locator.
+  virtual int IsQueryThreadSafe(int query)
+    { return query == vtkAbstractCellLocator::FIND_CELL; }
+
   void GetBucketNeighbors(int ijk[3], int ndivs, int level);
   void GetOverlappingBuckets(double x[3], int ijk[3], double dist, 
                              int prevMinLevel[3], int prevMaxLevel[3]);
@@ -243,12 +269,39 @@ protected:
   int NumberOfParents; // number of parent octants
   double H[3]; // width of leaf octant in x-y-z directions
   int NumberOfDivisions; // number of "leaf" octant sub-divisions
-  vtkIdList **Tree; // octree
 
-  void MarkParents(void*, int, int, int, int, int);
-  void GetChildren(int idx, int level, int children[8]);
-  int GenerateIndex(int offset, int numDivs, int i, int j, int k,
-                    vtkIdType &idx);
+  // The cells of leaf octant l are LeafCells[LeafOffsets[l]] up to
+  // LeafCells[LeafOffsets[l+1]], in increasing order.  Leaves are numbered
+  // in Morton order, see GetLeafIndex().
+  vtkIdType *LeafOffsets;
+  vtkIdType *LeafCells;
+  vtkIdList *BucketCells; // returned by GetCells()
+
+  // Description:
+  // Return the Morton index of the leaf octant (i,j,k) by interleaving the
+  // bits of i, j and k.  Supports up to 10 levels.
+  static vtkIdType GetLeafIndex(int i, int j, int k)
+    {
+    return vtkCellLocator::SpreadBits(i) |
+      (vtkCellLocator::SpreadBits(j) << 1) |
+      (vtkCellLocator::SpreadBits(k) << 2);
+    }
+  static vtkIdType SpreadBits(int i)
+    {
+    unsigned int x = static_cast<unsigned int>(i) & 0x3ff;
+    x = (x | (x << 16)) & 0x030000ff;
+    x = (x | (x << 8)) & 0x0300f00f;
+    x = (x | (x << 4)) & 0x030c30c3;
+    x = (x | (x << 2)) & 0x09249249;
+    return static_cast<vtkIdType>(x);
+    }
+  int IsLeafEmpty(vtkIdType leaf)
+    { return this->LeafOffsets[leaf] == this->LeafOffsets[leaf+1]; }
+
+  // Description:
+  // Return whether octant (i,j,k) of the given level holds no cells.
+  int IsOctantEmpty(int level, int i, int j, int k);
+
   void GenerateFace(int face, int numDivs, int i, int j, int k,
                     vtkPoints *pts, vtkCellArray *polys);
 
@@ -17,7 +17,10 @@
 #include "vtkMath.h"
 #include "vtkDataSet.h"
 #include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkGenericCell.h"
 #include "vtkCellLocator.h"
 #include "vtkSmartPointer.h"
@@ -221,6 +224,110 @@ int vtkCellLocatorInterpolatedVelocityField::FunctionValues
   return  bFound;
 }
 
+//----------------------------------------------------------------------------
+vtkIdType vtkCellLocatorInterpolatedVelocityField::FunctionValuesAtPoints
+  ( vtkPoints * points, vtkDoubleArray * f )
+{
+  vtkIdType numPts = points->GetNumberOfPoints();
+  f->SetNumberOfComponents( 3 );
+  f->SetNumberOfTuples( numPts );
+  double * fPtr = f->GetPointer( 0 );
+  for ( vtkIdType i = 0; i < 3 * numPts; i ++ )
+    {
+    fPtr[i] = 0.0;
+    }
+
+  // the points not located yet, and their index in points
+  vtkSmartPointer< vtkPoints > remaining = points;
+  vtkSmartPointer< vtkIdList > remainingIds = vtkSmartPointer< vtkIdList >::New();
+  remainingIds->SetNumberOfIds( numPts );
+  for ( vtkIdType i = 0; i < numPts; i ++ )
+    {
+    remainingIds->SetId( i, i );
+    }
+
+  vtkIdType numFound = 0;
+  vtkSmartPointer< vtkIdList > cellIds  = vtkSmartPointer< vtkIdList >::New();
+  vtkSmartPointer< vtkIdList > cellPts  = vtkSmartPointer< vtkIdList >::New();
+  vtkSmartPointer< vtkDoubleArray > weights = 
+    vtkSmartPointer< vtkDoubleArray >::New();
+  for ( size_t d = 0; 
+        d < this->DataSets->size() && remainingIds->GetNumberOfIds() > 0; d ++ )
+    {
+    vtkDataSet *             ds  = ( *this->DataSets )[d];
+    vtkAbstractCellLocator * loc = ( *this->CellLocators )[d].GetPointer();
+    vtkDataArray * vectors = 
+      ds->GetPointData()->GetVectors( this->VectorsSelection );
+    if ( !vectors )
+      {
+      continue;
+      }
+    double toler2 = ds->GetLength() * 
+      vtkCellLocatorInterpolatedVelocityField::TOLERANCE_SCALE;
+    vtkIdType numRemaining = remainingIds->GetNumberOfIds();
+    
+    if ( loc )
+      {
+      loc->FindCells( remaining, toler2, cellIds, NULL, weights );
+      }
+    else
+      {
+      // vtkImageData and vtkRectilinearGrid locate their cells directly
+      int    subIdx;
+      double x[3], pcoords[3];
+      vtkSmartPointer< vtkGenericCell > cell = 
+        vtkSmartPointer< vtkGenericCell >::New();
+      weights->SetNumberOfComponents( ds->GetMaxCellSize() );
+      weights->SetNumberOfTuples( numRemaining );
+      cellIds->SetNumberOfIds( numRemaining );
+      for ( vtkIdType j = 0; j < numRemaining; j ++ )
+        {
+        remaining->GetPoint( j, x );
+        cellIds->SetId( j, ds->FindCell( x, 0, cell, -1, toler2, subIdx, 
+                                         pcoords, weights->GetPointer( j *
+                                         weights->GetNumberOfComponents() ) ) );
+        }
+      }
+
+    // interpolate the located points, keep the others for the next dataset
+    vtkSmartPointer< vtkPoints > missed = vtkSmartPointer< vtkPoints >::New();
+    missed->SetDataTypeToDouble();
+    vtkSmartPointer< vtkIdList > missedIds = vtkSmartPointer< vtkIdList >::New();
+    int numWeights = weights->GetNumberOfComponents();
+    for ( vtkIdType j = 0; j < numRemaining; j ++ )
+      {
+      vtkIdType cellId = cellIds->GetId( j );
+      if ( cellId < 0 )
+        {
+        missed->InsertNextPoint( remaining->GetPoint( j ) );
+        missedIds->InsertNextId( remainingIds->GetId( j ) );
+        continue;
+        }
+        
+      double * w   = weights->GetPointer( j * numWeights );
+      double * vel = fPtr + 3 * remainingIds->GetId( j );
+      double   vector[3];
+      ds->GetCellPoints( cellId, cellPts );
+      for ( vtkIdType i = 0; i < cellPts->GetNumberOfIds(); i ++ )
+        {
+        vectors->GetTuple( cellPts->GetId( i ), vector );
+        vel[0] += vector[0] * w[i];
+        vel[1] += vector[1] * w[i];
+        vel[2] += vector[2] * w[i];
+        }
+      if ( this->NormalizeVector == true )
+        {
+        vtkMath::Normalize( vel );
+        }
+      numFound ++;
+      }
+    remaining    = missed;
+    remainingIds = missedIds;
+    }
+
+  return numFound;
+}
+
 //----------------------------------------------------------------------------
 void vtkCellLocatorInterpolatedVelocityField::AddDataSet( vtkDataSet * dataset )
 {
@@ -272,6 +379,49 @@ void vtkCellLocatorInterpolatedVelocityField::AddDataSet( vtkDataSet * dataset )
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkCellLocatorInterpolatedVelocityField::ShareDataSets
+  ( vtkAbstractInterpolatedVelocityField * from )
+{
+  vtkCellLocatorInterpolatedVelocityField * other = 
+    vtkCellLocatorInterpolatedVelocityField::SafeDownCast( from );
+  if ( !other )
+    {
+    this->Superclass::ShareDataSets( from );
+    return;
+    }
+
+  for ( size_t i = 0; i < other->DataSets->size(); i ++ )
+    {
+    vtkDataSet * dataset = ( *other->DataSets )[i];
+    vtkAbstractCellLocator * locator = ( *other->CellLocators )[i];
+    vtkAbstractInterpolatedVelocityField::PrepareDataSet( dataset );
+    if ( locator && dataset->GetNumberOfPoints() > 0 )
+      {
+      // a query builds a lazily evaluated locator, do it here rather than
+      // concurrently in the threads
+      double x[3];
+      dataset->GetPoint( 0, x );
+      locator->BuildLocator();
+      locator->FindCell( x );
+      }
+
+    this->DataSets->push_back( dataset );
+    this->CellLocators->push_back( locator );
+    
+    int  size = dataset->GetMaxCellSize();
+    if ( size > this->WeightsSize )
+      {
+      this->WeightsSize = size;
+      if ( this->Weights )
+        {
+        delete[] this->Weights;
+        }
+      this->Weights = new double[size];
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkCellLocatorInterpolatedVelocityField::CopyParameters
   ( vtkAbstractInterpolatedVelocityField * from )
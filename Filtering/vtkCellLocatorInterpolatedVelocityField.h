@@ -50,6 +50,8 @@
 
 class vtkAbstractCellLocator;
 class vtkCellLocatorInterpolatedVelocityFieldCellLocatorsType;
+class vtkDoubleArray;
+class vtkPoints;
 
 class VTK_FILTERING_EXPORT vtkCellLocatorInterpolatedVelocityField : public vtkAbstractInterpolatedVelocityField
 {
@@ -88,10 +90,24 @@ public:
   // evaluation point is searched in all until a match is found. THIS FUNCTION
   // DOES NOT CHANGE THE REFERENCE COUNT OF dataset FOR THREAD SAFETY REASONS.
   virtual void AddDataSet( vtkDataSet * dataset );
+
+  // Description:
+  // Add the datasets of another function together with its cell locators,
+  // which are built here if they are lazily evaluated.
+  virtual void ShareDataSets( vtkAbstractInterpolatedVelocityField * from );
   
   // Description:
   // Evaluate the velocity field f at point (x, y, z).
   virtual int FunctionValues( double * x, double * f );
+
+  // Description:
+  // Evaluate the velocity field at each of the points. f receives three
+  // components per point, zero for points outside all the datasets. The
+  // points of each dataset are located together with the batched
+  // vtkAbstractCellLocator::FindCells(), on several threads when the
+  // locator allows it. The cached cell is neither used nor changed.
+  // Returns the number of points at which the field was evaluated.
+  vtkIdType FunctionValuesAtPoints( vtkPoints * points, vtkDoubleArray * f );
   
   // Description:
   // Set the cell id cached by the last evaluation within a specified dataset.
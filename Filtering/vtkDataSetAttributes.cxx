@@ -726,15 +726,42 @@ void vtkDataSetAttributes::InterpolatePoint(vtkDataSetAttributes *fromPd,
                                             vtkIdType toId, vtkIdList *ptIds, 
                                             double *weights)
 {
-  int i;
-  for(i=this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End(); 
-      i=this->RequiredArrays.NextIndex())
+  // Walk the list of required arrays without moving the iterator so that
+  // this can be called from several threads at once.
+  int numRequired = this->RequiredArrays.GetListSize();
+  for(int j=0; j < numRequired; j++)
     {
+    int i = this->RequiredArrays.GetListItem(j);
     vtkAbstractArray* fromArray = this->Data[this->TargetIndices[i]];    
     fromArray->InterpolateTuple(toId, ptIds, fromPd->Data[i], weights);
     }
 }
 
+//--------------------------------------------------------------------------
+int vtkDataSetAttributes::PrepareThreadedInterpolation(
+  vtkIdType numberOfTuples)
+{
+  int i, j;
+  int numRequired = this->RequiredArrays.GetListSize();
+  for(j=0; j < numRequired; j++)
+    {
+    i = this->RequiredArrays.GetListItem(j);
+    this->Data[this->TargetIndices[i]]->SetNumberOfTuples(numberOfTuples);
+    }
+
+  // Bits share bytes with their neighbors, and the other array types
+  // may reallocate on every write.
+  for(i=0; i < this->GetNumberOfArrays(); i++)
+    {
+    vtkDataArray* da = vtkDataArray::SafeDownCast(this->Data[i]);
+    if (!da || da->GetDataType() == VTK_BIT)
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
 //--------------------------------------------------------------------------
 // Interpolate data from the two points p1,p2 (forming an edge) and an 
 // interpolation factor, t, along the edge. The weight ranges from (0,1), 
@@ -767,6 +794,99 @@ void vtkDataSetAttributes::InterpolateEdge(vtkDataSetAttributes *fromPd,
     }
 }
 
+//--------------------------------------------------------------------------
+template <class T>
+void vtkDataSetAttributesInterpolateEdges(const T *from, T *to, int numComp,
+                                          vtkIdType numEdges,
+                                          const vtkIdType *edges,
+                                          const double *t, int nearest)
+{
+  for (vtkIdType i=0; i < numEdges; i++, to += numComp)
+    {
+    if ( edges[2*i] < 0 )
+      {
+      continue;
+      }
+    const T *from1 = from + edges[2*i]*numComp;
+    const T *from2 = from + edges[2*i+1]*numComp;
+    double w = t[i];
+    if ( nearest )
+      {
+      w = (w < 0.5) ? 0.0 : 1.0;
+      }
+    for (int k=0; k < numComp; k++)
+      {
+      double c = (1.0 - w) * static_cast<double>(from1[k])
+        + w * static_cast<double>(from2[k]);
+      to[k] = static_cast<T>(c);
+      }
+    }
+}
+
+//--------------------------------------------------------------------------
+// Interpolate the data of consecutive points, each from an edge and an
+// interpolation factor, one array at a time.
+void vtkDataSetAttributes::InterpolateEdges(vtkDataSetAttributes *fromPd,
+                                            vtkIdType toId,
+                                            vtkIdType numEdges,
+                                            const vtkIdType *edges,
+                                            const double *t)
+{
+  if ( numEdges < 1 )
+    {
+    return;
+    }
+
+  int i;
+  for(i=this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End(); 
+      i=this->RequiredArrays.NextIndex())
+    {
+    vtkAbstractArray* fromArray = fromPd->Data[i];
+    vtkAbstractArray* toArray = this->Data[this->TargetIndices[i]];
+
+    //check if the destination array needs nearest neighbor interpolation
+    int attributeIndex = this->IsArrayAnAttribute(this->TargetIndices[i]);
+    int nearest = (attributeIndex != -1 &&
+                   this->CopyAttributeFlags[INTERPOLATE][attributeIndex]==2);
+
+    vtkDataArray* fromData = vtkDataArray::SafeDownCast(fromArray);
+    vtkDataArray* toData = vtkDataArray::SafeDownCast(toArray);
+    int type = toArray->GetDataType();
+    if ( fromData && toData && type == fromData->GetDataType() &&
+         type != VTK_BIT )
+      {
+      // Note that we must call WriteVoidPointer before GetVoidPointer
+      // in case WriteVoidPointer reallocates memory and fromData==toData.
+      int numComp = toData->GetNumberOfComponents();
+      void* vto = toData->WriteVoidPointer(toId*numComp, numEdges*numComp);
+      void* vfrom = fromData->GetVoidPointer(0);
+      switch (type)
+        {
+        vtkTemplateMacro(
+          vtkDataSetAttributesInterpolateEdges(
+            static_cast<VTK_TT*>(vfrom), static_cast<VTK_TT*>(vto),
+            numComp, numEdges, edges, t, nearest));
+        }
+      }
+    else
+      {
+      for (vtkIdType j=0; j < numEdges; j++)
+        {
+        if ( edges[2*j] >= 0 )
+          {
+          double w = t[j];
+          if ( nearest )
+            {
+            w = (w < 0.5) ? 0.0 : 1.0;
+            }
+          toArray->InterpolateTuple(toId+j, edges[2*j], fromArray,
+                                    edges[2*j+1], fromArray, w);
+          }
+        }
+      }
+    }
+}
+
 //--------------------------------------------------------------------------
 // Interpolate data from the two points p1,p2 (forming an edge) and an 
 // interpolation factor, t, along the edge. The weight ranges from (0,1), 
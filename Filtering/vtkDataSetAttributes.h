@@ -481,6 +481,15 @@ public:
   // If the flag is set to 2, nearest neighbor interpolation is used.
   void InterpolatePoint(vtkDataSetAttributes *fromPd, vtkIdType toId, 
                         vtkIdList *ids, double *weights);
+
+  // Description:
+  // Size the arrays written by InterpolatePoint() to numberOfTuples, so
+  // that InterpolatePoint() no longer grows them.  Returns 1 if
+  // InterpolatePoint() (and NullPoint() on point data) may then be called
+  // for different ids from several threads at once, or 0 if some array
+  // does not support that (bit arrays and non-numeric arrays).  Call
+  // after InterpolateAllocate().
+  int PrepareThreadedInterpolation(vtkIdType numberOfTuples);
   
   // Description:
   // Interpolate data from the two points p1,p2 (forming an edge) and an 
@@ -493,6 +502,18 @@ public:
   void InterpolateEdge(vtkDataSetAttributes *fromPd, vtkIdType toId,
                        vtkIdType p1, vtkIdType p2, double t);
 
+  // Description:
+  // Interpolate the data of numEdges consecutive points starting at toId,
+  // point toId+i from the edge (edges[2*i],edges[2*i+1]) at the
+  // interpolation factor t[i], as InterpolateEdge() does. The arrays are
+  // processed one at a time, which is faster than interpolating point by
+  // point. Points whose edge starts with a negative id are skipped. Make
+  // sure that the method InterpolateAllocate() has been invoked before
+  // using this method.
+  void InterpolateEdges(vtkDataSetAttributes *fromPd, vtkIdType toId,
+                        vtkIdType numEdges, const vtkIdType *edges,
+                        const double *t);
+
   // Description:
   // Interpolate data from the same id (point or cell) at different points
   // in time (parameter t). Two input data set attributes objects are input.
@@ -34,6 +34,7 @@
 #include "vtkInstantiator.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkTimerLog.h"
 
 #include <vtkstd/vector>
 
@@ -48,6 +49,20 @@ vtkInformationKeyMacro(vtkDemandDrivenPipeline, REQUEST_DATA_OBJECT, Request);
 vtkInformationKeyMacro(vtkDemandDrivenPipeline, REQUEST_INFORMATION, Request);
 vtkInformationKeyMacro(vtkDemandDrivenPipeline, REQUEST_REGENERATE_INFORMATION, Integer);
 
+static int vtkDemandDrivenPipelineGlobalTimerLogEvents = 0;
+
+//----------------------------------------------------------------------------
+void vtkDemandDrivenPipeline::SetGlobalTimerLogEvents(int val)
+{
+  vtkDemandDrivenPipelineGlobalTimerLogEvents = val;
+}
+
+//----------------------------------------------------------------------------
+int vtkDemandDrivenPipeline::GetGlobalTimerLogEvents()
+{
+  return vtkDemandDrivenPipelineGlobalTimerLogEvents;
+}
+
 //----------------------------------------------------------------------------
 vtkDemandDrivenPipeline::vtkDemandDrivenPipeline()
 {
@@ -501,6 +516,13 @@ int vtkDemandDrivenPipeline::ExecuteData(vtkInformation* request,
                                          vtkInformationVector** inInfo,
                                          vtkInformationVector* outInfo)
 {
+  // Bracket the execution in the timer log so that it shows up, per
+  // thread, in vtkTimerLog::DumpTraceEvents.
+  int timerLogEvents = vtkDemandDrivenPipelineGlobalTimerLogEvents;
+  if(timerLogEvents)
+    {
+    vtkTimerLog::MarkStartEvent(this->Algorithm->GetClassName());
+    }
   this->ExecuteDataStart(request, inInfo, outInfo);
   // Invoke the request on the algorithm.
 //   unsigned long mTimeBefore = this->Algorithm->GetMTime();
@@ -514,6 +536,10 @@ int vtkDemandDrivenPipeline::ExecuteData(vtkInformation* request,
 //                     << "executions");
 //     }
   this->ExecuteDataEnd(request, inInfo, outInfo);
+  if(timerLogEvents)
+    {
+    vtkTimerLog::MarkEndEvent(this->Algorithm->GetClassName());
+    }
 
   return result;
 }
@@ -135,6 +135,18 @@ public:
   // passes when you modification time should not be taken into account.
   static vtkInformationIntegerKey* REQUEST_REGENERATE_INFORMATION();
 
+  // Description:
+  // When on, each algorithm execution is bracketed by start and end events
+  // in the vtkTimerLog, named after the algorithm class, so that it shows
+  // up per thread in vtkTimerLog::DumpTraceEvents().  This applies to all
+  // pipelines.  Off by default.
+  static void SetGlobalTimerLogEvents(int val);
+  static void GlobalTimerLogEventsOn()
+    {vtkDemandDrivenPipeline::SetGlobalTimerLogEvents(1);}
+  static void GlobalTimerLogEventsOff()
+    {vtkDemandDrivenPipeline::SetGlobalTimerLogEvents(0);}
+  static int GetGlobalTimerLogEvents();
+
 protected:
   vtkDemandDrivenPipeline();
   ~vtkDemandDrivenPipeline();
@@ -437,6 +437,10 @@ public:
       {
         return this->List[this->Position];
       }
+    int GetListItem(int i) const
+      {
+        return this->List[i];
+      }
     int BeginIndex()
       {
         this->Position = -1;
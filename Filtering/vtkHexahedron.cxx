@@ -417,12 +417,12 @@ void vtkHexahedron::Contour(double value, vtkDataArray *cellScalars,
         {
         x[j] = x1[j] + t * (x2[j] - x1[j]);
         }
-      if ( locator->InsertUniquePoint(x, pts[i]) )
+      vtkIdType p1 = this->PointIds->GetId(v1);
+      vtkIdType p2 = this->PointIds->GetId(v2);
+      if ( locator->InsertUniqueEdgePoint(p1, p2, t, x, pts[i]) )
         {
         if ( outPd ) 
           {
-          vtkIdType p1 = this->PointIds->GetId(v1);
-          vtkIdType p2 = this->PointIds->GetId(v2);
           outPd->InterpolateEdge(inPd,pts[i],p1,p2,t);
           }
         }
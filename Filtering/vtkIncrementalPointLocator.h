@@ -106,6 +106,18 @@ public:
   // This method is not thread safe.
   virtual int InsertUniquePoint( const double x[3], vtkIdType & ptId ) = 0;
   
+  // Description:
+  // Insert a point x interpolated at parametric coordinate t on the edge 
+  // from input point p1 to input point p2 unless there has been a duplicate.
+  // Linear cells call this while contouring so that a locator can merge the
+  // points by input edge (see vtkMergeEdgePoints). By default the edge is 
+  // ignored and the point is merged via InsertUniquePoint().
+  virtual int InsertUniqueEdgePoint( vtkIdType vtkNotUsed( p1 ),
+                                     vtkIdType vtkNotUsed( p2 ),
+                                     double vtkNotUsed( t ),
+                                     const double x[3], vtkIdType & ptId )
+    { return this->InsertUniquePoint( x, ptId ); }
+  
   // Description:
   // Insert a given point with a specified point index ptId. InitPointInsertion()
   // should have been called prior to this function. Also, IsInsertedPoint()
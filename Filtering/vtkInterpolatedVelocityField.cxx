@@ -14,14 +14,61 @@
 =========================================================================*/
 #include "vtkInterpolatedVelocityField.h"
 
+#include "vtkDataArray.h"
 #include "vtkDataSet.h"
 #include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkMath.h"
 #include "vtkObjectFactory.h"
+#include "vtkPointData.h"
 
 //----------------------------------------------------------------------------
 vtkCxxRevisionMacro( vtkInterpolatedVelocityField, "$Revision$" );
 vtkStandardNewMacro( vtkInterpolatedVelocityField ); 
 
+//----------------------------------------------------------------------------
+vtkInterpolatedVelocityField::vtkInterpolatedVelocityField()
+{
+  this->NeighborWalk = false;
+  this->MaximumNumberOfWalkSteps = 16;
+  this->WalkHit   = 0;
+  this->WalkSteps = 0;
+  this->GlobalSearches = 0;
+  this->WalkFacePoints = vtkIdList::New();
+  this->WalkNeighbors  = vtkIdList::New();
+}
+
+//----------------------------------------------------------------------------
+vtkInterpolatedVelocityField::~vtkInterpolatedVelocityField()
+{
+  this->WalkFacePoints->Delete();
+  this->WalkNeighbors->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkInterpolatedVelocityField::CopyParameters
+  ( vtkAbstractInterpolatedVelocityField * from )
+{
+  this->Superclass::CopyParameters( from );
+
+  vtkInterpolatedVelocityField * field = 
+    vtkInterpolatedVelocityField::SafeDownCast( from );
+  if ( field )
+    {
+    this->NeighborWalk = field->NeighborWalk;
+    this->MaximumNumberOfWalkSteps = field->MaximumNumberOfWalkSteps;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkInterpolatedVelocityField::ClearStatistics()
+{
+  this->Superclass::ClearStatistics();
+  this->WalkHit   = 0;
+  this->WalkSteps = 0;
+  this->GlobalSearches = 0;
+}
+
 //----------------------------------------------------------------------------
 void vtkInterpolatedVelocityField::AddDataSet( vtkDataSet * dataset )
 {
@@ -106,8 +153,134 @@ int vtkInterpolatedVelocityField::FunctionValues( double * x, double * f )
   return retVal;
 }
 
+//----------------------------------------------------------------------------
+int vtkInterpolatedVelocityField::FunctionValues
+  ( vtkDataSet * dataset, double * x, double * f )
+{
+  if ( !this->NeighborWalk || !this->Caching || 
+       !dataset || !dataset->IsA( "vtkPointSet" ) )
+    {
+    return this->Superclass::FunctionValues( dataset, x, f );
+    }
+
+  f[0] = f[1] = f[2] = 0.0;
+  vtkDataArray * vectors = 
+    dataset->GetPointData()->GetVectors( this->VectorsSelection );
+  if ( !vectors )
+    {
+    vtkErrorMacro( << "Can't evaluate dataset!" );
+    return 0;
+    }
+
+  int    i, j, subId, ret;
+  double vec[3];
+  double dist2;
+  double tol2 = dataset->GetLength() * 
+                vtkInterpolatedVelocityField::TOLERANCE_SCALE;
+  int    found = 0;
+
+  if ( this->LastCellId != -1 )
+    {
+    // See if the point is in the cached cell, if not walk towards it
+    ret = this->GenCell->EvaluatePosition
+                ( x, 0, subId, this->LastPCoords, dist2, this->Weights );
+    if ( ret == 1 )
+      {
+      this->CacheHit ++;
+      found = 1;
+      }
+    else
+      {
+      this->CacheMiss ++;
+      found = ( ret == 0 && this->WalkToCell( dataset, x, subId ) );
+      }
+    }
+
+  if ( !found )
+    {
+    this->GlobalSearches ++;
+    this->LastCellId = 
+      dataset->FindCell( x, 0, this->GenCell, -1, tol2, 
+                         subId, this->LastPCoords, this->Weights );
+    if ( this->LastCellId == -1 )
+      {
+      return 0;
+      }
+    dataset->GetCell( this->LastCellId, this->GenCell );
+    }
+
+  // interpolate the vectors
+  int numPts = this->GenCell->GetNumberOfPoints();
+  for ( j = 0; j < numPts; j ++ )
+    {
+    vectors->GetTuple( this->GenCell->PointIds->GetId( j ), vec );
+    for ( i = 0; i < 3; i ++ )
+      {
+      f[i] += vec[i] * this->Weights[j];
+      }
+    }
+
+  if ( this->NormalizeVector == true )
+    {
+    vtkMath::Normalize( f );
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkInterpolatedVelocityField::WalkToCell
+  ( vtkDataSet * dataset, double * x, int subId )
+{
+  int       ret;
+  double    dist2;
+  vtkIdType prevCellId = -1;
+
+  for ( int step = 0; step < this->MaximumNumberOfWalkSteps; step ++ )
+    {
+    // step across the face closest to the point, unless it is on the
+    // boundary, shared by several cells or leads back to the previous cell
+    this->GenCell->CellBoundary( subId, this->LastPCoords, 
+                                 this->WalkFacePoints );
+    dataset->GetCellNeighbors( this->LastCellId, this->WalkFacePoints, 
+                               this->WalkNeighbors );
+    if ( this->WalkNeighbors->GetNumberOfIds() != 1 ||
+         this->WalkNeighbors->GetId( 0 ) == prevCellId )
+      {
+      return 0;
+      }
+
+    prevCellId = this->LastCellId;
+    this->LastCellId = this->WalkNeighbors->GetId( 0 );
+    dataset->GetCell( this->LastCellId, this->GenCell );
+    this->WalkSteps ++;
+
+    ret = this->GenCell->EvaluatePosition
+                ( x, 0, subId, this->LastPCoords, dist2, this->Weights );
+    if ( ret == 1 )
+      {
+      this->WalkHit ++;
+      return 1;
+      }
+    if ( ret == -1 )
+      {
+      return 0;
+      }
+    }
+
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 void vtkInterpolatedVelocityField::PrintSelf( ostream & os, vtkIndent indent )
 {
   this->Superclass::PrintSelf( os, indent );
+
+  os << indent << "Neighbor Walk: " 
+     << ( this->NeighborWalk ? "on." : "off." ) << endl;
+  os << indent << "Maximum Number Of Walk Steps: " 
+     << this->MaximumNumberOfWalkSteps << endl;
+  os << indent << "Walk Hit: "         << this->WalkHit        << endl;
+  os << indent << "Walk Steps: "       << this->WalkSteps      << endl;
+  os << indent << "Global Searches: "  << this->GlobalSearches << endl;
 }
@@ -39,6 +39,12 @@
 //  casues vtkInterpolatedVelocityField to return false target cells for 
 //  datasets defined on complex grids.
 //
+//  With NeighborWalk on, a point that leaves the cached cell is first looked
+//  for by walking from the cached cell through the face neighbors, towards
+//  the point, before vtkDataSet::FindCell() is invoked. Consecutive points
+//  of a streamline usually lie in the same or in an adjacent cell, so the
+//  walk replaces most of the searches through vtkPointLocator.
+//
 // .SECTION Caveats
 //  vtkInterpolatedVelocityField is not thread safe. A new instance should be
 //  created by each thread.
@@ -53,6 +59,8 @@
 
 #include "vtkAbstractInterpolatedVelocityField.h"
 
+class vtkIdList;
+
 class VTK_FILTERING_EXPORT vtkInterpolatedVelocityField 
   : public vtkAbstractInterpolatedVelocityField
 {
@@ -63,7 +71,7 @@ public:
 
   // Description:
   // Construct a vtkInterpolatedVelocityField without an initial dataset.
-  // Caching is set on and LastCellId is set to -1.
+  // Caching is set on, NeighborWalk is set off and LastCellId is set to -1.
   static vtkInterpolatedVelocityField * New();
   
   // Description:
@@ -86,9 +94,42 @@ public:
   virtual void SetLastCellId( vtkIdType c ) 
     { this->Superclass::SetLastCellId( c ); }
 
+  // Description:
+  // Set/Get the flag that turns on the neighbor walk. If the point is not in
+  // the cached cell, the walk steps to the neighbor across the cell face the
+  // point lies beyond, until the cell containing the point is found, the
+  // walk reaches the boundary of the dataset or MaximumNumberOfWalkSteps
+  // cells have been visited. Only then is vtkDataSet::FindCell() invoked.
+  // The walk is used for datasets of type vtkPointSet and requires Caching.
+  vtkSetMacro( NeighborWalk, bool );
+  vtkGetMacro( NeighborWalk, bool );
+  vtkBooleanMacro( NeighborWalk, bool );
+
+  // Description:
+  // Set/Get the maximum number of cells visited by one neighbor walk.
+  vtkSetClampMacro( MaximumNumberOfWalkSteps, int, 1, VTK_LARGE_INTEGER );
+  vtkGetMacro( MaximumNumberOfWalkSteps, int );
+
+  // Description:
+  // Get the neighbor walk statistics. WalkHit is the number of points found
+  // by a walk, WalkSteps the number of cells stepped through by all walks
+  // and GlobalSearches the number of times vtkDataSet::FindCell() had to be
+  // invoked while NeighborWalk is on.
+  vtkGetMacro( WalkHit, int );
+  vtkGetMacro( WalkSteps, int );
+  vtkGetMacro( GlobalSearches, int );
+
+  // Description:
+  // Reset the caching and neighbor walk statistics.
+  virtual void ClearStatistics();
+
+  // Description:
+  // Import parameters, including the neighbor walk settings.
+  virtual void CopyParameters( vtkAbstractInterpolatedVelocityField * from );
+
 protected:
-  vtkInterpolatedVelocityField() { }
-  ~vtkInterpolatedVelocityField() { }
+  vtkInterpolatedVelocityField();
+  ~vtkInterpolatedVelocityField();
 
   // Description:
   // Evaluate the velocity field f at point (x, y, z) in a specified dataset
@@ -96,8 +137,22 @@ protected:
   // locating the next cell (for datasets of type vtkPointSet) or simply
   // invoking vtkImageData/vtkRectilinearGrid::FindCell() to fulfill the same
   // task if the point is outside the current cell.
-  virtual int FunctionValues( vtkDataSet * ds, double * x, double * f )
-    { return this->Superclass::FunctionValues( ds, x, f ); }
+  // With NeighborWalk on, a neighbor walk is tried before FindCell().
+  virtual int FunctionValues( vtkDataSet * ds, double * x, double * f );
+
+  // Description:
+  // Walk from the cached cell, whose parametric coordinates of x and
+  // sub-id are in LastPCoords and subId, to the cell containing x. Return
+  // 1 and leave the cell cached, with its weights, if it is found.
+  int WalkToCell( vtkDataSet * ds, double * x, int subId );
+
+  bool        NeighborWalk;
+  int         MaximumNumberOfWalkSteps;
+  int         WalkHit;
+  int         WalkSteps;
+  int         GlobalSearches;
+  vtkIdList * WalkFacePoints;
+  vtkIdList * WalkNeighbors;
 
 private:
   vtkInterpolatedVelocityField
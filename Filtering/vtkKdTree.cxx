@@ -41,6 +41,7 @@
 #include "vtkUniformGrid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkCallbackCommand.h"
+#include "vtkParallelFor.h"
 
 #ifdef _MSC_VER
 #pragma warning ( disable : 4100 )
@@ -50,6 +51,7 @@
 #include <vtkstd/map>
 #include <vtkstd/queue>
 #include <vtkstd/set>
+#include <vtkstd/vector>
 
 vtkCxxRevisionMacro(vtkKdTree, "$Revision$");
 
@@ -917,7 +919,7 @@ void vtkKdTree::BuildLocator()
   
     this->ProgressOffset += this->ProgressScale;
     this->ProgressScale = 0.7;
-    this->DivideRegion(kd, ptarray, NULL, 0);
+    this->DivideRegionThreaded(kd, ptarray, NULL, 0);
   
     TIMERDONE("Build tree");
   
@@ -1245,6 +1247,120 @@ int vtkKdTree::DivideTest(int size, int level)
 }
 //----------------------------------------------------------------------------
 int vtkKdTree::DivideRegion(vtkKdNode *kd, float *c1, int *ids, int level)
+{
+  if (!this->DivideNode(kd, c1, ids, level))
+    {
+    return 0;   // unable to divide region further
+    }
+
+  int nleft = kd->GetLeft()->GetNumberOfPoints();
+
+  int *leftIds  = ids;
+  int *rightIds = ids ? ids + nleft : NULL;
+  
+  this->DivideRegion(kd->GetLeft(), c1, leftIds, level + 1);
+  
+  this->DivideRegion(kd->GetRight(), c1 + nleft*3, rightIds, level + 1);
+  
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+// A region still to be divided by DivideRegionThreaded().
+struct vtkKdTreeRegionTask
+{
+  vtkKdNode *Node;
+  float *Points;
+  int *Ids;
+  int Level;
+};
+
+// Divides the regions of a list, either one level or all the way down.
+class vtkKdTreeDivideFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkKdTree *Tree;
+  vtkstd::vector<vtkKdTreeRegionTask> *Tasks;
+  int Recurse;
+
+  void Execute(vtkIdType begin, vtkIdType end, int vtkNotUsed(threadId))
+    {
+    for (vtkIdType i=begin; i<end; i++)
+      {
+      vtkKdTreeRegionTask &task = (*this->Tasks)[i];
+      if (this->Recurse)
+        {
+        this->Tree->DivideRegion(task.Node, task.Points, task.Ids, task.Level);
+        }
+      else
+        {
+        this->Tree->DivideNode(task.Node, task.Points, task.Ids, task.Level);
+        }
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// The regions of the upper levels are divided one level at a time, all
+// regions of a level concurrently, until there are enough regions to keep
+// the threads busy.  These subtrees are then divided recursively, several
+// at a time.  The regions only share the point array, in disjoint ranges,
+// so the tree is the same as the one DivideRegion() builds.
+void vtkKdTree::DivideRegionThreaded(vtkKdNode *kd, float *c1, int *ids,
+                                     int level)
+{
+  vtkParallelFor *parallelFor = vtkParallelFor::New();
+  parallelFor->SetGrainSize(1);
+  size_t minimumTasks = 4 * parallelFor->GetNumberOfThreads();
+
+  vtkstd::vector<vtkKdTreeRegionTask> tasks, nextTasks;
+  vtkKdTreeRegionTask task;
+  task.Node = kd;
+  task.Points = c1;
+  task.Ids = ids;
+  task.Level = level;
+  tasks.push_back(task);
+
+  vtkKdTreeDivideFunctor functor;
+  functor.Tree = this;
+  functor.Recurse = 0;
+
+  while (parallelFor->GetNumberOfThreads() > 1 && !tasks.empty() &&
+         tasks.size() < minimumTasks)
+    {
+    functor.Tasks = &tasks;
+    parallelFor->Execute(0, static_cast<vtkIdType>(tasks.size()), &functor);
+
+    nextTasks.clear();
+    for (size_t i=0; i<tasks.size(); i++)
+      {
+      vtkKdNode *node = tasks[i].Node;
+      if (node->GetLeft() == NULL)
+        {
+        continue;
+        }
+      int nleft = node->GetLeft()->GetNumberOfPoints();
+      task.Level = tasks[i].Level + 1;
+      task.Node = node->GetLeft();
+      task.Points = tasks[i].Points;
+      task.Ids = tasks[i].Ids;
+      nextTasks.push_back(task);
+      task.Node = node->GetRight();
+      task.Points = tasks[i].Points + nleft*3;
+      task.Ids = tasks[i].Ids ? tasks[i].Ids + nleft : NULL;
+      nextTasks.push_back(task);
+      }
+    tasks.swap(nextTasks);
+    }
+
+  functor.Tasks = &tasks;
+  functor.Recurse = 1;
+  parallelFor->Execute(0, static_cast<vtkIdType>(tasks.size()), &functor);
+  parallelFor->Delete();
+}
+
+//----------------------------------------------------------------------------
+int vtkKdTree::DivideNode(vtkKdNode *kd, float *c1, int *ids, int level)
 {
   int ok = this->DivideTest(kd->GetNumberOfPoints(), level);
 
@@ -1299,21 +1415,7 @@ int vtkKdTree::DivideRegion(vtkKdNode *kd, float *c1, int *ids, int level)
 
   this->DoMedianFind(kd, c1, ids, dim1, dim2, dim3);
 
-  if (kd->GetLeft() == NULL)
-    {
-    return 0;   // unable to divide region further
-    }
-
-  int nleft = kd->GetLeft()->GetNumberOfPoints();
-
-  int *leftIds  = ids;
-  int *rightIds = ids ? ids + nleft : NULL;
-  
-  this->DivideRegion(kd->GetLeft(), c1, leftIds, level + 1);
-  
-  this->DivideRegion(kd->GetRight(), c1 + nleft*3, rightIds, level + 1);
-  
-  return 0;
+  return (kd->GetLeft() != NULL);
 }
 
 //----------------------------------------------------------------------------
@@ -1878,7 +1980,7 @@ void vtkKdTree::BuildLocatorFromPoints(vtkPoints **ptArrays, int numPtArrays)
 
   TIMER("Build tree");
 
-  this->DivideRegion(kd, points, ptIds, 0);
+  this->DivideRegionThreaded(kd, points, ptIds, 0);
 
   this->SetActualLevel();
   this->BuildRegionList();
@@ -3180,6 +3282,337 @@ void vtkKdTree::FreeSearchStructure()
     }
 }
 
+//----------------------------------------------------------------------------
+// Save and restore the k-d tree.  The nodes are written depth first, each
+// as its child flag, cut direction and point count followed by its spatial
+// and data bounds.  Point trees add the point permutation.
+//
+static const char vtkKdTreeSignature[] = "vtkKdTree 1\n";
+
+static int vtkKdTreeCountNodes(vtkKdNode *kd)
+{
+  if (kd->GetLeft() == NULL)
+    {
+    return 1;
+    }
+  return 1 + vtkKdTreeCountNodes(kd->GetLeft()) +
+    vtkKdTreeCountNodes(kd->GetRight());
+}
+
+static void vtkKdTreeWriteNode(ostream &file, vtkKdNode *kd)
+{
+  int info[3];
+  double bounds[12];
+  info[0] = (kd->GetLeft() != NULL);
+  info[1] = kd->GetDim();
+  info[2] = kd->GetNumberOfPoints();
+  kd->GetBounds(bounds);
+  kd->GetDataBounds(bounds + 6);
+  file.write(reinterpret_cast<char *>(info), sizeof(info));
+  file.write(reinterpret_cast<char *>(bounds), sizeof(bounds));
+  if (info[0])
+    {
+    vtkKdTreeWriteNode(file, kd->GetLeft());
+    vtkKdTreeWriteNode(file, kd->GetRight());
+    }
+}
+
+static void vtkKdTreeDeleteNode(vtkKdNode *kd)
+{
+  vtkKdNode *left = kd->GetLeft();
+  vtkKdNode *right = kd->GetRight();
+  if (left && right)
+    {
+    kd->DeleteChildNodes();   // undo AddChildNodes
+    vtkKdTreeDeleteNode(left);
+    vtkKdTreeDeleteNode(right);
+    }
+  kd->Delete();
+}
+
+// Returns the node, or NULL if the file is truncated or does not hold a
+// consistent tree of at most numNodes nodes.
+static vtkKdNode *vtkKdTreeReadNode(istream &file, int &numNodes)
+{
+  int info[3];
+  double bounds[12];
+  file.read(reinterpret_cast<char *>(info), sizeof(info));
+  file.read(reinterpret_cast<char *>(bounds), sizeof(bounds));
+  if (!file || --numNodes < 0 || info[1] < 0 || info[1] > 3 ||
+      info[2] < 0)
+    {
+    return NULL;
+    }
+
+  vtkKdNode *kd = vtkKdNode::New();
+  kd->SetDim(info[1]);
+  kd->SetNumberOfPoints(info[2]);
+  kd->SetBounds(bounds);
+  kd->SetDataBounds(bounds[6], bounds[7], bounds[8],
+                    bounds[9], bounds[10], bounds[11]);
+  if (info[0])
+    {
+    vtkKdNode *left = vtkKdTreeReadNode(file, numNodes);
+    vtkKdNode *right = left ? vtkKdTreeReadNode(file, numNodes) : NULL;
+    if (right == NULL ||
+        left->GetNumberOfPoints() + right->GetNumberOfPoints() != info[2])
+      {
+      if (left)
+        {
+        vtkKdTreeDeleteNode(left);
+        }
+      if (right)
+        {
+        vtkKdTreeDeleteNode(right);
+        }
+      kd->Delete();
+      return NULL;
+      }
+    kd->AddChildNodes(left, right);
+    }
+  return kd;
+}
+
+//----------------------------------------------------------------------------
+int vtkKdTree::WriteSearchStructure(const char *fileName)
+{
+  if (!fileName)
+    {
+    vtkErrorMacro(<< "No file name specified");
+    return 0;
+    }
+  if (!this->Top)
+    {
+    vtkErrorMacro(<< "No search structure to write");
+    return 0;
+    }
+
+  ofstream file(fileName, ios::out | ios::binary);
+  if (!file)
+    {
+    vtkErrorMacro(<< "Cannot open file " << fileName);
+    return 0;
+    }
+
+  int header[3];
+  header[0] = 0x01020304; // byte order
+  header[1] = vtkKdTreeCountNodes(this->Top);
+  header[2] = (this->LocatorIds ? this->NumberOfLocatorPoints : 0);
+  double widths[2];
+  widths[0] = this->MaxWidth;
+  widths[1] = this->FudgeFactor;
+
+  file.write(vtkKdTreeSignature, sizeof(vtkKdTreeSignature));
+  file.write(reinterpret_cast<char *>(header), sizeof(header));
+  file.write(reinterpret_cast<char *>(widths), sizeof(widths));
+  vtkKdTreeWriteNode(file, this->Top);
+  if (header[2] > 0)
+    {
+    file.write(reinterpret_cast<char *>(this->LocatorIds),
+               header[2]*sizeof(int));
+    }
+  if (!file)
+    {
+    vtkErrorMacro(<< "Error writing file " << fileName);
+    return 0;
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Reads the header and the tree of a file written by WriteSearchStructure.
+// Returns the root node, or NULL on error.
+vtkKdNode *vtkKdTree::ReadSearchStructureTree(istream &file,
+                                              const char *fileName,
+                                              int &numLocatorPoints,
+                                              double widths[2])
+{
+  char signature[sizeof(vtkKdTreeSignature)];
+  int header[3];
+  file.read(signature, sizeof(signature));
+  file.read(reinterpret_cast<char *>(header), sizeof(header));
+  file.read(reinterpret_cast<char *>(widths), 2*sizeof(double));
+  if (!file || memcmp(signature, vtkKdTreeSignature, sizeof(signature)) != 0)
+    {
+    vtkErrorMacro(<< fileName << " is not a k-d tree file");
+    return NULL;
+    }
+  if (header[0] != 0x01020304)
+    {
+    vtkErrorMacro(<< fileName << " was written on an incompatible machine");
+    return NULL;
+    }
+
+  int numNodes = header[1];
+  vtkKdNode *top = vtkKdTreeReadNode(file, numNodes);
+  if (!top || numNodes != 0 ||
+      (header[2] > 0 && top->GetNumberOfPoints() != header[2]))
+    {
+    if (top)
+      {
+      vtkKdTree::DeleteAllDescendants(top);
+      top->Delete();
+      }
+    vtkErrorMacro(<< fileName << " holds an invalid k-d tree");
+    return NULL;
+    }
+  numLocatorPoints = header[2];
+  return top;
+}
+
+//----------------------------------------------------------------------------
+int vtkKdTree::ReadSearchStructure(const char *fileName)
+{
+  if (!fileName)
+    {
+    vtkErrorMacro(<< "No file name specified");
+    return 0;
+    }
+
+  ifstream file(fileName, ios::in | ios::binary);
+  if (!file)
+    {
+    vtkErrorMacro(<< "Cannot open file " << fileName);
+    return 0;
+    }
+
+  int numLocatorPoints;
+  double widths[2];
+  vtkKdNode *top =
+    this->ReadSearchStructureTree(file, fileName, numLocatorPoints, widths);
+  if (!top)
+    {
+    return 0;
+    }
+
+  // The next BuildLocator() uses the tree read as user defined cuts.
+  vtkBSPCuts *cuts = vtkBSPCuts::New();
+  cuts->CreateCuts(top);
+  this->SetCuts(cuts);
+  cuts->Delete();
+
+  vtkKdTree::DeleteAllDescendants(top);
+  top->Delete();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkKdTree::ReadSearchStructure(const char *fileName, vtkPoints *ptArray)
+{
+  return this->ReadSearchStructure(fileName, &ptArray, 1);
+}
+
+//----------------------------------------------------------------------------
+int vtkKdTree::ReadSearchStructure(const char *fileName,
+                                   vtkPoints **ptArrays, int numPtArrays)
+{
+  if (!fileName)
+    {
+    vtkErrorMacro(<< "No file name specified");
+    return 0;
+    }
+
+  int i;
+  vtkIdType totalNumPoints = 0;
+  for (i = 0; i < numPtArrays; i++)
+    {
+    totalNumPoints += ptArrays[i]->GetNumberOfPoints();
+    }
+
+  ifstream file(fileName, ios::in | ios::binary);
+  if (!file)
+    {
+    vtkErrorMacro(<< "Cannot open file " << fileName);
+    return 0;
+    }
+
+  int numLocatorPoints;
+  double widths[2];
+  vtkKdNode *top =
+    this->ReadSearchStructureTree(file, fileName, numLocatorPoints, widths);
+  if (!top)
+    {
+    return 0;
+    }
+  if (numLocatorPoints < 1 || numLocatorPoints != totalNumPoints)
+    {
+    vtkKdTree::DeleteAllDescendants(top);
+    top->Delete();
+    vtkErrorMacro(<< fileName << " was not built from these points");
+    return 0;
+    }
+
+  int *ptIds = new int [numLocatorPoints];
+  file.read(reinterpret_cast<char *>(ptIds), numLocatorPoints*sizeof(int));
+  int ok = !file.fail();
+  for (i = 0; ok && i < numLocatorPoints; i++)
+    {
+    ok = (ptIds[i] >= 0 && ptIds[i] < numLocatorPoints);
+    }
+  if (!ok)
+    {
+    delete [] ptIds;
+    vtkKdTree::DeleteAllDescendants(top);
+    top->Delete();
+    vtkErrorMacro(<< fileName << " holds an invalid point permutation");
+    return 0;
+    }
+
+  this->FreeSearchStructure();
+  this->ClearLastBuildCache();
+
+  this->Top = top;
+  this->LocatorIds = ptIds;
+  this->NumberOfLocatorPoints = numLocatorPoints;
+  this->MaxWidth = static_cast<float>(widths[0]);
+  this->FudgeFactor = widths[1];
+
+  // Gather the points in the order of the k-d tree regions.
+
+  vtkIdType *firstId = new vtkIdType [numPtArrays];
+  firstId[0] = 0;
+  for (i = 1; i < numPtArrays; i++)
+    {
+    firstId[i] = firstId[i-1] + ptArrays[i-1]->GetNumberOfPoints();
+    }
+
+  float *points = this->LocatorPoints = new float [3 * numLocatorPoints];
+  int set = 0;
+  double pt[3];
+  for (i = 0; i < numLocatorPoints; i++)
+    {
+    vtkIdType ptId = ptIds[i];
+    if (ptId < firstId[set] || (set+1 < numPtArrays && ptId >= firstId[set+1]))
+      {
+      set = static_cast<int>(
+        vtkstd::upper_bound(firstId, firstId + numPtArrays, ptId) - firstId) - 1;
+      }
+    ptArrays[set]->GetPoint(ptId - firstId[set], pt);
+    points[3*i]   = static_cast<float>(pt[0]);
+    points[3*i+1] = static_cast<float>(pt[1]);
+    points[3*i+2] = static_cast<float>(pt[2]);
+    }
+  delete [] firstId;
+
+  this->SetActualLevel();
+  this->BuildRegionList();
+
+  this->LocatorRegionLocation = new int [this->NumberOfRegions];
+
+  int idx = 0;
+
+  for (int reg = 0; reg < this->NumberOfRegions; reg++)
+    {
+    this->LocatorRegionLocation[reg] = idx;
+
+    idx += this->RegionList[reg]->GetNumberOfPoints();
+    }
+
+  this->SetCalculator(this->Top);
+
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 // build PolyData representation of all spacial regions------------
 //
@@ -341,7 +341,8 @@ public:
   // Description:
   // Create the k-d tree decomposition of the cells of the data set
   // or data sets.  Cells are assigned to k-d tree spatial regions
-  // based on the location of their centroids.
+  // based on the location of their centroids.  The subtrees of the
+  // decomposition are divided by several threads at once.
   void BuildLocator();
 
   // Description:
@@ -424,6 +425,25 @@ public:
   void BuildLocatorFromPoints(vtkPointSet *pointset);
   void BuildLocatorFromPoints(vtkPoints *ptArray);
   void BuildLocatorFromPoints(vtkPoints **ptArray, int numPtArrays);
+
+  // Description:
+  // Save the k-d tree to a binary file, so that later runs need not build
+  // it again.  Trees built with BuildLocatorFromPoints also save the
+  // order of their points.  Returns 1 on success, 0 on error.
+  int WriteSearchStructure(const char *fileName);
+
+  // Description:
+  // Restore a k-d tree saved with WriteSearchStructure.  Given only the
+  // file name, the tree is read as user defined cuts (see SetCuts) that
+  // the next BuildLocator uses instead of computing its own; this also
+  // works for subclasses such as vtkPKdTree.  Given the points the tree
+  // was built from, the tree is restored as BuildLocatorFromPoints would
+  // build it.  The file must be read on a machine with the same byte
+  // order.  Returns 1 on success, 0 on error.
+  int ReadSearchStructure(const char *fileName);
+  int ReadSearchStructure(const char *fileName, vtkPoints *ptArray);
+  int ReadSearchStructure(const char *fileName, vtkPoints **ptArrays,
+                          int numPtArrays);
   
   // Description:
   // This call returns a mapping from the original point IDs supplied
@@ -692,6 +712,16 @@ protected:
 
   int DivideRegion(vtkKdNode *kd, float *c1, int *ids, int nlevels);
 
+  // Divide the region in two without recursing, returns 1 if divided.
+  int DivideNode(vtkKdNode *kd, float *c1, int *ids, int level);
+
+  // DivideRegion using several threads, gives the same tree.
+  void DivideRegionThreaded(vtkKdNode *kd, float *c1, int *ids, int level);
+  friend class vtkKdTreeDivideFunctor;
+
+  vtkKdNode *ReadSearchStructureTree(istream &file, const char *fileName,
+                                     int &numLocatorPoints, double widths[2]);
+
   void DoMedianFind(vtkKdNode *kd, float *c1, int *ids, int d1, int d2, int d3);
 
   void SelfRegister(vtkKdNode *kd);
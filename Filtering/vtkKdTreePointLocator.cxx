@@ -95,6 +95,37 @@ void vtkKdTreePointLocator::GenerateRepresentation(int level, vtkPolyData *pd)
   this->KdTree->GenerateRepresentation(level, pd);
 }
 
+int vtkKdTreePointLocator::WriteSearchStructure(const char *fileName)
+{
+  this->BuildLocator();
+  if(!this->KdTree)
+    {
+    return 0;
+    }
+  return this->KdTree->WriteSearchStructure(fileName);
+}
+
+int vtkKdTreePointLocator::ReadSearchStructure(const char *fileName)
+{
+  vtkPointSet* pointSet = vtkPointSet::SafeDownCast(this->GetDataSet());
+  if(!pointSet || !pointSet->GetPoints())
+    {
+    vtkErrorMacro("vtkKdTreePointLocator requires a PointSet to read locator.");
+    return 0;
+    }
+  vtkKdTree* kdTree = vtkKdTree::New();
+  if(!kdTree->ReadSearchStructure(fileName, pointSet->GetPoints()))
+    {
+    kdTree->Delete();
+    return 0;
+    }
+  this->FreeSearchStructure();
+  this->KdTree = kdTree;
+  this->KdTree->GetBounds(this->Bounds);
+  this->Modified();
+  return 1;
+}
+
 void vtkKdTreePointLocator::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
@@ -74,6 +74,13 @@ public:
   virtual void BuildLocator();
   virtual void GenerateRepresentation(int level, vtkPolyData *pd);
 
+  // Description:
+  // Save the k-d tree to a binary file, or restore a saved tree instead of
+  // building it.  The data set must be set before reading, and must hold
+  // the points the tree was built from.  Returns 1 on success, 0 on error.
+  int WriteSearchStructure(const char *fileName);
+  int ReadSearchStructure(const char *fileName);
+
 protected:
   vtkKdTreePointLocator();
   virtual ~vtkKdTreePointLocator();
@@ -0,0 +1,289 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkMergeEdgePoints.h"
+
+#include "vtkCellTypes.h"
+#include "vtkDataSet.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkGenericCell.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+
+#include <vtkstd/vector>
+
+#include <string.h>
+
+vtkCxxRevisionMacro(vtkMergeEdgePoints, "$Revision$");
+vtkStandardNewMacro(vtkMergeEdgePoints);
+
+//----------------------------------------------------------------------------
+// An edge location: the end points of the edge, the smaller id first, and the
+// parametric coordinate from the first, or the point itself twice at the ends
+// of the edge.
+struct vtkMergeEdgePointsKey
+{
+  vtkIdType P1;
+  vtkIdType P2;
+  double T;
+
+  vtkMergeEdgePointsKey(vtkIdType p1, vtkIdType p2, double t)
+    {
+    if ( t == 0.0 )
+      {
+      this->P1 = this->P2 = p1;
+      this->T = 0.0;
+      }
+    else if ( t == 1.0 )
+      {
+      this->P1 = this->P2 = p2;
+      this->T = 0.0;
+      }
+    else if ( p1 < p2 )
+      {
+      this->P1 = p1;
+      this->P2 = p2;
+      this->T = t;
+      }
+    else
+      {
+      this->P1 = p2;
+      this->P2 = p1;
+      this->T = 1.0 - t;
+      }
+    }
+
+  bool operator==(const vtkMergeEdgePointsKey &key) const
+    {
+    return this->P1 == key.P1 && this->P2 == key.P2 && this->T == key.T;
+    }
+};
+
+// An open addressing hash table of edge locations and the ids of their
+// points, a P1 of -1 marking a free slot, and the edge location each point
+// was inserted with.
+class vtkMergeEdgePointsInternals
+{
+public:
+  struct Entry
+  {
+    vtkMergeEdgePointsKey Key;
+    vtkIdType PointId;
+  };
+
+  vtkstd::vector<Entry> Table;
+  vtkIdType Mask;
+  vtkIdType NumberOfEdges;
+  vtkstd::vector<vtkIdType> PointEdges;
+  vtkstd::vector<double> PointWeights;
+
+  vtkMergeEdgePointsInternals()
+    {
+    this->Reset(0);
+    }
+
+  void Reset(vtkIdType estSize)
+    {
+    vtkIdType size = 1024;
+    while (size < 2*estSize)
+      {
+      size *= 2;
+      }
+    this->Table.assign(size, FreeEntry());
+    this->Mask = size - 1;
+    this->NumberOfEdges = 0;
+    this->PointEdges.clear();
+    this->PointWeights.clear();
+    }
+
+  static Entry FreeEntry()
+    {
+    Entry entry = { vtkMergeEdgePointsKey(-1, -1, 0.0), -1 };
+    return entry;
+    }
+
+  // Return the slot holding the key, or the free slot it goes in. Different
+  // locations on the same edge are nearby in the table.
+  vtkIdType FindSlot(const vtkMergeEdgePointsKey &key)
+    {
+    vtkTypeUInt64 bits;
+    memcpy(&bits, &key.T, sizeof(bits));
+    vtkTypeUInt64 h = static_cast<vtkTypeUInt64>(key.P1) * 73856093 ^
+                      static_cast<vtkTypeUInt64>(key.P2) * 19349663;
+    h ^= h >> 17;
+    h += bits ^ (bits >> 32);
+    vtkIdType slot = static_cast<vtkIdType>(h) & this->Mask;
+    const Entry *entry = &this->Table[slot];
+    while (entry->Key.P1 != -1 && !(entry->Key == key))
+      {
+      slot = (slot + 1) & this->Mask;
+      entry = &this->Table[slot];
+      }
+    return slot;
+    }
+
+  // Double the table size, keeping it at most half full.
+  void Grow()
+    {
+    vtkstd::vector<Entry> old;
+    old.swap(this->Table);
+    vtkIdType size = 2*(this->Mask + 1);
+    this->Table.assign(size, FreeEntry());
+    this->Mask = size - 1;
+    for (size_t i=0; i < old.size(); i++)
+      {
+      if (old[i].Key.P1 != -1)
+        {
+        this->Table[this->FindSlot(old[i].Key)] = old[i];
+        }
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+vtkMergeEdgePoints::vtkMergeEdgePoints()
+{
+  this->Internals = new vtkMergeEdgePointsInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkMergeEdgePoints::~vtkMergeEdgePoints()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+int vtkMergeEdgePoints::InitPointInsertion(vtkPoints *newPts,
+                                           const double bounds[6],
+                                           vtkIdType estSize)
+{
+  this->Internals->Reset(estSize);
+  return this->Superclass::InitPointInsertion(newPts, bounds, estSize);
+}
+
+//----------------------------------------------------------------------------
+void vtkMergeEdgePoints::Initialize()
+{
+  this->Internals->Reset(0);
+  this->Superclass::Initialize();
+}
+
+//----------------------------------------------------------------------------
+int vtkMergeEdgePoints::InsertUniqueEdgePoint(vtkIdType p1, vtkIdType p2,
+                                              double t, const double x[3],
+                                              vtkIdType &ptId)
+{
+  vtkMergeEdgePointsInternals *internals = this->Internals;
+  vtkMergeEdgePointsKey key(p1, p2, t);
+
+  vtkIdType slot = internals->FindSlot(key);
+  vtkMergeEdgePointsInternals::Entry *entry = &internals->Table[slot];
+  if ( entry->Key.P1 != -1 )
+    {
+    ptId = entry->PointId;
+    return 0;
+    }
+
+  ptId = this->InsertionPointId++;
+  this->Points->InsertPoint(ptId, x);
+  entry->Key = key;
+  entry->PointId = ptId;
+
+  if ( static_cast<vtkIdType>(internals->PointWeights.size()) <= ptId )
+    {
+    internals->PointEdges.resize(2*(ptId+1), -1);
+    internals->PointWeights.resize(ptId+1, 0.0);
+    }
+  internals->PointEdges[2*ptId] = p1;
+  internals->PointEdges[2*ptId+1] = p2;
+  internals->PointWeights[ptId] = t;
+
+  if ( ++internals->NumberOfEdges > internals->Mask / 2 )
+    {
+    internals->Grow();
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMergeEdgePoints::IsInsertedEdgePoint(vtkIdType p1, vtkIdType p2,
+                                                  double t)
+{
+  vtkMergeEdgePointsKey key(p1, p2, t);
+  return this->Internals->Table[this->Internals->FindSlot(key)].PointId;
+}
+
+//----------------------------------------------------------------------------
+int vtkMergeEdgePoints::GetPointEdge(vtkIdType ptId, vtkIdType edge[2],
+                                     double &t)
+{
+  vtkMergeEdgePointsInternals *internals = this->Internals;
+  if ( ptId < 0 ||
+       ptId >= static_cast<vtkIdType>(internals->PointWeights.size()) ||
+       internals->PointEdges[2*ptId] == -1 )
+    {
+    return 0;
+    }
+  edge[0] = internals->PointEdges[2*ptId];
+  edge[1] = internals->PointEdges[2*ptId+1];
+  t = internals->PointWeights[ptId];
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMergeEdgePoints::InterpolatePointData(vtkDataSetAttributes *inPd,
+                                              vtkDataSetAttributes *outPd)
+{
+  vtkMergeEdgePointsInternals *internals = this->Internals;
+  vtkIdType numPts = static_cast<vtkIdType>(internals->PointWeights.size());
+  if ( numPts > 0 )
+    {
+    outPd->InterpolateEdges(inPd, 0, numPts, &internals->PointEdges[0],
+                            &internals->PointWeights[0]);
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkMergeEdgePoints::CanMergeDataSet(vtkDataSet *input)
+{
+  vtkCellTypes *types = vtkCellTypes::New();
+  vtkGenericCell *cell = vtkGenericCell::New();
+  input->GetCellTypes(types);
+  int canMerge = 1;
+  for (int i=0; i < types->GetNumberOfTypes() && canMerge; i++)
+    {
+    int type = types->GetCellType(i);
+    cell->SetCellType(type);
+    canMerge = cell->IsLinear() && type != VTK_VERTEX &&
+      type != VTK_POLY_VERTEX;
+    }
+  cell->Delete();
+  types->Delete();
+  return canMerge;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkMergeEdgePoints::GetNumberOfEdgePoints()
+{
+  return this->Internals->NumberOfEdges;
+}
+
+//----------------------------------------------------------------------------
+void vtkMergeEdgePoints::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number Of Edge Points: "
+     << this->Internals->NumberOfEdges << "\n";
+}
@@ -0,0 +1,119 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkMergeEdgePoints - merge points generated on the same input edge
+// .SECTION Description
+// vtkMergeEdgePoints is a vtkMergePoints that merges the points linear cells
+// interpolate on their edges while contouring or clipping by the ids of the
+// edge end points and the parametric coordinate along the edge instead of by
+// position. The edge locations are kept in a hash table, so a lookup costs
+// no bucket search, and the location recorded for each point lets the
+// outputs of several locators, e.g. one per thread, be merged together by
+// edge as well. Points inserted with InsertUniquePoint() are merged by
+// position as in vtkMergePoints.
+//
+// A point at an end of its edge (t of 0 or 1) is keyed by the input point it
+// lies on, so that it is merged with the points the other edges of that
+// point produce there. Elsewhere the parametric coordinate must match
+// exactly, which it does when the cells sharing an edge interpolate it in
+// the same direction, as the linear cells of VTK do.
+//
+// .SECTION Caveats
+// Nonlinear cells contour their linear pieces with local point ids, so this
+// locator should only be given to the cells for which vtkCell::IsLinear()
+// returns 1; CanMergeDataSet() checks a whole dataset. Distinct input points
+// at the same position are not merged.
+//
+// .SECTION See Also
+// vtkMergePoints vtkIncrementalPointLocator vtkContourGrid vtkCutter
+// vtkClipDataSet
+
+#ifndef __vtkMergeEdgePoints_h
+#define __vtkMergeEdgePoints_h
+
+#include "vtkMergePoints.h"
+
+class vtkDataSet;
+class vtkDataSetAttributes;
+class vtkMergeEdgePointsInternals;
+
+class VTK_FILTERING_EXPORT vtkMergeEdgePoints : public vtkMergePoints
+{
+public:
+  static vtkMergeEdgePoints *New();
+  vtkTypeRevisionMacro(vtkMergeEdgePoints,vtkMergePoints);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Insert the point x interpolated at t on the input edge (p1,p2) unless a
+  // point has been inserted for the same edge location. Return 1 if the point
+  // was inserted, 0 otherwise. In either case its id is returned in ptId.
+  virtual int InsertUniqueEdgePoint(vtkIdType p1, vtkIdType p2, double t,
+                                    const double x[3], vtkIdType &ptId);
+
+  // Description:
+  // Return the id of the point inserted for the edge location (p1,p2,t), or
+  // -1 if there is none.
+  vtkIdType IsInsertedEdgePoint(vtkIdType p1, vtkIdType p2, double t);
+
+  // Description:
+  // Get the edge end points and the parametric coordinate a point was
+  // inserted with, so that it can be interpolated or inserted into another
+  // locator. Return 0 if the point was not inserted with
+  // InsertUniqueEdgePoint().
+  int GetPointEdge(vtkIdType ptId, vtkIdType edge[2], double &t);
+
+  // Description:
+  // Interpolate the data of all the points inserted with
+  // InsertUniqueEdgePoint() from inPd into outPd in one pass over each
+  // array, from the edges and parametric coordinates recorded at insertion.
+  // This lets filters pass a NULL output point data to the cells and
+  // interpolate afterwards. Make sure that outPd->InterpolateAllocate(inPd)
+  // has been invoked before using this method.
+  void InterpolatePointData(vtkDataSetAttributes *inPd,
+                            vtkDataSetAttributes *outPd);
+
+  // Description:
+  // Return 1 if all the cells of a dataset insert their points with
+  // InsertUniqueEdgePoint() given input point ids when contoured or
+  // clipped, i.e. if they are linear and not vertices, 0 otherwise.
+  static int CanMergeDataSet(vtkDataSet *input);
+
+  // Description:
+  // Get the number of points inserted with InsertUniqueEdgePoint().
+  vtkIdType GetNumberOfEdgePoints();
+
+  // Description:
+  // Initialize the point insertion, also forgetting the inserted edges.
+  virtual int InitPointInsertion(vtkPoints *newPts, const double bounds[6])
+    {return this->InitPointInsertion(newPts, bounds, 0);}
+  virtual int InitPointInsertion(vtkPoints *newPts, const double bounds[6],
+                                 vtkIdType estSize);
+
+  // Description:
+  // Release the search structures, including the inserted edges.
+  virtual void Initialize();
+
+protected:
+  vtkMergeEdgePoints();
+  ~vtkMergeEdgePoints();
+
+  vtkMergeEdgePointsInternals *Internals;
+
+private:
+  vtkMergeEdgePoints(const vtkMergeEdgePoints&);  // Not implemented.
+  void operator=(const vtkMergeEdgePoints&);  // Not implemented.
+};
+
+#endif
@@ -15,7 +15,6 @@
 #include "vtkMergePoints.h"
 
 #include "vtkDataArray.h"
-#include "vtkIdList.h"
 #include "vtkObjectFactory.h"
 #include "vtkPoints.h"
 #include "vtkFloatArray.h"
@@ -28,9 +27,8 @@ vtkStandardNewMacro(vtkMergePoints);
 // -1.
 vtkIdType vtkMergePoints::IsInsertedPoint(const double x[3])
 {
-  vtkIdType i, ijk0, ijk1, ijk2;
+  vtkIdType e, ijk0, ijk1, ijk2;
   vtkIdType idx;
-  vtkIdList *bucket;
   //
   //  Locate bucket that point is in.
   //
@@ -51,9 +49,7 @@ vtkIdType vtkMergePoints::IsInsertedPoint(const double x[3])
   idx = ijk0 + ijk1*this->Divisions[0] + 
         ijk2*this->Divisions[0]*this->Divisions[1];
 
-  bucket = this->HashTable[idx];
-
-  if ( ! bucket )
+  if ( this->IsBucketEmpty(idx) )
     {
     return -1;
     }
@@ -63,13 +59,10 @@ vtkIdType vtkMergePoints::IsInsertedPoint(const double x[3])
     // Check the list of points in that bucket.
     //
     vtkIdType ptId;
-    int nbOfIds = bucket->GetNumberOfIds ();
+    vtkIdType end = this->GetBucketEnd(idx);
 
-    // For efficiency reasons, we break the data abstraction for points
-    // and ids (we are assuming and vtkIdList
-    // is storing ints).
+    // For efficiency reasons, we break the data abstraction for points.
     vtkDataArray *dataArray = this->Points->GetData();
-    vtkIdType *idArray = bucket->GetPointer(0);
     if (dataArray->GetDataType() == VTK_FLOAT)
       {
       float f[3];
@@ -78,9 +71,9 @@ vtkIdType vtkMergePoints::IsInsertedPoint(const double x[3])
       f[2] = static_cast<float>(x[2]);
       vtkFloatArray *floatArray = static_cast<vtkFloatArray *>(dataArray);
       float *pt;
-      for (i=0; i < nbOfIds; i++) 
+      for (e=this->GetBucketBegin(idx); e != end; e=this->GetNextInBucket(e))
         {
-        ptId = idArray[i];
+        ptId = this->BucketPoints[e];
         pt = floatArray->GetPointer(0) + 3*ptId;
         if ( f[0] == pt[0] && f[1] == pt[1] && f[2] == pt[2] )
           {
@@ -92,9 +85,9 @@ vtkIdType vtkMergePoints::IsInsertedPoint(const double x[3])
       {
       // Using the double interface
       double *pt;
-      for (i=0; i < nbOfIds; i++) 
+      for (e=this->GetBucketBegin(idx); e != end; e=this->GetNextInBucket(e))
         {
-        ptId = idArray[i];
+        ptId = this->BucketPoints[e];
         pt = dataArray->GetTuple(ptId);
         if ( x[0] == pt[0] && x[1] == pt[1] && x[2] == pt[2] )
           {
@@ -110,9 +103,8 @@ vtkIdType vtkMergePoints::IsInsertedPoint(const double x[3])
 
 int vtkMergePoints::InsertUniquePoint(const double x[3], vtkIdType &id)
 {
-  vtkIdType i, ijk0, ijk1, ijk2;
+  vtkIdType e, ijk0, ijk1, ijk2;
   vtkIdType idx;
-  vtkIdList *bucket;
 
   //
   //  Locate bucket that point is in.
@@ -133,21 +125,16 @@ int vtkMergePoints::InsertUniquePoint(const double x[3], vtkIdType &id)
   idx = ijk0 + ijk1*this->Divisions[0] + 
         ijk2*this->Divisions[0]*this->Divisions[1];
 
-  bucket = this->HashTable[idx];
-
-  if (bucket) // see whether we've got duplicate point
+  if ( !this->IsBucketEmpty(idx) ) // see whether we've got duplicate point
     {
     //
     // Check the list of points in that bucket.
     //
     vtkIdType ptId;
-    int nbOfIds = bucket->GetNumberOfIds ();
+    vtkIdType end = this->GetBucketEnd(idx);
 
-    // For efficiency reasons, we break the data abstraction for points
-    // and ids (we are assuming vtkPoints stores a vtkIdList
-    // is storing ints).
+    // For efficiency reasons, we break the data abstraction for points.
     vtkDataArray *dataArray = this->Points->GetData();
-    vtkIdType *idArray = bucket->GetPointer(0);
     
     if (dataArray->GetDataType() == VTK_FLOAT)
       {
@@ -157,9 +144,9 @@ int vtkMergePoints::InsertUniquePoint(const double x[3], vtkIdType &id)
       f[2] = static_cast<float>(x[2]);
       vtkFloatArray *floatArray = static_cast<vtkFloatArray *>(dataArray);
       float *pt;
-      for (i=0; i < nbOfIds; i++) 
+      for (e=this->GetBucketBegin(idx); e != end; e=this->GetNextInBucket(e))
         {
-        ptId = idArray[i];
+        ptId = this->BucketPoints[e];
         pt = floatArray->GetPointer(0) + 3*ptId;
         if ( f[0] == pt[0] && f[1] == pt[1] && f[2] == pt[2] )
           {
@@ -173,9 +160,9 @@ int vtkMergePoints::InsertUniquePoint(const double x[3], vtkIdType &id)
       {
       // Using the double interface
       double *pt;
-      for (i=0; i < nbOfIds; i++) 
+      for (e=this->GetBucketBegin(idx); e != end; e=this->GetNextInBucket(e))
         {
-        ptId = idArray[i];
+        ptId = this->BucketPoints[e];
         pt = dataArray->GetTuple(ptId);
         if ( x[0] == pt[0] && x[1] == pt[1] && x[2] == pt[2] )
           {
@@ -186,17 +173,9 @@ int vtkMergePoints::InsertUniquePoint(const double x[3], vtkIdType &id)
         }
       }
     }
-  else
-    {
-    // create a bucket point list and insert the point
-    bucket = vtkIdList::New();
-    bucket->Allocate(this->NumberOfPointsPerBucket/2,
-                     this->NumberOfPointsPerBucket/3);
-    this->HashTable[idx] = bucket;
-    }
 
   // point has to be added
-  bucket->InsertNextId(this->InsertionPointId);
+  this->InsertIntoBucket(idx, this->InsertionPointId);
   this->Points->InsertPoint(this->InsertionPointId,x);
   id = this->InsertionPointId++;
 
@@ -234,6 +234,12 @@ class VTK_FILTERING_EXPORT vtkModifiedBSPTree : public vtkAbstractCellLocator {
   protected:
    vtkModifiedBSPTree();
   ~vtkModifiedBSPTree();
+
+  // Description:
+  // FindCell() only reads the tree; IntersectWithLine() tests the cells
+  // with the locator's own GenericCell.
+  virtual int IsQueryThreadSafe(int query)
+    { return query == vtkAbstractCellLocator::FIND_CELL; }
   //
   BSPNode  *mRoot;               // bounding box root node
   int       npn;
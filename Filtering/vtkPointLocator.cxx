@@ -19,6 +19,8 @@
 #include "vtkIntArray.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
+#include "vtkParallelFor.h"
+#include "vtkPointSet.h"
 #include "vtkPolyData.h"
 
 vtkCxxRevisionMacro(vtkPointLocator, "$Revision$");
@@ -90,6 +92,48 @@ protected:
   int MaxSize;
 };
 
+// Computes the bucket of each point of a data set for BuildLocator().
+class vtkPointLocatorBucketFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkDataSet *DataSet;
+  vtkDataArray *Points; // used instead of DataSet when set
+  double Bounds[6];
+  int Divisions[3];
+  vtkIdType *Buckets;
+
+  void Execute(vtkIdType begin, vtkIdType end, int vtkNotUsed(threadId))
+    {
+    double x[3];
+    int ijk[3];
+    vtkIdType product = 
+      static_cast<vtkIdType>(this->Divisions[0])*this->Divisions[1];
+    for (vtkIdType i=begin; i<end; i++)
+      {
+      if ( this->Points )
+        {
+        this->Points->GetTuple(i, x);
+        }
+      else
+        {
+        this->DataSet->GetPoint(i, x);
+        }
+      for (int j=0; j<3; j++)
+        {
+        ijk[j] = static_cast<int>(
+          static_cast<double>((x[j] - this->Bounds[2*j]) / 
+                              (this->Bounds[2*j+1] - this->Bounds[2*j]))
+          * this->Divisions[j]);
+        if (ijk[j] >= this->Divisions[j])
+          {
+          ijk[j] = this->Divisions[j] - 1;
+          }
+        }
+      this->Buckets[i] = ijk[0] + ijk[1]*this->Divisions[0] + ijk[2]*product;
+      }
+    }
+};
+
 
 // Construct with automatic computation of divisions, averaging
 // 25 points per bucket.
@@ -99,8 +143,15 @@ vtkPointLocator::vtkPointLocator()
   this->Points = NULL;
   this->Divisions[0] = this->Divisions[1] = this->Divisions[2] = 50;
   this->NumberOfPointsPerBucket = 3;
-  this->HashTable = NULL;
   this->NumberOfBuckets = 0;
+  this->BucketOffsets = NULL;
+  this->BucketPoints = NULL;
+  this->BucketHeads = NULL;
+  this->BucketTails = NULL;
+  this->NextEntry = NULL;
+  this->NumberOfEntries = 0;
+  this->EntriesSize = 0;
+  this->BucketIds = NULL;
   this->H[0] = this->H[1] = this->H[2] = 0.0;
   this->InsertionPointId = 0;
   this->InsertionTol2 = 0.0001;
@@ -115,6 +166,11 @@ vtkPointLocator::~vtkPointLocator()
     this->Points = NULL;
     }
   this->FreeSearchStructure();
+  if ( this->BucketIds )
+    {
+    this->BucketIds->Delete();
+    this->BucketIds = NULL;
+    }
 }
 
 void vtkPointLocator::Initialize()
@@ -129,21 +185,54 @@ void vtkPointLocator::Initialize()
 
 void vtkPointLocator::FreeSearchStructure()
 {
-  vtkIdList *ptIds;
-  vtkIdType i;
+  delete [] this->BucketOffsets;
+  this->BucketOffsets = NULL;
+  delete [] this->BucketPoints;
+  this->BucketPoints = NULL;
+  delete [] this->BucketHeads;
+  this->BucketHeads = NULL;
+  delete [] this->BucketTails;
+  this->BucketTails = NULL;
+  delete [] this->NextEntry;
+  this->NextEntry = NULL;
+  this->NumberOfEntries = 0;
+  this->EntriesSize = 0;
+}
 
-  if ( this->HashTable )
+// Append ptId to the end of bucket idx, keeping the points of a bucket in
+// insertion order.
+void vtkPointLocator::InsertIntoBucket(vtkIdType idx, vtkIdType ptId)
+{
+  if ( this->NumberOfEntries >= this->EntriesSize )
     {
-    for (i=0; i<this->NumberOfBuckets; i++)
+    vtkIdType newSize = 2*this->EntriesSize + 1;
+    vtkIdType *points = new vtkIdType[newSize];
+    vtkIdType *next = new vtkIdType[newSize];
+    if ( this->NumberOfEntries > 0 )
       {
-      if ( (ptIds = this->HashTable[i]) )
-        {
-        ptIds->Delete();
-        }
+      memcpy(points, this->BucketPoints,
+             this->NumberOfEntries*sizeof(vtkIdType));
+      memcpy(next, this->NextEntry, this->NumberOfEntries*sizeof(vtkIdType));
       }
-    delete [] this->HashTable;
-    this->HashTable = NULL;
+    delete [] this->BucketPoints;
+    delete [] this->NextEntry;
+    this->BucketPoints = points;
+    this->NextEntry = next;
+    this->EntriesSize = newSize;
+    }
+
+  vtkIdType e = this->NumberOfEntries++;
+  this->BucketPoints[e] = ptId;
+  this->NextEntry[e] = -1;
+  if ( this->BucketTails[idx] < 0 )
+    {
+    this->BucketHeads[idx] = e;
     }
+  else
+    {
+    this->NextEntry[this->BucketTails[idx]] = e;
+    }
+  this->BucketTails[idx] = e;
 }
 
 // Given a position x, return the id of the point closest to it.
@@ -155,7 +244,7 @@ vtkIdType vtkPointLocator::FindClosestPoint(const double x[3])
   double pt[3];
   int closest, level;
   vtkIdType ptId, cno;
-  vtkIdList *ptIds;
+  vtkIdType e;
   int ijk[3], *nei;
   vtkNeighborPoints buckets;
 
@@ -201,11 +290,12 @@ vtkIdType vtkPointLocator::FindClosestPoint(const double x[3])
       cno = nei[0] + nei[1]*this->Divisions[0] + 
             nei[2]*this->Divisions[0]*this->Divisions[1];
 
-      if ( (ptIds = this->HashTable[cno]) != NULL )
+      if ( !this->IsBucketEmpty(cno) )
         {
-        for (j=0; j < ptIds->GetNumberOfIds(); j++) 
+        for (e = this->GetBucketBegin(cno); e != this->GetBucketEnd(cno);
+             e = this->GetNextInBucket(e))
           {
-          ptId = ptIds->GetId(j);
+          ptId = this->BucketPoints[e];
           this->DataSet->GetPoint(ptId, pt);
           if ( (dist2 = vtkMath::Distance2BetweenPoints(x,pt)) < minDist2 ) 
             {
@@ -230,11 +320,12 @@ vtkIdType vtkPointLocator::FindClosestPoint(const double x[3])
       cno = nei[0] + nei[1]*this->Divisions[0] + 
             nei[2]*this->Divisions[0]*this->Divisions[1];
 
-      if ( (ptIds = this->HashTable[cno]) != NULL )
+      if ( !this->IsBucketEmpty(cno) )
         {
-        for (j=0; j < ptIds->GetNumberOfIds(); j++) 
+        for (e = this->GetBucketBegin(cno); e != this->GetBucketEnd(cno);
+             e = this->GetNextInBucket(e))
           {
-          ptId = ptIds->GetId(j);
+          ptId = this->BucketPoints[e];
           this->DataSet->GetPoint(ptId, pt);
           if ( (dist2 = vtkMath::Distance2BetweenPoints(x,pt)) < minDist2 ) 
             {
@@ -264,8 +355,8 @@ vtkIdType vtkPointLocator::FindClosestPointWithinRadius(double radius,
 {
   int i, j;
   double pt[3];
-  vtkIdType ptId, closest = -1;
-  vtkIdList *ptIds;
+  vtkIdType ptId, closest = -1, cno;
+  vtkIdType e;
   int ijk[3], *nei;
   double minDist2;
   
@@ -306,12 +397,14 @@ vtkIdType vtkPointLocator::FindClosestPointWithinRadius(double radius,
 
   // Start by searching the bucket that the point is in.
   //
-  if ( (ptIds = this->HashTable[ijk[0] + ijk[1]*this->Divisions[0] + 
-    ijk[2]*this->Divisions[0]*this->Divisions[1]]) != NULL )
+  cno = ijk[0] + ijk[1]*this->Divisions[0] +
+    ijk[2]*this->Divisions[0]*this->Divisions[1];
+  if ( !this->IsBucketEmpty(cno) )
     {
-    for (j=0; j < ptIds->GetNumberOfIds(); j++) 
+    for (e = this->GetBucketBegin(cno); e != this->GetBucketEnd(cno);
+         e = this->GetNextInBucket(e))
       {
-      ptId = ptIds->GetId(j);
+      ptId = this->BucketPoints[e];
       if (flag)
         {
         pointData->GetTuple(ptId, pt);
@@ -400,12 +493,13 @@ vtkIdType vtkPointLocator::FindClosestPointWithinRadius(double radius,
       // do we still need to test this bucket?
       if (this->Distance2ToBucket(x, nei) < refinedRadius2)
         {
-        ptIds = this->HashTable[nei[0] + nei[1]*this->Divisions[0] + 
-          nei[2]*numberOfBucketsPerPlane];
+        cno = nei[0] + nei[1]*this->Divisions[0] +
+          nei[2]*numberOfBucketsPerPlane;
 
-        for (j=0; j < ptIds->GetNumberOfIds(); j++) 
+        for (e = this->GetBucketBegin(cno); e != this->GetBucketEnd(cno);
+             e = this->GetNextInBucket(e))
           {
-          ptId = ptIds->GetId(j);
+          ptId = this->BucketPoints[e];
           if (flag)
             {
             pointData->GetTuple(ptId, pt);
@@ -556,7 +650,7 @@ void vtkPointLocator::FindDistributedPoints(int N, const double x[3],
   double pt[3];
   int level;
   vtkIdType ptId, cno;
-  vtkIdList *ptIds;
+  vtkIdType e;
   int ijk[3], *nei;
   int oct;
   int pointsChecked = 0;
@@ -615,12 +709,13 @@ void vtkPointLocator::FindDistributedPoints(int N, const double x[3],
       cno = nei[0] + nei[1]*this->Divisions[0] + 
             nei[2]*this->Divisions[0]*this->Divisions[1];
 
-      if ( (ptIds = this->HashTable[cno]) != NULL )
+      if ( !this->IsBucketEmpty(cno) )
         {
-        for (j=0; j < ptIds->GetNumberOfIds(); j++) 
+        for (e = this->GetBucketBegin(cno); e != this->GetBucketEnd(cno);
+             e = this->GetNextInBucket(e))
           {
           pointsChecked++;
-          ptId = ptIds->GetId(j);
+          ptId = this->BucketPoints[e];
           this->DataSet->GetPoint(ptId, pt);
           dist2 = vtkMath::Distance2BetweenPoints(x,pt);
           oct = GetOctent(x,pt);
@@ -670,12 +765,13 @@ void vtkPointLocator::FindDistributedPoints(int N, const double x[3],
     cno = nei[0] + nei[1]*this->Divisions[0] + 
       nei[2]*this->Divisions[0]*this->Divisions[1];
     
-    if ( (ptIds = this->HashTable[cno]) != NULL )
+    if ( !this->IsBucketEmpty(cno) )
       {
-      for (j=0; j < ptIds->GetNumberOfIds(); j++) 
+      for (e = this->GetBucketBegin(cno); e != this->GetBucketEnd(cno);
+           e = this->GetNextInBucket(e))
         {
         pointsChecked++;
-        ptId = ptIds->GetId(j);
+        ptId = this->BucketPoints[e];
         this->DataSet->GetPoint(ptId, pt);
         dist2 = vtkMath::Distance2BetweenPoints(x,pt);
         oct = GetOctent(x,pt);
@@ -709,7 +805,7 @@ void vtkPointLocator::FindClosestNPoints(int N, const double x[3],
   double pt[3];
   int level;
   vtkIdType ptId, cno;
-  vtkIdList *ptIds;
+  vtkIdType e;
   int ijk[3], *nei;
   vtkNeighborPoints buckets;
   
@@ -754,11 +850,12 @@ void vtkPointLocator::FindClosestNPoints(int N, const double x[3],
       cno = nei[0] + nei[1]*this->Divisions[0] + 
             nei[2]*this->Divisions[0]*this->Divisions[1];
 
-      if ( (ptIds = this->HashTable[cno]) != NULL )
+      if ( !this->IsBucketEmpty(cno) )
         {
-        for (j=0; j < ptIds->GetNumberOfIds(); j++) 
+        for (e = this->GetBucketBegin(cno); e != this->GetBucketEnd(cno);
+             e = this->GetNextInBucket(e))
           {
-          ptId = ptIds->GetId(j);
+          ptId = this->BucketPoints[e];
           this->DataSet->GetPoint(ptId, pt);
           dist2 = vtkMath::Distance2BetweenPoints(x,pt);
           if (currentCount < N)
@@ -801,11 +898,12 @@ void vtkPointLocator::FindClosestNPoints(int N, const double x[3],
     cno = nei[0] + nei[1]*this->Divisions[0] + 
       nei[2]*this->Divisions[0]*this->Divisions[1];
     
-    if ( (ptIds = this->HashTable[cno]) != NULL )
+    if ( !this->IsBucketEmpty(cno) )
       {
-      for (j=0; j < ptIds->GetNumberOfIds(); j++) 
+      for (e = this->GetBucketBegin(cno); e != this->GetBucketEnd(cno);
+           e = this->GetNextInBucket(e))
         {
-        ptId = ptIds->GetId(j);
+        ptId = this->BucketPoints[e];
         this->DataSet->GetPoint(ptId, pt);
         dist2 = vtkMath::Distance2BetweenPoints(x,pt);
         if (dist2 < maxDistance)
@@ -836,7 +934,7 @@ void vtkPointLocator::FindPointsWithinRadius(double R, const double x[3],
   double dist2;
   double pt[3];
   vtkIdType ptId, cno;
-  vtkIdList *ptIds;
+  vtkIdType e;
   int ijk[3], *nei;
   double R2 = R*R;
   vtkNeighborPoints buckets;
@@ -875,11 +973,12 @@ void vtkPointLocator::FindPointsWithinRadius(double R, const double x[3],
     cno = nei[0] + nei[1]*this->Divisions[0] + 
       nei[2]*this->Divisions[0]*this->Divisions[1];
     
-    if ( (ptIds = this->HashTable[cno]) != NULL )
+    if ( !this->IsBucketEmpty(cno) )
       {
-      for (j=0; j < ptIds->GetNumberOfIds(); j++) 
+      for (e = this->GetBucketBegin(cno); e != this->GetBucketEnd(cno);
+           e = this->GetNextInBucket(e))
         {
-        ptId = ptIds->GetId(j);
+        ptId = this->BucketPoints[e];
         this->DataSet->GetPoint(ptId, pt);
         dist2 = vtkMath::Distance2BetweenPoints(x,pt);
         if (dist2 <= R2)
@@ -902,15 +1001,12 @@ void vtkPointLocator::BuildLocator()
   double *bounds;
   vtkIdType numBuckets;
   double level;
-  int ndivs[3], product;
-  int i, j, ijk[3];
-  vtkIdType idx;
-  vtkIdList *bucket;
+  int ndivs[3];
+  int i;
+  vtkIdType idx, ptId;
   vtkIdType numPts;
-  double x[3];
-  typedef vtkIdList *vtkIdListPtr;
 
-  if ( (this->HashTable != NULL) && (this->BuildTime > this->MTime)
+  if ( this->HasBuckets() && (this->BuildTime > this->MTime)
        && (this->BuildTime > this->DataSet->GetMTime()) )
     {
     return;
@@ -927,10 +1023,7 @@ void vtkPointLocator::BuildLocator()
   //
   //  Make sure the appropriate data is available
   //
-  if ( this->HashTable )
-    {
-    this->FreeSearchStructure();
-    }
+  this->FreeSearchStructure();
   //
   //  Size the root bucket.  Initialize bucket data structure, compute 
   //  level and divisions.
@@ -971,8 +1064,6 @@ void vtkPointLocator::BuildLocator()
     }
 
   this->NumberOfBuckets = numBuckets = ndivs[0]*ndivs[1]*ndivs[2];
-  this->HashTable = new vtkIdListPtr[numBuckets];
-  memset (this->HashTable, 0, numBuckets*sizeof(vtkIdListPtr));
   //
   //  Compute width of bucket in three directions
   //
@@ -981,37 +1072,59 @@ void vtkPointLocator::BuildLocator()
     this->H[i] = (this->Bounds[2*i+1] - this->Bounds[2*i]) / ndivs[i] ;
     }
   //
-  //  Insert each point into the appropriate bucket.  Make sure point
-  //  falls within bucket.
+  //  Find the bucket of each point, in parallel. Make sure point falls
+  //  within bucket. Only the points of a vtkPointSet are read from
+  //  several threads; other data sets may compute or cache their points.
   //
-  product = ndivs[0]*ndivs[1];
-  for (i=0; i<numPts; i++) 
+  vtkIdType *ptBuckets = new vtkIdType[numPts];
+  vtkPointLocatorBucketFunctor functor;
+  functor.DataSet = this->DataSet;
+  functor.Points = NULL;
+  vtkPointSet *pointSet = vtkPointSet::SafeDownCast(this->DataSet);
+  if ( pointSet && pointSet->GetPoints() )
     {
-    this->DataSet->GetPoint(i, x);
-    for (j=0; j<3; j++) 
-      {
-      ijk[j] = static_cast<int>(
-        static_cast<double>((x[j] - this->Bounds[2*j]) / 
-                            (this->Bounds[2*j+1] - this->Bounds[2*j]))
-        * ndivs[j]);
-      
-      if (ijk[j] >= this->Divisions[j])
-        {
-        ijk[j] = this->Divisions[j] - 1;
-        }
-      }
-
-    idx = ijk[0] + ijk[1]*ndivs[0] + ijk[2]*product;
-    bucket = this->HashTable[idx];
-    if ( ! bucket )
-      {
-      bucket = vtkIdList::New();
-      bucket->Allocate(this->NumberOfPointsPerBucket,
-                       this->NumberOfPointsPerBucket/3);
-      this->HashTable[idx] = bucket;
-      }
-    bucket->InsertNextId(i);
+    functor.Points = pointSet->GetPoints()->GetData();
+    }
+  for (i=0; i<6; i++)
+    {
+    functor.Bounds[i] = this->Bounds[i];
+    }
+  for (i=0; i<3; i++)
+    {
+    functor.Divisions[i] = ndivs[i];
     }
+  functor.Buckets = ptBuckets;
+  vtkParallelFor *parallelFor = vtkParallelFor::New();
+  if ( !functor.Points )
+    {
+    parallelFor->SetNumberOfThreads(1);
+    }
+  parallelFor->Execute(0, numPts, &functor);
+  parallelFor->Delete();
+  //
+  //  Counting sort of the point ids into contiguous buckets. Points keep
+  //  their relative order within a bucket.
+  //
+  this->BucketOffsets = new vtkIdType[numBuckets+1];
+  memset(this->BucketOffsets, 0, (numBuckets+1)*sizeof(vtkIdType));
+  for (ptId=0; ptId<numPts; ptId++)
+    {
+    this->BucketOffsets[ptBuckets[ptId]+1]++;
+    }
+  for (idx=0; idx<numBuckets; idx++)
+    {
+    this->BucketOffsets[idx+1] += this->BucketOffsets[idx];
+    }
+  this->BucketPoints = new vtkIdType[numPts];
+  this->NumberOfEntries = this->EntriesSize = numPts;
+  vtkIdType *next = new vtkIdType[numBuckets];
+  memcpy(next, this->BucketOffsets, numBuckets*sizeof(vtkIdType));
+  for (ptId=0; ptId<numPts; ptId++)
+    {
+    this->BucketPoints[next[ptBuckets[ptId]]++] = ptId;
+    }
+  delete [] next;
+  delete [] ptBuckets;
 
   this->BuildTime.Modified();
 }
@@ -1205,7 +1318,7 @@ void vtkPointLocator::GetOverlappingBuckets(vtkNeighborPoints* buckets,
           continue;
           }
         // if this bucket has any cells, add it to the list
-        if (this->HashTable[i + jFactor + kFactor])
+        if (!this->IsBucketEmpty(i + jFactor + kFactor))
           {
           nei[0]=i; nei[1]=j; nei[2]=k;
           buckets->InsertNextPoint(nei);
@@ -1241,16 +1354,13 @@ int vtkPointLocator::InitPointInsertion(vtkPoints *newPts,
 {
   int i;
   int maxDivs;
-  typedef vtkIdList *vtkIdListPtr;
+  vtkIdType idx;
   double hmin;
   int ndivs[3];
   double level;
 
   this->InsertionPointId = 0;
-  if ( this->HashTable )
-    {
-    this->FreeSearchStructure();
-    }
+  this->FreeSearchStructure();
   if ( newPts == NULL )
     {
     vtkErrorMacro(<<"Must define points for point insertion");
@@ -1298,9 +1408,15 @@ int vtkPointLocator::InitPointInsertion(vtkPoints *newPts,
     }
 
   this->NumberOfBuckets = ndivs[0]*ndivs[1]*ndivs[2];
-  this->HashTable = new vtkIdListPtr[this->NumberOfBuckets];
-  memset (this->HashTable, 0, this->NumberOfBuckets*
-          sizeof(vtkIdListPtr));
+  this->BucketHeads = new vtkIdType[this->NumberOfBuckets];
+  this->BucketTails = new vtkIdType[this->NumberOfBuckets];
+  for (idx=0; idx<this->NumberOfBuckets; idx++)
+    {
+    this->BucketHeads[idx] = this->BucketTails[idx] = -1;
+    }
+  this->EntriesSize = (estNumPts > 0 ? estNumPts : VTK_INITIAL_SIZE);
+  this->BucketPoints = new vtkIdType[this->EntriesSize];
+  this->NextEntry = new vtkIdType[this->EntriesSize];
   //
   //  Compute width of bucket in three directions
   //
@@ -1334,7 +1450,6 @@ vtkIdType vtkPointLocator::InsertNextPoint(const double x[3])
 {
   int i, ijk[3];
   vtkIdType idx;
-  vtkIdList *bucket;
   //
   //  Locate bucket that point is in.
   //
@@ -1353,15 +1468,7 @@ vtkIdType vtkPointLocator::InsertNextPoint(const double x[3])
   idx = ijk[0] + ijk[1]*this->Divisions[0] + 
         ijk[2]*this->Divisions[0]*this->Divisions[1];
 
-  if ( ! (bucket = this->HashTable[idx]) )
-    {
-    bucket = vtkIdList::New();
-    bucket->Allocate(this->NumberOfPointsPerBucket/2,
-                     this->NumberOfPointsPerBucket/3);
-    this->HashTable[idx] = bucket;
-    }
-
-  bucket->InsertNextId(this->InsertionPointId);
+  this->InsertIntoBucket(idx, this->InsertionPointId);
   this->Points->InsertPoint(this->InsertionPointId,x);
   return this->InsertionPointId++;
 }
@@ -1376,7 +1483,6 @@ void vtkPointLocator::InsertPoint(vtkIdType ptId, const double x[3])
 {
   int i, ijk[3];
   vtkIdType idx;
-  vtkIdList *bucket;
   //
   //  Locate bucket that point is in.
   //
@@ -1395,15 +1501,7 @@ void vtkPointLocator::InsertPoint(vtkIdType ptId, const double x[3])
   idx = ijk[0] + ijk[1]*this->Divisions[0] + 
         ijk[2]*this->Divisions[0]*this->Divisions[1];
 
-  if ( ! (bucket = this->HashTable[idx]) )
-    {
-    bucket = vtkIdList::New();
-    bucket->Allocate(this->NumberOfPointsPerBucket,
-                     this->NumberOfPointsPerBucket/3);
-    this->HashTable[idx] = bucket;
-    }
-
-  bucket->InsertNextId(ptId);
+  this->InsertIntoBucket(idx, ptId);
   this->Points->InsertPoint(ptId,x);
 }
 
@@ -1412,7 +1510,7 @@ void vtkPointLocator::InsertPoint(vtkIdType ptId, const double x[3])
 // -1.
 vtkIdType vtkPointLocator::IsInsertedPoint(const double x[3])
 {
-  int i, j, ijk[3];
+  int i, ijk[3];
   vtkNeighborPoints buckets;
 
   //  Locate bucket that point is in.
@@ -1436,7 +1534,7 @@ vtkIdType vtkPointLocator::IsInsertedPoint(const double x[3])
   //
   int *nei, lvtk;
   vtkIdType ptId, cno;
-  vtkIdList *ptIds;
+  vtkIdType e;
   double pt[3];
 
   for (lvtk=0; lvtk <= this->InsertionLevel; lvtk++)
@@ -1449,11 +1547,12 @@ vtkIdType vtkPointLocator::IsInsertedPoint(const double x[3])
       cno = nei[0] + nei[1]*this->Divisions[0] + 
         nei[2]*this->Divisions[0]*this->Divisions[1];
 
-      if ( (ptIds = this->HashTable[cno]) != NULL )
+      if ( !this->IsBucketEmpty(cno) )
         {
-        for (j=0; j < ptIds->GetNumberOfIds(); j++) 
+        for (e = this->GetBucketBegin(cno); e != this->GetBucketEnd(cno);
+             e = this->GetNextInBucket(e))
           {
-          ptId = ptIds->GetId(j);
+          ptId = this->BucketPoints[e];
           this->Points->GetPoint(ptId, pt);
 
           if ( vtkMath::Distance2BetweenPoints(x,pt) <= this->InsertionTol2 )
@@ -1497,7 +1596,7 @@ vtkIdType vtkPointLocator::FindClosestInsertedPoint(const double x[3])
   int level;
   vtkIdType closest, j;
   vtkIdType ptId, cno;
-  vtkIdList *ptIds;
+  vtkIdType e;
   int ijk[3], *nei;
   int MULTIPLES;
   double diff;
@@ -1543,11 +1642,12 @@ vtkIdType vtkPointLocator::FindClosestInsertedPoint(const double x[3])
       cno = nei[0] + nei[1]*this->Divisions[0] + 
             nei[2]*this->Divisions[0]*this->Divisions[1];
 
-      if ( (ptIds = this->HashTable[cno]) != NULL )
+      if ( !this->IsBucketEmpty(cno) )
         {
-        for (j=0; j < ptIds->GetNumberOfIds(); j++) 
+        for (e = this->GetBucketBegin(cno); e != this->GetBucketEnd(cno);
+             e = this->GetNextInBucket(e))
           {
-          ptId = ptIds->GetId(j);
+          ptId = this->BucketPoints[e];
           this->Points->GetPoint(ptId, pt);
           if ( (dist2 = vtkMath::Distance2BetweenPoints(x,pt)) < minDist2 ) 
             {
@@ -1586,11 +1686,12 @@ vtkIdType vtkPointLocator::FindClosestInsertedPoint(const double x[3])
         {
         cno = nei[0] + nei[1]*this->Divisions[0] + nei[2]*this->Divisions[0]*this->Divisions[1];
 
-        if ( (ptIds = this->HashTable[cno]) )
+        if ( !this->IsBucketEmpty(cno) )
           {
-          for (j=0; j < ptIds->GetNumberOfIds(); j++) 
+          for (e = this->GetBucketBegin(cno); e != this->GetBucketEnd(cno);
+               e = this->GetNextInBucket(e))
             {
-            ptId = ptIds->GetId(j);
+            ptId = this->BucketPoints[e];
             this->Points->GetPoint(ptId, pt);
             if ( (dist2 = vtkMath::Distance2BetweenPoints(x,pt)) < minDist2 ) 
               {
@@ -1636,12 +1737,25 @@ vtkIdList *vtkPointLocator::GetPointsInBucket(const double x[3],
   
   // Get the id list, if any
   //
-  if ( this->HashTable )
+  if ( this->HasBuckets() )
     {
-    int idx = ijk[0] + ijk[1]*this->Divisions[0] + 
-              ijk[2]*this->Divisions[0]*this->Divisions[1];
-
-    return this->HashTable[idx];
+    vtkIdType idx = ijk[0] + ijk[1]*this->Divisions[0] + 
+                    ijk[2]*this->Divisions[0]*this->Divisions[1];
+    if ( this->IsBucketEmpty(idx) )
+      {
+      return NULL;
+      }
+    if ( !this->BucketIds )
+      {
+      this->BucketIds = vtkIdList::New();
+      }
+    this->BucketIds->Reset();
+    for (vtkIdType e = this->GetBucketBegin(idx);
+         e != this->GetBucketEnd(idx); e = this->GetNextInBucket(e))
+      {
+      this->BucketIds->InsertNextId(this->BucketPoints[e]);
+      }
+    return this->BucketIds;
     }
 
   return NULL;
@@ -1657,7 +1771,7 @@ void vtkPointLocator::GenerateRepresentation(int vtkNotUsed(level),
   vtkCellArray *polys;
   int ii, i, j, k, idx, offset[3], minusOffset[3], inside, sliceSize;
 
-  if ( this->HashTable == NULL ) 
+  if ( !this->HasBuckets() ) 
     {
     vtkErrorMacro(<<"Can't build representation...no data!");
     return;
@@ -1683,7 +1797,7 @@ void vtkPointLocator::GenerateRepresentation(int vtkNotUsed(level),
         offset[0] = i;
         minusOffset[0] = i - 1;
         idx = offset[0] + offset[1] + offset[2];
-        if ( this->HashTable[idx] == NULL )
+        if ( this->IsBucketEmpty(idx) )
           {
           inside = 0;
           }
@@ -1717,8 +1831,8 @@ void vtkPointLocator::GenerateRepresentation(int vtkNotUsed(level),
               idx = offset[0] + offset[1] + minusOffset[2];
               }
 
-            if ( (this->HashTable[idx] == NULL && inside) ||
-            (this->HashTable[idx] != NULL && !inside) )
+            if ( (this->IsBucketEmpty(idx) && inside) ||
+            (!this->IsBucketEmpty(idx) && !inside) )
               {
               this->GenerateFace(ii,i,j,k,pts,polys);
               }
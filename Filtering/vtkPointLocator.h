@@ -180,7 +180,8 @@ public:
   // Given a position x, return the list of points in the bucket that
   // contains the point. It is possible that NULL is returned. The user
   // provides an ijk array that is the indices into the locator.
-  // This method is thread safe.
+  // The returned list is owned by the locator and is overwritten by the
+  // next call, so this method is not thread safe.
   virtual vtkIdList *GetPointsInBucket(const double x[3], int ijk[3]);
 
   // Description:
@@ -214,11 +215,38 @@ protected:
   double Distance2ToBucket(const double x[3], const int nei[3]);
   double Distance2ToBounds(const double x[3], const double bounds[6]);
 
+  // Bucket traversal. The points of bucket idx are BucketPoints[e] for
+  // e = GetBucketBegin(idx); e != GetBucketEnd(idx); e = GetNextInBucket(e).
+  // After BuildLocator() the buckets are stored contiguously (CSR) and
+  // indexed by BucketOffsets; while inserting points they are chains
+  // linked through NextEntry.
+  vtkIdType GetBucketBegin(vtkIdType idx)
+    {return this->BucketOffsets ? this->BucketOffsets[idx] :
+       this->BucketHeads[idx];}
+  vtkIdType GetBucketEnd(vtkIdType idx)
+    {return this->BucketOffsets ? this->BucketOffsets[idx+1] : -1;}
+  vtkIdType GetNextInBucket(vtkIdType e)
+    {return this->BucketOffsets ? e+1 : this->NextEntry[e];}
+  int IsBucketEmpty(vtkIdType idx)
+    {return this->GetBucketBegin(idx) == this->GetBucketEnd(idx);}
+  int HasBuckets()
+    {return this->BucketOffsets != NULL || this->BucketHeads != NULL;}
+
+  // Append ptId to bucket idx while inserting points.
+  void InsertIntoBucket(vtkIdType idx, vtkIdType ptId);
+
   vtkPoints *Points; // Used for merging points
   int Divisions[3]; // Number of sub-divisions in x-y-z directions
   int NumberOfPointsPerBucket; //Used with previous boolean to control subdivide
-  vtkIdList **HashTable; // lists of point ids in buckets
   vtkIdType NumberOfBuckets; // total size of hash table
+  vtkIdType *BucketOffsets; // start of each bucket in BucketPoints
+  vtkIdType *BucketPoints; // point ids sorted by bucket
+  vtkIdType *BucketHeads; // first entry of each bucket while inserting
+  vtkIdType *BucketTails; // last entry of each bucket while inserting
+  vtkIdType *NextEntry; // next entry in the same bucket while inserting
+  vtkIdType NumberOfEntries; // entries used in BucketPoints/NextEntry
+  vtkIdType EntriesSize; // entries allocated in BucketPoints/NextEntry
+  vtkIdList *BucketIds; // returned by GetPointsInBucket()
   double H[3]; // width of each bucket in x-y-z directions
 
   double InsertionTol2;
@@ -14,24 +14,28 @@
 =========================================================================*/
 #include "vtkScalarTree.h"
 
+#include "vtkDataArray.h"
 #include "vtkDataSet.h"
 #include "vtkGarbageCollector.h"
 #include "vtkObjectFactory.h"
 
 vtkCxxRevisionMacro(vtkScalarTree, "$Revision$");
 vtkCxxSetObjectMacro(vtkScalarTree,DataSet,vtkDataSet);
+vtkCxxSetObjectMacro(vtkScalarTree,Scalars,vtkDataArray);
 
 // Instantiate scalar tree with maximum level of 20 and branching
 // factor of 5.
 vtkScalarTree::vtkScalarTree()
 {
   this->DataSet = NULL;
+  this->Scalars = NULL;
   this->ScalarValue = 0.0;
 }
 
 vtkScalarTree::~vtkScalarTree()
 {
   this->SetDataSet(NULL);
+  this->SetScalars(NULL);
 }
 
 void vtkScalarTree::PrintSelf(ostream& os, vtkIndent indent)
@@ -47,6 +51,15 @@ void vtkScalarTree::PrintSelf(ostream& os, vtkIndent indent)
     os << indent << "DataSet: (none)\n";
     }
 
+  if ( this->Scalars )
+    {
+    os << indent << "Scalars: " << this->Scalars << "\n";
+    }
+  else
+    {
+    os << indent << "Scalars: (none)\n";
+    }
+
   os << indent << "Build Time: " << this->BuildTime.GetMTime() << "\n";
 }
 
@@ -27,7 +27,7 @@
 // scalar value specified.
 
 // .SECTION See Also
-// vtkSimpleScalarTree 
+// vtkSimpleScalarTree vtkSpanSpace
 
 #ifndef __vtkScalarTree_h
 #define __vtkScalarTree_h
@@ -51,6 +51,12 @@ public:
   virtual void SetDataSet(vtkDataSet*);
   vtkGetObjectMacro(DataSet,vtkDataSet);
 
+  // Description:
+  // Set/Get the point scalars to organize the cells by. If none are given,
+  // the active point scalars of the dataset are used.
+  virtual void SetScalars(vtkDataArray*);
+  vtkGetObjectMacro(Scalars,vtkDataArray);
+
   // Description:
   // Construct the scalar tree from the dataset provided. Checks build times
   // and modified time from input and reconstructs the tree if necessary.
@@ -39,6 +39,7 @@ public:
 vtkSimpleScalarTree::vtkSimpleScalarTree()
 {
   this->DataSet = NULL;
+  this->BuiltScalars = NULL;
   this->Level = 0;
   this->MaxLevel = 20;
   this->BranchingFactor = 3;
@@ -85,16 +86,23 @@ void vtkSimpleScalarTree::BuildTree()
     return;
     }
 
+  vtkDataArray *scalars = this->GetScalars();
+  if ( !scalars )
+    {
+    scalars = this->DataSet->GetPointData()->GetScalars();
+    }
+
   if ( this->Tree != NULL && this->BuildTime > this->MTime 
-    && this->BuildTime > this->DataSet->GetMTime() )
+    && this->BuildTime > this->DataSet->GetMTime()
+    && this->BuiltScalars == scalars )
     {
     return;
     }
 
   vtkDebugMacro( << "Building scalar tree..." );
 
-  this->Scalars = this->DataSet->GetPointData()->GetScalars();
-  if ( ! this->Scalars )
+  this->BuiltScalars = scalars;
+  if ( ! this->BuiltScalars )
     {
     vtkErrorMacro( << "No scalar data to build trees with");
     return;
@@ -136,7 +144,7 @@ void vtkSimpleScalarTree::BuildTree()
       cellPts = cell->GetPointIds();
       numScalars = cellPts->GetNumberOfIds();
       cellScalars->SetNumberOfTuples(numScalars);
-      this->Scalars->GetTuples(cellPts, cellScalars);
+      this->BuiltScalars->GetTuples(cellPts, cellScalars);
       s = cellScalars->GetPointer(0);
 
       for ( j=0; j < numScalars; j++ )
@@ -300,7 +308,7 @@ vtkCell *vtkSimpleScalarTree::GetNextCell(vtkIdType& cellId,
                                           vtkIdList* &cellPts,
                                           vtkDataArray *cellScalars)
 {
-  double s, min=VTK_DOUBLE_MAX, max=(-VTK_DOUBLE_MAX);
+  double s, min, max;
   vtkIdType i, numScalars;
   vtkCell *cell;
   vtkIdType numCells = this->DataSet->GetNumberOfCells();
@@ -314,7 +322,9 @@ vtkCell *vtkSimpleScalarTree::GetNextCell(vtkIdType& cellId,
       cellPts = cell->GetPointIds();
       numScalars = cellPts->GetNumberOfIds();
       cellScalars->SetNumberOfTuples(numScalars);
-      this->Scalars->GetTuples(cellPts, cellScalars);
+      this->BuiltScalars->GetTuples(cellPts, cellScalars);
+      min = VTK_DOUBLE_MAX;
+      max = -VTK_DOUBLE_MAX;
       for (i=0; i < numScalars; i++)
         {
         s = cellScalars->GetTuple1(i);
@@ -0,0 +1,329 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkSpanSpace.h"
+
+#include "vtkCell.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkIdList.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+#include <math.h>
+
+vtkCxxRevisionMacro(vtkSpanSpace, "$Revision$");
+vtkStandardNewMacro(vtkSpanSpace);
+
+//----------------------------------------------------------------------------
+// A cell in span space.
+struct vtkSpanSpaceCell
+{
+  double Min;
+  double Max;
+  vtkIdType CellId;
+};
+
+// Orders the cells of a row by decreasing max.
+static bool vtkSpanSpaceMaxGreater(const vtkSpanSpaceCell &a,
+                                   const vtkSpanSpaceCell &b)
+{
+  return a.Max > b.Max;
+}
+
+// The cells sorted by row and by decreasing max within each row, the start
+// of each row, and the cells found by the last traversal.
+class vtkSpanSpaceInternals
+{
+public:
+  vtkstd::vector<vtkSpanSpaceCell> Cells;
+  vtkstd::vector<vtkIdType> Rows;
+  vtkstd::vector<vtkIdType> ActiveCells;
+  vtkIdType Current;
+  vtkDataArray *Scalars; //the scalars the span space was built from
+  double Min;   //the range of the cell minimums
+  double Max;
+  double Scale; //the number of rows per unit of scalar
+  int Resolution;
+
+  vtkSpanSpaceInternals()
+    {
+    this->Current = 0;
+    this->Scalars = NULL;
+    this->Min = this->Max = this->Scale = 0.0;
+    this->Resolution = 0;
+    }
+
+  // The row of the cells whose min is s. Only monotony matters: a cell in
+  // a row below the row of a value has a smaller min, one in a row above a
+  // larger min.
+  int GetRow(double s)
+    {
+    double row = floor((s - this->Min) * this->Scale);
+    if ( row < 0.0 )
+      {
+      return 0;
+      }
+    if ( row >= this->Resolution - 1 )
+      {
+      return this->Resolution - 1;
+      }
+    return static_cast<int>(row);
+    }
+};
+
+//----------------------------------------------------------------------------
+// Compute the scalar range of the cells from the first component of the
+// scalars.
+template <class T>
+void vtkSpanSpaceComputeRanges(vtkDataSet *input, T *s, int numComp,
+                               vtkSpanSpaceCell *cells)
+{
+  vtkIdList *cellPts = vtkIdList::New();
+  vtkIdType numCells = input->GetNumberOfCells();
+  for (vtkIdType cellId=0; cellId < numCells; cellId++)
+    {
+    input->GetCellPoints(cellId, cellPts);
+    vtkIdType numPts = cellPts->GetNumberOfIds();
+    vtkIdType *pts = cellPts->GetPointer(0);
+    double min = VTK_DOUBLE_MAX, max = -VTK_DOUBLE_MAX;
+    for (vtkIdType i=0; i < numPts; i++)
+      {
+      double value = static_cast<double>(s[pts[i]*numComp]);
+      if ( value < min )
+        {
+        min = value;
+        }
+      if ( value > max )
+        {
+        max = value;
+        }
+      }
+    cells[cellId].Min = min;
+    cells[cellId].Max = max;
+    cells[cellId].CellId = cellId;
+    }
+  cellPts->Delete();
+}
+
+//----------------------------------------------------------------------------
+// Instantiate a span space with a resolution of 256.
+vtkSpanSpace::vtkSpanSpace()
+{
+  this->Resolution = 256;
+  this->Internals = new vtkSpanSpaceInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkSpanSpace::~vtkSpanSpace()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+// Initialize locator. Frees memory and resets object as appropriate.
+void vtkSpanSpace::Initialize()
+{
+  delete this->Internals;
+  this->Internals = new vtkSpanSpaceInternals;
+}
+
+//----------------------------------------------------------------------------
+// Construct the span space from the dataset provided. Checks build times
+// and modified time from input and reconstructs the tree if necessary.
+void vtkSpanSpace::BuildTree()
+{
+  vtkIdType numCells, cellId;
+
+  // Check input...see whether we have to rebuild
+  //
+  if ( !this->DataSet || (numCells = this->DataSet->GetNumberOfCells()) < 1 )
+    {
+    vtkErrorMacro( << "No data to build tree with");
+    return;
+    }
+
+  vtkDataArray *scalars = this->Scalars;
+  if ( !scalars )
+    {
+    scalars = this->DataSet->GetPointData()->GetScalars();
+    }
+  if ( ! scalars )
+    {
+    vtkErrorMacro( << "No scalar data to build trees with");
+    this->Initialize();
+    return;
+    }
+
+  vtkSpanSpaceInternals *internals = this->Internals;
+  if ( internals->Scalars == scalars &&
+       this->BuildTime > this->MTime &&
+       this->BuildTime > this->DataSet->GetMTime() &&
+       this->BuildTime > scalars->GetMTime() )
+    {
+    return;
+    }
+
+  vtkDebugMacro( << "Building span space..." );
+
+  this->Initialize();
+  internals = this->Internals;
+  internals->Scalars = scalars;
+  internals->Resolution = this->Resolution;
+
+  // Place the cells in span space
+  //
+  vtkstd::vector<vtkSpanSpaceCell> cells(numCells);
+  int numComp = scalars->GetNumberOfComponents();
+  void *s = scalars->GetVoidPointer(0);
+  switch (scalars->GetDataType())
+    {
+    vtkTemplateMacro(
+      vtkSpanSpaceComputeRanges(this->DataSet, static_cast<VTK_TT*>(s),
+                                numComp, &cells[0]));
+    default:
+      vtkErrorMacro( << "Unsupported scalar type");
+      this->Initialize();
+      return;
+    }
+
+  internals->Min = VTK_DOUBLE_MAX;
+  internals->Max = -VTK_DOUBLE_MAX;
+  for ( cellId=0; cellId < numCells; cellId++ )
+    {
+    if ( cells[cellId].Min < internals->Min )
+      {
+      internals->Min = cells[cellId].Min;
+      }
+    if ( cells[cellId].Min > internals->Max )
+      {
+      internals->Max = cells[cellId].Min;
+      }
+    }
+  if ( internals->Max > internals->Min )
+    {
+    internals->Scale = this->Resolution / (internals->Max - internals->Min);
+    }
+
+  // Sort the cells into rows by their min, then each row by decreasing max
+  //
+  internals->Rows.assign(this->Resolution+1, 0);
+  for ( cellId=0; cellId < numCells; cellId++ )
+    {
+    internals->Rows[internals->GetRow(cells[cellId].Min)+1]++;
+    }
+  int row;
+  for ( row=0; row < this->Resolution; row++ )
+    {
+    internals->Rows[row+1] += internals->Rows[row];
+    }
+  internals->Cells.resize(numCells);
+  vtkstd::vector<vtkIdType> next(internals->Rows.begin(),
+                                 internals->Rows.end()-1);
+  for ( cellId=0; cellId < numCells; cellId++ )
+    {
+    internals->Cells[next[internals->GetRow(cells[cellId].Min)]++] =
+      cells[cellId];
+    }
+  for ( row=0; row < this->Resolution; row++ )
+    {
+    vtkstd::sort(internals->Cells.begin() + internals->Rows[row],
+                 internals->Cells.begin() + internals->Rows[row+1],
+                 vtkSpanSpaceMaxGreater);
+    }
+
+  this->BuildTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+// Begin to traverse the cells based on a scalar value. Returned cells
+// will have scalar values that span the scalar value specified.
+void vtkSpanSpace::InitTraversal(double scalarValue)
+{
+  this->BuildTree();
+  vtkSpanSpaceInternals *internals = this->Internals;
+
+  this->ScalarValue = scalarValue;
+  internals->ActiveCells.clear();
+  internals->Current = 0;
+  if ( internals->Cells.empty() || scalarValue < internals->Min )
+    {
+    return;
+    }
+
+  // The cells of each row up to that of the scalar value with a max of at
+  // least the value, checking the min in the row of the value
+  //
+  vtkSpanSpaceCell key;
+  key.Max = scalarValue;
+  int valueRow = internals->GetRow(scalarValue);
+  for ( int row=0; row <= valueRow; row++ )
+    {
+    vtkstd::vector<vtkSpanSpaceCell>::iterator begin =
+      internals->Cells.begin() + internals->Rows[row];
+    vtkstd::vector<vtkSpanSpaceCell>::iterator end =
+      vtkstd::upper_bound(begin,
+                          internals->Cells.begin() + internals->Rows[row+1],
+                          key, vtkSpanSpaceMaxGreater);
+    for ( ; begin != end; ++begin )
+      {
+      if ( row < valueRow || begin->Min <= scalarValue )
+        {
+        internals->ActiveCells.push_back(begin->CellId);
+        }
+      }
+    }
+
+  vtkstd::sort(internals->ActiveCells.begin(), internals->ActiveCells.end());
+}
+
+//----------------------------------------------------------------------------
+// Return the next cell that may contain scalar value specified to
+// initialize traversal. The value NULL is returned if the list is
+// exhausted. Make sure that InitTraversal() has been invoked first or
+// you'll get erratic behavior.
+vtkCell *vtkSpanSpace::GetNextCell(vtkIdType &cellId, vtkIdList* &cellPts,
+                                   vtkDataArray *cellScalars)
+{
+  vtkSpanSpaceInternals *internals = this->Internals;
+  if ( internals->Current >=
+       static_cast<vtkIdType>(internals->ActiveCells.size()) )
+    {
+    return NULL;
+    }
+
+  cellId = internals->ActiveCells[internals->Current++];
+  vtkCell *cell = this->DataSet->GetCell(cellId);
+  cellPts = cell->GetPointIds();
+  cellScalars->SetNumberOfTuples(cellPts->GetNumberOfIds());
+  internals->Scalars->GetTuples(cellPts, cellScalars);
+  return cell;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSpanSpace::GetNumberOfActiveCells()
+{
+  return static_cast<vtkIdType>(this->Internals->ActiveCells.size());
+}
+
+//----------------------------------------------------------------------------
+void vtkSpanSpace::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Resolution: " << this->Resolution << "\n" ;
+}
@@ -0,0 +1,100 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkSpanSpace - organize cells in span space (used to accelerate repeated contouring)
+// .SECTION Description
+// vtkSpanSpace is a scalar tree that places each cell of a dataset at the
+// point (min,max) of its scalar range in the span space. The span space is
+// cut into Resolution rows of equal width along the min axis, and the cells
+// of each row are sorted by decreasing max. The cells that contain a scalar
+// value v are then, in every row below the one holding v, a prefix of the
+// row found by binary search, and in the row holding v the cells of such a
+// prefix that also have min <= v. The cost of a traversal is thus that of
+// Resolution binary searches plus the number of cells returned, instead of
+// a visit of every cell.
+//
+// The span space is built once for a dataset and scalar array, and only
+// rebuilt when either is modified, so contouring the same data at many
+// values, e.g. while dragging an isovalue slider, only pays for the cells
+// that are contoured. The cells are returned in order of increasing id, as
+// vtkSimpleScalarTree returns them.
+//
+// .SECTION See Also
+// vtkScalarTree vtkSimpleScalarTree vtkContourFilter vtkContourGrid
+
+#ifndef __vtkSpanSpace_h
+#define __vtkSpanSpace_h
+
+#include "vtkScalarTree.h"
+
+class vtkSpanSpaceInternals;
+
+class VTK_FILTERING_EXPORT vtkSpanSpace : public vtkScalarTree
+{
+public:
+  // Description:
+  // Instantiate a span space with a resolution of 256.
+  static vtkSpanSpace *New();
+
+  // Description:
+  // Standard type related macros and PrintSelf() method.
+  vtkTypeRevisionMacro(vtkSpanSpace,vtkScalarTree);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set/Get the number of rows the span space is cut into along the min
+  // axis. More rows mean fewer cells to check in the row of the scalar
+  // value, but more binary searches per traversal.
+  vtkSetClampMacro(Resolution,int,1,VTK_LARGE_INTEGER);
+  vtkGetMacro(Resolution,int);
+
+  // Description:
+  // Construct the span space from the dataset provided. Checks build times
+  // and modified time from input and reconstructs the tree if necessary.
+  virtual void BuildTree();
+
+  // Description:
+  // Initialize locator. Frees memory and resets object as appropriate.
+  virtual void Initialize();
+
+  // Description:
+  // Begin to traverse the cells based on a scalar value. Returned cells
+  // will have scalar values that span the scalar value specified.
+  virtual void InitTraversal(double scalarValue);
+
+  // Description:
+  // Return the next cell that may contain scalar value specified to
+  // initialize traversal. The value NULL is returned if the list is
+  // exhausted. Make sure that InitTraversal() has been invoked first or
+  // you'll get erratic behavior.
+  virtual vtkCell *GetNextCell(vtkIdType &cellId, vtkIdList* &ptIds,
+                               vtkDataArray *cellScalars);
+
+  // Description:
+  // Return the number of cells found by the last InitTraversal().
+  vtkIdType GetNumberOfActiveCells();
+
+protected:
+  vtkSpanSpace();
+  ~vtkSpanSpace();
+
+  int Resolution;
+  vtkSpanSpaceInternals *Internals;
+
+private:
+  vtkSpanSpace(const vtkSpanSpace&);  // Not implemented.
+  void operator=(const vtkSpanSpace&);  // Not implemented.
+};
+
+#endif
@@ -247,7 +247,9 @@ int vtkStreamingDemandDrivenPipeline::Update(int port)
         retval = retval && this->UpdateData(port);
         }
       }
-    while (this->ContinueExecuting);
+    while (retval && this->ContinueExecuting);
+    // a failed update does not continue on the next one
+    this->ContinueExecuting = 0;
     return retval;
     }
   else
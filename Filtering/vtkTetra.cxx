@@ -306,12 +306,12 @@ void vtkTetra::Contour(double value, vtkDataArray *cellScalars,
         {
         x[j] = x1[j] + t * (x2[j] - x1[j]);
         }
-      if ( locator->InsertUniquePoint(x, pts[i]) )
+      vtkIdType p1 = this->PointIds->GetId(v1);
+      vtkIdType p2 = this->PointIds->GetId(v2);
+      if ( locator->InsertUniqueEdgePoint(p1, p2, t, x, pts[i]) )
         {
         if ( outPd ) 
           {
-          vtkIdType p1 = this->PointIds->GetId(v1);
-          vtkIdType p2 = this->PointIds->GetId(v2);
           outPd->InterpolateEdge(inPd,pts[i],p1,p2,t);
           }
         }
@@ -868,9 +868,13 @@ void vtkTetra::Clip(double value, vtkDataArray *cellScalars,
       {
       vertexId = edge[i] - 100;
       this->Points->GetPoint(vertexId, x);
-      if ( locator->InsertUniquePoint(x, pts[i-1]) )
+      vtkIdType pId = this->PointIds->GetId(vertexId);
+      if ( locator->InsertUniqueEdgePoint(pId, pId, 0.0, x, pts[i-1]) )
         {
-        outPD->CopyData(inPD,this->PointIds->GetId(vertexId),pts[i-1]);
+        if ( outPD )
+          {
+          outPD->CopyData(inPD,pId,pts[i-1]);
+          }
         }
       }
 
@@ -903,11 +907,14 @@ void vtkTetra::Clip(double value, vtkDataArray *cellScalars,
         x[j] = x1[j] + t * (x2[j] - x1[j]);
         }
 
-      if ( locator->InsertUniquePoint(x, pts[i-1]) )
+      vtkIdType p1 = this->PointIds->GetId(v1);
+      vtkIdType p2 = this->PointIds->GetId(v2);
+      if ( locator->InsertUniqueEdgePoint(p1, p2, t, x, pts[i-1]) )
         {
-        vtkIdType p1 = this->PointIds->GetId(v1);
-        vtkIdType p2 = this->PointIds->GetId(v2);
-        outPD->InterpolateEdge(inPD,pts[i-1],p1,p2,t);
+        if ( outPD )
+          {
+          outPD->InterpolateEdge(inPD,pts[i-1],p1,p2,t);
+          }
         }
       }
     }
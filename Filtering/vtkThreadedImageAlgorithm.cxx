@@ -21,6 +21,7 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -33,6 +34,8 @@ vtkThreadedImageAlgorithm::vtkThreadedImageAlgorithm()
 {
   this->Threader = vtkMultiThreader::New();
   this->NumberOfThreads = this->Threader->GetNumberOfThreads();
+  this->UseWorkStealing = 0;
+  this->MinimumPieceSize = 65536;
 }
 
 //----------------------------------------------------------------------------
@@ -47,8 +50,21 @@ void vtkThreadedImageAlgorithm::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
   
   os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "UseWorkStealing: " 
+     << (this->UseWorkStealing ? "On\n" : "Off\n");
+  os << indent << "MinimumPieceSize: " << this->MinimumPieceSize << "\n";
 }
 
+// The range of pieces [Begin, End) that a thread still has to execute.
+// The owner takes pieces from the front, other threads steal from the
+// back.
+struct vtkImagePieceQueue
+{
+  vtkSimpleMutexLock Lock;
+  int Begin;
+  int End;
+};
+
 struct vtkImageThreadStruct
 {
   vtkThreadedImageAlgorithm *Filter;
@@ -57,6 +73,12 @@ struct vtkImageThreadStruct
   vtkInformationVector *OutputsInfo;
   vtkImageData   ***Inputs;
   vtkImageData   **Outputs;
+
+  // Only used when work stealing.
+  int Extent[6];
+  int RequestedPieces;
+  int NumberOfQueues;
+  vtkImagePieceQueue *Queues;
 };
 
 //----------------------------------------------------------------------------
@@ -123,22 +145,12 @@ int vtkThreadedImageAlgorithm::SplitExtent(int splitExt[6],
 }
 
 
-// this mess is really a simple function. All it does is call
-// the ThreadedExecute method after setting the correct
-// extent for this thread. Its just a pain to calculate
-// the correct extent.
-VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
+// Find the extent that the threads have to work on: the update extent
+// of the output the request came from or, for sinks, of the first
+// connected input.  Returns 0 if there is nothing to do.
+static int vtkThreadedImageAlgorithmGetExecuteExtent(vtkImageThreadStruct *str,
+                                                     int ext[6])
 {
-  vtkImageThreadStruct *str;
-  int ext[6], splitExt[6], total;
-  int threadId, threadCount;
-  
-  threadId = static_cast<vtkMultiThreader::ThreadInfo *>(arg)->ThreadID;
-  threadCount = static_cast<vtkMultiThreader::ThreadInfo *>(arg)->NumberOfThreads;
-  
-  str = static_cast<vtkImageThreadStruct *>
-    (static_cast<vtkMultiThreader::ThreadInfo *>(arg)->UserData);
-
   // if we have an output
   if (str->Filter->GetNumberOfOutputPorts())
     {
@@ -150,7 +162,7 @@ VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
     // update directly, for now an error
     if (outputPort == -1)
       {
-      return VTK_THREAD_RETURN_VALUE;
+      return 0;
       }
   
     // get the update extent from the output port
@@ -180,9 +192,32 @@ VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
       }
     if (inPort >= str->Filter->GetNumberOfInputPorts())
       {
-      return VTK_THREAD_RETURN_VALUE;
+      return 0;
       }
     }
+  return 1;
+}
+
+// this mess is really a simple function. All it does is call
+// the ThreadedExecute method after setting the correct
+// extent for this thread. Its just a pain to calculate
+// the correct extent.
+VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
+{
+  vtkImageThreadStruct *str;
+  int ext[6], splitExt[6], total;
+  int threadId, threadCount;
+  
+  threadId = static_cast<vtkMultiThreader::ThreadInfo *>(arg)->ThreadID;
+  threadCount = static_cast<vtkMultiThreader::ThreadInfo *>(arg)->NumberOfThreads;
+  
+  str = static_cast<vtkImageThreadStruct *>
+    (static_cast<vtkMultiThreader::ThreadInfo *>(arg)->UserData);
+
+  if (!vtkThreadedImageAlgorithmGetExecuteExtent(str, ext))
+    {
+    return VTK_THREAD_RETURN_VALUE;
+    }
   
   // execute the actual method with appropriate extent
   // first find out how many pieces extent can be split into.
@@ -212,6 +247,83 @@ VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute( void *arg )
   return VTK_THREAD_RETURN_VALUE;
 }
 
+// Take the next piece of this thread's queue or, if it is empty, steal
+// half of the pieces left in another thread's queue.  Returns -1 when
+// there are no pieces left anywhere.
+static int vtkThreadedImageAlgorithmNextPiece(vtkImageThreadStruct *str,
+                                              int threadId)
+{
+  int threadCount = str->NumberOfQueues;
+  vtkImagePieceQueue *own = str->Queues + threadId;
+  int piece = -1;
+
+  own->Lock.Lock();
+  if (own->Begin < own->End)
+    {
+    piece = own->Begin++;
+    }
+  own->Lock.Unlock();
+  if (piece >= 0)
+    {
+    return piece;
+    }
+
+  for (int i = 1; i < threadCount; ++i)
+    {
+    vtkImagePieceQueue *victim = str->Queues + (threadId + i) % threadCount;
+    int begin = 0, end = 0;
+    victim->Lock.Lock();
+    int left = victim->End - victim->Begin;
+    if (left > 0)
+      {
+      end = victim->End;
+      begin = end - (left + 1) / 2;
+      victim->End = begin;
+      }
+    victim->Lock.Unlock();
+    if (begin < end)
+      {
+      // keep the first stolen piece, queue the rest
+      own->Lock.Lock();
+      own->Begin = begin + 1;
+      own->End = end;
+      own->Lock.Unlock();
+      return begin;
+      }
+    }
+  return -1;
+}
+
+// The thread function used when work stealing: keep executing pieces
+// until no thread has any left.
+VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmWorkStealingExecute( void *arg )
+{
+  int threadId = static_cast<vtkMultiThreader::ThreadInfo *>(arg)->ThreadID;
+  vtkImageThreadStruct *str = static_cast<vtkImageThreadStruct *>
+    (static_cast<vtkMultiThreader::ThreadInfo *>(arg)->UserData);
+
+  int splitExt[6];
+  int piece;
+  while ((piece = vtkThreadedImageAlgorithmNextPiece(str, threadId)) >= 0)
+    {
+    int total = str->Filter->SplitExtent(splitExt, str->Extent, piece,
+                                         str->RequestedPieces);
+    if (piece >= total ||
+        splitExt[1] < splitExt[0] ||
+        splitExt[3] < splitExt[2] ||
+        splitExt[5] < splitExt[4])
+      {
+      continue;
+      }
+    str->Filter->ThreadedRequestData(str->Request,
+                                     str->InputsInfo, str->OutputsInfo,
+                                     str->Inputs, str->Outputs, 
+                                     splitExt, threadId);
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 
 //----------------------------------------------------------------------------
 // This is the superclasses style of Execute method.  Convert it into
@@ -283,15 +395,61 @@ int vtkThreadedImageAlgorithm::RequestData(
     this->CopyAttributeData(str.Inputs[0][0],str.Outputs[0],inputVector);
     }
     
-  this->Threader->SetNumberOfThreads(this->NumberOfThreads);
+  // obey the global maximum here rather than in SingleMethodExecute, so
+  // that the pieces queued for work stealing all have a thread
+  int threadCount = this->NumberOfThreads;
+  int maxThreads = vtkMultiThreader::GetGlobalMaximumNumberOfThreads();
+  if (maxThreads > 0 && threadCount > maxThreads)
+    {
+    threadCount = maxThreads;
+    }
+  this->Threader->SetNumberOfThreads(threadCount);
   this->Threader->SetSingleMethod(vtkThreadedImageAlgorithmThreadedExecute, &str);  
 
   // always shut off debugging to avoid threading problems with GetMacros
   int debug = this->Debug;
   this->Debug = 0;
+
+  // when work stealing, split the extent into many pieces up front and
+  // hand each thread a contiguous run of them
+  str.Queues = 0;
+  if (this->UseWorkStealing &&
+      vtkThreadedImageAlgorithmGetExecuteExtent(&str, str.Extent))
+    {
+    int splitExt[6];
+    double size = 1.0;
+    for (i = 0; i < 3; ++i)
+      {
+      size *= (str.Extent[2*i+1] >= str.Extent[2*i] ?
+               str.Extent[2*i+1] - str.Extent[2*i] + 1 : 0);
+      }
+    double pieces = size / this->MinimumPieceSize;
+    int requested = (pieces > VTK_LARGE_INTEGER ? VTK_LARGE_INTEGER :
+                     static_cast<int>(pieces));
+    if (requested < threadCount)
+      {
+      requested = threadCount;
+      }
+    str.RequestedPieces = requested;
+    int total = this->SplitExtent(splitExt, str.Extent, 0, requested);
+    str.NumberOfQueues = threadCount;
+    str.Queues = new vtkImagePieceQueue[threadCount];
+    for (i = 0; i < threadCount; ++i)
+      {
+      str.Queues[i].Begin = static_cast<int>(
+        static_cast<double>(total) * i / threadCount);
+      str.Queues[i].End = static_cast<int>(
+        static_cast<double>(total) * (i + 1) / threadCount);
+      }
+    this->Threader->SetSingleMethod(
+      vtkThreadedImageAlgorithmWorkStealingExecute, &str);
+    }
+
   this->Threader->SingleMethodExecute();
   this->Debug = debug;
 
+  delete [] str.Queues;
+
   // free up the arrays
   for (i = 0; i < this->GetNumberOfInputPorts(); ++i)
     {
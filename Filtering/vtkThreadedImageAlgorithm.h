@@ -58,6 +58,26 @@ public:
   vtkSetClampMacro( NumberOfThreads, int, 1, VTK_MAX_THREADS );
   vtkGetMacro( NumberOfThreads, int );
 
+  // Description:
+  // When UseWorkStealing is on, the update extent is split into many
+  // small pieces instead of one piece per thread.  Each thread starts
+  // with a contiguous run of pieces and, once it runs out, steals pieces
+  // from the threads that still have work left.  This keeps all threads
+  // busy when the cost per voxel is uneven.  ThreadedRequestData may then
+  // be called several times per thread, each time with the id of the
+  // calling thread, so subclasses must not assume one call per threadId.
+  // Off by default.
+  vtkSetMacro( UseWorkStealing, int );
+  vtkGetMacro( UseWorkStealing, int );
+  vtkBooleanMacro( UseWorkStealing, int );
+
+  // Description:
+  // The minimum number of voxels in a piece when UseWorkStealing is on.
+  // Smaller pieces balance the load better but add per-piece overhead.
+  // The default is 65536.
+  vtkSetClampMacro( MinimumPieceSize, int, 1, VTK_LARGE_INTEGER );
+  vtkGetMacro( MinimumPieceSize, int );
+
   // Description:
   // Putting this here until I merge graphics and imaging streaming.
   virtual int SplitExtent(int splitExt[6], int startExt[6], 
@@ -69,6 +89,8 @@ protected:
 
   vtkMultiThreader *Threader;
   int NumberOfThreads;
+  int UseWorkStealing;
+  int MinimumPieceSize;
   
   // Description:
   // This is called by the superclass.
@@ -444,12 +444,12 @@ void vtkTriangle::Contour(double value, vtkDataArray *cellScalars,
         {
         x[j] = x1[j] + t * (x2[j] - x1[j]);
         }
-      if ( locator->InsertUniquePoint(x, pts[i]) )
+      vtkIdType p1 = this->PointIds->GetId(e1);
+      vtkIdType p2 = this->PointIds->GetId(e2);
+      if ( locator->InsertUniqueEdgePoint(p1, p2, t, x, pts[i]) )
         {
         if ( outPd ) 
           {
-          vtkIdType p1 = this->PointIds->GetId(e1);
-          vtkIdType p2 = this->PointIds->GetId(e2);
           outPd->InterpolateEdge(inPd,pts[i],p1,p2,t);
           }
         }
@@ -901,9 +901,13 @@ void vtkTriangle::Clip(double value, vtkDataArray *cellScalars,
         {
         vertexId = edge[i] - 100;
         this->Points->GetPoint(vertexId, x);
-        if ( locator->InsertUniquePoint(x, pts[i]) )
+        vtkIdType pId = this->PointIds->GetId(vertexId);
+        if ( locator->InsertUniqueEdgePoint(pId, pId, 0.0, x, pts[i]) )
           {
-          outPd->CopyData(inPd,this->PointIds->GetId(vertexId),pts[i]);
+          if ( outPd )
+            {
+            outPd->CopyData(inPd,pId,pts[i]);
+            }
           }
         }
 
@@ -941,11 +945,14 @@ void vtkTriangle::Clip(double value, vtkDataArray *cellScalars,
           {
           x[j] = x1[j] + t * (x2[j] - x1[j]);
           }
-        if ( locator->InsertUniquePoint(x, pts[i]) )
+        vtkIdType p1 = this->PointIds->GetId(e1);
+        vtkIdType p2 = this->PointIds->GetId(e2);
+        if ( locator->InsertUniqueEdgePoint(p1, p2, t, x, pts[i]) )
           {
-          vtkIdType p1 = this->PointIds->GetId(e1);
-          vtkIdType p2 = this->PointIds->GetId(e2);
-          outPd->InterpolateEdge(inPd,pts[i],p1,p2,t);
+          if ( outPd )
+            {
+            outPd->InterpolateEdge(inPd,pts[i],p1,p2,t);
+            }
           }
         }
       }
@@ -674,11 +674,20 @@ vtkCell *vtkUnstructuredGrid::GetCell(vtkIdType cellId)
     return NULL;
     }
 
-  loc = this->Locations->GetValue(cellId);
-  vtkDebugMacro(<< "location = " <<  loc);
-  this->Connectivity->GetCell(loc,numPts,pts);
+  if ( this->UseCellOffsets() )
+    {
+    this->Connectivity->GetCellAtId(cellId, cell->PointIds);
+    numPts = cell->PointIds->GetNumberOfIds();
+    pts = cell->PointIds->GetPointer(0);
+    }
+  else
+    {
+    loc = this->Locations->GetValue(cellId);
+    vtkDebugMacro(<< "location = " <<  loc);
+    this->Connectivity->GetCell(loc,numPts,pts);
+    cell->PointIds->SetNumberOfIds(numPts);
+    }
 
-  cell->PointIds->SetNumberOfIds(numPts);
   cell->Points->SetNumberOfPoints(numPts);
 
   for (i=0; i<numPts; i++)
@@ -705,10 +714,19 @@ void vtkUnstructuredGrid::GetCell(vtkIdType cellId, vtkGenericCell *cell)
 
   cell->SetCellType(static_cast<int>(Types->GetValue(cellId)));
 
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
+  if ( this->UseCellOffsets() )
+    {
+    this->Connectivity->GetCellAtId(cellId, cell->PointIds);
+    numPts = cell->PointIds->GetNumberOfIds();
+    pts = cell->PointIds->GetPointer(0);
+    }
+  else
+    {
+    loc = this->Locations->GetValue(cellId);
+    this->Connectivity->GetCell(loc,numPts,pts);
+    cell->PointIds->SetNumberOfIds(numPts);
+    }
 
-  cell->PointIds->SetNumberOfIds(numPts);
   cell->Points->SetNumberOfPoints(numPts);
 
   for (i=0; i<numPts; i++)
@@ -733,9 +751,26 @@ void vtkUnstructuredGrid::GetCellBounds(vtkIdType cellId, double bounds[6])
   int loc;
   double x[3];
   vtkIdType *pts, numPts;
+  vtkIdType ptsBuffer[VTK_CELL_SIZE];
 
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
+  if ( this->UseCellOffsets() )
+    {
+    if ( !this->Connectivity->GetCellPointerAtId(cellId, numPts, pts) )
+      {
+      if ( this->Connectivity->GetCellSize(cellId) > VTK_CELL_SIZE )
+        {
+        this->Superclass::GetCellBounds(cellId, bounds);
+        return;
+        }
+      this->Connectivity->GetCellAtId(cellId, numPts, ptsBuffer);
+      pts = ptsBuffer;
+      }
+    }
+  else
+    {
+    loc = this->Locations->GetValue(cellId);
+    this->Connectivity->GetCell(loc,numPts,pts);
+    }
 
   // carefully compute the bounds
   if (numPts)
@@ -790,6 +825,10 @@ vtkIdType vtkUnstructuredGrid::GetNumberOfCells()
 // cell topology.
 vtkIdType vtkUnstructuredGrid::InsertNextCell(int type, vtkIdList *ptIds)
 {
+  if ( !this->Locations )
+    {
+    this->BuildLocations();
+    }
   vtkIdType npts = ptIds->GetNumberOfIds();
   // insert connectivity
   this->Connectivity->InsertNextCell(ptIds);
@@ -807,6 +846,10 @@ vtkIdType vtkUnstructuredGrid::InsertNextCell(int type, vtkIdList *ptIds)
 vtkIdType vtkUnstructuredGrid::InsertNextCell(int type, vtkIdType npts,
                                               vtkIdType *pts)
 {
+  if ( !this->Locations )
+    {
+    this->BuildLocations();
+    }
   // insert connectivity
   this->Connectivity->InsertNextCell(npts,pts);
   // insert type and storage information
@@ -850,7 +893,20 @@ void vtkUnstructuredGrid::SetCells(int type, vtkCellArray *cells)
   if ( this->Locations)
     {
     this->Locations->UnRegister(this);
+    this->Locations = NULL;
+    }
+
+  // offsets storage provides random access without locations
+  if ( cells->GetUsesOffsetsStorage() )
+    {
+    vtkIdType numCells = cells->GetNumberOfCells();
+    for (vtkIdType cellId=0; cellId < numCells; cellId++)
+      {
+      this->Types->InsertNextValue(static_cast<unsigned char>(type));
+      }
+    return;
     }
+
   this->Locations = vtkIdTypeArray::New();
   this->Locations->Allocate(cells->GetNumberOfCells(),1000);
   this->Locations->Register(this);
@@ -896,7 +952,20 @@ void vtkUnstructuredGrid::SetCells(int *types, vtkCellArray *cells)
   if ( this->Locations)
     {
     this->Locations->UnRegister(this);
+    this->Locations = NULL;
+    }
+
+  // offsets storage provides random access without locations
+  if ( cells->GetUsesOffsetsStorage() )
+    {
+    vtkIdType numCells = cells->GetNumberOfCells();
+    for (vtkIdType cellId=0; cellId < numCells; cellId++)
+      {
+      this->Types->InsertNextValue(static_cast<unsigned char>(types[cellId]));
+      }
+    return;
     }
+
   this->Locations = vtkIdTypeArray::New();
   this->Locations->Allocate(cells->GetNumberOfCells(),1000);
   this->Locations->Register(this);
@@ -951,6 +1020,83 @@ void vtkUnstructuredGrid::SetCells(vtkUnsignedCharArray *cellTypes,
 
 }
 
+//----------------------------------------------------------------------------
+// The interleaved location of each cell of offsets storage.
+template <class T>
+static void vtkUnstructuredGridOffsetsToLocations(const T *offsets,
+                                                  vtkIdType numCells,
+                                                  vtkIdType *locations)
+{
+  for (vtkIdType cellId=0; cellId < numCells; cellId++)
+    {
+    locations[cellId] =
+      static_cast<vtkIdType>(offsets[cellId] - offsets[0]) + cellId;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkUnstructuredGrid::BuildLocations()
+{
+  vtkIdTypeArray *locations = vtkIdTypeArray::New();
+  vtkIdType numCells = this->Connectivity->GetNumberOfCells();
+  vtkDataArray *offsets = this->Connectivity->GetOffsetsArray();
+  if ( offsets )
+    {
+    vtkIdType *ptr = locations->WritePointer(0, numCells);
+    if ( offsets->GetDataType() == VTK_INT )
+      {
+      vtkUnstructuredGridOffsetsToLocations(
+        static_cast<int *>(offsets->GetVoidPointer(0)), numCells, ptr);
+      }
+    else
+      {
+      vtkUnstructuredGridOffsetsToLocations(
+        static_cast<vtkIdType *>(offsets->GetVoidPointer(0)), numCells, ptr);
+      }
+    }
+  else
+    {
+    vtkIdType npts, *pts;
+    vtkIdType loc = this->Connectivity->GetTraversalLocation();
+    locations->Allocate(numCells,1000);
+    for (this->Connectivity->InitTraversal();
+         this->Connectivity->GetNextCell(npts,pts);)
+      {
+      locations->InsertNextValue(
+        this->Connectivity->GetTraversalLocation(npts));
+      }
+    this->Connectivity->SetTraversalLocation(loc);
+    }
+
+  locations->Register(this);
+  locations->Delete();
+  this->Locations = locations;
+}
+
+//----------------------------------------------------------------------------
+int vtkUnstructuredGrid::UseCellOffsets()
+{
+  if ( this->Connectivity->GetUsesOffsetsStorage() )
+    {
+    return 1;
+    }
+  if ( !this->Locations )
+    {
+    this->BuildLocations();
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+vtkIdTypeArray* vtkUnstructuredGrid::GetCellLocationsArray()
+{
+  if ( !this->Locations && this->Connectivity )
+    {
+    this->BuildLocations();
+    }
+  return this->Locations;
+}
+
 //----------------------------------------------------------------------------
 void vtkUnstructuredGrid::BuildLinks()
 {
@@ -974,6 +1120,12 @@ void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
   int loc;
   vtkIdType *pts, numPts;
 
+  if ( this->UseCellOffsets() )
+    {
+    this->Connectivity->GetCellAtId(cellId, ptIds);
+    return;
+    }
+
   loc = this->Locations->GetValue(cellId);
   this->Connectivity->GetCell(loc,numPts,pts);
   ptIds->SetNumberOfIds(numPts);
@@ -992,6 +1144,18 @@ void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdType& npts,
 {
   int loc;
 
+  // Without a pointer into the offsets storage (32-bit connectivity)
+  // GetCell() converts the cells to the interleaved layout, once.
+  if ( this->UseCellOffsets() &&
+       this->Connectivity->GetCellPointerAtId(cellId, npts, pts) )
+    {
+    return;
+    }
+  if ( !this->Locations )
+    {
+    this->BuildLocations();
+    }
+
   loc = this->Locations->GetValue(cellId);
 
   this->Connectivity->GetCell(loc,npts,pts);
@@ -1103,6 +1267,10 @@ void vtkUnstructuredGrid::ReplaceCell(vtkIdType cellId, int npts,
 {
   int loc;
 
+  if ( !this->Locations )
+    {
+    this->BuildLocations();
+    }
   loc = this->Locations->GetValue(cellId);
   this->Connectivity->ReplaceCell(loc,npts,pts);
 }
@@ -92,7 +92,7 @@ public:
 
   int GetCellType(vtkIdType cellId);
   vtkUnsignedCharArray* GetCellTypesArray() { return this->Types; }
-  vtkIdTypeArray* GetCellLocationsArray() { return this->Locations; }
+  vtkIdTypeArray* GetCellLocationsArray();
   void Squeeze();
   void Initialize();
   int GetMaxCellSize();
@@ -103,7 +103,15 @@ public:
 
   // Description:
   // Special methods specific to vtkUnstructuredGrid for defining the cells
-  // composing the dataset.
+  // composing the dataset.  When the cell array uses offsets storage (see
+  // vtkCellArray::SetData()) no cell locations are built and cells are
+  // accessed through the offsets.  GetCellLocationsArray() computes the
+  // locations from the offsets.  The insertion methods, and
+  // GetCellPoints(cellId,npts,pts) with a vtkIntArray connectivity,
+  // convert the cells back to the interleaved layout, once and under a
+  // lock.  Without offsets storage the cell locations are built on first
+  // use, which is not thread safe: call GetCellLocationsArray() from a
+  // single thread before accessing the cells from several threads.
   void SetCells(int type, vtkCellArray *cells);
   void SetCells(int *types, vtkCellArray *cells);
   void SetCells(vtkUnsignedCharArray *cellTypes, vtkIdTypeArray *cellLocations, 
@@ -224,6 +232,13 @@ protected:
   vtkUnsignedCharArray *Types;
   vtkIdTypeArray *Locations;
 
+  // Locations are left out while the connectivity uses offsets storage.
+  // UseCellOffsets() returns 1 if that is the case, otherwise it makes
+  // sure the locations are built.  BuildLocations() builds them, from the
+  // offsets when there are some.
+  void BuildLocations();
+  int UseCellOffsets();
+
  private:
   void Cleanup();
   
@@ -0,0 +1,197 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Clean a mesh whose cells all have their own points with a locator, by
+// exact merging and by grid merging, with one and with several threads,
+// and check that the outputs are the same up to the numbering of their
+// points. Also abort the merging on threads, which must give no cells.
+
+#include "vtkCellArray.h"
+#include "vtkCleanPolyData.h"
+#include "vtkCommand.h"
+#include "vtkDoubleArray.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataSetUtilities.h"
+
+#define GRID_SIZE 40
+
+// a square of triangles, some of them degenerate, with vertices, lines and
+// strips, every cell having its own points, moved by at most jitter. The
+// points have their lattice position as point data and the cells their id
+// as cell data.
+static vtkPolyData* MakeMesh(double jitter)
+{
+  const int n = GRID_SIZE;
+  vtkPolyData* mesh = vtkPolyData::New();
+  vtkPoints* points = vtkPoints::New();
+  points->SetDataTypeToDouble();
+  vtkDoubleArray* positions = vtkDoubleArray::New();
+  positions->SetName("Position");
+  positions->SetNumberOfComponents(3);
+  vtkCellArray* cells[4];
+  for(int type=0;type<4;type++)
+    {
+    cells[type] = vtkCellArray::New();
+    }
+
+  vtkIdType pts[5];
+  int count = 0;
+  for(int j=0;j<n;j++)
+    {
+    for(int i=0;i<n;i++, count++)
+      {
+      int corners[5][2] = { {i,j}, {i+1,j}, {i+1,j+1}, {i,j+1}, {i,j} };
+      int type = 2, npts = 3;
+      if(count % 17 == 0)
+        {
+        corners[1][0] = i; // a degenerate triangle, becomes a line
+        }
+      else if(count % 23 == 0)
+        {
+        corners[1][0] = i; corners[2][0] = i; corners[2][1] = j;
+        }
+      else if(count % 13 == 0)
+        {
+        type = 1; npts = 2;
+        }
+      else if(count % 29 == 0)
+        {
+        type = 0; npts = 1;
+        }
+      else if(count % 11 == 0)
+        {
+        type = 3; npts = 5;
+        corners[4][0] = i; corners[4][1] = j+1; // a degenerate strip
+        }
+      for(int k=0;k<npts;k++)
+        {
+        double x[3];
+        x[0] = corners[k][0];
+        x[1] = corners[k][1];
+        x[2] = 0.1*sin(0.3*x[0]) + 0.1*cos(0.2*x[1]);
+        positions->InsertNextTuple(x);
+        x[0] += jitter*sin(1.3*count + k);
+        x[1] += jitter*cos(0.7*count + 2*k);
+        pts[k] = points->InsertNextPoint(x);
+        }
+      cells[type]->InsertNextCell(npts, pts);
+      }
+    }
+
+  // a vertex one and a half lattice steps before the other points, which
+  // moves the origin of the bounds there, and an unused point
+  pts[0] = points->InsertNextPoint(-1.5, -1.5, -1.5);
+  positions->InsertNextTuple3(-1.5, -1.5, -1.5);
+  cells[0]->InsertNextCell(1, pts);
+  points->InsertNextPoint(0.0, 0.0, 0.0);
+  positions->InsertNextTuple3(0.0, 0.0, 0.0);
+  mesh->SetPoints(points);
+  mesh->GetPointData()->AddArray(positions);
+  mesh->SetVerts(cells[0]);
+  mesh->SetLines(cells[1]);
+  mesh->SetPolys(cells[2]);
+  mesh->SetStrips(cells[3]);
+  points->Delete();
+  positions->Delete();
+  for(int type=0;type<4;type++)
+    {
+    cells[type]->Delete();
+    }
+
+  vtkTestDataSetUtilities::AddCellIds(mesh);
+  return mesh;
+}
+
+// aborts the filter at its first progress event
+class AbortCommand : public vtkCommand
+{
+public:
+  static AbortCommand* New() { return new AbortCommand; }
+  virtual void Execute(vtkObject* caller, unsigned long, void*)
+    {
+    vtkAlgorithm::SafeDownCast(caller)->AbortExecuteOn();
+    }
+};
+
+static vtkPolyData* Clean(vtkPolyData* input, int mode, int numThreads,
+                          double tolerance, int abort = 0)
+{
+  vtkSmartPointer<vtkCleanPolyData> clean =
+    vtkSmartPointer<vtkCleanPolyData>::New();
+  if(abort)
+    {
+    vtkSmartPointer<AbortCommand> command =
+      vtkSmartPointer<AbortCommand>::New();
+    clean->AddObserver(vtkCommand::ProgressEvent, command);
+    }
+  clean->SetInput(input);
+  clean->SetMergeMode(mode);
+  clean->SetNumberOfThreads(numThreads);
+  clean->ToleranceIsAbsoluteOn();
+  clean->SetAbsoluteTolerance(tolerance);
+  clean->Update();
+  vtkPolyData* output = vtkPolyData::New();
+  output->ShallowCopy(clean->GetOutput());
+  return output;
+}
+
+int TestCleanPolyDataMergeModes(int, char*[])
+{
+  vtkSmartPointer<vtkPolyData> mesh;
+  mesh.TakeReference(MakeMesh(0.0));
+  vtkSmartPointer<vtkPolyData> jittered;
+  jittered.TakeReference(MakeMesh(0.01));
+
+  int rval = 0;
+  vtkSmartPointer<vtkPolyData> locator, exact, exactThreads, grid, gridThreads;
+  locator.TakeReference(Clean(mesh, VTK_CLEAN_MERGE_WITH_LOCATOR, 1, 0.0));
+  exact.TakeReference(Clean(mesh, VTK_CLEAN_MERGE_EXACT, 1, 0.0));
+  exactThreads.TakeReference(Clean(mesh, VTK_CLEAN_MERGE_EXACT, 4, 0.0));
+  cout << "Cleaned " << mesh->GetNumberOfPoints() << " points into "
+       << locator->GetNumberOfPoints() << " and " << mesh->GetNumberOfCells()
+       << " cells into " << locator->GetNumberOfCells() << endl;
+  rval += vtkTestDataSetUtilities::ComparePointSets(
+    locator, exact, "Position", 0.0, "exact");
+  rval += vtkTestDataSetUtilities::ComparePointSets(
+    exact, exactThreads, "Position", 0.0, "exact on threads");
+
+  // the jittered points are merged on a grid with cells of size 1 centered
+  // on the lattice points
+  grid.TakeReference(Clean(jittered, VTK_CLEAN_MERGE_ON_GRID, 1, 1.0));
+  gridThreads.TakeReference(Clean(jittered, VTK_CLEAN_MERGE_ON_GRID, 4, 1.0));
+  rval += vtkTestDataSetUtilities::ComparePointSets(
+    locator, grid, "Position", 0.03, "grid");
+  rval += vtkTestDataSetUtilities::ComparePointSets(
+    grid, gridThreads, "Position", 0.0, "grid on threads");
+
+  // exact merging keeps the jittered points apart
+  exact.TakeReference(Clean(jittered, VTK_CLEAN_MERGE_EXACT, 4, 0.0));
+  if(exact->GetNumberOfPoints() != jittered->GetNumberOfPoints() - 1)
+    {
+    cerr << "Jittered points merged" << endl;
+    rval++;
+    }
+
+  exact.TakeReference(Clean(mesh, VTK_CLEAN_MERGE_EXACT, 4, 0.0, 1));
+  if(exact->GetNumberOfCells() != 0)
+    {
+    cerr << "Aborted merging gave " << exact->GetNumberOfCells() << " cells"
+         << endl;
+    rval++;
+    }
+  return rval;
+}
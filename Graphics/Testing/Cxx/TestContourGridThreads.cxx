@@ -0,0 +1,122 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Contour a tetrahedral grid with one and with several threads and check
+// that the outputs are the same up to the numbering of their points. Two of
+// the values are close enough for the contours to cross the same edges.
+// Then do the same with triangles, lines and vertices mixed in with the
+// tetrahedra, whose contours must come in the same order too.
+
+#include "vtkCellType.h"
+#include "vtkContourGrid.h"
+#include "vtkDoubleArray.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+#define GRID_SIZE 20
+
+// a distorted lattice of tetrahedra with the distance to a point off its
+// center as scalars and the cell ids as cell data. If mixed, a face, an edge
+// and a corner of some of the tetrahedra are inserted after them.
+static vtkUnstructuredGrid* MakeTetraGrid(int mixed)
+{
+  vtkUnstructuredGrid* grid =
+    vtkTestDataSetUtilities::MakeTetraGrid(GRID_SIZE, 0.2);
+  if(mixed)
+    {
+    vtkUnstructuredGrid* tetras = grid;
+    grid = vtkUnstructuredGrid::New();
+    grid->SetPoints(tetras->GetPoints());
+    grid->Allocate(2*tetras->GetNumberOfCells());
+    vtkIdType npts, *pts;
+    for(vtkIdType cellId=0;cellId<tetras->GetNumberOfCells();cellId++)
+      {
+      tetras->GetCellPoints(cellId, npts, pts);
+      grid->InsertNextCell(VTK_TETRA, npts, pts);
+      if(cellId % 7 == 0)
+        {
+        grid->InsertNextCell(VTK_TRIANGLE, 3, pts);
+        }
+      if(cellId % 11 == 0)
+        {
+        grid->InsertNextCell(VTK_LINE, 2, pts + 1);
+        }
+      if(cellId % 13 == 0)
+        {
+        grid->InsertNextCell(VTK_VERTEX, 1, pts + 2);
+        }
+      }
+    tetras->Delete();
+    }
+  vtkDoubleArray* scalars = vtkDoubleArray::New();
+  scalars->SetName("Distance");
+  for(vtkIdType i=0;i<grid->GetNumberOfPoints();i++)
+    {
+    double x[3];
+    grid->GetPoint(i, x);
+    scalars->InsertNextValue(sqrt((x[0]-9.3)*(x[0]-9.3) +
+                                  (x[1]-10.4)*(x[1]-10.4) +
+                                  (x[2]-9.7)*(x[2]-9.7)));
+    }
+  grid->GetPointData()->SetScalars(scalars);
+  scalars->Delete();
+  vtkTestDataSetUtilities::AddCellIds(grid);
+  return grid;
+}
+
+static int CompareContours(vtkPolyData* p1, vtkPolyData* p2, int mixed)
+{
+  cout << "Comparing contours: " << p1->GetNumberOfPolys() << " polys, "
+       << p1->GetNumberOfLines() << " lines, " << p1->GetNumberOfVerts()
+       << " vertices, " << p1->GetNumberOfPoints() << " points.\n";
+  if(p1->GetNumberOfPolys() == 0 ||
+     (mixed && (p1->GetNumberOfLines() == 0 || p1->GetNumberOfVerts() == 0)))
+    {
+    cerr << "Empty contour" << endl;
+    return 1;
+    }
+  return vtkTestDataSetUtilities::ComparePointSets(p1, p2, 0, 0.0,
+                                                   "Threaded contour");
+}
+
+int TestContourGridThreads(int, char*[])
+{
+  int rval = 0;
+  for(int mixed=0;mixed<2;mixed++)
+    {
+    vtkSmartPointer<vtkUnstructuredGrid> grid;
+    grid.TakeReference(MakeTetraGrid(mixed));
+
+    vtkSmartPointer<vtkPolyData> outputs[2];
+    for(int threaded=0;threaded<2;threaded++)
+      {
+      vtkSmartPointer<vtkContourGrid> contour =
+        vtkSmartPointer<vtkContourGrid>::New();
+      contour->SetInput(grid);
+      contour->SetValue(0, 3.0);
+      contour->SetValue(1, 6.5);
+      contour->SetValue(2, 6.75);
+      contour->SetValue(3, 9.0);
+      contour->SetNumberOfThreads(threaded ? 4 : 1);
+      contour->Update();
+      outputs[threaded] = contour->GetOutput();
+      }
+    rval += CompareContours(outputs[0], outputs[1], mixed);
+    }
+
+  return rval;
+}
@@ -0,0 +1,229 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Extract the surface of an unstructured grid mixing every kind of linear
+// 3D cell with vertices, lines and polygons, on one and on several
+// threads, and check that the outputs are the same. Also extract it with a
+// quadratic cell added, which is never done on threads.
+
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkDataSetSurfaceFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+#define GRID_SIZE 8
+
+static vtkIdType AddPoint(vtkPoints* points, vtkDoubleArray* scalars,
+                          double x, double y, double z)
+{
+  scalars->InsertNextValue(x*x - y*z);
+  return points->InsertNextPoint(x, y, z);
+}
+
+// a prism of n sides, extruded from z to z+1, so that two of them stacked
+// share a face
+static void AddPrism(vtkUnstructuredGrid* grid, vtkIdType* ring, int n,
+                     double z)
+{
+  vtkPoints* points = grid->GetPoints();
+  vtkDoubleArray* scalars =
+    vtkDoubleArray::SafeDownCast(grid->GetPointData()->GetScalars());
+  vtkIdType pts[12];
+  for(int i=0;i<n;i++)
+    {
+    pts[i] = ring[i];
+    ring[i] = AddPoint(points, scalars, -3.0 + cos(6.2832*i/n),
+                       1.0 + sin(6.2832*i/n), z+1);
+    pts[n+i] = ring[i];
+    }
+  grid->InsertNextCell(n == 5 ? VTK_PENTAGONAL_PRISM : VTK_HEXAGONAL_PRISM,
+                       2*n, pts);
+}
+
+// a lattice of cubes made of hexahedra, voxels, tetrahedra and wedges,
+// with pyramids on some of its top faces, stacked pentagonal and hexagonal
+// prisms beside it, a few vertices, lines, triangles and quads, and a
+// quadratic tetrahedron if asked
+static vtkUnstructuredGrid* MakeGrid(int quadratic)
+{
+  const int n = GRID_SIZE;
+  vtkUnstructuredGrid* grid = vtkUnstructuredGrid::New();
+  vtkPoints* points = vtkPoints::New();
+  vtkDoubleArray* scalars = vtkDoubleArray::New();
+  scalars->SetName("Scalars");
+  grid->SetPoints(points);
+  grid->GetPointData()->SetScalars(scalars);
+  points->Delete();
+  scalars->Delete();
+  int i, j, k;
+  for(k=0;k<=n;k++)
+    {
+    for(j=0;j<=n;j++)
+      {
+      for(i=0;i<=n;i++)
+        {
+        AddPoint(points, scalars, i, j, k);
+        }
+      }
+    }
+  grid->Allocate(6*n*n*n);
+
+  static const int perms[6][3] =
+    { {0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0} };
+  for(k=0;k<n;k++)
+    {
+    for(j=0;j<n;j++)
+      {
+      for(i=0;i<n;i++)
+        {
+        vtkIdType p[8]; // the corners, x fastest
+        for(int c=0;c<8;c++)
+          {
+          p[c] = (i + (c & 1)) + (n+1)*((j + ((c >> 1) & 1)) +
+                                        (n+1)*(k + (c >> 2)));
+          }
+        int kind = (i/2 + j/3 + k) % 4;
+        if(kind == 0)
+          {
+          vtkIdType hex[8] = { p[0], p[1], p[3], p[2], p[4], p[5], p[7], p[6] };
+          grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+          }
+        else if(kind == 1)
+          {
+          grid->InsertNextCell(VTK_VOXEL, 8, p);
+          }
+        else if(kind == 2)
+          {
+          for(int t=0;t<6;t++)
+            {
+            int ijk[3] = { 0, 0, 0 };
+            vtkIdType tet[4];
+            for(int v=0;v<4;v++)
+              {
+              if(v > 0)
+                {
+                ijk[perms[t][v-1]] = 1;
+                }
+              tet[v] = p[ijk[0] + 2*ijk[1] + 4*ijk[2]];
+              }
+            grid->InsertNextCell(VTK_TETRA, 4, tet);
+            }
+          }
+        else
+          {
+          vtkIdType wedge1[6] = { p[0], p[1], p[2], p[4], p[5], p[6] };
+          vtkIdType wedge2[6] = { p[1], p[3], p[2], p[5], p[7], p[6] };
+          grid->InsertNextCell(VTK_WEDGE, 6, wedge1);
+          grid->InsertNextCell(VTK_WEDGE, 6, wedge2);
+          }
+        if(k == n-1 && j < 3)
+          {
+          vtkIdType pyramid[5] = { p[4], p[5], p[7], p[6], 0 };
+          pyramid[4] = AddPoint(points, scalars, i+0.5, j+0.5, n+0.7);
+          grid->InsertNextCell(VTK_PYRAMID, 5, pyramid);
+          }
+        }
+      }
+    }
+
+  for(int sides=5;sides<=6;sides++)
+    {
+    vtkIdType ring[6];
+    for(i=0;i<sides;i++)
+      {
+      ring[i] = AddPoint(points, scalars, -3.0 + cos(6.2832*i/sides),
+                         1.0 + sin(6.2832*i/sides), 2.0*sides);
+      }
+    AddPrism(grid, ring, sides, 2.0*sides);
+    AddPrism(grid, ring, sides, 2.0*sides + 1.0);
+    }
+
+  vtkIdType vertex = 5, line[3] = { 0, 10, 20 };
+  vtkIdType triangle[3] = { 0, 1, n+1 }, quad[4] = { 1, 2, n+3, n+2 };
+  grid->InsertNextCell(VTK_VERTEX, 1, &vertex);
+  grid->InsertNextCell(VTK_POLY_LINE, 3, line);
+  grid->InsertNextCell(VTK_TRIANGLE, 3, triangle);
+  grid->InsertNextCell(VTK_QUAD, 4, quad);
+
+  if(quadratic)
+    {
+    vtkIdType tet[10];
+    double x[10][3] = { {0,0,0}, {1,0,0}, {0,1,0}, {0,0,1}, {0.5,0,0},
+                        {0.5,0.5,0}, {0,0.5,0}, {0,0,0.5}, {0.5,0,0.5},
+                        {0,0.5,0.5} };
+    for(i=0;i<10;i++)
+      {
+      tet[i] = AddPoint(points, scalars, x[i][0] - 4.0, x[i][1] - 4.0, x[i][2]);
+      }
+    grid->InsertNextCell(VTK_QUADRATIC_TETRA, 10, tet);
+    }
+
+  vtkDoubleArray* cellData = vtkDoubleArray::New();
+  cellData->SetName("CellData");
+  for(vtkIdType cellId=0;cellId<grid->GetNumberOfCells();cellId++)
+    {
+    cellData->InsertNextValue(0.5*cellId);
+    }
+  grid->GetCellData()->AddArray(cellData);
+  cellData->Delete();
+  return grid;
+}
+
+int TestDataSetSurfaceFilterThreads(int, char*[])
+{
+  int rval = 0;
+  for(int quadratic=0;quadratic<2;quadratic++)
+    {
+    vtkSmartPointer<vtkUnstructuredGrid> grid;
+    grid.TakeReference(MakeGrid(quadratic));
+
+    vtkSmartPointer<vtkPolyData> outputs[2];
+    for(int threaded=0;threaded<2;threaded++)
+      {
+      vtkSmartPointer<vtkDataSetSurfaceFilter> surface =
+        vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
+      surface->SetInput(grid);
+      surface->PassThroughCellIdsOn();
+      surface->PassThroughPointIdsOn();
+      surface->SetNumberOfThreads(threaded ? 4 : 1);
+      surface->Update();
+      outputs[threaded] = surface->GetOutput();
+      }
+
+    cout << "Grid of " << grid->GetNumberOfCells() << " cells: "
+         << outputs[0]->GetNumberOfPolys() << " polygons, "
+         << outputs[0]->GetNumberOfPoints() << " points" << endl;
+    int failed = 0;
+    failed += vtkTestDataSetUtilities::ComparePolyData(
+      outputs[0], outputs[1], "Threaded surface");
+    if(!outputs[0]->GetCellData()->GetArray("vtkOriginalCellIds") ||
+       outputs[0]->GetNumberOfPolys() < 6*GRID_SIZE*GRID_SIZE)
+      {
+      cerr << "Surface incomplete" << endl;
+      failed++;
+      }
+    if(failed)
+      {
+      rval++;
+      }
+    }
+
+  return rval;
+}
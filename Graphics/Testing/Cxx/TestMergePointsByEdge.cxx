@@ -0,0 +1,123 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Cut and clip tetrahedral and hexahedral grids with the points merged by
+// position and by edge and check that the outputs are the same up to the
+// numbering of their points.
+
+#include "vtkCellType.h"
+#include "vtkClipDataSet.h"
+#include "vtkCutter.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkPlane.h"
+#include "vtkPointData.h"
+#include "vtkPointSet.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+#define GRID_SIZE 12
+
+// a distorted lattice of hexahedra or tetrahedra with the distance to a
+// point off its center as scalars, a vector array and the cell ids as cell
+// data
+static vtkUnstructuredGrid* MakeGrid(int cellType)
+{
+  vtkUnstructuredGrid* grid = cellType == VTK_HEXAHEDRON ?
+    vtkTestDataSetUtilities::MakeHexahedronGrid(GRID_SIZE, 0.2) :
+    vtkTestDataSetUtilities::MakeTetraGrid(GRID_SIZE, 0.2);
+  vtkDoubleArray* scalars = vtkDoubleArray::New();
+  scalars->SetName("Distance");
+  vtkFloatArray* vectors = vtkFloatArray::New();
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  for(vtkIdType i=0;i<grid->GetNumberOfPoints();i++)
+    {
+    double x[3];
+    grid->GetPoint(i, x);
+    scalars->InsertNextValue(sqrt((x[0]-5.3)*(x[0]-5.3) +
+                                  (x[1]-6.4)*(x[1]-6.4) +
+                                  (x[2]-5.7)*(x[2]-5.7)));
+    vectors->InsertNextTuple3(x[1], -x[0], 0.1*x[2]*x[2]);
+    }
+  grid->GetPointData()->SetScalars(scalars);
+  grid->GetPointData()->AddArray(vectors);
+  scalars->Delete();
+  vectors->Delete();
+  vtkTestDataSetUtilities::AddCellIds(grid);
+  return grid;
+}
+
+static int CompareOutputs(vtkPointSet* p1, vtkPointSet* p2, const char* label)
+{
+  cout << "Comparing " << label << ": " << p1->GetNumberOfCells()
+       << " cells, " << p1->GetNumberOfPoints() << " points.\n";
+  if(p1->GetNumberOfCells() == 0)
+    {
+    cerr << "Empty output" << endl;
+    return 1;
+    }
+  return vtkTestDataSetUtilities::ComparePointSets(p1, p2, 0, 0.0,
+                                                   "Merging by edge");
+}
+
+int TestMergePointsByEdge(int, char*[])
+{
+  int rval = 0;
+  const int cellTypes[2] = { VTK_TETRA, VTK_HEXAHEDRON };
+  for(int type=0;type<2;type++)
+    {
+    vtkSmartPointer<vtkUnstructuredGrid> grid;
+    grid.TakeReference(MakeGrid(cellTypes[type]));
+
+    // two cut planes close enough to cross the same edges
+    vtkSmartPointer<vtkPlane> plane = vtkSmartPointer<vtkPlane>::New();
+    plane->SetOrigin(5.5, 5.5, 5.5);
+    plane->SetNormal(0.3, 0.5, 0.8);
+
+    vtkSmartPointer<vtkPolyData> cuts[2];
+    vtkSmartPointer<vtkUnstructuredGrid> clips[2], clippedAway[2];
+    for(int byEdge=0;byEdge<2;byEdge++)
+      {
+      vtkSmartPointer<vtkCutter> cutter = vtkSmartPointer<vtkCutter>::New();
+      cutter->SetInput(grid);
+      cutter->SetCutFunction(plane);
+      cutter->SetValue(0, 0.0);
+      cutter->SetValue(1, 0.1);
+      cutter->SetMergePointsByEdge(byEdge);
+      cutter->Update();
+      cuts[byEdge] = cutter->GetOutput();
+
+      vtkSmartPointer<vtkClipDataSet> clipper =
+        vtkSmartPointer<vtkClipDataSet>::New();
+      clipper->SetInput(grid);
+      clipper->SetValue(4.5);
+      clipper->GenerateClippedOutputOn();
+      clipper->SetMergePointsByEdge(byEdge);
+      clipper->Update();
+      clips[byEdge] = clipper->GetOutput();
+      clippedAway[byEdge] = clipper->GetClippedOutput();
+      }
+
+    const char* name = (type ? "hexahedra" : "tetrahedra");
+    cout << "Grid of " << name << endl;
+    rval += CompareOutputs(cuts[0], cuts[1], "cuts");
+    rval += CompareOutputs(clips[0], clips[1], "clips");
+    rval += CompareOutputs(clippedAway[0], clippedAway[1], "clipped away");
+    }
+
+  return rval;
+}
@@ -0,0 +1,101 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compute the normals of a sphere with some of its triangles reversed and
+// of a cube with one and with several threads, and check that the outputs
+// are the same and that the normals of the sphere point outwards.
+
+#include "vtkCubeSource.h"
+#include "vtkDataArray.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataNormals.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkSphereSource.h"
+
+// the normals of a sphere centered at the origin point outwards
+static int CheckSphereNormals(vtkPolyData* sphere)
+{
+  vtkDataArray* normals = sphere->GetPointData()->GetNormals();
+  for(vtkIdType i=0;i<sphere->GetNumberOfPoints();i++)
+    {
+    double x[3], n[3];
+    sphere->GetPoint(i, x);
+    normals->GetTuple(i, n);
+    vtkMath::Normalize(x);
+    if(vtkMath::Dot(x, n) < 0.9)
+      {
+      cerr << "Wrong normal at point " << i << endl;
+      return 1;
+      }
+    }
+  return 0;
+}
+
+int TestPolyDataNormalsThreads(int, char*[])
+{
+  vtkSmartPointer<vtkSphereSource> sphereSource =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphereSource->SetThetaResolution(80);
+  sphereSource->SetPhiResolution(60);
+  sphereSource->Update();
+  vtkSmartPointer<vtkPolyData> sphere = vtkSmartPointer<vtkPolyData>::New();
+  sphere->DeepCopy(sphereSource->GetOutput());
+  sphere->BuildCells();
+  for(vtkIdType cellId=3;cellId<sphere->GetNumberOfCells();cellId+=3)
+    {
+    sphere->ReverseCell(cellId);
+    }
+  sphere->GetPointData()->SetNormals(NULL);
+
+  vtkSmartPointer<vtkCubeSource> cube = vtkSmartPointer<vtkCubeSource>::New();
+  cube->Update();
+
+  vtkPolyData* inputs[2] = { sphere, cube->GetOutput() };
+  int rval = 0;
+  for(int input=0;input<2;input++)
+    {
+    for(int options=0;options<8;options++)
+      {
+      vtkSmartPointer<vtkPolyData> outputs[2];
+      for(int threaded=0;threaded<2;threaded++)
+        {
+        vtkSmartPointer<vtkPolyDataNormals> normals =
+          vtkSmartPointer<vtkPolyDataNormals>::New();
+        normals->SetInput(inputs[input]);
+        normals->SetConsistency(options & 1);
+        normals->SetSplitting(options & 2 ? 1 : 0);
+        normals->SetFlipNormals(options & 4 ? 1 : 0);
+        normals->ComputeCellNormalsOn();
+        normals->SetNumberOfThreads(threaded ? 4 : 1);
+        normals->Update();
+        outputs[threaded] = normals->GetOutput();
+        }
+      if(vtkTestDataSetUtilities::ComparePolyData(outputs[0], outputs[1],
+                                                  "Threaded normals"))
+        {
+        cerr << "Input " << input << ", options " << options << endl;
+        rval++;
+        }
+      if(input == 0 && options == 1)
+        {
+        rval += CheckSphereNormals(outputs[0]);
+        }
+      }
+    }
+
+  return rval;
+}
@@ -0,0 +1,401 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Decimate a sphere with vertices and lines by quadric clustering, streaming
+// it in pieces with and without the bounds of the whole input known and on
+// several threads, and check that the output is that of the whole sphere.
+// Auto adjust the divisions to the points of the pieces when the first
+// piece is empty, abort a stream and check that the next one starts over.
+// Also decimate on a grid far too large to be stored densely.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkQuadricClustering.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTestDataSetUtilities.h"
+
+// produces the pieces of a mesh, each made of a range of its vertices, of
+// its lines and of its polygons, and counts its executions. The first piece
+// is left empty, without points, if asked, and the consumer of the pieces
+// is aborted on a given execution.
+class vtkTestPieceSource : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkTestPieceSource *New();
+  vtkTypeRevisionMacro(vtkTestPieceSource,vtkPolyDataAlgorithm);
+
+  vtkPolyData *Mesh;
+  int ProvideBounds;
+  int EmptyFirstPiece;
+  int NumberOfExecutions;
+  vtkAlgorithm *Consumer;
+  int AbortExecution;
+
+protected:
+  vtkTestPieceSource()
+    {
+    this->SetNumberOfInputPorts(0);
+    this->Mesh = NULL;
+    this->ProvideBounds = 0;
+    this->EmptyFirstPiece = 0;
+    this->NumberOfExecutions = 0;
+    this->Consumer = NULL;
+    this->AbortExecution = 0;
+    }
+
+  int RequestInformation(vtkInformation *, vtkInformationVector **,
+                         vtkInformationVector *outputVector)
+    {
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::MAXIMUM_NUMBER_OF_PIECES(),
+                 -1);
+    if (this->ProvideBounds)
+      {
+      outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_BOUNDING_BOX(),
+                   this->Mesh->GetBounds(), 6);
+      }
+    return 1;
+    }
+
+  int RequestData(vtkInformation *, vtkInformationVector **,
+                  vtkInformationVector *outputVector)
+    {
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    vtkPolyData *output = vtkPolyData::SafeDownCast(
+      outInfo->Get(vtkDataObject::DATA_OBJECT()));
+    int piece =
+      outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+    int numPieces =
+      outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
+    this->NumberOfExecutions++;
+    if (this->NumberOfExecutions == this->AbortExecution)
+      {
+      this->Consumer->AbortExecuteOn();
+      }
+    if (this->EmptyFirstPiece)
+      {
+      if (piece == 0)
+        {
+        return 1;
+        }
+      piece--;
+      numPieces--;
+      }
+
+    vtkCellArray *inCells[3] =
+      { this->Mesh->GetVerts(), this->Mesh->GetLines(), this->Mesh->GetPolys() };
+    vtkCellArray *outCells[3];
+    vtkCellData *inCD = this->Mesh->GetCellData();
+    vtkCellData *outCD = output->GetCellData();
+    outCD->CopyAllocate(inCD);
+    vtkIdType cellId = 0, outCellId = 0, npts, *pts;
+    for (int type=0; type < 3; type++)
+      {
+      outCells[type] = vtkCellArray::New();
+      vtkIdType numCells = inCells[type]->GetNumberOfCells();
+      vtkIdType begin = piece*numCells/numPieces;
+      vtkIdType end = (piece+1)*numCells/numPieces;
+      inCells[type]->InitTraversal();
+      for (vtkIdType i=0; inCells[type]->GetNextCell(npts, pts); i++, cellId++)
+        {
+        if (i >= begin && i < end)
+          {
+          outCells[type]->InsertNextCell(npts, pts);
+          outCD->CopyData(inCD, cellId, outCellId++);
+          }
+        }
+      }
+    output->SetPoints(this->Mesh->GetPoints());
+    output->SetVerts(outCells[0]);
+    output->SetLines(outCells[1]);
+    output->SetPolys(outCells[2]);
+    for (int type=0; type < 3; type++)
+      {
+      outCells[type]->Delete();
+      }
+    return 1;
+    }
+};
+
+vtkCxxRevisionMacro(vtkTestPieceSource, "$Revision$");
+vtkStandardNewMacro(vtkTestPieceSource);
+
+// a sphere, with a few vertices and lines if asked, and the cell ids as
+// cell data
+static vtkPolyData* MakeMesh(int withVertsAndLines)
+{
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetThetaResolution(60);
+  sphere->SetPhiResolution(40);
+  sphere->Update();
+  vtkPolyData* mesh = vtkPolyData::New();
+  mesh->ShallowCopy(sphere->GetOutput());
+
+  vtkIdType numPts = mesh->GetNumberOfPoints();
+  vtkCellArray* verts = vtkCellArray::New();
+  vtkCellArray* lines = vtkCellArray::New();
+  for (vtkIdType i=0; withVertsAndLines && i < numPts; i+=37)
+    {
+    verts->InsertNextCell(1, &i);
+    }
+  for (vtkIdType i=0; withVertsAndLines && i+40 < numPts; i+=53)
+    {
+    vtkIdType line[2] = { i, i+40 };
+    lines->InsertNextCell(2, line);
+    }
+  mesh->SetVerts(verts);
+  mesh->SetLines(lines);
+  verts->Delete();
+  lines->Delete();
+
+  vtkTestDataSetUtilities::AddCellIds(mesh);
+  return mesh;
+}
+
+static void SetUp(vtkQuadricClustering* clustering)
+{
+  clustering->SetNumberOfDivisions(17, 19, 13);
+  clustering->AutoAdjustNumberOfDivisionsOff();
+  clustering->CopyCellDataOn();
+}
+
+// The outputs have the same cells, with their points at most tol apart.
+// The points are numbered in the order the cells first use them, which
+// differs between the whole input and its pieces when vertices and lines
+// are mixed with the polygons, and so does the order of the cell data. It
+// is only compared for polygons alone.
+static int CompareOutputs(vtkPolyData* p1, vtkPolyData* p2, double tol,
+                          const char* label)
+{
+  if (p1->GetNumberOfPoints() != p2->GetNumberOfPoints() ||
+      p1->GetNumberOfVerts() != p2->GetNumberOfVerts() ||
+      p1->GetNumberOfLines() != p2->GetNumberOfLines() ||
+      p1->GetNumberOfPolys() != p2->GetNumberOfPolys())
+    {
+    cerr << label << ": " << p2->GetNumberOfPoints() << " points and "
+         << p2->GetNumberOfCells() << " cells instead of "
+         << p1->GetNumberOfPoints() << " and " << p1->GetNumberOfCells() << endl;
+    return 1;
+    }
+  vtkCellArray* cells1[3] = { p1->GetVerts(), p1->GetLines(), p1->GetPolys() };
+  vtkCellArray* cells2[3] = { p2->GetVerts(), p2->GetLines(), p2->GetPolys() };
+  for (int type=0; type < 3; type++)
+    {
+    vtkIdType npts1, *pts1, npts2, *pts2;
+    cells1[type]->InitTraversal();
+    cells2[type]->InitTraversal();
+    while (cells1[type]->GetNextCell(npts1, pts1))
+      {
+      cells2[type]->GetNextCell(npts2, pts2);
+      if (npts1 != npts2)
+        {
+        cerr << label << ": cells differ" << endl;
+        return 1;
+        }
+      for (vtkIdType i=0; i < npts1; i++)
+        {
+        double x1[3], x2[3];
+        p1->GetPoint(pts1[i], x1);
+        p2->GetPoint(pts2[i], x2);
+        for (int j=0; j < 3; j++)
+          {
+          if (fabs(x1[j] - x2[j]) > tol)
+            {
+            cerr << label << ": points differ" << endl;
+            return 1;
+            }
+          }
+        }
+      }
+    }
+  if (p1->GetNumberOfVerts() > 0 || p1->GetNumberOfLines() > 0)
+    {
+    return 0;
+    }
+
+  vtkDataArray* ids1 = p1->GetCellData()->GetArray("CellId");
+  vtkDataArray* ids2 = p2->GetCellData()->GetArray("CellId");
+  if (!ids1 || !ids2)
+    {
+    cerr << label << ": cell data missing" << endl;
+    return 1;
+    }
+  return vtkTestDataSetUtilities::CompareArrays(ids1, ids2, label);
+}
+
+int TestQuadricClusteringStreaming(int, char*[])
+{
+  int rval = 0;
+  const int numPieces = 5;
+  vtkSmartPointer<vtkPolyData> mesh;
+  for (int withVertsAndLines=0; withVertsAndLines < 2; withVertsAndLines++)
+    {
+    mesh.TakeReference(MakeMesh(withVertsAndLines));
+
+    vtkSmartPointer<vtkQuadricClustering> whole =
+      vtkSmartPointer<vtkQuadricClustering>::New();
+    SetUp(whole);
+    whole->SetInput(mesh);
+    whole->Update();
+    cout << "Decimated " << mesh->GetNumberOfCells() << " cells into "
+         << whole->GetOutput()->GetNumberOfCells() << endl;
+
+    for (int provideBounds=0; provideBounds < 2; provideBounds++)
+      {
+      vtkSmartPointer<vtkTestPieceSource> source =
+        vtkSmartPointer<vtkTestPieceSource>::New();
+      source->Mesh = mesh;
+      source->ProvideBounds = provideBounds;
+      vtkSmartPointer<vtkQuadricClustering> streamed =
+        vtkSmartPointer<vtkQuadricClustering>::New();
+      SetUp(streamed);
+      streamed->SetInputConnection(source->GetOutputPort());
+      streamed->SetNumberOfStreamDivisions(numPieces);
+      streamed->Update();
+
+      const char* label = (provideBounds ? "streamed with whole bounds" :
+                           "streamed without whole bounds");
+      rval += CompareOutputs(whole->GetOutput(), streamed->GetOutput(), 0.0,
+                             label);
+      int expected = (provideBounds ? 1 : 2)*numPieces;
+      if (source->NumberOfExecutions != expected)
+        {
+        cerr << label << ": " << source->NumberOfExecutions
+             << " pieces requested instead of " << expected << endl;
+        rval++;
+        }
+
+      // the quadrics are summed in another order on threads
+      streamed->SetNumberOfThreads(3);
+      streamed->Update();
+      rval += CompareOutputs(whole->GetOutput(), streamed->GetOutput(), 1e-6,
+                             "streamed on threads");
+      }
+    }
+
+  // The divisions are adjusted to the points of the pieces, those of the
+  // whole mesh in each piece but the empty first one. They are counted in
+  // a first pass without the whole bounds, and estimated from the first
+  // piece with points, for all the pieces, with them.
+  for (int provideBounds=0; provideBounds < 2; provideBounds++)
+    {
+    vtkSmartPointer<vtkPolyData> repeated =
+      vtkSmartPointer<vtkPolyData>::New();
+    repeated->ShallowCopy(mesh);
+    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    for (int i=(provideBounds ? 0 : 1); i < numPieces; i++)
+      {
+      for (vtkIdType ptId=0; ptId < mesh->GetNumberOfPoints(); ptId++)
+        {
+        points->InsertNextPoint(mesh->GetPoint(ptId));
+        }
+      }
+    repeated->SetPoints(points);
+    repeated->GetPointData()->Initialize();
+    vtkSmartPointer<vtkQuadricClustering> adjusted =
+      vtkSmartPointer<vtkQuadricClustering>::New();
+    adjusted->SetInput(repeated);
+    adjusted->SetNumberOfDivisions(100, 100, 100);
+    adjusted->CopyCellDataOn();
+    adjusted->Update();
+
+    vtkSmartPointer<vtkTestPieceSource> source =
+      vtkSmartPointer<vtkTestPieceSource>::New();
+    source->Mesh = mesh;
+    source->ProvideBounds = provideBounds;
+    source->EmptyFirstPiece = 1;
+    vtkSmartPointer<vtkQuadricClustering> streamed =
+      vtkSmartPointer<vtkQuadricClustering>::New();
+    streamed->SetInputConnection(source->GetOutputPort());
+    streamed->SetNumberOfDivisions(100, 100, 100);
+    streamed->CopyCellDataOn();
+    streamed->SetNumberOfStreamDivisions(numPieces);
+    streamed->Update();
+
+    int expected = (provideBounds ? 1 : 2)*numPieces;
+    if (source->NumberOfExecutions != expected)
+      {
+      cerr << "Auto adjusted: " << source->NumberOfExecutions
+           << " pieces requested instead of " << expected << endl;
+      rval++;
+      }
+    rval += CompareOutputs(adjusted->GetOutput(), streamed->GetOutput(), 0.0,
+                           "auto adjusted with an empty first piece");
+    }
+
+  // A stream aborted on its third piece stops there, and the next one
+  // starts over from the first piece.
+  vtkSmartPointer<vtkQuadricClustering> whole =
+    vtkSmartPointer<vtkQuadricClustering>::New();
+  SetUp(whole);
+  whole->SetInput(mesh);
+  whole->Update();
+  vtkSmartPointer<vtkTestPieceSource> source =
+    vtkSmartPointer<vtkTestPieceSource>::New();
+  source->Mesh = mesh;
+  source->ProvideBounds = 1;
+  vtkSmartPointer<vtkQuadricClustering> streamed =
+    vtkSmartPointer<vtkQuadricClustering>::New();
+  SetUp(streamed);
+  streamed->SetInputConnection(source->GetOutputPort());
+  streamed->SetNumberOfStreamDivisions(numPieces);
+  source->Consumer = streamed;
+  source->AbortExecution = 3;
+  streamed->Update();
+  if (source->NumberOfExecutions != 3)
+    {
+    cerr << "Aborted: " << source->NumberOfExecutions
+         << " pieces requested instead of 3" << endl;
+    rval++;
+    }
+  source->AbortExecution = 0;
+  source->Modified();
+  streamed->Update();
+  if (source->NumberOfExecutions != 3 + numPieces)
+    {
+    cerr << "After abort: " << source->NumberOfExecutions - 3
+         << " pieces requested instead of " << numPieces << endl;
+    rval++;
+    }
+  rval += CompareOutputs(whole->GetOutput(), streamed->GetOutput(), 0.0,
+                         "streamed after abort");
+
+  // a billion bins, each point of the sphere getting its own
+  vtkSmartPointer<vtkQuadricClustering> fine =
+    vtkSmartPointer<vtkQuadricClustering>::New();
+  fine->SetInput(mesh);
+  fine->SetNumberOfDivisions(1000, 1000, 1000);
+  fine->AutoAdjustNumberOfDivisionsOff();
+  fine->Update();
+  if (fine->GetOutput()->GetNumberOfPolys() != mesh->GetNumberOfPolys() ||
+      fine->GetOutput()->GetNumberOfPoints() != mesh->GetNumberOfPoints())
+    {
+    cerr << "Fine grid: " << fine->GetOutput()->GetNumberOfPoints()
+         << " points and " << fine->GetOutput()->GetNumberOfPolys()
+         << " polygons instead of " << mesh->GetNumberOfPoints() << " and "
+         << mesh->GetNumberOfPolys() << endl;
+    rval++;
+    }
+  return rval;
+}
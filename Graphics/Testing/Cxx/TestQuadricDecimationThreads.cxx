@@ -0,0 +1,140 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Decimate a sphere with scalars, with and without the attribute error
+// metric, and a flat square, whose edges all cost the same, on one and on
+// several threads, and check that the outputs are the same, reduced as
+// asked, made of proper triangles and still on the original surface. The
+// square also checks that edges of equal cost are collapsed in the order
+// they always were.
+
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkPlaneSource.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkQuadricDecimation.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkSphereSource.h"
+#include "vtkTriangleFilter.h"
+
+// the triangles use three different points, all within the radius of the
+// sphere or the plane of the square
+static int CheckOutput(vtkPolyData* output, int sphere)
+{
+  vtkCellArray* polys = output->GetPolys();
+  vtkIdType npts, *pts;
+  for(polys->InitTraversal();polys->GetNextCell(npts, pts);)
+    {
+    if(npts != 3 || pts[0] == pts[1] || pts[1] == pts[2] || pts[2] == pts[0])
+      {
+      cerr << "Degenerate triangle" << endl;
+      return 1;
+      }
+    }
+  for(vtkIdType i=0;i<output->GetNumberOfPoints();i++)
+    {
+    double x[3];
+    output->GetPoint(i, x);
+    double error = (sphere ?
+                    fabs(sqrt(x[0]*x[0] + x[1]*x[1] + x[2]*x[2]) - 0.5) :
+                    fabs(x[2]));
+    if(error > 0.01)
+      {
+      cerr << "Point " << i << " moved off the surface by " << error << endl;
+      return 1;
+      }
+    }
+  return 0;
+}
+
+int TestQuadricDecimationThreads(int, char*[])
+{
+  vtkSmartPointer<vtkSphereSource> sphereSource =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphereSource->SetThetaResolution(80);
+  sphereSource->SetPhiResolution(60);
+  sphereSource->Update();
+  vtkSmartPointer<vtkPolyData> sphere = vtkSmartPointer<vtkPolyData>::New();
+  sphere->DeepCopy(sphereSource->GetOutput());
+  vtkSmartPointer<vtkDoubleArray> wave = vtkSmartPointer<vtkDoubleArray>::New();
+  wave->SetName("Wave");
+  for(vtkIdType i=0;i<sphere->GetNumberOfPoints();i++)
+    {
+    double x[3];
+    sphere->GetPoint(i, x);
+    wave->InsertNextValue(sin(10.0*x[0]) * cos(7.0*x[1]));
+    }
+  sphere->GetPointData()->SetScalars(wave);
+
+  vtkSmartPointer<vtkPlaneSource> plane =
+    vtkSmartPointer<vtkPlaneSource>::New();
+  plane->SetResolution(60, 60);
+  vtkSmartPointer<vtkTriangleFilter> square =
+    vtkSmartPointer<vtkTriangleFilter>::New();
+  square->SetInputConnection(plane->GetOutputPort());
+  square->Update();
+
+  vtkPolyData* inputs[2] = { sphere, square->GetOutput() };
+  // the points of the outputs for each input and attribute error metric
+  vtkIdType expectedPoints[2][2] = { { 466, 466 }, { 401, 0 } };
+  int rval = 0;
+  for(int input=0;input<2;input++)
+    {
+    // the attributes of the square cannot be interpolated over the plane
+    for(int attributes=0;attributes<(input == 0 ? 2 : 1);attributes++)
+      {
+      vtkSmartPointer<vtkPolyData> outputs[2];
+      double reduction = 0.0;
+      for(int threaded=0;threaded<2;threaded++)
+        {
+        vtkSmartPointer<vtkQuadricDecimation> decimation =
+          vtkSmartPointer<vtkQuadricDecimation>::New();
+        decimation->SetInput(inputs[input]);
+        decimation->SetTargetReduction(0.9);
+        decimation->SetAttributeErrorMetric(attributes);
+        decimation->SetNumberOfThreads(threaded ? 4 : 1);
+        decimation->Update();
+        outputs[threaded] = decimation->GetOutput();
+        reduction = decimation->GetActualReduction();
+        }
+
+      cout << "Input " << input << ", attributes " << attributes << ": "
+           << inputs[input]->GetNumberOfPolys() << " triangles reduced to "
+           << outputs[0]->GetNumberOfPolys() << endl;
+      int failed = 0;
+      failed += vtkTestDataSetUtilities::ComparePolyData(
+        outputs[0], outputs[1], "Threaded decimation");
+      if(reduction < 0.9)
+        {
+        cerr << "Reduced by " << reduction << " only" << endl;
+        failed++;
+        }
+      failed += CheckOutput(outputs[0], input == 0);
+      if(outputs[0]->GetNumberOfPoints() != expectedPoints[input][attributes])
+        {
+        cerr << outputs[0]->GetNumberOfPoints() << " points instead of "
+             << expectedPoints[input][attributes] << endl;
+        failed++;
+        }
+      if(failed)
+        {
+        rval++;
+        }
+      }
+    }
+
+  return rval;
+}
@@ -0,0 +1,72 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Time vtkQuadricDecimation reducing a sphere to 5% of its triangles on one
+// and on four threads, and check that the outputs are the same. Pass
+// "-n <triangles>" to change the size of the sphere, 50000 triangles by
+// default; the benchmark proper is run with 10000000.
+
+#include "vtkPolyData.h"
+#include "vtkQuadricDecimation.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTestDataSetUtilities.h"
+#include "vtkTimerLog.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+int TestQuadricDecimationTiming(int argc, char *argv[])
+{
+  vtkIdType numTris = 50000;
+  for (int i=1; i < argc-1; i++)
+    {
+    if (!strcmp(argv[i], "-n"))
+      {
+      numTris = atoi(argv[i+1]);
+      }
+    }
+
+  // A sphere of phi by 2*phi points has about 4*phi*phi triangles.
+  int phi = static_cast<int>(sqrt(numTris / 4.0));
+  phi = (phi > 4 ? phi : 4);
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetPhiResolution(phi);
+  sphere->SetThetaResolution(2*phi);
+  sphere->Update();
+  cerr << sphere->GetOutput()->GetNumberOfPolys() << " triangles" << endl;
+
+  vtkSmartPointer<vtkTimerLog> timer = vtkSmartPointer<vtkTimerLog>::New();
+  vtkSmartPointer<vtkPolyData> outputs[2];
+  int numThreads[2] = { 1, 4 };
+  for (int i=0; i < 2; i++)
+    {
+    vtkSmartPointer<vtkQuadricDecimation> decimation =
+      vtkSmartPointer<vtkQuadricDecimation>::New();
+    decimation->SetInputConnection(sphere->GetOutputPort());
+    decimation->SetTargetReduction(0.95);
+    decimation->SetNumberOfThreads(numThreads[i]);
+    timer->StartTimer();
+    decimation->Update();
+    timer->StopTimer();
+    outputs[i] = decimation->GetOutput();
+    cerr << numThreads[i] << " threads: " << timer->GetElapsedTime()
+         << " s, " << outputs[i]->GetNumberOfPolys() << " triangles left"
+         << endl;
+    }
+
+  return vtkTestDataSetUtilities::ComparePolyData(outputs[0], outputs[1],
+                                                  "Threaded decimation");
+}
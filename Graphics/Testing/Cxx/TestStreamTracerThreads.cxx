@@ -0,0 +1,165 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Integrate streamlines from many seeds with one and with several threads
+// and check that the outputs are the same, for both interpolator types and
+// with the neighbor walk, whose cell search statistics are output as well.
+
+#include "vtkCellData.h"
+#include "vtkCellLocator.h"
+#include "vtkCellLocatorInterpolatedVelocityField.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkInterpolatedVelocityField.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamTracer.h"
+#include "vtkStructuredGrid.h"
+#include "vtkTestDataSetUtilities.h"
+
+#define NUMBER_OF_SEEDS 200
+
+// a vortex around the z axis drifting upwards, on a distorted grid
+static vtkStructuredGrid* MakeVortexGrid()
+{
+  const int dim = 16;
+  vtkStructuredGrid* grid = vtkStructuredGrid::New();
+  grid->SetDimensions(dim, dim, dim);
+  vtkPoints* points = vtkPoints::New();
+  vtkDoubleArray* vectors = vtkDoubleArray::New();
+  vectors->SetName("Velocity");
+  vectors->SetNumberOfComponents(3);
+  for(int k=0;k<dim;k++)
+    {
+    for(int j=0;j<dim;j++)
+      {
+      for(int i=0;i<dim;i++)
+        {
+        double x = i - 0.5*(dim-1) + 0.2*sin(0.7*j);
+        double y = j - 0.5*(dim-1) + 0.2*sin(0.5*k);
+        double z = k + 0.2*sin(0.3*i);
+        points->InsertNextPoint(x, y, z);
+        vectors->InsertNextTuple3(-y, x, 0.3*(x*x + y*y) / dim);
+        }
+      }
+    }
+  grid->SetPoints(points);
+  grid->GetPointData()->SetVectors(vectors);
+  points->Delete();
+  vectors->Delete();
+  return grid;
+}
+
+static int CompareStreamlines(vtkPolyData* p1, vtkPolyData* p2,
+                              const char* label)
+{
+  cout << "Comparing " << label << " streamlines: "
+       << p1->GetNumberOfLines() << " lines, "
+       << p1->GetNumberOfPoints() << " points.\n";
+  if(p1->GetNumberOfLines() < NUMBER_OF_SEEDS / 2)
+    {
+    cerr << "Too few streamlines" << endl;
+    return 1;
+    }
+  if(p1->GetNumberOfLines() != p2->GetNumberOfLines())
+    {
+    cerr << "Threaded integration gave " << p2->GetNumberOfLines()
+         << " lines instead of " << p1->GetNumberOfLines() << endl;
+    return 1;
+    }
+
+  const char* pointArrays[] =
+    { "Velocity", "IntegrationTime", "Vorticity", "Rotation", "Normals" };
+  for(int i=0;i<5;i++)
+    {
+    if(!p1->GetPointData()->GetArray(pointArrays[i]))
+      {
+      cerr << pointArrays[i] << " missing" << endl;
+      return 1;
+      }
+    }
+  return vtkTestDataSetUtilities::ComparePolyData(p1, p2,
+                                                  "Threaded integration");
+}
+
+int TestStreamTracerThreads(int, char*[])
+{
+  vtkSmartPointer<vtkStructuredGrid> grid;
+  grid.TakeReference(MakeVortexGrid());
+
+  // seeds both inside and outside the grid
+  vtkMath::RandomSeed(1234);
+  vtkSmartPointer<vtkPoints> seedPoints = vtkSmartPointer<vtkPoints>::New();
+  for(int i=0;i<NUMBER_OF_SEEDS;i++)
+    {
+    seedPoints->InsertNextPoint(vtkMath::Random(-8.0, 8.0),
+                                vtkMath::Random(-8.0, 8.0),
+                                vtkMath::Random(-1.0, 12.0));
+    }
+  vtkSmartPointer<vtkPolyData> seeds = vtkSmartPointer<vtkPolyData>::New();
+  seeds->SetPoints(seedPoints);
+
+  int rval = 0;
+  const char* labels[3] = { "point locator", "cell locator", "neighbor walk" };
+  for(int interpolator=0;interpolator<3;interpolator++)
+    {
+    vtkSmartPointer<vtkPolyData> outputs[2];
+    for(int threaded=0;threaded<2;threaded++)
+      {
+      vtkSmartPointer<vtkStreamTracer> tracer =
+        vtkSmartPointer<vtkStreamTracer>::New();
+      tracer->SetInput(grid);
+      tracer->SetSource(seeds);
+      if(interpolator == 2)
+        {
+        vtkSmartPointer<vtkInterpolatedVelocityField> function =
+          vtkSmartPointer<vtkInterpolatedVelocityField>::New();
+        function->NeighborWalkOn();
+        tracer->SetInterpolatorPrototype(function);
+        }
+      else if(interpolator)
+        {
+        // vtkModifiedBSPTree, the default locator, splits its nodes along
+        // random axes, so runs with different trees may find different
+        // cells for points on cell faces.
+        vtkSmartPointer<vtkCellLocatorInterpolatedVelocityField> function =
+          vtkSmartPointer<vtkCellLocatorInterpolatedVelocityField>::New();
+        vtkSmartPointer<vtkCellLocator> locator =
+          vtkSmartPointer<vtkCellLocator>::New();
+        function->SetCellLocatorPrototype(locator);
+        tracer->SetInterpolatorPrototype(function);
+        }
+      tracer->SetIntegratorTypeToRungeKutta45();
+      tracer->SetIntegrationDirectionToBoth();
+      tracer->SetMaximumPropagation(60);
+      tracer->SetNumberOfThreads(threaded ? 4 : 1);
+      tracer->Update();
+      outputs[threaded] = tracer->GetOutput();
+      }
+    rval += CompareStreamlines(outputs[0], outputs[1], labels[interpolator]);
+    vtkDataArray* walkHits = outputs[0]->GetCellData()->GetArray("WalkHits");
+    if((interpolator == 2) != (walkHits != 0) ||
+       (walkHits && walkHits->GetRange()[1] <= 0))
+      {
+      cerr << "Cell search statistics wrongly output with the "
+           << labels[interpolator] << endl;
+      rval++;
+      }
+    }
+
+  return rval;
+}
@@ -0,0 +1,196 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Contour an image with and without the brick index of
+// vtkSynchronizedTemplates3D at many values and check that the outputs are
+// the same, also after the scalars are modified.
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSynchronizedTemplates3D.h"
+
+#include <vtkstd/vector>
+
+// an image of two blobs with an offset extent, the distance to their
+// centers in the second component of its scalars
+static vtkImageData* MakeImage()
+{
+  vtkImageData* image = vtkImageData::New();
+  image->SetExtent(-3, 43, 2, 38, 5, 49);
+  image->SetSpacing(0.5, 0.7, 0.6);
+  image->SetOrigin(1.0, -2.0, 0.5);
+  vtkFloatArray* scalars = vtkFloatArray::New();
+  scalars->SetName("Blobs");
+  scalars->SetNumberOfComponents(2);
+  scalars->SetNumberOfTuples(image->GetNumberOfPoints());
+  int* ext = image->GetExtent();
+  vtkIdType id = 0;
+  for(int k=ext[4];k<=ext[5];k++)
+    {
+    for(int j=ext[2];j<=ext[3];j++)
+      {
+      for(int i=ext[0];i<=ext[1];i++, id++)
+        {
+        double d1 = (i-8)*(i-8) + (j-10)*(j-10) + (k-15)*(k-15);
+        double d2 = (i-32)*(i-32) + (j-28)*(j-28) + (k-38)*(k-38);
+        scalars->SetComponent(id, 0, i);
+        scalars->SetComponent(id, 1, floor(sqrt(d1 < d2 ? d1 : d2)));
+        }
+      }
+    }
+  image->GetPointData()->SetScalars(scalars);
+  scalars->Delete();
+  return image;
+}
+
+static int CompareOutputs(vtkPolyData* p1, vtkPolyData* p2, double value)
+{
+  if(p1->GetNumberOfPoints() != p2->GetNumberOfPoints() ||
+     p1->GetNumberOfPolys() != p2->GetNumberOfPolys())
+    {
+    cerr << "The brick index gave " << p2->GetNumberOfPoints() << " points and "
+         << p2->GetNumberOfPolys() << " triangles instead of "
+         << p1->GetNumberOfPoints() << " and " << p1->GetNumberOfPolys()
+         << " at " << value << endl;
+    return 1;
+    }
+  for(vtkIdType i=0;i<p1->GetNumberOfPoints();i++)
+    {
+    double x1[3], x2[3];
+    p1->GetPoint(i, x1);
+    p2->GetPoint(i, x2);
+    if(x1[0] != x2[0] || x1[1] != x2[1] || x1[2] != x2[2])
+      {
+      cerr << "Points differ at " << value << endl;
+      return 1;
+      }
+    }
+  vtkIdTypeArray* c1 = p1->GetPolys()->GetData();
+  vtkIdTypeArray* c2 = p2->GetPolys()->GetData();
+  for(vtkIdType i=0;i<c1->GetNumberOfTuples();i++)
+    {
+    if(c1->GetValue(i) != c2->GetValue(i))
+      {
+      cerr << "Triangles differ at " << value << endl;
+      return 1;
+      }
+    }
+  vtkDataArray* n1 = p1->GetPointData()->GetNormals();
+  vtkDataArray* n2 = p2->GetPointData()->GetNormals();
+  for(vtkIdType i=0;i<n1->GetNumberOfTuples();i++)
+    {
+    for(int j=0;j<3;j++)
+      {
+      if(n1->GetComponent(i, j) != n2->GetComponent(i, j))
+        {
+        cerr << "Normals differ at " << value << endl;
+        return 1;
+        }
+      }
+    }
+  return 0;
+}
+
+static int CompareContours(vtkSynchronizedTemplates3D* plain,
+                           vtkSynchronizedTemplates3D* bricks,
+                           const vtkstd::vector<double>& values,
+                           vtkIdType& numPolys)
+{
+  int rval = 0;
+  for(size_t v=0;v<values.size();v++)
+    {
+    plain->SetValue(0, values[v]);
+    bricks->SetValue(0, values[v]);
+    plain->Update();
+    bricks->Update();
+    rval += CompareOutputs(plain->GetOutput(), bricks->GetOutput(), values[v]);
+    numPolys += plain->GetOutput()->GetNumberOfPolys();
+    }
+  // several values at once
+  plain->SetValue(1, values[values.size()/2]);
+  bricks->SetValue(1, values[values.size()/2]);
+  plain->Update();
+  bricks->Update();
+  rval += CompareOutputs(plain->GetOutput(), bricks->GetOutput(), values[0]);
+  plain->SetNumberOfContours(1);
+  bricks->SetNumberOfContours(1);
+  return rval;
+}
+
+int TestSynchronizedTemplates3DBricks(int, char*[])
+{
+  vtkSmartPointer<vtkImageData> image;
+  image.TakeReference(MakeImage());
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+
+  vtkSmartPointer<vtkSynchronizedTemplates3D> plain =
+    vtkSmartPointer<vtkSynchronizedTemplates3D>::New();
+  plain->SetInput(image);
+  plain->SetArrayComponent(1);
+  vtkSmartPointer<vtkSynchronizedTemplates3D> bricks =
+    vtkSmartPointer<vtkSynchronizedTemplates3D>::New();
+  bricks->SetInput(image);
+  bricks->SetArrayComponent(1);
+  bricks->UseBrickIndexOn();
+  bricks->SetBrickSize(5);
+
+  // values between and at the scalar values, which are whole numbers
+  vtkstd::vector<double> values;
+  for(int i=-1;i<=40;i++)
+    {
+    values.push_back(i);
+    values.push_back(i + 0.37);
+    }
+
+  int rval = 0;
+  vtkIdType numPolys = 0;
+  rval += CompareContours(plain, bricks, values, numPolys);
+
+  // another brick size, and bricks larger than the image
+  bricks->SetBrickSize(8);
+  rval += CompareContours(plain, bricks, values, numPolys);
+  bricks->SetBrickSize(100);
+  rval += CompareContours(plain, bricks, values, numPolys);
+
+  // new scalars must not be skipped by the index built for the old ones
+  bricks->SetBrickSize(4);
+  rval += CompareContours(plain, bricks, values, numPolys);
+  for(vtkIdType i=0;i<scalars->GetNumberOfTuples();i+=7)
+    {
+    scalars->SetComponent(i, 1, 45.0 - scalars->GetComponent(i, 1));
+    }
+  scalars->Modified();
+  values.push_back(44.5);
+  rval += CompareContours(plain, bricks, values, numPolys);
+
+  // and neither must another component
+  plain->SetArrayComponent(0);
+  bricks->SetArrayComponent(0);
+  rval += CompareContours(plain, bricks, values, numPolys);
+
+  cout << numPolys << " triangles compared." << endl;
+  if(numPolys == 0)
+    {
+    cerr << "Empty contours" << endl;
+    rval++;
+    }
+  return rval;
+}
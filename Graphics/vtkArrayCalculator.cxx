@@ -23,14 +23,154 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkParallelFor.h"
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
 #include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <vtkstd/vector>
+
 vtkCxxRevisionMacro(vtkArrayCalculator, "$Revision$");
 vtkStandardNewMacro(vtkArrayCalculator);
 
+//----------------------------------------------------------------------------
+// Evaluates the function for a range of tuples.  vtkFunctionParser keeps
+// its variables and evaluation stack in the object, so each thread gets
+// its own copy of the filter's parser.  The values of the variables of a
+// tuple are gathered in a per-thread buffer and evaluated at once, as
+// setting them one by one would modify the parser for every tuple.
+class vtkArrayCalculatorFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkFunctionParser *Parser;
+  vtkstd::vector<vtkSmartPointer<vtkFunctionParser> > Parsers;
+  vtkstd::vector<double> Values; //scalar then vector values, per thread
+  int NumberOfScalarValues;
+  int NumberOfValues;
+  vtkDataSet *DataSetInput;
+  vtkGraph *GraphInput;
+  vtkDataArray *ResultArray;
+  int UseCoordinates;
+  vtkstd::vector<vtkDataArray*> ScalarArrays;
+  int *ScalarComponents;
+  vtkstd::vector<vtkDataArray*> VectorArrays;
+  int **VectorComponents;
+  int NumberOfCoordinateScalarArrays;
+  int *CoordinateScalarComponents;
+  int NumberOfCoordinateVectorArrays;
+  int **CoordinateVectorComponents;
+
+  virtual void Initialize(int numberOfThreads)
+    {
+    int numScalars = this->Parser->GetNumberOfScalarVariables();
+    int numVectors = this->Parser->GetNumberOfVectorVariables();
+    int i;
+    this->NumberOfScalarValues = numScalars;
+    this->NumberOfValues = numScalars + 3*numVectors;
+    this->Values.resize(numberOfThreads*this->NumberOfValues + 1);
+    this->Parsers.resize(numberOfThreads);
+    this->Parsers[0] = this->Parser;
+    for (int t = 0; t < numberOfThreads; t++)
+      {
+      // Start from the values of the first tuple, in case the parser has
+      // variables that are not set per tuple.
+      double *values = &this->Values[t*this->NumberOfValues];
+      for (i = 0; i < numScalars; i++)
+        {
+        values[i] = this->Parser->GetScalarVariableValue(i);
+        }
+      for (i = 0; i < numVectors; i++)
+        {
+        this->Parser->GetVectorVariableValue(i, values + numScalars + 3*i);
+        }
+      if (t == 0)
+        {
+        continue;
+        }
+
+      // Add the variables in the same order so that they have the same
+      // indices as in the filter's parser.
+      vtkFunctionParser *parser = vtkFunctionParser::New();
+      parser->SetFunction(this->Parser->GetFunction());
+      parser->SetReplaceInvalidValues(this->Parser->GetReplaceInvalidValues());
+      parser->SetReplacementValue(this->Parser->GetReplacementValue());
+      for (i = 0; i < numScalars; i++)
+        {
+        parser->SetScalarVariableValue(
+          this->Parser->GetScalarVariableName(i),
+          this->Parser->GetScalarVariableValue(i));
+        }
+      for (i = 0; i < numVectors; i++)
+        {
+        parser->SetVectorVariableValue(
+          this->Parser->GetVectorVariableName(i),
+          this->Parser->GetVectorVariableValue(i));
+        }
+      this->Parsers[t] = parser;
+      parser->Delete();
+      }
+    }
+
+  virtual void Execute(vtkIdType begin, vtkIdType end, int threadId)
+    {
+    static const double errorResult[3] = {VTK_PARSER_ERROR_RESULT,
+                                          VTK_PARSER_ERROR_RESULT,
+                                          VTK_PARSER_ERROR_RESULT};
+    vtkFunctionParser *parser = this->Parsers[threadId];
+    double *scalarValues = &this->Values[threadId*this->NumberOfValues];
+    double *vectorValues = scalarValues + this->NumberOfScalarValues;
+    double *result;
+    int numScalars = static_cast<int>(this->ScalarArrays.size());
+    int numVectors = static_cast<int>(this->VectorArrays.size());
+    int j, k;
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      for (j = 0; j < numScalars; j++)
+        {
+        scalarValues[j] = this->ScalarArrays[j]->GetComponent(
+          i, this->ScalarComponents[j]);
+        }
+      for (j = 0; j < numVectors; j++)
+        {
+        for (k = 0; k < 3; k++)
+          {
+          vectorValues[3*j+k] = this->VectorArrays[j]->GetComponent(
+            i, this->VectorComponents[j][k]);
+          }
+        }
+      if (this->UseCoordinates)
+        {
+        double pt[3];
+        if (this->DataSetInput)
+          {
+          this->DataSetInput->GetPoint(i, pt);
+          }
+        else
+          {
+          this->GraphInput->GetPoint(i, pt);
+          }
+        for (j = 0; j < this->NumberOfCoordinateScalarArrays; j++)
+          {
+          scalarValues[j+numScalars] = pt[this->CoordinateScalarComponents[j]];
+          }
+        for (j = 0; j < this->NumberOfCoordinateVectorArrays; j++)
+          {
+          for (k = 0; k < 3; k++)
+            {
+            vectorValues[3*(j+numVectors)+k] =
+              pt[this->CoordinateVectorComponents[j][k]];
+            }
+          }
+        }
+      result = parser->EvaluateValues(scalarValues, vectorValues);
+      this->ResultArray->SetTuple(i, result ? result : errorResult);
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
 vtkArrayCalculator::vtkArrayCalculator()
 {
   this->FunctionParser = vtkFunctionParser::New();
@@ -444,63 +584,44 @@ int vtkArrayCalculator::RequestData(
     resultArray->SetTuple(0, this->FunctionParser->GetVectorResult());
     }
   
-  for (i = 1; i < numTuples; i++)
-    {
-    for (j = 0; j < this->NumberOfScalarArrays; j++)
-      {
-      currentArray = inFD->GetArray(this->ScalarArrayNames[j]);
-      this->FunctionParser->
-        SetScalarVariableValue(
-          j, currentArray->GetComponent(i, this->SelectedScalarComponents[j]));
-      }
-    for (j = 0; j < this->NumberOfVectorArrays; j++)
-      {
-      currentArray = inFD->GetArray(this->VectorArrayNames[j]);
-      this->FunctionParser->
-        SetVectorVariableValue(
-          j, currentArray->GetComponent(i, this->SelectedVectorComponents[j][0]),
-          currentArray->GetComponent(
-            i, this->SelectedVectorComponents[j][1]),
-          currentArray->GetComponent(i, this->SelectedVectorComponents[j][2]));
-      }
-    if(attributeDataType == 0)
-      {
-      double* pt = 0;
-      if (dsInput)
-        {
-        pt = dsInput->GetPoint(i);
-        }
-      else
-        {
-        pt = graphInput->GetPoint(i);
-        }
-      for (j = 0; j < this->NumberOfCoordinateScalarArrays; j++)
-        {
-        this->FunctionParser->
-          SetScalarVariableValue(
-            j+this->NumberOfScalarArrays, pt[this->SelectedCoordinateScalarComponents[j]]);
-        }
-      for (j = 0; j < this->NumberOfCoordinateVectorArrays; j++)
-        {
-        this->FunctionParser->
-          SetVectorVariableValue(
-            j+this->NumberOfVectorArrays,
-            pt[this->SelectedCoordinateVectorComponents[j][0]],
-            pt[this->SelectedCoordinateVectorComponents[j][1]],
-            pt[this->SelectedCoordinateVectorComponents[j][2]]);
-        }
-      }
-    if (resultType == 0)
-      {
-      scalarResult[0] = this->FunctionParser->GetScalarResult();
-      resultArray->SetTuple(i, scalarResult);
-      }
-    else
-      {
-      resultArray->SetTuple(i, this->FunctionParser->GetVectorResult());
-      }
-    }
-  
+  // The first tuple was evaluated above by the filter's own parser, which
+  // also checked the function and the variables.  Do the rest in parallel.
+  vtkArrayCalculatorFunctor functor;
+  functor.Parser = this->FunctionParser;
+  functor.DataSetInput = dsInput;
+  functor.GraphInput = graphInput;
+  functor.ResultArray = resultArray;
+  functor.UseCoordinates = (attributeDataType == 0 &&
+    (this->NumberOfCoordinateScalarArrays > 0 ||
+     this->NumberOfCoordinateVectorArrays > 0));
+  for (j = 0; j < this->NumberOfScalarArrays; j++)
+    {
+    functor.ScalarArrays.push_back(inFD->GetArray(this->ScalarArrayNames[j]));
+    }
+  functor.ScalarComponents = this->SelectedScalarComponents;
+  for (j = 0; j < this->NumberOfVectorArrays; j++)
+    {
+    functor.VectorArrays.push_back(inFD->GetArray(this->VectorArrayNames[j]));
+    }
+  functor.VectorComponents = this->SelectedVectorComponents;
+  functor.NumberOfCoordinateScalarArrays =
+    this->NumberOfCoordinateScalarArrays;
+  functor.CoordinateScalarComponents =
+    this->SelectedCoordinateScalarComponents;
+  functor.NumberOfCoordinateVectorArrays =
+    this->NumberOfCoordinateVectorArrays;
+  functor.CoordinateVectorComponents =
+    this->SelectedCoordinateVectorComponents;
+
+  vtkSmartPointer<vtkParallelFor> parallelFor =
+    vtkSmartPointer<vtkParallelFor>::New();
+  if (resultArray->GetDataType() == VTK_BIT)
+    {
+    // Neighboring bits share a byte.
+    parallelFor->SetNumberOfThreads(1);
+    }
+  parallelFor->Execute(1, numTuples, &functor);
+
   if(resultPoints)
     {
     if(psInput)
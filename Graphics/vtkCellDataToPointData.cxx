@@ -20,11 +20,79 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkParallelFor.h"
 #include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+
+#include <vtkstd/vector>
 
 vtkCxxRevisionMacro(vtkCellDataToPointData, "$Revision$");
 vtkStandardNewMacro(vtkCellDataToPointData);
 
+#define VTK_MAX_CELLS_PER_POINT 4096
+
+//----------------------------------------------------------------------------
+// Averages the cell data around a range of points.
+class vtkCellDataToPointDataFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkCellDataToPointData *Filter;
+  vtkDataSet *Input;
+  vtkCellData *InPD;
+  vtkPointData *OutPD;
+  vtkIdType NumberOfPoints;
+  int Abort;
+  vtkstd::vector<vtkSmartPointer<vtkIdList> > CellIds;
+  vtkstd::vector<double> Weights;
+
+  virtual void Initialize(int numberOfThreads)
+    {
+    this->CellIds.resize(numberOfThreads);
+    for (int i=0; i < numberOfThreads; i++)
+      {
+      this->CellIds[i] = vtkSmartPointer<vtkIdList>::New();
+      this->CellIds[i]->Allocate(VTK_MAX_CELLS_PER_POINT);
+      }
+    this->Weights.resize(numberOfThreads*VTK_MAX_CELLS_PER_POINT);
+    }
+
+  virtual void Execute(vtkIdType begin, vtkIdType end, int threadId)
+    {
+    // Progress follows the first point of each chunk of thread 0.
+    if ( threadId == 0 )
+      {
+      this->Filter->UpdateProgress(
+        static_cast<double>(begin)/this->NumberOfPoints);
+      this->Abort = this->Filter->GetAbortExecute();
+      }
+    if ( this->Abort )
+      {
+      return;
+      }
+
+    vtkIdList *cellIds = this->CellIds[threadId];
+    double *weights = &this->Weights[threadId*VTK_MAX_CELLS_PER_POINT];
+    for (vtkIdType ptId=begin; ptId < end; ptId++)
+      {
+      this->Input->GetPointCells(ptId, cellIds);
+      vtkIdType numCells = cellIds->GetNumberOfIds();
+      if ( numCells > 0 && numCells < VTK_MAX_CELLS_PER_POINT )
+        {
+        double weight = 1.0 / numCells;
+        for (vtkIdType cellId=0; cellId < numCells; cellId++)
+          {
+          weights[cellId] = weight;
+          }
+        this->OutPD->InterpolatePoint(this->InPD, ptId, cellIds, weights);
+        }
+      else
+        {
+        this->OutPD->NullPoint(ptId);
+        }
+      }
+    }
+};
+
 //----------------------------------------------------------------------------
 // Instantiate object so that cell data is not passed to output.
 vtkCellDataToPointData::vtkCellDataToPointData()
@@ -32,8 +100,6 @@ vtkCellDataToPointData::vtkCellDataToPointData()
   this->PassCellData = 0;
 }
 
-#define VTK_MAX_CELLS_PER_POINT 4096
-
 //----------------------------------------------------------------------------
 int vtkCellDataToPointData::RequestData(
   vtkInformation*,
@@ -48,29 +114,20 @@ int vtkCellDataToPointData::RequestData(
   vtkDataSet *input = vtkDataSet::SafeDownCast(
     inInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType cellId, ptId;
-  vtkIdType numCells, numPts;
+  vtkIdType numPts;
   vtkCellData *inPD=input->GetCellData();
   vtkPointData *outPD=output->GetPointData();
-  vtkIdList *cellIds;
-  double weight;
-  double *weights;
 
   vtkDebugMacro(<<"Mapping cell data to point data");
 
   // First, copy the input to the output as a starting point
   output->CopyStructure( input );
 
-  cellIds = vtkIdList::New();
-  cellIds->Allocate(VTK_MAX_CELLS_PER_POINT);
-
   if ( (numPts=input->GetNumberOfPoints()) < 1 )
     {
     vtkDebugMacro(<<"No input point data!");
-    cellIds->Delete();
     return 1;
     }
-  weights = new double[VTK_MAX_CELLS_PER_POINT];
   
   // Pass the point data first. The fields and attributes
   // which also exist in the cell data of the input will
@@ -83,33 +140,27 @@ int vtkCellDataToPointData::RequestData(
   // It's weird, but it works.
   outPD->InterpolateAllocate(inPD,numPts);
 
-  int abort=0;
-  vtkIdType progressInterval=numPts/20 + 1;
-  for (ptId=0; ptId < numPts && !abort; ptId++)
+  vtkSmartPointer<vtkParallelFor> parallelFor =
+    vtkSmartPointer<vtkParallelFor>::New();
+  if ( !outPD->PrepareThreadedInterpolation(numPts) )
     {
-    if ( !(ptId % progressInterval) )
-      {
-      this->UpdateProgress(static_cast<double>(ptId)/numPts);
-      abort = GetAbortExecute();
-      }
-
-    input->GetPointCells(ptId, cellIds);
-    numCells = cellIds->GetNumberOfIds();
-    if ( numCells > 0 && numCells < VTK_MAX_CELLS_PER_POINT )
-      {
-      weight = 1.0 / numCells;
-      for (cellId=0; cellId < numCells; cellId++)
-        {
-        weights[cellId] = weight;
-        }
-      outPD->InterpolatePoint(inPD, ptId, cellIds, weights);
-      }
-    else
-      {
-      outPD->NullPoint(ptId);
-      }
+    parallelFor->SetNumberOfThreads(1);
     }
 
+  // GetPointCells builds the cell links on first use, do that here
+  // before the threads start.
+  vtkSmartPointer<vtkIdList> cellIds = vtkSmartPointer<vtkIdList>::New();
+  input->GetPointCells(0, cellIds);
+
+  vtkCellDataToPointDataFunctor functor;
+  functor.Filter = this;
+  functor.Input = input;
+  functor.InPD = inPD;
+  functor.OutPD = outPD;
+  functor.NumberOfPoints = numPts;
+  functor.Abort = 0;
+  parallelFor->Execute(0, numPts, &functor);
+
   if ( !this->PassCellData )
     {
     output->GetCellData()->CopyAllOff();
@@ -117,9 +168,6 @@ int vtkCellDataToPointData::RequestData(
     }
   output->GetCellData()->PassData(input->GetCellData());
 
-  cellIds->Delete();
-  delete [] weights;
-  
   return 1;
 }
 
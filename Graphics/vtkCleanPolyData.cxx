@@ -16,15 +16,23 @@
 
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkIdTypeArray.h"
 #include "vtkMergePoints.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkParallelFor.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkIncrementalPointLocator.h"
 
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+#include <math.h>
+#include <string.h>
+
 vtkCxxRevisionMacro(vtkCleanPolyData, "$Revision$");
 vtkStandardNewMacro(vtkCleanPolyData);
 
@@ -46,6 +54,8 @@ vtkCleanPolyData::vtkCleanPolyData()
   this->ConvertStripsToPolys = 1;
   this->Locator = NULL;
   this->PieceInvariant = 1;
+  this->MergeMode = VTK_CLEAN_MERGE_WITH_LOCATOR;
+  this->NumberOfThreads = 1;
 }
 
 //--------------------------------------------------------------------------
@@ -161,6 +171,11 @@ int vtkCleanPolyData::RequestData(
     vtkDebugMacro(<<"No data to Operate On!");
     return 1;
     }
+  if ( this->PointMerging &&
+       this->MergeMode != VTK_CLEAN_MERGE_WITH_LOCATOR )
+    {
+    return this->MergeWithoutLocator(input, output);
+    }
   vtkIdType *updatedPts = new vtkIdType[input->GetMaxCellSize()];
 
   vtkIdType numNewPts;
@@ -603,6 +618,609 @@ int vtkCleanPolyData::RequestData(
   return 1;
 }
 
+//--------------------------------------------------------------------------
+// Renumber the points of a cell with pointMap into newPts, removing
+// consecutive duplicates, and return the kind of cell it becomes as
+// RequestData() converts degenerate cells: 0 for a vertex, 1 for a line, 2
+// for a polygon, 3 for a strip, or -1 if it is dropped. type is the kind of
+// the input cell.
+static int vtkCleanPolyDataMapCell(int type, vtkIdType npts, vtkIdType *pts,
+                                   vtkIdType *pointMap, vtkIdType *newPts,
+                                   vtkIdType &numNewPts, int convertLines,
+                                   int convertPolys, int convertStrips)
+{
+  numNewPts = 0;
+  for (vtkIdType i=0; i < npts; i++)
+    {
+    vtkIdType ptId = pointMap[pts[i]];
+    if ( type == 0 || i == 0 || ptId != newPts[numNewPts-1] )
+      {
+      newPts[numNewPts++] = ptId;
+      }
+    }
+  if ( type == 0 )
+    {
+    return (numNewPts > 0 ? 0 : -1);
+    }
+  if ( type == 2 && numNewPts > 2 && newPts[0] == newPts[numNewPts-1] )
+    {
+    numNewPts--;
+    }
+  if ( type == 3 && (numNewPts > 3 || !convertStrips) )
+    {
+    return 3;
+    }
+  if ( type >= 2 && (numNewPts > 2 || !convertPolys) )
+    {
+    return 2;
+    }
+  if ( numNewPts > 1 || !convertLines )
+    {
+    return 1;
+    }
+  return (numNewPts == 1 ? 0 : -1);
+}
+
+//--------------------------------------------------------------------------
+// Hash the key of a point. Keys that compare equal hash equally.
+static inline vtkIdType vtkCleanPolyDataHash(const double key[3],
+                                             vtkIdType numBuckets)
+{
+  unsigned long hash = 0;
+  for (int i=0; i < 3; i++)
+    {
+    double k = (key[i] == 0.0 ? 0.0 : key[i]); // -0.0 is 0.0
+    unsigned int words[2];
+    memcpy(words, &k, sizeof(k));
+    hash = (hash ^ words[0])*16777619;
+    hash = (hash ^ words[1])*16777619;
+    }
+  hash ^= (hash >> 15);
+  return static_cast<vtkIdType>(hash % static_cast<unsigned long>(numBuckets));
+}
+
+//--------------------------------------------------------------------------
+// Computes the key of a range of points, its coordinates or the grid cell
+// it falls in, and the bucket it hashes to. Points with a NaN key are never
+// merged.
+class vtkCleanPolyDataKeyFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkCleanPolyData *Self;
+  vtkPoints *Points;
+  double Origin[3];
+  double Spacing; //of the grid, 0 when merging exactly
+  vtkIdType NumberOfBuckets;
+  double *Keys;
+  vtkIdType *Buckets; //-1 for the points that are never merged
+  vtkIdType *MergeMap;
+
+  void Execute(vtkIdType begin, vtkIdType end, int vtkNotUsed(threadId))
+    {
+    double x[3];
+    for (vtkIdType ptId=begin; ptId < end; ptId++)
+      {
+      double *key = this->Keys + 3*ptId;
+      this->Points->GetPoint(ptId, x);
+      this->Self->OperateOnPoint(x, key);
+      if ( this->Spacing > 0.0 )
+        {
+        for (int i=0; i < 3; i++)
+          {
+          key[i] = floor((key[i] - this->Origin[i]) / this->Spacing);
+          }
+        }
+      this->MergeMap[ptId] = ptId;
+      if ( key[0] != key[0] || key[1] != key[1] || key[2] != key[2] )
+        {
+        this->Buckets[ptId] = -1;
+        }
+      else
+        {
+        this->Buckets[ptId] = vtkCleanPolyDataHash(key, this->NumberOfBuckets);
+        }
+      }
+    }
+};
+
+//--------------------------------------------------------------------------
+// Counts the points of each bucket in ranges of points, then places them,
+// in order, at the positions the counts give.
+class vtkCleanPolyDataBucketFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfRanges;
+  vtkIdType NumberOfBuckets;
+  vtkIdType *Buckets;
+  vtkIdType *Counts; //per range and bucket, then the next position
+  vtkIdType *Sorted; //NULL while counting
+
+  void Execute(vtkIdType begin, vtkIdType end, int vtkNotUsed(threadId))
+    {
+    for (vtkIdType range=begin; range < end; range++)
+      {
+      vtkIdType *counts = this->Counts + range*this->NumberOfBuckets;
+      vtkIdType last = (range+1)*this->NumberOfPoints/this->NumberOfRanges;
+      for (vtkIdType ptId=range*this->NumberOfPoints/this->NumberOfRanges;
+           ptId < last; ptId++)
+        {
+        vtkIdType bucket = this->Buckets[ptId];
+        if ( bucket < 0 )
+          {
+          continue;
+          }
+        if ( this->Sorted )
+          {
+          this->Sorted[counts[bucket]++] = ptId;
+          }
+        else
+          {
+          counts[bucket]++;
+          }
+        }
+      }
+    }
+};
+
+//--------------------------------------------------------------------------
+// Orders point ids by key, then by id.
+class vtkCleanPolyDataKeyLess
+{
+public:
+  const double *Keys;
+  bool operator()(vtkIdType a, vtkIdType b) const
+    {
+    const double *ka = this->Keys + 3*a;
+    const double *kb = this->Keys + 3*b;
+    for (int i=0; i < 3; i++)
+      {
+      if ( ka[i] != kb[i] )
+        {
+        return ka[i] < kb[i];
+        }
+      }
+    return a < b;
+    }
+};
+
+//--------------------------------------------------------------------------
+// Sorts a range of buckets and merges the points with equal keys into the
+// first of them. Stops when the filter is aborted.
+class vtkCleanPolyDataMergeFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkCleanPolyData *Self;
+  double *Keys;
+  vtkIdType *Sorted;
+  vtkIdType *BucketStarts;
+  vtkIdType *MergeMap;
+  int Abort;
+
+  void Execute(vtkIdType begin, vtkIdType end, int threadId)
+    {
+    vtkCleanPolyDataKeyLess less;
+    less.Keys = this->Keys;
+    for (vtkIdType bucket=begin; bucket < end; bucket++)
+      {
+      // Thread 0 checks for an abort before each of its buckets.
+      if ( threadId == 0 )
+        {
+        this->Abort = this->Self->GetAbortExecute();
+        }
+      if ( this->Abort )
+        {
+        return;
+        }
+      vtkIdType *first = this->Sorted + this->BucketStarts[bucket];
+      vtkIdType *last = this->Sorted + this->BucketStarts[bucket+1];
+      vtkstd::sort(first, last, less);
+      for (vtkIdType *current=first; current < last; current++)
+        {
+        double *key = this->Keys + 3*(*current);
+        double *firstKey = this->Keys + 3*(*first);
+        if ( key[0] != firstKey[0] || key[1] != firstKey[1] ||
+             key[2] != firstKey[2] )
+          {
+          first = current;
+          }
+        this->MergeMap[*current] = *first;
+        }
+      }
+    }
+};
+
+//--------------------------------------------------------------------------
+// Visits a range of the input cells, numbered vertices first, then lines,
+// polygons and strips, to mark the merged points they use, to find the
+// kind and size of the cells they become, or to write these cells.
+class vtkCleanPolyDataCellFunctor : public vtkParallelForFunctor
+{
+public:
+  enum { MarkPoints, MapCells, WriteCells };
+  int Pass;
+  vtkIdType *Data[4];     //the connectivity of each kind of input cell
+  vtkIdType Start[5];     //the id of the first cell of each kind
+  vtkIdType *Locations;   //of the cells in the connectivity of their kind
+  vtkIdType *MergeMap;
+  unsigned char *Used;
+  vtkIdType *PointMap;
+  int Convert[3];         //lines, polygons and strips
+  int MaxCellSize;
+  signed char *Kinds;     //of the output cells
+  vtkIdType *Sizes;
+  vtkIdType *OutLocations;
+  vtkIdType *OutData[4];
+  vtkstd::vector<vtkstd::vector<vtkIdType> > Buffers;
+
+  void Initialize(int numberOfThreads)
+    {
+    this->Buffers.resize(numberOfThreads);
+    for (int i=0; i < numberOfThreads; i++)
+      {
+      this->Buffers[i].resize(this->MaxCellSize+1);
+      }
+    }
+
+  void Execute(vtkIdType begin, vtkIdType end, int threadId)
+    {
+    vtkIdType *buffer = &this->Buffers[threadId][0];
+    vtkIdType numNewPts;
+    int type = 0;
+    for (vtkIdType cellId=begin; cellId < end; cellId++)
+      {
+      while ( cellId >= this->Start[type+1] )
+        {
+        type++;
+        }
+      vtkIdType *cell = this->Data[type] + this->Locations[cellId];
+      vtkIdType npts = cell[0];
+      vtkIdType *pts = cell + 1;
+      if ( this->Pass == MarkPoints )
+        {
+        for (vtkIdType i=0; i < npts; i++)
+          {
+          this->Used[this->MergeMap[pts[i]]] = 1;
+          }
+        }
+      else if ( this->Pass == MapCells )
+        {
+        this->Kinds[cellId] = static_cast<signed char>(
+          vtkCleanPolyDataMapCell(type, npts, pts, this->PointMap, buffer,
+                                  numNewPts, this->Convert[0],
+                                  this->Convert[1], this->Convert[2]));
+        this->Sizes[cellId] = numNewPts;
+        }
+      else if ( this->Kinds[cellId] >= 0 )
+        {
+        vtkIdType *newCell = this->OutData[this->Kinds[cellId]] +
+          this->OutLocations[cellId];
+        vtkCleanPolyDataMapCell(type, npts, pts, this->PointMap, newCell+1,
+                                numNewPts, this->Convert[0],
+                                this->Convert[1], this->Convert[2]);
+        newCell[0] = numNewPts;
+        }
+      }
+    }
+};
+
+//--------------------------------------------------------------------------
+// Writes a range of the merged points.
+template <class T>
+class vtkCleanPolyDataPointFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkCleanPolyData *Self;
+  vtkPoints *Points;
+  vtkIdType *SourceIds;
+  T *NewPoints;
+
+  void Execute(vtkIdType begin, vtkIdType end, int vtkNotUsed(threadId))
+    {
+    double x[3], newx[3];
+    for (vtkIdType ptId=begin; ptId < end; ptId++)
+      {
+      this->Points->GetPoint(this->SourceIds[ptId], x);
+      this->Self->OperateOnPoint(x, newx);
+      T *newPt = this->NewPoints + 3*ptId;
+      newPt[0] = static_cast<T>(newx[0]);
+      newPt[1] = static_cast<T>(newx[1]);
+      newPt[2] = static_cast<T>(newx[2]);
+      }
+    }
+};
+
+//--------------------------------------------------------------------------
+int vtkCleanPolyData::MergeWithoutLocator(vtkPolyData *input,
+                                          vtkPolyData *output)
+{
+  vtkPoints *inPts = input->GetPoints();
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkIdType ptId, cellId;
+  int type, i;
+
+  vtkParallelFor *parallelFor = vtkParallelFor::New();
+  parallelFor->SetNumberOfThreads(this->NumberOfThreads);
+
+  // Key the points by their coordinates, or by the grid cell they fall in,
+  // and hash the keys into buckets of a few hundred points.
+  //
+  vtkCleanPolyDataKeyFunctor keyFunctor;
+  keyFunctor.Self = this;
+  keyFunctor.Points = inPts;
+  keyFunctor.Spacing = 0.0;
+  if ( this->MergeMode == VTK_CLEAN_MERGE_ON_GRID )
+    {
+    keyFunctor.Spacing = ( this->ToleranceIsAbsolute ? this->AbsoluteTolerance :
+                           this->Tolerance*input->GetLength() );
+    }
+  double originalbounds[6], mappedbounds[6];
+  input->GetBounds(originalbounds);
+  this->OperateOnBounds(originalbounds,mappedbounds);
+  for (i=0; i < 3; i++)
+    {
+    keyFunctor.Origin[i] = mappedbounds[2*i];
+    }
+  vtkIdType numBuckets = numPts/256 + 1;
+  keyFunctor.NumberOfBuckets = numBuckets;
+  double *keys = new double[3*numPts];
+  vtkIdType *buckets = new vtkIdType[numPts];
+  vtkIdType *mergeMap = new vtkIdType[numPts];
+  keyFunctor.Keys = keys;
+  keyFunctor.Buckets = buckets;
+  keyFunctor.MergeMap = mergeMap;
+  parallelFor->Execute(0, numPts, &keyFunctor);
+  this->UpdateProgress(0.2);
+
+  // Sort the points by bucket: count the points of each bucket in ranges of
+  // points, then place the points of each range after those of the
+  // previous ranges.
+  //
+  vtkCleanPolyDataBucketFunctor bucketFunctor;
+  bucketFunctor.NumberOfPoints = numPts;
+  bucketFunctor.NumberOfRanges = 4*this->NumberOfThreads;
+  if ( bucketFunctor.NumberOfRanges > numPts )
+    {
+    bucketFunctor.NumberOfRanges = numPts;
+    }
+  bucketFunctor.NumberOfBuckets = numBuckets;
+  bucketFunctor.Buckets = buckets;
+  vtkstd::vector<vtkIdType> counts(bucketFunctor.NumberOfRanges*numBuckets, 0);
+  bucketFunctor.Counts = &counts[0];
+  bucketFunctor.Sorted = NULL;
+  parallelFor->SetGrainSize(1);
+  parallelFor->Execute(0, bucketFunctor.NumberOfRanges, &bucketFunctor);
+
+  vtkstd::vector<vtkIdType> bucketStarts(numBuckets+1);
+  vtkIdType numSorted = 0;
+  for (vtkIdType bucket=0; bucket < numBuckets; bucket++)
+    {
+    bucketStarts[bucket] = numSorted;
+    for (vtkIdType range=0; range < bucketFunctor.NumberOfRanges; range++)
+      {
+      vtkIdType count = counts[range*numBuckets + bucket];
+      counts[range*numBuckets + bucket] = numSorted;
+      numSorted += count;
+      }
+    }
+  bucketStarts[numBuckets] = numSorted;
+  vtkIdType *sorted = new vtkIdType[numSorted+1];
+  bucketFunctor.Sorted = sorted;
+  parallelFor->Execute(0, bucketFunctor.NumberOfRanges, &bucketFunctor);
+  parallelFor->SetGrainSize(0);
+  delete [] buckets;
+
+  // Merge the points with equal keys into the first of them
+  //
+  vtkCleanPolyDataMergeFunctor mergeFunctor;
+  mergeFunctor.Self = this;
+  mergeFunctor.Keys = keys;
+  mergeFunctor.Sorted = sorted;
+  mergeFunctor.BucketStarts = &bucketStarts[0];
+  mergeFunctor.MergeMap = mergeMap;
+  mergeFunctor.Abort = 0;
+  parallelFor->Execute(0, numBuckets, &mergeFunctor);
+  delete [] sorted;
+  delete [] keys;
+  if ( mergeFunctor.Abort )
+    {
+    // Like the locator path, produce no cells when aborted.
+    delete [] mergeMap;
+    parallelFor->Delete();
+    return 1;
+    }
+  this->UpdateProgress(0.5);
+
+  // Locate the input cells, vertices first, then lines, polygons and
+  // strips, as RequestData() numbers them.
+  //
+  vtkCellArray *inCells[4];
+  inCells[0] = input->GetVerts();
+  inCells[1] = input->GetLines();
+  inCells[2] = input->GetPolys();
+  inCells[3] = input->GetStrips();
+  vtkCleanPolyDataCellFunctor cellFunctor;
+  vtkIdType *locations = new vtkIdType[numCells+1];
+  cellFunctor.Start[0] = 0;
+  for (type=0; type < 4; type++)
+    {
+    vtkIdType numTypeCells = inCells[type]->GetNumberOfCells();
+    cellFunctor.Start[type+1] = cellFunctor.Start[type] + numTypeCells;
+    cellFunctor.Data[type] = inCells[type]->GetPointer();
+    vtkIdType loc = 0;
+    for (cellId=cellFunctor.Start[type]; cellId < cellFunctor.Start[type+1];
+         cellId++)
+      {
+      locations[cellId] = loc;
+      loc += cellFunctor.Data[type][loc] + 1;
+      }
+    }
+  cellFunctor.Locations = locations;
+  cellFunctor.MergeMap = mergeMap;
+  cellFunctor.MaxCellSize = input->GetMaxCellSize();
+  cellFunctor.Convert[0] = this->ConvertLinesToPoints;
+  cellFunctor.Convert[1] = this->ConvertPolysToLines;
+  cellFunctor.Convert[2] = this->ConvertStripsToPolys;
+
+  // Number the merged points used by the cells in the order of the input
+  // points. A point is merged into a point of smaller id.
+  //
+  unsigned char *used = new unsigned char[numPts];
+  memset(used, 0, numPts);
+  cellFunctor.Used = used;
+  cellFunctor.Pass = vtkCleanPolyDataCellFunctor::MarkPoints;
+  parallelFor->Execute(0, numCells, &cellFunctor);
+
+  vtkIdType *pointMap = new vtkIdType[numPts];
+  vtkstd::vector<vtkIdType> sourceIds;
+  for (ptId=0; ptId < numPts; ptId++)
+    {
+    if ( mergeMap[ptId] != ptId )
+      {
+      pointMap[ptId] = pointMap[mergeMap[ptId]];
+      }
+    else if ( used[ptId] )
+      {
+      pointMap[ptId] = static_cast<vtkIdType>(sourceIds.size());
+      sourceIds.push_back(ptId);
+      }
+    else
+      {
+      pointMap[ptId] = -1;
+      }
+    }
+  delete [] used;
+  delete [] mergeMap;
+  vtkIdType numNewPts = static_cast<vtkIdType>(sourceIds.size());
+
+  vtkPoints *newPts = inPts->NewInstance();
+  newPts->SetDataType(inPts->GetDataType());
+  newPts->SetNumberOfPoints(numNewPts);
+  if ( numNewPts > 0 )
+    {
+    switch (newPts->GetDataType())
+      {
+      vtkTemplateMacro(
+        vtkCleanPolyDataPointFunctor<VTK_TT> pointFunctor;
+        pointFunctor.Self = this;
+        pointFunctor.Points = inPts;
+        pointFunctor.SourceIds = &sourceIds[0];
+        pointFunctor.NewPoints = static_cast<VTK_TT *>(newPts->GetVoidPointer(0));
+        parallelFor->Execute(0, numNewPts, &pointFunctor));
+      }
+    }
+  vtkPointData *inputPD = input->GetPointData();
+  vtkPointData *outputPD = output->GetPointData();
+  outputPD->CopyAllocate(inputPD, numNewPts);
+  for (ptId=0; ptId < numNewPts; ptId++)
+    {
+    outputPD->CopyData(inputPD, sourceIds[ptId], ptId);
+    }
+  vtkDebugMacro(<<"Removed " << numPts - numNewPts << " points");
+  this->UpdateProgress(0.7);
+
+  // Find the kind and size of the output cells, lay them out in the order
+  // of the input cells and write them.
+  //
+  signed char *kinds = new signed char[numCells+1];
+  vtkIdType *sizes = new vtkIdType[numCells+1];
+  cellFunctor.PointMap = pointMap;
+  cellFunctor.Kinds = kinds;
+  cellFunctor.Sizes = sizes;
+  cellFunctor.Pass = vtkCleanPolyDataCellFunctor::MapCells;
+  parallelFor->Execute(0, numCells, &cellFunctor);
+
+  vtkIdType numNewCells[4] = {0, 0, 0, 0};
+  vtkIdType newSize[4] = {0, 0, 0, 0};
+  vtkIdType *outLocations = sizes; //reused in place
+  for (cellId=0; cellId < numCells; cellId++)
+    {
+    if ( kinds[cellId] >= 0 )
+      {
+      type = kinds[cellId];
+      vtkIdType size = sizes[cellId];
+      outLocations[cellId] = newSize[type];
+      newSize[type] += size + 1;
+      numNewCells[type]++;
+      }
+    }
+
+  vtkIdTypeArray *newData[4];
+  for (type=0; type < 4; type++)
+    {
+    newData[type] = vtkIdTypeArray::New();
+    newData[type]->SetNumberOfValues(newSize[type]);
+    cellFunctor.OutData[type] = newData[type]->GetPointer(0);
+    }
+  cellFunctor.OutLocations = outLocations;
+  cellFunctor.Pass = vtkCleanPolyDataCellFunctor::WriteCells;
+  parallelFor->Execute(0, numCells, &cellFunctor);
+  parallelFor->Delete();
+  delete [] pointMap;
+  delete [] locations;
+  delete [] sizes;
+
+  // The cell data follows the order of the output cells, vertices first
+  //
+  vtkCellData *inputCD = input->GetCellData();
+  vtkCellData *outputCD = output->GetCellData();
+  vtkIdType newCellIds[4];
+  newCellIds[0] = 0;
+  for (type=1; type < 4; type++)
+    {
+    newCellIds[type] = newCellIds[type-1] + numNewCells[type-1];
+    }
+  outputCD->CopyAllocate(inputCD, newCellIds[3] + numNewCells[3]);
+  for (cellId=0; cellId < numCells; cellId++)
+    {
+    if ( kinds[cellId] >= 0 )
+      {
+      outputCD->CopyData(inputCD, cellId, newCellIds[kinds[cellId]]++);
+      }
+    }
+  delete [] kinds;
+
+  output->SetPoints(newPts);
+  newPts->Delete();
+  for (type=0; type < 4; type++)
+    {
+    if ( numNewCells[type] > 0 )
+      {
+      vtkCellArray *newCells = vtkCellArray::New();
+      newCells->SetCells(numNewCells[type], newData[type]);
+      switch (type)
+        {
+        case 0: output->SetVerts(newCells); break;
+        case 1: output->SetLines(newCells); break;
+        case 2: output->SetPolys(newCells); break;
+        default: output->SetStrips(newCells); break;
+        }
+      newCells->Delete();
+      }
+    newData[type]->Delete();
+    }
+
+  return 1;
+}
+
+//--------------------------------------------------------------------------
+const char *vtkCleanPolyData::GetMergeModeAsString()
+{
+  if ( this->MergeMode == VTK_CLEAN_MERGE_EXACT )
+    {
+    return "Exact";
+    }
+  else if ( this->MergeMode == VTK_CLEAN_MERGE_ON_GRID )
+    {
+    return "Grid";
+    }
+  else
+    {
+    return "Locator";
+    }
+}
+
 //--------------------------------------------------------------------------
 // Method manages creation of locators. It takes into account the potential
 // change of tolerance (zero to non-zero).
@@ -682,6 +1300,8 @@ void vtkCleanPolyData::PrintSelf(ostream& os, vtkIndent indent)
     }
   os << indent << "PieceInvariant: "
      << (this->PieceInvariant ? "On\n" : "Off\n");
+  os << indent << "Merge Mode: " << this->GetMergeModeAsString() << "\n";
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
 }
 
 //--------------------------------------------------------------------------
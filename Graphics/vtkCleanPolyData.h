@@ -43,6 +43,15 @@
 // Note that merging of points can be disabled. In this case, a point locator
 // will not be used, and points that are not used by any cells will be
 // eliminated, but never merged.
+//
+// The locator inserts the points one at a time. For large inputs, MergeMode
+// can instead merge the points on several threads (see NumberOfThreads),
+// either when their coordinates are equal (SetMergeModeToExact()) or when
+// they fall in the same cell of a grid whose cells have the tolerance as
+// size (SetMergeModeToGrid()). The points are hashed by their coordinates
+// or grid cell and sorted within each hash bucket, and the cells are then
+// renumbered in parallel. The merged points are numbered in the order of
+// the input points instead of the order in which the cells use them.
 
 // .SECTION Caveats
 // Merging points can alter topology, including introducing non-manifold
@@ -61,6 +70,10 @@
 
 class vtkIncrementalPointLocator;
 
+#define VTK_CLEAN_MERGE_WITH_LOCATOR 0
+#define VTK_CLEAN_MERGE_EXACT 1
+#define VTK_CLEAN_MERGE_ON_GRID 2
+
 class VTK_GRAPHICS_EXPORT vtkCleanPolyData : public vtkPolyDataAlgorithm
 {
 public:
@@ -113,6 +126,34 @@ public:
   vtkGetMacro(PointMerging,int);
   vtkBooleanMacro(PointMerging,int);
 
+  // Description:
+  // Set/Get how points are merged. With a locator, the default, points
+  // within the tolerance of a point already inserted are merged with it.
+  // Exact merging only merges points whose coordinates are equal and
+  // ignores the tolerance. Grid merging merges the points that fall in the
+  // same cell of a grid aligned with the bounds of the points, whose cells
+  // have the tolerance as size, so that a point is moved by at most the
+  // diagonal of a grid cell; points closer than the tolerance but in
+  // neighboring grid cells are not merged. Grid merging with a tolerance of
+  // zero is exact merging. The locator is only used by the first mode.
+  vtkSetClampMacro(MergeMode,int,VTK_CLEAN_MERGE_WITH_LOCATOR,
+                   VTK_CLEAN_MERGE_ON_GRID);
+  vtkGetMacro(MergeMode,int);
+  void SetMergeModeToLocator()
+    {this->SetMergeMode(VTK_CLEAN_MERGE_WITH_LOCATOR);};
+  void SetMergeModeToExact()
+    {this->SetMergeMode(VTK_CLEAN_MERGE_EXACT);};
+  void SetMergeModeToGrid()
+    {this->SetMergeMode(VTK_CLEAN_MERGE_ON_GRID);};
+  const char *GetMergeModeAsString();
+
+  // Description:
+  // Set/Get the number of threads used by the exact and grid merge modes.
+  // OperateOnPoint() is then called concurrently, so subclasses overriding
+  // it must keep it free of side effects. The default is one thread.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
   // Description:
   // Set/Get a spatial locator for speeding the search process. By
   // default an instance of vtkMergePoints is used.
@@ -157,6 +198,10 @@ protected:
   virtual int RequestInformation(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
   virtual int RequestUpdateExtent(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
 
+  // Merge the points by hashing and sorting them instead of with the
+  // locator, as the exact and grid merge modes do.
+  int MergeWithoutLocator(vtkPolyData *input, vtkPolyData *output);
+
   int   PointMerging;
   double Tolerance;
   double AbsoluteTolerance;
@@ -165,6 +210,8 @@ protected:
   int ConvertStripsToPolys;
   int ToleranceIsAbsolute;
   vtkIncrementalPointLocator *Locator;
+  int MergeMode;
+  int NumberOfThreads;
 
   int PieceInvariant;
 private:
@@ -26,6 +26,7 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkIntArray.h"
+#include "vtkMergeEdgePoints.h"
 #include "vtkMergePoints.h"
 #include "vtkObjectFactory.h"
 #include "vtkPlane.h"
@@ -57,6 +58,7 @@ vtkClipDataSet::vtkClipDataSet(vtkImplicitFunction *cf)
 
   this->GenerateClippedOutput = 0;
   this->MergeTolerance = 0.01;
+  this->MergePointsByEdge = 0;
 
   this->SetNumberOfOutputPorts(2);
   vtkUnstructuredGrid *output2 = vtkUnstructuredGrid::New();
@@ -279,12 +281,25 @@ int vtkClipDataSet::RequestData(
   newPoints = vtkPoints::New();
   newPoints->Allocate(numPts,numPts/2);
   
-  // locator used to merge potentially duplicate points
-  if ( this->Locator == NULL )
+  // locator used to merge potentially duplicate points. When merging by
+  // edge the cells get no output point data; the points are interpolated
+  // afterwards, one array at a time.
+  vtkIncrementalPointLocator *locator;
+  vtkMergeEdgePoints *edgeLocator = NULL;
+  if ( this->MergePointsByEdge && vtkMergeEdgePoints::CanMergeDataSet(input) )
+    {
+    edgeLocator = vtkMergeEdgePoints::New();
+    locator = edgeLocator;
+    }
+  else
     {
-    this->CreateDefaultLocator();
+    if ( this->Locator == NULL )
+      {
+      this->CreateDefaultLocator();
+      }
+    locator = this->Locator;
     }
-  this->Locator->InitPointInsertion (newPoints, input->GetBounds());
+  locator->InitPointInsertion (newPoints, input->GetBounds());
 
   // Determine whether we're clipping with input scalars or a clip function
   // and do necessary setup.
@@ -328,6 +343,10 @@ int vtkClipDataSet::RequestData(
         }
       cellScalars->Delete();
       newPoints->Delete();
+      if ( edgeLocator )
+        {
+        edgeLocator->Delete();
+        }
       // When processing composite datasets with partial arrays, this warning is
       // not applicable, hence disabling it.
       // vtkErrorMacro(<<"Cannot clip without clip function or input scalars");
@@ -353,6 +372,7 @@ int vtkClipDataSet::RequestData(
   tempDSA->InterpolateAllocate(inPD, 1, 2);
   outPD->InterpolateAllocate(inPD,estimatedSize,estimatedSize/2);
   tempDSA->Delete();
+  vtkPointData *cellOutPD = (edgeLocator ? NULL : outPD);
   outCD[0] = output->GetCellData();
   outCD[0]->CopyAllocate(inCD,estimatedSize,estimatedSize/2);
   if ( this->GenerateClippedOutput )
@@ -395,15 +415,15 @@ int vtkClipDataSet::RequestData(
       }
 
     // perform the clipping
-    cell->Clip(value, cellScalars, this->Locator, conn[0],
-               inPD, outPD, inCD, cellId, outCD[0], this->InsideOut);
+    cell->Clip(value, cellScalars, locator, conn[0],
+               inPD, cellOutPD, inCD, cellId, outCD[0], this->InsideOut);
     numNew[0] = conn[0]->GetNumberOfCells() - num[0];
     num[0] = conn[0]->GetNumberOfCells();
  
     if ( this->GenerateClippedOutput )
       {
-      cell->Clip(value, cellScalars, this->Locator, conn[1],
-                 inPD, outPD, inCD, cellId, outCD[1], !this->InsideOut);
+      cell->Clip(value, cellScalars, locator, conn[1],
+                 inPD, cellOutPD, inCD, cellId, outCD[1], !this->InsideOut);
       numNew[1] = conn[1]->GetNumberOfCells() - num[1];
       num[1] = conn[1]->GetNumberOfCells();
       }
@@ -444,6 +464,11 @@ int vtkClipDataSet::RequestData(
   cell->Delete();
   cellScalars->Delete();
 
+  if ( edgeLocator )
+    {
+    edgeLocator->InterpolatePointData(inPD, outPD);
+    }
+
   if ( this->ClipFunction ) 
     {
     clipScalars->Delete();
@@ -466,7 +491,11 @@ int vtkClipDataSet::RequestData(
     }
   
   newPoints->Delete();
-  this->Locator->Initialize();//release any extra memory
+  locator->Initialize();//release any extra memory
+  if ( edgeLocator )
+    {
+    edgeLocator->Delete();
+    }
   output->Squeeze();
 
   return 1;
@@ -673,6 +702,9 @@ void vtkClipDataSet::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "UseValueAsOffset: " 
      << (this->UseValueAsOffset ? "On\n" : "Off\n");
+
+  os << indent << "Merge Points By Edge: " 
+     << (this->MergePointsByEdge ? "On\n" : "Off\n");
 }
 
 //-----------------------------------------------------------------------
@@ -142,6 +142,19 @@ public:
   void SetLocator(vtkIncrementalPointLocator *locator);
   vtkGetObjectMacro(Locator,vtkIncrementalPointLocator);
 
+  // Description:
+  // If this flag is enabled, the cell points and the intersection points
+  // are merged by the input point or edge they lie on, with a
+  // vtkMergeEdgePoints, instead of by position with the locator. This is
+  // exact and needs no search, and the point data is interpolated once all
+  // the points are known, one array at a time. It only applies to inputs
+  // made of linear cells other than vertices, and not to 3D images, which
+  // are clipped with vtkClipVolume; other inputs use the locator. Off by
+  // default.
+  vtkSetMacro(MergePointsByEdge,int);
+  vtkGetMacro(MergePointsByEdge,int);
+  vtkBooleanMacro(MergePointsByEdge,int);
+
   // Description:
   // Create default locator. Used to create one when none is specified. The 
   // locator is used to merge coincident points.
@@ -172,6 +185,7 @@ protected:
 
   int GenerateClippedOutput;
   double MergeTolerance;
+  int MergePointsByEdge;
 
   // Callback registered with the InternalProgressObserver.
   static void InternalProgressCallbackFunction(vtkObject*, unsigned long,
@@ -32,7 +32,7 @@
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearSynchronizedTemplates.h"
-#include "vtkSimpleScalarTree.h"
+#include "vtkSpanSpace.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkSynchronizedTemplates2D.h"
@@ -378,6 +378,17 @@ int vtkContourFilter::RequestData(
       {
       cgrid->SetLocator( this->Locator );
       }
+    // Hand our scalar tree over so that it outlives the contour grid filter
+    // and need not be built again for new contour values.
+    if ( this->UseScalarTree )
+      {
+      if ( this->ScalarTree == NULL )
+        {
+        this->ScalarTree = vtkSpanSpace::New();
+        }
+      cgrid->SetUseScalarTree(1);
+      cgrid->SetScalarTree(this->ScalarTree);
+      }
       
     for (i = 0; i < numContours; i++)
       {
@@ -511,9 +522,10 @@ int vtkContourFilter::RequestData(
       vtkCell *cell;
       if ( this->ScalarTree == NULL )
         {
-        this->ScalarTree = vtkSimpleScalarTree::New();
+        this->ScalarTree = vtkSpanSpace::New();
         }
       this->ScalarTree->SetDataSet(input);
+      this->ScalarTree->SetScalars(inScalars);
       // Note: This will have problems when input contains 2D and 3D cells.
       // CellData will get scrabled because of the implicit ordering of
       // verts, lines and polys in vtkPolyData.  The solution
@@ -114,7 +114,10 @@ public:
   vtkBooleanMacro(UseScalarTree,int);
 
   // Description:
-  // Enable the use of a scalar tree to accelerate contour extraction.
+  // Set/Get the scalar tree used to accelerate contour extraction of
+  // unstructured grids and polygonal data. A vtkSpanSpace is created when
+  // none is given. The tree is kept between executions, so contouring the
+  // same input at new values does not build it again.
   virtual void SetScalarTree(vtkScalarTree*);
   vtkGetObjectMacro(ScalarTree,vtkScalarTree);
 
@@ -17,24 +17,32 @@
 #include "vtkCell.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkCellTypes.h"
 #include "vtkContourValues.h"
 #include "vtkFloatArray.h"
+#include "vtkGarbageCollector.h"
+#include "vtkGenericCell.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkParallelFor.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
-#include "vtkSimpleScalarTree.h"
+#include "vtkSmartPointer.h"
+#include "vtkSpanSpace.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkCutter.h"
 #include "vtkMergePoints.h"
+#include "vtkMergeEdgePoints.h"
 #include "vtkPointLocator.h"
 #include "vtkIncrementalPointLocator.h"
 
 #include <math.h>
+#include <vtkstd/vector>
 
 vtkCxxRevisionMacro(vtkContourGrid, "$Revision$");
 vtkStandardNewMacro(vtkContourGrid);
+vtkCxxSetObjectMacro(vtkContourGrid,ScalarTree,vtkScalarTree);
 
 // Construct object with initial range (0,1) and single contour value
 // of 0.0.
@@ -51,6 +59,8 @@ vtkContourGrid::vtkContourGrid()
   this->UseScalarTree = 0;
   this->ScalarTree = NULL;
 
+  this->NumberOfThreads = 1;
+
   // by default process active point scalars
   this->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,
                                vtkDataSetAttributes::SCALARS);
@@ -269,9 +279,10 @@ void vtkContourGridExecute(vtkContourGrid *self, vtkDataSet *input,
     //
     if ( scalarTree == NULL )
       {
-      scalarTree = vtkSimpleScalarTree::New();
+      scalarTree = vtkSpanSpace::New();
       }
     scalarTree->SetDataSet(input);
+    scalarTree->SetScalars(inScalars);
     //
     // Loop over all contour values.  Then for each contour value, 
     // loop over all cells.
@@ -319,6 +330,368 @@ void vtkContourGridExecute(vtkContourGrid *self, vtkDataSet *input,
   output->Squeeze();
 }
 
+//----------------------------------------------------------------------------
+// The output of one range of cells contoured by the parallel path, with the
+// locator that merged its points by input edge.
+class vtkContourGridPiece
+{
+public:
+  vtkIdType Begin;
+  vtkIdType End;
+  vtkSmartPointer<vtkPoints> Points;
+  vtkSmartPointer<vtkCellArray> Verts;
+  vtkSmartPointer<vtkCellArray> Lines;
+  vtkSmartPointer<vtkCellArray> Polys;
+  vtkSmartPointer<vtkPointData> PointData;
+  vtkSmartPointer<vtkCellData> CellData;
+  vtkSmartPointer<vtkMergeEdgePoints> Locator;
+
+  vtkContourGridPiece(vtkUnstructuredGrid *input, int computeScalars,
+                      vtkIdType begin, vtkIdType end, vtkIdType estimatedSize)
+    {
+    this->Begin = begin;
+    this->End = end;
+    this->Points = vtkSmartPointer<vtkPoints>::New();
+    this->Points->Allocate(estimatedSize,estimatedSize);
+    this->Verts = vtkSmartPointer<vtkCellArray>::New();
+    this->Verts->Allocate(estimatedSize,estimatedSize);
+    this->Lines = vtkSmartPointer<vtkCellArray>::New();
+    this->Lines->Allocate(estimatedSize,estimatedSize);
+    this->Polys = vtkSmartPointer<vtkCellArray>::New();
+    this->Polys->Allocate(estimatedSize,estimatedSize);
+    this->PointData = vtkSmartPointer<vtkPointData>::New();
+    if (!computeScalars)
+      {
+      this->PointData->CopyScalarsOff();
+      }
+    this->PointData->InterpolateAllocate(input->GetPointData(),
+                                         estimatedSize,estimatedSize);
+    this->CellData = vtkSmartPointer<vtkCellData>::New();
+    this->CellData->CopyAllocate(input->GetCellData(),
+                                 estimatedSize,estimatedSize);
+    this->Locator = vtkSmartPointer<vtkMergeEdgePoints>::New();
+    this->Locator->InitPointInsertion(this->Points, input->GetBounds(),
+                                      estimatedSize);
+    }
+};
+
+// Contour the cells of a piece, in the order of the serial path: lines,
+// then 2D cells, then 3D cells.
+template <class T>
+void vtkContourGridContourPiece(vtkContourGrid *self,
+                                vtkUnstructuredGrid *input,
+                                vtkDataArray *inScalars, T *scalarArrayPtr,
+                                int numContours, double *values,
+                                unsigned char *cellTypeDimensions,
+                                vtkGenericCell *cell,
+                                vtkDataArray *cellScalars,
+                                vtkContourGridPiece *piece,
+                                int reportProgress)
+{
+  vtkIdType cellId, i, numPoints, cellArrayIt;
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkIdType *cellArrayPtr = input->GetCells()->GetPointer();
+  vtkPointData *inPd = input->GetPointData();
+  vtkCellData *inCd = input->GetCellData();
+  double range[2];
+  T tempScalar;
+  int cellType, needCell;
+
+  for (int dimensionality = 1; dimensionality <= 3; ++dimensionality)
+    {
+    cellArrayIt = input->GetCellLocationsArray()->GetValue(piece->Begin);
+    for (cellId=piece->Begin; cellId < piece->End; cellId++)
+      {
+      numPoints = cellArrayPtr[cellArrayIt];
+      cellType = input->GetCellType(cellId);
+      if (cellType >= VTK_NUMBER_OF_CELL_TYPES ||
+          cellTypeDimensions[cellType] != dimensionality)
+        {
+        cellArrayIt += 1+numPoints;
+        continue;
+        }
+      cellArrayIt++;
+
+      //find min and max values in scalar data
+      range[0] = range[1] = scalarArrayPtr[cellArrayPtr[cellArrayIt++]];
+      for (i = 1; i < numPoints; i++)
+        {
+        tempScalar = scalarArrayPtr[cellArrayPtr[cellArrayIt++]];
+        if (tempScalar <= range[0])
+          {
+          range[0] = tempScalar;
+          }
+        if (tempScalar >= range[1])
+          {
+          range[1] = tempScalar;
+          }
+        }
+
+      if ( !(cellId % 5000) )
+        {
+        if (reportProgress && dimensionality == 3)
+          {
+          self->UpdateProgress (static_cast<double>(cellId)/numCells);
+          }
+        if (self->GetAbortExecute())
+          {
+          return;
+          }
+        }
+
+      for (needCell = 0, i = 0; i < numContours && !needCell; i++)
+        {
+        needCell = (values[i] >= range[0]) && (values[i] <= range[1]);
+        }
+      if (needCell)
+        {
+        input->GetCell(cellId, cell);
+        inScalars->GetTuples(cell->GetPointIds(), cellScalars);
+        for (i=0; i < numContours; i++)
+          {
+          if ((values[i] >= range[0]) && (values[i] <= range[1]))
+            {
+            cell->Contour(values[i], cellScalars, piece->Locator,
+                          piece->Verts, piece->Lines, piece->Polys,
+                          inPd, piece->PointData, inCd, cellId,
+                          piece->CellData);
+            }
+          }
+        }
+      }
+    }
+}
+
+// Contours the pieces on several threads, each thread with its own cell
+// and cell scalars.
+class vtkContourGridFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkContourGrid *Filter;
+  vtkUnstructuredGrid *Input;
+  vtkDataArray *InScalars;
+  int NumberOfContours;
+  double *Values;
+  unsigned char CellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+  vtkstd::vector<vtkContourGridPiece *> Pieces;
+
+  vtkstd::vector<vtkSmartPointer<vtkGenericCell> > Cells;
+  vtkstd::vector<vtkSmartPointer<vtkDataArray> > CellScalars;
+
+  void Initialize(int numberOfThreads)
+    {
+    this->Cells.resize(numberOfThreads);
+    this->CellScalars.resize(numberOfThreads);
+    for (int i=0; i<numberOfThreads; i++)
+      {
+      this->Cells[i] = vtkSmartPointer<vtkGenericCell>::New();
+      this->CellScalars[i].TakeReference(this->InScalars->NewInstance());
+      this->CellScalars[i]->SetNumberOfComponents(
+        this->InScalars->GetNumberOfComponents());
+      this->CellScalars[i]->Allocate(
+        VTK_CELL_SIZE*this->InScalars->GetNumberOfComponents());
+      }
+    }
+
+  void Execute(vtkIdType begin, vtkIdType end, int threadId)
+    {
+    void *scalarArrayPtr = this->InScalars->GetVoidPointer(0);
+    for (vtkIdType i=begin; i<end; i++)
+      {
+      switch (this->InScalars->GetDataType())
+        {
+        vtkTemplateMacro(
+          vtkContourGridContourPiece(
+            this->Filter, this->Input, this->InScalars,
+            static_cast<VTK_TT *>(scalarArrayPtr), this->NumberOfContours,
+            this->Values, this->CellTypeDimensions,
+            this->Cells[threadId], this->CellScalars[threadId],
+            this->Pieces[i], threadId == 0));
+        }
+      }
+    }
+};
+
+// Append the cells of a piece to the output, renumbering their points and
+// copying their cell data.
+static void vtkContourGridAppendCells(vtkCellArray *from, vtkCellArray *to,
+                                      vtkIdType fromCellId,
+                                      vtkCellData *fromCd, vtkCellData *toCd,
+                                      vtkIdType toCellId,
+                                      const vtkIdType *pointMap)
+{
+  vtkIdType npts, *pts, newPts[VTK_CELL_SIZE];
+  int numArrays = toCd->GetNumberOfArrays();
+  for (from->InitTraversal(); from->GetNextCell(npts, pts);
+       fromCellId++, toCellId++)
+    {
+    for (vtkIdType j=0; j<npts; j++)
+      {
+      newPts[j] = pointMap[pts[j]];
+      }
+    to->InsertNextCell(npts, newPts);
+    for (int k=0; k<numArrays; k++)
+      {
+      toCd->GetAbstractArray(k)->InsertTuple(
+        toCellId, fromCellId, fromCd->GetAbstractArray(k));
+      }
+    }
+}
+
+// The parallel path: contour ranges of cells into pieces on several
+// threads, then merge the pieces, in order, by input edge.
+static void vtkContourGridThreadedExecute(vtkContourGrid *self,
+                                          vtkUnstructuredGrid *input,
+                                          vtkPolyData *output,
+                                          vtkDataArray *inScalars,
+                                          int numContours, double *values,
+                                          int computeScalars,
+                                          vtkIdType numPieces,
+                                          vtkIdType estimatedSize)
+{
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkPointData *outPd = output->GetPointData();
+  vtkCellData *outCd = output->GetCellData();
+  vtkIdType i, j;
+  int k;
+
+  // Build the search structures of the input before the threads read it.
+  input->GetCellLocationsArray();
+  double *bounds = input->GetBounds();
+
+  vtkContourGridFunctor functor;
+  functor.Filter = self;
+  functor.Input = input;
+  functor.InScalars = inScalars;
+  functor.NumberOfContours = numContours;
+  functor.Values = values;
+  vtkCutter::GetCellTypeDimensions(functor.CellTypeDimensions);
+  vtkIdType pieceSize = estimatedSize / numPieces;
+  if (pieceSize < 1024)
+    {
+    pieceSize = 1024;
+    }
+  for (i=0; i<numPieces; i++)
+    {
+    functor.Pieces.push_back(
+      new vtkContourGridPiece(input, computeScalars, i*numCells/numPieces,
+                              (i+1)*numCells/numPieces, pieceSize));
+    }
+
+  vtkParallelFor *parallelFor = vtkParallelFor::New();
+  parallelFor->SetNumberOfThreads(self->GetNumberOfThreads());
+  parallelFor->SetGrainSize(1);
+  parallelFor->Execute(0, numPieces, &functor);
+  parallelFor->Delete();
+
+  // Merge the points of the pieces by the edges they were interpolated on.
+  vtkPoints *newPts = vtkPoints::New();
+  newPts->Allocate(estimatedSize,estimatedSize);
+  vtkMergeEdgePoints *merge = vtkMergeEdgePoints::New();
+  merge->InitPointInsertion(newPts, bounds, estimatedSize);
+  if (!computeScalars)
+    {
+    outPd->CopyScalarsOff();
+    }
+  outPd->InterpolateAllocate(input->GetPointData(),estimatedSize,
+                             estimatedSize);
+  outCd->CopyAllocate(input->GetCellData(),estimatedSize,estimatedSize);
+  int numPointArrays = outPd->GetNumberOfArrays();
+
+  vtkstd::vector<vtkstd::vector<vtkIdType> > pointMaps(numPieces);
+  vtkIdType numVerts = 0, numLines = 0, numPolys = 0;
+  for (i=0; i<numPieces; i++)
+    {
+    vtkContourGridPiece *piece = functor.Pieces[i];
+    vtkIdType numPts = piece->Points->GetNumberOfPoints();
+    vtkstd::vector<vtkIdType> &pointMap = pointMaps[i];
+    pointMap.resize(numPts);
+    double x[3], t;
+    vtkIdType edge[2], newId;
+    int inserted;
+    for (j=0; j<numPts; j++)
+      {
+      piece->Points->GetPoint(j, x);
+      if (piece->Locator->GetPointEdge(j, edge, t))
+        {
+        inserted = merge->InsertUniqueEdgePoint(edge[0], edge[1], t, x, newId);
+        }
+      else
+        {
+        inserted = merge->InsertUniquePoint(x, newId);
+        }
+      if (inserted)
+        {
+        for (k=0; k<numPointArrays; k++)
+          {
+          outPd->GetAbstractArray(k)->InsertTuple(
+            newId, j, piece->PointData->GetAbstractArray(k));
+          }
+        }
+      pointMap[j] = newId;
+      }
+    numVerts += piece->Verts->GetNumberOfCells();
+    numLines += piece->Lines->GetNumberOfCells();
+    numPolys += piece->Polys->GetNumberOfCells();
+    }
+
+  // Append the cells, verts then lines then polys as the cell data of a
+  // vtkPolyData is ordered. A single thread contours the 1D cells, which
+  // give the verts, before the 2D cells, which give the lines, and these
+  // before the 3D cells, which give the polys, so appending each kind
+  // range by range keeps its cells in the order of a single thread even
+  // when the dimensions are mixed.
+  vtkCellArray *newVerts = vtkCellArray::New();
+  newVerts->Allocate(numVerts ? numVerts*2 : 1);
+  vtkCellArray *newLines = vtkCellArray::New();
+  newLines->Allocate(numLines ? numLines*3 : 1);
+  vtkCellArray *newPolys = vtkCellArray::New();
+  newPolys->Allocate(numPolys ? numPolys*4 : 1);
+  vtkIdType vertId = 0, lineId = numVerts, polyId = numVerts + numLines;
+  for (i=0; i<numPieces; i++)
+    {
+    vtkContourGridPiece *piece = functor.Pieces[i];
+    const vtkIdType *pointMap = 
+      pointMaps[i].empty() ? 0 : &pointMaps[i][0];
+    vtkIdType pieceVerts = piece->Verts->GetNumberOfCells();
+    vtkIdType pieceLines = piece->Lines->GetNumberOfCells();
+    vtkContourGridAppendCells(piece->Verts, newVerts, 0,
+                              piece->CellData, outCd, vertId, pointMap);
+    vtkContourGridAppendCells(piece->Lines, newLines, pieceVerts,
+                              piece->CellData, outCd, lineId, pointMap);
+    vtkContourGridAppendCells(piece->Polys, newPolys, pieceVerts + pieceLines,
+                              piece->CellData, outCd, polyId, pointMap);
+    vertId += pieceVerts;
+    lineId += pieceLines;
+    polyId += piece->Polys->GetNumberOfCells();
+    delete piece;
+    }
+
+  output->SetPoints(newPts);
+  newPts->Delete();
+  merge->Delete();
+
+  if (newVerts->GetNumberOfCells())
+    {
+    output->SetVerts(newVerts);
+    }
+  newVerts->Delete();
+
+  if (newLines->GetNumberOfCells())
+    {
+    output->SetLines(newLines);
+    }
+  newLines->Delete();
+
+  if (newPolys->GetNumberOfCells())
+    {
+    output->SetPolys(newPolys);
+    }
+  newPolys->Delete();
+
+  output->Squeeze();
+}
+
 //
 // Contouring filter for unstructured grids.
 //
@@ -361,6 +734,48 @@ int vtkContourGrid::RequestData(
     return 1;
     }
 
+  // Contour ranges of cells on several threads when the points can be
+  // merged by the input edge they lie on, which needs linear cells and the
+  // default merging of coincident points.
+  if ( this->NumberOfThreads > 1 && !useScalarTree &&
+       this->Locator->IsA("vtkMergePoints") )
+    {
+    vtkIdType numPieces = 8*this->NumberOfThreads;
+    if ( numPieces > numCells / 1024 )
+      {
+      numPieces = numCells / 1024;
+      }
+    int allLinear = 1;
+    if ( numPieces > 1 )
+      {
+      vtkCellTypes *types = vtkCellTypes::New();
+      vtkGenericCell *cell = vtkGenericCell::New();
+      input->GetCellTypes(types);
+      for (int i=0; i < types->GetNumberOfTypes() && allLinear; i++)
+        {
+        cell->SetCellType(types->GetCellType(i));
+        allLinear = cell->IsLinear();
+        }
+      cell->Delete();
+      types->Delete();
+      }
+    if ( numPieces > 1 && allLinear )
+      {
+      vtkIdType estimatedSize = static_cast<vtkIdType>(
+        pow(static_cast<double>(numCells),.75));
+      estimatedSize *= numContours;
+      estimatedSize = estimatedSize / 1024 * 1024; //multiple of 1024
+      if (estimatedSize < 1024)
+        {
+        estimatedSize = 1024;
+        }
+      vtkContourGridThreadedExecute(this, input, output, inScalars,
+                                    numContours, values, computeScalars,
+                                    numPieces, estimatedSize);
+      return 1;
+      }
+    }
+
   scalarArrayPtr = inScalars->GetVoidPointer(0);
         
   switch (inScalars->GetDataType())
@@ -427,6 +842,15 @@ void vtkContourGrid::PrintSelf(ostream& os, vtkIndent indent)
      << (this->ComputeScalars ? "On\n" : "Off\n");
   os << indent << "Use Scalar Tree: " 
      << (this->UseScalarTree ? "On\n" : "Off\n");
+  if ( this->ScalarTree )
+    {
+    os << indent << "Scalar Tree: " << this->ScalarTree << "\n";
+    }
+  else
+    {
+    os << indent << "Scalar Tree: (none)\n";
+    }
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
 
   this->ContourValues->PrintSelf(os,indent.GetNextIndent());
 
@@ -439,3 +863,12 @@ void vtkContourGrid::PrintSelf(ostream& os, vtkIndent indent)
     os << indent << "Locator: (none)\n";
     }
 }
+
+//----------------------------------------------------------------------------
+void vtkContourGrid::ReportReferences(vtkGarbageCollector* collector)
+{
+  this->Superclass::ReportReferences(collector);
+  // The scalar tree shares our input and is therefore involved in a
+  // reference loop.
+  vtkGarbageCollectorReport(collector, this->ScalarTree, "ScalarTree");
+}
@@ -32,6 +32,17 @@
 // contours are being extracted. If you want to use a scalar tree,
 // invoke the method UseScalarTreeOn().
 //
+// Grids made of linear cells only can be contoured on several threads by
+// setting NumberOfThreads. The cells are then split in ranges, each range is
+// contoured into its own output with a vtkMergeEdgePoints locator, and the
+// outputs are merged by the input edge each point was interpolated on.
+// Each range contours its 1D, then 2D, then 3D cells, and the vertices,
+// lines and polygons of the ranges are appended in range order, so grids
+// mixing cells of several dimensions give their cells and cell data in the
+// order of a single thread. Only the numbering of the points differs: a
+// single thread numbers the points on all the 1D cells first, then on the
+// 2D cells, the threads number them range by range.
+//
 
 // .SECTION Caveats
 // For unstructured data or structured grids, normals and gradients
@@ -112,6 +123,24 @@ public:
   vtkGetMacro(UseScalarTree,int);
   vtkBooleanMacro(UseScalarTree,int);
 
+  // Description:
+  // Set/Get the scalar tree used to accelerate contour extraction. A
+  // vtkSpanSpace is created when none is given. The tree is kept between
+  // executions, so contouring the same input at new values does not build
+  // it again.
+  virtual void SetScalarTree(vtkScalarTree*);
+  vtkGetObjectMacro(ScalarTree,vtkScalarTree);
+
+  // Description:
+  // Set/Get the number of threads used to contour. With more than one
+  // thread, grids of linear cells are contoured in parallel and the points
+  // merged by input edge instead of by position, which gives the output of
+  // a single thread up to the order of the points. The parallel path is not
+  // used with a scalar tree or with a locator other than vtkMergePoints.
+  // The default is one thread.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
   // Description:
   // Set / get a spatial locator for merging points. By default, 
   // an instance of vtkMergePoints is used.
@@ -127,6 +156,8 @@ protected:
   vtkContourGrid();
   ~vtkContourGrid();
 
+  virtual void ReportReferences(vtkGarbageCollector*);
+
   virtual int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
   virtual int FillInputPortInformation(int port, vtkInformation *info);
 
@@ -138,6 +169,7 @@ protected:
   int UseScalarTree;
   vtkScalarTree *ScalarTree;
   vtkEdgeTable *EdgeTable;
+  int NumberOfThreads;
   
 private:
   vtkContourGrid(const vtkContourGrid&);  // Not implemented.
@@ -26,6 +26,7 @@
 #include "vtkImplicitFunction.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMergeEdgePoints.h"
 #include "vtkMergePoints.h"
 #include "vtkObjectFactory.h"
 #include "vtkPlane.h"
@@ -58,6 +59,7 @@ vtkCutter::vtkCutter(vtkImplicitFunction *cf)
   this->CutFunction = cf;
   this->GenerateCutScalars = 0;
   this->Locator = NULL;
+  this->MergePointsByEdge = 0;
 
   this->SynchronizedTemplates3D = vtkSynchronizedTemplates3D::New();
   this->SynchronizedTemplatesCutter3D = vtkSynchronizedTemplatesCutter3D::New();
@@ -472,12 +474,27 @@ void vtkCutter::DataSetCutter(vtkDataSet *input, vtkPolyData *output)
   outPD->InterpolateAllocate(inPD,estimatedSize,estimatedSize/2);
   outCD->CopyAllocate(inCD,estimatedSize,estimatedSize/2);
 
-  // locator used to merge potentially duplicate points
-  if ( this->Locator == NULL )
+  // locator used to merge potentially duplicate points. When merging by
+  // edge the cells get no output point data; the points are interpolated
+  // afterwards, one array at a time.
+  vtkIncrementalPointLocator *locator;
+  vtkMergeEdgePoints *edgeLocator = NULL;
+  vtkPointData *cellOutPD = outPD;
+  if ( this->MergePointsByEdge && vtkMergeEdgePoints::CanMergeDataSet(input) )
+    {
+    edgeLocator = vtkMergeEdgePoints::New();
+    locator = edgeLocator;
+    cellOutPD = NULL;
+    }
+  else
     {
-    this->CreateDefaultLocator();
+    if ( this->Locator == NULL )
+      {
+      this->CreateDefaultLocator();
+      }
+    locator = this->Locator;
     }
-  this->Locator->InitPointInsertion (newPoints, input->GetBounds());
+  locator->InitPointInsertion (newPoints, input->GetBounds());
 
   // Loop over all points evaluating scalar function at each point
   //
@@ -529,8 +546,8 @@ void vtkCutter::DataSetCutter(vtkDataSet *input, vtkPolyData *output)
           }
 
         value = this->ContourValues->GetValue(iter);
-        cell->Contour(value, cellScalars, this->Locator, 
-                      newVerts, newLines, newPolys, inPD, outPD,
+        cell->Contour(value, cellScalars, locator, 
+                      newVerts, newLines, newPolys, inPD, cellOutPD,
                       inCD, cellId, outCD);
 
         } // for all cells
@@ -597,8 +614,8 @@ void vtkCutter::DataSetCutter(vtkDataSet *input, vtkPolyData *output)
             abortExecute = this->GetAbortExecute();
             }
           value = this->ContourValues->GetValue(iter);
-          cell->Contour(value, cellScalars, this->Locator, 
-                        newVerts, newLines, newPolys, inPD, outPD,
+          cell->Contour(value, cellScalars, locator, 
+                        newVerts, newLines, newPolys, inPD, cellOutPD,
                         inCD, cellId, outCD);
 
           } // for all contour values
@@ -613,6 +630,11 @@ void vtkCutter::DataSetCutter(vtkDataSet *input, vtkPolyData *output)
   cellScalars->Delete();
   cutScalars->Delete();
 
+  if ( edgeLocator )
+    {
+    edgeLocator->InterpolatePointData(inPD, outPD);
+    }
+
   if ( this->GenerateCutScalars )
     {
     inPD->Delete();
@@ -639,7 +661,11 @@ void vtkCutter::DataSetCutter(vtkDataSet *input, vtkPolyData *output)
     }
   newPolys->Delete();
 
-  this->Locator->Initialize();//release any extra memory
+  locator->Initialize();//release any extra memory
+  if ( edgeLocator )
+    {
+    edgeLocator->Delete();
+    }
   output->Squeeze();
 }
 
@@ -701,12 +727,27 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
   outPD->InterpolateAllocate(inPD,estimatedSize,estimatedSize/2);
   outCD->CopyAllocate(inCD,estimatedSize,estimatedSize/2);
     
-  // locator used to merge potentially duplicate points
-  if ( this->Locator == NULL )
+  // locator used to merge potentially duplicate points. When merging by
+  // edge the cells get no output point data; the points are interpolated
+  // afterwards, one array at a time.
+  vtkIncrementalPointLocator *locator;
+  vtkMergeEdgePoints *edgeLocator = NULL;
+  vtkPointData *cellOutPD = outPD;
+  if ( this->MergePointsByEdge && vtkMergeEdgePoints::CanMergeDataSet(input) )
+    {
+    edgeLocator = vtkMergeEdgePoints::New();
+    locator = edgeLocator;
+    cellOutPD = NULL;
+    }
+  else
     {
-    this->CreateDefaultLocator();
+    if ( this->Locator == NULL )
+      {
+      this->CreateDefaultLocator();
+      }
+    locator = this->Locator;
     }
-  this->Locator->InitPointInsertion (newPoints, input->GetBounds());
+  locator->InitPointInsertion (newPoints, input->GetBounds());
 
   // Loop over all points evaluating scalar function at each point
   //
@@ -794,8 +835,8 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
               }
             value = this->ContourValues->GetValue(iter);
               
-            cell->Contour(value, cellScalars, this->Locator, 
-                          newVerts, newLines, newPolys, inPD, outPD,
+            cell->Contour(value, cellScalars, locator, 
+                          newVerts, newLines, newPolys, inPD, cellOutPD,
                           inCD, cellId, outCD);
             }
           }
@@ -894,8 +935,8 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
               }
             value = this->ContourValues->GetValue(iter);
 
-            cell->Contour(value, cellScalars, this->Locator, 
-                          newVerts, newLines, newPolys, inPD, outPD,
+            cell->Contour(value, cellScalars, locator, 
+                          newVerts, newLines, newPolys, inPD, cellOutPD,
                           inCD, cellId, outCD);
             } // for all contour values
 
@@ -910,6 +951,11 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
   cellScalars->Delete();
   cutScalars->Delete();
 
+  if ( edgeLocator )
+    {
+    edgeLocator->InterpolatePointData(inPD, outPD);
+    }
+
   if ( this->GenerateCutScalars )
     {
     inPD->Delete();
@@ -936,7 +982,11 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
     }
   newPolys->Delete();
 
-  this->Locator->Initialize();//release any extra memory
+  locator->Initialize();//release any extra memory
+  if ( edgeLocator )
+    {
+    edgeLocator->Delete();
+    }
   output->Squeeze();
 }
 
@@ -992,6 +1042,8 @@ void vtkCutter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Generate Cut Scalars: "
      << (this->GenerateCutScalars ? "On\n" : "Off\n");
+  os << indent << "Merge Points By Edge: "
+     << (this->MergePointsByEdge ? "On\n" : "Off\n");
 }
 
 //-----------------------------------------------------------------------
@@ -139,6 +139,19 @@ public:
   void SetLocator(vtkIncrementalPointLocator *locator);
   vtkGetObjectMacro(Locator,vtkIncrementalPointLocator);
 
+  // Description:
+  // If this flag is enabled, the points generated on the edges of the input
+  // cells are merged by the input edge they lie on, with a
+  // vtkMergeEdgePoints, instead of by position with the locator. This is
+  // exact and needs no search, and the point data is interpolated once all
+  // the points are known, one array at a time. It only applies to datasets
+  // cut cell by cell (not to images, structured and rectilinear grids, which
+  // are cut with synchronized templates) and made of linear cells other
+  // than vertices; other inputs use the locator. Off by default.
+  vtkSetMacro(MergePointsByEdge,int);
+  vtkGetMacro(MergePointsByEdge,int);
+  vtkBooleanMacro(MergePointsByEdge,int);
+
   // Description:
   // Set the sorting order for the generated polydata. There are two
   // possibilities:
@@ -203,6 +216,7 @@ protected:
   int SortBy;
   vtkContourValues *ContourValues;
   int GenerateCutScalars;
+  int MergePointsByEdge;
 private:
   vtkCutter(const vtkCutter&);  // Not implemented.
   void operator=(const vtkCutter&);  // Not implemented.
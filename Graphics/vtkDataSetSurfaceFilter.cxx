@@ -22,6 +22,7 @@
 #include "vtkInformationVector.h"
 #include "vtkMergePoints.h"
 #include "vtkObjectFactory.h"
+#include "vtkParallelFor.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPyramid.h"
@@ -38,6 +39,9 @@
 #include "vtkWedge.h"
 #include "vtkIdTypeArray.h"
 
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
 
 static int sizeofFastQuad(int numPts)
 {
@@ -70,6 +74,8 @@ vtkDataSetSurfaceFilter::vtkDataSetSurfaceFilter()
   this->PassThroughPointIds = 0;
   this->OriginalCellIds = NULL;
   this->OriginalPointIds = NULL;
+
+  this->NumberOfThreads = 1;
 }
 
 //----------------------------------------------------------------------------
@@ -893,7 +899,422 @@ void vtkDataSetSurfaceFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "PieceInvariant: " << this->PieceInvariant << endl;
   os << indent << "PassThroughCellIds: " << (this->PassThroughCellIds ? "On\n" : "Off\n");
   os << indent << "PassThroughPointIds: " << (this->PassThroughPointIds ? "On\n" : "Off\n");
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
+
+}
+
+//----------------------------------------------------------------------------
+// The faces of the 3D cells whose external faces can be found on threads,
+// each given by its number of points and their indices in the cell, in the
+// order and orientation UnstructuredGridExecute() inserts them in the hash.
+// Wedges and pyramids are listed as their GetFace() returns them.
+struct vtkDataSetSurfaceFilterCellFaces
+{
+  int NumberOfFaces;
+  int Faces[8][7];
+};
+
+static const vtkDataSetSurfaceFilterCellFaces vtkDataSetSurfaceFilterTetraFaces =
+  { 4, { {3, 0,1,3}, {3, 0,2,1}, {3, 0,3,2}, {3, 1,2,3} } };
+static const vtkDataSetSurfaceFilterCellFaces vtkDataSetSurfaceFilterHexFaces =
+  { 6, { {4, 0,1,5,4}, {4, 0,3,2,1}, {4, 0,4,7,3}, {4, 1,2,6,5},
+         {4, 2,3,7,6}, {4, 4,5,6,7} } };
+static const vtkDataSetSurfaceFilterCellFaces vtkDataSetSurfaceFilterVoxelFaces =
+  { 6, { {4, 0,1,5,4}, {4, 0,2,3,1}, {4, 0,4,6,2}, {4, 1,3,7,5},
+         {4, 2,6,7,3}, {4, 4,5,7,6} } };
+static const vtkDataSetSurfaceFilterCellFaces vtkDataSetSurfaceFilterWedgeFaces =
+  { 5, { {3, 0,1,2}, {3, 3,5,4}, {4, 0,3,4,1}, {4, 1,4,5,2},
+         {4, 2,5,3,0} } };
+static const vtkDataSetSurfaceFilterCellFaces vtkDataSetSurfaceFilterPyramidFaces =
+  { 5, { {4, 0,3,2,1}, {3, 0,1,4}, {3, 1,2,4}, {3, 2,3,4}, {3, 3,0,4} } };
+static const vtkDataSetSurfaceFilterCellFaces vtkDataSetSurfaceFilterPentaFaces =
+  { 7, { {4, 0,1,6,5}, {4, 1,2,7,6}, {4, 2,3,8,7}, {4, 3,4,9,8},
+         {4, 4,0,5,9}, {5, 0,1,2,3,4}, {5, 5,6,7,8,9} } };
+static const vtkDataSetSurfaceFilterCellFaces vtkDataSetSurfaceFilterHexaFaces =
+  { 8, { {4, 0,1,7,6}, {4, 1,2,8,7}, {4, 2,3,9,8}, {4, 3,4,10,9},
+         {4, 4,5,11,10}, {4, 5,0,6,11}, {6, 0,1,2,3,4,5},
+         {6, 6,7,8,9,10,11} } };
+
+// The faces of a cell type, NULL if its faces are not found on threads.
+static const vtkDataSetSurfaceFilterCellFaces *
+vtkDataSetSurfaceFilterGetCellFaces(int cellType)
+{
+  switch (cellType)
+    {
+    case VTK_TETRA:
+      return &vtkDataSetSurfaceFilterTetraFaces;
+    case VTK_HEXAHEDRON:
+      return &vtkDataSetSurfaceFilterHexFaces;
+    case VTK_VOXEL:
+      return &vtkDataSetSurfaceFilterVoxelFaces;
+    case VTK_WEDGE:
+      return &vtkDataSetSurfaceFilterWedgeFaces;
+    case VTK_PYRAMID:
+      return &vtkDataSetSurfaceFilterPyramidFaces;
+    case VTK_PENTAGONAL_PRISM:
+      return &vtkDataSetSurfaceFilterPentaFaces;
+    case VTK_HEXAGONAL_PRISM:
+      return &vtkDataSetSurfaceFilterHexaFaces;
+    default:
+      return NULL;
+    }
+}
+
+// Whether the external faces of the cells can be found on threads: the 3D
+// cells all have their faces listed above, and the other cells never go
+// through the hash.
+static int vtkDataSetSurfaceFilterCanThread(unsigned char *cellTypes,
+                                            vtkIdType numCells)
+{
+  for (vtkIdType cellId=0; cellId < numCells; cellId++)
+    {
+    switch (cellTypes[cellId])
+      {
+      case VTK_EMPTY_CELL:
+      case VTK_VERTEX:
+      case VTK_POLY_VERTEX:
+      case VTK_LINE:
+      case VTK_POLY_LINE:
+      case VTK_QUADRATIC_EDGE:
+      case VTK_PIXEL:
+      case VTK_QUAD:
+      case VTK_TRIANGLE:
+      case VTK_POLYGON:
+      case VTK_TRIANGLE_STRIP:
+      case VTK_QUADRATIC_TRIANGLE:
+      case VTK_QUADRATIC_QUAD:
+      case VTK_QUADRATIC_LINEAR_QUAD:
+      case VTK_BIQUADRATIC_QUAD:
+        break;
+      default:
+        if (!vtkDataSetSurfaceFilterGetCellFaces(cellTypes[cellId]))
+          {
+          return 0;
+          }
+      }
+    }
+  return 1;
+}
+
+// Copy the points of a face of a cell, rotated as the hash stores them:
+// the smallest id first, keeping the orientation. Returns the number of
+// points of the face.
+static int vtkDataSetSurfaceFilterGetFace(const vtkIdType *ids,
+                                          const int *face, vtkIdType *pts)
+{
+  int numPts = face[0];
+  vtkIdType a = ids[face[1]], b = ids[face[2]], c = ids[face[3]];
+  if (numPts == 3)
+    {
+    if (b < a && b < c)
+      {
+      pts[0] = b; pts[1] = c; pts[2] = a;
+      }
+    else if (c < a && c < b)
+      {
+      pts[0] = c; pts[1] = a; pts[2] = b;
+      }
+    else
+      {
+      pts[0] = a; pts[1] = b; pts[2] = c;
+      }
+    }
+  else if (numPts == 4)
+    {
+    vtkIdType d = ids[face[4]];
+    if (b < a && b < c && b < d)
+      {
+      pts[0] = b; pts[1] = c; pts[2] = d; pts[3] = a;
+      }
+    else if (c < a && c < b && c < d)
+      {
+      pts[0] = c; pts[1] = d; pts[2] = a; pts[3] = b;
+      }
+    else if (d < a && d < b && d < c)
+      {
+      pts[0] = d; pts[1] = a; pts[2] = b; pts[3] = c;
+      }
+    else
+      {
+      pts[0] = a; pts[1] = b; pts[2] = c; pts[3] = d;
+      }
+    }
+  else
+    {
+    int offset = 0;
+    for (int i=1; i < numPts; i++)
+      {
+      if (ids[face[i+1]] < ids[face[offset+1]])
+        {
+        offset = i;
+        }
+      }
+    for (int i=0; i < numPts; i++)
+      {
+      pts[i] = ids[face[(offset+i)%numPts + 1]];
+      }
+    }
+  return numPts;
+}
+
+// Whether a face matches one met before with the same first point, as the
+// hash compares them.
+static int vtkDataSetSurfaceFilterSameFace(const vtkIdType *quad,
+                                           int quadNumPts,
+                                           const vtkIdType *tab, int numPts)
+{
+  if (numPts != quadNumPts)
+    {
+    return 0;
+    }
+  if (numPts == 3)
+    {
+    return ((tab[1] == quad[1] && tab[2] == quad[2]) ||
+            (tab[1] == quad[2] && tab[2] == quad[1]));
+    }
+  if (numPts == 4)
+    {
+    return (tab[2] == quad[2] &&
+            ((tab[1] == quad[1] && tab[3] == quad[3]) ||
+             (tab[1] == quad[3] && tab[3] == quad[1])));
+    }
+  int i;
+  if (tab[1] == quad[1])
+    {
+    for (i = 2; i < numPts && tab[i] == quad[i]; i++)
+      {
+      }
+    return (i == numPts);
+    }
+  if (tab[numPts-1] == quad[1])
+    {
+    for (i = 2; i < numPts && tab[numPts-i] == quad[i]; i++)
+      {
+      }
+    return (i == numPts);
+    }
+  return 0;
+}
 
+// A face of a 3D cell, keyed by its smallest point. Face packs the cell id
+// and the index of the face in the cell so that the faces of a point sort
+// in the order the hash meets them. It is set to -1 once the face is known
+// to be shared.
+struct vtkDataSetSurfaceFilterFace
+{
+  vtkIdType Point;
+  vtkIdType Face;
+};
+
+static bool vtkDataSetSurfaceFilterFaceLess(
+  const vtkDataSetSurfaceFilterFace &a, const vtkDataSetSurfaceFilterFace &b)
+{
+  return (a.Point < b.Point || (a.Point == b.Point && a.Face < b.Face));
+}
+
+// The points of the face a vtkDataSetSurfaceFilterFace stands for.
+static int vtkDataSetSurfaceFilterGetFace(const vtkIdType *connectivity,
+                                          const vtkIdType *locations,
+                                          const unsigned char *cellTypes,
+                                          vtkIdType face, vtkIdType *pts)
+{
+  vtkIdType cellId = face / 8;
+  return vtkDataSetSurfaceFilterGetFace(
+    connectivity + locations[cellId] + 1,
+    vtkDataSetSurfaceFilterGetCellFaces(cellTypes[cellId])->Faces[face % 8],
+    pts);
+}
+
+//----------------------------------------------------------------------------
+// Counts the faces of ranges of cells falling in each block of points, by
+// their smallest point, then places them, in order, at the positions the
+// counts give.
+class vtkDataSetSurfaceFilterBucketFunctor : public vtkParallelForFunctor
+{
+public:
+  const vtkIdType *Connectivity;
+  const vtkIdType *Locations;
+  const unsigned char *CellTypes;
+  vtkIdType NumberOfCells;
+  vtkIdType NumberOfRanges;
+  vtkIdType NumberOfBlocks;
+  vtkIdType BlockSize;
+  vtkIdType *Counts; //per range and block, then the next position
+  vtkDataSetSurfaceFilterFace *Faces; //NULL while counting
+
+  void Execute(vtkIdType begin, vtkIdType end, int vtkNotUsed(threadId))
+    {
+    vtkIdType pts[6];
+    for (vtkIdType range=begin; range < end; range++)
+      {
+      vtkIdType *counts = this->Counts + range*this->NumberOfBlocks;
+      vtkIdType last = (range+1)*this->NumberOfCells/this->NumberOfRanges;
+      for (vtkIdType cellId=range*this->NumberOfCells/this->NumberOfRanges;
+           cellId < last; cellId++)
+        {
+        const vtkDataSetSurfaceFilterCellFaces *cellFaces =
+          vtkDataSetSurfaceFilterGetCellFaces(this->CellTypes[cellId]);
+        if (!cellFaces)
+          {
+          continue;
+          }
+        const vtkIdType *ids =
+          this->Connectivity + this->Locations[cellId] + 1;
+        for (int i=0; i < cellFaces->NumberOfFaces; i++)
+          {
+          vtkDataSetSurfaceFilterGetFace(ids, cellFaces->Faces[i], pts);
+          vtkIdType block = pts[0] / this->BlockSize;
+          if (this->Faces)
+            {
+            vtkDataSetSurfaceFilterFace *face = this->Faces + counts[block]++;
+            face->Point = pts[0];
+            face->Face = 8*cellId + i;
+            }
+          else
+            {
+            counts[block]++;
+            }
+          }
+        }
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Sorts the faces of a range of blocks by smallest point, and marks those
+// met more than once with the same first point, as the hash matches them.
+class vtkDataSetSurfaceFilterVisibleFunctor : public vtkParallelForFunctor
+{
+public:
+  const vtkIdType *Connectivity;
+  const vtkIdType *Locations;
+  const unsigned char *CellTypes;
+  vtkDataSetSurfaceFilterFace *Faces;
+  const vtkIdType *BlockStarts;
+  // per thread, the faces first met for the current point: their position,
+  // number of points and points
+  vtkstd::vector<vtkstd::vector<vtkIdType> > Entries;
+
+  void Initialize(int numberOfThreads)
+    {
+    this->Entries.resize(numberOfThreads);
+    }
+
+  void Execute(vtkIdType begin, vtkIdType end, int threadId)
+    {
+    vtkstd::vector<vtkIdType> &entries = this->Entries[threadId];
+    vtkIdType pts[6];
+    for (vtkIdType block=begin; block < end; block++)
+      {
+      vtkDataSetSurfaceFilterFace *first = this->Faces + this->BlockStarts[block];
+      vtkDataSetSurfaceFilterFace *last = this->Faces + this->BlockStarts[block+1];
+      vtkstd::sort(first, last, vtkDataSetSurfaceFilterFaceLess);
+      vtkDataSetSurfaceFilterFace *next;
+      for (vtkDataSetSurfaceFilterFace *face=first; face < last; face=next)
+        {
+        for (next=face+1; next < last && next->Point == face->Point; next++)
+          {
+          }
+        if (next - face == 1)
+          {
+          continue;
+          }
+        entries.clear();
+        for (vtkDataSetSurfaceFilterFace *current=face; current < next;
+             current++)
+          {
+          int numPts = vtkDataSetSurfaceFilterGetFace(
+            this->Connectivity, this->Locations, this->CellTypes,
+            current->Face, pts);
+          size_t entry;
+          for (entry=0; entry < entries.size(); entry += 8)
+            {
+            if (vtkDataSetSurfaceFilterSameFace(
+                  &entries[entry+2], static_cast<int>(entries[entry+1]),
+                  pts, numPts))
+              {
+              break;
+              }
+            }
+          if (entry < entries.size())
+            {
+            face[entries[entry]].Face = -1;
+            current->Face = -1;
+            }
+          else
+            {
+            entries.push_back(current - face);
+            entries.push_back(numPts);
+            entries.insert(entries.end(), pts, pts+6);
+            }
+          }
+        }
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Find the faces of the 3D cells of an unstructured grid used by a single
+// cell. The faces are bucketed by blocks of their smallest point over
+// ranges of cells, then each block is sorted and its shared faces marked,
+// on threads. The faces end up sorted by smallest point, then in the order
+// the hash would have met them, with -1 as Face for the shared ones.
+static void vtkDataSetSurfaceFilterFindFaces(
+  vtkUnstructuredGrid *input, int numThreads,
+  vtkstd::vector<vtkDataSetSurfaceFilterFace> &faces)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkIdType numCells = input->GetNumberOfCells();
+
+  vtkParallelFor *parallelFor = vtkParallelFor::New();
+  parallelFor->SetNumberOfThreads(numThreads);
+
+  vtkDataSetSurfaceFilterBucketFunctor bucketFunctor;
+  bucketFunctor.Connectivity = input->GetCells()->GetPointer();
+  bucketFunctor.Locations = input->GetCellLocationsArray()->GetPointer(0);
+  bucketFunctor.CellTypes = input->GetCellTypesArray()->GetPointer(0);
+  bucketFunctor.NumberOfCells = numCells;
+  bucketFunctor.NumberOfRanges = 4*numThreads;
+  if (bucketFunctor.NumberOfRanges > numCells)
+    {
+    bucketFunctor.NumberOfRanges = numCells;
+    }
+  bucketFunctor.BlockSize = 256;
+  vtkIdType numBlocks = numPts/bucketFunctor.BlockSize + 1;
+  bucketFunctor.NumberOfBlocks = numBlocks;
+  vtkstd::vector<vtkIdType> counts(bucketFunctor.NumberOfRanges*numBlocks, 0);
+  bucketFunctor.Counts = &counts[0];
+  bucketFunctor.Faces = NULL;
+  parallelFor->SetGrainSize(1);
+  parallelFor->Execute(0, bucketFunctor.NumberOfRanges, &bucketFunctor);
+
+  vtkstd::vector<vtkIdType> blockStarts(numBlocks+1);
+  vtkIdType numFaces = 0;
+  for (vtkIdType block=0; block < numBlocks; block++)
+    {
+    blockStarts[block] = numFaces;
+    for (vtkIdType range=0; range < bucketFunctor.NumberOfRanges; range++)
+      {
+      vtkIdType count = counts[range*numBlocks + block];
+      counts[range*numBlocks + block] = numFaces;
+      numFaces += count;
+      }
+    }
+  blockStarts[numBlocks] = numFaces;
+  faces.resize(numFaces+1);
+  bucketFunctor.Faces = &faces[0];
+  parallelFor->Execute(0, bucketFunctor.NumberOfRanges, &bucketFunctor);
+  parallelFor->SetGrainSize(0);
+  faces.resize(numFaces);
+
+  vtkDataSetSurfaceFilterVisibleFunctor visibleFunctor;
+  visibleFunctor.Connectivity = bucketFunctor.Connectivity;
+  visibleFunctor.Locations = bucketFunctor.Locations;
+  visibleFunctor.CellTypes = bucketFunctor.CellTypes;
+  visibleFunctor.Faces = (numFaces > 0 ? &faces[0] : NULL);
+  visibleFunctor.BlockStarts = &blockStarts[0];
+  parallelFor->Execute(0, numBlocks, &visibleFunctor);
+  parallelFor->Delete();
 }
 
 //========================================================================
@@ -945,7 +1366,25 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
   cell = vtkGenericCell::New();
 
   this->NumberOfNewCells = 0;
-  this->InitializeQuadHash(numPts);
+
+  // The external faces of the 3D cells are either found on threads before
+  // traversing the cells, or through the hash as the cells are traversed.
+  int threaded = (this->NumberOfThreads > 1 &&
+                  vtkDataSetSurfaceFilterCanThread(cellTypes, numCells));
+  vtkstd::vector<vtkDataSetSurfaceFilterFace> faces;
+  if (threaded)
+    {
+    this->PointMap = new vtkIdType[numPts];
+    for (inPtId = 0; inPtId < numPts; ++inPtId)
+      {
+      this->PointMap[inPtId] = -1;
+      }
+    vtkDataSetSurfaceFilterFindFaces(input, this->NumberOfThreads, faces);
+    }
+  else
+    {
+    this->InitializeQuadHash(numPts);
+    }
 
   // Allocate
   //
@@ -1047,6 +1486,10 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
       this->RecordOrigCellId(this->NumberOfNewCells, cellId);
       outputCD->CopyData(cd, cellId, this->NumberOfNewCells++);
       }
+    else if (threaded && vtkDataSetSurfaceFilterGetCellFaces(cellType))
+      {
+      // Do nothing.  The faces were found on threads.
+      }
     else if (cellType == VTK_HEXAHEDRON)
       {
       this->InsertQuadInHash(ids[0], ids[1], ids[5], ids[4], cellId);
@@ -1276,18 +1719,46 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
     } // for all cells.
 
 
-  // Now transfer geometry from hash to output (only triangles and quads).
-  this->InitQuadHashTraversal();
-  while ( (q = this->GetNextVisibleQuadFromHash()) )
+  // Now transfer the faces found on threads to output, in the order the
+  // hash would have given them.
+  if (threaded)
+    {
+    vtkIdType *connectivity = input->GetCells()->GetPointer();
+    vtkIdType *locations = input->GetCellLocationsArray()->GetPointer(0);
+    for (size_t f = 0; f < faces.size(); f++)
+      {
+      if (faces[f].Face < 0)
+        {
+        continue;
+        }
+      numFacePts = vtkDataSetSurfaceFilterGetFace(connectivity, locations,
+                                                  cellTypes, faces[f].Face,
+                                                  outPts);
+      for (i = 0; i < numFacePts; i++)
+        {
+        outPts[i] = this->GetOutputPointId(outPts[i], input, newPts, outputPD);
+        }
+      newPolys->InsertNextCell(numFacePts, outPts);
+      cellId = faces[f].Face / 8;
+      this->RecordOrigCellId(this->NumberOfNewCells, cellId);
+      outputCD->CopyData(inputCD, cellId, this->NumberOfNewCells++);
+      }
+    }
+  else
     {
-    // handle all polys
-    for (i = 0; i < q->numPts; i++)
+    // Now transfer geometry from hash to output (only triangles and quads).
+    this->InitQuadHashTraversal();
+    while ( (q = this->GetNextVisibleQuadFromHash()) )
       {
-      q->ptArray[i] = this->GetOutputPointId(q->ptArray[i], input, newPts, outputPD);
+      // handle all polys
+      for (i = 0; i < q->numPts; i++)
+        {
+        q->ptArray[i] = this->GetOutputPointId(q->ptArray[i], input, newPts, outputPD);
+        }
+      newPolys->InsertNextCell(q->numPts, q->ptArray);
+      this->RecordOrigCellId(this->NumberOfNewCells, q);
+      outputCD->CopyData(inputCD, q->SourceId, this->NumberOfNewCells++);
       }
-    newPolys->InsertNextCell(q->numPts, q->ptArray);
-    this->RecordOrigCellId(this->NumberOfNewCells, q);
-    outputCD->CopyData(inputCD, q->SourceId, this->NumberOfNewCells++);
     }
 
   if (this->PassThroughCellIds)
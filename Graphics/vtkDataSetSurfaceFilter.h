@@ -18,6 +18,14 @@
 // does not have an option to select bounds.  It may use more memory than
 // vtkGeometryFilter.  It only has one option: whether to use triangle strips 
 // when the input type is structured.
+//
+// The external faces of an unstructured grid made of linear 3D cells
+// (tetrahedra, hexahedra, voxels, wedges, pyramids and pentagonal and
+// hexagonal prisms) can be found on several threads by setting
+// NumberOfThreads. The faces are then keyed by their smallest point and
+// sorted instead of being inserted in the face hash, and the output is the
+// same as with a single thread. Grids with other 3D cells always use the
+// hash.
 
 // .SECTION See Also
 // vtkGeometryFilter vtkStructuredGridGeometryFilter.
@@ -80,6 +88,11 @@ public:
   vtkGetMacro(PassThroughPointIds,int);
   vtkBooleanMacro(PassThroughPointIds,int);
 
+  // Description:
+  // Set/Get the number of threads finding the external faces of
+  // unstructured grids. The default is one thread.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
 
   // Description:
   // Direct access methods that can be used to use the this class as an
@@ -169,6 +182,8 @@ protected:
   void RecordOrigPointId(vtkIdType newIndex, vtkIdType origId);
   vtkIdTypeArray *OriginalPointIds;
 
+  int NumberOfThreads;
+
 private:
   vtkDataSetSurfaceFilter(const vtkDataSetSurfaceFilter&);  // Not implemented.
   void operator=(const vtkDataSetSurfaceFilter&);  // Not implemented.
@@ -21,12 +21,63 @@
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
+#include "vtkParallelFor.h"
 #include "vtkPointData.h"
 #include "vtkSmartPointer.h"
 
 vtkCxxRevisionMacro(vtkElevationFilter, "$Revision$");
 vtkStandardNewMacro(vtkElevationFilter);
 
+//----------------------------------------------------------------------------
+// Computes the elevation scalars of a range of points.
+class vtkElevationFilterFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkElevationFilter *Filter;
+  vtkDataSet *Input;
+  float *Scalars;
+  vtkIdType NumberOfPoints;
+  double LowPoint[3];
+  double DiffVector[3];
+  double Length2;
+  double ScalarRange[2];
+  int Abort;
+
+  virtual void Execute(vtkIdType begin, vtkIdType end, int threadId)
+    {
+    // Support progress and abort.  Only the calling thread (thread 0)
+    // talks to the filter, the others just look at the abort flag.
+    if (threadId == 0)
+      {
+      this->Filter->UpdateProgress(
+        static_cast<double>(begin+1)/this->NumberOfPoints);
+      this->Abort = this->Filter->GetAbortExecute();
+      }
+    if (this->Abort)
+      {
+      return;
+      }
+
+    // Compute parametric coordinate and map into scalar range.
+    double diffScalar = this->ScalarRange[1] - this->ScalarRange[0];
+    for(vtkIdType i=begin; i < end; ++i)
+      {
+      // Project this input point into the 1D system.
+      double x[3];
+      this->Input->GetPoint(i, x);
+      double v[3] = { x[0] - this->LowPoint[0],
+                      x[1] - this->LowPoint[1],
+                      x[2] - this->LowPoint[2] };
+      double s = vtkMath::Dot(v, this->DiffVector) / this->Length2;
+      s = (s < 0.0 ? 0.0 : s > 1.0 ? 1.0 : s);
+
+      // Store the resulting scalar value.
+      this->Scalars[i] = 
+        static_cast<float>(this->ScalarRange[0] + s*diffScalar);
+      }
+    }
+};
+
 //----------------------------------------------------------------------------
 vtkElevationFilter::vtkElevationFilter()
 {
@@ -101,35 +152,31 @@ int vtkElevationFilter::RequestData(vtkInformation*,
     length2 = 1.0;
     }
 
-  // Support progress and abort.
-  vtkIdType tenth = (numPts >= 10? numPts/10 : 1);
-  double numPtsInv = 1.0/numPts;
-  int abort = 0;
-
-  // Compute parametric coordinate and map into scalar range.
-  double diffScalar = this->ScalarRange[1] - this->ScalarRange[0];
-  vtkDebugMacro("Generating elevation scalars!");
-  for(vtkIdType i=0; i < numPts && !abort; ++i)
+  // Compute parametric coordinate and map into scalar range, using
+  // several threads for large inputs.
+  vtkElevationFilterFunctor functor;
+  functor.Filter = this;
+  functor.Input = input;
+  functor.Scalars = newScalars->GetPointer(0);
+  functor.NumberOfPoints = numPts;
+  functor.Length2 = length2;
+  functor.Abort = 0;
+  for(int j=0; j < 3; ++j)
     {
-    // Periodically update progress and check for an abort request.
-    if(i % tenth == 0)
-      {
-      this->UpdateProgress((i+1)*numPtsInv);
-      abort = this->GetAbortExecute();
-      }
-
-    // Project this input point into the 1D system.
-    double x[3];
-    input->GetPoint(i, x);
-    double v[3] = { x[0] - this->LowPoint[0],
-                    x[1] - this->LowPoint[1],
-                    x[2] - this->LowPoint[2] };
-    double s = vtkMath::Dot(v, diffVector) / length2;
-    s = (s < 0.0 ? 0.0 : s > 1.0 ? 1.0 : s);
-
-    // Store the resulting scalar value.
-    newScalars->SetValue(i, this->ScalarRange[0] + s*diffScalar);
+    functor.LowPoint[j] = this->LowPoint[j];
+    functor.DiffVector[j] = diffVector[j];
     }
+  functor.ScalarRange[0] = this->ScalarRange[0];
+  functor.ScalarRange[1] = this->ScalarRange[1];
+
+  // GetPoint is only thread safe once it has been called from one thread.
+  double x[3];
+  input->GetPoint(0, x);
+
+  vtkDebugMacro("Generating elevation scalars!");
+  vtkSmartPointer<vtkParallelFor> parallelFor =
+    vtkSmartPointer<vtkParallelFor>::New();
+  parallelFor->Execute(0, numPts, &functor);
 
   // Copy all the input geometry and data to the output.
   output->CopyStructure(input);
@@ -270,6 +270,11 @@ protected:
   vtkOBBTree();
   ~vtkOBBTree();
 
+  // Description:
+  // IntersectWithLine() only reads the tree once it is built.
+  virtual int IsQueryThreadSafe(int query)
+    { return query == vtkAbstractCellLocator::INTERSECT_WITH_LINE; }
+
   // Compute an OBB from the list of cells given.  This used to be
   // public but should not have been.  A public call has been added
   // so that the functionality can be accessed.
@@ -20,11 +20,75 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkParallelFor.h"
 #include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+
+#include <vtkstd/vector>
 
 vtkCxxRevisionMacro(vtkPointDataToCellData, "$Revision$");
 vtkStandardNewMacro(vtkPointDataToCellData);
 
+//----------------------------------------------------------------------------
+// Averages the point data of a range of cells.
+class vtkPointDataToCellDataFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkPointDataToCellData *Filter;
+  vtkDataSet *Input;
+  vtkPointData *InPD;
+  vtkCellData *OutCD;
+  vtkIdType NumberOfCells;
+  int MaxCellSize;
+  int Abort;
+  vtkstd::vector<vtkSmartPointer<vtkIdList> > CellPts;
+  vtkstd::vector<double> Weights;
+
+  virtual void Initialize(int numberOfThreads)
+    {
+    this->CellPts.resize(numberOfThreads);
+    for (int i=0; i < numberOfThreads; i++)
+      {
+      this->CellPts[i] = vtkSmartPointer<vtkIdList>::New();
+      this->CellPts[i]->Allocate(this->MaxCellSize);
+      }
+    this->Weights.resize(numberOfThreads*this->MaxCellSize + 1);
+    }
+
+  virtual void Execute(vtkIdType begin, vtkIdType end, int threadId)
+    {
+    // Report progress at the start of the chunks of thread 0.
+    if ( threadId == 0 )
+      {
+      this->Filter->UpdateProgress(
+        static_cast<double>(begin)/this->NumberOfCells);
+      this->Abort = this->Filter->GetAbortExecute();
+      }
+    if ( this->Abort )
+      {
+      return;
+      }
+
+    vtkIdList *cellPts = this->CellPts[threadId];
+    double *weights = &this->Weights[threadId*this->MaxCellSize];
+    for (vtkIdType cellId=begin; cellId < end; cellId++)
+      {
+      this->Input->GetCellPoints(cellId, cellPts);
+      vtkIdType numPts = cellPts->GetNumberOfIds();
+      if ( numPts > 0 )
+        {
+        double weight = 1.0 / numPts;
+        for (vtkIdType ptId=0; ptId < numPts; ptId++)
+          {
+          weights[ptId] = weight;
+          }
+        }
+      // Cells without points get zeros, the arrays are already sized.
+      this->OutCD->InterpolatePoint(this->InPD, cellId, cellPts, weights);
+      }
+    }
+};
+
 //----------------------------------------------------------------------------
 // Instantiate object so that point data is not passed to output.
 vtkPointDataToCellData::vtkPointDataToCellData()
@@ -46,14 +110,9 @@ int vtkPointDataToCellData::RequestData(
   vtkDataSet *input = vtkDataSet::SafeDownCast(
     inInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType cellId, ptId;
-  vtkIdType numCells, numPts;
+  vtkIdType numCells;
   vtkPointData *inPD=input->GetPointData();
   vtkCellData *outCD=output->GetCellData();
-  int maxCellSize=input->GetMaxCellSize();
-  vtkIdList *cellPts;
-  double weight;
-  double *weights;
 
   vtkDebugMacro(<<"Mapping point data to cell data");
 
@@ -65,10 +124,6 @@ int vtkPointDataToCellData::RequestData(
     vtkDebugMacro(<<"No input cells!");
     return 1;
     }
-  weights=new double[maxCellSize];
-  
-  cellPts = vtkIdList::New();
-  cellPts->Allocate(maxCellSize);
 
   // Pass the cell data first. The fields and attributes
   // which also exist in the point data of the input will
@@ -81,29 +136,28 @@ int vtkPointDataToCellData::RequestData(
   // It's weird, but it works.
   outCD->InterpolateAllocate(inPD,numCells);
 
-  int abort=0;
-  vtkIdType progressInterval=numCells/20 + 1;
-  for (cellId=0; cellId < numCells && !abort; cellId++)
+  vtkSmartPointer<vtkParallelFor> parallelFor =
+    vtkSmartPointer<vtkParallelFor>::New();
+  if ( !outCD->PrepareThreadedInterpolation(numCells) )
     {
-    if ( !(cellId % progressInterval) )
-      {
-      this->UpdateProgress((double)cellId/numCells);
-      abort = GetAbortExecute();
-      }
-
-    input->GetCellPoints(cellId, cellPts);
-    numPts = cellPts->GetNumberOfIds();
-    if ( numPts > 0 )
-      {
-      weight = 1.0 / numPts;
-      for (ptId=0; ptId < numPts; ptId++)
-        {
-        weights[ptId] = weight;
-        }
-      outCD->InterpolatePoint(inPD, cellId, cellPts, weights);
-      }
+    parallelFor->SetNumberOfThreads(1);
     }
 
+  // GetCellPoints builds the cell structure of polydata on first use,
+  // do that here before the threads start.
+  vtkSmartPointer<vtkIdList> cellPts = vtkSmartPointer<vtkIdList>::New();
+  input->GetCellPoints(0, cellPts);
+
+  vtkPointDataToCellDataFunctor functor;
+  functor.Filter = this;
+  functor.Input = input;
+  functor.InPD = inPD;
+  functor.OutCD = outCD;
+  functor.NumberOfCells = numCells;
+  functor.MaxCellSize = input->GetMaxCellSize();
+  functor.Abort = 0;
+  parallelFor->Execute(0, numCells, &functor);
+
   if ( !this->PassPointData )
     {
     output->GetPointData()->CopyAllOff();
@@ -111,9 +165,6 @@ int vtkPointDataToCellData::RequestData(
     }
   output->GetPointData()->PassData(input->GetPointData());
 
-  cellPts->Delete();
-  delete [] weights;
-
   return 1;
 }
 
@@ -21,6 +21,7 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkParallelFor.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
@@ -30,6 +31,110 @@
 vtkCxxRevisionMacro(vtkPolyDataNormals, "$Revision$");
 vtkStandardNewMacro(vtkPolyDataNormals);
 
+//----------------------------------------------------------------------------
+// Computes the normals of a range of polygons.
+class vtkPolyDataNormalsPolyFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkPolyDataNormals *Filter;
+  vtkPolyData *Mesh;
+  vtkPoints *Points;
+  float *PolyNormals;
+  vtkIdType NumberOfPolys;
+  int Abort;
+
+  void Execute(vtkIdType begin, vtkIdType end, int threadId)
+    {
+    vtkIdType npts, *pts;
+    double n[3];
+    for (vtkIdType cellId=begin; cellId < end; cellId++)
+      {
+      if ((cellId % 1000) == 0)
+        {
+        // Progress is reported every 1000 polygons of thread 0, which
+        // also passes an abort on to the others.
+        if (threadId == 0)
+          {
+          this->Filter->UpdateProgress(0.333 + 0.333 *
+            static_cast<double>(cellId) / this->NumberOfPolys);
+          this->Abort = this->Filter->GetAbortExecute();
+          }
+        if (this->Abort)
+          {
+          return;
+          }
+        }
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      vtkPolygon::ComputeNormal(this->Points, npts, pts, n);
+      float *normal = this->PolyNormals + 3*cellId;
+      normal[0] = static_cast<float>(n[0]);
+      normal[1] = static_cast<float>(n[1]);
+      normal[2] = static_cast<float>(n[2]);
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Computes the normals of a range of points from the normals of the polygons
+// using them. The polygons of a point are found from the links of the input
+// point it was split from, and are summed in order of increasing id, so that
+// the normals do not depend on the number of threads.
+class vtkPolyDataNormalsPointFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkPolyData *OldMesh;
+  vtkPolyData *NewMesh;
+  vtkIdList *Map; //the input point of each point, NULL when not split
+  float *PolyNormals;
+  float *Normals;
+  double FlipDirection;
+
+  void Execute(vtkIdType begin, vtkIdType end, int vtkNotUsed(threadId))
+    {
+    unsigned short ncells;
+    vtkIdType *cells, npts, *pts;
+    for (vtkIdType ptId=begin; ptId < end; ptId++)
+      {
+      vtkIdType oldId = (this->Map ? this->Map->GetId(ptId) : ptId);
+      this->OldMesh->GetPointCells(oldId, ncells, cells);
+      float sum[3] = {0.0, 0.0, 0.0};
+      for (int i=0; i < ncells; i++)
+        {
+        // a polygon using a point twice is linked to it twice
+        if (i > 0 && cells[i] == cells[i-1])
+          {
+          continue;
+          }
+        float *polyNormal = this->PolyNormals + 3*cells[i];
+        this->NewMesh->GetCellPoints(cells[i], npts, pts);
+        for (vtkIdType k=0; k < npts; k++)
+          {
+          if (pts[k] == ptId)
+            {
+            for (int j=0; j < 3; j++)
+              {
+              sum[j] = static_cast<float>(static_cast<double>(sum[j]) +
+                                          polyNormal[j]);
+              }
+            }
+          }
+        }
+
+      double vertNormal[3];
+      vertNormal[0] = sum[0];
+      vertNormal[1] = sum[1];
+      vertNormal[2] = sum[2];
+      double length = vtkMath::Norm(vertNormal);
+      float *normal = this->Normals + 3*ptId;
+      for (int j=0; j < 3; j++)
+        {
+        normal[j] = static_cast<float>(
+          length != 0.0 ? vertNormal[j] / length * this->FlipDirection : 0.0);
+        }
+      }
+    }
+};
+
 // Construct with feature angle=30, splitting and consistency turned on, 
 // flipNormals turned off, and non-manifold traversal turned on.
 vtkPolyDataNormals::vtkPolyDataNormals()
@@ -42,6 +147,7 @@ vtkPolyDataNormals::vtkPolyDataNormals()
   this->ComputeCellNormals = 0;
   this->NonManifoldTraversal = 1;
   this->AutoOrientNormals = 0;
+  this->NumberOfThreads = 1;
   // some internal data
   this->NumFlips = 0;
 }
@@ -65,12 +171,10 @@ int vtkPolyDataNormals::RequestData(
   vtkPolyData *output = vtkPolyData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  int j;
   vtkIdType npts = 0;
   vtkIdType i;
   vtkIdType *pts = 0;
   vtkIdType numNewPts;
-  double polyNormal[3], vertNormal[3], length;
   double flipDirection=1.0;
   vtkIdType numPolys, numStrips;
   vtkIdType cellId;
@@ -84,6 +188,7 @@ int vtkPolyDataNormals::RequestData(
   double n[3];
   vtkCellArray *newPolys;
   vtkIdType ptId, oldId;
+  vtkIdList *map = NULL;
 
   vtkDebugMacro(<<"Generating surface normals");
 
@@ -153,9 +258,17 @@ int vtkPolyDataNormals::RequestData(
     
   this->NewMesh = vtkPolyData::New();
   this->NewMesh->SetPoints(inPts);
-  // create a copy because we're modifying it
-  newPolys = vtkCellArray::New();
-  newPolys->DeepCopy(polys);
+  // create a copy if we're modifying it
+  if ( this->Consistency || this->Splitting || this->AutoOrientNormals )
+    {
+    newPolys = vtkCellArray::New();
+    newPolys->DeepCopy(polys);
+    }
+  else
+    {
+    newPolys = polys;
+    newPolys->Register(this);
+    }
   this->NewMesh->SetPolys(newPolys);
   this->NewMesh->BuildCells(); //builds connectivity
 
@@ -317,20 +430,18 @@ int vtkPolyDataNormals::RequestData(
   this->PolyNormals->SetName("Normals");
   this->PolyNormals->SetNumberOfTuples(numPolys);
 
-  for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts); 
-       cellId++ )
-    {
-    if ((cellId % 1000) == 0)
-      {
-      this->UpdateProgress (0.333 + 0.333 * (double) cellId / (double) numPolys);
-      if (this->GetAbortExecute())
-        {
-        break; 
-        }
-      }
-    vtkPolygon::ComputeNormal(inPts, npts, pts, n);
-    this->PolyNormals->SetTuple(cellId,n);
-    }
+  vtkParallelFor *parallelFor = vtkParallelFor::New();
+  parallelFor->SetNumberOfThreads(this->NumberOfThreads);
+
+  vtkPolyDataNormalsPolyFunctor polyFunctor;
+  polyFunctor.Filter = this;
+  polyFunctor.Mesh = this->NewMesh;
+  polyFunctor.Points = inPts;
+  polyFunctor.PolyNormals = this->PolyNormals->GetPointer(0);
+  polyFunctor.NumberOfPolys = numPolys;
+  polyFunctor.Abort = 0;
+  parallelFor->Execute(0, numPolys, &polyFunctor);
+  this->UpdateProgress(0.666);
 
   // Split mesh if sharp features
   if ( this->Splitting ) 
@@ -343,7 +454,7 @@ int vtkPolyDataNormals::RequestData(
     //  Splitting will create new points.  We have to create index array 
     // to map new points into old points.
     //
-    this->Map = vtkIdList::New();
+    this->Map = map = vtkIdList::New();
     this->Map->SetNumberOfIds(numPts);
     for (i=0; i < numPts; i++)
       {
@@ -371,7 +482,6 @@ int vtkPolyDataNormals::RequestData(
       newPts->SetPoint(ptId,inPts->GetPoint(oldId));
       outPD->CopyData(pd,oldId,ptId);
       }
-    this->Map->Delete();
     } //splitting
 
   else //no splitting, so no new points
@@ -381,7 +491,7 @@ int vtkPolyDataNormals::RequestData(
     outPD->PassData(pd);
     }
 
-  if ( this->Consistency || this->Splitting )
+  if ( this->Visited )
     {
     delete [] this->Visited;
     this->CellIds->Delete();
@@ -397,47 +507,27 @@ int vtkPolyDataNormals::RequestData(
     flipDirection = -1.0;
     }
 
-  newNormals = vtkFloatArray::New();
-  newNormals->SetNumberOfComponents(3);
-  newNormals->SetNumberOfTuples(numNewPts);
-  newNormals->SetName("Normals");
-  n[0] = n[1] = n[2] = 0.0;
-  for (i=0; i < numNewPts; i++)
+  newNormals = NULL;
+  if (this->ComputePointNormals)
     {
-    newNormals->SetTuple(i,n);
+    newNormals = vtkFloatArray::New();
+    newNormals->SetNumberOfComponents(3);
+    newNormals->SetNumberOfTuples(numNewPts);
+    newNormals->SetName("Normals");
+
+    vtkPolyDataNormalsPointFunctor pointFunctor;
+    pointFunctor.OldMesh = this->OldMesh;
+    pointFunctor.NewMesh = this->NewMesh;
+    pointFunctor.Map = map;
+    pointFunctor.PolyNormals = this->PolyNormals->GetPointer(0);
+    pointFunctor.Normals = newNormals->GetPointer(0);
+    pointFunctor.FlipDirection = flipDirection;
+    parallelFor->Execute(0, numNewPts, &pointFunctor);
     }
-
-  if (this->ComputePointNormals)
+  parallelFor->Delete();
+  if ( map )
     {
-    for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts); 
-          cellId++ )
-      {
-      this->PolyNormals->GetTuple(cellId, polyNormal);
-
-      for (i=0; i < npts; i++) 
-        {
-        newNormals->GetTuple(pts[i], vertNormal);
-        for (j=0; j < 3; j++)
-          {
-          n[j] = vertNormal[j] + polyNormal[j];
-          }
-        newNormals->SetTuple(pts[i],n);
-        }
-      }
-
-    for (i=0; i < numNewPts; i++) 
-      {
-      newNormals->GetTuple(i, vertNormal);
-      length = vtkMath::Norm(vertNormal);
-      if (length != 0.0) 
-        {
-        for (j=0; j < 3; j++)
-          {
-          n[j] = vertNormal[j] / length * flipDirection;
-          }
-        }
-      newNormals->SetTuple(i,n);
-      }
+    map->Delete();
     }
 
   //  Update ourselves.  If no new nodes have been created (i.e., no
@@ -462,14 +552,14 @@ int vtkPolyDataNormals::RequestData(
     }
   this->PolyNormals->Delete();
 
-  if (this->ComputePointNormals)
+  if (newNormals)
     {
     outPD->SetNormals(newNormals);
+    newNormals->Delete();
     }
-  newNormals->Delete();
 
   output->SetPolys(newPolys);
-  newPolys->Delete();
+  newPolys->UnRegister(this);
 
   // copy the original vertices and lines to the output
   output->SetVerts(input->GetVerts());
@@ -730,5 +820,6 @@ void vtkPolyDataNormals::PrintSelf(ostream& os, vtkIndent indent)
      << (this->ComputeCellNormals ? "On\n" : "Off\n");
   os << indent << "Non-manifold Traversal: " 
      << (this->NonManifoldTraversal ? "On\n" : "Off\n");
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
 }
 
@@ -24,6 +24,12 @@
 // averaging them at shared points. When sharp edges are present, the edges
 // are split and new points generated to prevent blurry edges (due to 
 // Gouraud shading).
+//
+// The polygon normals and their averages at the points can be computed on
+// several threads by setting NumberOfThreads; the output does not depend on
+// the number of threads. The reordering of polygons for consistency and the
+// splitting of sharp edges remain serial, so for large meshes known to be
+// consistently ordered it pays to turn Consistency off.
 
 // .SECTION Caveats
 // Normals are computed only for polygons and triangle strips. Normals are
@@ -67,7 +73,10 @@ public:
   vtkBooleanMacro(Splitting,int);
 
   // Description:
-  // Turn on/off the enforcement of consistent polygon ordering.
+  // Turn on/off the enforcement of consistent polygon ordering. The
+  // ordering is checked by a serial traversal of the whole mesh, which can
+  // be skipped by turning this off when the input is known to be
+  // consistently ordered.
   vtkSetMacro(Consistency,int);
   vtkGetMacro(Consistency,int);
   vtkBooleanMacro(Consistency,int);
@@ -114,6 +123,12 @@ public:
   vtkSetMacro(NonManifoldTraversal,int);
   vtkGetMacro(NonManifoldTraversal,int);
   vtkBooleanMacro(NonManifoldTraversal,int);
+
+  // Description:
+  // Set/Get the number of threads computing the polygon normals and the
+  // point normals. The default is one thread.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
   
 protected:
   vtkPolyDataNormals();
@@ -131,6 +146,7 @@ protected:
   int ComputePointNormals;
   int ComputeCellNormals;
   int NumFlips;
+  int NumberOfThreads;
 
 private:
   vtkIdList *Wave;
@@ -14,21 +14,28 @@
 =========================================================================*/
 #include "vtkProbeFilter.h"
 
+#include "vtkAbstractCellLocator.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
 #include "vtkCharArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <vtkstd/vector>
 
 vtkCxxRevisionMacro(vtkProbeFilter, "$Revision$");
 vtkStandardNewMacro(vtkProbeFilter);
+vtkCxxSetObjectMacro(vtkProbeFilter, CellLocatorPrototype,
+                     vtkAbstractCellLocator);
 
 class vtkProbeFilter::vtkVectorOfArrays : 
   public vtkstd::vector<vtkDataArray*>
@@ -47,6 +54,7 @@ vtkProbeFilter::vtkProbeFilter()
   this->SetValidPointMaskArrayName("vtkValidPointMask");
   this->CellArrays = new vtkVectorOfArrays();
   this->NumberOfValidPoints = 0;
+  this->CellLocatorPrototype = 0;
 
   this->PointList = 0;
   this->CellList = 0;
@@ -63,6 +71,7 @@ vtkProbeFilter::~vtkProbeFilter()
   this->ValidPoints = NULL;
   this->SetValidPointMaskArrayName(0);
   delete this->CellArrays;
+  this->SetCellLocatorPrototype(0);
 
   delete this->PointList;
   delete this->CellList;
@@ -269,6 +278,34 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
   double minRes2 = minRes * minRes;
   tol2 = tol2 > minRes2 ? minRes2 : tol2;
 
+  // With a locator, find the cells of all the points still to be probed
+  // at once.
+  vtkSmartPointer<vtkIdList> locatedCellIds;
+  vtkSmartPointer<vtkDoubleArray> locatedWeights;
+  vtkIdType located = 0;
+  if (this->CellLocatorPrototype)
+    {
+    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+    points->Allocate(numPts);
+    for (ptId=0; ptId < numPts; ptId++)
+      {
+      if (maskArray[ptId] != static_cast<char>(1))
+        {
+        input->GetPoint(ptId, x);
+        points->InsertNextPoint(x);
+        }
+      }
+
+    vtkSmartPointer<vtkAbstractCellLocator> locator;
+    locator.TakeReference(this->CellLocatorPrototype->NewInstance());
+    locator->SetDataSet(source);
+    locator->BuildLocator();
+    locatedCellIds = vtkSmartPointer<vtkIdList>::New();
+    locatedWeights = vtkSmartPointer<vtkDoubleArray>::New();
+    locator->FindCells(points, tol2, locatedCellIds, NULL, locatedWeights);
+    }
+
   // Loop over all input points, interpolating source data
   //
   int abort=0;
@@ -288,11 +325,23 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
       continue;
       }
 
-    // Get the xyz coordinate of the point in the input dataset
-    input->GetPoint(ptId, x);
+    vtkIdType cellId;
+    double *ptWeights = weights;
+    if (locatedCellIds)
+      {
+      cellId = locatedCellIds->GetId(located);
+      ptWeights = locatedWeights->GetPointer(
+        located*locatedWeights->GetNumberOfComponents());
+      located++;
+      }
+    else
+      {
+      // Get the xyz coordinate of the point in the input dataset
+      input->GetPoint(ptId, x);
 
-    // Find the cell that contains xyz and get it
-    vtkIdType cellId = source->FindCell(x,NULL,-1,tol2,subId,pcoords,weights);
+      // Find the cell that contains xyz and get it
+      cellId = source->FindCell(x,NULL,-1,tol2,subId,pcoords,weights);
+      }
     if (cellId >= 0)
       {
       cell = source->GetCell(cellId);
@@ -305,7 +354,7 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
       {
       // Interpolate the point data
       outPD->InterpolatePoint((*this->PointList), pd, srcIdx, ptId,
-        cell->PointIds, weights);
+        cell->PointIds, ptWeights);
       this->ValidPoints->InsertNextValue(ptId);
       this->NumberOfValidPoints++;
       vtkVectorOfArrays::iterator iter;
@@ -511,4 +560,6 @@ void vtkProbeFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "ValidPointMaskArrayName: " << (this->ValidPointMaskArrayName?
     this->ValidPointMaskArrayName : "vtkValidPointMask") << "\n";
   os << indent << "ValidPoints: " << this->ValidPoints << "\n";
+  os << indent << "CellLocatorPrototype: " << this->CellLocatorPrototype
+     << "\n";
 }
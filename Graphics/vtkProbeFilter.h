@@ -31,6 +31,12 @@
 // rendering techniques can be used to visualize the results. Another example:
 // a line or curve can be used to probe data to produce x-y plots along
 // that line or curve.
+//
+// By default the source cell of each point is found with
+// vtkDataSet::FindCell(), one point at a time. When a CellLocatorPrototype
+// is set, an instance of it is built on the source and all the points are
+// located with one batched vtkAbstractCellLocator::FindCells() call, which
+// runs on several threads for locators that support it.
 
 #ifndef __vtkProbeFilter_h
 #define __vtkProbeFilter_h
@@ -38,6 +44,7 @@
 #include "vtkDataSetAlgorithm.h"
 #include "vtkDataSetAttributes.h" // needed for vtkDataSetAttributes::FieldList
 
+class vtkAbstractCellLocator;
 class vtkIdTypeArray;
 class vtkCharArray;
 class vtkMaskPoints;
@@ -85,6 +92,12 @@ public:
   vtkSetStringMacro(ValidPointMaskArrayName)
   vtkGetStringMacro(ValidPointMaskArrayName)
 
+  // Description:
+  // Set/Get the prototype of the cell locator used to locate the points in
+  // the source. NULL, the default, uses vtkDataSet::FindCell() instead.
+  virtual void SetCellLocatorPrototype(vtkAbstractCellLocator*);
+  vtkGetObjectMacro(CellLocatorPrototype, vtkAbstractCellLocator);
+
 //BTX 
 protected:
   vtkProbeFilter();
@@ -123,6 +136,7 @@ protected:
   vtkIdTypeArray *ValidPoints;
   vtkCharArray* MaskPoints;
   int NumberOfValidPoints;
+  vtkAbstractCellLocator* CellLocatorPrototype;
 
   // Agreed, this is sort of a hack to allow subclasses to override the default
   // behavior of this filter to call NullPoint() for every point that is
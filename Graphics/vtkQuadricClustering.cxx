@@ -22,22 +22,225 @@
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
+#include "vtkParallelFor.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTimerLog.h"
 #include "vtkTriangle.h"
+#include <vtksys/hash_map.hxx> // keep the bins visited
 #include <vtksys/hash_set.hxx> // keep track of inserted triangles
+#include <vtkstd/vector>
 
 vtkCxxRevisionMacro(vtkQuadricClustering, "$Revision$");
 vtkStandardNewMacro(vtkQuadricClustering);
 
 //----------------------------------------------------------------------------
-// PIMPLd STL set for keeping track of inserted cells
+// PIMPLd STL set for keeping track of inserted cells, keyed by the sorted
+// bin ids of their corners
+struct vtkQuadricClusteringTriangle
+{
+  vtkIdType BinIds[3];
+  bool operator==(const vtkQuadricClusteringTriangle &t) const
+    {
+    return this->BinIds[0] == t.BinIds[0] && this->BinIds[1] == t.BinIds[1] &&
+      this->BinIds[2] == t.BinIds[2];
+    }
+};
+struct vtkQuadricClusteringTriangleHash {
+  size_t operator()(const vtkQuadricClusteringTriangle &t) const
+    {
+    return static_cast<size_t>(t.BinIds[0] + 31*(t.BinIds[1] + 31*t.BinIds[2]));
+    }
+};
+class vtkQuadricClusteringCellSet : public vtksys::hash_set<vtkQuadricClusteringTriangle, vtkQuadricClusteringTriangleHash> {};
+typedef vtkQuadricClusteringCellSet::iterator vtkQuadricClusteringCellSetIterator;
+
+//----------------------------------------------------------------------------
+// The quadric accumulated in a bin and the output point of the bin.
+struct vtkQuadricClusteringBin
+{
+  vtkQuadricClusteringBin():VertexId(-1),Dimension(255),UsedByVertex(0) {}
+
+  vtkIdType VertexId;
+  // Dimension is a flag representing the dimension of the cells
+  // contributing to the quadric. Vertices: 0, Lines: 1, Triangles: 2.
+  unsigned char Dimension;
+  // Set once an output vertex cell uses the point of the bin.
+  unsigned char UsedByVertex;
+  double Quadric[9];
+};
+
+// PIMPLd hash of the bins visited, keyed by bin id
 struct vtkQuadricClusteringIdTypeHash {
   size_t operator()(vtkIdType val) const { return static_cast<size_t>(val); }
 };
-class vtkQuadricClusteringCellSet : public vtksys::hash_set<vtkIdType, vtkQuadricClusteringIdTypeHash> {};
-typedef vtkQuadricClusteringCellSet::iterator vtkQuadricClusteringCellSetIterator;
+class vtkQuadricClusteringBins : public vtksys::hash_map<vtkIdType, vtkQuadricClusteringBin, vtkQuadricClusteringIdTypeHash> {};
+typedef vtkQuadricClusteringBins::iterator vtkQuadricClusteringBinsIterator;
+
+//----------------------------------------------------------------------------
+// Add a quadric of the given dimension to a bin. Only the quadrics of the
+// lowest dimension are kept: points supercede segments, which supercede
+// triangles.
+static inline void vtkQuadricClusteringAddQuadric(vtkQuadricClusteringBin &bin,
+                                                  int dimension,
+                                                  const double quadric[9],
+                                                  double scale)
+{
+  int i;
+  if (bin.Dimension > dimension)
+    {
+    bin.Dimension = static_cast<unsigned char>(dimension);
+    for (i = 0; i < 9; i++)
+      {
+      bin.Quadric[i] = 0.0;
+      }
+    }
+  if (bin.Dimension == dimension)
+    {
+    for (i = 0; i < 9; i++)
+      {
+      bin.Quadric[i] += quadric[i] * scale;
+      }
+    }
+}
+
+// The quadric of a triangle, without the constant coefficient.
+static inline void vtkQuadricClusteringTriangleQuadric(double *pt0,
+                                                       double *pt1,
+                                                       double *pt2,
+                                                       double quadric[9])
+{
+  double quadric4x4[4][4];
+  vtkTriangle::ComputeQuadric(pt0, pt1, pt2, quadric4x4);
+  quadric[0] = quadric4x4[0][0];
+  quadric[1] = quadric4x4[0][1];
+  quadric[2] = quadric4x4[0][2];
+  quadric[3] = quadric4x4[0][3];
+  quadric[4] = quadric4x4[1][1];
+  quadric[5] = quadric4x4[1][2];
+  quadric[6] = quadric4x4[1][3];
+  quadric[7] = quadric4x4[2][2];
+  quadric[8] = quadric4x4[2][3];
+}
+
+//----------------------------------------------------------------------------
+// Accumulates the quadrics of the triangles of polygons and strips on
+// threads. The cells, polygons first, are cut into ranges whose quadrics go
+// to bins of their own, added to the bins of the filter in range order so
+// that the sums do not depend on the scheduling of the threads.
+class vtkQuadricClusteringTriangleFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkQuadricClustering *Self;
+  vtkPoints *Points;
+  vtkIdType *Polys;
+  vtkIdType *Strips;
+  vtkIdType NumberOfPolys;
+  vtkstd::vector<vtkIdType> RangeStarts; //first cell of each range, and end
+  vtkstd::vector<vtkIdType> Locations;   //of the first cell of each range
+  vtkstd::vector<vtkQuadricClusteringBins> RangeBins;
+
+  void Execute(vtkIdType begin, vtkIdType end, int vtkNotUsed(threadId))
+    {
+    for (vtkIdType range=begin; range < end; range++)
+      {
+      this->ExecuteRange(range);
+      }
+    }
+
+  void ExecuteRange(vtkIdType range)
+    {
+    vtkQuadricClusteringBins &bins = this->RangeBins[range];
+    vtkIdType cellId = this->RangeStarts[range];
+    vtkIdType *cell = (cellId < this->NumberOfPolys ? this->Polys :
+                       this->Strips) + this->Locations[range];
+    double pts[3][3];
+    vtkIdType binIds[3];
+    for ( ; cellId < this->RangeStarts[range+1]; cellId++)
+      {
+      if (cellId == this->NumberOfPolys)
+        {
+        cell = this->Strips;
+        }
+      vtkIdType numPts = cell[0];
+      vtkIdType *ptIds = cell + 1;
+      cell += numPts + 1;
+      if (numPts < 3)
+        {
+        continue;
+        }
+      this->Points->GetPoint(ptIds[0], pts[0]);
+      binIds[0] = this->Self->HashPoint(pts[0]);
+      this->Points->GetPoint(ptIds[1], pts[1]);
+      binIds[1] = this->Self->HashPoint(pts[1]);
+      if (cellId < this->NumberOfPolys)
+        {
+        // a fan of triangles from the first point
+        for (vtkIdType j=2; j < numPts; j++)
+          {
+          this->Points->GetPoint(ptIds[j], pts[2]);
+          binIds[2] = this->Self->HashPoint(pts[2]);
+          this->AddTriangle(bins, binIds, pts);
+          pts[1][0] = pts[2][0];
+          pts[1][1] = pts[2][1];
+          pts[1][2] = pts[2][2];
+          binIds[1] = binIds[2];
+          }
+        }
+      else
+        {
+        // a strip, the triangles replacing their oldest point in turn
+        int odd = 0;
+        for (vtkIdType j=2; j < numPts; j++)
+          {
+          this->Points->GetPoint(ptIds[j], pts[2]);
+          binIds[2] = this->Self->HashPoint(pts[2]);
+          this->AddTriangle(bins, binIds, pts);
+          pts[odd][0] = pts[2][0];
+          pts[odd][1] = pts[2][1];
+          pts[odd][2] = pts[2][2];
+          binIds[odd] = binIds[2];
+          odd = odd ? 0 : 1;
+          }
+        }
+      }
+    }
+
+  void AddTriangle(vtkQuadricClusteringBins &bins, vtkIdType binIds[3],
+                   double pts[3][3])
+    {
+    if (this->Self->UseInternalTriangles == 0 &&
+        (binIds[0] == binIds[1] || binIds[0] == binIds[2] ||
+         binIds[1] == binIds[2]))
+      {
+      return;
+      }
+    double quadric[9];
+    vtkQuadricClusteringTriangleQuadric(pts[0], pts[1], pts[2], quadric);
+    for (int i = 0; i < 3; ++i)
+      {
+      vtkQuadricClusteringAddQuadric(bins[binIds[i]], 2, quadric,
+                                     100000000.0);
+      }
+    }
+
+  void Reduce()
+    {
+    for (size_t range=0; range < this->RangeBins.size(); range++)
+      {
+      vtkQuadricClusteringBins &bins = this->RangeBins[range];
+      for (vtkQuadricClusteringBinsIterator it=bins.begin(); it != bins.end();
+           ++it)
+        {
+        vtkQuadricClusteringAddQuadric((*this->Self->Bins)[it->first],
+                                       it->second.Dimension,
+                                       it->second.Quadric, 1.0);
+        }
+      bins.clear();
+      }
+    }
+};
 
 
 //----------------------------------------------------------------------------
@@ -54,7 +257,7 @@ vtkQuadricClustering::vtkQuadricClustering()
   this->NumberOfXDivisions = 50;
   this->NumberOfYDivisions = 50;
   this->NumberOfZDivisions = 50;
-  this->QuadricArray = NULL;
+  this->Bins = NULL;
   this->NumberOfBinsUsed = 0;
   this->AbortExecute = 0;
 
@@ -78,8 +281,16 @@ vtkQuadricClustering::vtkQuadricClustering()
   this->CellSet = NULL;
   this->NumberOfBins = 0;
 
+  this->NumberOfStreamDivisions = 1;
+  this->CurrentPiece = 0;
+  this->StreamBoundsPass = 0;
+  this->StreamNumberOfPoints = 0;
+  this->StreamStarted = 0;
+  this->NumberOfThreads = 1;
+
   this->OutputTriangleArray = NULL;
   this->OutputLines = NULL;
+  this->OutputVerts = NULL;
 
   // Used for matching boundaries.
   this->FeatureEdges = vtkFeatureEdges::New();
@@ -106,10 +317,10 @@ vtkQuadricClustering::~vtkQuadricClustering()
     delete this->CellSet;
     this->CellSet = NULL;
     }
-  if (this->QuadricArray)
+  if (this->Bins)
     {
-    delete [] this->QuadricArray;
-    this->QuadricArray = NULL;
+    delete this->Bins;
+    this->Bins = NULL;
     }
   if (this->OutputTriangleArray)
     {
@@ -121,11 +332,16 @@ vtkQuadricClustering::~vtkQuadricClustering()
     this->OutputLines->Delete();
     this->OutputLines = NULL;
     }
+  if (this->OutputVerts)
+    {
+    this->OutputVerts->Delete();
+    this->OutputVerts = NULL;
+    }
 }
 
 //----------------------------------------------------------------------------
 int vtkQuadricClustering::RequestData(
-  vtkInformation *vtkNotUsed(request),
+  vtkInformation *request,
   vtkInformationVector **inputVector,
   vtkInformationVector *outputVector)
 {
@@ -145,6 +361,17 @@ int vtkQuadricClustering::RequestData(
 
   vtkTimerLog *tlog=NULL;
 
+  if (this->NumberOfStreamDivisions > 1)
+    {
+    if (input)
+      {
+      return this->RequestStreamedData(request, inInfo, input);
+      }
+    // Stop a stream whose input went missing.
+    request->Remove(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING());
+    this->CurrentPiece = 0;
+    }
+
   if (!input || (input->GetNumberOfPoints() == 0))
     {
     // The user may be calling StartAppend, Append, and EndAppend explicitly.
@@ -163,36 +390,12 @@ int vtkQuadricClustering::RequestData(
     tlog->StartTimer();
     }
 
-  // Lets limit the number of divisions based on 
-  // the number of points in the input.
-  int target = input->GetNumberOfPoints();
-  int numDiv = (this->NumberOfXDivisions * this->NumberOfYDivisions
-                  * this->NumberOfZDivisions) / 2;
-  if (this->AutoAdjustNumberOfDivisions && numDiv > target) 
-    {
-    double factor = pow(((double)numDiv/(double)target),0.33333);
-    this->NumberOfDivisions[0] = 
-      (int)(0.5+(double)(this->NumberOfXDivisions)/factor);  
-    this->NumberOfDivisions[0] = (this->NumberOfDivisions[0] > 0 ? this->NumberOfDivisions[0] : 1);
-    this->NumberOfDivisions[1] = 
-      (int)(0.5+(double)(this->NumberOfYDivisions)/factor);  
-    this->NumberOfDivisions[1] = (this->NumberOfDivisions[1] > 0 ? this->NumberOfDivisions[1] : 1);
-    this->NumberOfDivisions[2] = 
-      (int)(0.5+(double)(this->NumberOfZDivisions)/factor);  
-    this->NumberOfDivisions[2] = (this->NumberOfDivisions[2] > 0 ? this->NumberOfDivisions[2] : 1);
-    }
-  else
-    {
-    this->NumberOfDivisions[0] = this->NumberOfXDivisions;
-    this->NumberOfDivisions[1] = this->NumberOfYDivisions;
-    this->NumberOfDivisions[2] = this->NumberOfZDivisions;
-    }
+  this->AdjustNumberOfDivisions(input->GetNumberOfPoints());
 
   this->UpdateProgress(.01);
 
   this->StartAppend(input->GetBounds());
   this->UpdateProgress(.2);
-  this->SliceSize = this->NumberOfDivisions[0]*this->NumberOfDivisions[1];
 
   this->Append(input);
   if (this->UseFeatureEdges)
@@ -210,10 +413,10 @@ int vtkQuadricClustering::RequestData(
     }
 
   // Free up some memory.
-  if (this->QuadricArray)
+  if (this->Bins)
     {
-    delete [] this->QuadricArray;
-    this->QuadricArray = NULL;
+    delete this->Bins;
+    this->Bins = NULL;
     } 
 
   if ( this->Debug )
@@ -226,6 +429,173 @@ int vtkQuadricClustering::RequestData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkQuadricClustering::RequestStreamedData(vtkInformation *request,
+                                              vtkInformation *inInfo,
+                                              vtkPolyData *input)
+{
+  int numPieces = this->NumberOfStreamDivisions;
+  int i;
+
+  // A stream that was interrupted before its last piece is started over.
+  if (this->CurrentPiece != 0 &&
+      !request->Get(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING()))
+    {
+    this->CurrentPiece = 0;
+    request->Set(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING(), 1);
+    return 1;
+    }
+
+  // On the first piece, get the bounds of the whole input, or prepare to
+  // sweep the pieces for them and for the number of their points.
+  if (this->CurrentPiece == 0)
+    {
+    double *wholeBounds =
+      inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_BOUNDING_BOX());
+    this->StreamBoundsPass = (wholeBounds == NULL ||
+                              wholeBounds[0] > wholeBounds[1] ||
+                              wholeBounds[2] > wholeBounds[3] ||
+                              wholeBounds[4] > wholeBounds[5]);
+    this->StreamNumberOfPoints = 0;
+    this->StreamStarted = 0;
+    for (i = 0; i < 3; ++i)
+      {
+      this->Bounds[2*i] = ( this->StreamBoundsPass ? VTK_DOUBLE_MAX :
+                            wholeBounds[2*i] );
+      this->Bounds[2*i+1] = ( this->StreamBoundsPass ? -VTK_DOUBLE_MAX :
+                              wholeBounds[2*i+1] );
+      }
+    }
+
+  int firstAppended = (this->StreamBoundsPass ? numPieces : 0);
+  if (this->CurrentPiece < firstAppended)
+    {
+    this->StreamNumberOfPoints += input->GetNumberOfPoints();
+    if (input->GetNumberOfPoints() > 0)
+      {
+      double *bounds = input->GetBounds();
+      for (i = 0; i < 3; ++i)
+        {
+        this->Bounds[2*i] = ( bounds[2*i] < this->Bounds[2*i] ?
+                              bounds[2*i] : this->Bounds[2*i] );
+        this->Bounds[2*i+1] = ( bounds[2*i+1] > this->Bounds[2*i+1] ?
+                                bounds[2*i+1] : this->Bounds[2*i+1] );
+        }
+      }
+    }
+  else
+    {
+    if (this->CurrentPiece == firstAppended &&
+        this->Bounds[0] > this->Bounds[1])
+      {
+      // All the pieces are empty.
+      request->Remove(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING());
+      this->CurrentPiece = 0;
+      return 1;
+      }
+    if (!this->StreamStarted && input->GetNumberOfPoints() > 0)
+      {
+      // Without a first pass, the points of the whole input are estimated
+      // from the first piece that has any.
+      this->AdjustNumberOfDivisions(
+        this->StreamBoundsPass ? this->StreamNumberOfPoints :
+        input->GetNumberOfPoints()*numPieces);
+      double bounds[6];
+      for (i = 0; i < 6; ++i)
+        {
+        bounds[i] = this->Bounds[i];
+        }
+      this->StartAppend(bounds);
+      this->StreamStarted = 1;
+      }
+    if (input->GetNumberOfPoints() > 0 && !input->CheckAttributes())
+      {
+      // Cell data is copied from the cells of the current piece.
+      this->InCellCount = 0;
+      this->Append(input);
+      }
+    }
+
+  this->CurrentPiece++;
+  if (this->CurrentPiece < firstAppended + numPieces &&
+      !this->GetAbortExecute())
+    {
+    // There are more pieces to go.
+    request->Set(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING(), 1);
+    return 1;
+    }
+
+  request->Remove(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING());
+  this->CurrentPiece = 0;
+  if (this->StreamStarted)
+    {
+    this->EndAppend();
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkQuadricClustering::RequestUpdateExtent(
+  vtkInformation *request,
+  vtkInformationVector **inputVector,
+  vtkInformationVector *outputVector)
+{
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  if (!inInfo || this->NumberOfStreamDivisions <= 1)
+    {
+    return this->Superclass::RequestUpdateExtent(request, inputVector,
+                                                 outputVector);
+    }
+
+  // Request the current piece of the pieces of the output piece.
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  int outPiece = 0, outNumPieces = 1;
+  if (outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER()))
+    {
+    outPiece = 
+      outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+    outNumPieces = 
+      outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
+    }
+  int numPieces = this->NumberOfStreamDivisions;
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(),
+              outPiece*numPieces + this->CurrentPiece % numPieces);
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(),
+              outNumPieces*numPieces);
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS(),
+              0);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkQuadricClustering::AdjustNumberOfDivisions(vtkIdType numPts)
+{
+  // Lets limit the number of divisions based on 
+  // the number of points in the input.
+  vtkIdType target = (numPts > 0 ? numPts : 1);
+  vtkIdType numDiv = (static_cast<vtkIdType>(this->NumberOfXDivisions) *
+                      this->NumberOfYDivisions * this->NumberOfZDivisions) / 2;
+  if (this->AutoAdjustNumberOfDivisions && numDiv > target) 
+    {
+    double factor = pow(((double)numDiv/(double)target),0.33333);
+    this->NumberOfDivisions[0] = 
+      (int)(0.5+(double)(this->NumberOfXDivisions)/factor);  
+    this->NumberOfDivisions[0] = (this->NumberOfDivisions[0] > 0 ? this->NumberOfDivisions[0] : 1);
+    this->NumberOfDivisions[1] = 
+      (int)(0.5+(double)(this->NumberOfYDivisions)/factor);  
+    this->NumberOfDivisions[1] = (this->NumberOfDivisions[1] > 0 ? this->NumberOfDivisions[1] : 1);
+    this->NumberOfDivisions[2] = 
+      (int)(0.5+(double)(this->NumberOfZDivisions)/factor);  
+    this->NumberOfDivisions[2] = (this->NumberOfDivisions[2] > 0 ? this->NumberOfDivisions[2] : 1);
+    }
+  else
+    {
+    this->NumberOfDivisions[0] = this->NumberOfXDivisions;
+    this->NumberOfDivisions[1] = this->NumberOfYDivisions;
+    this->NumberOfDivisions[2] = this->NumberOfZDivisions;
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkQuadricClustering::StartAppend(double *bounds)
 {
@@ -234,9 +604,8 @@ void vtkQuadricClustering::StartAppend(double *bounds)
   // If there are duplicate triangles. remove them
   if ( this->PreventDuplicateCells )
     {
+    delete this->CellSet;
     this->CellSet = new vtkQuadricClusteringCellSet;
-    this->NumberOfBins = 
-      this->NumberOfDivisions[0]*this->NumberOfDivisions[1]*this->NumberOfDivisions[2];
     }
 
   // Copy over the bounds.
@@ -274,6 +643,8 @@ void vtkQuadricClustering::StartAppend(double *bounds)
     this->DivisionSpacing[1] = (bounds[3]-bounds[2])/this->NumberOfDivisions[1];
     this->DivisionSpacing[2] = (bounds[5]-bounds[4])/this->NumberOfDivisions[2];
     }
+  this->SliceSize = this->NumberOfDivisions[0]*this->NumberOfDivisions[1];
+  this->NumberOfBins = this->SliceSize*this->NumberOfDivisions[2];
 
   // Check for conditions that can occur if the Append methods 
   // are not called in the correct order.
@@ -289,9 +660,15 @@ void vtkQuadricClustering::StartAppend(double *bounds)
     this->OutputLines = NULL;
     //vtkWarningMacro("Array already created.  Did you call EndAppend?");
     }
+  if (this->OutputVerts)
+    {
+    this->OutputVerts->Delete();
+    this->OutputVerts = NULL;
+    }
 
   this->OutputTriangleArray = vtkCellArray::New();
   this->OutputLines = vtkCellArray::New();
+  this->OutputVerts = vtkCellArray::New();
 
   this->XBinSize = (this->Bounds[1]-this->Bounds[0])/this->NumberOfDivisions[0];
   this->YBinSize = (this->Bounds[3]-this->Bounds[2])/this->NumberOfDivisions[1];
@@ -301,21 +678,10 @@ void vtkQuadricClustering::StartAppend(double *bounds)
   this->YBinStep = (this->YBinSize > 0.0) ? (1.0/this->YBinSize) : 0.0;
   this->ZBinStep = (this->ZBinSize > 0.0) ? (1.0/this->ZBinSize) : 0.0;
 
+  // Only the bins visited are stored.
   this->NumberOfBinsUsed = 0;
-  if (this->QuadricArray)
-    {
-    delete [] this->QuadricArray;
-    this->QuadricArray = NULL;
-    }
-  this->QuadricArray = 
-    new vtkQuadricClustering::PointQuadric[this->NumberOfDivisions[0] *
-                                          this->NumberOfDivisions[1] *
-                                          this->NumberOfDivisions[2]];
-  if (this->QuadricArray == NULL)
-    {
-    vtkErrorMacro("Could not allocate quadric grid.");
-    return;
-    }
+  delete this->Bins;
+  this->Bins = new vtkQuadricClusteringBins;
 
   vtkInformation *inInfo = this->GetExecutive()->GetInputInformation(0, 0);
   vtkInformation *outInfo = this->GetExecutive()->GetOutputInformation(0);
@@ -344,7 +710,8 @@ void vtkQuadricClustering::Append(vtkPolyData *pd)
   vtkPoints *inputPoints = pd->GetPoints();
   
   // Check for mis-use of the Append methods.
-  if (this->OutputTriangleArray == NULL || this->OutputLines == NULL)
+  if (this->OutputTriangleArray == NULL || this->OutputLines == NULL ||
+      this->OutputVerts == NULL)
     {
     vtkDebugMacro("Missing Array:  Did you call StartAppend?");
     return;
@@ -369,18 +736,84 @@ void vtkQuadricClustering::Append(vtkPolyData *pd)
     }
   this->UpdateProgress(.60);
 
+  // The quadrics of the triangles may be accumulated on threads first,
+  // the triangles then being added in order.
+  int geometryFlag = 1;
   inputPolys = pd->GetPolys();
+  inputStrips = pd->GetStrips();
+  if (this->NumberOfThreads > 1 && inputPolys && inputStrips)
+    {
+    this->AddTriangleQuadrics(inputPolys, inputStrips, inputPoints);
+    geometryFlag = 2;
+    }
+
   if (inputPolys)
     {
-    this->AddPolygons(inputPolys, inputPoints, 1, pd, output);
+    this->AddPolygons(inputPolys, inputPoints, geometryFlag, pd, output);
     }
   this->UpdateProgress(.80);
 
-  inputStrips = pd->GetStrips();
   if (inputStrips)
     {
-    this->AddStrips(inputStrips, inputPoints, 1, pd, output);
+    this->AddStrips(inputStrips, inputPoints, geometryFlag, pd, output);
     }
+
+  this->AppendVertexGeometry(pd, output);
+}
+
+//----------------------------------------------------------------------------
+void vtkQuadricClustering::AddTriangleQuadrics(vtkCellArray *polys,
+                                               vtkCellArray *strips,
+                                               vtkPoints *points)
+{
+  vtkIdType numPolys = polys->GetNumberOfCells();
+  vtkIdType numCells = numPolys + strips->GetNumberOfCells();
+  if (numCells == 0)
+    {
+    return;
+    }
+
+  vtkQuadricClusteringTriangleFunctor functor;
+  functor.Self = this;
+  functor.Points = points;
+  functor.Polys = polys->GetPointer();
+  functor.Strips = strips->GetPointer();
+  functor.NumberOfPolys = numPolys;
+
+  // Cut the cells into a few ranges per thread and find where each range
+  // starts in its cell array.
+  vtkIdType numRanges = 4*this->NumberOfThreads;
+  if (numRanges > numCells)
+    {
+    numRanges = numCells;
+    }
+  functor.RangeStarts.resize(numRanges+1);
+  functor.Locations.resize(numRanges);
+  functor.RangeBins.resize(numRanges);
+  vtkIdType cellId = 0, loc = 0;
+  vtkIdType *cells = (numPolys > 0 ? functor.Polys : functor.Strips);
+  for (vtkIdType range=0; range < numRanges; range++)
+    {
+    vtkIdType start = range*numCells/numRanges;
+    for ( ; cellId < start; cellId++)
+      {
+      loc += cells[loc] + 1;
+      if (cellId + 1 == numPolys)
+        {
+        cells = functor.Strips;
+        loc = 0;
+        }
+      }
+    functor.RangeStarts[range] = start;
+    functor.Locations[range] = loc;
+    }
+  functor.RangeStarts[numRanges] = numCells;
+
+  vtkParallelFor *parallelFor = vtkParallelFor::New();
+  parallelFor->SetNumberOfThreads(this->NumberOfThreads);
+  parallelFor->SetGrainSize(1);
+  parallelFor->Execute(0, numRanges, &functor);
+  parallelFor->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -481,15 +914,17 @@ inline void vtkQuadricClustering::InitializeQuadric(double quadric[9])
 // triangle and the point.  We ignore constant factors across all coefficents, 
 // and the constant coefficient.
 // If geomertyFlag is 1 then the triangle is added to the output.  Otherwise,
-// only the quadric is affected.
+// only the quadric is affected. If it is 2, the quadric has already been
+// added and only the triangle is.
 void vtkQuadricClustering::AddTriangle(vtkIdType *binIds, double *pt0, double *pt1,
                                        double *pt2, int geometryFlag,
                                        vtkPolyData *input, vtkPolyData *output)
 {
   int i;
   vtkIdType triPtIds[3];
-  double quadric[9], quadric4x4[4][4];
-  vtkIdType minIdx, midIdx, maxIdx, idx;
+  double quadric[9];
+  vtkIdType minIdx, midIdx, maxIdx;
+  vtkQuadricClusteringBin *bins[3];
 
   // Special condition for fast execution.
   // Only add triangles that traverse three bins to quadrics.
@@ -502,31 +937,21 @@ void vtkQuadricClustering::AddTriangle(vtkIdType *binIds, double *pt0, double *p
       }
     }
  
-  // Compute the quadric.
-  vtkTriangle::ComputeQuadric(pt0, pt1, pt2, quadric4x4);
-  quadric[0] = quadric4x4[0][0];
-  quadric[1] = quadric4x4[0][1];
-  quadric[2] = quadric4x4[0][2];
-  quadric[3] = quadric4x4[0][3];
-  quadric[4] = quadric4x4[1][1];
-  quadric[5] = quadric4x4[1][2];
-  quadric[6] = quadric4x4[1][3];
-  quadric[7] = quadric4x4[2][2];
-  quadric[8] = quadric4x4[2][3];
-
-  // Add the quadric to each of the three corner bins.
   for (i = 0; i < 3; ++i)
     {
-    // If the current quadric is not initialized, then clear it out.
-    if (this->QuadricArray[binIds[i]].Dimension > 2)
+    bins[i] = &(*this->Bins)[binIds[i]];
+    }
+
+  if (geometryFlag != 2)
+    {
+    // Compute the quadric.
+    vtkQuadricClusteringTriangleQuadric(pt0, pt1, pt2, quadric);
+
+    // Add the quadric to each of the three corner bins.
+    // Points and segments supercede triangles.
+    for (i = 0; i < 3; ++i)
       {
-      this->QuadricArray[binIds[i]].Dimension = 2; 
-      // Initialize the coeff
-      this->InitializeQuadric(this->QuadricArray[binIds[i]].Quadric);
-      }
-    if (this->QuadricArray[binIds[i]].Dimension == 2)
-      { // Points and segments supercede triangles.
-      this->AddQuadric(binIds[i], quadric);
+      vtkQuadricClusteringAddQuadric(*bins[i], 2, quadric, 100000000.0);
       }
     }
 
@@ -536,12 +961,12 @@ void vtkQuadricClustering::AddTriangle(vtkIdType *binIds, double *pt0, double *p
     for (i = 0; i < 3; i++)
       {
       // Get the vertex from each bin.
-      if (this->QuadricArray[binIds[i]].VertexId == -1)
+      if (bins[i]->VertexId == -1)
         {
-        this->QuadricArray[binIds[i]].VertexId = this->NumberOfBinsUsed;
+        bins[i]->VertexId = this->NumberOfBinsUsed;
         this->NumberOfBinsUsed++;
         }
-      triPtIds[i] = this->QuadricArray[binIds[i]].VertexId;
+      triPtIds[i] = bins[i]->VertexId;
       }
     // This comparison could just as well be on triPtIds.
     if (binIds[0] != binIds[1] && binIds[0] != binIds[2] &&
@@ -592,11 +1017,12 @@ void vtkQuadricClustering::AddTriangle(vtkIdType *binIds, double *pt0, double *p
               }
             break;
           }
-        idx = binIds[minIdx] + this->NumberOfBins*binIds[midIdx] + 
-              this->NumberOfBins*this->NumberOfBins*binIds[maxIdx];
-        if ( this->CellSet->find(idx) == this->CellSet->end() )
+        vtkQuadricClusteringTriangle triangle;
+        triangle.BinIds[0] = binIds[minIdx];
+        triangle.BinIds[1] = binIds[midIdx];
+        triangle.BinIds[2] = binIds[maxIdx];
+        if ( this->CellSet->insert(triangle).second )
           {
-          this->CellSet->insert(idx);
           this->OutputTriangleArray->InsertNextCell(3, triPtIds);
           if (this->CopyCellData && input)
             {
@@ -719,19 +1145,13 @@ void vtkQuadricClustering::AddEdge(vtkIdType *binIds, double *pt0, double *pt1,
   q[7] = length2*(1.0 - d[2]*d[2]);
   q[8] = length2*(d[2]*md - m[2]);
 
+  vtkQuadricClusteringBin *bins[2];
   for (i = 0; i < 2; ++i)
     {
-    // If the current quadric is from triangles (or not initialized), then clear it out.
-    if (this->QuadricArray[binIds[i]].Dimension > 1)
-      {
-      this->QuadricArray[binIds[i]].Dimension = 1; 
-      // Initialize the coeff
-      this->InitializeQuadric(this->QuadricArray[binIds[i]].Quadric);
-      }
-    if (this->QuadricArray[binIds[i]].Dimension == 1)
-      { // Points supercede segements.
-      this->AddQuadric(binIds[i], q);
-      }
+    // If the current quadric is from triangles (or not initialized), then
+    // it is cleared out. Points supercede segements.
+    bins[i] = &(*this->Bins)[binIds[i]];
+    vtkQuadricClusteringAddQuadric(*bins[i], 1, q, 100000000.0);
     }
 
   if (geometryFlag)
@@ -740,12 +1160,12 @@ void vtkQuadricClustering::AddEdge(vtkIdType *binIds, double *pt0, double *pt1,
     for (i = 0; i < 2; i++)
       {
       // Get the vertex from each bin.
-      if (this->QuadricArray[binIds[i]].VertexId == -1)
+      if (bins[i]->VertexId == -1)
         {
-        this->QuadricArray[binIds[i]].VertexId = this->NumberOfBinsUsed;
+        bins[i]->VertexId = this->NumberOfBinsUsed;
         this->NumberOfBinsUsed++;
         }
-      edgePtIds[i] = this->QuadricArray[binIds[i]].VertexId;
+      edgePtIds[i] = bins[i]->VertexId;
       }
     // This comparison could just as well be on edgePtIds.
     if (binIds[0] != binIds[1])
@@ -839,25 +1259,17 @@ void vtkQuadricClustering::AddVertex(vtkIdType binId, double *pt,
   q[8] = -pt[2];
 
   // If the current quadric is from triangles, edges (or not initialized),
-  // then clear it out.
-  if (this->QuadricArray[binId].Dimension > 0)
-    {
-    this->QuadricArray[binId].Dimension = 0; 
-    // Initialize the coeff
-    this->InitializeQuadric(this->QuadricArray[binId].Quadric);
-    }
-  if (this->QuadricArray[binId].Dimension == 0)
-    { // Points supercede all other types of quadrics.
-    this->AddQuadric(binId, q);
-    }
+  // then it is cleared out. Points supercede all other types of quadrics.
+  vtkQuadricClusteringBin &bin = (*this->Bins)[binId];
+  vtkQuadricClusteringAddQuadric(bin, 0, q, 100000000.0);
 
   if (geometryFlag)
     {
     // Now add the vert to the geometry.
     // Get the vertex from the bin.
-    if (this->QuadricArray[binId].VertexId == -1)
+    if (bin.VertexId == -1)
       {
-      this->QuadricArray[binId].VertexId = this->NumberOfBinsUsed;
+      bin.VertexId = this->NumberOfBinsUsed;
       this->NumberOfBinsUsed++;
 
       if (this->CopyCellData && input)
@@ -873,7 +1285,7 @@ void vtkQuadricClustering::AddVertex(vtkIdType binId, double *pt,
 //----------------------------------------------------------------------------
 void vtkQuadricClustering::AddQuadric(vtkIdType binId, double quadric[9])
 {
-  double *q = this->QuadricArray[binId].Quadric;
+  double *q = (*this->Bins)[binId].Quadric;
   
   for (int i=0; i<9; i++)
     {
@@ -929,14 +1341,7 @@ vtkIdType vtkQuadricClustering::HashPoint(double point[3])
 //----------------------------------------------------------------------------
 void vtkQuadricClustering::EndAppend()
 {
-  vtkInformation *inInfo = this->GetExecutive()->GetInputInformation(0, 0);
   vtkInformation *outInfo = this->GetExecutive()->GetOutputInformation(0);
-  vtkPolyData *input = 0;
-  if (inInfo)
-    {
-    input = vtkPolyData::SafeDownCast(
-      inInfo->Get(vtkDataObject::DATA_OBJECT()));
-    }
   vtkPolyData *output = vtkPolyData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
@@ -944,17 +1349,10 @@ void vtkQuadricClustering::EndAppend()
   int abortExecute=0;
   vtkPoints *outputPoints;
   double newPt[3];
-  numBuckets = this->NumberOfDivisions[0] * this->NumberOfDivisions[1] * 
-                this->NumberOfDivisions[2];
-  double step = (double)numBuckets / 10.0;
-  if (step < 1000.0)
-    {
-    step = 1000.0;
-    }
-  double cstep = 0;
   
   // Check for mis use of the Append methods.
-  if (this->OutputTriangleArray == NULL || this->OutputLines == NULL)
+  if (this->OutputTriangleArray == NULL || this->OutputLines == NULL ||
+      this->OutputVerts == NULL)
     {
     vtkDebugMacro("Missing Array:  Did you call StartAppend?");
     return;
@@ -967,9 +1365,18 @@ void vtkQuadricClustering::EndAppend()
     this->CellSet = NULL;
     }
 
-  // Compute the representative points for each bin
+  // Compute the representative points for each bin visited
+  numBuckets = static_cast<vtkIdType>(this->Bins->size());
+  double step = (double)numBuckets / 10.0;
+  if (step < 1000.0)
+    {
+    step = 1000.0;
+    }
+  double cstep = 0;
   outputPoints = vtkPoints::New();
-  for (i = 0; !abortExecute && i < numBuckets; i++ )
+  outputPoints->SetNumberOfPoints(this->NumberOfBinsUsed);
+  vtkQuadricClusteringBinsIterator it = this->Bins->begin();
+  for (i = 0; !abortExecute && it != this->Bins->end(); ++i, ++it)
     {
     if (cstep > step)
       {
@@ -980,10 +1387,10 @@ void vtkQuadricClustering::EndAppend()
       }
     ++cstep;
 
-    if (this->QuadricArray[i].VertexId != -1)
+    if (it->second.VertexId != -1)
       {
-      this->ComputeRepresentativePoint(this->QuadricArray[i].Quadric, i, newPt);
-      outputPoints->InsertPoint(this->QuadricArray[i].VertexId, newPt);
+      this->ComputeRepresentativePoint(it->second.Quadric, it->first, newPt);
+      outputPoints->SetPoint(it->second.VertexId, newPt);
       }
     }
 
@@ -1005,17 +1412,22 @@ void vtkQuadricClustering::EndAppend()
   this->OutputLines->Delete();
   this->OutputLines = NULL;
 
-  this->EndAppendVertexGeometry(input, output);
+  if (this->OutputVerts->GetNumberOfCells() > 0)
+    {
+    output->SetVerts(this->OutputVerts);
+    }
+  this->OutputVerts->Delete();
+  this->OutputVerts = NULL;
 
   // Tell the data is is up to date 
   // (in case the user calls this method directly).
   output->DataHasBeenGenerated();
 
-  // Free the quadric array.
-  if (this->QuadricArray)
+  // Free the bins.
+  if (this->Bins)
     {
-    delete [] this->QuadricArray;
-    this->QuadricArray = NULL;
+    delete this->Bins;
+    this->Bins = NULL;
     }
 }
 
@@ -1265,9 +1677,9 @@ void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData *input,
   vtkIdType   outPtId;
   vtkPoints   *inputPoints;
   vtkPoints   *outputPoints;
-  vtkIdType   numPoints, numBins;
+  vtkIdType   numPoints;
   vtkIdType   binId;
-  double       *minError, e, pt[3];
+  double       e, pt[3];
   double       *q;
 
   inputPoints = input->GetPoints();
@@ -1277,7 +1689,8 @@ void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData *input,
     }
 
   // Check for misuse of the Append methods.
-  if (this->OutputTriangleArray == NULL || this->OutputLines == NULL)
+  if (this->OutputTriangleArray == NULL || this->OutputLines == NULL ||
+      this->OutputVerts == NULL)
     {
     vtkDebugMacro("Missing Array:  Did you call StartAppend?");
     return;
@@ -1296,14 +1709,8 @@ void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData *input,
   output->GetPointData()->
     CopyAllocate(input->GetPointData(), this->NumberOfBinsUsed);
 
-  // Allocate and initialize an array to hold errors for each bin.
-  numBins = this->NumberOfDivisions[0] * this->NumberOfDivisions[1] 
-                  * this->NumberOfDivisions[2];
-  minError = new double[numBins];
-  for (i = 0; i < numBins; ++i)
-    {
-    minError[i] = VTK_DOUBLE_MAX;
-    }
+  // Allocate and initialize an array to hold errors for each output point.
+  vtkstd::vector<double> minError(this->NumberOfBinsUsed, VTK_DOUBLE_MAX);
 
   // Loop through the input points.
   numPoints = inputPoints->GetNumberOfPoints();
@@ -1311,7 +1718,8 @@ void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData *input,
     {
     inputPoints->GetPoint(i, pt);
     binId = this->HashPoint(pt);
-    outPtId = this->QuadricArray[binId].VertexId;
+    vtkQuadricClusteringBinsIterator bin = this->Bins->find(binId);
+    outPtId = (bin == this->Bins->end() ? -1 : bin->second.VertexId);
     // Sanity check.
     if (outPtId == -1)
       {
@@ -1324,13 +1732,13 @@ void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData *input,
     // Compute the error for this point.  Note: the constant term is ignored.
     // It will be the same for every point in this bin, and it
     // is not stored in the quadric array anyway.
-    q = this->QuadricArray[binId].Quadric;
+    q = bin->second.Quadric;
     e = q[0]*pt[0]*pt[0] + 2.0*q[1]*pt[0]*pt[1] + 2.0*q[2]*pt[0]*pt[2] + 2.0*q[3]*pt[0]
           + q[4]*pt[1]*pt[1] + 2.0*q[5]*pt[1]*pt[2] + 2.0*q[6]*pt[1]
           + q[7]*pt[2]*pt[2] + 2.0*q[8]*pt[2];
-    if (e < minError[binId])
+    if (e < minError[outPtId])
       {
-      minError[binId] = e;
+      minError[outPtId] = e;
       outputPoints->InsertPoint(outPtId, pt);
 
       // Since this is the same point as the input point, copy point data here too.
@@ -1351,22 +1759,25 @@ void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData *input,
   this->OutputLines->Delete();
   this->OutputLines = NULL;
 
-  this->EndAppendVertexGeometry(input, output);
-
-  if (this->QuadricArray)
+  if (this->OutputVerts->GetNumberOfCells() > 0)
     {
-    delete [] this->QuadricArray;
-    this->QuadricArray = NULL;
+    output->SetVerts(this->OutputVerts);
     }
+  this->OutputVerts->Delete();
+  this->OutputVerts = NULL;
 
-  delete [] minError;
+  if (this->Bins)
+    {
+    delete this->Bins;
+    this->Bins = NULL;
+    }
 }
 
 //----------------------------------------------------------------------------
 // This is not a perfect implementation, because it does not determine
 // which vertex cell is the best for a bin.  The first detected is used.
-void vtkQuadricClustering::EndAppendVertexGeometry(vtkPolyData *input,
-                                                   vtkPolyData *output)
+void vtkQuadricClustering::AppendVertexGeometry(vtkPolyData *input,
+                                                vtkPolyData *output)
 {
   vtkCellArray *inVerts, *outVerts;
   vtkIdType *tmp = NULL;
@@ -1376,11 +1787,10 @@ void vtkQuadricClustering::EndAppendVertexGeometry(vtkPolyData *input,
   int j;
   vtkIdType *ptIds = 0;
   vtkIdType numPts = 0;
-  vtkIdType outPtId;
   vtkIdType binId, cellId, outCellId;
 
   inVerts = input->GetVerts();
-  outVerts = vtkCellArray::New();
+  outVerts = this->OutputVerts;
 
   for (cellId=0, inVerts->InitTraversal(); inVerts->GetNextCell(numPts, ptIds); cellId++)
     {
@@ -1398,12 +1808,13 @@ void vtkQuadricClustering::EndAppendVertexGeometry(vtkPolyData *input,
       {
       input->GetPoint(ptIds[j], pt);
       binId = this->HashPoint(pt);
-      outPtId = this->QuadricArray[binId].VertexId;
-      if (outPtId >= 0)
+      vtkQuadricClusteringBinsIterator bin = this->Bins->find(binId);
+      if (bin != this->Bins->end() && bin->second.VertexId >= 0 &&
+          !bin->second.UsedByVertex)
         {
-        // Do not use this point.  Destroy infomration in Quadric array.
-        this->QuadricArray[binId].VertexId = -1;
-        tmp[tmpIdx] = outPtId;
+        // Do not use this point for another vertex cell.
+        bin->second.UsedByVertex = 1;
+        tmp[tmpIdx] = bin->second.VertexId;
         ++tmpIdx;
         }
       }
@@ -1420,12 +1831,6 @@ void vtkQuadricClustering::EndAppendVertexGeometry(vtkPolyData *input,
     {
     delete [] tmp;
     }
-
-  if (outVerts->GetNumberOfCells() > 0)
-    {
-    output->SetVerts(outVerts);
-    }
-  outVerts->Delete();
 }
 
 
@@ -1619,5 +2024,8 @@ void vtkQuadricClustering::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Prevent Duplicate Cells : " 
      << (this->PreventDuplicateCells ? "On\n" : "Off\n");
+  os << indent << "Number Of Stream Divisions: "
+     << this->NumberOfStreamDivisions << "\n";
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
 }
 
@@ -56,7 +56,19 @@
 // this approach does not fit into the visualization architecture and requires
 // manual control, it has the advantage that extremely large data can be 
 // processed in pieces and appended to the filter piece-by-piece.
-
+//
+// The same can be done within the pipeline by setting
+// NumberOfStreamDivisions: the filter then requests its input in that many
+// pieces, one after the other, and appends each of them. The bounds of the
+// whole model are taken from the WHOLE_BOUNDING_BOX the input provides, or,
+// if it provides none, from a first pass over the pieces, which also counts
+// their points for AutoAdjustNumberOfDivisions. With the bounds known, each
+// piece is read once and the number of points is estimated from the first
+// piece that has any. Only the bins visited are stored, in a hash table
+// keyed by bin id, so the memory used grows with the size of the output
+// rather than with that of the input or of the grid. The quadrics of the
+// triangles can also be accumulated on several threads, see
+// NumberOfThreads.
 
 // .SECTION Caveats
 // This filter can drastically affect topology, i.e., topology is not 
@@ -85,6 +97,7 @@
 class vtkCellArray;
 class vtkFeatureEdges;
 class vtkPoints;
+class vtkQuadricClusteringBins;
 class vtkQuadricClusteringCellSet;
 
 
@@ -213,13 +226,43 @@ public:
   vtkGetMacro(PreventDuplicateCells,int);
   vtkBooleanMacro(PreventDuplicateCells,int);
 
+  // Description:
+  // Set/Get the number of pieces the input is requested in. When larger
+  // than 1, the filter streams its input: each piece is updated and
+  // appended in turn, and only the bins visited are kept in memory.
+  // UseInputPoints and UseFeatureEdges are ignored when streaming, and
+  // cell data is copied from each piece. The default is 1.
+  vtkSetClampMacro(NumberOfStreamDivisions,int,1,VTK_LARGE_INTEGER);
+  vtkGetMacro(NumberOfStreamDivisions,int);
+
+  // Description:
+  // Set/Get the number of threads the quadrics of the polygons and strips
+  // are accumulated on. The triangles are still added to the output in
+  // order, so the output is the same for any number of threads up to the
+  // rounding of the sums of the quadrics. The default is 1.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
 protected:
   vtkQuadricClustering();
   ~vtkQuadricClustering();
 
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
+  int RequestUpdateExtent(vtkInformation *, vtkInformationVector **,
+                          vtkInformationVector *);
   int FillInputPortInformation(int, vtkInformation *);
 
+  // Description:
+  // Append the current piece of a streamed input, starting the append on
+  // the first piece and ending it on the last one.
+  int RequestStreamedData(vtkInformation *request, vtkInformation *inInfo,
+                          vtkPolyData *input);
+
+  // Description:
+  // Limit the number of divisions based on the number of input points
+  // when AutoAdjustNumberOfDivisions is on.
+  void AdjustNumberOfDivisions(vtkIdType numPts);
+
   // Description:
   // Given a point, determine what bin it falls into.
   vtkIdType HashPoint(double point[3]);
@@ -231,7 +274,8 @@ protected:
 
   // Description:
   // Add triangles to the quadric array.  If geometry flag is on then
-  // triangles are added to the output.
+  // triangles are added to the output. If it is 2, only the triangles are
+  // added, their quadrics having been accumulated by AddTriangleQuadrics().
   void AddPolygons(vtkCellArray *polys, vtkPoints *points, int geometryFlag,
                    vtkPolyData *input, vtkPolyData *output);
   void AddStrips(vtkCellArray *strips, vtkPoints *points, int geometryFlag,
@@ -239,6 +283,12 @@ protected:
   void AddTriangle(vtkIdType *binIds, double *pt0, double *pt1, double *pt2,
                    int geometeryFlag, vtkPolyData *input, vtkPolyData *output);
 
+  // Description:
+  // Add the quadrics of the triangles of polygons and strips to the
+  // quadric array on NumberOfThreads threads.
+  void AddTriangleQuadrics(vtkCellArray *polys, vtkCellArray *strips,
+                           vtkPoints *points);
+
   // Description:
   // Add edges to the quadric array.  If geometry flag is on then
   // edges are added to the output.
@@ -278,9 +328,9 @@ protected:
   int UseInputPoints;
 
   // Description:
-  // This method sets the verticies of the output.
+  // This method adds the vertex cells of an appended input to the output.
   // It duplicates the structure of the input cells (but decimiated).
-  void EndAppendVertexGeometry(vtkPolyData *input, vtkPolyData *output);
+  void AppendVertexGeometry(vtkPolyData *input, vtkPolyData *output);
 
   // Unfinished option to handle boundary edges differently.
   void AppendFeatureQuadrics(vtkPolyData *pd, vtkPolyData *output);
@@ -297,6 +347,13 @@ protected:
   vtkQuadricClusteringCellSet *CellSet; //PIMPLd stl set for tracking inserted cells
   vtkIdType NumberOfBins;
 
+  int NumberOfStreamDivisions;
+  int CurrentPiece;     //the piece appended next when streaming
+  int StreamBoundsPass; //set when the pieces are first swept for bounds
+  vtkIdType StreamNumberOfPoints; //points of the pieces swept
+  int StreamStarted;    //set once the first piece is appended
+  int NumberOfThreads;
+
   // Used internally.
   // can be smaller than user values when input numb er of points is small.
   int NumberOfDivisions[3];
@@ -319,27 +376,14 @@ protected:
   double ZBinStep;
   vtkIdType SliceSize; //eliminate one multiplication
 
-  //BTX
-  struct PointQuadric 
-  {
-    PointQuadric():VertexId(-1),Dimension(255) {}
-    
-    vtkIdType VertexId;
-    // Dimension is supposed to be a flag representing the dimension of the
-    // cells contributing to the quadric.  Lines: 1, Triangles: 2 (and points
-    // 0 in the future?)
-    unsigned char Dimension;
-    double Quadric[9];
-  };
-  //ETX
-
-  PointQuadric* QuadricArray;
+  vtkQuadricClusteringBins *Bins; //PIMPLd hash of the bins visited
   vtkIdType NumberOfBinsUsed;
 
   // Have to make these instance variables if we are going to allow
   // the algorithm to be driven by the Append methods.
   vtkCellArray *OutputTriangleArray;
   vtkCellArray *OutputLines;
+  vtkCellArray *OutputVerts;
 
   vtkFeatureEdges *FeatureEdges;
   vtkPoints *FeaturePoints;
@@ -350,6 +394,10 @@ protected:
   int OutCellCount;
 
 private:
+  //BTX
+  friend class vtkQuadricClusteringTriangleFunctor;
+  //ETX
+
   vtkQuadricClustering(const vtkQuadricClustering&);  // Not implemented.
   void operator=(const vtkQuadricClustering&);  // Not implemented.
 };
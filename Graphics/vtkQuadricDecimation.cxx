@@ -42,7 +42,6 @@
 #include "vtkQuadricDecimation.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
-#include "vtkEdgeTable.h"
 #include "vtkDoubleArray.h"
 #include "vtkGenericCell.h"
 #include "vtkIdList.h"
@@ -50,23 +49,332 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkParallelFor.h"
 #include "vtkPolyData.h"
 #include "vtkPointData.h"
-#include "vtkPriorityQueue.h"
 #include "vtkTriangle.h"
 
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
 vtkCxxRevisionMacro(vtkQuadricDecimation, "$Revision$");
 vtkStandardNewMacro(vtkQuadricDecimation);
 
+//----------------------------------------------------------------------------
+// The edges of the mesh. Each edge stores its two end points, and the edges
+// of a point are linked into a list through the edges themselves, so that
+// no per point storage is needed beyond the first edge of the list.
+class vtkQuadricDecimationEdges
+{
+public:
+  vtkstd::vector<vtkIdType> Points; //end points of edge e at 2*e and 2*e+1
+  vtkstd::vector<vtkIdType> Next;   //next edge in the list of Points[i] at i
+  vtkstd::vector<vtkIdType> First;  //first edge of each point, or -1
+
+  void Initialize(vtkIdType numPts)
+    {
+    vtkstd::vector<vtkIdType>().swap(this->Points);
+    vtkstd::vector<vtkIdType>().swap(this->Next);
+    vtkstd::vector<vtkIdType>(numPts, -1).swap(this->First);
+    }
+
+  vtkIdType GetNumberOfEdges()
+    {
+    return static_cast<vtkIdType>(this->Points.size() / 2);
+    }
+
+  // The link following this edge in the list of one of its end points.
+  vtkIdType &GetNext(vtkIdType edgeId, vtkIdType ptId)
+    {
+    return this->Next[2*edgeId + (this->Points[2*edgeId] == ptId ? 0 : 1)];
+    }
+
+  vtkIdType GetOtherPoint(vtkIdType edgeId, vtkIdType ptId)
+    {
+    return this->Points[2*edgeId + (this->Points[2*edgeId] == ptId ? 1 : 0)];
+    }
+
+  // Return the id of the edge between the points, or -1.
+  vtkIdType IsEdge(vtkIdType p1, vtkIdType p2)
+    {
+    for (vtkIdType edgeId = this->First[p1]; edgeId >= 0;
+         edgeId = this->GetNext(edgeId, p1))
+      {
+      if (this->GetOtherPoint(edgeId, p1) == p2)
+        {
+        return edgeId;
+        }
+      }
+    return -1;
+    }
+
+  vtkIdType InsertEdge(vtkIdType p1, vtkIdType p2)
+    {
+    vtkIdType edgeId = this->GetNumberOfEdges();
+    this->Points.push_back(p1);
+    this->Points.push_back(p2);
+    this->Next.push_back(this->First[p1]);
+    this->Next.push_back(this->First[p2]);
+    this->First[p1] = this->First[p2] = edgeId;
+    return edgeId;
+    }
+
+  // Unlink the edge from the list of one of its end points.
+  void RemoveEdge(vtkIdType edgeId, vtkIdType ptId)
+    {
+    vtkIdType *link = &this->First[ptId];
+    while (*link != edgeId)
+      {
+      link = &this->GetNext(*link, ptId);
+      }
+    *link = this->GetNext(edgeId, ptId);
+    }
+};
+
+//----------------------------------------------------------------------------
+// A binary heap of edges ordered by cost. Each entry is stamped with the
+// round it is queued in, a round ending with each edge popped, and its edge
+// id, as Round*NumberOfEdges + EdgeId. The stamp of the queued entry of each
+// edge is kept aside: an edge queued again or deleted gets a new stamp, or
+// none, without touching the heap, and its older entries are discarded when
+// they reach the top. The heap is rebuilt without them when they become the
+// majority.
+//
+// Edges of equal cost come out in order of stamp: by round, then by id. This
+// order does not depend on how the heap happens to be laid out. The rounds
+// keep the edges queued again after a collapse behind those of equal cost
+// already waiting: in a flat region every edge costs nothing, and ordering
+// by id alone would collapse the whole region into one point, one edge
+// after the other.
+class vtkQuadricDecimationQueue
+{
+public:
+  struct Entry
+  {
+    double Cost;
+    vtkTypeInt64 Stamp;
+    vtkIdType EdgeId;
+  };
+
+  vtkstd::vector<Entry> Heap;
+  vtkstd::vector<vtkTypeInt64> Stamps; //the stamp of the queued entry, or 0
+  vtkTypeInt64 Round;
+
+  vtkQuadricDecimationQueue()
+    {
+    this->Round = 1;
+    }
+
+  vtkTypeInt64 GetStamp(vtkIdType edgeId)
+    {
+    return this->Round*static_cast<vtkTypeInt64>(this->Stamps.size()) + edgeId;
+    }
+
+  static bool Greater(const Entry &a, const Entry &b)
+    {
+    return a.Cost > b.Cost || (a.Cost == b.Cost && a.Stamp > b.Stamp);
+    }
+
+  // Queue all the edges with the given costs.
+  void Initialize(vtkIdType numEdges, const double *costs)
+    {
+    this->Round = 1;
+    vtkstd::vector<vtkTypeInt64>(numEdges).swap(this->Stamps);
+    vtkstd::vector<Entry>(numEdges).swap(this->Heap);
+    for (vtkIdType edgeId=0; edgeId < numEdges; edgeId++)
+      {
+      this->Heap[edgeId].Cost = costs[edgeId];
+      this->Heap[edgeId].Stamp = this->Stamps[edgeId] = this->GetStamp(edgeId);
+      this->Heap[edgeId].EdgeId = edgeId;
+      }
+    vtkstd::make_heap(this->Heap.begin(), this->Heap.end(), Greater);
+    }
+
+  // An edge is queued at most once per round, so its stamp tells its
+  // entries apart.
+  void Insert(double cost, vtkIdType edgeId)
+    {
+    if (this->Heap.size() > 2*this->Stamps.size() + 1024)
+      {
+      this->Compact();
+      }
+    Entry entry;
+    entry.Cost = cost;
+    entry.Stamp = this->Stamps[edgeId] = this->GetStamp(edgeId);
+    entry.EdgeId = edgeId;
+    this->Heap.push_back(entry);
+    vtkstd::push_heap(this->Heap.begin(), this->Heap.end(), Greater);
+    }
+
+  void DeleteId(vtkIdType edgeId)
+    {
+    this->Stamps[edgeId] = 0;
+    }
+
+  // Remove the cheapest edge and return its id, or -1 if none is left.
+  vtkIdType Pop(double &cost)
+    {
+    while (!this->Heap.empty())
+      {
+      vtkstd::pop_heap(this->Heap.begin(), this->Heap.end(), Greater);
+      Entry entry = this->Heap.back();
+      this->Heap.pop_back();
+      if (entry.Stamp == this->Stamps[entry.EdgeId])
+        {
+        this->Stamps[entry.EdgeId] = 0;
+        ++this->Round;
+        cost = entry.Cost;
+        return entry.EdgeId;
+        }
+      }
+    return -1;
+    }
+
+  void Compact()
+    {
+    size_t numEntries = 0;
+    for (size_t i=0; i < this->Heap.size(); i++)
+      {
+      if (this->Heap[i].Stamp == this->Stamps[this->Heap[i].EdgeId])
+        {
+        this->Heap[numEntries++] = this->Heap[i];
+        }
+      }
+    this->Heap.resize(numEntries);
+    vtkstd::make_heap(this->Heap.begin(), this->Heap.end(), Greater);
+    }
+};
+
+//----------------------------------------------------------------------------
+// Computes the quadrics of a range of points by summing those of the
+// triangles using them. The triangles of a point are found from its links,
+// in order of increasing id, so that the sums are those of a serial
+// traversal of the triangles whatever the number of threads.
+class vtkQuadricDecimationQuadricFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkQuadricDecimation *Self;
+  vtkstd::vector<vtkstd::vector<double> > QEMs; //per thread
+  vtkstd::vector<int> Failed;                   //per thread
+
+  void Initialize(int numThreads)
+    {
+    this->QEMs.resize(numThreads);
+    for (int i=0; i < numThreads; i++)
+      {
+      this->QEMs[i].resize(11 + 4 * this->Self->NumberOfComponents);
+      }
+    this->Failed.assign(numThreads, 0);
+    }
+
+  void Execute(vtkIdType begin, vtkIdType end, int threadId)
+    {
+    vtkPolyData *mesh = this->Self->Mesh;
+    int size = 11 + 4 * this->Self->NumberOfComponents;
+    double *QEM = &this->QEMs[threadId][0];
+    unsigned short ncells;
+    vtkIdType *cells, npts, *pts;
+    double area;
+    int i, j, k;
+    for (vtkIdType ptId=begin; ptId < end; ptId++)
+      {
+      double *quadric = this->Self->ErrorQuadrics[ptId].Quadric;
+      for (j = 0; j < size; j++)
+        {
+        quadric[j] = 0.0;
+        }
+      mesh->GetPointCells(ptId, ncells, cells);
+      for (i = 0; i < ncells; i++)
+        {
+        // a triangle using a point twice is linked to it twice
+        if (i > 0 && cells[i] == cells[i-1])
+          {
+          continue;
+          }
+        mesh->GetCellPoints(cells[i], npts, pts);
+        if (!this->Self->ComputeTriangleQuadric(pts, QEM, area))
+          {
+          this->Failed[threadId] = 1;
+          }
+        for (k = 0; k < 3; k++)
+          {
+          if (pts[k] == ptId)
+            {
+            for (j = 0; j < size; j++)
+              {
+              quadric[j] += QEM[j] * area;
+              }
+            }
+          }
+        }
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Computes the cost of and target point for collapsing a range of edges,
+// with temporary arrays for each thread.
+class vtkQuadricDecimationCostFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkQuadricDecimation *Self;
+  double *Costs;
+  double *TargetPoints;
+  vtkstd::vector<vtkstd::vector<double> > TempQuad;
+  vtkstd::vector<vtkstd::vector<double> > TempB;
+  vtkstd::vector<vtkstd::vector<double> > TempData;
+  vtkstd::vector<vtkstd::vector<double*> > TempA;
+
+  void Initialize(int numThreads)
+    {
+    int dim = 3 + this->Self->NumberOfComponents;
+    this->TempQuad.resize(numThreads);
+    this->TempB.resize(numThreads);
+    this->TempData.resize(numThreads);
+    this->TempA.resize(numThreads);
+    for (int i=0; i < numThreads; i++)
+      {
+      this->TempQuad[i].resize(11 + 4 * this->Self->NumberOfComponents);
+      this->TempB[i].resize(dim);
+      this->TempData[i].resize(dim*dim);
+      this->TempA[i].resize(dim);
+      for (int j=0; j < dim; j++)
+        {
+        this->TempA[i][j] = &this->TempData[i][j*dim];
+        }
+      }
+    }
+
+  void Execute(vtkIdType begin, vtkIdType end, int threadId)
+    {
+    int dim = 3 + this->Self->NumberOfComponents;
+    double *tempQuad = &this->TempQuad[threadId][0];
+    for (vtkIdType edgeId=begin; edgeId < end; edgeId++)
+      {
+      double *x = this->TargetPoints + dim*edgeId;
+      if (this->Self->AttributeErrorMetric)
+        {
+        this->Costs[edgeId] =
+          this->Self->ComputeCost2(edgeId, x, tempQuad,
+                                   &this->TempA[threadId][0],
+                                   &this->TempB[threadId][0]);
+        }
+      else
+        {
+        this->Costs[edgeId] = this->Self->ComputeCost(edgeId, x, tempQuad);
+        }
+      }
+    }
+};
+
 
 //----------------------------------------------------------------------------
 vtkQuadricDecimation::vtkQuadricDecimation()
 {
-  this->Edges = vtkEdgeTable::New();
-  this->EdgeCosts = vtkPriorityQueue::New();
-  this->EndPoint1List = vtkIdList::New();
-  this->EndPoint2List = vtkIdList::New();
+  this->Edges = new vtkQuadricDecimationEdges;
+  this->EdgeCosts = new vtkQuadricDecimationQueue;
   this->ErrorQuadrics = NULL;
+  this->ErrorQuadricData = NULL;
   this->TargetPoints = vtkDoubleArray::New();
   
   this->TargetReduction = 0.9;
@@ -87,15 +395,14 @@ vtkQuadricDecimation::vtkQuadricDecimation()
   this->TensorsWeight = 0.1;
 
   this->ActualReduction = 0.0;
+  this->NumberOfThreads = 1;
 }
 
 //----------------------------------------------------------------------------
 vtkQuadricDecimation::~vtkQuadricDecimation()
 {
-  this->Edges->Delete();
-  this->EdgeCosts->Delete();
-  this->EndPoint1List->Delete();
-  this->EndPoint2List->Delete();
+  delete this->Edges;
+  delete this->EdgeCosts;
   this->TargetPoints->Delete();
 }
 
@@ -188,7 +495,7 @@ int vtkQuadricDecimation::RequestData(
 
   vtkIdType numPts = input->GetNumberOfPoints();
   vtkIdType numTris = input->GetNumberOfPolys();
-  vtkIdType edgeId, i;
+  vtkIdType edgeId, i, p1, p2;
   int j;
   double cost;
   double *x;
@@ -241,23 +548,22 @@ int vtkQuadricDecimation::RequestData(
     new vtkQuadricDecimation::ErrorQuadric[numPts];
   
   vtkDebugMacro(<<"Computing Edges");
-  this->Edges->InitEdgeInsertion(numPts, 1); // storing edge id as attribute
-  this->EdgeCosts->Allocate(this->Mesh->GetPolys()->GetNumberOfCells() * 3);
+  this->Edges->Initialize(numPts);
+  this->Edges->Points.reserve(this->Mesh->GetNumberOfCells() * 3);
+  this->Edges->Next.reserve(this->Mesh->GetNumberOfCells() * 3);
   for (i = 0; i <  this->Mesh->GetNumberOfCells(); i++) 
     {
     this->Mesh->GetCellPoints(i, npts, pts); 
       
     for (j = 0; j < 3; j++)
       {
-      if (this->Edges->IsEdge(pts[j], pts[(j+1)%3]) == -1)
+      // If this edge has not been processed, add it with its end points in
+      // the order of this triangle.
+      p1 = pts[j];
+      p2 = pts[(j+1)%3];
+      if (p1 != p2 && this->Edges->IsEdge(p1, p2) == -1)
         {
-        // If this edge has not been processed, get an id for it, add it to
-        // the edge list (Edges), and add its endpoints to the EndPoint1List
-        // and EndPoint2List (the 2 endpoints to different lists).
-        edgeId = this->Edges->GetNumberOfEdges();
-        this->Edges->InsertEdge(pts[j], pts[(j+1)%3], edgeId);
-        this->EndPoint1List->InsertId(edgeId, pts[j]);
-        this->EndPoint2List->InsertId(edgeId, pts[(j+1)%3]);
+        this->Edges->InsertEdge(p1, p2);
         }
       }
     }
@@ -289,26 +595,13 @@ int vtkQuadricDecimation::RequestData(
   this->UpdateProgress(0.15);
   
   vtkDebugMacro(<<"Computing Costs");
-  // Compute the cost of and target point for collapsing each edge.
-  for (i = 0; i < this->Edges->GetNumberOfEdges(); i++)
-    {
-    if (this->AttributeErrorMetric) 
-      {
-      cost = this->ComputeCost2(i, x);
-      }
-    else
-      {
-      cost = this->ComputeCost(i, x);
-      }
-    this->EdgeCosts->Insert(cost, i);
-    this->TargetPoints->InsertTuple(i, x);
-    }
+  this->InitializeCosts();
   this->UpdateProgress(0.20);
 
   // Okay collapse edges until desired reduction is reached
   this->ActualReduction = 0.0;
   this->NumberOfEdgeCollapses = 0;
-  edgeId = this->EdgeCosts->Pop(0,cost);
+  edgeId = this->EdgeCosts->Pop(cost);
 
   int abort = 0;
   while ( !abort && edgeId >= 0 && cost < VTK_DOUBLE_MAX &&
@@ -321,8 +614,8 @@ int vtkQuadricDecimation::RequestData(
       abort = this->GetAbortExecute();
       }
 
-    endPtIds[0] = this->EndPoint1List->GetId(edgeId);
-    endPtIds[1] = this->EndPoint2List->GetId(edgeId);
+    endPtIds[0] = this->Edges->Points[2*edgeId];
+    endPtIds[1] = this->Edges->Points[2*edgeId+1];
     this->TargetPoints->GetTuple(edgeId, x);
 
     // check for a poorly placed point
@@ -333,7 +626,7 @@ int vtkQuadricDecimation::RequestData(
       // when it is recomputed it will be reconsidered
       this->EdgeCosts->Insert(VTK_DOUBLE_MAX, edgeId);
 
-      edgeId = this->EdgeCosts->Pop(0, cost);
+      edgeId = this->EdgeCosts->Pop(cost);
       continue;
       }
     
@@ -352,19 +645,20 @@ int vtkQuadricDecimation::RequestData(
     // Update the output triangles.
     numDeletedTris += this->CollapseEdge(endPtIds[0], endPtIds[1]);
     this->ActualReduction = (double) numDeletedTris / numTris;
-    edgeId = this->EdgeCosts->Pop(0, cost);
+    edgeId = this->EdgeCosts->Pop(cost);
     }
 
   vtkDebugMacro(<<"Number Of Edge Collapses: "
                 << this->NumberOfEdgeCollapses << " Cost: " << cost);
 
   // clean up working data
-  for (i = 0; i < numPts; i++)
-    {
-    delete [] this->ErrorQuadrics[i].Quadric;
-    }
+  delete [] this->ErrorQuadricData;
+  this->ErrorQuadricData = NULL;
   delete [] this->ErrorQuadrics;
+  this->ErrorQuadrics = NULL;
   delete [] x;
+  this->Edges->Initialize(0);
+  this->EdgeCosts->Initialize(0, NULL);
   this->CollapseCellIds->Delete();
   delete [] this->TempX;
   delete [] this->TempQuad;
@@ -409,15 +703,43 @@ int vtkQuadricDecimation::RequestData(
 //----------------------------------------------------------------------------
 void vtkQuadricDecimation::InitializeQuadrics(vtkIdType numPts)
 {
-  vtkPolyData *input = this->Mesh;
-  double *QEM;
   vtkIdType ptId;
-  int i, j;
-  vtkCellArray *polys;
-  vtkIdType npts, *pts=NULL;
+  int size = 11 + 4 * this->NumberOfComponents;
+
+  // allocate the global QEM array in one block
+  this->ErrorQuadricData = new double[numPts * size];
+  for (ptId = 0; ptId < numPts; ptId++) 
+    {
+    this->ErrorQuadrics[ptId].Quadric = this->ErrorQuadricData + ptId * size;
+    }
+
+  // sum the QEM of the faces at each point
+  vtkQuadricDecimationQuadricFunctor functor;
+  functor.Self = this;
+  vtkParallelFor *parallelFor = vtkParallelFor::New();
+  parallelFor->SetNumberOfThreads(this->NumberOfThreads);
+  parallelFor->Execute(0, numPts, &functor);
+  parallelFor->Delete();
+
+  for (size_t i = 0; i < functor.Failed.size(); i++)
+    {
+    if (functor.Failed[i])
+      {
+      vtkErrorMacro(<<"Unable to factor attribute matrix!");
+      break;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkQuadricDecimation::ComputeTriangleQuadric(vtkIdType *pts, double *QEM,
+                                                 double &area)
+{
+  vtkPolyData *input = this->Mesh;
+  int i;
   double point0[3], point1[3], point2[3];
   double n[3];
-  double tempP1[3], tempP2[3],  d, triArea2;
+  double tempP1[3], tempP2[3],  d;
   double data[16];
   double *A[4], x[4];
   int index[4];
@@ -426,146 +748,140 @@ void vtkQuadricDecimation::InitializeQuadrics(vtkIdType numPts)
   A[2] = data+8;
   A[3] = data+12;
 
-  // allocate local QEM sparce matrix
-  QEM = new double[11 + 4 * this->NumberOfComponents];
-
-  // clear and allocate global QEM array
-  for (ptId = 0; ptId < numPts; ptId++) 
+  input->GetPoint(pts[0], point0);
+  input->GetPoint(pts[1], point1);
+  input->GetPoint(pts[2], point2);
+  for (i = 0; i < 3; i++)
     {
-    this->ErrorQuadrics[ptId].Quadric =
-      new double[11 + 4 * this->NumberOfComponents];
-    for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
-      {
-      this->ErrorQuadrics[ptId].Quadric[i] = 0.0;
-      }
+    tempP1[i] = point1[i] - point0[i];
+    tempP2[i] = point2[i] - point0[i];
     }
+  vtkMath::Cross(tempP1, tempP2, n);
+  area = vtkMath::Normalize(n);
+  //area = (area * area * 0.25);
+  area = area * 0.5;
+  // I am unsure whether this should be squared or not??
+  d = -vtkMath::Dot(n, point0);
+  // could possible add in angle weights??
+
+  // set the geometric part of the QEM
+  QEM[0] = n[0] * n[0];
+  QEM[1] = n[0] * n[1];
+  QEM[2] = n[0] * n[2];
+  QEM[3] = d * n[0];
+
+  QEM[4] = n[1] * n[1];
+  QEM[5] = n[1] * n[2];
+  QEM[6] = d * n[1];
+
+  QEM[7] = n[2] * n[2];
+  QEM[8] = d * n[2];
+
+  QEM[9] = d * d;
+  QEM[10] = 1;
   
-  polys = input->GetPolys();
-  // compute the QEM for each face
-  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); ) 
-    {
-    input->GetPoint(pts[0], point0);
-    input->GetPoint(pts[1], point1);
-    input->GetPoint(pts[2], point2);
-    for (i = 0; i < 3; i++)
+  if (this->AttributeErrorMetric) 
+    {
+    for (i = 0; i < 3; i++) 
       {
-      tempP1[i] = point1[i] - point0[i];
-      tempP2[i] = point2[i] - point0[i];
-      }
-    vtkMath::Cross(tempP1, tempP2, n);
-    triArea2 = vtkMath::Normalize(n);
-    //triArea2 = (triArea2 * triArea2 * 0.25);
-    triArea2 = triArea2 * 0.5;
-    // I am unsure whether this should be squared or not??
-    d = -vtkMath::Dot(n, point0);
-    // could possible add in angle weights??
-
-    // set the geometric part of the QEM
-    QEM[0] = n[0] * n[0];
-    QEM[1] = n[0] * n[1];
-    QEM[2] = n[0] * n[2];
-    QEM[3] = d * n[0];
-
-    QEM[4] = n[1] * n[1];
-    QEM[5] = n[1] * n[2];
-    QEM[6] = d * n[1];
-
-    QEM[7] = n[2] * n[2];
-    QEM[8] = d * n[2];
-
-    QEM[9] = d * d;
-    QEM[10] = 1;
-    
-    if (this->AttributeErrorMetric) 
+      A[0][i] = point0[i];
+      A[1][i] = point1[i];
+      A[2][i] = point2[i];
+      A[3][i] = n[i];
+      }       
+    A[0][3] =  A[1][3] = A[2][3] = 1;
+    A[3][3] = 0;
+
+    // should handle poorly condition matrix better
+    if (vtkMath::LUFactorLinearSystem(A, index, 4))
       {
-      for (i = 0; i < 3; i++) 
-        {
-        A[0][i] = point0[i];
-        A[1][i] = point1[i];
-        A[2][i] = point2[i];
-        A[3][i] = n[i];
-        }       
-      A[0][3] =  A[1][3] = A[2][3] = 1;
-      A[3][3] = 0;
-
-      // should handle poorly condition matrix better
-      if (vtkMath::LUFactorLinearSystem(A, index, 4))
+      for (i = 0; i < this->NumberOfComponents; i++) 
         {
-        for (i = 0; i < this->NumberOfComponents; i++) 
+        x[3] = 0;
+        if (i < this->AttributeComponents[0]) 
           {
-          x[3] = 0;
-          if (i < this->AttributeComponents[0]) 
-            {
-            x[0] = input->GetPointData()->GetScalars()->GetComponent(pts[0], i) *  this->AttributeScale[0];
-            x[1] = input->GetPointData()->GetScalars()->GetComponent(pts[1], i) *  this->AttributeScale[0];
-            x[2] = input->GetPointData()->GetScalars()->GetComponent(pts[2], i) *  this->AttributeScale[0];
-            } 
-          else if (i < this->AttributeComponents[1]) 
-            {
-            x[0] = input->GetPointData()->GetVectors()->GetComponent(pts[0], i - this->AttributeComponents[0]) *  this->AttributeScale[1];
-            x[1] = input->GetPointData()->GetVectors()->GetComponent(pts[1], i - this->AttributeComponents[0]) *  this->AttributeScale[1];
-            x[2] = input->GetPointData()->GetVectors()->GetComponent(pts[2], i - this->AttributeComponents[0]) *  this->AttributeScale[1];
-            } 
-          else if (i < this->AttributeComponents[2]) 
-            {
-            x[0] = input->GetPointData()->GetNormals()->GetComponent(pts[0], i - this->AttributeComponents[1]) *  this->AttributeScale[2];
-            x[1] = input->GetPointData()->GetNormals()->GetComponent(pts[1], i - this->AttributeComponents[1]) *  this->AttributeScale[2];
-            x[2] = input->GetPointData()->GetNormals()->GetComponent(pts[2], i - this->AttributeComponents[1]) *  this->AttributeScale[2];
-            } 
-          else if (i < this->AttributeComponents[3]) 
-            {
-            x[0] = input->GetPointData()->GetTCoords()->GetComponent(pts[0], i - this->AttributeComponents[2]) *  this->AttributeScale[3];
-            x[1] = input->GetPointData()->GetTCoords()->GetComponent(pts[1], i - this->AttributeComponents[2])*  this->AttributeScale[3];
-            x[2] = input->GetPointData()->GetTCoords()->GetComponent(pts[2], i - this->AttributeComponents[2])*  this->AttributeScale[3];
-            } 
-          else if (i < this->AttributeComponents[4]) 
-            {
-            x[0] = input->GetPointData()->GetTensors()->GetComponent(pts[0], i - this->AttributeComponents[3])*  this->AttributeScale[4];
-            x[1] = input->GetPointData()->GetTensors()->GetComponent(pts[1], i - this->AttributeComponents[3])*  this->AttributeScale[4];
-            x[2] = input->GetPointData()->GetTensors()->GetComponent(pts[2], i - this->AttributeComponents[3])*  this->AttributeScale[4];
-            }
-          vtkMath::LUSolveLinearSystem(A, index, x, 4);
-
-          // add in the contribution of this element into the QEM
-          QEM[0] += x[0] * x[0];
-          QEM[1] += x[0] * x[1];
-          QEM[2] += x[0] * x[2];
-          QEM[3] += x[3] * x[0];
-          
-          QEM[4] += x[1] * x[1];
-          QEM[5] += x[1] * x[2];
-          QEM[6] += x[3] * x[1];
-          
-          QEM[7] += x[2] * x[2];
-          QEM[8] += x[3] * x[2];
-          
-          QEM[9] += x[3] * x[3];
-          
-          QEM[11+i*4] = -x[0];
-          QEM[12+i*4] = -x[1];
-          QEM[13+i*4] = -x[2];
-          QEM[14+i*4] = -x[3];
+          x[0] = input->GetPointData()->GetScalars()->GetComponent(pts[0], i) *  this->AttributeScale[0];
+          x[1] = input->GetPointData()->GetScalars()->GetComponent(pts[1], i) *  this->AttributeScale[0];
+          x[2] = input->GetPointData()->GetScalars()->GetComponent(pts[2], i) *  this->AttributeScale[0];
+          } 
+        else if (i < this->AttributeComponents[1]) 
+          {
+          x[0] = input->GetPointData()->GetVectors()->GetComponent(pts[0], i - this->AttributeComponents[0]) *  this->AttributeScale[1];
+          x[1] = input->GetPointData()->GetVectors()->GetComponent(pts[1], i - this->AttributeComponents[0]) *  this->AttributeScale[1];
+          x[2] = input->GetPointData()->GetVectors()->GetComponent(pts[2], i - this->AttributeComponents[0]) *  this->AttributeScale[1];
+          } 
+        else if (i < this->AttributeComponents[2]) 
+          {
+          x[0] = input->GetPointData()->GetNormals()->GetComponent(pts[0], i - this->AttributeComponents[1]) *  this->AttributeScale[2];
+          x[1] = input->GetPointData()->GetNormals()->GetComponent(pts[1], i - this->AttributeComponents[1]) *  this->AttributeScale[2];
+          x[2] = input->GetPointData()->GetNormals()->GetComponent(pts[2], i - this->AttributeComponents[1]) *  this->AttributeScale[2];
+          } 
+        else if (i < this->AttributeComponents[3]) 
+          {
+          x[0] = input->GetPointData()->GetTCoords()->GetComponent(pts[0], i - this->AttributeComponents[2]) *  this->AttributeScale[3];
+          x[1] = input->GetPointData()->GetTCoords()->GetComponent(pts[1], i - this->AttributeComponents[2])*  this->AttributeScale[3];
+          x[2] = input->GetPointData()->GetTCoords()->GetComponent(pts[2], i - this->AttributeComponents[2])*  this->AttributeScale[3];
+          } 
+        else if (i < this->AttributeComponents[4]) 
+          {
+          x[0] = input->GetPointData()->GetTensors()->GetComponent(pts[0], i - this->AttributeComponents[3])*  this->AttributeScale[4];
+          x[1] = input->GetPointData()->GetTensors()->GetComponent(pts[1], i - this->AttributeComponents[3])*  this->AttributeScale[4];
+          x[2] = input->GetPointData()->GetTensors()->GetComponent(pts[2], i - this->AttributeComponents[3])*  this->AttributeScale[4];
           }
-        }
-      else 
-        {
-        vtkErrorMacro(<<"Unable to factor attribute matrix!");
+        vtkMath::LUSolveLinearSystem(A, index, x, 4);
+
+        // add in the contribution of this element into the QEM
+        QEM[0] += x[0] * x[0];
+        QEM[1] += x[0] * x[1];
+        QEM[2] += x[0] * x[2];
+        QEM[3] += x[3] * x[0];
+        
+        QEM[4] += x[1] * x[1];
+        QEM[5] += x[1] * x[2];
+        QEM[6] += x[3] * x[1];
+        
+        QEM[7] += x[2] * x[2];
+        QEM[8] += x[3] * x[2];
+        
+        QEM[9] += x[3] * x[3];
+        
+        QEM[11+i*4] = -x[0];
+        QEM[12+i*4] = -x[1];
+        QEM[13+i*4] = -x[2];
+        QEM[14+i*4] = -x[3];
         }
       }
-    
-      // add the QEM to all point of the face
-    for (i = 0; i < 3; i++) 
+    else 
       {
-      for (j = 0; j < 11 + 4 * this->NumberOfComponents; j++) 
+      for (i = 0; i < 4 * this->NumberOfComponents; i++)
         {
-        this->ErrorQuadrics[pts[i]].Quadric[j] += QEM[j] * triArea2;
+        QEM[11+i] = 0.0;
         }
+      return 0;
       }
-    }//for all triangles
-
-  delete [] QEM;
+    }
+  
+  return 1;
 }
 
+//----------------------------------------------------------------------------
+void vtkQuadricDecimation::InitializeCosts()
+{
+  vtkIdType numEdges = this->Edges->GetNumberOfEdges();
+  vtkstd::vector<double> costs(numEdges);
+  this->TargetPoints->SetNumberOfTuples(numEdges);
+
+  vtkQuadricDecimationCostFunctor functor;
+  functor.Self = this;
+  functor.Costs = (numEdges > 0 ? &costs[0] : NULL);
+  functor.TargetPoints = this->TargetPoints->GetPointer(0);
+  vtkParallelFor *parallelFor = vtkParallelFor::New();
+  parallelFor->SetNumberOfThreads(this->NumberOfThreads);
+  parallelFor->Execute(0, numEdges, &functor);
+  parallelFor->Delete();
+
+  this->EdgeCosts->Initialize(numEdges, functor.Costs);
+}
 
 void vtkQuadricDecimation::AddBoundaryConstraints(void) 
 {
@@ -664,132 +980,57 @@ void vtkQuadricDecimation::AddQuadric(vtkIdType oldPtId, vtkIdType newPtId)
 }
 
 //----------------------------------------------------------------------------
-void vtkQuadricDecimation::FindAffectedEdges(vtkIdType p1Id, vtkIdType p2Id,
-                                              vtkIdList *edges)
+// Move the edges of the removed point pt1Id to pt0Id, dropping the collapsed
+// edge and those joining pt0Id to a point it is already joined to, and
+// queue the edges of pt0Id again with their new costs.
+void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
 {
-  unsigned short ncells;
-  vtkIdType *cells, npts, *pts, edgeId;
-  unsigned short i, j;
- 
-  edges->Reset();
-  this->Mesh->GetPointCells(p2Id, ncells, cells);
-  for (i = 0; i < ncells; i++)
+  vtkQuadricDecimationEdges *edges = this->Edges;
+  vtkIdType edgeId, nextId, otherId;
+  double cost;
+
+  for (edgeId = edges->First[pt1Id]; edgeId >= 0; edgeId = nextId)
     {
-    this->Mesh->GetCellPoints(cells[i], npts, pts);
-    for (j = 0; j < 3; j++) 
+    nextId = edges->GetNext(edgeId, pt1Id);
+    otherId = edges->GetOtherPoint(edgeId, pt1Id);
+    if (otherId == pt0Id || edges->IsEdge(otherId, pt0Id) >= 0)
       {
-      if (pts[j] != p1Id && pts[j] != p2Id &&
-          (edgeId = this->Edges->IsEdge(pts[j], p2Id)) >= 0 &&
-          edges->IsId(edgeId) == -1) 
-        {
-        edges->InsertNextId(edgeId);
-        }
+      edges->RemoveEdge(edgeId, otherId);
+      this->EdgeCosts->DeleteId(edgeId);
       }
-    }
-
-  this->Mesh->GetPointCells(p1Id, ncells, cells);
-  for (i = 0; i < ncells; i++)
-    {
-    this->Mesh->GetCellPoints(cells[i], npts, pts);
-    for (j = 0; j < 3; j++) 
+    else
       {
-      if (pts[j] != p1Id && pts[j] != p2Id &&
-          (edgeId = this->Edges->IsEdge(pts[j], p1Id)) >= 0 &&
-          edges->IsId(edgeId) == -1) 
-        {
-        edges->InsertNextId(edgeId);
-        }
+      // The edge now joins the other point to pt0Id.
+      edges->Next[2*edgeId] = edges->GetNext(edgeId, otherId);
+      edges->Points[2*edgeId] = otherId;
+      edges->Points[2*edgeId+1] = pt0Id;
+      edges->Next[2*edgeId+1] = edges->First[pt0Id];
+      edges->First[pt0Id] = edgeId;
       }
     }
-}
-
-// FIXME: memory allocation clean up
-void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
-{
-  vtkIdList *changedEdges = vtkIdList::New();
-  vtkIdType i, edgeId, edge[2];
-  double cost;
+  edges->First[pt1Id] = -1;
 
-  // Find all edges with exactly either of these 2 endpoints.
-  this->FindAffectedEdges(pt0Id, pt1Id, changedEdges);
-
-  // Reset the endpoints for these edges to reflect the new point from the
-  // collapsed edge.
-  // Add these new edges to the edge table.
-  // Remove the the changed edges from the priority queue.
-  for (i = 0; i < changedEdges->GetNumberOfIds(); i++)
+  for (edgeId = edges->First[pt0Id]; edgeId >= 0;
+       edgeId = edges->GetNext(edgeId, pt0Id))
     {
-    edge[0] = this->EndPoint1List->GetId(changedEdges->GetId(i));
-    edge[1] = this->EndPoint2List->GetId(changedEdges->GetId(i));
-
-    // Remove all affected edges from the priority queue. 
-    // This does not include collapsed edge.
-    this->EdgeCosts->DeleteId(changedEdges->GetId(i));
-
-    // Determine the new set of edges
-    if (edge[0] == pt1Id)
+    // Compute cost (target point/data) and add to priority queue.
+    if (this->AttributeErrorMetric) 
       {
-      if (this->Edges->IsEdge(edge[1], pt0Id) == -1)
-        { // The edge will be completely new, add it.
-        edgeId = this->Edges->GetNumberOfEdges();
-        this->Edges->InsertEdge(edge[1], pt0Id, edgeId);
-        this->EndPoint1List->InsertId(edgeId, edge[1]);
-        this->EndPoint2List->InsertId(edgeId, pt0Id);
-        // Compute cost (target point/data) and add to priority cue.
-        if (this->AttributeErrorMetric) 
-          {
-          cost = this->ComputeCost2(edgeId, this->TempX);
-          }
-        else
-          {
-          cost = this->ComputeCost(edgeId, this->TempX);
-          }
-        this->EdgeCosts->Insert(cost, edgeId);
-        this->TargetPoints->InsertTuple(edgeId, this->TempX);
-        }
-      }
-    else if (edge[1] == pt1Id)
-      { // The edge will be completely new, add it.
-      if (this->Edges->IsEdge(edge[0], pt0Id) == -1)
-        {
-        edgeId = this->Edges->GetNumberOfEdges();
-        this->Edges->InsertEdge(edge[0], pt0Id, edgeId);
-        this->EndPoint1List->InsertId(edgeId, edge[0]);
-        this->EndPoint2List->InsertId(edgeId, pt0Id);
-        // Compute cost (target point/data) and add to priority cue.
-        if (this->AttributeErrorMetric) 
-          {
-          cost = this->ComputeCost2(edgeId, this->TempX);
-          }
-        else
-          {
-          cost = this->ComputeCost(edgeId, this->TempX);
-          }
-        this->EdgeCosts->Insert(cost, edgeId);
-        this->TargetPoints->InsertTuple(edgeId, this->TempX);
-        }
+      cost = this->ComputeCost2(edgeId, this->TempX, this->TempQuad,
+                                this->TempA, this->TempB);
       }
     else
-      { // This edge already has one point as the merged point.
-      if (this->AttributeErrorMetric) 
-        {
-        cost = this->ComputeCost2(changedEdges->GetId(i), this->TempX);
-        }
-      else
-        {
-        cost = this->ComputeCost(changedEdges->GetId(i), this->TempX);
-        }
-      this->EdgeCosts->Insert(cost, changedEdges->GetId(i));
-      this->TargetPoints->InsertTuple(changedEdges->GetId(i), this->TempX);
+      {
+      cost = this->ComputeCost(edgeId, this->TempX, this->TempQuad);
       }
+    this->EdgeCosts->Insert(cost, edgeId);
+    this->TargetPoints->SetTuple(edgeId, this->TempX);
     }
-
-  changedEdges->Delete();
-  return; 
 }
 
 //----------------------------------------------------------------------------
-double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
+double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x,
+                                         double *tempQuad)
 {
   static const double errorNumber = 1e-10;
   double temp[3], A[3][3], b[3];
@@ -801,25 +1042,25 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
   double v[3],  c, norm, normTemp,  temp2[3];
   double pt1[3], pt2[3];
 
-  pointIds[0] = this->EndPoint1List->GetId(edgeId);
-  pointIds[1] = this->EndPoint2List->GetId(edgeId);
+  pointIds[0] = this->Edges->Points[2*edgeId];
+  pointIds[1] = this->Edges->Points[2*edgeId+1];
   
   for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
     {
-    this->TempQuad[i] = this->ErrorQuadrics[pointIds[0]].Quadric[i] +
+    tempQuad[i] = this->ErrorQuadrics[pointIds[0]].Quadric[i] +
       this->ErrorQuadrics[pointIds[1]].Quadric[i];
     }
 
-  A[0][0] = this->TempQuad[0];
-  A[0][1] = A[1][0] = this->TempQuad[1];
-  A[0][2] = A[2][0] = this->TempQuad[2];
-  A[1][1] = this->TempQuad[4];
-  A[1][2] = A[2][1] = this->TempQuad[5];
-  A[2][2] = this->TempQuad[7];
+  A[0][0] = tempQuad[0];
+  A[0][1] = A[1][0] = tempQuad[1];
+  A[0][2] = A[2][0] = tempQuad[2];
+  A[1][1] = tempQuad[4];
+  A[1][2] = A[2][1] = tempQuad[5];
+  A[2][2] = tempQuad[7];
 
-  b[0] = -this->TempQuad[3];
-  b[1] = -this->TempQuad[6];
-  b[2] = -this->TempQuad[8];
+  b[0] = -tempQuad[3];
+  b[1] = -tempQuad[6];
+  b[2] = -tempQuad[8];
    
   norm = vtkMath::Norm(A[0]);
   normTemp = vtkMath::Norm(A[1]);
@@ -873,7 +1114,7 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
   
   // Compute the cost
   // x'*quad*x
-  index = this->TempQuad;
+  index = tempQuad;
   for (i = 0; i < 4; i++) 
     {
     cost += (*index++)*newPoint[i]*newPoint[i];
@@ -888,7 +1129,9 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
 
 
 //----------------------------------------------------------------------------
-double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
+double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x,
+                                          double *tempQuad, double **tempA,
+                                          double *tempB)
 {
   // this function is so ugly because the functionality of converting an QEM
   // into a dence matrix was not extracted into a separate function and
@@ -899,34 +1142,34 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
   int i, j;
   int solveOk;
 
-  pointIds[0] = this->EndPoint1List->GetId(edgeId);
-  pointIds[1] = this->EndPoint2List->GetId(edgeId);
+  pointIds[0] = this->Edges->Points[2*edgeId];
+  pointIds[1] = this->Edges->Points[2*edgeId+1];
 
   for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)  
     {
-    this->TempQuad[i] = this->ErrorQuadrics[pointIds[0]].Quadric[i] +
+    tempQuad[i] = this->ErrorQuadrics[pointIds[0]].Quadric[i] +
       this->ErrorQuadrics[pointIds[1]].Quadric[i];
     }
   
   // copy the temp quad into TempA
   // converting from the sparce matrix format into a dence
-  this->TempA[0][0] = this->TempQuad[0];
-  this->TempA[0][1] = this->TempA[1][0] = this->TempQuad[1];
-  this->TempA[0][2] = this->TempA[2][0] = this->TempQuad[2];
-  this->TempA[1][1] = this->TempQuad[4];
-  this->TempA[1][2] = this->TempA[2][1] = this->TempQuad[5];
-  this->TempA[2][2] = this->TempQuad[7];
+  tempA[0][0] = tempQuad[0];
+  tempA[0][1] = tempA[1][0] = tempQuad[1];
+  tempA[0][2] = tempA[2][0] = tempQuad[2];
+  tempA[1][1] = tempQuad[4];
+  tempA[1][2] = tempA[2][1] = tempQuad[5];
+  tempA[2][2] = tempQuad[7];
   
-  this->TempB[0] = -this->TempQuad[3];
-  this->TempB[1] = -this->TempQuad[6];
-  this->TempB[2] = -this->TempQuad[8];
+  tempB[0] = -tempQuad[3];
+  tempB[1] = -tempQuad[6];
+  tempB[2] = -tempQuad[8];
 
   for (i = 3; i < 3 +  this->NumberOfComponents; i++) 
     {
-    this->TempA[0][i] = this->TempA[i][0] = this->TempQuad[11+4*(i-3)];
-    this->TempA[1][i] = this->TempA[i][1] = this->TempQuad[11+4*(i-3)+1];
-    this->TempA[2][i] = this->TempA[i][2] = this->TempQuad[11+4*(i-3)+2];
-    this->TempB[i] = -this->TempQuad[11+4*(i-3)+3];
+    tempA[0][i] = tempA[i][0] = tempQuad[11+4*(i-3)];
+    tempA[1][i] = tempA[i][1] = tempQuad[11+4*(i-3)+1];
+    tempA[2][i] = tempA[i][2] = tempQuad[11+4*(i-3)+2];
+    tempB[i] = -tempQuad[11+4*(i-3)+3];
     }
 
   for (i = 3; i < 3 +  this->NumberOfComponents; i++) 
@@ -935,38 +1178,38 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
       {
       if (i == j)
         {
-        this->TempA[i][j] = this->TempQuad[10];
+        tempA[i][j] = tempQuad[10];
         }
       else 
         {
-        this->TempA[i][j] = 0;
+        tempA[i][j] = 0;
         }
       }
     }
   
   for (i = 0; i < 3 + this->NumberOfComponents; i++) 
     {
-    x[i] = this->TempB[i];
+    x[i] = tempB[i];
     }
   
   // solve A*x = b
   // this clobers A
   // need to develop a quality of the solution test??
-  solveOk = vtkMath::SolveLinearSystem(this->TempA, x, 3 +  this->NumberOfComponents);
+  solveOk = vtkMath::SolveLinearSystem(tempA, x, 3 +  this->NumberOfComponents);
   
   // need to copy back into A
-  this->TempA[0][0] = this->TempQuad[0];
-  this->TempA[0][1] = this->TempA[1][0] = this->TempQuad[1];
-  this->TempA[0][2] = this->TempA[2][0] = this->TempQuad[2];
-  this->TempA[1][1] = this->TempQuad[4];
-  this->TempA[1][2] = this->TempA[2][1] = this->TempQuad[5];
-  this->TempA[2][2] = this->TempQuad[7];
+  tempA[0][0] = tempQuad[0];
+  tempA[0][1] = tempA[1][0] = tempQuad[1];
+  tempA[0][2] = tempA[2][0] = tempQuad[2];
+  tempA[1][1] = tempQuad[4];
+  tempA[1][2] = tempA[2][1] = tempQuad[5];
+  tempA[2][2] = tempQuad[7];
  
   for (i = 3; i < 3 +  this->NumberOfComponents; i++) 
     {
-    this->TempA[0][i] = this->TempA[i][0] = this->TempQuad[11+4*(i-3)];
-    this->TempA[1][i] = this->TempA[i][1] = this->TempQuad[11+4*(i-3)+1];
-    this->TempA[2][i] = this->TempA[i][2] = this->TempQuad[11+4*(i-3)+2];
+    tempA[0][i] = tempA[i][0] = tempQuad[11+4*(i-3)];
+    tempA[1][i] = tempA[i][1] = tempQuad[11+4*(i-3)+1];
+    tempA[2][i] = tempA[i][2] = tempQuad[11+4*(i-3)+2];
     }
 
   for (i = 3; i < 3 +  this->NumberOfComponents; i++) 
@@ -975,11 +1218,11 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
       {
       if (i == j)
         {
-        this->TempA[i][j] = this->TempQuad[10]; 
+        tempA[i][j] = tempQuad[10]; 
         }
       else 
         {
-        this->TempA[i][j] = 0;
+        tempA[i][j] = 0;
         }
       }
     }
@@ -1012,7 +1255,7 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
       temp2[i] = 0;
       for (j = 0; j < 3 + this->NumberOfComponents; ++j) 
         {
-        temp2[i] += this->TempA[i][j]*v[j];
+        temp2[i] += tempA[i][j]*v[j];
         }
       }
       
@@ -1030,13 +1273,13 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
         temp[i] = 0;
         for (j = 0; j < 3 + this->NumberOfComponents; ++j) 
           {
-          temp[i] += this->TempA[i][j]*pt1[j];
+          temp[i] += tempA[i][j]*pt1[j];
           }
         }
           
       for (i = 0; i < 3 + this->NumberOfComponents; i++)
         {
-        temp[i] = this->TempB[i] - temp[i];
+        temp[i] = tempB[i] - temp[i];
         }
           
       for (i = 0; i < 3 + this->NumberOfComponents; i++)
@@ -1070,18 +1313,18 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
   // x'*A*x - 2*b*x + d
   for (i = 0; i < 3+this->NumberOfComponents; i++) 
     {
-    cost += this->TempA[i][i]*x[i]*x[i];
+    cost += tempA[i][i]*x[i]*x[i];
     for (j = i+1; j < 3+this->NumberOfComponents; j++) 
       {
-      cost += 2.0*this->TempA[i][j]*x[i]*x[j];
+      cost += 2.0*tempA[i][j]*x[i]*x[j];
       }
     }
   for (i = 0; i < 3+this->NumberOfComponents; i++) 
     {
-    cost -=  2.0 * this->TempB[i]*x[i];
+    cost -=  2.0 * tempB[i]*x[i];
     }
       
-  cost += this->TempQuad[9];
+  cost += tempQuad[9];
 
   return cost;
 }
@@ -1374,4 +1617,5 @@ void vtkQuadricDecimation::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Normals Weight: " << this->NormalsWeight << "\n";
   os << indent << "TCoords Weight: " << this->TCoordsWeight << "\n";
   os << indent << "Tensors Weight: " << this->TensorsWeight << "\n";
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
 }
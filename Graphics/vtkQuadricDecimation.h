@@ -46,6 +46,15 @@
 // Attributes" is also a good take on the subject especially as it pertains
 // to the error metric applied to attributes.
 //
+// The edges waiting to be collapsed are kept in a binary heap from which
+// edges whose cost changed are not removed but superseded, the stale
+// entries being skipped when they reach the top. Edges of equal cost are
+// collapsed in the order they were queued in, then in order of id, so the
+// output does not depend on the layout of the heap. The initial quadrics of
+// the points and costs of the edges can be computed on several threads by
+// setting NumberOfThreads; the output does not depend on the number of
+// threads.
+//
 // .SECTION Thanks
 // Thanks to Bradley Lowekamp of the National Library of Medicine/NIH for
 // contributing this class.
@@ -55,11 +64,11 @@
 
 #include "vtkPolyDataAlgorithm.h"
 
-class vtkEdgeTable;
 class vtkIdList;
 class vtkPointData;
-class vtkPriorityQueue;
 class vtkDoubleArray;
+class vtkQuadricDecimationEdges;
+class vtkQuadricDecimationQueue;
 
 class VTK_GRAPHICS_EXPORT vtkQuadricDecimation : public vtkPolyDataAlgorithm
 {
@@ -124,6 +133,13 @@ public:
   // filter has executed.
   vtkGetMacro(ActualReduction, double);
 
+  // Description:
+  // Set/Get the number of threads computing the initial quadrics and edge
+  // costs. The edges are collapsed on one thread. The default is one
+  // thread.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
 protected:
   vtkQuadricDecimation();
   ~vtkQuadricDecimation();
@@ -147,6 +163,12 @@ protected:
   // Compute quadric for this vertex.
   void ComputeQuadric(vtkIdType pointId);
 
+  // Description:
+  // Compute the quadric of a triangle and the weight it is added to its
+  // points with. Return 0 if the attributes of the triangle could not be
+  // interpolated.
+  int ComputeTriangleQuadric(vtkIdType *pts, double *QEM, double &area);
+
   // Description:
   // Add the quadrics for these 2 points since the edge between them has
   // been collapsed.
@@ -154,19 +176,15 @@ protected:
   
   // Description:
   // Compute cost for contracting this edge and the point that gives us this
-  // cost.
-  double ComputeCost(vtkIdType edgeId, double *x);
-  double ComputeCost2(vtkIdType edgeId, double *x);
+  // cost. The temporary arrays are passed in so that the costs of several
+  // edges can be computed at once on different threads.
+  double ComputeCost(vtkIdType edgeId, double *x, double *tempQuad);
+  double ComputeCost2(vtkIdType edgeId, double *x, double *tempQuad,
+                      double **tempA, double *tempB);
 
   // Description:
-  // Find all edges that will have an endpoint change ids because of an edge
-  // collapse.  p1Id and p2Id are the endpoints of the edge.  p2Id is the
-  // pointId being removed.
-  void FindAffectedEdges(vtkIdType p1Id, vtkIdType p2Id, vtkIdList *edges);
-  
-  // Description:
-  // Find a cell that uses this edge.
-  vtkIdType GetEdgeCellId(vtkIdType p1Id, vtkIdType p2Id);
+  // Compute the cost of and target point for collapsing each edge.
+  void InitializeCosts();
 
   int IsGoodPlacement(vtkIdType pt0Id, vtkIdType pt1Id, const double *x);
   int TrianglePlaneCheck(const double t0[3], const double t1[3], 
@@ -200,11 +218,11 @@ protected:
   double TCoordsWeight;
   double TensorsWeight;
 
+  int NumberOfThreads;
+
   int               NumberOfEdgeCollapses;
-  vtkEdgeTable     *Edges;
-  vtkIdList        *EndPoint1List;
-  vtkIdList        *EndPoint2List;
-  vtkPriorityQueue *EdgeCosts;
+  vtkQuadricDecimationEdges *Edges;
+  vtkQuadricDecimationQueue *EdgeCosts;
   vtkDoubleArray   *TargetPoints;
   int               NumberOfComponents;
   vtkPolyData      *Mesh;
@@ -217,6 +235,7 @@ protected:
   //ETX
 
   ErrorQuadric *ErrorQuadrics;
+  double       *ErrorQuadricData; // the quadrics of all points in one block
   int           AttributeComponents[6];
   double        AttributeScale[6];
   
@@ -229,6 +248,11 @@ protected:
   double *TempData;
 
 private:
+  //BTX
+  friend class vtkQuadricDecimationQuadricFunctor;
+  friend class vtkQuadricDecimationCostFunctor;
+  //ETX
+
   vtkQuadricDecimation(const vtkQuadricDecimation&);  // Not implemented.
   void operator=(const vtkQuadricDecimation&);  // Not implemented.
 };
@@ -35,6 +35,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkMath.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkObjectFactory.h"
+#include "vtkParallelFor.h"
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
 #include "vtkPolyData.h"
@@ -44,6 +45,8 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkRungeKutta45.h"
 #include "vtkSmartPointer.h"
 
+#include <vtkstd/vector>
+
 vtkCxxRevisionMacro(vtkStreamTracer, "$Revision$");
 vtkStandardNewMacro(vtkStreamTracer);
 vtkCxxSetObjectMacro(vtkStreamTracer,Integrator,vtkInitialValueProblemSolver);
@@ -72,6 +75,7 @@ vtkStreamTracer::vtkStreamTracer()
 
   this->ComputeVorticity = true;
   this->RotationScale    = 1.0;
+  this->NumberOfThreads  = 1;
 
   this->LastUsedStepSize = 0.0;
 
@@ -600,6 +604,207 @@ int vtkStreamTracer::CheckInputs(vtkAbstractInterpolatedVelocityField*& func,
   return VTK_OK;
 }
 
+//----------------------------------------------------------------------------
+// The streamlines integrated from a range of seeds, and the state carried
+// from one streamline to the next.
+class vtkStreamTracerLines
+{
+public:
+  vtkStreamTracerLines(vtkPointData *pointData, bool computeVorticity,
+                       bool cellSearchStatistics)
+    {
+    this->PointData = pointData;
+    this->Points = vtkSmartPointer<vtkPoints>::New();
+    this->Lines = vtkSmartPointer<vtkCellArray>::New();
+
+    // We will keep track of integration time in this array
+    this->Time = vtkSmartPointer<vtkDoubleArray>::New();
+    this->Time->SetName("IntegrationTime");
+
+    // This array explains why the integration stopped
+    this->ReasonForTermination = vtkSmartPointer<vtkIntArray>::New();
+    this->ReasonForTermination->SetName("ReasonForTermination");
+
+    // These count how the cells of each streamline were found
+    if (cellSearchStatistics)
+      {
+      const char *names[4] =
+        { "CacheHits", "WalkHits", "WalkSteps", "GlobalSearches" };
+      for (int i=0; i<4; i++)
+        {
+        this->CellSearches[i] = vtkSmartPointer<vtkIntArray>::New();
+        this->CellSearches[i]->SetName(names[i]);
+        }
+      }
+
+    if (computeVorticity)
+      {
+      this->Vorticity = vtkSmartPointer<vtkDoubleArray>::New();
+      this->Vorticity->SetName("Vorticity");
+      this->Vorticity->SetNumberOfComponents(3);
+
+      this->Rotation = vtkSmartPointer<vtkDoubleArray>::New();
+      this->Rotation->SetName("Rotation");
+
+      this->AngularVelocity = vtkSmartPointer<vtkDoubleArray>::New();
+      this->AngularVelocity->SetName("AngularVelocity");
+      }
+
+    this->Propagation = 0.0;
+    this->NumberOfSteps = 0;
+    this->HasPropagation = 0;
+    this->HasLastPoint = 0;
+    this->HasLastUsedStepSize = 0;
+    this->LastUsedStepSize = 0.0;
+    this->Aborted = 0;
+    }
+
+  // Append the streamlines of other after those of this.
+  void Append(vtkStreamTracerLines *other);
+
+  vtkPointData *PointData;  // all point attributes of the input
+  vtkSmartPointer<vtkPoints> Points;
+  vtkSmartPointer<vtkCellArray> Lines;
+  vtkSmartPointer<vtkDoubleArray> Time;
+  vtkSmartPointer<vtkIntArray> ReasonForTermination;
+  vtkSmartPointer<vtkIntArray> CellSearches[4];
+  vtkSmartPointer<vtkDoubleArray> Vorticity;
+  vtkSmartPointer<vtkDoubleArray> Rotation;
+  vtkSmartPointer<vtkDoubleArray> AngularVelocity;
+
+  double Propagation;
+  vtkIdType NumberOfSteps;
+  int HasPropagation;
+  double LastPoint[3];
+  int HasLastPoint;
+  double LastUsedStepSize;
+  int HasLastUsedStepSize;
+  int Aborted;
+};
+
+//----------------------------------------------------------------------------
+static void vtkStreamTracerAppendArray(vtkAbstractArray *to,
+                                       vtkAbstractArray *from)
+{
+  vtkIdType numTuples = from->GetNumberOfTuples();
+  for (vtkIdType i=0; i<numTuples; i++)
+    {
+    to->InsertNextTuple(i, from);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamTracerLines::Append(vtkStreamTracerLines *other)
+{
+  vtkIdType offset = this->Points->GetNumberOfPoints();
+  vtkStreamTracerAppendArray(this->Points->GetData(),
+                             other->Points->GetData());
+
+  vtkIdType npts, *pts;
+  vtkCellArray *lines = other->Lines;
+  for (lines->InitTraversal(); lines->GetNextCell(npts, pts); )
+    {
+    this->Lines->InsertNextCell(static_cast<int>(npts));
+    for (vtkIdType i=0; i<npts; i++)
+      {
+      this->Lines->InsertCellPoint(pts[i] + offset);
+      }
+    }
+
+  // both point data were allocated from the same input attributes, so
+  // they have the same arrays in the same order
+  int numArrays = this->PointData->GetNumberOfArrays();
+  for (int i=0; i<numArrays; i++)
+    {
+    vtkStreamTracerAppendArray(this->PointData->GetAbstractArray(i),
+                               other->PointData->GetAbstractArray(i));
+    }
+  vtkStreamTracerAppendArray(this->Time, other->Time);
+  vtkStreamTracerAppendArray(this->ReasonForTermination,
+                             other->ReasonForTermination);
+  if (this->CellSearches[0])
+    {
+    for (int i=0; i<4; i++)
+      {
+      vtkStreamTracerAppendArray(this->CellSearches[i],
+                                 other->CellSearches[i]);
+      }
+    }
+  if (this->Vorticity)
+    {
+    vtkStreamTracerAppendArray(this->Vorticity, other->Vorticity);
+    vtkStreamTracerAppendArray(this->Rotation, other->Rotation);
+    vtkStreamTracerAppendArray(this->AngularVelocity, other->AngularVelocity);
+    }
+
+  // the state left by the last streamline
+  if (other->HasPropagation)
+    {
+    this->Propagation = other->Propagation;
+    this->NumberOfSteps = other->NumberOfSteps;
+    this->HasPropagation = 1;
+    }
+  if (other->HasLastPoint)
+    {
+    memcpy(this->LastPoint, other->LastPoint, 3*sizeof(double));
+    this->HasLastPoint = 1;
+    }
+  if (other->HasLastUsedStepSize)
+    {
+    this->LastUsedStepSize = other->LastUsedStepSize;
+    this->HasLastUsedStepSize = 1;
+    }
+  this->Aborted |= other->Aborted;
+}
+
+//----------------------------------------------------------------------------
+// Integrates contiguous ranges of seeds, each into its own
+// vtkStreamTracerLines.  Each thread evaluates the velocity with its own
+// copy of the function, sharing the datasets and their search structures.
+class vtkStreamTracerIntegrateFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkStreamTracer *Tracer;
+  vtkAbstractInterpolatedVelocityField *Function;
+  vtkstd::vector<vtkStreamTracerLines *> Ranges;
+  vtkDataArray *SeedSource;
+  vtkIdList *SeedIds;
+  vtkIntArray *IntegrationDirections;
+  int MaxCellSize;
+  const char *VectorName;
+
+  vtkstd::vector<vtkSmartPointer<vtkAbstractInterpolatedVelocityField> >
+    Functions;
+
+  void Initialize(int numberOfThreads)
+    {
+    this->Functions.resize(numberOfThreads);
+    this->Functions[0] = this->Function;
+    for (int i=1; i<numberOfThreads; i++)
+      {
+      this->Functions[i].TakeReference(this->Function->NewInstance());
+      this->Functions[i]->CopyParameters(this->Function);
+      this->Functions[i]->SelectVectors(this->Function->GetVectorsSelection());
+      this->Functions[i]->ShareDataSets(this->Function);
+      }
+    }
+
+  void Execute(vtkIdType begin, vtkIdType end, int threadId)
+    {
+    vtkIdType numLines = this->SeedIds->GetNumberOfIds();
+    vtkIdType numRanges = static_cast<vtkIdType>(this->Ranges.size());
+    for (vtkIdType i=begin; i<end; i++)
+      {
+      this->Tracer->IntegrateLines(
+        this->Ranges[i], i*numLines/numRanges, (i+1)*numLines/numRanges,
+        this->SeedSource, this->SeedIds, this->IntegrationDirections,
+        this->Functions[threadId], this->MaxCellSize, this->VectorName,
+        threadId == 0);
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
 void vtkStreamTracer::Integrate(vtkDataSet *input0,
                                 vtkPolyData* output,
                                 vtkDataArray* seedSource, 
@@ -612,14 +817,156 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
                                 double& inPropagation,
                                 vtkIdType& inNumSteps)
 {
-  int i;
   vtkIdType numLines = seedIds->GetNumberOfIds();
-  double propagation = inPropagation;
-  vtkIdType numSteps = inNumSteps;
 
   // Useful pointers
   vtkDataSetAttributes* outputPD = output->GetPointData();
   vtkDataSetAttributes* outputCD = output->GetCellData();
+
+  if (this->GetIntegrator() == 0)
+    {
+    vtkErrorMacro("No integrator is specified.");
+    return;
+    }
+
+  // We will interpolate all point attributes of the input on
+  // each point of the output (unless they are turned off)
+  // Note that we are using only the first input, if there are more
+  // than one, the attributes have to match.
+  outputPD->InterpolateAllocate(input0->GetPointData());
+  // Note:  It is an overestimation to have the estimate the same number of
+  // output points and input points.  We sill have to squeeze at end.
+
+  // The values passed in the function call are only used for the
+  // first line.
+  // The cell search statistics are output when the neighbor walk is used
+  vtkInterpolatedVelocityField *walker =
+    vtkInterpolatedVelocityField::SafeDownCast(func);
+  bool cellSearchStatistics = (walker && walker->GetNeighborWalk());
+  vtkStreamTracerLines lines(output->GetPointData(), this->ComputeVorticity,
+                             cellSearchStatistics);
+  lines.Propagation = inPropagation;
+  lines.NumberOfSteps = inNumSteps;
+
+  if (this->NumberOfThreads > 1 && numLines > 1)
+    {
+    // Split the seeds in a few ranges per thread. The first range goes
+    // straight to the output, the others are appended to it in seed order.
+    vtkIdType numRanges = 8 * this->NumberOfThreads;
+    if (numRanges > numLines)
+      {
+      numRanges = numLines;
+      }
+
+    vtkStreamTracerIntegrateFunctor functor;
+    functor.Tracer = this;
+    functor.Function = func;
+    functor.SeedSource = seedSource;
+    functor.SeedIds = seedIds;
+    functor.IntegrationDirections = integrationDirections;
+    functor.MaxCellSize = maxCellSize;
+    functor.VectorName = vecName;
+    functor.Ranges.push_back(&lines);
+    vtkIdType i;
+    for (i=1; i<numRanges; i++)
+      {
+      vtkPointData *pointData = vtkPointData::New();
+      pointData->InterpolateAllocate(input0->GetPointData());
+      functor.Ranges.push_back(
+        new vtkStreamTracerLines(pointData, this->ComputeVorticity,
+                                 cellSearchStatistics));
+      }
+
+    vtkParallelFor *parallelFor = vtkParallelFor::New();
+    parallelFor->SetNumberOfThreads(this->NumberOfThreads);
+    parallelFor->SetGrainSize(1);
+    parallelFor->Execute(0, numRanges, &functor);
+    parallelFor->Delete();
+
+    for (i=1; i<numRanges; i++)
+      {
+      lines.Append(functor.Ranges[i]);
+      functor.Ranges[i]->PointData->Delete();
+      delete functor.Ranges[i];
+      }
+    }
+  else
+    {
+    this->IntegrateLines(&lines, 0, numLines, seedSource, seedIds,
+                         integrationDirections, func, maxCellSize, vecName,
+                         1);
+    }
+
+  inPropagation = lines.Propagation;
+  inNumSteps = lines.NumberOfSteps;
+  if (lines.HasLastPoint)
+    {
+    memcpy(lastPoint, lines.LastPoint, 3*sizeof(double));
+    }
+  if (lines.HasLastUsedStepSize)
+    {
+    this->LastUsedStepSize = lines.LastUsedStepSize;
+    }
+
+  if (!lines.Aborted)
+    {
+    // Create the output polyline
+    output->SetPoints(lines.Points);
+    outputPD->AddArray(lines.Time);
+    if (lines.Vorticity)
+      {
+      outputPD->AddArray(lines.Vorticity);
+      outputPD->AddArray(lines.Rotation);
+      outputPD->AddArray(lines.AngularVelocity);
+      }
+    
+    vtkIdType numPts = lines.Points->GetNumberOfPoints();
+    if ( numPts > 1 )
+      {
+      // Assign geometry and attributes
+      output->SetLines(lines.Lines);
+      if (this->GenerateNormalsInIntegrate)
+        {
+        this->GenerateNormals(output, 0, vecName);
+        }
+
+      outputCD->AddArray(lines.ReasonForTermination);
+      if (cellSearchStatistics)
+        {
+        for (int i=0; i<4; i++)
+          {
+          outputCD->AddArray(lines.CellSearches[i]);
+          }
+        }
+      }
+    }
+
+  output->Squeeze();
+  return;
+}
+
+//----------------------------------------------------------------------------
+// Integrate the streamlines of seeds begin to end-1 and append them to
+// lines.  Everything this changes is in lines and func, so that ranges of
+// seeds can be integrated concurrently with different functions.
+void vtkStreamTracer::IntegrateLines(vtkStreamTracerLines* lines,
+                                     vtkIdType begin,
+                                     vtkIdType end,
+                                     vtkDataArray* seedSource, 
+                                     vtkIdList* seedIds,
+                                     vtkIntArray* integrationDirections,
+                                     vtkAbstractInterpolatedVelocityField* func,
+                                     int maxCellSize,
+                                     const char *vecName,
+                                     int reportProgress)
+{
+  int i;
+  vtkIdType numLines = seedIds->GetNumberOfIds();
+  double propagation = lines->Propagation;
+  vtkIdType numSteps = lines->NumberOfSteps;
+
+  // Useful pointers
+  vtkPointData* outputPD = lines->PointData;
   vtkPointData* inputPD;
   vtkDataSet* input;
   vtkDataArray* inVectors;
@@ -632,12 +979,6 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
     weights = new double[maxCellSize];
     }
 
-  if (this->GetIntegrator() == 0)
-    {
-    vtkErrorMacro("No integrator is specified.");
-    return;
-    }
-
   // Used in GetCell() 
   vtkGenericCell* cell = vtkGenericCell::New();
 
@@ -652,56 +993,42 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
   // were to allocate any points here, potentially, we can
   // waste a lot of memory if a lot of streamers are used.
   // Always insert the first point
-  vtkPoints* outputPoints = vtkPoints::New();
-  vtkCellArray* outputLines = vtkCellArray::New();
-
-  // We will keep track of integration time in this array
-  vtkDoubleArray* time = vtkDoubleArray::New();
-  time->SetName("IntegrationTime");
-
-  // This array explains why the integration stopped
-  vtkIntArray* retVals = vtkIntArray::New();
-  retVals->SetName("ReasonForTermination");
+  vtkPoints* outputPoints = lines->Points;
+  vtkCellArray* outputLines = lines->Lines;
+  vtkDoubleArray* time = lines->Time;
+  vtkIntArray* retVals = lines->ReasonForTermination;
 
   vtkDoubleArray* cellVectors = 0;
-  vtkDoubleArray* vorticity = 0;
-  vtkDoubleArray* rotation = 0;
-  vtkDoubleArray* angularVel = 0;
+  vtkDoubleArray* vorticity = lines->Vorticity;
+  vtkDoubleArray* rotation = lines->Rotation;
+  vtkDoubleArray* angularVel = lines->AngularVelocity;
   if (this->ComputeVorticity)
     {
     cellVectors = vtkDoubleArray::New();
     cellVectors->SetNumberOfComponents(3);
     cellVectors->Allocate(3*VTK_CELL_SIZE);
-    
-    vorticity = vtkDoubleArray::New();
-    vorticity->SetName("Vorticity");
-    vorticity->SetNumberOfComponents(3);
-
-    rotation = vtkDoubleArray::New();
-    rotation->SetName("Rotation");
-
-    angularVel = vtkDoubleArray::New();
-    angularVel->SetName("AngularVelocity");
     }
   
-  // We will interpolate all point attributes of the input on
-  // each point of the output (unless they are turned off)
-  // Note that we are using only the first input, if there are more
-  // than one, the attributes have to match.
-  outputPD->InterpolateAllocate(input0->GetPointData());
-  // Note:  It is an overestimation to have the estimate the same number of
-  // output points and input points.  We sill have to squeeze at end.
-
-  vtkIdType numPtsTotal=0;
+  vtkIdType numPtsTotal = outputPoints->GetNumberOfPoints();
   double velocity[3];
 
+  // Used to record the cell search statistics of each streamline
+  vtkInterpolatedVelocityField* walker = 0;
+  if (lines->CellSearches[0])
+    {
+    walker = vtkInterpolatedVelocityField::SafeDownCast(func);
+    }
+
   int shouldAbort = 0;
 
-  for(int currentLine = 0; currentLine < numLines; currentLine++)
+  for(vtkIdType currentLine = begin; currentLine < end; currentLine++)
     {
 
     double progress = static_cast<double>(currentLine)/numLines;
-    this->UpdateProgress(progress);
+    if (reportProgress)
+      {
+      this->UpdateProgress(progress);
+      }
 
     switch (integrationDirections->GetValue(currentLine))
       {
@@ -720,6 +1047,7 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
     // Clear the last cell to avoid starting a search from
     // the last point in the streamline
     func->ClearLastCellId();
+    func->ClearStatistics();
 
     // Initial point
     seedSource->GetTuple(seedIds->GetId(currentLine), point1);
@@ -813,9 +1141,12 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
 
       if ( numSteps++ % 1000 == 1 )
         {
-        progress = 
-          ( currentLine + propagation / this->MaximumPropagation ) / numLines;
-        this->UpdateProgress(progress);
+        if (reportProgress)
+          {
+          progress = ( currentLine + propagation / this->MaximumPropagation )
+            / numLines;
+          this->UpdateProgress(progress);
+          }
 
         if (this->GetAbortExecute())
           {
@@ -848,7 +1179,8 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
           }
         maxStep = stepSize.Interval;
         }
-      this->LastUsedStepSize = stepSize.Interval;
+      lines->LastUsedStepSize = stepSize.Interval;
+      lines->HasLastUsedStepSize = 1;
           
       // Calculate the next step using the integrator provided
       // Break if the next point is out of bounds.
@@ -860,7 +1192,8 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
       if ( tmp != 0 )
         {
         retVal = tmp;
-        memcpy(lastPoint, point2, 3*sizeof(double));
+        memcpy(lines->LastPoint, point2, 3*sizeof(double));
+        lines->HasLastPoint = 1;
         break;
         }
 
@@ -893,7 +1226,8 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
       if ( !func->FunctionValues(point2, velocity) )
         {
         retVal = OUT_OF_DOMAIN;
-        memcpy(lastPoint, point2, 3*sizeof(double));
+        memcpy(lines->LastPoint, point2, 3*sizeof(double));
+        lines->HasLastPoint = 1;
         break;
         }
       // Make sure we use the dataset found by the vtkAbstractInterpolatedVelocityField
@@ -985,70 +1319,37 @@ void vtkStreamTracer::Integrate(vtkDataSet *input0,
         outputLines->InsertCellPoint(i);
         }
       retVals->InsertNextValue(retVal);
+      if (walker)
+        {
+        lines->CellSearches[0]->InsertNextValue(walker->GetCacheHit());
+        lines->CellSearches[1]->InsertNextValue(walker->GetWalkHit());
+        lines->CellSearches[2]->InsertNextValue(walker->GetWalkSteps());
+        lines->CellSearches[3]->InsertNextValue(walker->GetGlobalSearches());
+        }
       }
 
     // Initialize these to 0 before starting the next line.
     // The values passed in the function call are only used
     // for the first line.
-    inPropagation = propagation;
-    inNumSteps = numSteps;
+    lines->Propagation = propagation;
+    lines->NumberOfSteps = numSteps;
+    lines->HasPropagation = 1;
 
     propagation = 0;
     numSteps = 0;
     }
 
-  if (!shouldAbort)
-    {
-    // Create the output polyline
-    output->SetPoints(outputPoints);
-    outputPD->AddArray(time);
-    if (vorticity)
-      {
-      outputPD->AddArray(vorticity);
-      outputPD->AddArray(rotation);
-      outputPD->AddArray(angularVel);
-      }
-    
-    vtkIdType numPts = outputPoints->GetNumberOfPoints();
-    if ( numPts > 1 )
-      {
-      // Assign geometry and attributes
-      output->SetLines(outputLines);
-      if (this->GenerateNormalsInIntegrate)
-        {
-        this->GenerateNormals(output, 0, vecName);
-        }
-
-      outputCD->AddArray(retVals);
-      }
-    }
-
-  if (vorticity)
-    {
-    vorticity->Delete();
-    rotation->Delete();
-    angularVel->Delete();
-    }
+  lines->Aborted = shouldAbort;
 
   if (cellVectors)
     {
     cellVectors->Delete();
     }
-  retVals->Delete();
-
-  outputPoints->Delete();
-  outputLines->Delete();
-
-  time->Delete();
-
 
   integrator->Delete();
   cell->Delete();
 
   delete[] weights;
-  
-  output->Squeeze();
-  return;
 }
 
 void vtkStreamTracer::GenerateNormals(vtkPolyData* output, double* firstNormal, 
@@ -1261,6 +1562,7 @@ void vtkStreamTracer::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Vorticity computation: " 
      << (this->ComputeVorticity ? " On" : " Off") << endl;
   os << indent << "Rotation scale: " << this->RotationScale << endl;
+  os << indent << "Number of threads: " << this->NumberOfThreads << endl;
 }
 
 vtkExecutive* vtkStreamTracer::CreateDefaultExecutive()
@@ -30,7 +30,10 @@
 // flow field domain, or if the particle speed is reduced to a value less
 // than a specified terminal speed, or when a maximum number of steps is 
 // completed. The specific reason for the termination is stored in a cell 
-// array named ReasonForTermination.
+// array named ReasonForTermination.  When the interpolator prototype is a
+// vtkInterpolatedVelocityField with NeighborWalk on, the cell arrays
+// CacheHits, WalkHits, WalkSteps and GlobalSearches also count how the
+// cells of each streamline were found.
 //
 // Note that normalized vectors are adopted in streamline integration,
 // which achieves high numerical accuracy/smoothness of flow lines that is
@@ -67,6 +70,13 @@
 // a source object, traces will be generated from each point in the source
 // that is inside the dataset.
 //
+// Streamlines are integrated one seed after the other unless
+// NumberOfThreads is larger than one. The seeds are then split in ranges
+// that are integrated concurrently, each thread evaluating the velocity
+// with its own copy of the interpolator that shares the datasets and cell
+// locators of the others. The streamlines are output in seed order,
+// whatever the number of threads.
+//
 // .SECTION See Also
 // vtkRibbonFilter vtkRuledSurfaceFilter vtkInitialValueProblemSolver 
 // vtkRungeKutta2 vtkRungeKutta4 vtkRungeKutta45 vtkTemporalStreamTracer
@@ -89,6 +99,9 @@ class vtkGenericCell;
 class vtkIdList;
 class vtkIntArray;
 class vtkAbstractInterpolatedVelocityField;
+//BTX
+class vtkStreamTracerLines;
+//ETX
 
 class VTK_GRAPHICS_EXPORT vtkStreamTracer : public vtkPolyDataAlgorithm
 {
@@ -281,6 +294,14 @@ public:
   vtkSetMacro(RotationScale, double);
   vtkGetMacro(RotationScale, double);
 
+  // Description:
+  // Set/Get the number of threads integrating the streamlines. The
+  // default of 1 integrates them on the calling thread. The interpolator
+  // prototype must support evaluation from several threads through
+  // vtkAbstractInterpolatedVelocityField::ShareDataSets().
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
   // Description:
   // The object used to interpolate the velocity field during
   // integration is of the same class as this prototype.
@@ -324,6 +345,19 @@ protected:
                  const char *vecFieldName,
                  double& propagation,
                  vtkIdType& numSteps);
+//BTX
+  void IntegrateLines(vtkStreamTracerLines* lines,
+                      vtkIdType begin,
+                      vtkIdType end,
+                      vtkDataArray* seedSource, 
+                      vtkIdList* seedIds,
+                      vtkIntArray* integrationDirections,
+                      vtkAbstractInterpolatedVelocityField* func,
+                      int maxCellSize,
+                      const char *vecName,
+                      int reportProgress);
+  friend class vtkStreamTracerIntegrateFunctor;
+//ETX
   void SimpleIntegrate(double seed[3], 
                        double lastPoint[3], 
                        double stepSize,
@@ -379,6 +413,7 @@ protected:
 
   bool ComputeVorticity;
   double RotationScale;
+  int NumberOfThreads;
 
   vtkAbstractInterpolatedVelocityField * InterpolatorPrototype;
 
@@ -26,9 +26,11 @@
 #include "vtkLongArray.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
+#include "vtkParallelFor.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkShortArray.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredPoints.h"
 #include "vtkUnsignedCharArray.h"
@@ -36,11 +38,213 @@
 #include "vtkUnsignedLongArray.h"
 #include "vtkUnsignedShortArray.h"
 
+#include <vtkstd/vector>
+
 #include <math.h>
 
 vtkCxxRevisionMacro(vtkSynchronizedTemplates3D, "$Revision$");
 vtkStandardNewMacro(vtkSynchronizedTemplates3D);
 
+//----------------------------------------------------------------------------
+// The scalar range of bricks of BrickSize^3 cubes of an image, cube (i,j,k)
+// having its lower corner at point (i,j,k). A brick holding a NaN has an
+// infinite range so that it is never skipped.
+class vtkSynchronizedTemplates3DBrickIndex
+{
+public:
+  vtkstd::vector<double> Ranges; //min and max of each brick, x fastest
+  vtkstd::vector<unsigned char> ActiveRows; //rows of bricks along x
+  int Extent[6];    //the extent of the points the index was built for
+  int Dimensions[3]; //the number of bricks in each direction
+  int BrickSize;
+  int Component;
+  vtkDataArray *Scalars; //the scalars the index was built from
+  vtkTimeStamp BuildTime;
+
+  vtkSynchronizedTemplates3DBrickIndex()
+    {
+    this->Scalars = NULL;
+    this->BrickSize = this->Component = 0;
+    for (int i=0; i < 6; i++)
+      {
+      this->Extent[i] = 0;
+      }
+    this->Dimensions[0] = this->Dimensions[1] = this->Dimensions[2] = 0;
+    }
+
+  // Build the index unless it is up to date for these scalars.
+  void Build(vtkImageData *data, vtkDataArray *scalars, int component,
+             int brickSize);
+
+  // Find the rows of bricks that have a cube between columns xMin and xMax
+  // whose range contains value.
+  void FindActiveRows(double value, int xMin, int xMax);
+
+  // Return whether a cube using the edges of the points of row (j,k) may
+  // contain value, the cubes being restricted to those of the extent ext.
+  int IsRowActive(int j, int k, int *ext)
+    {
+    int jMin = (j-1 < ext[2] ? ext[2] : j-1);
+    int jMax = (j < ext[3] ? j : ext[3]-1);
+    int kMin = (k-1 < ext[4] ? ext[4] : k-1);
+    int kMax = (k < ext[5] ? k : ext[5]-1);
+    int size = this->BrickSize;
+    for (int bk=(kMin-this->Extent[4])/size;
+         bk <= (kMax-this->Extent[4])/size; bk++)
+      {
+      for (int bj=(jMin-this->Extent[2])/size;
+           bj <= (jMax-this->Extent[2])/size; bj++)
+        {
+        if (this->ActiveRows[bj + bk*this->Dimensions[1]])
+          {
+          return 1;
+          }
+        }
+      }
+    return 0;
+    }
+};
+
+//----------------------------------------------------------------------------
+// Computes the range of a set of bricks.
+template <class T>
+class vtkSynchronizedTemplates3DBrickFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkSynchronizedTemplates3DBrickIndex *Index;
+  T *Scalars; //the component at the first point of the extent
+  vtkIdType Increments[3];
+
+  void Execute(vtkIdType begin, vtkIdType end, int vtkNotUsed(threadId))
+    {
+    int *dims = this->Index->Dimensions;
+    int *ext = this->Index->Extent;
+    int size = this->Index->BrickSize;
+    for (vtkIdType brick=begin; brick < end; brick++)
+      {
+      int b[3], pMin[3], pMax[3];
+      b[0] = static_cast<int>(brick % dims[0]);
+      b[1] = static_cast<int>((brick / dims[0]) % dims[1]);
+      b[2] = static_cast<int>(brick / dims[0] / dims[1]);
+      for (int i=0; i < 3; i++)
+        {
+        pMin[i] = b[i]*size;
+        pMax[i] = pMin[i] + size;
+        if (pMax[i] > ext[2*i+1] - ext[2*i])
+          {
+          pMax[i] = ext[2*i+1] - ext[2*i];
+          }
+        }
+      double min = VTK_DOUBLE_MAX, max = -VTK_DOUBLE_MAX;
+      for (int k=pMin[2]; k <= pMax[2]; k++)
+        {
+        for (int j=pMin[1]; j <= pMax[1]; j++)
+          {
+          T *ptr = this->Scalars + pMin[0]*this->Increments[0] +
+            j*this->Increments[1] + k*this->Increments[2];
+          for (int i=pMin[0]; i <= pMax[0]; i++, ptr += this->Increments[0])
+            {
+            double s = static_cast<double>(*ptr);
+            if (s < min)
+              {
+              min = s;
+              }
+            if (s > max)
+              {
+              max = s;
+              }
+            if (s != s)
+              {
+              min = -VTK_DOUBLE_MAX;
+              max = VTK_DOUBLE_MAX;
+              }
+            }
+          }
+        }
+      this->Index->Ranges[2*brick] = min;
+      this->Index->Ranges[2*brick+1] = max;
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+void vtkSynchronizedTemplates3DBrickIndex::Build(vtkImageData *data,
+                                                 vtkDataArray *scalars,
+                                                 int component, int brickSize)
+{
+  int *ext = data->GetExtent();
+  if (this->Scalars == scalars && this->Component == component &&
+      this->BrickSize == brickSize && this->BuildTime > scalars->GetMTime() &&
+      this->Extent[0] == ext[0] && this->Extent[1] == ext[1] &&
+      this->Extent[2] == ext[2] && this->Extent[3] == ext[3] &&
+      this->Extent[4] == ext[4] && this->Extent[5] == ext[5])
+    {
+    return;
+    }
+
+  this->Scalars = scalars;
+  this->Component = component;
+  this->BrickSize = brickSize;
+  vtkIdType numBricks = 1;
+  for (int i=0; i < 3; i++)
+    {
+    this->Extent[2*i] = ext[2*i];
+    this->Extent[2*i+1] = ext[2*i+1];
+    this->Dimensions[i] = (ext[2*i+1] - ext[2*i] + brickSize - 1) / brickSize;
+    if (this->Dimensions[i] < 1)
+      {
+      this->Dimensions[i] = 1;
+      }
+    numBricks *= this->Dimensions[i];
+    }
+  this->Ranges.resize(2*numBricks);
+  this->ActiveRows.resize(this->Dimensions[1]*this->Dimensions[2]);
+
+  void *ptr = data->GetArrayPointerForExtent(scalars, ext);
+  vtkIdType increments[3];
+  increments[0] = scalars->GetNumberOfComponents();
+  increments[1] = increments[0]*(ext[1]-ext[0]+1);
+  increments[2] = increments[1]*(ext[3]-ext[2]+1);
+  vtkSmartPointer<vtkParallelFor> parallelFor =
+    vtkSmartPointer<vtkParallelFor>::New();
+  switch (scalars->GetDataType())
+    {
+    vtkTemplateMacro(
+      vtkSynchronizedTemplates3DBrickFunctor<VTK_TT> functor;
+      functor.Index = this;
+      functor.Scalars = static_cast<VTK_TT *>(ptr) + component;
+      functor.Increments[0] = increments[0];
+      functor.Increments[1] = increments[1];
+      functor.Increments[2] = increments[2];
+      parallelFor->Execute(0, numBricks, &functor));
+    }
+
+  this->BuildTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkSynchronizedTemplates3DBrickIndex::FindActiveRows(double value,
+                                                          int xMin, int xMax)
+{
+  int size = this->BrickSize;
+  int bMin = (xMin - this->Extent[0]) / size;
+  int bMax = (xMax - 1 - this->Extent[0]) / size;
+  int numRows = this->Dimensions[1]*this->Dimensions[2];
+  for (int row=0; row < numRows; row++)
+    {
+    double *range = &this->Ranges[2*(row*this->Dimensions[0] + bMin)];
+    this->ActiveRows[row] = 0;
+    for (int b=bMin; b <= bMax; b++, range += 2)
+      {
+      if (range[0] <= value && value <= range[1])
+        {
+        this->ActiveRows[row] = 1;
+        break;
+        }
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 // Description:
 // Construct object with initial scalar range (0,1) and single contour value
@@ -58,6 +262,10 @@ vtkSynchronizedTemplates3D::vtkSynchronizedTemplates3D()
 
   this->ArrayComponent = 0;
 
+  this->UseBrickIndex = 0;
+  this->BrickSize = 16;
+  this->BrickIndex = new vtkSynchronizedTemplates3DBrickIndex;
+
   // by default process active point scalars
   this->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,
                                vtkDataSetAttributes::SCALARS);
@@ -67,6 +275,7 @@ vtkSynchronizedTemplates3D::vtkSynchronizedTemplates3D()
 vtkSynchronizedTemplates3D::~vtkSynchronizedTemplates3D()
 {
   this->ContourValues->Delete();
+  delete this->BrickIndex;
 }
 
 //----------------------------------------------------------------------------
@@ -255,7 +464,8 @@ template <class T>
 void ContourImage(vtkSynchronizedTemplates3D *self, int *exExt,
                   vtkInformation *inInfo,
                   vtkImageData *data, vtkPolyData *output, T *ptr, 
-                  vtkDataArray *inScalars)
+                  vtkDataArray *inScalars,
+                  vtkSynchronizedTemplates3DBrickIndex *index)
 {
   int *inExt = data->GetExtent();
   int xdim = exExt[1] - exExt[0] + 1;
@@ -365,12 +575,27 @@ void ContourImage(vtkSynchronizedTemplates3D *self, int *exExt,
     isect1[((ydim-1)*xdim + i)*3 + 1] = -1;
     isect1[((ydim-1)*xdim + i)*3*2 + 1] = -1;
     }
+  // the rows of each buffer known to hold no edge points
+  char *cleared = NULL;
+  char *cleared2 = NULL;
+  if (index)
+    {
+    cleared = new char [ydim*2];
+    for (i = 0; i < ydim*2; i++)
+      {
+      cleared[i] = 0;
+      }
+    }
 
   // for each contour
   for (vidx = 0; vidx < numContours; vidx++)
     {
     value = values[vidx];
     inPtrZ = ptr;
+    if (index)
+      {
+      index->FindActiveRows(value, xMin, xMax);
+      }
 
     //==================================================================
     for (k = zMin; k <= zMax; k++)
@@ -389,6 +614,7 @@ void ContourImage(vtkSynchronizedTemplates3D *self, int *exExt,
         offsets[11] = zstep*3;
         isect1Ptr = isect1;
         isect2Ptr = isect1 + xdim*ydim*3;
+        cleared2 = cleared + ydim;
         }
       else
         { 
@@ -398,11 +624,33 @@ void ContourImage(vtkSynchronizedTemplates3D *self, int *exExt,
         offsets[11] = -zstep*3;
         isect1Ptr = isect1 + xdim*ydim*3;
         isect2Ptr = isect1;
+        cleared2 = cleared;
         }
 
       inPtrY = inPtrZ;
       for (j = yMin; j <= yMax; j++)
         {
+        // No edge of the row crosses the value if none of the bricks of the
+        // cubes using them spans it. Clear its edges unless they already are.
+        if (index)
+          {
+          if (!index->IsRowActive(j, k, exExt))
+            {
+            if (!cleared2[j-yMin])
+              {
+              for (i = 0; i < xdim*3; i++)
+                {
+                isect2Ptr[i] = -1;
+                }
+              cleared2[j-yMin] = 1;
+              }
+            isect2Ptr += xdim*3;
+            isect1Ptr += xdim*3;
+            inPtrY += yInc;
+            continue;
+            }
+          cleared2[j-yMin] = 0;
+          }
         // Should not impact perfomance here/
         edgePtId = (j-inExt[2])*yInc + (k-inExt[4])*zInc;
         // Increments are different for cells.  Since the cells are not
@@ -606,6 +854,7 @@ void ContourImage(vtkSynchronizedTemplates3D *self, int *exExt,
       }
     }
   delete [] isect1;
+  delete [] cleared;
 
   if (newScalars)
     {
@@ -698,12 +947,20 @@ void vtkSynchronizedTemplates3D::ThreadedExecute(vtkImageData *data,
     return;
     }
   
+  vtkSynchronizedTemplates3DBrickIndex *index = NULL;
+  if (this->UseBrickIndex)
+    {
+    this->BrickIndex->Build(data, inScalars, this->ArrayComponent,
+                            this->BrickSize);
+    index = this->BrickIndex;
+    }
+
   ptr = data->GetArrayPointerForExtent(inScalars, exExt);
   switch (inScalars->GetDataType())
     {
     vtkTemplateMacro(
       ContourImage(this, exExt, inInfo, data, output, 
-                   (VTK_TT *)ptr, inScalars));
+                   (VTK_TT *)ptr, inScalars, index));
     }
 }
 
@@ -857,6 +1114,8 @@ void vtkSynchronizedTemplates3D::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Compute Gradients: " << (this->ComputeGradients ? "On\n" : "Off\n");
   os << indent << "Compute Scalars: " << (this->ComputeScalars ? "On\n" : "Off\n");
   os << indent << "ArrayComponent: " << this->ArrayComponent << endl;
+  os << indent << "Use Brick Index: " << (this->UseBrickIndex ? "On\n" : "Off\n");
+  os << indent << "Brick Size: " << this->BrickSize << endl;
 }
 
 
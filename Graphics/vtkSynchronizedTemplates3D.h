@@ -18,6 +18,13 @@
 // vtkSynchronizedTemplates3D is a 3D implementation of the synchronized 
 // template algorithm. Note that vtkContourFilter will automatically
 // use this class when appropriate.
+//
+// When contouring the same image at many values, e.g. while exploring
+// isovalues interactively, UseBrickIndex lets the filter keep the scalar
+// range of bricks of BrickSize^3 voxels. The index is built once for the
+// scalars, and again only when they are modified, and the rows of voxels
+// whose bricks do not span a contour value are skipped without reading
+// their scalars.
 
 // .SECTION Caveats
 // This filter is specialized to 3D images (aka volumes).
@@ -32,6 +39,7 @@
 #include "vtkContourValues.h" // Passes calls through
 
 class vtkImageData;
+class vtkSynchronizedTemplates3DBrickIndex;
 
 class VTK_GRAPHICS_EXPORT vtkSynchronizedTemplates3D : public vtkPolyDataAlgorithm
 {
@@ -135,6 +143,22 @@ public:
   vtkSetMacro(ArrayComponent, int);
   vtkGetMacro(ArrayComponent, int);
 
+  // Description:
+  // Set/Get whether to keep the scalar range of bricks of voxels in order
+  // to skip the parts of the image that do not span a contour value. The
+  // index is built on the first execution and kept until the scalars,
+  // their extent, ArrayComponent or BrickSize change. Off by default.
+  vtkSetMacro(UseBrickIndex,int);
+  vtkGetMacro(UseBrickIndex,int);
+  vtkBooleanMacro(UseBrickIndex,int);
+
+  // Description:
+  // Set/Get the number of voxels along each side of the bricks of the
+  // index. Smaller bricks skip more voxels but take more memory and more
+  // time to check for each contour value. Defaults to 16.
+  vtkSetClampMacro(BrickSize,int,1,VTK_LARGE_INTEGER);
+  vtkGetMacro(BrickSize,int);
+
 protected:
   vtkSynchronizedTemplates3D();
   ~vtkSynchronizedTemplates3D();
@@ -152,6 +176,10 @@ protected:
 
   int ArrayComponent;
 
+  int UseBrickIndex;
+  int BrickSize;
+  vtkSynchronizedTemplates3DBrickIndex *BrickIndex;
+
 private:
   vtkSynchronizedTemplates3D(const vtkSynchronizedTemplates3D&);  // Not implemented.
   void operator=(const vtkSynchronizedTemplates3D&);  // Not implemented.
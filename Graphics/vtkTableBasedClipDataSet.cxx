@@ -1589,6 +1589,7 @@ vtkTableBasedClipDataSet::vtkTableBasedClipDataSet( vtkImplicitFunction * cf )
   this->UseValueAsOffset      = true;
   this->GenerateClipScalars   = 0;
   this->GenerateClippedOutput = 0;
+  this->MergePointsByEdge     = 0;
 
   this->SetNumberOfOutputPorts( 2 );
   vtkUnstructuredGrid * output2 = vtkUnstructuredGrid::New();
@@ -2003,6 +2004,7 @@ void vtkTableBasedClipDataSet::ClipDataSet( vtkDataSet * pDataSet,
   clipData->SetClipFunction( this->ClipFunction );
   clipData->SetUseValueAsOffset( this->UseValueAsOffset );
   clipData->SetGenerateClipScalars( this->GenerateClipScalars );
+  clipData->SetMergePointsByEdge( this->MergePointsByEdge );
   
   if ( !this->ClipFunction )
     {
@@ -3472,4 +3474,7 @@ void vtkTableBasedClipDataSet::PrintSelf( ostream & os, vtkIndent indent )
 
   os << indent << "UseValueAsOffset: " 
      << (this->UseValueAsOffset ? "On\n" : "Off\n");
+
+  os << indent << "Merge Points By Edge: " 
+     << (this->MergePointsByEdge ? "On\n" : "Off\n");
 }
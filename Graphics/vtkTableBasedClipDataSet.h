@@ -171,6 +171,15 @@ public:
   vtkSetClampMacro( MergeTolerance, double, 0.0001, 0.25 );
   vtkGetMacro( MergeTolerance, double );
   
+  // Description:
+  // Set/Get whether the grids this filter hands to vtkClipDataSet have their
+  // points merged by input edge instead of by position. See
+  // vtkClipDataSet::SetMergePointsByEdge(). The grids clipped with the case
+  // tables always merge their points by edge. Off by default.
+  vtkSetMacro( MergePointsByEdge, int );
+  vtkGetMacro( MergePointsByEdge, int );
+  vtkBooleanMacro( MergePointsByEdge, int );
+  
   // Description:
   // Create a default point locator when none is specified. The point locator is
   // used to merge coincident points.
@@ -259,6 +268,7 @@ protected:
   int    InsideOut;
   int    GenerateClipScalars;
   int    GenerateClippedOutput;
+  int    MergePointsByEdge;
   bool   UseValueAsOffset;
   double Value;
   double MergeTolerance;
@@ -20,13 +20,109 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkParallelFor.h"
 #include "vtkPointData.h"
+#include "vtkSmartPointer.h"
 
 #include <math.h>
+#include <vtkstd/vector>
 
 vtkCxxRevisionMacro(vtkVectorNorm, "$Revision$");
 vtkStandardNewMacro(vtkVectorNorm);
 
+// Computes the norms of a range of vectors and the largest norm seen by
+// each thread.  With Normalize set, divides a range of norms by
+// MaxScalar instead.
+class vtkVectorNormFunctor : public vtkParallelForFunctor
+{
+public:
+  vtkVectorNorm *Filter;
+  vtkDataArray *Vectors;
+  float *Scalars;
+  vtkIdType NumberOfVectors;
+  double ProgressOffset;
+  int Normalize;
+  double MaxScalar;
+  vtkstd::vector<double> ThreadMaxScalar;
+  int Abort;
+
+  virtual void Initialize(int numberOfThreads)
+    {
+    this->ThreadMaxScalar.assign(numberOfThreads, 0.0);
+    this->Abort = 0;
+    }
+
+  virtual void Execute(vtkIdType begin, vtkIdType end, int threadId)
+    {
+    vtkIdType i;
+    if ( this->Normalize )
+      {
+      for (i=begin; i < end; i++)
+        {
+        this->Scalars[i] = 
+          static_cast<float>(this->Scalars[i] / this->MaxScalar);
+        }
+      return;
+      }
+
+    // Only the calling thread reports progress.
+    if ( threadId == 0 )
+      {
+      this->Filter->UpdateProgress(
+        this->ProgressOffset + 0.5*begin/this->NumberOfVectors);
+      this->Abort = this->Filter->GetAbortExecute();
+      }
+    if ( this->Abort )
+      {
+      return;
+      }
+
+    double v[3], s;
+    double maxScalar = this->ThreadMaxScalar[threadId];
+    for (i=begin; i < end; i++)
+      {
+      this->Vectors->GetTuple(i, v);
+      s = sqrt((double)v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
+      if ( s > maxScalar )
+        {
+        maxScalar = s;
+        }
+      this->Scalars[i] = static_cast<float>(s);
+      }
+    this->ThreadMaxScalar[threadId] = maxScalar;
+    }
+
+  virtual void Reduce()
+    {
+    if ( this->Normalize )
+      {
+      return;
+      }
+    vtkstd::vector<double>::iterator it;
+    for (it = this->ThreadMaxScalar.begin();
+         it != this->ThreadMaxScalar.end(); ++it)
+      {
+      if ( *it > this->MaxScalar )
+        {
+        this->MaxScalar = *it;
+        }
+      }
+    }
+
+  // Compute the norms, then normalize them if requested.
+  void Run(vtkParallelFor *parallelFor, int normalize)
+    {
+    this->Normalize = 0;
+    this->MaxScalar = 0.0;
+    parallelFor->Execute(0, this->NumberOfVectors, this);
+    if ( normalize && this->MaxScalar > 0.0 && !this->Abort )
+      {
+      this->Normalize = 1;
+      parallelFor->Execute(0, this->NumberOfVectors, this);
+      }
+    }
+};
+
 // Construct with normalize flag off.
 vtkVectorNorm::vtkVectorNorm()
 {
@@ -49,10 +145,9 @@ int vtkVectorNorm::RequestData(
   vtkDataSet *output = vtkDataSet::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType numVectors, i;
+  vtkIdType numVectors;
   int computePtScalars=1, computeCellScalars=1;
   vtkFloatArray *newScalars;
-  double v[3], s, maxScalar;
   vtkDataArray *ptVectors, *cellVectors;
   vtkPointData *pd=input->GetPointData(), *outPD=output->GetPointData();
   vtkCellData *cd=input->GetCellData(), *outCD=output->GetCellData();
@@ -81,43 +176,25 @@ int vtkVectorNorm::RequestData(
     return 1;
     }
 
+  // The norms are computed on several threads for large inputs.
+  vtkVectorNormFunctor functor;
+  functor.Filter = this;
+  vtkSmartPointer<vtkParallelFor> parallelFor =
+    vtkSmartPointer<vtkParallelFor>::New();
+
   // Allocate / operate on point data
-  int abort=0;
-  vtkIdType progressInterval;
   if ( computePtScalars )
     {
     numVectors = ptVectors->GetNumberOfTuples();
     newScalars = vtkFloatArray::New();
     newScalars->SetNumberOfTuples(numVectors);
 
-    progressInterval=numVectors/10+1;
-    for (maxScalar=0.0, i=0; i < numVectors && !abort; i++)
-      {
-      ptVectors->GetTuple(i, v);
-      s = sqrt((double)v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
-      if ( s > maxScalar )
-        {
-        maxScalar = s;
-        }
-      newScalars->SetComponent(i,0,s);
-
-      if ( ! (i % progressInterval) ) 
-        {
-        vtkDebugMacro(<<"Computing point vector norm #" << i);
-        this->UpdateProgress (0.5*i/numVectors);
-        }
-      }
-
-    // If necessary, normalize
-    if ( this->Normalize && maxScalar > 0.0 )
-      {
-      for (i=0; i < numVectors; i++)
-        {
-        s = newScalars->GetComponent(i,0);
-        s /= maxScalar;
-        newScalars->SetComponent(i,0,s);
-        }
-      }
+    vtkDebugMacro(<<"Computing point vector norms");
+    functor.Vectors = ptVectors;
+    functor.Scalars = newScalars->GetPointer(0);
+    functor.NumberOfVectors = numVectors;
+    functor.ProgressOffset = 0.0;
+    functor.Run(parallelFor, this->Normalize);
 
     int idx = outPD->AddArray(newScalars);
     outPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
@@ -132,33 +209,12 @@ int vtkVectorNorm::RequestData(
     newScalars = vtkFloatArray::New();
     newScalars->SetNumberOfTuples(numVectors);
 
-    progressInterval=numVectors/10+1;
-    for (maxScalar=0.0, i=0; i < numVectors && !abort; i++)
-      {
-      cellVectors->GetTuple(i, v);
-      s = sqrt((double)v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
-      if ( s > maxScalar )
-        {
-        maxScalar = s;
-        }
-      newScalars->SetComponent(i,0,s);
-      if ( ! (i % progressInterval) ) 
-        {
-        vtkDebugMacro(<<"Computing cell vector norm #" << i);
-        this->UpdateProgress (0.5+0.5*i/numVectors);
-        }
-      }
-
-    // If necessary, normalize
-    if ( this->Normalize && maxScalar > 0.0 )
-      {
-      for (i=0; i < numVectors; i++)
-        {
-        s = newScalars->GetComponent(i,0);
-        s /= maxScalar;
-        newScalars->SetComponent(i,0,s);
-        }
-      }
+    vtkDebugMacro(<<"Computing cell vector norms");
+    functor.Vectors = cellVectors;
+    functor.Scalars = newScalars->GetPointer(0);
+    functor.NumberOfVectors = numVectors;
+    functor.ProgressOffset = 0.5;
+    functor.Run(parallelFor, this->Normalize);
 
     int idx = outCD->AddArray(newScalars);
     outCD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
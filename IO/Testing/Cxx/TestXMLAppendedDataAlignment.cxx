@@ -0,0 +1,107 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile$
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Write an image with raw appended data, with and without aligned blocks,
+// and read it back with memory mapping on.  The aligned arrays must be
+// mapped, and both files must read back the same values.
+
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+
+#include <vtksys/SystemTools.hxx>
+
+static int CheckArray(vtkDataArray *a1, vtkDataArray *a2, int mapped,
+                      int align)
+{
+  if (!a2 || a1->GetNumberOfTuples() != a2->GetNumberOfTuples())
+    {
+    cerr << a1->GetName() << " not read back with alignment " << align
+         << endl;
+    return 1;
+    }
+  if (mapped && !a2->GetMemoryMapped())
+    {
+    cerr << a1->GetName() << " not mapped from the aligned file" << endl;
+    return 1;
+    }
+  for (vtkIdType i=0; i < a1->GetNumberOfTuples(); i++)
+    {
+    if (a1->GetTuple1(i) != a2->GetTuple1(i))
+      {
+      cerr << a1->GetName() << " differs at " << i << " with alignment "
+           << align << endl;
+      return 1;
+      }
+    }
+  return 0;
+}
+
+int TestXMLAppendedDataAlignment(int argc, char *argv[])
+{
+  // An odd number of bytes first, so the next block is misaligned
+  // unless padded.
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(11, 11, 11);
+  vtkIdType numPoints = image->GetNumberOfPoints();
+  vtkSmartPointer<vtkUnsignedCharArray> bytes =
+    vtkSmartPointer<vtkUnsignedCharArray>::New();
+  bytes->SetName("Bytes");
+  vtkSmartPointer<vtkDoubleArray> values =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  values->SetName("Values");
+  for (vtkIdType i=0; i < numPoints; i++)
+    {
+    bytes->InsertNextValue(static_cast<unsigned char>(i % 251));
+    values->InsertNextValue(0.25*i - 100.0);
+    }
+  image->GetPointData()->AddArray(bytes);
+  image->GetPointData()->AddArray(values);
+
+  char *fileName = vtkTestUtilities::ExpandFileNameWithArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", ".",
+    "TestXMLAppendedDataAlignment.vti");
+
+  int rval = 0;
+  for (int align=0; align < 2; align++)
+    {
+    vtkSmartPointer<vtkXMLImageDataWriter> writer =
+      vtkSmartPointer<vtkXMLImageDataWriter>::New();
+    writer->SetInput(image);
+    writer->SetFileName(fileName);
+    writer->SetDataModeToAppended();
+    writer->EncodeAppendedDataOff();
+    writer->SetCompressor(0);
+    writer->SetAlignAppendedData(align);
+    writer->Write();
+
+    vtkSmartPointer<vtkXMLImageDataReader> reader =
+      vtkSmartPointer<vtkXMLImageDataReader>::New();
+    reader->SetFileName(fileName);
+    reader->UseMemoryMapOn();
+    reader->Update();
+    vtkPointData *pd = reader->GetOutput()->GetPointData();
+    rval += CheckArray(bytes, pd->GetArray("Bytes"), align, align);
+    rval += CheckArray(values, pd->GetArray("Values"), align, align);
+    }
+
+  vtksys::SystemTools::RemoveFile(fileName);
+  delete [] fileName;
+  return rval;
+}
@@ -69,6 +69,8 @@ vtkImageReader2::vtkImageReader2()
   this->FileNameSliceOffset = 0;
   this->FileNameSliceSpacing = 1;
 
+  this->UseMemoryMap = 0;
+
   // Left over from short reader
   this->SwapBytes = 0;
   this->FileLowerLeft = 0;
@@ -453,6 +455,8 @@ void vtkImageReader2::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Swap Bytes: " << (this->SwapBytes ? "On\n" : "Off\n");
 
+  os << indent << "UseMemoryMap: " << (this->UseMemoryMap ? "On\n" : "Off\n");
+
   os << indent << "DataIncrements: (" << this->DataIncrements[0];
   for (idx = 1; idx < 2; ++idx)
     {
@@ -793,11 +797,87 @@ void vtkImageReader2Update(vtkImageReader2 *self, vtkImageData *data, OT *outPtr
     }
 }
 
+//----------------------------------------------------------------------------
+int vtkImageReader2::MapOutputData(vtkDataObject *output)
+{
+  vtkImageData *data = vtkImageData::SafeDownCast(output);
+  if (!data || (!this->FileName && !this->FilePattern) ||
+      this->GetSwapBytes())
+    {
+    return 0;
+    }
+
+  int ext[6];
+  this->GetExecutive()->GetOutputInformation(0)->Get(
+    vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), ext);
+
+  // The rows of the extent must follow each other in the file.
+  if (ext[0] != this->DataExtent[0] || ext[1] != this->DataExtent[1] ||
+      ext[2] != this->DataExtent[2] || ext[3] != this->DataExtent[3] ||
+      (!this->FileLowerLeft && ext[2] != ext[3]))
+    {
+    return 0;
+    }
+  // So must the slices.
+  int fileDimensionality = this->GetFileDimensionality();
+  if (fileDimensionality != 3 &&
+      !(fileDimensionality == 2 && ext[4] == ext[5]))
+    {
+    return 0;
+    }
+
+  this->ComputeDataIncrements();
+  vtkTypeInt64 offset = static_cast<vtkTypeInt64>(this->GetHeaderSize(ext[4]));
+  if (fileDimensionality == 3)
+    {
+    offset += static_cast<vtkTypeInt64>(ext[4] - this->DataExtent[4]) *
+      static_cast<vtkTypeInt64>(this->DataIncrements[2]);
+    this->ComputeInternalFileName(0);
+    }
+  else
+    {
+    this->ComputeInternalFileName(ext[4]);
+    }
+
+  vtkDataArray *scalars = vtkDataArray::CreateDataArray(this->DataScalarType);
+  if (!scalars)
+    {
+    return 0;
+    }
+  vtkIdType numberOfValues = static_cast<vtkIdType>(
+    this->NumberOfScalarComponents) * (ext[1] - ext[0] + 1) *
+    (ext[3] - ext[2] + 1) * (ext[5] - ext[4] + 1);
+  int mapped = 0;
+  if (offset % scalars->GetDataTypeSize() == 0)
+    {
+    // Downstream filters may modify the scalars in place.
+    scalars->SetNumberOfComponents(this->NumberOfScalarComponents);
+    mapped = scalars->MapFile(this->InternalFileName, offset,
+                              numberOfValues, 1);
+    }
+  if (mapped)
+    {
+    vtkDebugMacro("Mapped extent: " << ext[0] << ", " << ext[1] << ", "
+                  << ext[2] << ", " << ext[3] << ", " << ext[4] << ", "
+                  << ext[5]);
+    data->SetExtent(ext);
+    scalars->SetName("ImageFile");
+    data->GetPointData()->SetScalars(scalars);
+    }
+  scalars->Delete();
+  return mapped;
+}
+
 //----------------------------------------------------------------------------
 // This function reads a data from a file.  The datas extent/axes
 // are assumed to be the same as the file extent/order.
 void vtkImageReader2::ExecuteData(vtkDataObject *output)
 {
+  if (this->UseMemoryMap && this->MapOutputData(output))
+    {
+    return;
+    }
+
   vtkImageData *data = this->AllocateOutputData(output);
   
   void *ptr;
@@ -181,6 +181,19 @@ public:
   vtkGetMacro(FileLowerLeft, int);
   vtkSetMacro(FileLowerLeft, int);
 
+  // Description:
+  // When on, the output scalars are mapped from the file instead of being
+  // read into memory whenever the file layout allows it: a single file
+  // holds the requested extent contiguously (all of the x and y range of
+  // DataExtent, stored lower left first unless there is only one row) and
+  // no byte swapping is needed.  Pages are then read from the file as
+  // they are accessed and changes to them are not written back.  Other
+  // requests are read as usual.  Readers that override ExecuteData() may
+  // ignore this flag.  Off by default.
+  vtkSetMacro(UseMemoryMap, int);
+  vtkGetMacro(UseMemoryMap, int);
+  vtkBooleanMacro(UseMemoryMap, int);
+
   // Description:
   // Set/Get the internal file name
   virtual void ComputeInternalFileName(int slice);
@@ -242,6 +255,8 @@ protected:
 
   int FileNameSliceOffset;
   int FileNameSliceSpacing;
+
+  int UseMemoryMap;
   
   virtual int RequestInformation(vtkInformation* request,
                                  vtkInformationVector** inputVector,
@@ -249,6 +264,10 @@ protected:
   virtual void ExecuteInformation();
   virtual void ExecuteData(vtkDataObject *data);
   virtual void ComputeDataIncrements();
+
+  // Map the requested extent of the file into the output scalars.
+  // Returns 0 if the file layout does not allow it.
+  virtual int MapOutputData(vtkDataObject *output);
 private:
   vtkImageReader2(const vtkImageReader2&);  // Not implemented.
   void operator=(const vtkImageReader2&);  // Not implemented.
@@ -43,6 +43,7 @@ vtkXMLDataParser::vtkXMLDataParser()
   this->DataStream = 0;
   this->InlineDataStream = vtkBase64InputStream::New();
   this->AppendedDataStream = vtkBase64InputStream::New();
+  this->AppendedDataRaw = 0;
 
   this->BlockCompressedSizes = 0;
   this->BlockStartOffsets = 0;
@@ -164,6 +165,7 @@ void vtkXMLDataParser::StartElement(const char* name, const char** atts)
       {
       this->AppendedDataStream->Delete();
       this->AppendedDataStream = vtkInputStream::New();
+      this->AppendedDataRaw = 1;
       }
     }
 }
@@ -837,6 +839,46 @@ vtkXMLDataParser::ReadBinaryData(void* in_buffer,
   return this->Abort? 0:actualWords;
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLDataParser::GetRawAppendedDataPosition(OffsetType offset,
+                                                 OffsetType startWord,
+                                                 OffsetType numWords,
+                                                 int wordType,
+                                                 OffsetType& position)
+{
+  unsigned long wordSize = this->GetWordTypeSize(wordType);
+#ifdef VTK_WORDS_BIGENDIAN
+  int nativeByteOrder = vtkXMLDataParser::BigEndian;
+#else
+  int nativeByteOrder = vtkXMLDataParser::LittleEndian;
+#endif
+  if(!this->AppendedDataRaw || this->Compressor || this->Abort ||
+     wordSize == 0 || (wordSize > 1 && this->ByteOrder != nativeByteOrder))
+    {
+    return 0;
+    }
+
+  // The block starts with its length.
+  HeaderType rsize;
+  const unsigned long len = sizeof(HeaderType);
+  this->SeekG(this->AppendedDataPosition+offset);
+  if(!this->Stream->read(reinterpret_cast<char*>(&rsize), len))
+    {
+    this->Stream->clear(this->Stream->rdstate() & ~ios::failbit);
+    this->Stream->clear(this->Stream->rdstate() & ~ios::eofbit);
+    return 0;
+    }
+  this->PerformByteSwap(&rsize, 1, len);
+  if((startWord+numWords)*static_cast<OffsetType>(wordSize) >
+     static_cast<OffsetType>(rsize))
+    {
+    return 0;
+    }
+
+  position = this->AppendedDataPosition + offset + len + startWord*wordSize;
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 vtkXMLDataParser::OffsetType
 vtkXMLDataParser::ReadAsciiData(void* buffer,
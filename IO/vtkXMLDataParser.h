@@ -79,6 +79,16 @@ public:
     { return this->ReadAppendedData(offset, buffer, startWord, numWords,
                                     VTK_CHAR); }
 
+  // Description:
+  // Find where the given words of an appended data block are stored in
+  // the file.  Returns 1 and sets position to the file offset of the
+  // first word if they are stored as they are in memory, that is with
+  // raw encoding, no compression and native byte order.  Returns 0
+  // otherwise, in which case they must be read with ReadAppendedData.
+  int GetRawAppendedDataPosition(OffsetType offset, OffsetType startWord,
+                                 OffsetType numWords, int wordType,
+                                 OffsetType& position);
+
   // Description:
   // Read from an ascii data section starting at the current position in
   // the stream.  Returns the number of words read.
@@ -212,6 +222,9 @@ protected:
   // The stream to use for appended data.
   vtkInputStream* AppendedDataStream;
 
+  // Whether the appended data are stored without encoding.
+  int AppendedDataRaw;
+
   //BTX
   // We need a 32 bit unsigned integer type for platform-independent
   // binary headers.  Note that this is duplicated in vtkXMLWriter.h.
@@ -52,6 +52,8 @@ vtkXMLDataReader::vtkXMLDataReader()
   this->PointDataOffset = NULL;
   this->CellDataTimeStep = NULL;
   this->CellDataOffset = NULL;
+
+  this->UseMemoryMap = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -82,6 +84,7 @@ vtkXMLDataReader::~vtkXMLDataReader()
 void vtkXMLDataReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "UseMemoryMap: " << this->UseMemoryMap << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -757,6 +760,14 @@ int vtkXMLDataReader::ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayInde
     {
     return 0;
     }
+  // Arrays read whole may be mapped from the file.
+  if (this->UseMemoryMap && arrayIndex == 0 &&
+      numValues == array->GetNumberOfTuples()*array->GetNumberOfComponents() &&
+      this->MapArrayValues(da, array, startIndex, numValues))
+    {
+    return 1;
+    }
+
   this->InReadData = 1;
   int result;
   // All arrays types except vtkBitArray.
@@ -777,6 +788,35 @@ int vtkXMLDataReader::ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayInde
   return result;
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLDataReader::MapArrayValues(vtkXMLDataElement* da,
+                                     vtkAbstractArray* array,
+                                     vtkIdType startIndex,
+                                     vtkIdType numValues)
+{
+  vtkDataArray* dataArray = vtkDataArray::SafeDownCast(array);
+  // Only data read from FileName can be mapped from it.
+  if (!dataArray || dataArray->GetDataType() == VTK_BIT ||
+      !this->FileName || !this->IsReadingFromFile() ||
+      !da->GetAttribute("offset") || numValues <= 0)
+    {
+    return 0;
+    }
+
+  unsigned long offset = 0;
+  da->GetScalarAttribute("offset", offset);
+  vtkXMLDataParser::OffsetType position;
+  if (!this->XMLParser->GetRawAppendedDataPosition(
+        offset, startIndex, numValues, dataArray->GetDataType(), position) ||
+      position % dataArray->GetDataTypeSize() != 0)
+    {
+    return 0;
+    }
+
+  // Downstream filters may modify the values in place.
+  return dataArray->MapFile(this->FileName, position, numValues, 1);
+}
+
 //----------------------------------------------------------------------------
 void vtkXMLDataReader::DataProgressCallbackFunction(vtkObject*, unsigned long,
                                                     void* clientdata, void*)
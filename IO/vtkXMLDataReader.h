@@ -44,6 +44,18 @@ public:
   // SetupOutputInformation to outInfo
   virtual void CopyOutputInformation(vtkInformation *outInfo, int port);
 
+  // Description:
+  // When on, arrays stored uncompressed in a raw appended data section
+  // are mapped from the file instead of being read into memory, provided
+  // they are in the native byte order, suitably aligned in the file (see
+  // vtkXMLWriter::SetAlignAppendedData()) and read whole into an output
+  // array.  Pages are then read from the file as they are accessed and
+  // changes to them are not written back.  Other arrays, and data read
+  // from a stream set by the caller, are read as usual.  Off by default.
+  vtkSetMacro(UseMemoryMap, int);
+  vtkGetMacro(UseMemoryMap, int);
+  vtkBooleanMacro(UseMemoryMap, int);
+
 protected:
   vtkXMLDataReader();
   ~vtkXMLDataReader();  
@@ -87,6 +99,12 @@ protected:
   // values will be put in the array.
   int ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayIndex, vtkAbstractArray* array,
     vtkIdType startIndex, vtkIdType numValues);
+
+  // Map numValues values starting at startIndex from the file as the
+  // whole content of the array.  Returns 0 if they are not stored in a
+  // form that can be mapped.
+  int MapArrayValues(vtkXMLDataElement* da, vtkAbstractArray* array,
+                     vtkIdType startIndex, vtkIdType numValues);
     
 
   
@@ -128,6 +146,8 @@ protected:
   int *CellDataTimeStep;
   unsigned long *CellDataOffset;
   int CellDataNeedToReadTimeStep(vtkXMLDataElement *eNested);
+
+  int UseMemoryMap;
  
 private:
   vtkXMLDataReader(const vtkXMLDataReader&);  // Not implemented.
@@ -268,6 +268,10 @@ protected:
 
   vtkDataObject* GetCurrentOutput();
   vtkInformation* GetCurrentOutputInformation();
+
+  // Whether the input is read from FileName, and not from a stream set by
+  // the caller.
+  int IsReadingFromFile() { return this->FileStream != 0; }
   
 private:
   // The stream used to read the input if it is in a file.
@@ -247,6 +247,7 @@ vtkXMLWriter::vtkXMLWriter()
   this->ByteSwapBuffer = 0;
 
   this->EncodeAppendedData = 1;
+  this->AlignAppendedData = 0;
   this->AppendedDataPosition = 0;
   this->DataMode = vtkXMLWriter::Appended;
   this->ProgressRange[0] = 0;
@@ -349,6 +350,7 @@ void vtkXMLWriter::PrintSelf(ostream& os, vtkIndent indent)
     os << indent << "Compressor: (none)\n";
     }
   os << indent << "EncodeAppendedData: " << this->EncodeAppendedData << "\n";
+  os << indent << "AlignAppendedData: " << this->AlignAppendedData << "\n";
   os << indent << "BlockSize: " << this->BlockSize << "\n";
   if(this->Stream)
     {
@@ -1762,6 +1764,22 @@ void vtkXMLWriter::WriteArrayAppended(
 void vtkXMLWriter::WriteArrayAppendedData(vtkAbstractArray* a,
   OffsetType pos, OffsetType& lastoffset)
 {
+  // Start raw values on a multiple of their size in the file so that
+  // readers can map them.  The padding lies between blocks and is never
+  // read.
+  if(this->AlignAppendedData && !this->EncodeAppendedData &&
+     !this->Compressor)
+    {
+    ostream& os = *(this->Stream);
+    OffsetType wordSize = this->GetOutputWordTypeSize(a->GetDataType());
+    OffsetType dataPosition =
+      static_cast<OffsetType>(os.tellp()) + sizeof(HeaderType);
+    while(wordSize > 1 && dataPosition % wordSize != 0)
+      {
+      os.put(0);
+      ++dataPosition;
+      }
+    }
   this->WriteAppendedDataOffset(pos, lastoffset, "offset");
   this->WriteBinaryData(a); 
 }
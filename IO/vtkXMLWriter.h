@@ -157,6 +157,16 @@ public:
   vtkSetMacro(EncodeAppendedData, int);
   vtkGetMacro(EncodeAppendedData, int);
   vtkBooleanMacro(EncodeAppendedData, int);
+
+  // Description:
+  // Get/Set whether raw, uncompressed appended blocks are padded so that
+  // their values start on a multiple of their size in the file.  Aligned
+  // arrays can be mapped by vtkXMLDataReader with UseMemoryMap on.  The
+  // padding lies between blocks, so the files stay readable by any
+  // reader.  The default is not to pad.
+  vtkSetMacro(AlignAppendedData, int);
+  vtkGetMacro(AlignAppendedData, int);
+  vtkBooleanMacro(AlignAppendedData, int);
   
   // Description:
   // Set/Get an input of this algorithm. You should not override these
@@ -230,6 +240,9 @@ protected:
   
   // Whether to base64-encode the appended data section.
   int EncodeAppendedData;
+
+  // Whether to align raw appended blocks on their word size.
+  int AlignAppendedData;
   
   // The stream position at which appended data starts.
   OffsetType AppendedDataPosition;
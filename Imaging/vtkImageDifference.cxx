@@ -26,18 +26,39 @@ vtkStandardNewMacro(vtkImageDifference);
 // Construct object to extract all of the input data.
 vtkImageDifference::vtkImageDifference()
 {
-  int i;
-  for ( i = 0; i < this->NumberOfThreads; i++ )
-    {
-    this->ErrorPerThread[i] = 0;
-    this->ThresholdedErrorPerThread[i] = 0.0;
-    }
+  this->ErrorPerThread = NULL;
+  this->ThresholdedErrorPerThread = NULL;
+  this->ErrorArraySize = 0;
   this->Threshold = 16;
   this->AllowShift = 1;
   this->Averaging = 1;
   this->SetNumberOfInputPorts(2);
 }
 
+vtkImageDifference::~vtkImageDifference()
+{
+  delete [] this->ErrorPerThread;
+  delete [] this->ThresholdedErrorPerThread;
+}
+
+void vtkImageDifference::AllocateErrors(double error)
+{
+  int i;
+  if (this->ErrorArraySize != this->NumberOfThreads)
+    {
+    delete [] this->ErrorPerThread;
+    delete [] this->ThresholdedErrorPerThread;
+    this->ErrorArraySize = this->NumberOfThreads;
+    this->ErrorPerThread = new double [this->ErrorArraySize];
+    this->ThresholdedErrorPerThread = new double [this->ErrorArraySize];
+    }
+  for ( i = 0; i < this->ErrorArraySize; i++ )
+    {
+    this->ErrorPerThread[i] = error;
+    this->ThresholdedErrorPerThread[i] = error;
+    }
+}
+
 
 
 // not so simple macro for calculating error
@@ -160,6 +181,17 @@ int vtkImageDifference::RequestUpdateExtent(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkImageDifference::RequestData(vtkInformation *request,
+                                    vtkInformationVector **inputVector,
+                                    vtkInformationVector *outputVector)
+{
+  // One entry per thread of this execution, threads add the error of each
+  // piece they are given to theirs.
+  this->AllocateErrors(0.0);
+  return this->Superclass::RequestData(request, inputVector, outputVector);
+}
+
 //----------------------------------------------------------------------------
 void vtkImageDifference::ThreadedRequestData(
   vtkInformation * vtkNotUsed( request ), 
@@ -185,9 +217,6 @@ void vtkImageDifference::ThreadedRequestData(
   unsigned long count = 0;
   unsigned long target;
   
-  this->ErrorPerThread[id] = 0;
-  this->ThresholdedErrorPerThread[id] = 0;
-  
   if (inData[0] == NULL || inData[1] == NULL || outData == NULL)
     {
     if (!id)
@@ -384,11 +413,7 @@ int vtkImageDifference::RequestInformation (
       in1Ext[2] != in2Ext[2] || in1Ext[3] != in2Ext[3] || 
       in1Ext[4] != in2Ext[4] || in1Ext[5] != in2Ext[5])
     {
-    for (i = 0; i < this->NumberOfThreads; i++)
-      {
-      this->ErrorPerThread[i] = 1000;
-      this->ThresholdedErrorPerThread[i] = 1000;
-      }
+    this->AllocateErrors(1000);
     vtkErrorMacro("ExecuteInformation: Input are not the same size.\n" 
       << " Input1 is: " << in1Ext[0] << "," << in1Ext[1] << ","
                         << in1Ext[2] << "," << in1Ext[3] << ","
@@ -424,7 +449,7 @@ double vtkImageDifference::GetError()
   double error = 0.0;
   int i;
 
-  for ( i= 0; i < this->NumberOfThreads; i++ )
+  for ( i= 0; i < this->ErrorArraySize; i++ )
     {
     error += this->ErrorPerThread[i];
     }
@@ -437,7 +462,7 @@ double vtkImageDifference::GetThresholdedError()
   double error = 0.0;
   int i;
 
-  for ( i= 0; i < this->NumberOfThreads; i++ )
+  for ( i= 0; i < this->ErrorArraySize; i++ )
     {
     error += this->ThresholdedErrorPerThread[i];
     }
@@ -462,7 +487,7 @@ void vtkImageDifference::PrintSelf(ostream& os, vtkIndent indent)
   
   int i;
 
-  for ( i= 0; i < this->NumberOfThreads; i++ )
+  for ( i= 0; i < this->ErrorArraySize; i++ )
     {
     os << indent << "Error for thread " << i << ": " << this->ErrorPerThread[i] << "\n";
     os << indent << "ThresholdedError for thread " << i << ": " 
@@ -87,10 +87,18 @@ public:
 
 protected:
   vtkImageDifference();
-  ~vtkImageDifference() {};
+  ~vtkImageDifference();
 
-  double ErrorPerThread[VTK_MAX_THREADS];
-  double ThresholdedErrorPerThread[VTK_MAX_THREADS];
+  // Description:
+  // Make sure the per-thread errors hold NumberOfThreads entries and set
+  // them all to error.
+  void AllocateErrors(double error);
+
+  // The errors of each thread of the last execution, ErrorArraySize of
+  // them.
+  double *ErrorPerThread;
+  double *ThresholdedErrorPerThread;
+  int ErrorArraySize;
   int AllowShift;
   int Threshold;
   int Averaging;
@@ -102,6 +110,10 @@ protected:
                                   vtkInformationVector **,
                                   vtkInformationVector *);
   
+  virtual int RequestData(vtkInformation *request,
+                          vtkInformationVector **inputVector,
+                          vtkInformationVector *outputVector);
+
   virtual void ThreadedRequestData(vtkInformation *request, 
                                    vtkInformationVector **inputVector, 
                                    vtkInformationVector *outputVector,